@@ -0,0 +1,254 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/* sector-queue disk encryption engine over XTS: the shape of a
+ * user-space block target, upstreamed so the pieces stay matched to
+ * the library's sector-batch API.
+ *
+ * One submission/completion ring pair per worker, workers pinned one
+ * per core, sector batches dealt round robin.  Workers share one
+ * read-only symmetric_xts state and run xts_encrypt_sectors_ex() on
+ * their slice, so key schedules are set up once, not per queue.  The
+ * per-sector IV policy is pluggable: plain64 (IEEE 1619) or ESSIV
+ * (xts_essiv_*), selected on the command line.
+ *
+ * The library never spawns threads; like the other demos this is the
+ * caller's side of that contract.
+ *
+ * usage: disk_engine [workers] [essiv]
+ */
+
+#ifdef __linux__
+/* for pthread_setaffinity_np / cpu_set_t */
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+
+#include <tomcrypt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+#define SECTOR_SIZE  4096
+#define BATCH        32          /* sectors per ring entry */
+#define RING_SLOTS   64          /* entries per worker ring (power of two) */
+#define RUN_NS       ((ulong64)2000000000)
+
+struct batch {
+   unsigned char *data[BATCH];   /* encrypted in place */
+   ulong64        sector[BATCH];
+   int            nsec;
+};
+
+/* single-producer single-consumer ring: the producer owns head, the
+ * worker owns tail, slots carry batch indices */
+struct ring {
+   volatile unsigned long head, tail;
+   struct batch          *slot[RING_SLOTS];
+};
+
+struct worker {
+   pthread_t         tid;
+   int               index;
+   struct ring       sq;        /* submission ring */
+   struct ring       cq;        /* completion ring */
+   ulong64           sectors_done;
+};
+
+static symmetric_xts    g_xts;
+static ltc_xts_essiv    g_essiv;
+static ltc_xts_tweak_fn g_tweak_fn  = NULL;
+static void            *g_tweak_ctx = NULL;
+static volatile int     g_stop;
+
+static ulong64 ns_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (ulong64)ts.tv_sec * (ulong64)1000000000 + (ulong64)ts.tv_nsec;
+}
+
+static int ring_push(struct ring *r, struct batch *b)
+{
+   unsigned long h = r->head;
+   if (h - r->tail == RING_SLOTS) return 0;   /* full */
+   r->slot[h % RING_SLOTS] = b;
+   __sync_synchronize();
+   r->head = h + 1;
+   return 1;
+}
+
+static struct batch *ring_pop(struct ring *r)
+{
+   unsigned long t = r->tail;
+   struct batch *b;
+   if (t == r->head) return NULL;             /* empty */
+   b = r->slot[t % RING_SLOTS];
+   __sync_synchronize();
+   r->tail = t + 1;
+   return b;
+}
+
+static void pin_to_cpu(int cpu)
+{
+#ifdef __linux__
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   CPU_SET(cpu, &set);
+   pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+   (void)cpu;
+#endif
+}
+
+static void *worker_main(void *arg)
+{
+   struct worker *w = arg;
+   struct batch  *b;
+
+   pin_to_cpu(w->index);
+   for (;;) {
+      b = ring_pop(&w->sq);
+      if (b == NULL) {
+         if (g_stop) break;
+         continue;                 /* poll; a real target would park */
+      }
+      if (xts_encrypt_sectors_ex((const unsigned char * const *)b->data,
+                                 b->data, b->nsec, SECTOR_SIZE, b->sector,
+                                 g_tweak_fn, g_tweak_ctx, &g_xts) != CRYPT_OK) {
+         fprintf(stderr, "worker %d: encrypt failed\n", w->index);
+         exit(EXIT_FAILURE);
+      }
+      w->sectors_done += b->nsec;
+      while (!ring_push(&w->cq, b)) { /* completion ring full: spin */ }
+   }
+   return NULL;
+}
+
+int main(int argc, char **argv)
+{
+   unsigned char   key[64];
+   struct worker  *w;
+   struct batch   *batches;
+   unsigned char  *arena;
+   ulong64         t0, t1, next_sector, total;
+   unsigned long   nbatch, i, j, inflight;
+   int             nworkers, use_essiv, cipher, rr;
+   long            ncpu;
+
+   ncpu      = sysconf(_SC_NPROCESSORS_ONLN);
+   nworkers  = (argc > 1) ? atoi(argv[1]) : (int)(ncpu > 0 ? ncpu : 1);
+   use_essiv = (argc > 2) && (strcmp(argv[2], "essiv") == 0);
+   if (nworkers < 1)  nworkers = 1;
+   if (nworkers > 64) nworkers = 64;
+
+   if (crypt_register_all_descriptors() != CRYPT_OK ||
+       crypt_registry_seal()            != CRYPT_OK) {
+      fprintf(stderr, "registry setup failed\n");
+      return EXIT_FAILURE;
+   }
+   cipher = find_cipher("aes");
+   XMEMSET(key, 0x5C, sizeof(key));
+   if (xts_start(cipher, key, key + 32, 32, 0, &g_xts) != CRYPT_OK) {
+      fprintf(stderr, "xts_start failed\n");
+      return EXIT_FAILURE;
+   }
+   if (use_essiv) {
+      if (xts_essiv_init(&g_essiv, cipher, find_hash("sha256"), key, 64) != CRYPT_OK) {
+         fprintf(stderr, "essiv init failed\n");
+         return EXIT_FAILURE;
+      }
+      g_tweak_fn  = xts_essiv_tweak;
+      g_tweak_ctx = &g_essiv;
+   }
+
+   /* enough batches to keep every ring full */
+   nbatch  = (unsigned long)nworkers * RING_SLOTS;
+   batches = calloc(nbatch, sizeof(*batches));
+   arena   = malloc(nbatch * BATCH * (size_t)SECTOR_SIZE);
+   w       = calloc(nworkers, sizeof(*w));
+   if (batches == NULL || arena == NULL || w == NULL) {
+      fprintf(stderr, "out of memory\n");
+      return EXIT_FAILURE;
+   }
+   for (i = 0; i < nbatch; i++) {
+      for (j = 0; j < BATCH; j++) {
+         batches[i].data[j] = arena + ((i * BATCH + j) * (size_t)SECTOR_SIZE);
+      }
+   }
+
+   for (i = 0; i < (unsigned long)nworkers; i++) {
+      w[i].index = (int)i;
+      if (pthread_create(&w[i].tid, NULL, worker_main, &w[i]) != 0) {
+         fprintf(stderr, "pthread_create failed\n");
+         return EXIT_FAILURE;
+      }
+   }
+
+   /* producer: deal fresh batches round robin, recycle completions */
+   next_sector = 0;
+   inflight    = 0;
+   rr          = 0;
+   i           = 0;          /* next unused batch */
+   t0 = ns_now();
+   do {
+      struct batch *b = NULL;
+      if (i < nbatch) {
+         b = &batches[i++];
+      } else {
+         /* reap a completion from any queue */
+         for (j = 0; j < (unsigned long)nworkers && b == NULL; j++) {
+            b = ring_pop(&w[(rr + j) % nworkers].cq);
+         }
+         if (b != NULL) inflight--;
+      }
+      if (b != NULL) {
+         b->nsec = BATCH;
+         for (j = 0; j < BATCH; j++) {
+            b->sector[j] = next_sector++;
+         }
+         if (ring_push(&w[rr].sq, b)) {
+            inflight++;
+            rr = (rr + 1) % nworkers;
+         }
+      }
+      t1 = ns_now();
+   } while (t1 - t0 < RUN_NS);
+
+   g_stop = 1;
+   total  = 0;
+   for (i = 0; i < (unsigned long)nworkers; i++) {
+      pthread_join(w[i].tid, NULL);
+      total += w[i].sectors_done;
+   }
+
+   printf("disk_engine: %d worker(s), %s tweaks, %lu in flight at stop\n",
+          nworkers, use_essiv ? "essiv" : "plain64", inflight);
+   printf("  %llu sectors (%.1f MB) in %.2fs -> %.1f MB/s\n",
+          (unsigned long long)total,
+          (double)total * SECTOR_SIZE / 1e6,
+          (double)(t1 - t0) / 1e9,
+          (double)total * SECTOR_SIZE * 1e3 / (double)(t1 - t0));
+
+   if (use_essiv) xts_essiv_done(&g_essiv);
+   xts_done(&g_xts);
+   free(arena);
+   free(batches);
+   free(w);
+   return EXIT_SUCCESS;
+}
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
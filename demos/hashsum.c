@@ -9,21 +9,110 @@
 
 #include <tomcrypt.h>
 
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+#define HASHSUM_PARALLEL
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 int errno;
 
 void register_algs(void);
 
+/* one slot per file so output stays in command line order no matter
+ * which worker finishes first */
+struct sum_job {
+   const char    *fname;
+   int            err;
+   unsigned long  len;
+   unsigned char  digest[MAXBLOCKSIZE];
+};
+
+static struct sum_job *jobs;
+static int             njobs, hashidx;
+
+#ifdef HASHSUM_PARALLEL
+#define MAXWORKERS 64
+
+static pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER;
+static int             next_job = 0;
+
+static void *sum_worker(void *arg)
+{
+   int i;
+   (void)arg;
+   for (;;) {
+      pthread_mutex_lock(&job_lock);
+      i = next_job++;
+      pthread_mutex_unlock(&job_lock);
+      if (i >= njobs) {
+         break;
+      }
+      jobs[i].len = sizeof(jobs[i].digest);
+      jobs[i].err = hash_file(hashidx, jobs[i].fname, jobs[i].digest, &jobs[i].len);
+   }
+   return NULL;
+}
+#endif
+
+static void run_jobs(int nthreads)
+{
+   int z;
+#ifdef HASHSUM_PARALLEL
+   if (nthreads > 1 && njobs > 1) {
+      pthread_t tid[MAXWORKERS];
+      int started = 0;
+      if (nthreads > MAXWORKERS)  nthreads = MAXWORKERS;
+      if (nthreads > njobs)       nthreads = njobs;
+      for (z = 0; z < nthreads; z++) {
+         if (pthread_create(&tid[z], NULL, sum_worker, NULL) != 0) {
+            break;
+         }
+         started++;
+      }
+      if (started > 0) {
+         for (z = 0; z < started; z++) {
+            pthread_join(tid[z], NULL);
+         }
+         return;
+      }
+      /* thread creation failed outright; fall through sequentially */
+   }
+#else
+   (void)nthreads;
+#endif
+   for (z = 0; z < njobs; z++) {
+      jobs[z].len = sizeof(jobs[z].digest);
+      jobs[z].err = hash_file(hashidx, jobs[z].fname, jobs[z].digest, &jobs[z].len);
+   }
+}
+
 int main(int argc, char **argv)
 {
-   int idx, x, z;
-   unsigned long w;
+   int idx, x, z, argi, nthreads, ret;
    unsigned char hash_buffer[MAXBLOCKSIZE];
    hash_state md;
 
    /* You need to register algorithms before using them */
    register_algs();
-   if (argc < 2) {
-      printf("usage: ./hash algorithm file [file ...]\n");
+
+   /* default the pool to the online core count; -j N overrides */
+   nthreads = 1;
+#ifdef HASHSUM_PARALLEL
+   {
+      long n = sysconf(_SC_NPROCESSORS_ONLN);
+      if (n > 1) nthreads = (int)n;
+   }
+#endif
+   argi = 1;
+   if (argi + 1 < argc && strcmp(argv[argi], "-j") == 0) {
+      nthreads = atoi(argv[argi+1]);
+      if (nthreads < 1) nthreads = 1;
+      argi += 2;
+   }
+
+   if (argc < argi + 1) {
+      printf("usage: ./hash [-j threads] algorithm file [file ...]\n");
       printf("Algorithms:\n");
       for (x = 0; hash_descriptor[x].name != NULL; x++) {
          printf(" %s (%d)\n", hash_descriptor[x].name, hash_descriptor[x].ID);
@@ -31,13 +120,14 @@ int main(int argc, char **argv)
       exit(EXIT_SUCCESS);
    }
 
-   idx = find_hash(argv[1]);
+   idx = find_hash(argv[argi]);
    if (idx == -1) {
       fprintf(stderr, "\nInvalid hash specified on command line.\n");
       return -1;
    }
+   argi++;
 
-   if (argc == 2) {
+   if (argc == argi) {
       hash_descriptor[idx].init(&md);
       do {
          x = fread(hash_buffer, 1, sizeof(hash_buffer), stdin);
@@ -48,20 +138,36 @@ int main(int argc, char **argv)
           printf("%02x",hash_buffer[x]);
       }
       printf("  (stdin)\n");
-   } else {
-      for (z = 2; z < argc; z++) {
-         w = sizeof(hash_buffer);
-         if ((errno = hash_file(idx,argv[z],hash_buffer,&w)) != CRYPT_OK) {
-            printf("File hash error: %s\n", error_to_string(errno));
-         } else {
-             for (x = 0; x < (int)hash_descriptor[idx].hashsize; x++) {
-                 printf("%02x",hash_buffer[x]);
-             }
-             printf("  %s\n", argv[z]);
-         }
+      return EXIT_SUCCESS;
+   }
+
+   njobs   = argc - argi;
+   hashidx = idx;
+   jobs    = calloc(njobs, sizeof(*jobs));
+   if (jobs == NULL) {
+      fprintf(stderr, "out of memory\n");
+      return -1;
+   }
+   for (z = 0; z < njobs; z++) {
+      jobs[z].fname = argv[argi + z];
+   }
+
+   run_jobs(nthreads);
+
+   ret = EXIT_SUCCESS;
+   for (z = 0; z < njobs; z++) {
+      if (jobs[z].err != CRYPT_OK) {
+         printf("File hash error: %s\n", error_to_string(jobs[z].err));
+         ret = EXIT_FAILURE;
+      } else {
+          for (x = 0; x < (int)hash_descriptor[idx].hashsize; x++) {
+              printf("%02x",jobs[z].digest[x]);
+          }
+          printf("  %s\n", jobs[z].fname);
       }
    }
-   return EXIT_SUCCESS;
+   free(jobs);
+   return ret;
 }
 
 void register_algs(void)
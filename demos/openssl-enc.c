@@ -63,12 +63,8 @@ static char salt_header[] = { 'S', 'a', 'l', 't', 'e', 'd', '_', '_' };
 #include <stdio.h>
 #include <string.h>
 
-/* A simple way to handle the possibility that a block may increase in size
-   after padding. */
-union paddable {
-   unsigned char unpad[1024];
-   unsigned char pad[1024+MAXBLOCKSIZE];
-};
+/* The pipeline helper leaves MAXBLOCKSIZE of slack in each chunk, so
+   padding can grow a block in place. */
 
 /*
  * Print usage and exit with a bad status (and perror() if any errno).
@@ -160,7 +156,7 @@ void dump_bytes(unsigned char *in, unsigned long len)
  * Output:       none
  * Side Effects: bytes printed as a hex blob, no lf at the end
  */
-size_t pkcs7_pad(union paddable *buf, size_t nb, int block_length,
+size_t pkcs7_pad(unsigned char *buf, size_t nb, int block_length,
                  int is_padding)
 {
    unsigned char padval;
@@ -176,7 +172,7 @@ size_t pkcs7_pad(union paddable *buf, size_t nb, int block_length,
       padval = (unsigned char) (block_length - (nb % block_length));
       padval = padval ? padval : block_length;
 
-      memset(buf->pad+nb, padval, padval);
+      memset(buf+nb, padval, padval);
       return nb+padval;
    } else {
       /* We are UNPADDING this block (and removing bytes)
@@ -186,7 +182,7 @@ size_t pkcs7_pad(union paddable *buf, size_t nb, int block_length,
       /* Figure out what the padlength should be by looking at the
          last byte */
       idx = nb-1;
-      padval = buf->pad[idx];
+      padval = buf[idx];
 
       /* padval must be nonzero and <= block length */
       if(padval <= 0 || padval > block_length)
@@ -196,7 +192,7 @@ size_t pkcs7_pad(union paddable *buf, size_t nb, int block_length,
       idx--;
 
       while(idx >= (off_t)(nb-padval))
-         if(buf->pad[idx] != padval)
+         if(buf[idx] != padval)
             return -1;
          else
             idx--;
@@ -207,10 +203,54 @@ size_t pkcs7_pad(union paddable *buf, size_t nb, int block_length,
    }
 }
 
+/*
+ * The cipher stage of the pipeline: CBC over whole chunks (which hits
+ * the bulk cipher paths), padding on the way in, unpadding on the way
+ * out.  Runs once per chunk with final set on the last one.
+ */
+struct crypt_stage {
+   symmetric_CBC cbc;
+   int encrypt;
+};
+
+static int crypt_stage(void *state, unsigned char *buf, unsigned long *len,
+                       int final)
+{
+   struct crypt_stage *cs = state;
+   size_t nb;
+   int ret;
+
+   if(cs->encrypt) {
+      if(final)
+         *len = pkcs7_pad(buf, *len, cs->cbc.blocklen, 1);
+      return cbc_encrypt(buf, buf, *len, &cs->cbc);
+   } else {
+      /* an empty ciphertext cannot carry valid padding */
+      if(*len == 0)
+         return CRYPT_ERROR;
+      ret = cbc_decrypt(buf, buf, *len, &cs->cbc);
+      if(ret != CRYPT_OK)
+         return ret;
+      if(final) {
+         nb = pkcs7_pad(buf, *len, cs->cbc.blocklen, 0);
+         if(nb == (size_t)-1)
+            /* The file didn't decrypt correctly */
+            return CRYPT_ERROR;
+         *len = nb;
+      }
+      return CRYPT_OK;
+   }
+}
+
 /*
  * Perform an encrypt/decrypt operation to/from files using AES+CBC+PKCS7 pad.
  * Set encrypt to 1 to encrypt, 0 to decrypt.
  *
+ * The heavy lifting happens in file_pipeline_filehandle(), which keeps
+ * the read of the next chunk and the write of the previous one in
+ * flight while crypt_stage() works on the current one, instead of the
+ * old read/crypt/write lockstep.
+ *
  * Input:        in/out files, key, iv, and mode
  * Output:       CRYPT_OK if no error
  * Side Effects: bytes slurped from infile, pushed to outfile, fds updated.
@@ -218,10 +258,8 @@ size_t pkcs7_pad(union paddable *buf, size_t nb, int block_length,
 int do_crypt(FILE *infd, FILE *outfd, unsigned char *key, unsigned char *iv,
              int encrypt)
 {
-   union paddable inbuf, outbuf;
+   struct crypt_stage cs;
    int cipher, ret;
-   symmetric_CBC cbc;
-   size_t nb;
 
    /* Register your cipher! */
    cipher = register_cipher(&aes_desc);
@@ -229,57 +267,17 @@ int do_crypt(FILE *infd, FILE *outfd, unsigned char *key, unsigned char *iv,
       return CRYPT_INVALID_CIPHER;
 
    /* Start a CBC session with cipher/key/val params */
-   ret = cbc_start(cipher, iv, key, KEY_LENGTH, 0, &cbc);
+   ret = cbc_start(cipher, iv, key, KEY_LENGTH, 0, &cs.cbc);
    if( ret != CRYPT_OK )
       return -1;
+   cs.encrypt = encrypt;
 
-   do {
-      /* Get bytes from the source */
-      nb = fread(inbuf.unpad, 1, sizeof(inbuf.unpad), infd);
-      if(!nb)
-         return encrypt ? CRYPT_OK : CRYPT_ERROR;
-
-      /* Barf if we got a read error */
-      if(ferror(infd))
-         return CRYPT_ERROR;
-
-      if(encrypt) {
-         /* We're encrypting, so pad first (if at EOF) and then
-            crypt */
-         if(feof(infd))
-            nb = pkcs7_pad(&inbuf, nb,
-                           aes_desc.block_length, 1);
-
-         ret = cbc_encrypt(inbuf.pad, outbuf.pad, nb, &cbc);
-         if(ret != CRYPT_OK)
-            return ret;
-
-      } else {
-         /* We're decrypting, so decrypt and then unpad if at
-            EOF */
-         ret = cbc_decrypt(inbuf.unpad, outbuf.unpad, nb, &cbc);
-         if( ret != CRYPT_OK )
-            return ret;
-
-         if( feof(infd) )
-            nb = pkcs7_pad(&outbuf, nb,
-                           aes_desc.block_length, 0);
-         if(nb == -1)
-            /* The file didn't decrypt correctly */
-            return CRYPT_ERROR;
-
-      }
-
-      /* Push bytes to outfile */
-      if(fwrite(outbuf.unpad, 1, nb, outfd) != nb)
-         return CRYPT_ERROR;
-
-   } while(!feof(infd));
+   ret = file_pipeline_filehandle(infd, outfd, crypt_stage, &cs);
 
    /* Close up */
-   cbc_done(&cbc);
+   cbc_done(&cs.cbc);
 
-   return CRYPT_OK;
+   return ret;
 }
 
 /* Convenience macro for the various barfable places below */
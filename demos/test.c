@@ -21,10 +21,13 @@ static const struct {
       LTC_TEST_FN(pkcs_1_eme_test),
       LTC_TEST_FN(rsa_test),
       LTC_TEST_FN(dh_test),
+      LTC_TEST_FN(x25519_test),
+      LTC_TEST_FN(ed25519_test),
       LTC_TEST_FN(ecc_tests),
       LTC_TEST_FN(dsa_test),
       LTC_TEST_FN(katja_test),
       LTC_TEST_FN(file_test),
+      LTC_TEST_FN(perf_test),
 };
 
 int main(int argc, char **argv)
@@ -0,0 +1,239 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/* thread-scaling stress benchmark: hammers the shared-state hot spots
+ * (fortuna_read, find_cipher, a shared GCM context, and the ECC FP
+ * cache when compiled in) from 1..N threads and prints the ops/sec
+ * curve per workload, so lock contention shows up as a number instead
+ * of a production incident.
+ *
+ * Build the library with LTC_PTHREAD for the fortuna and FP-cache rows
+ * to exercise the library's own locks; without it the demo serializes
+ * those workloads with its own mutex (which is what a correct caller
+ * would have to do anyway).  A shared GCM context always needs caller
+ * locking, so that row measures exactly that.  find_cipher runs bare:
+ * after crypt_registry_seal() it is a plain load and should scale
+ * linearly -- a flat per-thread figure there is a regression.
+ *
+ * usage: thread_scaling [max_threads]
+ */
+
+#include <tomcrypt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+#define RUN_NS CONST64(300000000)   /* per measurement point */
+
+static volatile int g_stop;
+static pthread_mutex_t g_demo_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static prng_state g_fortuna;
+static gcm_state  g_gcm;
+static int        g_cipher = -1;
+
+static ulong64 ns_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (ulong64)ts.tv_sec * CONST64(1000000000) + (ulong64)ts.tv_nsec;
+}
+
+/* ---- workloads ----------------------------------------------------- */
+
+#ifdef LTC_FORTUNA
+static void op_fortuna(void)
+{
+   unsigned char buf[32];
+#ifndef LTC_PTHREAD
+   pthread_mutex_lock(&g_demo_mutex);
+#endif
+   fortuna_read(buf, sizeof(buf), &g_fortuna);
+#ifndef LTC_PTHREAD
+   pthread_mutex_unlock(&g_demo_mutex);
+#endif
+}
+#endif
+
+static void op_find_cipher(void)
+{
+   if (find_cipher("aes") == -1) {
+      g_stop = 1;   /* cannot happen; keeps the call from folding away */
+   }
+}
+
+static void op_gcm(void)
+{
+   unsigned char blk[64];
+   XMEMSET(blk, 0, sizeof(blk));
+   pthread_mutex_lock(&g_demo_mutex);
+   gcm_process(&g_gcm, blk, sizeof(blk), blk, GCM_ENCRYPT);
+   pthread_mutex_unlock(&g_demo_mutex);
+}
+
+#if defined(LTC_MECC) && defined(LTC_MECC_FP)
+static ecc_key g_ecc;
+
+static void op_fp_mulmod(void)
+{
+   ecc_point *R = ltc_ecc_new_point();
+   if (R == NULL) { g_stop = 1; return; }
+#ifndef LTC_PTHREAD
+   pthread_mutex_lock(&g_demo_mutex);
+#endif
+   ltc_ecc_fp_mulmod(g_ecc.k, &g_ecc.pubkey, R, g_ecc.dp->prime, 1);
+#ifndef LTC_PTHREAD
+   pthread_mutex_unlock(&g_demo_mutex);
+#endif
+   ltc_ecc_del_point(R);
+}
+#endif
+
+/* ---- harness ------------------------------------------------------- */
+
+typedef void (*op_fn)(void);
+
+struct tctx {
+   op_fn    op;
+   ulong64  count;
+};
+
+static void *worker(void *v)
+{
+   struct tctx *t = v;
+   ulong64 c = 0;
+   while (!g_stop) {
+      t->op();
+      c++;
+   }
+   t->count = c;
+   return NULL;
+}
+
+/* total ops/sec with nthreads hammering op */
+static double run_point(op_fn op, int nthreads)
+{
+   struct tctx tc[64];
+   pthread_t   th[64];
+   ulong64 t0, t1, total;
+   int i;
+
+   g_stop = 0;
+   total  = 0;
+   for (i = 0; i < nthreads; i++) {
+      tc[i].op    = op;
+      tc[i].count = 0;
+      if (pthread_create(&th[i], NULL, worker, &tc[i]) != 0) {
+         fprintf(stderr, "pthread_create failed\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+   t0 = ns_now();
+   do { t1 = ns_now(); } while (t1 - t0 < RUN_NS);
+   g_stop = 1;
+   for (i = 0; i < nthreads; i++) {
+      pthread_join(th[i], NULL);
+      total += tc[i].count;
+   }
+   return (double)total * 1.0e9 / (double)(t1 - t0);
+}
+
+static void run_curve(const char *name, op_fn op, int maxthreads)
+{
+   double base = 0.0, ops;
+   int n;
+   for (n = 1; n <= maxthreads; n *= 2) {
+      ops = run_point(op, n);
+      if (n == 1) base = ops;
+      printf("%-14s %3d  %12.0f  %12.0f  %5.1f%%\n",
+             name, n, ops, ops / n,
+             base > 0.0 ? 100.0 * ops / (base * n) : 0.0);
+   }
+}
+
+int main(int argc, char **argv)
+{
+   unsigned char ent[64], key[16], iv[12];
+   int maxthreads;
+   long ncpu;
+
+   ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+   maxthreads = (argc > 1) ? atoi(argv[1]) : (int)(ncpu > 0 ? ncpu : 1);
+   if (maxthreads < 1)  maxthreads = 1;
+   if (maxthreads > 64) maxthreads = 64;
+
+   if (crypt_register_all_descriptors() != CRYPT_OK ||
+       crypt_registry_seal()            != CRYPT_OK) {
+      fprintf(stderr, "registry setup failed\n");
+      return EXIT_FAILURE;
+   }
+   g_cipher = find_cipher("aes");
+   if (g_cipher == -1) {
+      fprintf(stderr, "no aes\n");
+      return EXIT_FAILURE;
+   }
+
+   XMEMSET(ent, 0x5A, sizeof(ent));
+   XMEMSET(key, 0x55, sizeof(key));
+   XMEMSET(iv,  0xAA, sizeof(iv));
+
+   printf("%-14s %3s  %12s  %12s  %6s\n",
+          "workload", "thr", "ops/s", "ops/s/thr", "eff");
+
+#ifdef LTC_FORTUNA
+   if (fortuna_start(&g_fortuna)                    != CRYPT_OK ||
+       fortuna_add_entropy(ent, 32, &g_fortuna)     != CRYPT_OK ||
+       fortuna_ready(&g_fortuna)                    != CRYPT_OK) {
+      fprintf(stderr, "fortuna setup failed\n");
+      return EXIT_FAILURE;
+   }
+   run_curve("fortuna_read", op_fortuna, maxthreads);
+   fortuna_done(&g_fortuna);
+#endif
+
+   run_curve("find_cipher", op_find_cipher, maxthreads);
+
+   if (gcm_init(&g_gcm, g_cipher, key, sizeof(key)) != CRYPT_OK ||
+       gcm_add_iv(&g_gcm, iv, sizeof(iv))           != CRYPT_OK ||
+       gcm_add_aad(&g_gcm, NULL, 0)                 != CRYPT_OK) {
+      fprintf(stderr, "gcm setup failed\n");
+      return EXIT_FAILURE;
+   }
+   run_curve("gcm_shared", op_gcm, maxthreads);
+
+#if defined(LTC_MECC) && defined(LTC_MECC_FP)
+   if (ltc_mp.name != NULL) {
+      prng_state yp;
+      int wprng = find_prng("yarrow");
+      if (wprng != -1 &&
+          prng_descriptor[wprng].start(&yp) == CRYPT_OK &&
+          prng_descriptor[wprng].add_entropy(ent, sizeof(ent), &yp) == CRYPT_OK &&
+          prng_descriptor[wprng].ready(&yp) == CRYPT_OK &&
+          ecc_make_key(&yp, wprng, 32, &g_ecc) == CRYPT_OK) {
+         run_curve("fp_mulmod", op_fp_mulmod, maxthreads);
+         ecc_free(&g_ecc);
+         prng_descriptor[wprng].done(&yp);
+      }
+   } else {
+      printf("%-14s (skipped, no math provider)\n", "fp_mulmod");
+   }
+#else
+   printf("%-14s (skipped, LTC_MECC_FP not compiled in)\n", "fp_mulmod");
+#endif
+
+   return EXIT_SUCCESS;
+}
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
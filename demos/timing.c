@@ -1,10 +1,902 @@
-#include <tomcrypt_test.h>
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
 
-int main(void)
+/* benchmark suite: measures every registered cipher (key schedule and
+ * the ECB/CBC/CTR modes), AEAD mode, hash, MAC and PRNG across a range
+ * of buffer sizes, plus the public key primitives when a math provider
+ * is compiled in.  Each figure is the median of several timed trials
+ * after a warmup pass, reported as MB/s, ops/s and -- when the cycle
+ * counter calibrates -- cycles per byte.  Output is a JSON document so
+ * results can be diffed and graphed mechanically.
+ *
+ * usage: timing [-q] [-t trials] [-o outfile]
+ *        -q         quick run (fewer sizes and trials)
+ *        -t trials  trials per measurement (default 7)
+ *        -o file    write the JSON there instead of stdout
+ */
+
+#include <tomcrypt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+static FILE *g_out;
+static int   g_trials   = 7;
+static int   g_lat_samples = 256;  /* per-op samples for latency histograms */
+static int   g_first    = 1;   /* comma bookkeeping for the JSON array */
+static double g_cyc_ns  = 0.0; /* cycles per nanosecond, 0 if unknown */
+
+/* target time per timed trial; long enough to dwarf timer overhead */
+#define TRIAL_NS 4000000.0
+
+static const unsigned long g_sizes_full[]  = { 64, 256, 1024, 4096, 65536,
+                                               1048576, 16777216 };
+static const unsigned long g_sizes_quick[] = { 64, 1024, 65536 };
+static const unsigned long *g_sizes = g_sizes_full;
+static int g_nsizes = (int)(sizeof(g_sizes_full)/sizeof(g_sizes_full[0]));
+
+#define MAXBUF 16777216UL
+
+/* ---- timers -------------------------------------------------------- */
+
+static ulong64 ns_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (ulong64)ts.tv_sec * CONST64(1000000000) + (ulong64)ts.tv_nsec;
+}
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+static ulong64 cyc_now(void)
+{
+   unsigned int lo, hi;
+   __asm__ __volatile__ ("rdtsc" : "=a"(lo), "=d"(hi));
+   return ((ulong64)hi << 32) | lo;
+}
+#else
+static ulong64 cyc_now(void) { return 0; }
+#endif
+
+/* relate the cycle counter to the monotonic clock so cycles/byte can
+ * be derived from wall time; leaves g_cyc_ns at 0 if there is no
+ * usable counter */
+static void calibrate(void)
+{
+   ulong64 n0, n1, c0, c1;
+   c0 = cyc_now();
+   if (c0 == 0) return;
+   n0 = ns_now();
+   do { n1 = ns_now(); } while (n1 - n0 < CONST64(50000000));
+   c1 = cyc_now();
+   if (c1 > c0) {
+      g_cyc_ns = (double)(c1 - c0) / (double)(n1 - n0);
+   }
+}
+
+/* ---- cache-miss counters (Linux perf_event, optional) --------------
+ * L1D and last-level load misses per processed byte, for weighing the
+ * table-driven primitives (aes_tab, whirltab, the GCM PC tables)
+ * against their computed variants: build the suite once per variant
+ * and diff the figures.  Both fields are null when the kernel refuses
+ * perf_event_open (no privileges, perf_event_paranoid, no PMU). */
+#if defined(__linux__)
+static int g_perf_l1 = -1, g_perf_ll = -1;
+
+static int perf_open(unsigned long long config)
+{
+   struct perf_event_attr at;
+   memset(&at, 0, sizeof(at));
+   at.size           = sizeof(at);
+   at.type           = PERF_TYPE_HW_CACHE;
+   at.config         = config;
+   at.disabled       = 1;
+   at.exclude_kernel = 1;
+   at.exclude_hv     = 1;
+   return (int)syscall(__NR_perf_event_open, &at, 0, -1, -1, 0);
+}
+
+static void perf_init(void)
+{
+   g_perf_l1 = perf_open(PERF_COUNT_HW_CACHE_L1D |
+                         (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+   g_perf_ll = perf_open(PERF_COUNT_HW_CACHE_LL |
+                         (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+}
+
+static void perf_start(int fd)
+{
+   if (fd != -1) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+   }
+}
+
+/* counter value since perf_start, or -1 when unavailable */
+static double perf_stop(int fd)
+{
+   long long v;
+   if (fd == -1) return -1.0;
+   ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+   if (read(fd, &v, sizeof(v)) != (ssize_t)sizeof(v)) return -1.0;
+   return (double)v;
+}
+#else
+static int g_perf_l1 = -1, g_perf_ll = -1;
+static void perf_init(void)   { }
+static void perf_start(int fd)  { (void)fd; }
+static double perf_stop(int fd) { (void)fd; return -1.0; }
+#endif
+
+/* ---- measurement core ---------------------------------------------- */
+
+typedef void (*bench_fn)(void *ctx, unsigned char *buf, unsigned long len,
+                         unsigned long reps);
+
+static int dbl_cmp(const void *a, const void *b)
+{
+   double x = *(const double *)a, y = *(const double *)b;
+   return (x > y) - (x < y);
+}
+
+/* run fn over buf/len and report the median trial; len == 0 marks a
+ * pure ops benchmark (key schedules, PK) where only ops/s applies.
+ * Returns the median ns per rep so sections can derive further
+ * figures from it. */
+static double bench_one(const char *kind, const char *name,
+                        unsigned long len, bench_fn fn, void *ctx,
+                        unsigned char *buf)
+{
+   double ns_per_rep, med, l1, ll;
+   double trial[64];
+   ulong64 t0, t1;
+   unsigned long reps, r, chunk;
+   int i;
+
+   /* size one rep, then scale the batch to the trial target */
+   t0 = ns_now();
+   fn(ctx, buf, len, 1);
+   t1 = ns_now();
+   ns_per_rep = (double)(t1 - t0);
+   if (ns_per_rep < 1.0) ns_per_rep = 1.0;
+   reps = (unsigned long)(TRIAL_NS / ns_per_rep);
+   if (reps < 1)          reps = 1;
+   if (reps > 1UL << 24)  reps = 1UL << 24;
+
+   /* warmup batch, then the timed trials */
+   fn(ctx, buf, len, reps);
+   for (i = 0; i < g_trials; i++) {
+      t0 = ns_now();
+      for (r = reps; r > 0; r -= chunk) {
+         chunk = r > 4096 ? 4096 : r;
+         fn(ctx, buf, len, chunk);
+      }
+      t1 = ns_now();
+      trial[i] = (double)(t1 - t0) / (double)reps;
+   }
+   XQSORT(trial, g_trials, sizeof(double), dbl_cmp);
+   med = trial[g_trials / 2];
+
+   /* one extra counted pass for the cache-miss rates */
+   l1 = ll = -1.0;
+   if (len > 0 && (g_perf_l1 != -1 || g_perf_ll != -1)) {
+      perf_start(g_perf_l1);
+      perf_start(g_perf_ll);
+      fn(ctx, buf, len, reps);
+      l1 = perf_stop(g_perf_l1);
+      ll = perf_stop(g_perf_ll);
+   }
+
+   fprintf(g_out, "%s\n  {\"kind\": \"%s\", \"name\": \"%s\"",
+           g_first ? "" : ",", kind, name);
+   g_first = 0;
+   fprintf(g_out, ", \"ops_per_sec\": %.1f", 1.0e9 / med);
+   if (len > 0) {
+      fprintf(g_out, ", \"size\": %lu, \"mb_per_sec\": %.2f",
+              len, (double)len * (1.0e9 / med) / 1048576.0);
+      if (g_cyc_ns > 0.0) {
+         fprintf(g_out, ", \"cycles_per_byte\": %.3f",
+                 med * g_cyc_ns / (double)len);
+      } else {
+         fprintf(g_out, ", \"cycles_per_byte\": null");
+      }
+      if (l1 >= 0.0) {
+         fprintf(g_out, ", \"l1d_miss_per_kb\": %.3f",
+                 l1 * 1024.0 / ((double)reps * (double)len));
+      } else {
+         fprintf(g_out, ", \"l1d_miss_per_kb\": null");
+      }
+      if (ll >= 0.0) {
+         fprintf(g_out, ", \"llc_miss_per_kb\": %.3f",
+                 ll * 1024.0 / ((double)reps * (double)len));
+      } else {
+         fprintf(g_out, ", \"llc_miss_per_kb\": null");
+      }
+   }
+   fprintf(g_out, "}");
+   fflush(g_out);
+   return med;
+}
+
+/* time fn one rep at a time and emit the full latency distribution:
+ * percentiles from the sorted samples plus a log2-bucketed histogram,
+ * so allocator stalls and other tail spikes stay visible where a
+ * throughput average would wash them out */
+static void bench_lat(const char *kind, const char *name,
+                      bench_fn fn, void *ctx, unsigned char *buf)
+{
+   static double sample[4096];
+   ulong64 t0, t1;
+   unsigned long hist[40];
+   int i, n, b, hi;
+
+   n = g_lat_samples;
+   if (n > (int)(sizeof(sample)/sizeof(sample[0]))) {
+      n = (int)(sizeof(sample)/sizeof(sample[0]));
+   }
+   fn(ctx, buf, 0, 1);   /* warmup, faults code and tables in */
+   for (i = 0; i < n; i++) {
+      t0 = ns_now();
+      fn(ctx, buf, 0, 1);
+      t1 = ns_now();
+      sample[i] = (double)(t1 - t0);
+   }
+   XQSORT(sample, n, sizeof(double), dbl_cmp);
+
+   XMEMSET(hist, 0, sizeof(hist));
+   hi = 0;
+   for (i = 0; i < n; i++) {
+      for (b = 0; b < 39 && sample[i] >= (double)(CONST64(1) << (b + 1)); b++);
+      hist[b]++;
+      if (b > hi) hi = b;
+   }
+
+   fprintf(g_out, "%s\n  {\"kind\": \"%s\", \"name\": \"%s\", \"samples\": %d",
+           g_first ? "" : ",", kind, name, n);
+   g_first = 0;
+   fprintf(g_out, ", \"min_ns\": %.0f, \"p50_ns\": %.0f, \"p90_ns\": %.0f"
+           ", \"p99_ns\": %.0f, \"max_ns\": %.0f",
+           sample[0], sample[n / 2], sample[(n * 9) / 10],
+           sample[(n * 99) / 100], sample[n - 1]);
+   fprintf(g_out, ", \"hist\": [");
+   for (b = 0; b <= hi; b++) {
+      fprintf(g_out, "%s{\"lt_ns\": %lu, \"n\": %lu}",
+              b ? ", " : "", (unsigned long)1 << (b + 1), hist[b]);
+   }
+   fprintf(g_out, "]}");
+   fflush(g_out);
+}
+
+/* ---- wrappers ------------------------------------------------------ */
+
+struct alg_ctx { int idx, keylen;
+                 unsigned char key[MAXBLOCKSIZE], iv[MAXBLOCKSIZE]; };
+
+/* back-to-back single-block calls through the descriptor pointer: the
+ * baseline the chaining modes are charged against */
+struct raw_ecb_ctx { int idx, blocklen; symmetric_key skey; };
+
+static void run_raw_ecb(void *vc, unsigned char *buf, unsigned long len,
+                        unsigned long reps)
+{
+   struct raw_ecb_ctx *c = vc;
+   unsigned long i;
+   while (reps-- > 0) {
+      for (i = 0; i + c->blocklen <= len; i += c->blocklen) {
+         cipher_descriptor[c->idx].ecb_encrypt(buf + i, buf + i, &c->skey);
+      }
+   }
+}
+
+#ifdef LTC_XTS_MODE
+struct xts_ctx { symmetric_xts xts; unsigned char tweak[16]; };
+
+static void run_xts(void *vc, unsigned char *buf, unsigned long len,
+                    unsigned long reps)
+{
+   struct xts_ctx *c = vc;
+   while (reps-- > 0) { xts_encrypt(buf, len, buf, c->tweak, &c->xts); }
+}
+#endif
+
+static void run_keysched(void *vc, unsigned char *buf, unsigned long len,
+                         unsigned long reps)
+{
+   struct alg_ctx *c = vc;
+   symmetric_key skey;
+   LTC_UNUSED_PARAM(buf); LTC_UNUSED_PARAM(len);
+   while (reps-- > 0) {
+      cipher_descriptor[c->idx].setup(c->key, c->keylen, 0, &skey);
+      if (cipher_descriptor[c->idx].done != NULL) {
+         cipher_descriptor[c->idx].done(&skey);
+      }
+   }
+}
+
+static void run_ecb(void *vc, unsigned char *buf, unsigned long len,
+                    unsigned long reps)
+{
+   symmetric_ECB *ecb = vc;
+   while (reps-- > 0) { ecb_encrypt(buf, buf, len, ecb); }
+}
+
+static void run_cbc(void *vc, unsigned char *buf, unsigned long len,
+                    unsigned long reps)
+{
+   symmetric_CBC *cbc = vc;
+   while (reps-- > 0) { cbc_encrypt(buf, buf, len, cbc); }
+}
+
+static void run_ctr(void *vc, unsigned char *buf, unsigned long len,
+                    unsigned long reps)
+{
+   symmetric_CTR *ctr = vc;
+   while (reps-- > 0) { ctr_encrypt(buf, buf, len, ctr); }
+}
+
+#ifdef LTC_GCM_MODE
+static void run_gcm(void *vc, unsigned char *buf, unsigned long len,
+                    unsigned long reps)
+{
+   struct alg_ctx *c = vc;
+   unsigned char tag[16];
+   unsigned long taglen;
+   while (reps-- > 0) {
+      taglen = sizeof(tag);
+      gcm_memory(c->idx, c->key, c->keylen, c->iv, 12, NULL, 0,
+                 buf, len, buf, tag, &taglen, GCM_ENCRYPT);
+   }
+}
+#endif
+
+#ifdef LTC_CCM_MODE
+static void run_ccm(void *vc, unsigned char *buf, unsigned long len,
+                    unsigned long reps)
+{
+   struct alg_ctx *c = vc;
+   unsigned char tag[16];
+   unsigned long taglen;
+   while (reps-- > 0) {
+      taglen = sizeof(tag);
+      ccm_memory(c->idx, c->key, c->keylen, NULL, c->iv, 13, NULL, 0,
+                 buf, len, buf, tag, &taglen, CCM_ENCRYPT);
+   }
+}
+#endif
+
+#ifdef LTC_EAX_MODE
+static void run_eax(void *vc, unsigned char *buf, unsigned long len,
+                    unsigned long reps)
+{
+   struct alg_ctx *c = vc;
+   unsigned char tag[16];
+   unsigned long taglen;
+   while (reps-- > 0) {
+      taglen = sizeof(tag);
+      eax_encrypt_authenticate_memory(c->idx, c->key, c->keylen, c->iv, 16,
+                                      NULL, 0, buf, len, buf, tag, &taglen);
+   }
+}
+#endif
+
+static void run_hash(void *vc, unsigned char *buf, unsigned long len,
+                     unsigned long reps)
+{
+   int idx = *(int *)vc;
+   unsigned char md[MAXBLOCKSIZE];
+   unsigned long mdlen;
+   while (reps-- > 0) {
+      mdlen = sizeof(md);
+      hash_memory(idx, buf, len, md, &mdlen);
+   }
+}
+
+#ifdef LTC_HMAC
+static void run_hmac(void *vc, unsigned char *buf, unsigned long len,
+                     unsigned long reps)
+{
+   struct alg_ctx *c = vc;  /* idx is a hash index here */
+   unsigned char md[MAXBLOCKSIZE];
+   unsigned long mdlen;
+   while (reps-- > 0) {
+      mdlen = sizeof(md);
+      hmac_memory(c->idx, c->key, 32, buf, len, md, &mdlen);
+   }
+}
+#endif
+
+#ifdef LTC_OMAC
+static void run_omac(void *vc, unsigned char *buf, unsigned long len,
+                     unsigned long reps)
+{
+   struct alg_ctx *c = vc;
+   unsigned char md[MAXBLOCKSIZE];
+   unsigned long mdlen;
+   while (reps-- > 0) {
+      mdlen = sizeof(md);
+      omac_memory(c->idx, c->key, c->keylen, buf, len, md, &mdlen);
+   }
+}
+#endif
+
+#ifdef LTC_PMAC
+static void run_pmac(void *vc, unsigned char *buf, unsigned long len,
+                     unsigned long reps)
+{
+   struct alg_ctx *c = vc;
+   unsigned char md[MAXBLOCKSIZE];
+   unsigned long mdlen;
+   while (reps-- > 0) {
+      mdlen = sizeof(md);
+      pmac_memory(c->idx, c->key, c->keylen, buf, len, md, &mdlen);
+   }
+}
+#endif
+
+struct prng_ctx { prng_state st; int idx; };
+
+static void run_prng(void *vc, unsigned char *buf, unsigned long len,
+                     unsigned long reps)
+{
+   struct prng_ctx *p = vc;
+   while (reps-- > 0) { prng_descriptor[p->idx].read(buf, len, &p->st); }
+}
+
+/* ---- sections ------------------------------------------------------ */
+
+static void bench_ciphers(unsigned char *buf)
+{
+   struct alg_ctx c;
+   symmetric_ECB ecb;
+   symmetric_CBC cbc;
+   symmetric_CTR ctr;
+   unsigned long len;
+   int x, s, ks;
+
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (cipher_descriptor[x].name == NULL) continue;
+      c.idx = x;
+      ks = cipher_descriptor[x].max_key_length;
+      if (ks > 32) ks = 32;
+      if (cipher_descriptor[x].keysize(&ks) != CRYPT_OK) continue;
+      c.keylen = ks;
+      XMEMSET(c.key, 0x55, sizeof(c.key));
+      XMEMSET(c.iv,  0xAA, sizeof(c.iv));
+
+      bench_one("keysched", cipher_descriptor[x].name, 0, run_keysched, &c, buf);
+
+      if (ecb_start(x, c.key, c.keylen, 0, &ecb) != CRYPT_OK) continue;
+      cbc_start(x, c.iv, c.key, c.keylen, 0, &cbc);
+      ctr_start(x, c.iv, c.key, c.keylen, 0, CTR_COUNTER_LITTLE_ENDIAN, &ctr);
+      for (s = 0; s < g_nsizes; s++) {
+         len = g_sizes[s] & ~(unsigned long)(cipher_descriptor[x].block_length - 1);
+         bench_one("cipher-ecb", cipher_descriptor[x].name, len, run_ecb, &ecb, buf);
+         bench_one("cipher-cbc", cipher_descriptor[x].name, len, run_cbc, &cbc, buf);
+         bench_one("cipher-ctr", cipher_descriptor[x].name, len, run_ctr, &ctr, buf);
+      }
+      ecb_done(&ecb); cbc_done(&cbc); ctr_done(&ctr);
+
+      if (cipher_descriptor[x].block_length == 16) {
+         for (s = 0; s < g_nsizes; s++) {
+#ifdef LTC_GCM_MODE
+            bench_one("aead-gcm", cipher_descriptor[x].name, g_sizes[s], run_gcm, &c, buf);
+#endif
+#ifdef LTC_CCM_MODE
+            bench_one("aead-ccm", cipher_descriptor[x].name, g_sizes[s], run_ccm, &c, buf);
+#endif
+#ifdef LTC_EAX_MODE
+            bench_one("aead-eax", cipher_descriptor[x].name, g_sizes[s], run_eax, &c, buf);
+#endif
+         }
+      }
+   }
+}
+
+/* charge each chaining mode against raw back-to-back descriptor ECB
+ * calls on the same data; the difference is pure mode overhead
+ * (descriptor indirection, chaining arithmetic, loop bookkeeping) */
+static void bench_mode_overhead(unsigned char *buf)
+{
+   static const unsigned long ov_sizes[] = { 256, 16384 };
+   struct alg_ctx c;
+   struct raw_ecb_ctx raw;
+   symmetric_CBC cbc;
+   symmetric_CTR ctr;
+#ifdef LTC_XTS_MODE
+   struct xts_ctx xc;
+#endif
+   double raw_ns, mode_ns, ov_ns;
+   unsigned long len, nblk;
+   int x, s, ks, m;
+   const char *mname;
+
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (cipher_descriptor[x].name == NULL) continue;
+      ks = cipher_descriptor[x].max_key_length;
+      if (ks > 32) ks = 32;
+      if (cipher_descriptor[x].keysize(&ks) != CRYPT_OK) continue;
+      c.idx = x; c.keylen = ks;
+      XMEMSET(c.key, 0x55, sizeof(c.key));
+      XMEMSET(c.iv,  0xAA, sizeof(c.iv));
+      raw.idx      = x;
+      raw.blocklen = cipher_descriptor[x].block_length;
+      if (cipher_descriptor[x].setup(c.key, ks, 0, &raw.skey) != CRYPT_OK) continue;
+
+      for (s = 0; s < (int)(sizeof(ov_sizes)/sizeof(ov_sizes[0])); s++) {
+         len  = ov_sizes[s] & ~(unsigned long)(raw.blocklen - 1);
+         nblk = len / raw.blocklen;
+         raw_ns = bench_one("raw-ecb", cipher_descriptor[x].name, len,
+                            run_raw_ecb, &raw, buf);
+         for (m = 0; m < 3; m++) {
+            void *ctx;
+            bench_fn fn;
+            if (m == 0) {
+               if (cbc_start(x, c.iv, c.key, ks, 0, &cbc) != CRYPT_OK) continue;
+               mname = "cbc"; fn = run_cbc; ctx = &cbc;
+            } else if (m == 1) {
+               if (ctr_start(x, c.iv, c.key, ks, 0,
+                             CTR_COUNTER_LITTLE_ENDIAN, &ctr) != CRYPT_OK) continue;
+               mname = "ctr"; fn = run_ctr; ctx = &ctr;
+            } else {
+#ifdef LTC_XTS_MODE
+               if (raw.blocklen != 16 || (unsigned long)(2*ks) > sizeof(c.key)) continue;
+               if (xts_start(x, c.key, c.key, ks, 0, &xc.xts) != CRYPT_OK) continue;
+               XMEMSET(xc.tweak, 0x42, sizeof(xc.tweak));
+               mname = "xts"; fn = run_xts; ctx = &xc;
+#else
+               continue;
+#endif
+            }
+            mode_ns = bench_one("mode", cipher_descriptor[x].name, len, fn, ctx, buf);
+            ov_ns   = (mode_ns - raw_ns) / (double)nblk;
+            fprintf(g_out, ",\n  {\"kind\": \"mode-overhead\", \"name\": \"%s-%s\""
+                    ", \"size\": %lu, \"overhead_ns_per_block\": %.2f",
+                    cipher_descriptor[x].name, mname, len, ov_ns);
+            if (g_cyc_ns > 0.0) {
+               fprintf(g_out, ", \"overhead_cycles_per_block\": %.2f}", ov_ns * g_cyc_ns);
+            } else {
+               fprintf(g_out, ", \"overhead_cycles_per_block\": null}");
+            }
+            if (m == 0)      { cbc_done(&cbc); }
+            else if (m == 1) { ctr_done(&ctr); }
+#ifdef LTC_XTS_MODE
+            else             { xts_done(&xc.xts); }
+#endif
+         }
+      }
+      if (cipher_descriptor[x].done != NULL) {
+         cipher_descriptor[x].done(&raw.skey);
+      }
+   }
+}
+
+static void bench_hashes(unsigned char *buf)
+{
+#ifdef LTC_HMAC
+   struct alg_ctx c;
+#endif
+   int x, s;
+
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (hash_descriptor[x].name == NULL) continue;
+      for (s = 0; s < g_nsizes; s++) {
+         bench_one("hash", hash_descriptor[x].name, g_sizes[s], run_hash, &x, buf);
+      }
+#ifdef LTC_HMAC
+      c.idx = x;
+      XMEMSET(c.key, 0x55, sizeof(c.key));
+      for (s = 0; s < g_nsizes; s++) {
+         bench_one("mac-hmac", hash_descriptor[x].name, g_sizes[s], run_hmac, &c, buf);
+      }
+#endif
+   }
+}
+
+static void bench_cipher_macs(unsigned char *buf)
+{
+#if defined(LTC_OMAC) || defined(LTC_PMAC)
+   struct alg_ctx c;
+   int x, s, ks;
+
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (cipher_descriptor[x].name == NULL) continue;
+      c.idx = x;
+      ks = cipher_descriptor[x].max_key_length;
+      if (ks > 32) ks = 32;
+      if (cipher_descriptor[x].keysize(&ks) != CRYPT_OK) continue;
+      c.keylen = ks;
+      XMEMSET(c.key, 0x55, sizeof(c.key));
+      for (s = 0; s < g_nsizes; s++) {
+#ifdef LTC_OMAC
+         bench_one("mac-omac", cipher_descriptor[x].name, g_sizes[s], run_omac, &c, buf);
+#endif
+#ifdef LTC_PMAC
+         bench_one("mac-pmac", cipher_descriptor[x].name, g_sizes[s], run_pmac, &c, buf);
+#endif
+      }
+   }
+#else
+   LTC_UNUSED_PARAM(buf);
+#endif
+}
+
+static void bench_prngs(unsigned char *buf)
+{
+   struct prng_ctx p;
+   unsigned char ent[64];
+   int x, s;
+
+   XMEMSET(ent, 0x5A, sizeof(ent));
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (prng_descriptor[x].name == NULL) continue;
+      /* sprng reads the system device; not a library figure */
+      if (XSTRCMP(prng_descriptor[x].name, "sprng") == 0) continue;
+      if (prng_descriptor[x].start(&p.st) != CRYPT_OK) continue;
+      prng_descriptor[x].add_entropy(ent, sizeof(ent), &p.st);
+      if (prng_descriptor[x].ready(&p.st) != CRYPT_OK) continue;
+      p.idx = x;
+      for (s = 0; s < g_nsizes && g_sizes[s] <= 1048576; s++) {
+         bench_one("prng", prng_descriptor[x].name, g_sizes[s], run_prng, &p, buf);
+      }
+      prng_descriptor[x].done(&p.st);
+   }
+}
+
+/* ---- public key ---------------------------------------------------- */
+
+#if defined(LTC_MRSA) || defined(LTC_MECC)
+struct pk_ctx {
+#ifdef LTC_MRSA
+   rsa_key rsa;
+#endif
+#ifdef LTC_MECC
+   ecc_key ecc, ecc2;
+#endif
+#ifdef LTC_MDH
+   dh_key dh, dh2;
+#endif
+   prng_state prng;
+   int wprng, hash;
+   unsigned char msg[32], sig[512];
+   unsigned long siglen;
+};
+
+#ifdef LTC_MRSA
+static void run_rsa_sign(void *vc, unsigned char *buf, unsigned long len,
+                         unsigned long reps)
+{
+   struct pk_ctx *p = vc;
+   LTC_UNUSED_PARAM(buf); LTC_UNUSED_PARAM(len);
+   while (reps-- > 0) {
+      p->siglen = sizeof(p->sig);
+      rsa_sign_hash(p->msg, sizeof(p->msg), p->sig, &p->siglen,
+                    &p->prng, p->wprng, p->hash, 8, &p->rsa);
+   }
+}
+
+static void run_rsa_verify(void *vc, unsigned char *buf, unsigned long len,
+                           unsigned long reps)
+{
+   struct pk_ctx *p = vc;
+   int stat;
+   LTC_UNUSED_PARAM(buf); LTC_UNUSED_PARAM(len);
+   while (reps-- > 0) {
+      rsa_verify_hash(p->sig, p->siglen, p->msg, sizeof(p->msg),
+                      p->hash, 8, &stat, &p->rsa);
+   }
+}
+#endif
+
+#ifdef LTC_MECC
+static void run_ecc_sign(void *vc, unsigned char *buf, unsigned long len,
+                         unsigned long reps)
+{
+   struct pk_ctx *p = vc;
+   LTC_UNUSED_PARAM(buf); LTC_UNUSED_PARAM(len);
+   while (reps-- > 0) {
+      p->siglen = sizeof(p->sig);
+      ecc_sign_hash(p->msg, sizeof(p->msg), p->sig, &p->siglen,
+                    &p->prng, p->wprng, &p->ecc);
+   }
+}
+
+static void run_ecc_verify(void *vc, unsigned char *buf, unsigned long len,
+                           unsigned long reps)
+{
+   struct pk_ctx *p = vc;
+   int stat;
+   LTC_UNUSED_PARAM(buf); LTC_UNUSED_PARAM(len);
+   while (reps-- > 0) {
+      ecc_verify_hash(p->sig, p->siglen, p->msg, sizeof(p->msg),
+                      &stat, &p->ecc);
+   }
+}
+
+static void run_ecdh(void *vc, unsigned char *buf, unsigned long len,
+                     unsigned long reps)
+{
+   struct pk_ctx *p = vc;
+   unsigned char out[128];
+   unsigned long outlen;
+   LTC_UNUSED_PARAM(buf); LTC_UNUSED_PARAM(len);
+   while (reps-- > 0) {
+      outlen = sizeof(out);
+      ecc_shared_secret(&p->ecc, &p->ecc2, out, &outlen);
+   }
+}
+#endif
+
+#ifdef LTC_MDH
+static void run_dh(void *vc, unsigned char *buf, unsigned long len,
+                   unsigned long reps)
+{
+   struct pk_ctx *p = vc;
+   unsigned char out[512];
+   unsigned long outlen;
+   LTC_UNUSED_PARAM(buf); LTC_UNUSED_PARAM(len);
+   while (reps-- > 0) {
+      outlen = sizeof(out);
+      dh_shared_secret(&p->dh, &p->dh2, out, &outlen);
+   }
+}
+#endif
+#endif /* LTC_MRSA || LTC_MECC */
+
+static void bench_pk(unsigned char *buf)
+{
+#if defined(LTC_MRSA) || defined(LTC_MECC)
+   struct pk_ctx p;
+   unsigned char ent[64];
+
+   if (ltc_mp.name == NULL) return;   /* no math provider wired in */
+   p.wprng = find_prng("yarrow");
+   p.hash  = find_hash("sha256");
+   if (p.wprng == -1 || p.hash == -1) return;
+   XMEMSET(ent, 0x5A, sizeof(ent));
+   XMEMSET(p.msg, 0x3C, sizeof(p.msg));
+   if (prng_descriptor[p.wprng].start(&p.prng) != CRYPT_OK) return;
+   prng_descriptor[p.wprng].add_entropy(ent, sizeof(ent), &p.prng);
+   if (prng_descriptor[p.wprng].ready(&p.prng) != CRYPT_OK) return;
+
+#ifdef LTC_MRSA
+   if (rsa_make_key(&p.prng, p.wprng, 2048/8, 65537, &p.rsa) == CRYPT_OK) {
+      bench_one("pk-rsa2048-sign",   "rsa", 0, run_rsa_sign,   &p, buf);
+      bench_one("pk-rsa2048-verify", "rsa", 0, run_rsa_verify, &p, buf);
+      rsa_free(&p.rsa);
+   }
+#endif
+#ifdef LTC_MECC
+   if (ecc_make_key(&p.prng, p.wprng, 32, &p.ecc) == CRYPT_OK) {
+      bench_one("pk-ecc256-sign",   "ecc", 0, run_ecc_sign,   &p, buf);
+      bench_one("pk-ecc256-verify", "ecc", 0, run_ecc_verify, &p, buf);
+      ecc_free(&p.ecc);
+   }
+#endif
+   prng_descriptor[p.wprng].done(&p.prng);
+#else
+   LTC_UNUSED_PARAM(buf);
+#endif
+}
+
+/* per-operation latency distributions for the PK primitives, across a
+ * couple of key sizes each; see bench_lat() */
+static void bench_pk_latency(unsigned char *buf)
 {
+#if defined(LTC_MRSA) || defined(LTC_MECC)
+   struct pk_ctx p;
+   unsigned char ent[64];
+   char name[64];
+   int s;
+#ifdef LTC_MRSA
+   static const int rsa_bits[] = { 1024, 2048 };
+#endif
+#ifdef LTC_MECC
+   static const int ecc_bytes[] = { 24, 32 };
+#endif
+#ifdef LTC_MDH
+   static const int dh_bytes[] = { 128, 192 };
+#endif
 
-init_timer();
-reg_algs();
+   if (ltc_mp.name == NULL) return;
+   p.wprng = find_prng("yarrow");
+   p.hash  = find_hash("sha256");
+   if (p.wprng == -1 || p.hash == -1) return;
+   XMEMSET(ent, 0x5A, sizeof(ent));
+   XMEMSET(p.msg, 0x3C, sizeof(p.msg));
+   if (prng_descriptor[p.wprng].start(&p.prng) != CRYPT_OK) return;
+   prng_descriptor[p.wprng].add_entropy(ent, sizeof(ent), &p.prng);
+   if (prng_descriptor[p.wprng].ready(&p.prng) != CRYPT_OK) return;
+
+#ifdef LTC_MRSA
+   for (s = 0; s < (int)(sizeof(rsa_bits)/sizeof(rsa_bits[0])); s++) {
+      if (rsa_make_key(&p.prng, p.wprng, rsa_bits[s]/8, 65537, &p.rsa) != CRYPT_OK) continue;
+      snprintf(name, sizeof(name), "rsa%d-sign", rsa_bits[s]);
+      bench_lat("pk-latency", name, run_rsa_sign, &p, buf);
+      snprintf(name, sizeof(name), "rsa%d-verify", rsa_bits[s]);
+      bench_lat("pk-latency", name, run_rsa_verify, &p, buf);
+      rsa_free(&p.rsa);
+   }
+#endif
+#ifdef LTC_MECC
+   for (s = 0; s < (int)(sizeof(ecc_bytes)/sizeof(ecc_bytes[0])); s++) {
+      if (ecc_make_key(&p.prng, p.wprng, ecc_bytes[s], &p.ecc) != CRYPT_OK) continue;
+      snprintf(name, sizeof(name), "ecc%d-sign", ecc_bytes[s] * 8);
+      bench_lat("pk-latency", name, run_ecc_sign, &p, buf);
+      snprintf(name, sizeof(name), "ecc%d-verify", ecc_bytes[s] * 8);
+      bench_lat("pk-latency", name, run_ecc_verify, &p, buf);
+      if (ecc_make_key(&p.prng, p.wprng, ecc_bytes[s], &p.ecc2) == CRYPT_OK) {
+         snprintf(name, sizeof(name), "ecdh%d", ecc_bytes[s] * 8);
+         bench_lat("pk-latency", name, run_ecdh, &p, buf);
+         ecc_free(&p.ecc2);
+      }
+      ecc_free(&p.ecc);
+   }
+#endif
+#ifdef LTC_MDH
+   for (s = 0; s < (int)(sizeof(dh_bytes)/sizeof(dh_bytes[0])); s++) {
+      if (dh_make_key(&p.prng, p.wprng, dh_bytes[s], &p.dh) != CRYPT_OK) continue;
+      if (dh_make_key(&p.prng, p.wprng, dh_bytes[s], &p.dh2) == CRYPT_OK) {
+         snprintf(name, sizeof(name), "dh%d", dh_bytes[s] * 8);
+         bench_lat("pk-latency", name, run_dh, &p, buf);
+         dh_free(&p.dh2);
+      }
+      dh_free(&p.dh);
+   }
+#endif
+   prng_descriptor[p.wprng].done(&p.prng);
+#else
+   LTC_UNUSED_PARAM(buf);
+#endif
+}
+
+/* ---- driver -------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+   unsigned char *buf;
+   unsigned long y;
+   int x, s;
+
+   g_out = stdout;
+   for (x = 1; x < argc; x++) {
+      if (XSTRCMP(argv[x], "-q") == 0) {
+         g_sizes  = g_sizes_quick;
+         g_nsizes = (int)(sizeof(g_sizes_quick)/sizeof(g_sizes_quick[0]));
+         g_trials = 3;
+         g_lat_samples = 64;
+      } else if (XSTRCMP(argv[x], "-t") == 0 && x + 1 < argc) {
+         g_trials = atoi(argv[++x]);
+         if (g_trials < 1)  g_trials = 1;
+         if (g_trials > 63) g_trials = 63;
+      } else if (XSTRCMP(argv[x], "-o") == 0 && x + 1 < argc) {
+         g_out = fopen(argv[++x], "w");
+         if (g_out == NULL) { perror(argv[x]); return EXIT_FAILURE; }
+      } else {
+         fprintf(stderr, "usage: %s [-q] [-t trials] [-o outfile]\n", argv[0]);
+         return EXIT_FAILURE;
+      }
+   }
+
+   if (crypt_register_all_descriptors() != CRYPT_OK) {
+      fprintf(stderr, "registering descriptors failed\n");
+      return EXIT_FAILURE;
+   }
 
 #ifdef USE_LTM
    ltc_mp = ltm_desc;
@@ -12,29 +904,41 @@ reg_algs();
    ltc_mp = tfm_desc;
 #elif defined(USE_GMP)
    ltc_mp = gmp_desc;
-#else
-   extern ltc_math_descriptor EXT_MATH_LIB;
-   ltc_mp = EXT_MATH_LIB;
-#endif
-
-time_keysched();
-time_cipher();
-time_cipher2();
-time_cipher3();
-time_cipher4();
-time_hash();
-time_macs();
-time_encmacs();
-time_prng();
-time_mult();
-time_sqr();
-time_rsa();
-time_ecc();
-#ifdef USE_LTM
-time_katja();
 #endif
-return EXIT_SUCCESS;
 
+   perf_init();
+   buf = XMALLOC(MAXBUF);
+   if (buf == NULL) {
+      fprintf(stderr, "out of memory\n");
+      return EXIT_FAILURE;
+   }
+   for (y = 0; y < MAXBUF; y += 4096) {
+      buf[y] = (unsigned char)y; /* fault the pages in */
+   }
+
+   calibrate();
+
+   fprintf(g_out, "{\"library\": \"libtomcrypt " SCRYPT "\",\n");
+   fprintf(g_out, " \"trials\": %d, \"cycle_counter\": %s,\n",
+           g_trials, g_cyc_ns > 0.0 ? "true" : "false");
+   fprintf(g_out, " \"sizes\": [");
+   for (s = 0; s < g_nsizes; s++) {
+      fprintf(g_out, "%s%lu", s ? ", " : "", g_sizes[s]);
+   }
+   fprintf(g_out, "],\n \"results\": [");
+
+   bench_ciphers(buf);
+   bench_mode_overhead(buf);
+   bench_hashes(buf);
+   bench_cipher_macs(buf);
+   bench_prngs(buf);
+   bench_pk(buf);
+   bench_pk_latency(buf);
+
+   fprintf(g_out, "\n]}\n");
+   if (g_out != stdout) fclose(g_out);
+   XFREE(buf);
+   return EXIT_SUCCESS;
 }
 
 /* $Source$ */
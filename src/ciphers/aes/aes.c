@@ -43,13 +43,27 @@
 #define ECB_TEST rijndael_test
 #define ECB_KS   rijndael_keysize
 
+#if defined(LTC_AES_NI)
+#define ECB_ACCEL_ENC rijndael_accel_ecb_encrypt
+#define ECB_ACCEL_DEC rijndael_accel_ecb_decrypt
+#define CBC_ACCEL_ENC rijndael_accel_cbc_encrypt
+#elif defined(LTC_AES_BITSLICE)
+#define ECB_ACCEL_ENC rijndael_bitslice_ecb_encrypt
+#define ECB_ACCEL_DEC NULL
+#define CBC_ACCEL_ENC NULL
+#else
+#define ECB_ACCEL_ENC NULL
+#define ECB_ACCEL_DEC NULL
+#define CBC_ACCEL_ENC NULL
+#endif
+
 const struct ltc_cipher_descriptor rijndael_desc =
 {
     "rijndael",
     6,
     16, 32, 16, 10,
     SETUP, ECB_ENC, ECB_DEC, ECB_TEST, ECB_DONE, ECB_KS,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    ECB_ACCEL_ENC, ECB_ACCEL_DEC, CBC_ACCEL_ENC, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
 };
 
 const struct ltc_cipher_descriptor aes_desc =
@@ -58,7 +72,7 @@ const struct ltc_cipher_descriptor aes_desc =
     6,
     16, 32, 16, 10,
     SETUP, ECB_ENC, ECB_DEC, ECB_TEST, ECB_DONE, ECB_KS,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    ECB_ACCEL_ENC, ECB_ACCEL_DEC, CBC_ACCEL_ENC, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
 };
 
 #else
@@ -68,13 +82,24 @@ const struct ltc_cipher_descriptor aes_desc =
 #define ECB_KS   rijndael_enc_keysize
 #define ECB_DONE rijndael_enc_done
 
+#if defined(LTC_AES_NI)
+#define ECB_ACCEL_ENC rijndael_accel_ecb_encrypt
+#define CBC_ACCEL_ENC rijndael_accel_cbc_encrypt
+#elif defined(LTC_AES_BITSLICE)
+#define ECB_ACCEL_ENC rijndael_bitslice_ecb_encrypt
+#define CBC_ACCEL_ENC NULL
+#else
+#define ECB_ACCEL_ENC NULL
+#define CBC_ACCEL_ENC NULL
+#endif
+
 const struct ltc_cipher_descriptor rijndael_enc_desc =
 {
     "rijndael",
     6,
     16, 32, 16, 10,
     SETUP, ECB_ENC, NULL, NULL, ECB_DONE, ECB_KS,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    ECB_ACCEL_ENC, NULL, CBC_ACCEL_ENC, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
 };
 
 const struct ltc_cipher_descriptor aes_enc_desc =
@@ -83,7 +108,7 @@ const struct ltc_cipher_descriptor aes_enc_desc =
     6,
     16, 32, 16, 10,
     SETUP, ECB_ENC, NULL, NULL, ECB_DONE, ECB_KS,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    ECB_ACCEL_ENC, NULL, CBC_ACCEL_ENC, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
 };
 
 #endif
@@ -137,7 +162,16 @@ int SETUP(const unsigned char *key, int keylen, int num_rounds, symmetric_key *s
        return CRYPT_INVALID_ROUNDS;
     }
 
+#ifdef LTC_AES_KEYCACHE
+    if (rijndael_keycache_lookup(key, keylen, num_rounds, skey) == CRYPT_OK) {
+       return CRYPT_OK;
+    }
+#endif
+
     skey->rijndael.Nr = 10 + ((keylen/8)-2)*2;
+#ifdef LTC_AES_COMPACT
+    skey->rijndael.compact = 0;
+#endif
 
     /* setup the forward key */
     i                 = 0;
@@ -272,6 +306,23 @@ int SETUP(const unsigned char *key, int keylen, int num_rounds, symmetric_key *s
     *rk   = *rrk;
 #endif /* ENCRYPT_ONLY */
 
+#ifdef LTC_AES_NI
+    /* hand the schedule over to the hardware path when we have one */
+    if (rijndael_aesni_enabled()) {
+       rijndael_aesni_setup(skey);
+    }
+#endif
+#ifdef LTC_AES_ARMV8
+    if (rijndael_armv8_enabled()) {
+       rijndael_armv8_setup(skey);
+    }
+#endif
+
+#ifdef LTC_AES_KEYCACHE
+    /* cache the final (possibly hardware-layout) schedule */
+    rijndael_keycache_store(key, keylen, num_rounds, skey);
+#endif
+
     return CRYPT_OK;
 }
 
@@ -295,6 +346,24 @@ int ECB_ENC(const unsigned char *pt, unsigned char *ct, symmetric_key *skey)
     LTC_ARGCHK(ct != NULL);
     LTC_ARGCHK(skey != NULL);
 
+#ifdef LTC_AES_NI
+    if (rijndael_aesni_enabled()) {
+       rijndael_aesni_ecb_encrypt(pt, ct, skey);
+       return CRYPT_OK;
+    }
+#endif
+#ifdef LTC_AES_ARMV8
+    if (rijndael_armv8_enabled()) {
+       rijndael_armv8_ecb_encrypt(pt, ct, skey);
+       return CRYPT_OK;
+    }
+#endif
+#ifdef LTC_AES_COMPACT
+    if (skey->rijndael.compact) {
+       return rijndael_compact_ecb_encrypt(pt, ct, skey);
+    }
+#endif
+
     Nr = skey->rijndael.Nr;
     rk = skey->rijndael.eK;
 
@@ -474,6 +543,24 @@ int ECB_DEC(const unsigned char *ct, unsigned char *pt, symmetric_key *skey)
     LTC_ARGCHK(ct != NULL);
     LTC_ARGCHK(skey != NULL);
 
+#ifdef LTC_AES_NI
+    if (rijndael_aesni_enabled()) {
+       rijndael_aesni_ecb_decrypt(ct, pt, skey);
+       return CRYPT_OK;
+    }
+#endif
+#ifdef LTC_AES_ARMV8
+    if (rijndael_armv8_enabled()) {
+       rijndael_armv8_ecb_decrypt(ct, pt, skey);
+       return CRYPT_OK;
+    }
+#endif
+#ifdef LTC_AES_COMPACT
+    if (skey->rijndael.compact) {
+       return rijndael_compact_ecb_decrypt(ct, pt, skey);
+    }
+#endif
+
     Nr = skey->rijndael.Nr;
     rk = skey->rijndael.dK;
 
@@ -0,0 +1,116 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file aes_armv8.c
+  ARMv8 Crypto Extensions backend for AES (Rijndael), selected at
+  run-time from aes.c.  Mirrors the layout used by the AES-NI backend:
+  rijndael_setup builds the schedule as usual, then the round keys are
+  re-serialized into raw bytes for AESE/AESD.
+*/
+
+#if defined(LTC_RIJNDAEL) && defined(LTC_AES_ARMV8)
+
+#include <arm_neon.h>
+
+/**
+  Query whether the CPU executing us provides the AES instructions.
+  The result is cached by ltc_cpu_features().
+  @return 1 if the ARMv8 AES extension is available, 0 otherwise
+*/
+int rijndael_armv8_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_AES) != 0;
+}
+
+/* build the decryption schedule from the (already converted) encryption
+ * schedule; AESD wants the InvMixColumns transform of the middle round keys
+ */
+static void _armv8_invert_schedule(symmetric_key *skey)
+{
+   unsigned char *ek = (unsigned char *)skey->rijndael.eK;
+   unsigned char *dk = (unsigned char *)skey->rijndael.dK;
+   int            i, Nr = skey->rijndael.Nr;
+
+   vst1q_u8(dk, vld1q_u8(ek + (Nr << 4)));
+   for (i = 1; i < Nr; i++) {
+      vst1q_u8(dk + (i << 4), vaesimcq_u8(vld1q_u8(ek + ((Nr - i) << 4))));
+   }
+   vst1q_u8(dk + (Nr << 4), vld1q_u8(ek));
+}
+
+/**
+  Convert a scheduled key into the layout the ARMv8 code expects.
+  @param skey   The scheduled key to convert
+*/
+void rijndael_armv8_setup(symmetric_key *skey)
+{
+   unsigned char *ek = (unsigned char *)skey->rijndael.eK;
+   ulong32        t;
+   int            i;
+
+   for (i = 0; i < 4 * (skey->rijndael.Nr + 1); i++) {
+      t = skey->rijndael.eK[i];
+      STORE32H(t, ek + 4*i);
+   }
+   _armv8_invert_schedule(skey);
+}
+
+/**
+  Encrypt a block of text with the ARMv8 AES extension
+  @param pt The input plaintext (16 bytes)
+  @param ct The output ciphertext (16 bytes)
+  @param skey The key as scheduled by rijndael_armv8_setup
+*/
+void rijndael_armv8_ecb_encrypt(const unsigned char *pt, unsigned char *ct, const symmetric_key *skey)
+{
+   const unsigned char *rk = (const unsigned char *)skey->rijndael.eK;
+   int                  r,  Nr = skey->rijndael.Nr;
+   uint8x16_t           b;
+
+   b = vld1q_u8(pt);
+   /* AESE adds the round key itself, so the loop runs a round "early" and
+    * the final AddRoundKey is a plain XOR */
+   for (r = 0; r < Nr - 1; r++) {
+      b = vaesmcq_u8(vaeseq_u8(b, vld1q_u8(rk + (r << 4))));
+   }
+   b = vaeseq_u8(b, vld1q_u8(rk + ((Nr - 1) << 4)));
+   b = veorq_u8(b, vld1q_u8(rk + (Nr << 4)));
+   vst1q_u8(ct, b);
+}
+
+/**
+  Decrypt a block of text with the ARMv8 AES extension
+  @param ct The input ciphertext (16 bytes)
+  @param pt The output plaintext (16 bytes)
+  @param skey The key as scheduled by rijndael_armv8_setup
+*/
+void rijndael_armv8_ecb_decrypt(const unsigned char *ct, unsigned char *pt, const symmetric_key *skey)
+{
+   const unsigned char *rk = (const unsigned char *)skey->rijndael.dK;
+   int                  r,  Nr = skey->rijndael.Nr;
+   uint8x16_t           b;
+
+   b = vld1q_u8(ct);
+   for (r = 0; r < Nr - 1; r++) {
+      b = vaesimcq_u8(vaesdq_u8(b, vld1q_u8(rk + (r << 4))));
+   }
+   b = vaesdq_u8(b, vld1q_u8(rk + ((Nr - 1) << 4)));
+   b = veorq_u8(b, vld1q_u8(rk + (Nr << 4)));
+   vst1q_u8(pt, b);
+}
+
+#endif /* LTC_RIJNDAEL && LTC_AES_ARMV8 */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,302 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file aes_bitslice.c
+  Constant-time bitsliced AES encryption, four blocks per invocation.
+  The state of four blocks is kept as eight 64-bit bit planes (plane b
+  holds bit b of all 64 state bytes), SubBytes is computed as a GF(2^8)
+  inversion plus the affine map, so no data-dependent memory access is
+  made at all.  Used as the batched accel_ecb fallback on CPUs without
+  hardware AES.
+*/
+
+#if defined(LTC_RIJNDAEL) && defined(LTC_AES_BITSLICE)
+
+/* mask of the bytes with row index r (bit position ≡ r mod 4) */
+#define BS_ROW(r)   (CONST64(0x1111111111111111) << (r))
+/* low n bits of every 16-bit (one block) lane */
+#define BS_LANE_LO(n) (CONST64(0x0001000100010001) * (((ulong64)1 << (n)) - 1))
+
+/* 8x8 bit matrix transpose (Hacker's Delight), an involution */
+static ulong64 _bs_transpose8(ulong64 x)
+{
+   ulong64 t;
+   t = (x ^ (x >>  7)) & CONST64(0x00AA00AA00AA00AA); x = x ^ t ^ (t <<  7);
+   t = (x ^ (x >> 14)) & CONST64(0x0000CCCC0000CCCC); x = x ^ t ^ (t << 14);
+   t = (x ^ (x >> 28)) & CONST64(0x00000000F0F0F0F0); x = x ^ t ^ (t << 28);
+   return x;
+}
+
+/* 64 bytes (four blocks) -> eight bit planes */
+static void _bs_load(ulong64 p[8], const unsigned char *in)
+{
+   ulong64 w;
+   int     g, b;
+
+   for (b = 0; b < 8; b++) {
+      p[b] = 0;
+   }
+   for (g = 0; g < 8; g++) {
+      w = 0;
+      for (b = 0; b < 8; b++) {
+         w |= (ulong64)in[8*g + b] << (8*b);
+      }
+      w = _bs_transpose8(w);
+      for (b = 0; b < 8; b++) {
+         p[b] |= ((w >> (8*b)) & 255) << (8*g);
+      }
+   }
+}
+
+/* eight bit planes -> 64 bytes */
+static void _bs_store(unsigned char *out, const ulong64 p[8])
+{
+   ulong64 w;
+   int     g, b;
+
+   for (g = 0; g < 8; g++) {
+      w = 0;
+      for (b = 0; b < 8; b++) {
+         w |= ((p[b] >> (8*g)) & 255) << (8*b);
+      }
+      w = _bs_transpose8(w);
+      for (b = 0; b < 8; b++) {
+         out[8*g + b] = (unsigned char)((w >> (8*b)) & 255);
+      }
+   }
+}
+
+/* sliced multiplication in GF(2^8)/0x11B, schoolbook with folding */
+static void _bs_mul(ulong64 r[8], const ulong64 a[8], const ulong64 b[8])
+{
+   ulong64 c[15];
+   int     i, j;
+
+   for (i = 0; i < 15; i++) {
+      c[i] = 0;
+   }
+   for (i = 0; i < 8; i++) {
+      for (j = 0; j < 8; j++) {
+         c[i+j] ^= a[i] & b[j];
+      }
+   }
+   /* x^8 = x^4 + x^3 + x + 1 */
+   for (i = 14; i >= 8; i--) {
+      c[i-8] ^= c[i];
+      c[i-7] ^= c[i];
+      c[i-5] ^= c[i];
+      c[i-4] ^= c[i];
+   }
+   for (i = 0; i < 8; i++) {
+      r[i] = c[i];
+   }
+}
+
+/* sliced squaring, the linear map x -> x^2 over GF(2^8)/0x11B */
+static void _bs_sqr(ulong64 r[8], const ulong64 a[8])
+{
+   ulong64 t[8];
+   t[0] = a[0] ^ a[4] ^ a[6];
+   t[1] = a[4] ^ a[6] ^ a[7];
+   t[2] = a[1] ^ a[5];
+   t[3] = a[4] ^ a[5] ^ a[6] ^ a[7];
+   t[4] = a[2] ^ a[4] ^ a[7];
+   t[5] = a[5] ^ a[6];
+   t[6] = a[3] ^ a[5];
+   t[7] = a[6] ^ a[7];
+   XMEMCPY(r, t, sizeof(t));
+}
+
+/* SubBytes: x^254 (inversion, with 0 -> 0 for free) then the affine map */
+static void _bs_sub_bytes(ulong64 p[8])
+{
+   ulong64 x2[8], x3[8], x12[8], x15[8], t[8];
+   int     i;
+
+   _bs_sqr(x2, p);            /* x^2   */
+   _bs_mul(x3, x2, p);        /* x^3   */
+   _bs_sqr(t, x3);
+   _bs_sqr(x12, t);           /* x^12  */
+   _bs_mul(x15, x12, x3);     /* x^15  */
+   _bs_sqr(t, x15);
+   _bs_sqr(t, t);
+   _bs_sqr(t, t);
+   _bs_sqr(t, t);             /* x^240 */
+   _bs_mul(t, t, x12);        /* x^252 */
+   _bs_mul(t, t, x2);         /* x^254 = x^-1 */
+
+   for (i = 0; i < 8; i++) {
+      p[i] = t[i] ^ t[(i+4)&7] ^ t[(i+5)&7] ^ t[(i+6)&7] ^ t[(i+7)&7];
+   }
+   p[0] = ~p[0];
+   p[1] = ~p[1];
+   p[5] = ~p[5];
+   p[6] = ~p[6];
+}
+
+/* rotate the row-r bytes left by r columns, within each block's 16-bit lane */
+static void _bs_shift_rows(ulong64 p[8])
+{
+   ulong64 x, y, v;
+   int     b, r;
+
+   for (b = 0; b < 8; b++) {
+      x = p[b];
+      y = x & BS_ROW(0);
+      for (r = 1; r < 4; r++) {
+         v  = x & BS_ROW(r);
+         y |= ((v & ~BS_LANE_LO(4*r)) >> (4*r)) | ((v & BS_LANE_LO(4*r)) << (16 - 4*r));
+      }
+      p[b] = y;
+   }
+}
+
+/* rotate every 4-byte column group up by one row */
+static void _bs_rot_col1(ulong64 d[8], const ulong64 s[8])
+{
+   int b;
+   for (b = 0; b < 8; b++) {
+      d[b] = ((s[b] & ~BS_ROW(0)) >> 1) | ((s[b] & BS_ROW(0)) << 3);
+   }
+}
+
+/* sliced xtime: multiply every byte by 2 */
+static void _bs_xtime(ulong64 d[8], const ulong64 s[8])
+{
+   ulong64 t7 = s[7];
+   d[7] = s[6];
+   d[6] = s[5];
+   d[5] = s[4];
+   d[4] = s[3] ^ t7;
+   d[3] = s[2] ^ t7;
+   d[2] = s[1];
+   d[1] = s[0] ^ t7;
+   d[0] = t7;
+}
+
+static void _bs_mix_columns(ulong64 p[8])
+{
+   ulong64 a1[8], a2[8], a3[8], x[8], x1[8];
+   int     b;
+
+   _bs_rot_col1(a1, p);
+   _bs_rot_col1(a2, a1);
+   _bs_rot_col1(a3, a2);
+   _bs_xtime(x,  p);
+   _bs_xtime(x1, a1);
+   for (b = 0; b < 8; b++) {
+      p[b] = x[b] ^ x1[b] ^ a1[b] ^ a2[b] ^ a3[b];
+   }
+}
+
+/* slice one round key (replicated over the four block lanes) */
+static void _bs_slice_key(ulong64 rk[8], const ulong32 *ek)
+{
+   unsigned char kb[16];
+   ulong64       w, lo;
+   ulong32       t;
+   int           g, b;
+
+   for (g = 0; g < 4; g++) {
+      t = ek[g];
+      STORE32H(t, kb + 4*g);
+   }
+   for (b = 0; b < 8; b++) {
+      rk[b] = 0;
+   }
+   for (g = 0; g < 2; g++) {
+      w = 0;
+      for (b = 0; b < 8; b++) {
+         w |= (ulong64)kb[8*g + b] << (8*b);
+      }
+      w = _bs_transpose8(w);
+      for (b = 0; b < 8; b++) {
+         rk[b] |= ((w >> (8*b)) & 255) << (8*g);
+      }
+   }
+   /* replicate the 16 key bits into all four lanes */
+   for (b = 0; b < 8; b++) {
+      lo = rk[b] & 0xFFFF;
+      rk[b] = lo * CONST64(0x0001000100010001);
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(kb, sizeof(kb));
+#endif
+}
+
+/* encrypt four blocks in constant time */
+static void _bs_encrypt4(const unsigned char *pt, unsigned char *ct, const symmetric_key *skey)
+{
+   ulong64 p[8], rk[8];
+   int     r, b, Nr = skey->rijndael.Nr;
+
+   _bs_load(p, pt);
+   _bs_slice_key(rk, skey->rijndael.eK);
+   for (b = 0; b < 8; b++) {
+      p[b] ^= rk[b];
+   }
+   for (r = 1; r < Nr; r++) {
+      _bs_sub_bytes(p);
+      _bs_shift_rows(p);
+      _bs_mix_columns(p);
+      _bs_slice_key(rk, skey->rijndael.eK + 4*r);
+      for (b = 0; b < 8; b++) {
+         p[b] ^= rk[b];
+      }
+   }
+   _bs_sub_bytes(p);
+   _bs_shift_rows(p);
+   _bs_slice_key(rk, skey->rijndael.eK + 4*Nr);
+   for (b = 0; b < 8; b++) {
+      p[b] ^= rk[b];
+   }
+   _bs_store(ct, p);
+#ifdef LTC_CLEAN_STACK
+   zeromem(p,  sizeof(p));
+   zeromem(rk, sizeof(rk));
+#endif
+}
+
+/**
+  Constant-time batched ECB encrypt (accel_ecb_encrypt signature)
+  @param pt     Plaintext
+  @param ct     [out] Ciphertext
+  @param blocks The number of complete blocks to process
+  @param skey   The key as scheduled by rijndael_setup
+  @return CRYPT_OK if successful
+*/
+int rijndael_bitslice_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey)
+{
+   unsigned char tmp[64];
+   unsigned long partial;
+
+   while (blocks >= 4) {
+      _bs_encrypt4(pt, ct, skey);
+      pt += 64; ct += 64; blocks -= 4;
+   }
+   if (blocks > 0) {
+      partial = 16 * blocks;
+      zeromem(tmp, sizeof(tmp));
+      XMEMCPY(tmp, pt, partial);
+      _bs_encrypt4(tmp, tmp, skey);
+      XMEMCPY(ct, tmp, partial);
+      zeromem(tmp, sizeof(tmp));
+   }
+   return CRYPT_OK;
+}
+
+#endif /* LTC_RIJNDAEL && LTC_AES_BITSLICE */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,210 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file aes_compact.c
+  Cache-resident AES variant: a single 256 byte sbox (plus its inverse)
+  and on-the-fly MixColumns instead of the 4x1KB Te/Td tables.  Selected
+  per key via rijndael_setup_compact for workloads where the big tables'
+  cache footprint hurts more than the extra arithmetic.
+*/
+
+#if defined(LTC_RIJNDAEL) && defined(LTC_AES_COMPACT)
+
+static const unsigned char sbox[256] = {
+   0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+   0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+   0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+   0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+   0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+   0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+   0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+   0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+   0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+   0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+   0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+   0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+   0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+   0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+   0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+   0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+static const unsigned char isbox[256] = {
+   0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
+   0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
+   0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
+   0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25,
+   0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92,
+   0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
+   0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06,
+   0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b,
+   0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
+   0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e,
+   0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b,
+   0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
+   0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f,
+   0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef,
+   0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
+   0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d
+};
+
+/* multiply by 2 in GF(2^8)/0x11B, branch free */
+#define XT(x) ((unsigned char)(((x) << 1) ^ ((((x) >> 7) & 1) * 0x1B)))
+
+/* serialize one round key from the big endian word schedule */
+static void _compact_rk(unsigned char *rk, const ulong32 *ek)
+{
+   ulong32 t;
+   int     w;
+   for (w = 0; w < 4; w++) {
+      t = ek[w];
+      STORE32H(t, rk + 4*w);
+   }
+}
+
+/**
+  Initialize AES for the compact, cache-resident code path
+  @param key The symmetric key you wish to pass
+  @param keylen The key length in bytes
+  @param num_rounds The number of rounds desired (0 for default)
+  @param skey The key in as scheduled by this function.
+  @return CRYPT_OK if successful
+*/
+int rijndael_setup_compact(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey)
+{
+   int err;
+   if ((err = rijndael_setup(key, keylen, num_rounds, skey)) != CRYPT_OK) {
+      return err;
+   }
+#ifdef LTC_AES_NI
+   /* with hardware AES the big tables are never touched anyway */
+   if (rijndael_aesni_enabled()) {
+      return CRYPT_OK;
+   }
+#endif
+#ifdef LTC_AES_ARMV8
+   if (rijndael_armv8_enabled()) {
+      return CRYPT_OK;
+   }
+#endif
+   skey->rijndael.compact = 1;
+   return CRYPT_OK;
+}
+
+/**
+  Encrypt a block with the 256-byte-table code path
+  @param pt The input plaintext (16 bytes)
+  @param ct The output ciphertext (16 bytes)
+  @param skey The key as scheduled by rijndael_setup_compact
+  @return CRYPT_OK if successful
+*/
+int rijndael_compact_ecb_encrypt(const unsigned char *pt, unsigned char *ct, const symmetric_key *skey)
+{
+   unsigned char s[16], t[16], rk[16];
+   unsigned char a, b, c, d, e;
+   int           i, r, Nr = skey->rijndael.Nr;
+
+   _compact_rk(rk, skey->rijndael.eK);
+   for (i = 0; i < 16; i++) {
+      s[i] = pt[i] ^ rk[i];
+   }
+
+   for (r = 1; r <= Nr; r++) {
+      /* SubBytes + ShiftRows: t[4c+r'] = sbox[s[4((c+r')%4)+r']] */
+      for (i = 0; i < 16; i++) {
+         t[i] = sbox[s[(i + 4*(i & 3)) & 15]];
+      }
+      _compact_rk(rk, skey->rijndael.eK + 4*r);
+      if (r < Nr) {
+         /* MixColumns folded with AddRoundKey */
+         for (i = 0; i < 16; i += 4) {
+            a = t[i]; b = t[i+1]; c = t[i+2]; d = t[i+3];
+            e = a ^ b ^ c ^ d;
+            s[i]   = a ^ e ^ XT(a ^ b) ^ rk[i];
+            s[i+1] = b ^ e ^ XT(b ^ c) ^ rk[i+1];
+            s[i+2] = c ^ e ^ XT(c ^ d) ^ rk[i+2];
+            s[i+3] = d ^ e ^ XT(d ^ a) ^ rk[i+3];
+         }
+      } else {
+         for (i = 0; i < 16; i++) {
+            s[i] = t[i] ^ rk[i];
+         }
+      }
+   }
+   XMEMCPY(ct, s, 16);
+#ifdef LTC_CLEAN_STACK
+   zeromem(s,  sizeof(s));
+   zeromem(t,  sizeof(t));
+   zeromem(rk, sizeof(rk));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Decrypt a block with the 256-byte-table code path
+  @param ct The input ciphertext (16 bytes)
+  @param pt The output plaintext (16 bytes)
+  @param skey The key as scheduled by rijndael_setup_compact
+  @return CRYPT_OK if successful
+*/
+int rijndael_compact_ecb_decrypt(const unsigned char *ct, unsigned char *pt, const symmetric_key *skey)
+{
+   unsigned char s[16], t[16], rk[16];
+   unsigned char a, b, c, d, x, y, z;
+   int           i, r, Nr = skey->rijndael.Nr;
+
+   /* straight inverse cipher over the forward schedule */
+   _compact_rk(rk, skey->rijndael.eK + 4*Nr);
+   for (i = 0; i < 16; i++) {
+      s[i] = ct[i] ^ rk[i];
+   }
+
+   for (r = Nr - 1; r >= 0; r--) {
+      /* InvShiftRows + InvSubBytes: t[4c+r'] = isbox[s[4((c-r')%4)+r']] */
+      for (i = 0; i < 16; i++) {
+         t[i] = isbox[s[(i - 4*(i & 3)) & 15]];
+      }
+      _compact_rk(rk, skey->rijndael.eK + 4*r);
+      for (i = 0; i < 16; i++) {
+         t[i] ^= rk[i];
+      }
+      if (r > 0) {
+         /* InvMixColumns as MixColumns preceded by the {04}-preprocessing step */
+         for (i = 0; i < 16; i += 4) {
+            a = t[i]; b = t[i+1]; c = t[i+2]; d = t[i+3];
+            x = XT(XT(a ^ c)); y = XT(XT(b ^ d));
+            a ^= x; b ^= y; c ^= x; d ^= y;
+            z = a ^ b ^ c ^ d;
+            s[i]   = a ^ z ^ XT(a ^ b);
+            s[i+1] = b ^ z ^ XT(b ^ c);
+            s[i+2] = c ^ z ^ XT(c ^ d);
+            s[i+3] = d ^ z ^ XT(d ^ a);
+         }
+      } else {
+         XMEMCPY(s, t, 16);
+      }
+   }
+   XMEMCPY(pt, s, 16);
+#ifdef LTC_CLEAN_STACK
+   zeromem(s,  sizeof(s));
+   zeromem(t,  sizeof(t));
+   zeromem(rk, sizeof(rk));
+#endif
+   return CRYPT_OK;
+}
+
+#endif /* LTC_RIJNDAEL && LTC_AES_COMPACT */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,123 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file aes_keycache.c
+  Bounded LRU cache of expanded AES key schedules.  Opt-in via
+  LTC_AES_KEYCACHE: workloads that re-key with recently seen keys
+  (TLS terminators and the like) skip the key expansion entirely and
+  get a copy of the cached schedule instead.  Note the cache keeps the
+  raw key bytes for comparison, so only enable it where that is an
+  acceptable trade against your threat model.
+*/
+
+#if defined(LTC_RIJNDAEL) && defined(LTC_AES_KEYCACHE)
+
+#ifndef LTC_AES_KEYCACHE_SIZE
+#define LTC_AES_KEYCACHE_SIZE 16
+#endif
+
+typedef struct {
+   unsigned char key[32];
+   int           keylen;      /* 0 == empty slot */
+   int           num_rounds;
+   ulong64       stamp;       /* last use, for LRU eviction */
+   symmetric_key skey;
+} aes_keycache_entry;
+
+static aes_keycache_entry cache[LTC_AES_KEYCACHE_SIZE];
+static ulong64            cache_clock;
+LTC_MUTEX_GLOBAL(ltc_aes_keycache_mutex)
+
+/**
+  Look up a scheduled key by its raw key bytes
+  @param key         The symmetric key
+  @param keylen      The length of the key (octets)
+  @param num_rounds  The number of rounds (as given to rijndael_setup)
+  @param skey        [out] Receives a copy of the cached schedule on a hit
+  @return CRYPT_OK on a hit, CRYPT_ERROR on a miss
+*/
+int rijndael_keycache_lookup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey)
+{
+   int x, err;
+
+   LTC_ARGCHK(key  != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   if (keylen < 16 || keylen > 32) {
+      return CRYPT_ERROR;
+   }
+
+   err = CRYPT_ERROR;
+   LTC_MUTEX_LOCK(&ltc_aes_keycache_mutex);
+   for (x = 0; x < LTC_AES_KEYCACHE_SIZE; x++) {
+      if (cache[x].keylen == keylen && cache[x].num_rounds == num_rounds &&
+          XMEM_NEQ(cache[x].key, key, (size_t)keylen) == 0) {
+         XMEMCPY(skey, &cache[x].skey, sizeof(*skey));
+         cache[x].stamp = ++cache_clock;
+         err = CRYPT_OK;
+         break;
+      }
+   }
+   LTC_MUTEX_UNLOCK(&ltc_aes_keycache_mutex);
+   return err;
+}
+
+/**
+  Store a freshly expanded schedule, evicting the least recently used slot
+  @param key         The symmetric key
+  @param keylen      The length of the key (octets)
+  @param num_rounds  The number of rounds (as given to rijndael_setup)
+  @param skey        The scheduled key to cache
+*/
+void rijndael_keycache_store(const unsigned char *key, int keylen, int num_rounds, const symmetric_key *skey)
+{
+   int x, victim;
+
+   if (key == NULL || skey == NULL || keylen < 16 || keylen > 32) {
+      return;
+   }
+
+   LTC_MUTEX_LOCK(&ltc_aes_keycache_mutex);
+   victim = 0;
+   for (x = 0; x < LTC_AES_KEYCACHE_SIZE; x++) {
+      if (cache[x].keylen == 0) {
+         victim = x;
+         break;
+      }
+      if (cache[x].stamp < cache[victim].stamp) {
+         victim = x;
+      }
+   }
+   XMEMCPY(cache[victim].key, key, (size_t)keylen);
+   cache[victim].keylen     = keylen;
+   cache[victim].num_rounds = num_rounds;
+   cache[victim].stamp      = ++cache_clock;
+   XMEMCPY(&cache[victim].skey, skey, sizeof(*skey));
+   LTC_MUTEX_UNLOCK(&ltc_aes_keycache_mutex);
+}
+
+/**
+  Flush the cache, e.g. on key rotation; zeroizes all cached key material
+*/
+void rijndael_keycache_flush(void)
+{
+   LTC_MUTEX_LOCK(&ltc_aes_keycache_mutex);
+   zeromem(cache, sizeof(cache));
+   LTC_MUTEX_UNLOCK(&ltc_aes_keycache_mutex);
+}
+
+#endif /* LTC_RIJNDAEL && LTC_AES_KEYCACHE */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
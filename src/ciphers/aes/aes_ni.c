@@ -0,0 +1,326 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file aes_ni.c
+  AES-NI backend for AES (Rijndael), selected at run-time from aes.c
+*/
+
+#if defined(LTC_RIJNDAEL) && defined(LTC_AES_NI)
+
+#include <wmmintrin.h>
+
+#define LTC_AESNI_CALL __attribute__((target("aes,sse2")))
+
+/**
+  Query whether the CPU executing us provides the AES instructions.
+  The result is cached so the CPUID dance only happens once.
+  @return 1 if AES-NI is available, 0 otherwise
+*/
+int rijndael_aesni_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_AES) != 0;
+}
+
+/* build the decryption schedule from the (already converted) encryption
+ * schedule; AESDEC wants the InvMixColumns transform of the middle round keys
+ */
+LTC_AESNI_CALL
+static void _aesni_invert_schedule(symmetric_key *skey)
+{
+   unsigned char *ek = (unsigned char *)skey->rijndael.eK;
+   unsigned char *dk = (unsigned char *)skey->rijndael.dK;
+   int            i, Nr = skey->rijndael.Nr;
+
+   _mm_storeu_si128((__m128i*)dk, _mm_loadu_si128((__m128i*)(ek + (Nr << 4))));
+   for (i = 1; i < Nr; i++) {
+      _mm_storeu_si128((__m128i*)(dk + (i << 4)),
+                       _mm_aesimc_si128(_mm_loadu_si128((__m128i*)(ek + ((Nr - i) << 4)))));
+   }
+   _mm_storeu_si128((__m128i*)(dk + (Nr << 4)), _mm_loadu_si128((__m128i*)ek));
+}
+
+/**
+  Convert a scheduled key into the layout the AES-NI code expects.
+  rijndael_setup stores the forward schedule as big endian 32-bit words;
+  AESENC consumes the raw round key bytes, so re-serialize in place and
+  rebuild the decryption schedule with AESIMC.
+  @param skey   The scheduled key to convert
+*/
+void rijndael_aesni_setup(symmetric_key *skey)
+{
+   unsigned char *ek = (unsigned char *)skey->rijndael.eK;
+   ulong32        t;
+   int            i;
+
+   for (i = 0; i < 4 * (skey->rijndael.Nr + 1); i++) {
+      t = skey->rijndael.eK[i];
+      STORE32H(t, ek + 4*i);
+   }
+   _aesni_invert_schedule(skey);
+}
+
+/**
+  Encrypt a block of text with AES-NI
+  @param pt The input plaintext (16 bytes)
+  @param ct The output ciphertext (16 bytes)
+  @param skey The key as scheduled by rijndael_aesni_setup
+*/
+LTC_AESNI_CALL
+void rijndael_aesni_ecb_encrypt(const unsigned char *pt, unsigned char *ct, const symmetric_key *skey)
+{
+   const unsigned char *rk = (const unsigned char *)skey->rijndael.eK;
+   int                  r,  Nr = skey->rijndael.Nr;
+   __m128i              b;
+
+   b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)pt),
+                     _mm_loadu_si128((const __m128i*)rk));
+   for (r = 1; r < Nr; r++) {
+      b = _mm_aesenc_si128(b, _mm_loadu_si128((const __m128i*)(rk + (r << 4))));
+   }
+   b = _mm_aesenclast_si128(b, _mm_loadu_si128((const __m128i*)(rk + (Nr << 4))));
+   _mm_storeu_si128((__m128i*)ct, b);
+}
+
+/**
+  Decrypt a block of text with AES-NI
+  @param ct The input ciphertext (16 bytes)
+  @param pt The output plaintext (16 bytes)
+  @param skey The key as scheduled by rijndael_aesni_setup
+*/
+LTC_AESNI_CALL
+void rijndael_aesni_ecb_decrypt(const unsigned char *ct, unsigned char *pt, const symmetric_key *skey)
+{
+   const unsigned char *rk = (const unsigned char *)skey->rijndael.dK;
+   int                  r,  Nr = skey->rijndael.Nr;
+   __m128i              b;
+
+   b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)ct),
+                     _mm_loadu_si128((const __m128i*)rk));
+   for (r = 1; r < Nr; r++) {
+      b = _mm_aesdec_si128(b, _mm_loadu_si128((const __m128i*)(rk + (r << 4))));
+   }
+   b = _mm_aesdeclast_si128(b, _mm_loadu_si128((const __m128i*)(rk + (Nr << 4))));
+   _mm_storeu_si128((__m128i*)pt, b);
+}
+
+/* eight independent blocks keep the AESENC pipeline full; one block at a
+ * time leaves most of its throughput on the table
+ */
+LTC_AESNI_CALL
+static void _aesni_ecb_encrypt8(const unsigned char *pt, unsigned char *ct, const symmetric_key *skey)
+{
+   const unsigned char *rk = (const unsigned char *)skey->rijndael.eK;
+   int                  r,  Nr = skey->rijndael.Nr;
+   __m128i              k, b0, b1, b2, b3, b4, b5, b6, b7;
+
+   k  = _mm_loadu_si128((const __m128i*)rk);
+   b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pt +   0)), k);
+   b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pt +  16)), k);
+   b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pt +  32)), k);
+   b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pt +  48)), k);
+   b4 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pt +  64)), k);
+   b5 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pt +  80)), k);
+   b6 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pt +  96)), k);
+   b7 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(pt + 112)), k);
+   for (r = 1; r < Nr; r++) {
+      k  = _mm_loadu_si128((const __m128i*)(rk + (r << 4)));
+      b0 = _mm_aesenc_si128(b0, k);
+      b1 = _mm_aesenc_si128(b1, k);
+      b2 = _mm_aesenc_si128(b2, k);
+      b3 = _mm_aesenc_si128(b3, k);
+      b4 = _mm_aesenc_si128(b4, k);
+      b5 = _mm_aesenc_si128(b5, k);
+      b6 = _mm_aesenc_si128(b6, k);
+      b7 = _mm_aesenc_si128(b7, k);
+   }
+   k = _mm_loadu_si128((const __m128i*)(rk + (Nr << 4)));
+   _mm_storeu_si128((__m128i*)(ct +   0), _mm_aesenclast_si128(b0, k));
+   _mm_storeu_si128((__m128i*)(ct +  16), _mm_aesenclast_si128(b1, k));
+   _mm_storeu_si128((__m128i*)(ct +  32), _mm_aesenclast_si128(b2, k));
+   _mm_storeu_si128((__m128i*)(ct +  48), _mm_aesenclast_si128(b3, k));
+   _mm_storeu_si128((__m128i*)(ct +  64), _mm_aesenclast_si128(b4, k));
+   _mm_storeu_si128((__m128i*)(ct +  80), _mm_aesenclast_si128(b5, k));
+   _mm_storeu_si128((__m128i*)(ct +  96), _mm_aesenclast_si128(b6, k));
+   _mm_storeu_si128((__m128i*)(ct + 112), _mm_aesenclast_si128(b7, k));
+}
+
+LTC_AESNI_CALL
+static void _aesni_ecb_decrypt8(const unsigned char *ct, unsigned char *pt, const symmetric_key *skey)
+{
+   const unsigned char *rk = (const unsigned char *)skey->rijndael.dK;
+   int                  r,  Nr = skey->rijndael.Nr;
+   __m128i              k, b0, b1, b2, b3, b4, b5, b6, b7;
+
+   k  = _mm_loadu_si128((const __m128i*)rk);
+   b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(ct +   0)), k);
+   b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(ct +  16)), k);
+   b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(ct +  32)), k);
+   b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(ct +  48)), k);
+   b4 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(ct +  64)), k);
+   b5 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(ct +  80)), k);
+   b6 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(ct +  96)), k);
+   b7 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(ct + 112)), k);
+   for (r = 1; r < Nr; r++) {
+      k  = _mm_loadu_si128((const __m128i*)(rk + (r << 4)));
+      b0 = _mm_aesdec_si128(b0, k);
+      b1 = _mm_aesdec_si128(b1, k);
+      b2 = _mm_aesdec_si128(b2, k);
+      b3 = _mm_aesdec_si128(b3, k);
+      b4 = _mm_aesdec_si128(b4, k);
+      b5 = _mm_aesdec_si128(b5, k);
+      b6 = _mm_aesdec_si128(b6, k);
+      b7 = _mm_aesdec_si128(b7, k);
+   }
+   k = _mm_loadu_si128((const __m128i*)(rk + (Nr << 4)));
+   _mm_storeu_si128((__m128i*)(pt +   0), _mm_aesdeclast_si128(b0, k));
+   _mm_storeu_si128((__m128i*)(pt +  16), _mm_aesdeclast_si128(b1, k));
+   _mm_storeu_si128((__m128i*)(pt +  32), _mm_aesdeclast_si128(b2, k));
+   _mm_storeu_si128((__m128i*)(pt +  48), _mm_aesdeclast_si128(b3, k));
+   _mm_storeu_si128((__m128i*)(pt +  64), _mm_aesdeclast_si128(b4, k));
+   _mm_storeu_si128((__m128i*)(pt +  80), _mm_aesdeclast_si128(b5, k));
+   _mm_storeu_si128((__m128i*)(pt +  96), _mm_aesdeclast_si128(b6, k));
+   _mm_storeu_si128((__m128i*)(pt + 112), _mm_aesdeclast_si128(b7, k));
+}
+
+/**
+  Accelerated multi-block ECB encrypt, eight pipelined blocks per stripe
+  @param pt     Plaintext
+  @param ct     [out] Ciphertext
+  @param blocks The number of complete blocks to process
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int rijndael_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey)
+{
+#ifndef LTC_AES_BITSLICE
+   int err;
+#endif
+   if (rijndael_aesni_enabled()) {
+      while (blocks >= 8) {
+         _aesni_ecb_encrypt8(pt, ct, skey);
+         pt += 8 * 16; ct += 8 * 16; blocks -= 8;
+      }
+      while (blocks-- > 0) {
+         rijndael_aesni_ecb_encrypt(pt, ct, skey);
+         pt += 16; ct += 16;
+      }
+   } else {
+#ifdef LTC_AES_BITSLICE
+      /* no hardware AES: use the constant-time bitsliced batch instead */
+      return rijndael_bitslice_ecb_encrypt(pt, ct, blocks, skey);
+#else
+      while (blocks-- > 0) {
+         if ((err = rijndael_ecb_encrypt(pt, ct, skey)) != CRYPT_OK) {
+            return err;
+         }
+         pt += 16; ct += 16;
+      }
+#endif
+   }
+   return CRYPT_OK;
+}
+
+/* CBC chains, so blocks cannot be pipelined against each other; the win
+ * over per-block dispatch is keeping the running IV in a register across
+ * the whole run
+ */
+LTC_AESNI_CALL
+static void _aesni_cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks,
+                               unsigned char *IV, const symmetric_key *skey)
+{
+   const unsigned char *rk = (const unsigned char *)skey->rijndael.eK;
+   int                  r,  Nr = skey->rijndael.Nr;
+   __m128i              b, iv;
+
+   iv = _mm_loadu_si128((__m128i*)IV);
+   while (blocks-- > 0) {
+      b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)pt), iv);
+      b = _mm_xor_si128(b, _mm_loadu_si128((const __m128i*)rk));
+      for (r = 1; r < Nr; r++) {
+         b = _mm_aesenc_si128(b, _mm_loadu_si128((const __m128i*)(rk + (r << 4))));
+      }
+      iv = _mm_aesenclast_si128(b, _mm_loadu_si128((const __m128i*)(rk + (Nr << 4))));
+      _mm_storeu_si128((__m128i*)ct, iv);
+      pt += 16; ct += 16;
+   }
+   _mm_storeu_si128((__m128i*)IV, iv);
+}
+
+/**
+  Accelerated multi-block CBC encrypt
+  @param pt     Plaintext
+  @param ct     [out] Ciphertext
+  @param blocks The number of complete blocks to process
+  @param IV     The initial value (input/output)
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int rijndael_accel_cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks,
+                               unsigned char *IV, symmetric_key *skey)
+{
+   int err;
+   unsigned long x;
+
+   if (rijndael_aesni_enabled()) {
+      _aesni_cbc_encrypt(pt, ct, blocks, IV, skey);
+   } else {
+      while (blocks-- > 0) {
+         for (x = 0; x < 16; x++) {
+            IV[x] ^= pt[x];
+         }
+         if ((err = rijndael_ecb_encrypt(IV, IV, skey)) != CRYPT_OK) {
+            return err;
+         }
+         XMEMCPY(ct, IV, 16);
+         pt += 16; ct += 16;
+      }
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Accelerated multi-block ECB decrypt, eight pipelined blocks per stripe
+  @param ct     Ciphertext
+  @param pt     [out] Plaintext
+  @param blocks The number of complete blocks to process
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int rijndael_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey)
+{
+   int err;
+   if (rijndael_aesni_enabled()) {
+      while (blocks >= 8) {
+         _aesni_ecb_decrypt8(ct, pt, skey);
+         ct += 8 * 16; pt += 8 * 16; blocks -= 8;
+      }
+      while (blocks-- > 0) {
+         rijndael_aesni_ecb_decrypt(ct, pt, skey);
+         ct += 16; pt += 16;
+      }
+   } else {
+      while (blocks-- > 0) {
+         if ((err = rijndael_ecb_decrypt(ct, pt, skey)) != CRYPT_OK) {
+            return err;
+         }
+         ct += 16; pt += 16;
+      }
+   }
+   return CRYPT_OK;
+}
+
+#endif /* LTC_RIJNDAEL && LTC_AES_NI */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
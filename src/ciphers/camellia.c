@@ -28,7 +28,9 @@ const struct ltc_cipher_descriptor camellia_desc = {
    &camellia_test,
    &camellia_done,
    &camellia_keysize,
-   NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+   &camellia_accel_ecb_encrypt,
+   &camellia_accel_ecb_decrypt,
+   NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
 };
 
 static const ulong32 SP1110[] = {
@@ -627,6 +629,192 @@ int camellia_ecb_decrypt(const unsigned char *ct, unsigned char *pt, symmetric_k
    return CRYPT_OK;
 }
 
+/* the two FL layer flavours, as helpers for the multi-block kernels */
+static ulong64 FL(ulong64 x, ulong64 kl)
+{
+   ulong32 a, b;
+   a = (ulong32)(x >> 32);
+   b = (ulong32)(x & 0xFFFFFFFFUL);
+   b ^= ROL((a & (ulong32)(kl >> 32)), 1);
+   a ^= b | (kl & 0xFFFFFFFFU);
+   return (((ulong64)a) << 32) | b;
+}
+
+static ulong64 FLINV(ulong64 x, ulong64 kl)
+{
+   ulong32 a, b;
+   a = (ulong32)(x >> 32);
+   b = (ulong32)(x & 0xFFFFFFFFUL);
+   a ^= b | (kl & 0xFFFFFFFFU);
+   b ^= ROL((a & (ulong32)(kl >> 32)), 1);
+   return (((ulong64)a) << 32) | b;
+}
+
+/* four independent blocks per trip: the per-round loops over i carry no
+ * dependency between blocks, so the compiler can overlap the table loads
+ * of one block with the arithmetic of the others */
+static void _camellia_encrypt4(const unsigned char *pt, unsigned char *ct, const symmetric_key *skey)
+{
+   ulong64 L[4], R[4];
+   int i, r;
+
+   for (i = 0; i < 4; i++) {
+      LOAD64H(L[i], pt+16*i); LOAD64H(R[i], pt+16*i+8);
+      L[i] ^= skey->camellia.kw[0];
+      R[i] ^= skey->camellia.kw[1];
+   }
+
+   for (r = 0; r < 6; r += 2) {
+      for (i = 0; i < 4; i++) R[i] ^= F(L[i] ^ skey->camellia.k[r]);
+      for (i = 0; i < 4; i++) L[i] ^= F(R[i] ^ skey->camellia.k[r+1]);
+   }
+   for (i = 0; i < 4; i++) {
+      L[i] = FL(L[i], skey->camellia.kl[0]);
+      R[i] = FLINV(R[i], skey->camellia.kl[1]);
+   }
+
+   for (r = 6; r < 12; r += 2) {
+      for (i = 0; i < 4; i++) R[i] ^= F(L[i] ^ skey->camellia.k[r]);
+      for (i = 0; i < 4; i++) L[i] ^= F(R[i] ^ skey->camellia.k[r+1]);
+   }
+   for (i = 0; i < 4; i++) {
+      L[i] = FL(L[i], skey->camellia.kl[2]);
+      R[i] = FLINV(R[i], skey->camellia.kl[3]);
+   }
+
+   for (r = 12; r < 18; r += 2) {
+      for (i = 0; i < 4; i++) R[i] ^= F(L[i] ^ skey->camellia.k[r]);
+      for (i = 0; i < 4; i++) L[i] ^= F(R[i] ^ skey->camellia.k[r+1]);
+   }
+
+   if (skey->camellia.R == 24) {
+      for (i = 0; i < 4; i++) {
+         L[i] = FL(L[i], skey->camellia.kl[4]);
+         R[i] = FLINV(R[i], skey->camellia.kl[5]);
+      }
+      for (r = 18; r < 24; r += 2) {
+         for (i = 0; i < 4; i++) R[i] ^= F(L[i] ^ skey->camellia.k[r]);
+         for (i = 0; i < 4; i++) L[i] ^= F(R[i] ^ skey->camellia.k[r+1]);
+      }
+   }
+
+   for (i = 0; i < 4; i++) {
+      L[i] ^= skey->camellia.kw[3];
+      R[i] ^= skey->camellia.kw[2];
+      STORE64H(R[i], ct+16*i); STORE64H(L[i], ct+16*i+8);
+   }
+}
+
+static void _camellia_decrypt4(const unsigned char *ct, unsigned char *pt, const symmetric_key *skey)
+{
+   ulong64 L[4], R[4];
+   int i, r;
+
+   for (i = 0; i < 4; i++) {
+      LOAD64H(R[i], ct+16*i); LOAD64H(L[i], ct+16*i+8);
+      L[i] ^= skey->camellia.kw[3];
+      R[i] ^= skey->camellia.kw[2];
+   }
+
+   if (skey->camellia.R == 24) {
+      for (r = 23; r > 18; r -= 2) {
+         for (i = 0; i < 4; i++) L[i] ^= F(R[i] ^ skey->camellia.k[r]);
+         for (i = 0; i < 4; i++) R[i] ^= F(L[i] ^ skey->camellia.k[r-1]);
+      }
+      for (i = 0; i < 4; i++) {
+         L[i] = FLINV(L[i], skey->camellia.kl[4]);
+         R[i] = FL(R[i], skey->camellia.kl[5]);
+      }
+   }
+
+   for (r = 17; r > 12; r -= 2) {
+      for (i = 0; i < 4; i++) L[i] ^= F(R[i] ^ skey->camellia.k[r]);
+      for (i = 0; i < 4; i++) R[i] ^= F(L[i] ^ skey->camellia.k[r-1]);
+   }
+   for (i = 0; i < 4; i++) {
+      L[i] = FLINV(L[i], skey->camellia.kl[2]);
+      R[i] = FL(R[i], skey->camellia.kl[3]);
+   }
+
+   for (r = 11; r > 6; r -= 2) {
+      for (i = 0; i < 4; i++) L[i] ^= F(R[i] ^ skey->camellia.k[r]);
+      for (i = 0; i < 4; i++) R[i] ^= F(L[i] ^ skey->camellia.k[r-1]);
+   }
+   for (i = 0; i < 4; i++) {
+      L[i] = FLINV(L[i], skey->camellia.kl[0]);
+      R[i] = FL(R[i], skey->camellia.kl[1]);
+   }
+
+   for (r = 5; r > 0; r -= 2) {
+      for (i = 0; i < 4; i++) L[i] ^= F(R[i] ^ skey->camellia.k[r]);
+      for (i = 0; i < 4; i++) R[i] ^= F(L[i] ^ skey->camellia.k[r-1]);
+   }
+
+   for (i = 0; i < 4; i++) {
+      R[i] ^= skey->camellia.kw[1];
+      L[i] ^= skey->camellia.kw[0];
+      STORE64H(R[i], pt+16*i+8); STORE64H(L[i], pt+16*i);
+   }
+}
+
+/**
+  Accelerated multi-block ECB encrypt, four pipelined blocks per stripe
+  @param pt     Plaintext
+  @param ct     [out] Ciphertext
+  @param blocks The number of complete blocks to process
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int camellia_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey)
+{
+   int err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   while (blocks >= 4) {
+      _camellia_encrypt4(pt, ct, skey);
+      pt += 64; ct += 64; blocks -= 4;
+   }
+   while (blocks-- > 0) {
+      if ((err = camellia_ecb_encrypt(pt, ct, skey)) != CRYPT_OK) {
+         return err;
+      }
+      pt += 16; ct += 16;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Accelerated multi-block ECB decrypt, four pipelined blocks per stripe
+  @param ct     Ciphertext
+  @param pt     [out] Plaintext
+  @param blocks The number of complete blocks to process
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int camellia_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey)
+{
+   int err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   while (blocks >= 4) {
+      _camellia_decrypt4(ct, pt, skey);
+      ct += 64; pt += 64; blocks -= 4;
+   }
+   while (blocks-- > 0) {
+      if ((err = camellia_ecb_decrypt(ct, pt, skey)) != CRYPT_OK) {
+         return err;
+      }
+      ct += 16; pt += 16;
+   }
+   return CRYPT_OK;
+}
+
 int camellia_test(void)
 {
    static const struct {
@@ -45,7 +45,9 @@ const struct ltc_cipher_descriptor des3_desc =
     &des3_test,
     &des3_done,
     &des3_keysize,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    &des3_accel_ecb_encrypt,
+    &des3_accel_ecb_decrypt,
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
 };
 
 static const ulong32 bytebit[8] =
@@ -1629,6 +1631,158 @@ int des_ecb_decrypt(const unsigned char *ct, unsigned char *pt, symmetric_key *s
     return CRYPT_OK;
 }
 
+#ifndef LTC_SMALL_CODE
+/* four blocks through the sixteen rounds with the per-round work
+ * interleaved across blocks; each block's chain is serial but the four
+ * chains are independent, which keeps the SP box loads pipelined */
+static void desfunc4(ulong32 *l, ulong32 *r, const ulong32 *keys)
+{
+    ulong32 work;
+    ulong64 tmp;
+    int cur_round, i;
+
+    for (i = 0; i < 4; i++) {
+       tmp = des_ip[0][byte(l[i], 0)] ^
+             des_ip[1][byte(l[i], 1)] ^
+             des_ip[2][byte(l[i], 2)] ^
+             des_ip[3][byte(l[i], 3)] ^
+             des_ip[4][byte(r[i], 0)] ^
+             des_ip[5][byte(r[i], 1)] ^
+             des_ip[6][byte(r[i], 2)] ^
+             des_ip[7][byte(r[i], 3)];
+       l[i] = (ulong32)(tmp >> 32);
+       r[i] = (ulong32)(tmp & 0xFFFFFFFFUL);
+    }
+
+    for (cur_round = 0; cur_round < 8; cur_round++) {
+        for (i = 0; i < 4; i++) {
+            work  = RORc(r[i], 4) ^ keys[0];
+            l[i] ^= SP7[work        & 0x3fL]
+                 ^  SP5[(work >>  8) & 0x3fL]
+                 ^  SP3[(work >> 16) & 0x3fL]
+                 ^  SP1[(work >> 24) & 0x3fL];
+            work  = r[i] ^ keys[1];
+            l[i] ^= SP8[ work        & 0x3fL]
+                 ^  SP6[(work >>  8) & 0x3fL]
+                 ^  SP4[(work >> 16) & 0x3fL]
+                 ^  SP2[(work >> 24) & 0x3fL];
+
+            work  = RORc(l[i], 4) ^ keys[2];
+            r[i] ^= SP7[ work        & 0x3fL]
+                 ^  SP5[(work >>  8) & 0x3fL]
+                 ^  SP3[(work >> 16) & 0x3fL]
+                 ^  SP1[(work >> 24) & 0x3fL];
+            work  = l[i] ^ keys[3];
+            r[i] ^= SP8[ work        & 0x3fL]
+                 ^  SP6[(work >>  8) & 0x3fL]
+                 ^  SP4[(work >> 16) & 0x3fL]
+                 ^  SP2[(work >> 24) & 0x3fL];
+        }
+        keys += 4;
+    }
+
+    for (i = 0; i < 4; i++) {
+       tmp = des_fp[0][byte(l[i], 0)] ^
+             des_fp[1][byte(l[i], 1)] ^
+             des_fp[2][byte(l[i], 2)] ^
+             des_fp[3][byte(l[i], 3)] ^
+             des_fp[4][byte(r[i], 0)] ^
+             des_fp[5][byte(r[i], 1)] ^
+             des_fp[6][byte(r[i], 2)] ^
+             des_fp[7][byte(r[i], 3)];
+       /* same final swap as desfunc */
+       l[i] = (ulong32)(tmp & 0xFFFFFFFFUL);
+       r[i] = (ulong32)(tmp >> 32);
+    }
+}
+#endif /* !LTC_SMALL_CODE */
+
+/**
+  Accelerated multi-block 3DES-EDE ECB encrypt, four blocks per stripe
+  @param pt     Plaintext
+  @param ct     [out] Ciphertext
+  @param blocks The number of complete blocks to process
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int des3_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey)
+{
+    int err;
+#ifndef LTC_SMALL_CODE
+    ulong32 l[4], r[4];
+    int i;
+
+    LTC_ARGCHK(pt   != NULL);
+    LTC_ARGCHK(ct   != NULL);
+    LTC_ARGCHK(skey != NULL);
+
+    while (blocks >= 4) {
+       for (i = 0; i < 4; i++) {
+          LOAD32H(l[i], pt+8*i);
+          LOAD32H(r[i], pt+8*i+4);
+       }
+       desfunc4(l, r, skey->des3.ek[0]);
+       desfunc4(l, r, skey->des3.ek[1]);
+       desfunc4(l, r, skey->des3.ek[2]);
+       for (i = 0; i < 4; i++) {
+          STORE32H(l[i], ct+8*i);
+          STORE32H(r[i], ct+8*i+4);
+       }
+       pt += 32; ct += 32; blocks -= 4;
+    }
+#endif
+    while (blocks-- > 0) {
+       if ((err = des3_ecb_encrypt(pt, ct, skey)) != CRYPT_OK) {
+          return err;
+       }
+       pt += 8; ct += 8;
+    }
+    return CRYPT_OK;
+}
+
+/**
+  Accelerated multi-block 3DES-EDE ECB decrypt, four blocks per stripe
+  @param ct     Ciphertext
+  @param pt     [out] Plaintext
+  @param blocks The number of complete blocks to process
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int des3_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey)
+{
+    int err;
+#ifndef LTC_SMALL_CODE
+    ulong32 l[4], r[4];
+    int i;
+
+    LTC_ARGCHK(pt   != NULL);
+    LTC_ARGCHK(ct   != NULL);
+    LTC_ARGCHK(skey != NULL);
+
+    while (blocks >= 4) {
+       for (i = 0; i < 4; i++) {
+          LOAD32H(l[i], ct+8*i);
+          LOAD32H(r[i], ct+8*i+4);
+       }
+       desfunc4(l, r, skey->des3.dk[0]);
+       desfunc4(l, r, skey->des3.dk[1]);
+       desfunc4(l, r, skey->des3.dk[2]);
+       for (i = 0; i < 4; i++) {
+          STORE32H(l[i], pt+8*i);
+          STORE32H(r[i], pt+8*i+4);
+       }
+       ct += 32; pt += 32; blocks -= 4;
+    }
+#endif
+    while (blocks-- > 0) {
+       if ((err = des3_ecb_decrypt(ct, pt, skey)) != CRYPT_OK) {
+          return err;
+       }
+       ct += 8; pt += 8;
+    }
+    return CRYPT_OK;
+}
+
 /**
   Encrypts a block of text with 3LTC_DES-EDE
   @param pt The input plaintext (8 bytes)
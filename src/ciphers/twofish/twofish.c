@@ -24,6 +24,11 @@
 #endif
 #endif
 
+#ifndef LTC_TWOFISH_SMALL
+static int s_twofish_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey);
+static int s_twofish_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey);
+#endif
+
 const struct ltc_cipher_descriptor twofish_desc =
 {
     "twofish",
@@ -35,7 +40,13 @@ const struct ltc_cipher_descriptor twofish_desc =
     &twofish_test,
     &twofish_done,
     &twofish_keysize,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+#ifndef LTC_TWOFISH_SMALL
+    &s_twofish_accel_ecb_encrypt,
+    &s_twofish_accel_ecb_decrypt,
+#else
+    NULL, NULL,
+#endif
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
 };
 
 /* the two polynomials */
@@ -50,15 +61,14 @@ static const unsigned char RS[4][8] = {
     { 0XA4, 0X55, 0X87, 0X5A, 0X58, 0XDB, 0X9E, 0X03 }
 };
 
-#ifdef LTC_TWOFISH_SMALL
-/* sbox usage orderings */
+/* sbox usage orderings (also used by the on-the-fly path of the
+ * large ram variant, see twofish_setup_ex) */
 static const unsigned char qord[4][5] = {
    { 1, 1, 0, 0, 1 },
    { 0, 1, 1, 0, 0 },
    { 0, 0, 0, 1, 1 },
    { 1, 0, 1, 1, 0 }
 };
-#endif /* LTC_TWOFISH_SMALL */
 
 #ifdef LTC_TWOFISH_TABLES
 
@@ -283,6 +293,37 @@ static void h_func(const unsigned char *in, unsigned char *out, unsigned char *M
 #define g_func(x, dum)  (S1[byte(x,0)] ^ S2[byte(x,1)] ^ S3[byte(x,2)] ^ S4[byte(x,3)])
 #define g1_func(x, dum) (S2[byte(x,0)] ^ S3[byte(x,1)] ^ S4[byte(x,2)] ^ S1[byte(x,3)])
 
+/* on-the-fly variant for keys scheduled with twofish_setup_ex and
+ * build_tabs == 0, mirrors the small ram g function */
+static ulong32 g_otf(ulong32 x, const symmetric_key *key)
+{
+   unsigned char g, i, y, z;
+   ulong32 res;
+
+   res = 0;
+   for (y = 0; y < 4; y++) {
+       z = key->twofish.start;
+
+       /* do unkeyed substitution */
+       g = sbox(qord[y][z++], (x >> (8*y)) & 255);
+
+       /* first subkey */
+       i = 0;
+
+       /* do key mixing+sbox until z==5 */
+       while (z != 5) {
+          g = g ^ key->twofish.SK[4*i++ + y];
+          g = sbox(qord[y][z++], g);
+       }
+
+       /* multiply g by a column of the MDS */
+       res ^= mds_column_mult(g, y);
+   }
+   return res;
+}
+
+#define g1_otf(x, key) g_otf(ROLc(x, 8), key)
+
 #else
 
 #ifdef LTC_CLEAN_STACK
@@ -331,17 +372,21 @@ static ulong32 g_func(ulong32 x, symmetric_key *key)
 #endif /* LTC_TWOFISH_SMALL */
 
  /**
-    Initialize the Twofish block cipher
+    Initialize the Twofish block cipher, with a runtime choice of variant
     @param key The symmetric key you wish to pass
     @param keylen The key length in bytes
     @param num_rounds The number of rounds desired (0 for default)
     @param skey The key in as scheduled by this function.
+    @param build_tabs Non-zero to build the large (4KB) per-key sbox tables
+                      for bulk keys, zero to schedule a short-lived key that
+                      computes the sboxes on the fly (ignored when compiled
+                      with LTC_TWOFISH_SMALL, which never has the tables)
     @return CRYPT_OK if successful
  */
 #ifdef LTC_CLEAN_STACK
-static int _twofish_setup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey)
+static int _twofish_setup_ex(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey, int build_tabs)
 #else
-int twofish_setup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey)
+int twofish_setup_ex(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey, int build_tabs)
 #endif
 {
 #ifndef LTC_TWOFISH_SMALL
@@ -376,6 +421,13 @@ int twofish_setup(const unsigned char *key, int keylen, int num_rounds, symmetri
    for (x = 0; x < k; x++) {
        rs_mult(M+(x*8), S+(x*4));
    }
+   /* keep them (and the sbox layer start) around for the on-the-fly path */
+   XMEMCPY(skey->twofish.SK, S, 4*(size_t)k);
+   switch (k) {
+         case 4 : skey->twofish.start = 0; break;
+         case 3 : skey->twofish.start = 1; break;
+         default: skey->twofish.start = 2; break;
+   }
 #else
    for (x = 0; x < k; x++) {
        rs_mult(M+(x*8), skey->twofish.S+(x*4));
@@ -407,6 +459,13 @@ int twofish_setup(const unsigned char *key, int keylen, int num_rounds, symmetri
    }
 
 #ifndef LTC_TWOFISH_SMALL
+   skey->twofish.tabs = build_tabs;
+   if (build_tabs == 0) {
+      /* short-lived key: skip the 4KB table build, the on-the-fly
+       * g function will be used instead */
+      return CRYPT_OK;
+   }
+
    /* make the sboxes (large ram variant) */
    if (k == 2) {
         for (x = 0; x < 256; x++) {
@@ -444,20 +503,118 @@ int twofish_setup(const unsigned char *key, int keylen, int num_rounds, symmetri
          case 3 : skey->twofish.start = 1; break;
          default: skey->twofish.start = 2; break;
    }
+   /* no big tables to build in this variant */
+   (void)build_tabs;
 #endif
    return CRYPT_OK;
 }
 
 #ifdef LTC_CLEAN_STACK
-int twofish_setup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey)
+int twofish_setup_ex(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey, int build_tabs)
 {
    int x;
-   x = _twofish_setup(key, keylen, num_rounds, skey);
+   x = _twofish_setup_ex(key, keylen, num_rounds, skey, build_tabs);
    burn_stack(sizeof(int) * 7 + sizeof(unsigned char) * 56 + sizeof(ulong32) * 2);
    return x;
 }
 #endif
 
+ /**
+    Initialize the Twofish block cipher
+    @param key The symmetric key you wish to pass
+    @param keylen The key length in bytes
+    @param num_rounds The number of rounds desired (0 for default)
+    @param skey The key in as scheduled by this function.
+    @return CRYPT_OK if successful
+ */
+int twofish_setup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey)
+{
+   return twofish_setup_ex(key, keylen, num_rounds, skey, 1);
+}
+
+#ifndef LTC_TWOFISH_SMALL
+/* round loops for keys scheduled without the big tables */
+static int _twofish_ecb_encrypt_otf(const unsigned char *pt, unsigned char *ct, symmetric_key *skey)
+{
+    ulong32 a,b,c,d,ta,tb,tc,td,t1,t2, *k;
+    int r;
+
+    LOAD32L(a,&pt[0]); LOAD32L(b,&pt[4]);
+    LOAD32L(c,&pt[8]); LOAD32L(d,&pt[12]);
+    a ^= skey->twofish.K[0];
+    b ^= skey->twofish.K[1];
+    c ^= skey->twofish.K[2];
+    d ^= skey->twofish.K[3];
+
+    k  = skey->twofish.K + 8;
+    for (r = 8; r != 0; --r) {
+        t2 = g1_otf(b, skey);
+        t1 = g_otf(a, skey) + t2;
+        c  = RORc(c ^ (t1 + k[0]), 1);
+        d  = ROLc(d, 1) ^ (t2 + t1 + k[1]);
+
+        t2 = g1_otf(d, skey);
+        t1 = g_otf(c, skey) + t2;
+        a  = RORc(a ^ (t1 + k[2]), 1);
+        b  = ROLc(b, 1) ^ (t2 + t1 + k[3]);
+        k += 4;
+    }
+
+    /* output with "undo last swap" */
+    ta = c ^ skey->twofish.K[4];
+    tb = d ^ skey->twofish.K[5];
+    tc = a ^ skey->twofish.K[6];
+    td = b ^ skey->twofish.K[7];
+
+    /* store output */
+    STORE32L(ta,&ct[0]); STORE32L(tb,&ct[4]);
+    STORE32L(tc,&ct[8]); STORE32L(td,&ct[12]);
+
+    return CRYPT_OK;
+}
+
+static int _twofish_ecb_decrypt_otf(const unsigned char *ct, unsigned char *pt, symmetric_key *skey)
+{
+    ulong32 a,b,c,d,ta,tb,tc,td,t1,t2, *k;
+    int r;
+
+    /* load input */
+    LOAD32L(ta,&ct[0]); LOAD32L(tb,&ct[4]);
+    LOAD32L(tc,&ct[8]); LOAD32L(td,&ct[12]);
+
+    /* undo undo final swap */
+    a = tc ^ skey->twofish.K[6];
+    b = td ^ skey->twofish.K[7];
+    c = ta ^ skey->twofish.K[4];
+    d = tb ^ skey->twofish.K[5];
+
+    k = skey->twofish.K + 36;
+    for (r = 8; r != 0; --r) {
+        t2 = g1_otf(d, skey);
+        t1 = g_otf(c, skey) + t2;
+        a = ROLc(a, 1) ^ (t1 + k[2]);
+        b = RORc(b ^ (t2 + t1 + k[3]), 1);
+
+        t2 = g1_otf(b, skey);
+        t1 = g_otf(a, skey) + t2;
+        c = ROLc(c, 1) ^ (t1 + k[0]);
+        d = RORc(d ^ (t2 +  t1 + k[1]), 1);
+        k -= 4;
+    }
+
+    /* pre-white */
+    a ^= skey->twofish.K[0];
+    b ^= skey->twofish.K[1];
+    c ^= skey->twofish.K[2];
+    d ^= skey->twofish.K[3];
+
+    /* store */
+    STORE32L(a, &pt[0]); STORE32L(b, &pt[4]);
+    STORE32L(c, &pt[8]); STORE32L(d, &pt[12]);
+    return CRYPT_OK;
+}
+#endif /* !LTC_TWOFISH_SMALL */
+
 /**
   Encrypts a block of text with Twofish
   @param pt The input plaintext (16 bytes)
@@ -481,6 +638,12 @@ int twofish_ecb_encrypt(const unsigned char *pt, unsigned char *ct, symmetric_ke
     LTC_ARGCHK(ct   != NULL);
     LTC_ARGCHK(skey != NULL);
 
+#ifndef LTC_TWOFISH_SMALL
+    if (skey->twofish.tabs == 0) {
+       return _twofish_ecb_encrypt_otf(pt, ct, skey);
+    }
+#endif
+
 #if !defined(LTC_TWOFISH_SMALL) && !defined(__GNUC__)
     S1 = skey->twofish.S[0];
     S2 = skey->twofish.S[1];
@@ -554,6 +717,12 @@ int twofish_ecb_decrypt(const unsigned char *ct, unsigned char *pt, symmetric_ke
     LTC_ARGCHK(ct   != NULL);
     LTC_ARGCHK(skey != NULL);
 
+#ifndef LTC_TWOFISH_SMALL
+    if (skey->twofish.tabs == 0) {
+       return _twofish_ecb_decrypt_otf(ct, pt, skey);
+    }
+#endif
+
 #if !defined(LTC_TWOFISH_SMALL) && !defined(__GNUC__)
     S1 = skey->twofish.S[0];
     S2 = skey->twofish.S[1];
@@ -606,6 +775,171 @@ int twofish_ecb_decrypt(const unsigned char *ct, unsigned char *pt, symmetric_ke
 }
 #endif
 
+#ifndef LTC_TWOFISH_SMALL
+
+/* Two-block interleaved ECB for latency-bound cores (Atom class): the
+ * serial dependent S-table loads of one lane hide behind the other
+ * lane's, and the next pair's input lines are prefetched while this
+ * pair is in flight.  Registered as the accel_ecb hooks so ECB (and
+ * anything built on it) batches pick the variant up automatically;
+ * on-the-fly scheduled keys fall back to the single-block path. */
+static int s_twofish_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey)
+{
+    ulong32 a0,b0,c0,d0,a1,b1,c1,d1,t1,t2,u1,u2,*k;
+    int r, err;
+#if !defined(__GNUC__)
+    ulong32 *S1, *S2, *S3, *S4;
+#endif
+
+    LTC_ARGCHK(pt   != NULL);
+    LTC_ARGCHK(ct   != NULL);
+    LTC_ARGCHK(skey != NULL);
+
+    if (skey->twofish.tabs == 0) {
+       goto tail;
+    }
+
+#if !defined(__GNUC__)
+    S1 = skey->twofish.S[0];
+    S2 = skey->twofish.S[1];
+    S3 = skey->twofish.S[2];
+    S4 = skey->twofish.S[3];
+#endif
+
+    while (blocks >= 2) {
+        /* pull the next pair in while this one runs the rounds */
+        LTC_PREFETCH_R(pt + 32);
+        LTC_PREFETCH_R(pt + 63);
+
+        LOAD32L(a0,&pt[ 0]); LOAD32L(b0,&pt[ 4]);
+        LOAD32L(c0,&pt[ 8]); LOAD32L(d0,&pt[12]);
+        LOAD32L(a1,&pt[16]); LOAD32L(b1,&pt[20]);
+        LOAD32L(c1,&pt[24]); LOAD32L(d1,&pt[28]);
+        a0 ^= skey->twofish.K[0]; a1 ^= skey->twofish.K[0];
+        b0 ^= skey->twofish.K[1]; b1 ^= skey->twofish.K[1];
+        c0 ^= skey->twofish.K[2]; c1 ^= skey->twofish.K[2];
+        d0 ^= skey->twofish.K[3]; d1 ^= skey->twofish.K[3];
+
+        k = skey->twofish.K + 8;
+        for (r = 8; r != 0; --r) {
+            t2 = g1_func(b0, skey);             u2 = g1_func(b1, skey);
+            t1 = g_func(a0, skey) + t2;         u1 = g_func(a1, skey) + u2;
+            c0 = RORc(c0 ^ (t1 + k[0]), 1);     c1 = RORc(c1 ^ (u1 + k[0]), 1);
+            d0 = ROLc(d0, 1) ^ (t2 + t1 + k[1]); d1 = ROLc(d1, 1) ^ (u2 + u1 + k[1]);
+
+            t2 = g1_func(d0, skey);             u2 = g1_func(d1, skey);
+            t1 = g_func(c0, skey) + t2;         u1 = g_func(c1, skey) + u2;
+            a0 = RORc(a0 ^ (t1 + k[2]), 1);     a1 = RORc(a1 ^ (u1 + k[2]), 1);
+            b0 = ROLc(b0, 1) ^ (t2 + t1 + k[3]); b1 = ROLc(b1, 1) ^ (u2 + u1 + k[3]);
+            k += 4;
+        }
+
+        /* output with "undo last swap" */
+        STORE32L(c0 ^ skey->twofish.K[4], &ct[ 0]);
+        STORE32L(d0 ^ skey->twofish.K[5], &ct[ 4]);
+        STORE32L(a0 ^ skey->twofish.K[6], &ct[ 8]);
+        STORE32L(b0 ^ skey->twofish.K[7], &ct[12]);
+        STORE32L(c1 ^ skey->twofish.K[4], &ct[16]);
+        STORE32L(d1 ^ skey->twofish.K[5], &ct[20]);
+        STORE32L(a1 ^ skey->twofish.K[6], &ct[24]);
+        STORE32L(b1 ^ skey->twofish.K[7], &ct[28]);
+
+        pt += 32; ct += 32; blocks -= 2;
+    }
+#ifdef LTC_CLEAN_STACK
+    burn_stack(sizeof(ulong32) * 13 + sizeof(int) * 2);
+#endif
+
+tail:
+    while (blocks > 0) {
+        if ((err = twofish_ecb_encrypt(pt, ct, skey)) != CRYPT_OK) {
+           return err;
+        }
+        pt += 16; ct += 16; blocks--;
+    }
+    return CRYPT_OK;
+}
+
+static int s_twofish_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey)
+{
+    ulong32 a0,b0,c0,d0,a1,b1,c1,d1,t1,t2,u1,u2,*k;
+    int r, err;
+#if !defined(__GNUC__)
+    ulong32 *S1, *S2, *S3, *S4;
+#endif
+
+    LTC_ARGCHK(pt   != NULL);
+    LTC_ARGCHK(ct   != NULL);
+    LTC_ARGCHK(skey != NULL);
+
+    if (skey->twofish.tabs == 0) {
+       goto tail;
+    }
+
+#if !defined(__GNUC__)
+    S1 = skey->twofish.S[0];
+    S2 = skey->twofish.S[1];
+    S3 = skey->twofish.S[2];
+    S4 = skey->twofish.S[3];
+#endif
+
+    while (blocks >= 2) {
+        LTC_PREFETCH_R(ct + 32);
+        LTC_PREFETCH_R(ct + 63);
+
+        LOAD32L(c0,&ct[ 0]); LOAD32L(d0,&ct[ 4]);
+        LOAD32L(a0,&ct[ 8]); LOAD32L(b0,&ct[12]);
+        LOAD32L(c1,&ct[16]); LOAD32L(d1,&ct[20]);
+        LOAD32L(a1,&ct[24]); LOAD32L(b1,&ct[28]);
+
+        /* undo undo final swap */
+        a0 ^= skey->twofish.K[6]; a1 ^= skey->twofish.K[6];
+        b0 ^= skey->twofish.K[7]; b1 ^= skey->twofish.K[7];
+        c0 ^= skey->twofish.K[4]; c1 ^= skey->twofish.K[4];
+        d0 ^= skey->twofish.K[5]; d1 ^= skey->twofish.K[5];
+
+        k = skey->twofish.K + 36;
+        for (r = 8; r != 0; --r) {
+            t2 = g1_func(d0, skey);             u2 = g1_func(d1, skey);
+            t1 = g_func(c0, skey) + t2;         u1 = g_func(c1, skey) + u2;
+            a0 = ROLc(a0, 1) ^ (t1 + k[2]);     a1 = ROLc(a1, 1) ^ (u1 + k[2]);
+            b0 = RORc(b0 ^ (t2 + t1 + k[3]), 1); b1 = RORc(b1 ^ (u2 + u1 + k[3]), 1);
+
+            t2 = g1_func(b0, skey);             u2 = g1_func(b1, skey);
+            t1 = g_func(a0, skey) + t2;         u1 = g_func(a1, skey) + u2;
+            c0 = ROLc(c0, 1) ^ (t1 + k[0]);     c1 = ROLc(c1, 1) ^ (u1 + k[0]);
+            d0 = RORc(d0 ^ (t2 + t1 + k[1]), 1); d1 = RORc(d1 ^ (u2 + u1 + k[1]), 1);
+            k -= 4;
+        }
+
+        /* pre-white */
+        STORE32L(a0 ^ skey->twofish.K[0], &pt[ 0]);
+        STORE32L(b0 ^ skey->twofish.K[1], &pt[ 4]);
+        STORE32L(c0 ^ skey->twofish.K[2], &pt[ 8]);
+        STORE32L(d0 ^ skey->twofish.K[3], &pt[12]);
+        STORE32L(a1 ^ skey->twofish.K[0], &pt[16]);
+        STORE32L(b1 ^ skey->twofish.K[1], &pt[20]);
+        STORE32L(c1 ^ skey->twofish.K[2], &pt[24]);
+        STORE32L(d1 ^ skey->twofish.K[3], &pt[28]);
+
+        ct += 32; pt += 32; blocks -= 2;
+    }
+#ifdef LTC_CLEAN_STACK
+    burn_stack(sizeof(ulong32) * 13 + sizeof(int) * 2);
+#endif
+
+tail:
+    while (blocks > 0) {
+        if ((err = twofish_ecb_decrypt(ct, pt, skey)) != CRYPT_OK) {
+           return err;
+        }
+        ct += 16; pt += 16; blocks--;
+    }
+    return CRYPT_OK;
+}
+
+#endif /* !LTC_TWOFISH_SMALL */
+
 /**
   Performs a self-test of the Twofish block cipher
   @return CRYPT_OK if functional, CRYPT_NOP if self-test has been disabled
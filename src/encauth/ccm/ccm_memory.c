@@ -17,6 +17,9 @@
 
 #ifdef LTC_CCM_MODE
 
+/* counter blocks materialized per trip through the bulk path */
+#define LTC_CCM_BULK_BLOCKS 16
+
 /**
    CCM encrypt/decrypt and produce an authentication tag
 
@@ -243,6 +246,60 @@ int ccm_memory(int cipher,
       y = 0;
 #ifdef LTC_FAST
       if (ptlen & ~15)  {
+          /* batch the CTR keystream lane through the multi-block ECB
+           * accelerator; the CBC-MAC lane is a serial chain, so it runs
+           * block by block against the span the keystream call covered */
+          if (cipher_descriptor[cipher].accel_ecb_encrypt != NULL && (ptlen & ~15) >= 32) {
+             unsigned char ctrblk[LTC_CCM_BULK_BLOCKS * 16], pads[LTC_CCM_BULK_BLOCKS * 16];
+             unsigned long i, n;
+             while ((ptlen & ~15) - y >= 32) {
+                n = ((ptlen & ~15) - y) >> 4;
+                if (n > LTC_CCM_BULK_BLOCKS) {
+                   n = LTC_CCM_BULK_BLOCKS;
+                }
+                for (i = 0; i < n; i++) {
+                   for (z = 15; z > 15-L; z--) {
+                       ctr[z] = (ctr[z] + 1) & 255;
+                       if (ctr[z]) break;
+                   }
+                   XMEMCPY(&ctrblk[i << 4], ctr, 16);
+                }
+                if ((err = cipher_descriptor[cipher].accel_ecb_encrypt(ctrblk, pads, n, skey)) != CRYPT_OK) {
+                   goto error;
+                }
+                if (direction == CCM_ENCRYPT) {
+                   /* the MAC only reads the plaintext, so it is independent
+                    * of the keystream results just issued */
+                   for (i = 0; i < n; i++) {
+                      for (z = 0; z < 16; z += sizeof(LTC_FAST_TYPE)) {
+                          *(LTC_FAST_TYPE_PTR_CAST(&PAD[z])) ^= *(LTC_FAST_TYPE_PTR_CAST(&pt[y + (i << 4) + z]));
+                      }
+                      if ((err = cipher_descriptor[cipher].ecb_encrypt(PAD, PAD, skey)) != CRYPT_OK) {
+                         goto error;
+                      }
+                   }
+                   for (z = 0; z < (n << 4); z += sizeof(LTC_FAST_TYPE)) {
+                       *(LTC_FAST_TYPE_PTR_CAST(&ct[y + z])) = *(LTC_FAST_TYPE_PTR_CAST(&pt[y + z])) ^ *(LTC_FAST_TYPE_PTR_CAST(&pads[z]));
+                   }
+                } else {
+                   for (z = 0; z < (n << 4); z += sizeof(LTC_FAST_TYPE)) {
+                       *(LTC_FAST_TYPE_PTR_CAST(&pt[y + z])) = *(LTC_FAST_TYPE_PTR_CAST(&ct[y + z])) ^ *(LTC_FAST_TYPE_PTR_CAST(&pads[z]));
+                   }
+                   for (i = 0; i < n; i++) {
+                      for (z = 0; z < 16; z += sizeof(LTC_FAST_TYPE)) {
+                          *(LTC_FAST_TYPE_PTR_CAST(&PAD[z])) ^= *(LTC_FAST_TYPE_PTR_CAST(&pt[y + (i << 4) + z]));
+                      }
+                      if ((err = cipher_descriptor[cipher].ecb_encrypt(PAD, PAD, skey)) != CRYPT_OK) {
+                         goto error;
+                      }
+                   }
+                }
+                y += n << 4;
+             }
+#ifdef LTC_CLEAN_STACK
+             zeromem(pads, sizeof(pads));
+#endif
+          }
           if (direction == CCM_ENCRYPT) {
              for (; y < (ptlen & ~15); y += 16) {
                 /* increment the ctr? */
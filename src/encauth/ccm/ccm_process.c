@@ -26,7 +26,8 @@ int ccm_process(ccm_state *ccm,
                 unsigned char *ct,
                 int direction)
 {
-   unsigned char  y, z, b;
+   unsigned long  y, z;
+   unsigned char  b;
    int err;
 
    LTC_ARGCHK(ccm != NULL);
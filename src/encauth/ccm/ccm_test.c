@@ -113,7 +113,7 @@ int ccm_test(void)
 },
 
 };
-  unsigned long taglen, x, y;
+  unsigned long taglen, x, y, z, n;
   unsigned char buf[64], buf2[64], tag[16], tag2[16], tag3[16], zero[64];
   int           err, idx;
   symmetric_key skey;
@@ -130,7 +130,9 @@ int ccm_test(void)
   }
 
   for (x = 0; x < (sizeof(tests)/sizeof(tests[0])); x++) {
-    for (y = 0; y < 2; y++) {
+    /* y == 0 one-shot ccm_memory, y == 1 incremental API in one call,
+       y == 2 incremental API streamed through small odd-sized chunks */
+    for (y = 0; y < 3; y++) {
       taglen = tests[x].taglen;
       if (y == 0) {
          if ((err = cipher_descriptor[idx].setup(tests[x].key, 16, 0, &skey)) != CRYPT_OK) {
@@ -154,11 +156,17 @@ int ccm_test(void)
          if ((err = ccm_add_nonce(&ccm, tests[x].nonce, tests[x].noncelen)) != CRYPT_OK) {
             return err;
          }
-         if ((err = ccm_add_aad(&ccm, tests[x].header, tests[x].headerlen)) != CRYPT_OK) {
-            return err;
+         for (z = 0; z < (unsigned long)tests[x].headerlen; z += n) {
+            n = (y == 1) ? tests[x].headerlen - z : ((unsigned long)tests[x].headerlen - z > 3 ? 3 : (unsigned long)tests[x].headerlen - z);
+            if ((err = ccm_add_aad(&ccm, tests[x].header + z, n)) != CRYPT_OK) {
+               return err;
+            }
          }
-         if ((err = ccm_process(&ccm, (unsigned char*)tests[x].pt, tests[x].ptlen, buf, CCM_ENCRYPT)) != CRYPT_OK) {
-            return err;
+         for (z = 0; z < (unsigned long)tests[x].ptlen; z += n) {
+            n = (y == 1) ? tests[x].ptlen - z : ((unsigned long)tests[x].ptlen - z > 7 ? 7 : (unsigned long)tests[x].ptlen - z);
+            if ((err = ccm_process(&ccm, (unsigned char*)tests[x].pt + z, n, buf + z, CCM_ENCRYPT)) != CRYPT_OK) {
+               return err;
+            }
          }
          if ((err = ccm_done(&ccm, tag, &taglen)) != CRYPT_OK) {
             return err;
@@ -209,11 +217,17 @@ int ccm_test(void)
          if ((err = ccm_add_nonce(&ccm, tests[x].nonce, tests[x].noncelen)) != CRYPT_OK) {
             return err;
          }
-         if ((err = ccm_add_aad(&ccm, tests[x].header, tests[x].headerlen)) != CRYPT_OK) {
-            return err;
+         for (z = 0; z < (unsigned long)tests[x].headerlen; z += n) {
+            n = (y == 1) ? tests[x].headerlen - z : ((unsigned long)tests[x].headerlen - z > 3 ? 3 : (unsigned long)tests[x].headerlen - z);
+            if ((err = ccm_add_aad(&ccm, tests[x].header + z, n)) != CRYPT_OK) {
+               return err;
+            }
          }
-         if ((err = ccm_process(&ccm, buf2, tests[x].ptlen, buf, CCM_DECRYPT)) != CRYPT_OK) {
-            return err;
+         for (z = 0; z < (unsigned long)tests[x].ptlen; z += n) {
+            n = (y == 1) ? tests[x].ptlen - z : ((unsigned long)tests[x].ptlen - z > 7 ? 7 : (unsigned long)tests[x].ptlen - z);
+            if ((err = ccm_process(&ccm, buf2 + z, n, buf + z, CCM_DECRYPT)) != CRYPT_OK) {
+               return err;
+            }
          }
          if ((err = ccm_done(&ccm, tag2, &taglen)) != CRYPT_OK) {
             return err;
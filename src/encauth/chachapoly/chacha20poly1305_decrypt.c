@@ -22,7 +22,7 @@
 int chacha20poly1305_decrypt(chacha20poly1305_state *st, const unsigned char *in, unsigned long inlen, unsigned char *out)
 {
    unsigned char padzero[16] = { 0 };
-   unsigned long padlen;
+   unsigned long padlen, n;
    int err;
 
    if (inlen == 0) return CRYPT_OK; /* nothing to do */
@@ -35,10 +35,17 @@ int chacha20poly1305_decrypt(chacha20poly1305_state *st, const unsigned char *in
       }
       st->aadflg = 0; /* no more AAD */
    }
-   if (st->aadflg) st->aadflg = 0; /* no more AAD */
-   if ((err = poly1305_process(&st->poly, in, inlen)) != CRYPT_OK)         return err;
-   if ((err = chacha_crypt(&st->chacha, in, inlen, out)) != CRYPT_OK)      return err;
-   st->ctlen += (ulong64)inlen;
+   /* alternate the Poly1305 and ChaCha lanes over cache-sized spans (see
+    * chacha20poly1305_encrypt.c) */
+   while (inlen > 0) {
+      n = (inlen > LTC_CHACHAPOLY_FUSE_CHUNK) ? LTC_CHACHAPOLY_FUSE_CHUNK : inlen;
+      if ((err = poly1305_process(&st->poly, in, n)) != CRYPT_OK)          return err;
+      if ((err = chacha_crypt(&st->chacha, in, n, out)) != CRYPT_OK)       return err;
+      st->ctlen += (ulong64)n;
+      in    += n;
+      out   += n;
+      inlen -= n;
+   }
    return CRYPT_OK;
 }
 
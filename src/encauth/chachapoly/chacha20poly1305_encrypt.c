@@ -22,13 +22,12 @@
 int chacha20poly1305_encrypt(chacha20poly1305_state *st, const unsigned char *in, unsigned long inlen, unsigned char *out)
 {
    unsigned char padzero[16] = { 0 };
-   unsigned long padlen;
+   unsigned long padlen, n;
    int err;
 
    if (inlen == 0) return CRYPT_OK; /* nothing to do */
    LTC_ARGCHK(st != NULL);
 
-   if ((err = chacha_crypt(&st->chacha, in, inlen, out)) != CRYPT_OK)         return err;
    if (st->aadflg) {
       padlen = 16 - (st->aadlen % 16);
       if (padlen < 16) {
@@ -36,8 +35,17 @@ int chacha20poly1305_encrypt(chacha20poly1305_state *st, const unsigned char *in
       }
       st->aadflg = 0; /* no more AAD */
    }
-   if ((err = poly1305_process(&st->poly, out, inlen)) != CRYPT_OK)           return err;
-   st->ctlen += (ulong64)inlen;
+   /* alternate the ChaCha and Poly1305 lanes over cache-sized spans instead
+    * of making two full trips over the buffer */
+   while (inlen > 0) {
+      n = (inlen > LTC_CHACHAPOLY_FUSE_CHUNK) ? LTC_CHACHAPOLY_FUSE_CHUNK : inlen;
+      if ((err = chacha_crypt(&st->chacha, in, n, out)) != CRYPT_OK)          return err;
+      if ((err = poly1305_process(&st->poly, out, n)) != CRYPT_OK)            return err;
+      st->ctlen += (ulong64)n;
+      in    += n;
+      out   += n;
+      inlen -= n;
+   }
    return CRYPT_OK;
 }
 
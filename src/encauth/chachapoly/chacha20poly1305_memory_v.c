@@ -0,0 +1,75 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+#include "tomcrypt.h"
+
+#ifdef LTC_CHACHA20POLY1305_MODE
+
+/**
+  Process an entire scattered ChaCha20Poly1305 packet in one call.  Each
+  fragment is encrypted (or decrypted) in place; partial blocks are
+  carried across fragment boundaries, so the chain behaves exactly like
+  one contiguous buffer.
+  @param key               The secret key
+  @param keylen            The length of the secret key
+  @param iv                The initial vector
+  @param ivlen             The length of the initial vector
+  @param aad               The additional authentication data (header)
+  @param aadlen            The length of the aad
+  @param iov               The array of fragments, processed in place
+  @param iovcnt            The number of fragments
+  @param tag               [out] The MAC tag
+  @param taglen            [in/out] The MAC tag length
+  @param direction         Encrypt or Decrypt mode (CHCHA20POLY1305_ENCRYPT or CHCHA20POLY1305_DECRYPT)
+  @return CRYPT_OK on success
+ */
+int chacha20poly1305_memory_v(const unsigned char *key, unsigned long keylen,
+                              const unsigned char *iv,  unsigned long ivlen,
+                              const unsigned char *aad, unsigned long aadlen,
+                              const ltc_iovec *iov, int iovcnt,
+                                    unsigned char *tag, unsigned long *taglen,
+                              int direction)
+{
+   chacha20poly1305_state st;
+   int x, err;
+
+   LTC_ARGCHK(key != NULL);
+   LTC_ARGCHK(iv  != NULL);
+   LTC_ARGCHK(iov != NULL || iovcnt == 0);
+   LTC_ARGCHK(tag != NULL);
+
+   if (direction != CHCHA20POLY1305_ENCRYPT && direction != CHCHA20POLY1305_DECRYPT) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   if ((err = chacha20poly1305_init(&st, key, keylen)) != CRYPT_OK)             { goto LBL_ERR; }
+   if ((err = chacha20poly1305_setiv(&st, iv, ivlen)) != CRYPT_OK)              { goto LBL_ERR; }
+   if (aad && aadlen > 0) {
+      if ((err = chacha20poly1305_add_aad(&st, aad, aadlen)) != CRYPT_OK)       { goto LBL_ERR; }
+   }
+   for (x = 0; x < iovcnt; x++) {
+      if (iov[x].len == 0) {
+         continue;
+      }
+      if (direction == CHCHA20POLY1305_ENCRYPT) {
+         if ((err = chacha20poly1305_encrypt(&st, iov[x].data, iov[x].len, iov[x].data)) != CRYPT_OK) { goto LBL_ERR; }
+      }
+      else {
+         if ((err = chacha20poly1305_decrypt(&st, iov[x].data, iov[x].len, iov[x].data)) != CRYPT_OK) { goto LBL_ERR; }
+      }
+   }
+   err = chacha20poly1305_done(&st, tag, taglen);
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(&st, sizeof(chacha20poly1305_state));
+#endif
+   return err;
+}
+
+#endif
@@ -15,7 +15,7 @@
   Set IV + counter data to the ChaCha20Poly1305 state and reset the context
   @param st     The ChaCha20Poly1305 state
   @param iv     The IV data to add
-  @param inlen  The length of the IV (must be 12 or 8)
+  @param inlen  The length of the IV (must be 24, 12 or 8)
   @return CRYPT_OK on success
  */
 int chacha20poly1305_setiv(chacha20poly1305_state *st, const unsigned char *iv, unsigned long ivlen)
@@ -26,10 +26,16 @@ int chacha20poly1305_setiv(chacha20poly1305_state *st, const unsigned char *iv,
 
    LTC_ARGCHK(st != NULL);
    LTC_ARGCHK(iv != NULL);
-   LTC_ARGCHK(ivlen == 12 || ivlen == 8);
+   LTC_ARGCHK(ivlen == 24 || ivlen == 12 || ivlen == 8);
 
    /* set IV for chacha20 */
-   if (ivlen == 12) {
+   if (ivlen == 24) {
+      /* XChaCha20-Poly1305: 192bit IV, HChaCha subkey cached in the
+       * chacha state; equivalent to the draft's 0^4 || iv[16..23]
+       * 96-bit nonce since the zero prefix lands in input[13] */
+      if ((err = chacha_xivctr64(&st->chacha, iv, ivlen, 1)) != CRYPT_OK) return err;
+   }
+   else if (ivlen == 12) {
       /* IV 96bit */
       if ((err = chacha_ivctr32(&st->chacha, iv, ivlen, 1)) != CRYPT_OK) return err;
    }
@@ -42,7 +48,12 @@ int chacha20poly1305_setiv(chacha20poly1305_state *st, const unsigned char *iv,
    for(i = 0; i < 12; i++) tmp_st.input[i] = st->chacha.input[i];
    tmp_st.rounds = 20;
    /* set IV */
-   if (ivlen == 12) {
+   if (ivlen == 24) {
+      /* the poly key comes from the derived subkey already copied
+       * above; only the trailing 64 IV bits go in */
+      if ((err = chacha_ivctr64(&tmp_st, iv + 16, 8, 0)) != CRYPT_OK) return err;
+   }
+   else if (ivlen == 12) {
       /* IV 32bit */
       if ((err = chacha_ivctr32(&tmp_st, iv, ivlen, 0)) != CRYPT_OK) return err;
    }
@@ -102,6 +102,31 @@ int chacha20poly1305_test(void)
    if (compare_testvector(pt, 16, rfc7905_pt, 16, "DEC-CT3", 1) != 0) return CRYPT_FAIL_TESTVECTOR;
    if (compare_testvector(dmac, len, rfc7905_tag, 16, "DEC-TAG3", 2) != 0) return CRYPT_FAIL_TESTVECTOR;
 
+   /* XChaCha20-Poly1305, draft-irtf-cfrg-xchacha A.3.2.1 (same key,
+    * aad and message as the RFC 7539 vector, 192-bit nonce) */
+   {
+      unsigned char xiv[24];
+      static const unsigned char xenc[] = { 0xbd, 0x6d, 0x17, 0x9d, 0x3e, 0x83, 0xd4, 0x3b, 0x95, 0x76, 0x57, 0x94, 0x93, 0xc0, 0xe9, 0x39,
+                                            0x57, 0x2a, 0x17, 0x00, 0x25, 0x2b, 0xfa, 0xcc, 0xbe, 0xd2, 0x90, 0x2c, 0x21, 0x39, 0x6c, 0xbb,
+                                            0x73, 0x1c, 0x7f, 0x1b, 0x0b, 0x4a, 0xa6, 0x44, 0x0b, 0xf3, 0xa8, 0x2f, 0x4e, 0xda, 0x7e, 0x39,
+                                            0xae, 0x64, 0xc6, 0x70, 0x8c, 0x54, 0xc2, 0x16, 0xcb, 0x96, 0xb7, 0x2e, 0x12, 0x13, 0xb4, 0x52,
+                                            0x2f, 0x8c, 0x9b, 0xa4, 0x0d, 0xb5, 0xd9, 0x45, 0xb1, 0x1b, 0x69, 0xb9, 0x82, 0xc1, 0xbb, 0x9e,
+                                            0x3f, 0x3f, 0xac, 0x2b, 0xc3, 0x69, 0x48, 0x8f, 0x76, 0xb2, 0x38, 0x35, 0x65, 0xd3, 0xff, 0xf9,
+                                            0x21, 0xf9, 0x66, 0x4c, 0x97, 0x63, 0x7d, 0xa9, 0x76, 0x88, 0x12, 0xf6, 0x15, 0xc6, 0x8b, 0x13,
+                                            0xb5, 0x2e };
+      static const unsigned char xtag[] = { 0xc0, 0x87, 0x59, 0x24, 0xc1, 0xc7, 0x98, 0x79, 0x47, 0xde, 0xaf, 0xd8, 0x78, 0x0a, 0xcf, 0x49 };
+      int i;
+      for (i = 0; i < 24; i++) xiv[i] = 0x40 + i;
+      chacha20poly1305_init(&st1, k, sizeof(k));
+      chacha20poly1305_setiv(&st1, xiv, sizeof(xiv));
+      chacha20poly1305_add_aad(&st1, aad, sizeof(aad));
+      chacha20poly1305_encrypt(&st1, (unsigned char *)m, mlen, ct);
+      len = sizeof(emac);
+      chacha20poly1305_done(&st1, emac, &len);
+      if (compare_testvector(ct, mlen, xenc, sizeof(xenc), "ENC-CT4", 1) != 0) return CRYPT_FAIL_TESTVECTOR;
+      if (compare_testvector(emac, len, xtag, sizeof(xtag), "ENC-TAG4", 2) != 0) return CRYPT_FAIL_TESTVECTOR;
+   }
+
    return CRYPT_OK;
 #endif
 }
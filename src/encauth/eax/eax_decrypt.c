@@ -28,19 +28,34 @@
 int eax_decrypt(eax_state *eax, const unsigned char *ct, unsigned char *pt,
                 unsigned long length)
 {
+   unsigned long n;
    int err;
 
    LTC_ARGCHK(eax != NULL);
    LTC_ARGCHK(pt  != NULL);
    LTC_ARGCHK(ct  != NULL);
 
-   /* omac ciphertext */
-   if ((err = omac_process(&eax->ctomac, ct, length)) != CRYPT_OK) {
-      return err;
+   /* alternate the OMAC and CTR lanes over cache-sized spans instead of
+    * making two full trips over the buffer (see eax_encrypt.c) */
+   while (length > 0) {
+      n = (length > LTC_EAX_FUSE_CHUNK) ? LTC_EAX_FUSE_CHUNK : length;
+
+      /* omac ciphertext */
+      if ((err = omac_process(&eax->ctomac, ct, n)) != CRYPT_OK) {
+         return err;
+      }
+
+      /* decrypt  */
+      if ((err = ctr_decrypt(ct, pt, n, &eax->ctr)) != CRYPT_OK) {
+         return err;
+      }
+
+      ct     += n;
+      pt     += n;
+      length -= n;
    }
 
-   /* decrypt  */
-   return ctr_decrypt(ct, pt, length, &eax->ctr);
+   return CRYPT_OK;
 }
 
 #endif
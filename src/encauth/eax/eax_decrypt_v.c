@@ -0,0 +1,51 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+    @file eax_decrypt_v.c
+    EAX implementation, decrypt a scattered message, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_EAX_MODE
+
+/**
+   Decrypt a fragment chain of data with EAX.  Each fragment is decrypted
+   in place; see eax_encrypt_v.c for the boundary semantics.
+   @param eax     The EAX state
+   @param iov     The array of fragments, decrypted in place
+   @param iovcnt  The number of fragments
+   @return CRYPT_OK if successful
+*/
+int eax_decrypt_v(eax_state *eax, const ltc_iovec *iov, int iovcnt)
+{
+   int x, err;
+
+   LTC_ARGCHK(eax != NULL);
+   LTC_ARGCHK(iov != NULL || iovcnt == 0);
+
+   for (x = 0; x < iovcnt; x++) {
+      if (iov[x].len == 0) {
+         continue;
+      }
+      if ((err = eax_decrypt(eax, iov[x].data, iov[x].data, iov[x].len)) != CRYPT_OK) {
+         return err;
+      }
+   }
+
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
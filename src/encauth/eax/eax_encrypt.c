@@ -28,19 +28,34 @@
 int eax_encrypt(eax_state *eax, const unsigned char *pt, unsigned char *ct,
                 unsigned long length)
 {
+   unsigned long n;
    int err;
 
    LTC_ARGCHK(eax != NULL);
    LTC_ARGCHK(pt  != NULL);
    LTC_ARGCHK(ct  != NULL);
 
-   /* encrypt */
-   if ((err = ctr_encrypt(pt, ct, length, &eax->ctr)) != CRYPT_OK) {
-      return err;
+   /* alternate the CTR and OMAC lanes over cache-sized spans instead of
+    * making two full trips over the buffer */
+   while (length > 0) {
+      n = (length > LTC_EAX_FUSE_CHUNK) ? LTC_EAX_FUSE_CHUNK : length;
+
+      /* encrypt */
+      if ((err = ctr_encrypt(pt, ct, n, &eax->ctr)) != CRYPT_OK) {
+         return err;
+      }
+
+      /* omac ciphertext */
+      if ((err = omac_process(&eax->ctomac, ct, n)) != CRYPT_OK) {
+         return err;
+      }
+
+      pt     += n;
+      ct     += n;
+      length -= n;
    }
 
-   /* omac ciphertext */
-   return omac_process(&eax->ctomac, ct, length);
+   return CRYPT_OK;
 }
 
 #endif
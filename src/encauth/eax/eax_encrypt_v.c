@@ -0,0 +1,53 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file eax_encrypt_v.c
+   EAX implementation, encrypt a scattered message, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_EAX_MODE
+
+/**
+   Encrypt a fragment chain of data with EAX.  Each fragment is encrypted
+   in place; the CTR and OMAC states carry partial blocks across fragment
+   boundaries, so the chain behaves exactly like one contiguous buffer.
+   @param eax     The EAX state
+   @param iov     The array of fragments, encrypted in place
+   @param iovcnt  The number of fragments
+   @return CRYPT_OK if successful
+*/
+int eax_encrypt_v(eax_state *eax, const ltc_iovec *iov, int iovcnt)
+{
+   int x, err;
+
+   LTC_ARGCHK(eax != NULL);
+   LTC_ARGCHK(iov != NULL || iovcnt == 0);
+
+   for (x = 0; x < iovcnt; x++) {
+      if (iov[x].len == 0) {
+         continue;
+      }
+      if ((err = eax_encrypt(eax, iov[x].data, iov[x].data, iov[x].len)) != CRYPT_OK) {
+         return err;
+      }
+   }
+
+   return CRYPT_OK;
+}
+
+#endif
+
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -88,6 +88,19 @@ int gcm_add_aad(gcm_state *gcm,
    }
 
    x = 0;
+#ifdef LTC_GF_CLMUL
+   /* aggregated GHASH: fold eight blocks per reduction through the H powers */
+   if (gcm->pre->clmul && gcm->buflen == 0) {
+      while (adatalen - x >= 128) {
+         gcm_gf_mult_clmul_fold8(gcm->pre->HP[0], &adata[x], gcm->X);
+         gcm->totlen += 1024;
+         x += 128;
+      }
+      adata += x;
+      adatalen -= x;
+      x = 0;
+   }
+#endif
 #ifdef LTC_FAST
    if (gcm->buflen == 0) {
       for (x = 0; x < (adatalen & ~15); x += 16) {
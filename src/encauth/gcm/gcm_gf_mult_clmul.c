@@ -0,0 +1,144 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+   @file gcm_gf_mult_clmul.c
+   Carry-less GF(2^128) multiply via PCLMULQDQ, shared by GCM and LRW
+*/
+
+#if defined(LTC_GF_CLMUL) && (defined(LTC_GCM_MODE) || defined(LTC_LRW_MODE))
+
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+
+#define LTC_CLMUL_CALL __attribute__((target("pclmul,ssse3,sse2")))
+
+/**
+  Test whether the CPU can run the carry-less multiply backend
+  @return nonzero if PCLMULQDQ is available at runtime
+*/
+int gcm_gf_mult_clmul_enabled(void)
+{
+   return (ltc_cpu_features() & (LTC_CPU_CLMUL | LTC_CPU_SSSE3)) ==
+          (LTC_CPU_CLMUL | LTC_CPU_SSSE3);
+}
+
+/* 256-bit carry-less product, schoolbook on 64-bit halves */
+LTC_CLMUL_CALL
+static void _clmul_mul256(__m128i A, __m128i B, __m128i *lo, __m128i *hi)
+{
+   __m128i t1, t2;
+
+   *lo = _mm_clmulepi64_si128(A, B, 0x00);
+   t1  = _mm_clmulepi64_si128(A, B, 0x10);
+   t2  = _mm_clmulepi64_si128(A, B, 0x01);
+   *hi = _mm_clmulepi64_si128(A, B, 0x11);
+   t1  = _mm_xor_si128(t1, t2);
+   *lo = _mm_xor_si128(*lo, _mm_slli_si128(t1, 8));
+   *hi = _mm_xor_si128(*hi, _mm_srli_si128(t1, 8));
+}
+
+/* fold an unreduced 256-bit product back to 128 bits */
+LTC_CLMUL_CALL
+static __m128i _clmul_reduce(__m128i lo, __m128i hi)
+{
+   __m128i t1, t2, t3, t4, t5;
+
+   /* shift the whole 256-bit product left by one to finish the reflection */
+   t1 = _mm_srli_epi32(lo, 31);
+   t2 = _mm_srli_epi32(hi, 31);
+   lo = _mm_slli_epi32(lo, 1);
+   hi = _mm_slli_epi32(hi, 1);
+   t3 = _mm_srli_si128(t1, 12);
+   t2 = _mm_slli_si128(t2, 4);
+   t1 = _mm_slli_si128(t1, 4);
+   lo = _mm_or_si128(lo, t1);
+   hi = _mm_or_si128(hi, _mm_or_si128(t2, t3));
+
+   /* reduce modulo x^128 + x^7 + x^2 + x + 1 in the reflected domain */
+   t1 = _mm_slli_epi32(lo, 31);
+   t2 = _mm_slli_epi32(lo, 30);
+   t3 = _mm_slli_epi32(lo, 25);
+   t1 = _mm_xor_si128(t1, _mm_xor_si128(t2, t3));
+   t2 = _mm_srli_si128(t1, 4);
+   t1 = _mm_slli_si128(t1, 12);
+   lo = _mm_xor_si128(lo, t1);
+
+   t3 = _mm_srli_epi32(lo, 1);
+   t4 = _mm_srli_epi32(lo, 2);
+   t5 = _mm_srli_epi32(lo, 7);
+   t3 = _mm_xor_si128(t3, _mm_xor_si128(t4, t5));
+   t3 = _mm_xor_si128(t3, t2);
+   lo = _mm_xor_si128(lo, t3);
+   return _mm_xor_si128(hi, lo);
+}
+
+/**
+  GCM GF multiply with PCLMULQDQ, bit-exact drop-in for gcm_gf_mult
+  @param a   The first value
+  @param b   The second value
+  @param c   [out] The product of the two
+*/
+LTC_CLMUL_CALL
+void gcm_gf_mult_clmul(const unsigned char *a, const unsigned char *b, unsigned char *c)
+{
+   const __m128i BSWAP = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+   __m128i A, B, lo, hi;
+
+   /* byte swap so the 128-bit value is the full bit reflection of the
+    * GCM-order polynomial */
+   A = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)a), BSWAP);
+   B = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)b), BSWAP);
+
+   _clmul_mul256(A, B, &lo, &hi);
+   _mm_storeu_si128((__m128i *)c, _mm_shuffle_epi8(_clmul_reduce(lo, hi), BSWAP));
+}
+
+/**
+  Aggregated GHASH: fold eight blocks into the accumulator with one reduction
+
+  Computes X = (X ^ C0)*H^8 ^ C1*H^7 ^ ... ^ C7*H, summing the unreduced
+  256-bit products so the modular reduction runs once per eight blocks.
+
+  @param hp  H^1..H^8, 16 octets each in GCM byte order (lowest power first)
+  @param ct  The eight 16-octet blocks to fold
+  @param x   [in/out] The GHASH accumulator
+*/
+LTC_CLMUL_CALL
+void gcm_gf_mult_clmul_fold8(const unsigned char *hp, const unsigned char *ct, unsigned char *x)
+{
+   const __m128i BSWAP = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+   __m128i A, H, lo, hi, tlo, thi;
+   int i;
+
+   /* the accumulator rides along with the first block, against H^8 */
+   A = _mm_xor_si128(_mm_loadu_si128((const __m128i *)x), _mm_loadu_si128((const __m128i *)ct));
+   A = _mm_shuffle_epi8(A, BSWAP);
+   H = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(hp + 112)), BSWAP);
+   _clmul_mul256(A, H, &lo, &hi);
+
+   for (i = 1; i < 8; i++) {
+      A = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(ct + (i << 4))), BSWAP);
+      H = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(hp + ((7 - i) << 4))), BSWAP);
+      _clmul_mul256(A, H, &tlo, &thi);
+      lo = _mm_xor_si128(lo, tlo);
+      hi = _mm_xor_si128(hi, thi);
+   }
+
+   _mm_storeu_si128((__m128i *)x, _mm_shuffle_epi8(_clmul_reduce(lo, hi), BSWAP));
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,66 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gcm_init_ex.c
+   GCM implementation, initialize state from shared key material, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_MODE
+
+/**
+  Initialize a GCM state against a precomp object
+
+  The precomp object is referenced, not copied; it must outlive the state
+  and may serve many states at once.  gcm_done() will not release it, use
+  gcm_precompute_done() when the key is retired.
+
+  @param gcm   The GCM state to initialize
+  @param pre   Precomputed key material from gcm_precompute()
+  @return CRYPT_OK on success
+ */
+int gcm_init_ex(gcm_state *gcm, gcm_precomp *pre)
+{
+   int err;
+
+   LTC_ARGCHK(gcm != NULL);
+   LTC_ARGCHK(pre != NULL);
+
+#ifdef LTC_FAST
+   if (16 % sizeof(LTC_FAST_TYPE)) {
+      return CRYPT_INVALID_ARG;
+   }
+#endif
+
+   if ((err = cipher_is_valid(pre->cipher)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* setup state */
+   zeromem(gcm->buf, sizeof(gcm->buf));
+   zeromem(gcm->X,   sizeof(gcm->X));
+   gcm->pre      = pre;
+   gcm->cipher   = pre->cipher;
+   gcm->mode     = LTC_GCM_MODE_IV;
+   gcm->ivmode   = 0;
+   gcm->buflen   = 0;
+   gcm->totlen   = 0;
+   gcm->pttotlen = 0;
+
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
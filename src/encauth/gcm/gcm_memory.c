@@ -43,7 +43,6 @@ int gcm_memory(      int           cipher,
                      unsigned char *tag,    unsigned long *taglen,
                                int direction)
 {
-    void      *orig;
     gcm_state *gcm;
     int        err;
 
@@ -65,25 +64,14 @@ int gcm_memory(      int           cipher,
 
 
 
-#ifndef LTC_GCM_TABLES_SSE2
-    orig = gcm = XMALLOC(sizeof(*gcm));
-#else
-    orig = gcm = XMALLOC(sizeof(*gcm) + 16);
-#endif
+    LTC_MEM_TAG("gcm");
+    /* cache-line aligned so the PC tables start on a line (and SSE2
+     * gets its 16-octet alignment for free) */
+    gcm = XMALLOC_ALIGNED(sizeof(*gcm), 64);
     if (gcm == NULL) {
         return CRYPT_MEM;
     }
 
-   /* Force GCM to be on a multiple of 16 so we can use 128-bit aligned operations
-    * note that we only modify gcm and keep orig intact.  This code is not portable
-    * but again it's only for SSE2 anyways, so who cares?
-    */
-#ifdef LTC_GCM_TABLES_SSE2
-   if ((unsigned long)gcm & 15) {
-      gcm = (gcm_state *)((unsigned long)gcm + (16 - ((unsigned long)gcm & 15)));
-   }
-#endif
-
     if ((err = gcm_init(gcm, cipher, key, keylen)) != CRYPT_OK) {
        goto LTC_ERR;
     }
@@ -98,7 +86,7 @@ int gcm_memory(      int           cipher,
     }
     err = gcm_done(gcm, tag, taglen);
 LTC_ERR:
-    XFREE(orig);
+    XFREE_ALIGNED(gcm);
     return err;
 }
 #endif
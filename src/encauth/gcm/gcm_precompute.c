@@ -0,0 +1,133 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gcm_precompute.c
+   GCM implementation, derive shareable key material, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_MODE
+
+/**
+  Precompute the GCM key material (key schedule, H and its tables/powers)
+
+  The result is never written to afterwards, so one precomp object may be
+  referenced by any number of gcm_states via gcm_init_ex().
+
+  @param pre     The precomp object to fill
+  @param cipher  The index of the cipher to use
+  @param key     The secret key
+  @param keylen  The length of the secret key
+  @return CRYPT_OK on success
+ */
+int gcm_precompute(gcm_precomp *pre, int cipher,
+                   const unsigned char *key, int keylen)
+{
+   int           err;
+   unsigned char B[16];
+#ifdef LTC_GCM_TABLES
+   int           x, y, z, t;
+#endif
+
+   LTC_ARGCHK(pre != NULL);
+   LTC_ARGCHK(key != NULL);
+
+   /* is cipher valid? */
+   if ((err = cipher_is_valid(cipher)) != CRYPT_OK) {
+      return err;
+   }
+   if (cipher_descriptor[cipher].block_length != 16) {
+      return CRYPT_INVALID_CIPHER;
+   }
+
+   /* schedule key */
+   if ((err = cipher_setup_cached(cipher, key, keylen, 0, &pre->K)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* H = E(0) */
+   zeromem(B, 16);
+   if ((err = cipher_descriptor[cipher].ecb_encrypt(B, pre->H, &pre->K)) != CRYPT_OK) {
+      return err;
+   }
+
+   pre->cipher = cipher;
+
+#ifdef LTC_GF_CLMUL
+   /* the carry-less multiply backend works straight from H, skip the tables */
+   pre->clmul = gcm_gf_mult_clmul_enabled();
+   if (pre->clmul) {
+      int i;
+      /* powers of H drive the aggregated (eight blocks per reduction) GHASH */
+      XMEMCPY(pre->HP[0], pre->H, 16);
+      for (i = 1; i < 8; i++) {
+         gcm_gf_mult_clmul(pre->HP[i-1], pre->H, pre->HP[i]);
+      }
+      return CRYPT_OK;
+   }
+#endif
+
+#ifdef LTC_GCM_TABLES
+   /* setup tables */
+
+   /* generate the first table as it has no shifting (from which we make the other tables) */
+   zeromem(B, 16);
+   for (y = 0; y < 256; y++) {
+        B[0] = y;
+        gcm_gf_mult(pre->H, B, &pre->PC[0][y][0]);
+   }
+
+   /* now generate the rest of the tables based the previous table */
+   for (x = 1; x < 16; x++) {
+      for (y = 0; y < 256; y++) {
+         /* now shift it right by 8 bits */
+         t = pre->PC[x-1][y][15];
+         for (z = 15; z > 0; z--) {
+             pre->PC[x][y][z] = pre->PC[x-1][y][z-1];
+         }
+         pre->PC[x][y][0] = gcm_shift_table[t<<1];
+         pre->PC[x][y][1] ^= gcm_shift_table[(t<<1)+1];
+      }
+   }
+
+#endif
+
+   return CRYPT_OK;
+}
+
+/**
+  Release a precomp object once no gcm_state references it any more
+  @param pre   The precomp object
+  @return CRYPT_OK on success
+ */
+int gcm_precompute_done(gcm_precomp *pre)
+{
+   int err;
+
+   LTC_ARGCHK(pre != NULL);
+
+   if ((err = cipher_is_valid(pre->cipher)) != CRYPT_OK) {
+      return err;
+   }
+   cipher_descriptor[pre->cipher].done(&pre->K);
+#ifdef LTC_CLEAN_STACK
+   zeromem(pre, sizeof(*pre));
+#endif
+
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
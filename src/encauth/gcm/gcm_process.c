@@ -67,7 +67,7 @@ int gcm_process(gcm_state *gcm,
           if (++gcm->Y[y] & 255) { break; }
       }
       /* encrypt the counter */
-      if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->K)) != CRYPT_OK) {
+      if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->pre->K)) != CRYPT_OK) {
          return err;
       }
 
@@ -79,11 +79,122 @@ int gcm_process(gcm_state *gcm,
       return CRYPT_INVALID_ARG;
    }
 
+   /* a buffered partial block or an off-size call ends up in the
+    * byte-at-a-time loop */
+   LTC_STATS_BUMP(LTC_STAT_GCM_PROCESS, gcm->cipher, ptlen,
+                  (gcm->buflen != 0) || (ptlen & 15) != 0);
+
    x = 0;
+#ifdef LTC_GF_CLMUL
+   /* aggregated GHASH: fold eight blocks per reduction through the H powers */
+   if (gcm->pre->clmul && gcm->buflen == 0) {
+      unsigned long z;
+
+      /* stitched path: batch the counter blocks through the multi-block ECB
+       * accelerator and schedule each chunk's GHASH fold right behind the
+       * next chunk's AES call, so the multiplier and the AES units overlap */
+      if (cipher_descriptor[gcm->cipher].accel_ecb_encrypt != NULL && ptlen - x >= 128) {
+         unsigned char ctrs[128], kbuf[128], *pend = NULL;
+         const unsigned char *ks;
+         while (ptlen - x >= 128) {
+            for (z = 0; z < 128; z += 16) {
+               for (y = 15; y >= 12; y--) {
+                  if (++gcm->Y[y] & 255) { break; }
+               }
+               XMEMCPY(&ctrs[z], gcm->Y, 16);
+            }
+            if ((err = cipher_descriptor[gcm->cipher].accel_ecb_encrypt(ctrs, kbuf, 8, &gcm->pre->K)) != CRYPT_OK) {
+               return err;
+            }
+            /* this fold only touches ciphertext that is already final, so it
+             * is independent of the AES results in flight */
+            if (direction == GCM_DECRYPT) {
+               gcm_gf_mult_clmul_fold8(gcm->pre->HP[0], &ct[x], gcm->X);
+            } else if (pend != NULL) {
+               gcm_gf_mult_clmul_fold8(gcm->pre->HP[0], pend, gcm->X);
+            }
+            /* keystream: the carried pad first, then the fresh blocks */
+            for (z = 0; z < 128; z += 16) {
+               ks = (z == 0) ? gcm->buf : &kbuf[z - 16];
+#ifdef LTC_FAST
+               for (y = 0; y < 16; y += (int)sizeof(LTC_FAST_TYPE)) {
+                  if (direction == GCM_ENCRYPT) {
+                     *(LTC_FAST_TYPE_PTR_CAST(&ct[x + z + y])) = *(LTC_FAST_TYPE_PTR_CAST(&pt[x + z + y])) ^ *(LTC_FAST_TYPE_PTR_CAST(&ks[y]));
+                  } else {
+                     *(LTC_FAST_TYPE_PTR_CAST(&pt[x + z + y])) = *(LTC_FAST_TYPE_PTR_CAST(&ct[x + z + y])) ^ *(LTC_FAST_TYPE_PTR_CAST(&ks[y]));
+                  }
+               }
+#else
+               for (y = 0; y < 16; y++) {
+                  if (direction == GCM_ENCRYPT) {
+                     ct[x + z + y] = pt[x + z + y] ^ ks[y];
+                  } else {
+                     pt[x + z + y] = ct[x + z + y] ^ ks[y];
+                  }
+               }
+#endif
+            }
+            if (direction == GCM_ENCRYPT) {
+               pend = &ct[x];
+            }
+            XMEMCPY(gcm->buf, &kbuf[112], 16);
+            gcm->pttotlen += 1024;
+            x += 128;
+         }
+         /* drain the fold the pipeline still owes */
+         if (pend != NULL) {
+            gcm_gf_mult_clmul_fold8(gcm->pre->HP[0], pend, gcm->X);
+         }
+#ifdef LTC_CLEAN_STACK
+         zeromem(ctrs, sizeof(ctrs));
+         zeromem(kbuf, sizeof(kbuf));
+#endif
+      }
+
+      while (ptlen - x >= 128) {
+         if (direction == GCM_DECRYPT) {
+            /* mix the ciphertext in before it is overwritten (pt may equal ct) */
+            gcm_gf_mult_clmul_fold8(gcm->pre->HP[0], &ct[x], gcm->X);
+         }
+         for (z = x; z < x + 128; z += 16) {
+            /* ctr encrypt */
+#ifdef LTC_FAST
+            for (y = 0; y < 16; y += (int)sizeof(LTC_FAST_TYPE)) {
+               if (direction == GCM_ENCRYPT) {
+                  *(LTC_FAST_TYPE_PTR_CAST(&ct[z + y])) = *(LTC_FAST_TYPE_PTR_CAST(&pt[z + y])) ^ *(LTC_FAST_TYPE_PTR_CAST(&gcm->buf[y]));
+               } else {
+                  *(LTC_FAST_TYPE_PTR_CAST(&pt[z + y])) = *(LTC_FAST_TYPE_PTR_CAST(&ct[z + y])) ^ *(LTC_FAST_TYPE_PTR_CAST(&gcm->buf[y]));
+               }
+            }
+#else
+            for (y = 0; y < 16; y++) {
+               if (direction == GCM_ENCRYPT) {
+                  ct[z + y] = pt[z + y] ^ gcm->buf[y];
+               } else {
+                  pt[z + y] = ct[z + y] ^ gcm->buf[y];
+               }
+            }
+#endif
+            /* increment counter */
+            for (y = 15; y >= 12; y--) {
+               if (++gcm->Y[y] & 255) { break; }
+            }
+            if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->pre->K)) != CRYPT_OK) {
+               return err;
+            }
+         }
+         if (direction == GCM_ENCRYPT) {
+            gcm_gf_mult_clmul_fold8(gcm->pre->HP[0], &ct[x], gcm->X);
+         }
+         gcm->pttotlen += 1024;
+         x += 128;
+      }
+   }
+#endif
 #ifdef LTC_FAST
    if (gcm->buflen == 0) {
       if (direction == GCM_ENCRYPT) {
-         for (x = 0; x < (ptlen & ~15); x += 16) {
+         for (; x < (ptlen & ~15); x += 16) {
              /* ctr encrypt */
              for (y = 0; y < 16; y += sizeof(LTC_FAST_TYPE)) {
                  *(LTC_FAST_TYPE_PTR_CAST(&ct[x + y])) = *(LTC_FAST_TYPE_PTR_CAST(&pt[x+y])) ^ *(LTC_FAST_TYPE_PTR_CAST(&gcm->buf[y]));
@@ -96,12 +207,12 @@ int gcm_process(gcm_state *gcm,
              for (y = 15; y >= 12; y--) {
                  if (++gcm->Y[y] & 255) { break; }
              }
-             if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->K)) != CRYPT_OK) {
+             if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->pre->K)) != CRYPT_OK) {
                 return err;
              }
          }
       } else {
-         for (x = 0; x < (ptlen & ~15); x += 16) {
+         for (; x < (ptlen & ~15); x += 16) {
              /* ctr encrypt */
              for (y = 0; y < 16; y += sizeof(LTC_FAST_TYPE)) {
                  *(LTC_FAST_TYPE_PTR_CAST(&gcm->X[y])) ^= *(LTC_FAST_TYPE_PTR_CAST(&ct[x+y]));
@@ -114,7 +225,7 @@ int gcm_process(gcm_state *gcm,
              for (y = 15; y >= 12; y--) {
                  if (++gcm->Y[y] & 255) { break; }
              }
-             if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->K)) != CRYPT_OK) {
+             if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->pre->K)) != CRYPT_OK) {
                 return err;
              }
          }
@@ -132,7 +243,7 @@ int gcm_process(gcm_state *gcm,
           for (y = 15; y >= 12; y--) {
               if (++gcm->Y[y] & 255) { break; }
           }
-          if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->K)) != CRYPT_OK) {
+          if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->pre->K)) != CRYPT_OK) {
              return err;
           }
           gcm->buflen = 0;
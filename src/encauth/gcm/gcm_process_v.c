@@ -0,0 +1,56 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+   @file gcm_process_v.c
+   GCM implementation, process a scattered message, by Tom St Denis
+*/
+
+#ifdef LTC_GCM_MODE
+
+/**
+  Process a fragment chain of plaintext (or ciphertext) through GCM.
+  Each fragment is encrypted (or decrypted) in place; the existing state
+  buffering carries partial blocks across fragment boundaries, so the
+  chain behaves exactly like one contiguous buffer.
+  @param gcm       The GCM state
+  @param iov       The array of fragments, processed in place
+  @param iovcnt    The number of fragments
+  @param direction Encrypt or Decrypt mode (GCM_ENCRYPT or GCM_DECRYPT)
+  @return CRYPT_OK on success
+ */
+int gcm_process_v(gcm_state *gcm,
+                  const ltc_iovec *iov, int iovcnt,
+                  int direction)
+{
+   int x, err;
+
+   LTC_ARGCHK(gcm != NULL);
+   LTC_ARGCHK(iov != NULL || iovcnt == 0);
+
+   for (x = 0; x < iovcnt; x++) {
+      if (iov[x].len == 0) {
+         continue;
+      }
+      if ((err = gcm_process(gcm, iov[x].data, iov[x].len, iov[x].data, direction)) != CRYPT_OK) {
+         return err;
+      }
+   }
+
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,76 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gcmsiv_memory.c
+   AES-GCM-SIV (RFC 8452), process a packet from a raw key, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_SIV_MODE
+
+/**
+  Process an entire GCM-SIV packet in one call.
+
+  Schedules the key-generating key and discards it afterwards; callers
+  sending many packets under one key should gcmsiv_precompute() once
+  and use gcmsiv_memory_ex() instead.
+
+  @param cipher    The index of the cipher to use (128-bit block)
+  @param key       The key-generating key
+  @param keylen    The length of the key (16 or 32 octets)
+  @param IV        The nonce
+  @param IVlen     The length of the nonce (must be 12 octets)
+  @param adata     The additional authenticated data
+  @param adatalen  The length of the AAD (octets)
+  @param pt        The plaintext
+  @param ptlen     The length of the plaintext/ciphertext (octets)
+  @param ct        The ciphertext
+  @param tag       [out on encrypt, in on decrypt] The tag
+  @param taglen    [in/out] The tag length (must admit 16 octets)
+  @param direction Encrypt or Decrypt mode (GCM_ENCRYPT or GCM_DECRYPT)
+  @return CRYPT_OK on success
+*/
+int gcmsiv_memory(   int            cipher,
+               const unsigned char *key,    unsigned long keylen,
+               const unsigned char *IV,     unsigned long IVlen,
+               const unsigned char *adata,  unsigned long adatalen,
+                     unsigned char *pt,     unsigned long ptlen,
+                     unsigned char *ct,
+                     unsigned char *tag,    unsigned long *taglen,
+                               int direction)
+{
+   gcmsiv_precomp *pre;
+   int             err;
+
+   LTC_ARGCHK(key != NULL);
+
+   pre = XMALLOC(sizeof(*pre));
+   if (pre == NULL) {
+      return CRYPT_MEM;
+   }
+   if ((err = gcmsiv_precompute(pre, cipher, key, keylen)) != CRYPT_OK) {
+      goto error;
+   }
+   err = gcmsiv_memory_ex(pre, IV, IVlen, adata, adatalen,
+                          pt, ptlen, ct, tag, taglen, direction);
+   gcmsiv_precompute_done(pre);
+error:
+   zeromem(pre, sizeof(*pre));
+   XFREE(pre);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,200 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gcmsiv_memory_ex.c
+   AES-GCM-SIV (RFC 8452), process a packet with precomputed keys, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_SIV_MODE
+
+/* derive the per-message keys: msg-auth (16) and msg-enc (16 or 32),
+ * 8 octets out of each encryption of LE32(i) || nonce */
+static int s_derive(const gcmsiv_precomp *pre, const unsigned char *IV,
+                    unsigned char *ak, unsigned char *ek, int *eklen)
+{
+   unsigned char blk[16], out[16];
+   int i, n, err;
+
+   *eklen = (pre->keylen == 32) ? 32 : 16;
+   n = 2 + (*eklen >> 3);          /* 4 blocks for AES-128, 6 for AES-256 */
+
+   XMEMCPY(blk + 4, IV, 12);
+   for (i = 0; i < n; i++) {
+      STORE32L((ulong32)i, blk);
+      if ((err = cipher_descriptor[pre->cipher].ecb_encrypt(blk, out, (symmetric_key *)&pre->K)) != CRYPT_OK) {
+         return err;
+      }
+      if (i < 2) {
+         XMEMCPY(ak + 8*i,       out, 8);
+      } else {
+         XMEMCPY(ek + 8*(i - 2), out, 8);
+      }
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(blk, sizeof(blk));
+   zeromem(out, sizeof(out));
+#endif
+   return CRYPT_OK;
+}
+
+/* AES-CTR per RFC 8452: 32-bit little-endian counter in octets 0..3 */
+static int s_ctr(symmetric_key *sk, int cipher, const unsigned char *tag,
+                 const unsigned char *in, unsigned char *out, unsigned long len)
+{
+   unsigned char blk[16], ks[16];
+   ulong32 ctr;
+   unsigned long x, y;
+   int err;
+
+   XMEMCPY(blk, tag, 16);
+   blk[15] |= 0x80;
+   LOAD32L(ctr, blk);
+
+   for (x = 0; x < len; x += 16) {
+      STORE32L(ctr, blk);
+      ctr++;
+      if ((err = cipher_descriptor[cipher].ecb_encrypt(blk, ks, sk)) != CRYPT_OK) {
+         return err;
+      }
+      for (y = 0; y < 16 && x + y < len; y++) {
+         out[x + y] = in[x + y] ^ ks[y];
+      }
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(blk, sizeof(blk));
+   zeromem(ks,  sizeof(ks));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Process an entire GCM-SIV packet with precomputed key material.
+
+  The precomp object is read-only here, so one object can serve any
+  number of threads.  On decrypt the tag is an input: the packet is
+  rejected (CRYPT_ERROR, pt zeroed) when it does not verify, since
+  unauthenticated SIV plaintext must never be released.
+
+  @param pre       The precomputed key material (gcmsiv_precompute())
+  @param IV        The nonce
+  @param IVlen     The length of the nonce (must be 12 octets)
+  @param adata     The additional authenticated data
+  @param adatalen  The length of the AAD (octets)
+  @param pt        The plaintext
+  @param ptlen     The length of the plaintext/ciphertext (octets)
+  @param ct        The ciphertext
+  @param tag       [out on encrypt, in on decrypt] The tag
+  @param taglen    [in/out] The tag length (must admit 16 octets)
+  @param direction Encrypt or Decrypt mode (GCM_ENCRYPT or GCM_DECRYPT)
+  @return CRYPT_OK on success
+*/
+int gcmsiv_memory_ex(const gcmsiv_precomp *pre,
+               const unsigned char *IV,     unsigned long IVlen,
+               const unsigned char *adata,  unsigned long adatalen,
+                     unsigned char *pt,     unsigned long ptlen,
+                     unsigned char *ct,
+                     unsigned char *tag,    unsigned long *taglen,
+                               int direction)
+{
+   unsigned char ak[16], ek[32], S[16], T[16];
+   symmetric_key *ek_sk;
+   int           eklen, err, i;
+
+   LTC_ARGCHK(pre    != NULL);
+   LTC_ARGCHK(IV     != NULL);
+   LTC_ARGCHK(tag    != NULL);
+   LTC_ARGCHK(taglen != NULL);
+   if (adatalen > 0) {
+      LTC_ARGCHK(adata != NULL);
+   }
+   if (ptlen > 0) {
+      LTC_ARGCHK(pt != NULL);
+      LTC_ARGCHK(ct != NULL);
+   }
+
+   if (IVlen != 12) {
+      return CRYPT_INVALID_ARG;
+   }
+   if (*taglen < 16) {
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+   if ((err = cipher_is_valid(pre->cipher)) != CRYPT_OK) {
+      return err;
+   }
+
+   ek_sk = XMALLOC(sizeof(*ek_sk));
+   if (ek_sk == NULL) {
+      return CRYPT_MEM;
+   }
+
+   if ((err = s_derive(pre, IV, ak, ek, &eklen)) != CRYPT_OK) {
+      goto error;
+   }
+   if ((err = cipher_descriptor[pre->cipher].setup(ek, eklen, 0, ek_sk)) != CRYPT_OK) {
+      goto error;
+   }
+
+   if (direction == GCM_ENCRYPT) {
+      /* S_s = POLYVAL(ak, aad, pt), nonce folded in, MSB cleared */
+      gcmsiv_polyval(ak, adata, adatalen, pt, ptlen, S);
+      for (i = 0; i < 12; i++) {
+         S[i] ^= IV[i];
+      }
+      S[15] &= 0x7F;
+      if ((err = cipher_descriptor[pre->cipher].ecb_encrypt(S, tag, ek_sk)) != CRYPT_OK) {
+         goto error;
+      }
+      *taglen = 16;
+      if ((err = s_ctr(ek_sk, pre->cipher, tag, pt, ct, ptlen)) != CRYPT_OK) {
+         goto error;
+      }
+   } else {
+      if ((err = s_ctr(ek_sk, pre->cipher, tag, ct, pt, ptlen)) != CRYPT_OK) {
+         goto error;
+      }
+      gcmsiv_polyval(ak, adata, adatalen, pt, ptlen, S);
+      for (i = 0; i < 12; i++) {
+         S[i] ^= IV[i];
+      }
+      S[15] &= 0x7F;
+      if ((err = cipher_descriptor[pre->cipher].ecb_encrypt(S, T, ek_sk)) != CRYPT_OK) {
+         goto error;
+      }
+      if (mem_neq(T, tag, 16) != 0) {
+         zeromem(pt, ptlen);
+         err = CRYPT_ERROR;
+         goto error;
+      }
+   }
+   err = CRYPT_OK;
+
+error:
+   if (cipher_descriptor[pre->cipher].done != NULL) {
+      cipher_descriptor[pre->cipher].done(ek_sk);
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(ak, sizeof(ak));
+   zeromem(ek, sizeof(ek));
+   zeromem(S,  sizeof(S));
+   zeromem(T,  sizeof(T));
+#endif
+   zeromem(ek_sk, sizeof(*ek_sk));
+   XFREE(ek_sk);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,124 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gcmsiv_polyval.c
+   AES-GCM-SIV (RFC 8452), the POLYVAL hash, by Tom St Denis
+
+   POLYVAL is GHASH with every operand bit-reflected (RFC 8452
+   appendix A): POLYVAL(H, X) = rev(GHASH(rev(H) * x, rev(X))), where
+   rev reverses the 16 octets and the mulX happens in GHASH's
+   convention.  That lets the GCM multiplier -- including the
+   carry-less CLMUL backend -- do the field work, at the price of one
+   byte reversal per block.
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_SIV_MODE
+
+static void s_rev(unsigned char *d, const unsigned char *s)
+{
+   int i;
+   for (i = 0; i < 16; i++) {
+      d[i] = s[15 - i];
+   }
+}
+
+static void s_gf_mult(const unsigned char *a, const unsigned char *b, unsigned char *c)
+{
+#ifdef LTC_GF_CLMUL
+   if (gcm_gf_mult_clmul_enabled()) {
+      gcm_gf_mult_clmul(a, b, c);
+      return;
+   }
+#endif
+   gcm_gf_mult(a, b, c);
+}
+
+/* absorb len octets (zero padding any trailing partial block) */
+static void s_absorb(unsigned char *S, const unsigned char *Hg,
+                     const unsigned char *in, unsigned long len)
+{
+   unsigned char B[16], T[16];
+   unsigned long x;
+   int y;
+
+   for (x = 0; x + 16 <= len; x += 16) {
+      s_rev(B, in + x);
+      for (y = 0; y < 16; y++) {
+         S[y] ^= B[y];
+      }
+      s_gf_mult(Hg, S, T);
+      XMEMCPY(S, T, 16);
+   }
+   if (x < len) {
+      zeromem(B, 16);
+      for (y = 0; x + y < len; y++) {
+         B[15 - y] = in[x + y];
+      }
+      for (y = 0; y < 16; y++) {
+         S[y] ^= B[y];
+      }
+      s_gf_mult(Hg, S, T);
+      XMEMCPY(S, T, 16);
+   }
+}
+
+/**
+  POLYVAL over aad || pt (each zero padded to a block) and the
+  GCM-SIV length block
+  @param h       The 16-octet POLYVAL key (message-authentication key)
+  @param aad     The additional authenticated data
+  @param aadlen  The length of the AAD (octets)
+  @param pt      The plaintext
+  @param ptlen   The length of the plaintext (octets)
+  @param out     [out] The 16-octet POLYVAL result
+*/
+void gcmsiv_polyval(const unsigned char *h,
+                    const unsigned char *aad, unsigned long aadlen,
+                    const unsigned char *pt,  unsigned long ptlen,
+                          unsigned char *out)
+{
+   static const unsigned char mulx[16] = { 0x40, 0 };  /* "x" in GHASH form */
+   unsigned char Hg[16], S[16], B[16], T[16];
+   int y;
+
+   /* Hg = rev(h) * x */
+   s_rev(T, h);
+   s_gf_mult(T, mulx, Hg);
+
+   zeromem(S, 16);
+   s_absorb(S, Hg, aad, aadlen);
+   s_absorb(S, Hg, pt,  ptlen);
+
+   /* length block: LE64(aad bits) || LE64(pt bits), reflected */
+   STORE64L(aadlen * CONST64(8), B + 0);
+   STORE64L(ptlen  * CONST64(8), B + 8);
+   s_rev(T, B);
+   for (y = 0; y < 16; y++) {
+      S[y] ^= T[y];
+   }
+   s_gf_mult(Hg, S, T);
+
+   s_rev(out, T);
+#ifdef LTC_CLEAN_STACK
+   zeromem(Hg, sizeof(Hg));
+   zeromem(S,  sizeof(S));
+   zeromem(B,  sizeof(B));
+   zeromem(T,  sizeof(T));
+#endif
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
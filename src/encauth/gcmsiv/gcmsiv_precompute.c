@@ -0,0 +1,80 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gcmsiv_precompute.c
+   AES-GCM-SIV (RFC 8452), derive shareable key material, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_SIV_MODE
+
+/**
+  Precompute the GCM-SIV key material (the key-generating key schedule)
+
+  GCM-SIV derives fresh authentication and encryption keys from the
+  nonce on every message, so unlike GCM there are no H tables to build
+  up front -- what is shareable is the scheduled key-generating key.
+  The result is never written to afterwards; one precomp object may be
+  used by any number of concurrent gcmsiv_memory_ex() calls.
+
+  @param pre     The precomp object to fill
+  @param cipher  The index of the cipher to use (must have a 128-bit block)
+  @param key     The key-generating key
+  @param keylen  The length of the key (16 or 32 octets)
+  @return CRYPT_OK on success
+ */
+int gcmsiv_precompute(gcmsiv_precomp *pre, int cipher,
+                      const unsigned char *key, unsigned long keylen)
+{
+   int err;
+
+   LTC_ARGCHK(pre != NULL);
+   LTC_ARGCHK(key != NULL);
+
+   if ((err = cipher_is_valid(cipher)) != CRYPT_OK) {
+      return err;
+   }
+   if (cipher_descriptor[cipher].block_length != 16) {
+      return CRYPT_INVALID_CIPHER;
+   }
+   if (keylen != 16 && keylen != 32) {
+      return CRYPT_INVALID_KEYSIZE;
+   }
+
+   if ((err = cipher_descriptor[cipher].setup(key, (int)keylen, 0, &pre->K)) != CRYPT_OK) {
+      return err;
+   }
+   pre->cipher = cipher;
+   pre->keylen = (int)keylen;
+   return CRYPT_OK;
+}
+
+/**
+  Terminate a GCM-SIV precomp object, wiping the key schedule
+  @param pre   The precomp object
+  @return CRYPT_OK on success
+*/
+int gcmsiv_precompute_done(gcmsiv_precomp *pre)
+{
+   LTC_ARGCHK(pre != NULL);
+   if (cipher_descriptor[pre->cipher].done != NULL) {
+      cipher_descriptor[pre->cipher].done(&pre->K);
+   }
+   zeromem(pre, sizeof(*pre));
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,142 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gcmsiv_test.c
+   AES-GCM-SIV (RFC 8452), self test, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_SIV_MODE
+
+/**
+  Test the GCM-SIV implementation
+  @return CRYPT_OK on success
+*/
+int gcmsiv_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   /* RFC 8452 appendix C vectors (expected is ct || tag) */
+   static const struct {
+      unsigned char key[32];  int keylen;
+      unsigned char IV[12];
+      unsigned char aad[12]; int aadlen;
+      unsigned char pt[16];  int ptlen;
+      unsigned char expect[32];
+   } tests[] = {
+      /* C.1, empty plaintext */
+      { { 0x01, }, 16,
+        { 0x03, },
+        { 0 }, 0,
+        { 0 }, 0,
+        { 0xdc,0x20,0xe2,0xd8,0x3f,0x25,0x70,0x5b,
+          0xb4,0x9e,0x43,0x9e,0xca,0x56,0xde,0x25 } },
+      /* C.1, 8 octet plaintext */
+      { { 0x01, }, 16,
+        { 0x03, },
+        { 0 }, 0,
+        { 0x01, }, 8,
+        { 0xb5,0xd8,0x39,0x33,0x0a,0xc7,0xb7,0x86,
+          0x57,0x87,0x82,0xff,0xf6,0x01,0x3b,0x81,
+          0x5b,0x28,0x7c,0x22,0x49,0x3a,0x36,0x4c } },
+      /* C.1, 16 octet plaintext */
+      { { 0x01, }, 16,
+        { 0x03, },
+        { 0 }, 0,
+        { 0x01, }, 16,
+        { 0x74,0x3f,0x7c,0x80,0x77,0xab,0x25,0xf8,
+          0x62,0x4e,0x2e,0x94,0x85,0x79,0xcf,0x77,
+          0x30,0x3a,0xaf,0x90,0xf6,0xfe,0x21,0x19,
+          0x9c,0x60,0x68,0x57,0x74,0x37,0xa0,0xc4 } },
+      /* C.1, 12 octet AAD, 4 octet plaintext */
+      { { 0x01, }, 16,
+        { 0x03, },
+        { 0x01, }, 12,
+        { 0x02, }, 4,
+        { 0xa8,0xfe,0x3e,0x87,0x07,0xeb,0x1f,0x84,
+          0xfb,0x28,0xf8,0xcb,0x73,0xde,0x8e,0x99,
+          0xe2,0xf4,0x8a,0x14 } },
+      /* C.2, AES-256, 8 octet plaintext */
+      { { 0x01, }, 32,
+        { 0x03, },
+        { 0 }, 0,
+        { 0x01, }, 8,
+        { 0xc2,0xef,0x32,0x8e,0x5c,0x71,0xc8,0x3b,
+          0x84,0x31,0x22,0x13,0x0f,0x73,0x64,0xb7,
+          0x61,0xe0,0xb9,0x74,0x27,0xe3,0xdf,0x28 } },
+   };
+   unsigned char out[48], pt[16], tag[16];
+   unsigned long taglen;
+   int           idx, err;
+   unsigned int  x;
+
+   idx = find_cipher("aes");
+   if (idx == -1) {
+      idx = find_cipher("rijndael");
+   }
+   if (idx == -1) {
+      return CRYPT_NOP;
+   }
+
+   for (x = 0; x < sizeof(tests)/sizeof(tests[0]); x++) {
+      /* encrypt */
+      taglen = sizeof(tag);
+      if ((err = gcmsiv_memory(idx, tests[x].key, tests[x].keylen,
+                               tests[x].IV, 12,
+                               tests[x].aad, tests[x].aadlen,
+                               (unsigned char *)tests[x].pt, tests[x].ptlen,
+                               out, tag, &taglen, GCM_ENCRYPT)) != CRYPT_OK) {
+         return err;
+      }
+      XMEMCPY(out + tests[x].ptlen, tag, 16);
+      if (compare_testvector(out, tests[x].ptlen + 16,
+                             tests[x].expect, tests[x].ptlen + 16,
+                             "GCM-SIV", x) != 0) {
+         return CRYPT_FAIL_TESTVECTOR;
+      }
+
+      /* decrypt back */
+      taglen = 16;
+      if ((err = gcmsiv_memory(idx, tests[x].key, tests[x].keylen,
+                               tests[x].IV, 12,
+                               tests[x].aad, tests[x].aadlen,
+                               pt, tests[x].ptlen,
+                               out, tag, &taglen, GCM_DECRYPT)) != CRYPT_OK) {
+         return err;
+      }
+      if (compare_testvector(pt, tests[x].ptlen,
+                             tests[x].pt, tests[x].ptlen,
+                             "GCM-SIV-PT", x) != 0) {
+         return CRYPT_FAIL_TESTVECTOR;
+      }
+
+      /* a flipped tag bit must be rejected and the plaintext wiped */
+      tag[0] ^= 1;
+      taglen = 16;
+      if (gcmsiv_memory(idx, tests[x].key, tests[x].keylen,
+                        tests[x].IV, 12,
+                        tests[x].aad, tests[x].aadlen,
+                        pt, tests[x].ptlen,
+                        out, tag, &taglen, GCM_DECRYPT) != CRYPT_ERROR) {
+         return CRYPT_FAIL_TESTVECTOR;
+      }
+   }
+   return CRYPT_OK;
+#endif
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -46,7 +46,50 @@ int ocb3_decrypt(ocb3_state *ocb, const unsigned char *ct, unsigned long ctlen,
    }
 
    full_blocks = ctlen/ocb->block_len;
-   for(i=0; i<full_blocks; i++) {
+   i = 0;
+
+#ifdef LTC_FAST
+   /* wide path: gather 8 offsets ahead of time and decrypt 8 whitened blocks
+    * per accelerated ECB call (see ocb3_encrypt.c) */
+   if (cipher_descriptor[ocb->cipher].accel_ecb_decrypt != NULL && ocb->block_len == 16) {
+      unsigned char offs[128], buf[128];
+      int j, y;
+
+      while (full_blocks - i >= 8) {
+         pt_b = (unsigned char *)pt+i*16;
+         ct_b = (unsigned char *)ct+i*16;
+
+         /* offs[] = the next 8 offsets, buf[] = ct[] XOR offs[] */
+         for (j = 0; j < 128; j += 16) {
+            ocb3_int_xor_blocks(ocb->Offset_current, ocb->Offset_current, ocb->L_[ocb3_int_ntz(ocb->block_index)], 16);
+            XMEMCPY(&offs[j], ocb->Offset_current, 16);
+            ocb->block_index++;
+         }
+         for (y = 0; y < 128; y += (int)sizeof(LTC_FAST_TYPE)) {
+            *(LTC_FAST_TYPE_PTR_CAST(&buf[y])) = *(LTC_FAST_TYPE_PTR_CAST(&ct_b[y])) ^ *(LTC_FAST_TYPE_PTR_CAST(&offs[y]));
+         }
+
+         /* decrypt all 8 blocks in one call */
+         if ((err = cipher_descriptor[ocb->cipher].accel_ecb_decrypt(buf, buf, 8, &ocb->key)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+
+         /* pt[] = buf[] XOR offs[], checksum[] = checksum[] XOR pt[] */
+         for (y = 0; y < 128; y += (int)sizeof(LTC_FAST_TYPE)) {
+            *(LTC_FAST_TYPE_PTR_CAST(&pt_b[y])) = *(LTC_FAST_TYPE_PTR_CAST(&buf[y])) ^ *(LTC_FAST_TYPE_PTR_CAST(&offs[y]));
+            *(LTC_FAST_TYPE_PTR_CAST(&ocb->checksum[y & 15])) ^= *(LTC_FAST_TYPE_PTR_CAST(&pt_b[y]));
+         }
+
+         i += 8;
+      }
+#ifdef LTC_CLEAN_STACK
+      zeromem(offs, sizeof(offs));
+      zeromem(buf,  sizeof(buf));
+#endif
+   }
+#endif
+
+   for(; i<full_blocks; i++) {
      pt_b = (unsigned char *)pt+i*ocb->block_len;
      ct_b = (unsigned char *)ct+i*ocb->block_len;
 
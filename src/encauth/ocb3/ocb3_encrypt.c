@@ -46,7 +46,51 @@ int ocb3_encrypt(ocb3_state *ocb, const unsigned char *pt, unsigned long ptlen,
    }
 
    full_blocks = ptlen/ocb->block_len;
-   for(i=0; i<full_blocks; i++) {
+   i = 0;
+
+#ifdef LTC_FAST
+   /* wide path: OCB3 blocks are independent once their offsets are known, so
+    * walk the (cheap, serial) offset recurrence 8 blocks ahead into a table
+    * and hand all 8 whitened blocks to the accelerated ECB callback at once */
+   if (cipher_descriptor[ocb->cipher].accel_ecb_encrypt != NULL && ocb->block_len == 16) {
+      unsigned char offs[128], buf[128];
+      int j, y;
+
+      while (full_blocks - i >= 8) {
+         pt_b = (unsigned char *)pt+i*16;
+         ct_b = (unsigned char *)ct+i*16;
+
+         /* offs[] = the next 8 offsets, buf[] = pt[] XOR offs[] */
+         for (j = 0; j < 128; j += 16) {
+            ocb3_int_xor_blocks(ocb->Offset_current, ocb->Offset_current, ocb->L_[ocb3_int_ntz(ocb->block_index)], 16);
+            XMEMCPY(&offs[j], ocb->Offset_current, 16);
+            ocb->block_index++;
+         }
+         for (y = 0; y < 128; y += (int)sizeof(LTC_FAST_TYPE)) {
+            *(LTC_FAST_TYPE_PTR_CAST(&buf[y])) = *(LTC_FAST_TYPE_PTR_CAST(&pt_b[y])) ^ *(LTC_FAST_TYPE_PTR_CAST(&offs[y]));
+         }
+
+         /* encrypt all 8 blocks in one call */
+         if ((err = cipher_descriptor[ocb->cipher].accel_ecb_encrypt(buf, buf, 8, &ocb->key)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+
+         /* ct[] = buf[] XOR offs[], checksum[] = checksum[] XOR pt[] */
+         for (y = 0; y < 128; y += (int)sizeof(LTC_FAST_TYPE)) {
+            *(LTC_FAST_TYPE_PTR_CAST(&ocb->checksum[y & 15])) ^= *(LTC_FAST_TYPE_PTR_CAST(&pt_b[y]));
+            *(LTC_FAST_TYPE_PTR_CAST(&ct_b[y])) = *(LTC_FAST_TYPE_PTR_CAST(&buf[y])) ^ *(LTC_FAST_TYPE_PTR_CAST(&offs[y]));
+         }
+
+         i += 8;
+      }
+#ifdef LTC_CLEAN_STACK
+      zeromem(offs, sizeof(offs));
+      zeromem(buf,  sizeof(buf));
+#endif
+   }
+#endif
+
+   for(; i<full_blocks; i++) {
      pt_b = (unsigned char *)pt+i*ocb->block_len;
      ct_b = (unsigned char *)ct+i*ocb->block_len;
 
@@ -0,0 +1,339 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file seal.c
+  Record-oriented seal/open one-shots.  A record protocol (TLS-style)
+  sets up an ltc_seal_state once per connection and then calls
+  ltc_seal()/ltc_open() per record: header as AAD, payload transformed
+  in place, tag appended to (or verified from) the end of the buffer.
+  Arguments are validated once here instead of once per underlying
+  call, no memory is allocated, and key schedules are reused across
+  records (gcm_reset, chachapoly setiv, ctr_setiv + HMAC midstates).
+*/
+
+#ifdef LTC_SEAL
+
+#if defined(LTC_CTR_MODE) && defined(LTC_HMAC)
+/* encrypt-then-MAC: bind both lengths so header/payload splits are
+   unambiguous under a shared MAC key */
+static int s_ctr_hmac_tag(ltc_seal_state *st,
+                          const unsigned char *header, unsigned long headerlen,
+                          const unsigned char *ct, unsigned long ctlen,
+                          unsigned char *tag, unsigned long *taglen)
+{
+   hmac_state hmac;
+   unsigned char lens[16];
+   int err;
+
+   STORE64L((ulong64)headerlen, lens);
+   STORE64L((ulong64)ctlen,     lens + 8);
+   if ((err = hmac_init_from_precomputed(&hmac, &st->u.ch.hmac)) != CRYPT_OK) {
+      return err;
+   }
+   if (headerlen > 0 &&
+       (err = hmac_process(&hmac, header, headerlen)) != CRYPT_OK) {
+      return err;
+   }
+   if (ctlen > 0 &&
+       (err = hmac_process(&hmac, ct, ctlen)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = hmac_process(&hmac, lens, sizeof(lens))) != CRYPT_OK) {
+      return err;
+   }
+   return hmac_done(&hmac, tag, taglen);
+}
+#endif
+
+#ifdef LTC_GCM_MODE
+/**
+  Initialize a seal state over GCM
+  @param st       The seal state to initialize
+  @param cipher   Index of the cipher (128-bit block)
+  @param key      The secret key
+  @param keylen   The length of the key (octets)
+  @param taglen   The record tag length, 4..16 (octets)
+  @return CRYPT_OK on success
+*/
+int ltc_seal_init_gcm(ltc_seal_state *st, int cipher,
+                      const unsigned char *key, unsigned long keylen,
+                      unsigned long taglen)
+{
+   int err;
+   LTC_ARGCHK(st != NULL);
+   if (taglen < 4 || taglen > 16) {
+      return CRYPT_INVALID_ARG;
+   }
+   if ((err = gcm_init(&st->u.gcm, cipher, key, keylen)) != CRYPT_OK) {
+      return err;
+   }
+   st->suite  = LTC_SEAL_GCM;
+   st->taglen = taglen;
+   return CRYPT_OK;
+}
+#endif
+
+#ifdef LTC_CHACHA20POLY1305_MODE
+/**
+  Initialize a seal state over ChaCha20-Poly1305
+  @param st       The seal state to initialize
+  @param key      The secret key
+  @param keylen   The length of the key (octets)
+  @param taglen   The record tag length, 4..16 (octets)
+  @return CRYPT_OK on success
+*/
+int ltc_seal_init_chachapoly(ltc_seal_state *st,
+                             const unsigned char *key, unsigned long keylen,
+                             unsigned long taglen)
+{
+   int err;
+   LTC_ARGCHK(st != NULL);
+   if (taglen < 4 || taglen > 16) {
+      return CRYPT_INVALID_ARG;
+   }
+   if ((err = chacha20poly1305_init(&st->u.chachapoly, key, keylen)) != CRYPT_OK) {
+      return err;
+   }
+   st->suite  = LTC_SEAL_CHACHAPOLY;
+   st->taglen = taglen;
+   return CRYPT_OK;
+}
+#endif
+
+#if defined(LTC_CTR_MODE) && defined(LTC_HMAC)
+/**
+  Initialize a seal state over CTR + HMAC (encrypt-then-MAC)
+  @param st         The seal state to initialize
+  @param cipher     Index of the cipher
+  @param hash       Index of the hash for the HMAC
+  @param enckey     The encryption key
+  @param enckeylen  The length of the encryption key (octets)
+  @param mackey     The MAC key (must differ from enckey in the protocol)
+  @param mackeylen  The length of the MAC key (octets)
+  @param taglen     The record tag length, 4..hash size (octets)
+  @return CRYPT_OK on success
+*/
+int ltc_seal_init_ctr_hmac(ltc_seal_state *st, int cipher, int hash,
+                           const unsigned char *enckey, unsigned long enckeylen,
+                           const unsigned char *mackey, unsigned long mackeylen,
+                           unsigned long taglen)
+{
+   unsigned char iv[MAXBLOCKSIZE];
+   int err;
+
+   LTC_ARGCHK(st != NULL);
+   if ((err = hash_is_valid(hash)) != CRYPT_OK) {
+      return err;
+   }
+   if (taglen < 4 || taglen > hash_descriptor[hash].hashsize) {
+      return CRYPT_INVALID_ARG;
+   }
+   /* the IV is replaced per record by ltc_seal()/ltc_open() */
+   zeromem(iv, sizeof(iv));
+   if ((err = ctr_start(cipher, iv, enckey, enckeylen, 0,
+                        CTR_COUNTER_BIG_ENDIAN, &st->u.ch.ctr)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = hmac_precompute(&st->u.ch.hmac, hash, mackey, mackeylen)) != CRYPT_OK) {
+      ctr_done(&st->u.ch.ctr);
+      return err;
+   }
+   st->suite  = LTC_SEAL_CTR_HMAC;
+   st->taglen = taglen;
+   return CRYPT_OK;
+}
+#endif
+
+/**
+  Seal one record: encrypt the payload in place and append the tag
+  @param st         The seal state
+  @param nonce      The per-record nonce (never repeat under one key)
+  @param noncelen   The length of the nonce (octets)
+  @param header     The record header, authenticated but not encrypted (may be NULL if headerlen is 0)
+  @param headerlen  The length of the header (octets)
+  @param buf        The payload; on output ciphertext with taglen tag octets appended
+  @param buflen     The length of the payload (octets); buf must have room for buflen + taglen
+  @return CRYPT_OK on success
+*/
+int ltc_seal(ltc_seal_state *st,
+             const unsigned char *nonce, unsigned long noncelen,
+             const unsigned char *header, unsigned long headerlen,
+             unsigned char *buf, unsigned long buflen)
+{
+   unsigned long tl;
+   int err;
+
+   LTC_ARGCHK(st    != NULL);
+   LTC_ARGCHK(nonce != NULL);
+   LTC_ARGCHK(buf   != NULL);
+
+   switch (st->suite) {
+#ifdef LTC_GCM_MODE
+      case LTC_SEAL_GCM:
+         if ((err = gcm_reset(&st->u.gcm)) != CRYPT_OK)                            return err;
+         if ((err = gcm_add_iv(&st->u.gcm, nonce, noncelen)) != CRYPT_OK)          return err;
+         if (headerlen > 0 &&
+             (err = gcm_add_aad(&st->u.gcm, header, headerlen)) != CRYPT_OK)       return err;
+         if (buflen > 0 &&
+             (err = gcm_process(&st->u.gcm, buf, buflen, buf, GCM_ENCRYPT)) != CRYPT_OK) return err;
+         tl = st->taglen;
+         return gcm_done(&st->u.gcm, buf + buflen, &tl);
+#endif
+#ifdef LTC_CHACHA20POLY1305_MODE
+      case LTC_SEAL_CHACHAPOLY:
+      {
+         /* _done wipes the chacha key, so run the record on a copy and
+            keep the keyed master intact for the next one */
+         chacha20poly1305_state rec = st->u.chachapoly;
+         unsigned char tag[16];
+         if ((err = chacha20poly1305_setiv(&rec, nonce, noncelen)) != CRYPT_OK)    return err;
+         if (headerlen > 0 &&
+             (err = chacha20poly1305_add_aad(&rec, header, headerlen)) != CRYPT_OK) return err;
+         if (buflen > 0 &&
+             (err = chacha20poly1305_encrypt(&rec, buf, buflen, buf)) != CRYPT_OK) return err;
+         tl = sizeof(tag);
+         if ((err = chacha20poly1305_done(&rec, tag, &tl)) != CRYPT_OK)            return err;
+         XMEMCPY(buf + buflen, tag, st->taglen);
+         return CRYPT_OK;
+      }
+#endif
+#if defined(LTC_CTR_MODE) && defined(LTC_HMAC)
+      case LTC_SEAL_CTR_HMAC:
+      {
+         unsigned char iv[MAXBLOCKSIZE], tag[MAXBLOCKSIZE];
+         if (noncelen > (unsigned long)st->u.ch.ctr.blocklen) {
+            return CRYPT_INVALID_ARG;
+         }
+         zeromem(iv, sizeof(iv));
+         XMEMCPY(iv, nonce, noncelen);
+         if ((err = ctr_setiv(iv, st->u.ch.ctr.blocklen, &st->u.ch.ctr)) != CRYPT_OK) return err;
+         if (buflen > 0 &&
+             (err = ctr_encrypt(buf, buf, buflen, &st->u.ch.ctr)) != CRYPT_OK)     return err;
+         tl = sizeof(tag);
+         if ((err = s_ctr_hmac_tag(st, header, headerlen, buf, buflen, tag, &tl)) != CRYPT_OK) return err;
+         XMEMCPY(buf + buflen, tag, st->taglen);
+         return CRYPT_OK;
+      }
+#endif
+      default:
+         return CRYPT_INVALID_ARG;
+   }
+}
+
+/**
+  Open one record: verify the appended tag and decrypt the payload in place
+  @param st         The seal state
+  @param nonce      The per-record nonce
+  @param noncelen   The length of the nonce (octets)
+  @param header     The record header (may be NULL if headerlen is 0)
+  @param headerlen  The length of the header (octets)
+  @param buf        The ciphertext followed by taglen tag octets; on success the payload
+  @param buflen     The length of the ciphertext WITHOUT the tag (octets)
+  @return CRYPT_OK on success, CRYPT_ERROR if the tag does not verify (payload zeroed)
+*/
+int ltc_open(ltc_seal_state *st,
+             const unsigned char *nonce, unsigned long noncelen,
+             const unsigned char *header, unsigned long headerlen,
+             unsigned char *buf, unsigned long buflen)
+{
+   unsigned char tag[MAXBLOCKSIZE];
+   unsigned long tl;
+   int err;
+
+   LTC_ARGCHK(st    != NULL);
+   LTC_ARGCHK(nonce != NULL);
+   LTC_ARGCHK(buf   != NULL);
+
+   switch (st->suite) {
+#ifdef LTC_GCM_MODE
+      case LTC_SEAL_GCM:
+         if ((err = gcm_reset(&st->u.gcm)) != CRYPT_OK)                            return err;
+         if ((err = gcm_add_iv(&st->u.gcm, nonce, noncelen)) != CRYPT_OK)          return err;
+         if (headerlen > 0 &&
+             (err = gcm_add_aad(&st->u.gcm, header, headerlen)) != CRYPT_OK)       return err;
+         if (buflen > 0 &&
+             (err = gcm_process(&st->u.gcm, buf, buflen, buf, GCM_DECRYPT)) != CRYPT_OK) return err;
+         tl = sizeof(tag);
+         if ((err = gcm_done(&st->u.gcm, tag, &tl)) != CRYPT_OK)                   return err;
+         break;
+#endif
+#ifdef LTC_CHACHA20POLY1305_MODE
+      case LTC_SEAL_CHACHAPOLY:
+      {
+         chacha20poly1305_state rec = st->u.chachapoly;
+         if ((err = chacha20poly1305_setiv(&rec, nonce, noncelen)) != CRYPT_OK)    return err;
+         if (headerlen > 0 &&
+             (err = chacha20poly1305_add_aad(&rec, header, headerlen)) != CRYPT_OK) return err;
+         if (buflen > 0 &&
+             (err = chacha20poly1305_decrypt(&rec, buf, buflen, buf)) != CRYPT_OK) return err;
+         tl = 16;
+         if ((err = chacha20poly1305_done(&rec, tag, &tl)) != CRYPT_OK)            return err;
+         break;
+      }
+#endif
+#if defined(LTC_CTR_MODE) && defined(LTC_HMAC)
+      case LTC_SEAL_CTR_HMAC:
+      {
+         unsigned char iv[MAXBLOCKSIZE];
+         /* verify before decrypting: never release keystream for forged records */
+         tl = sizeof(tag);
+         if ((err = s_ctr_hmac_tag(st, header, headerlen, buf, buflen, tag, &tl)) != CRYPT_OK) return err;
+         if (mem_neq(tag, buf + buflen, st->taglen) != 0) {
+            return CRYPT_ERROR;
+         }
+         if (noncelen > (unsigned long)st->u.ch.ctr.blocklen) {
+            return CRYPT_INVALID_ARG;
+         }
+         zeromem(iv, sizeof(iv));
+         XMEMCPY(iv, nonce, noncelen);
+         if ((err = ctr_setiv(iv, st->u.ch.ctr.blocklen, &st->u.ch.ctr)) != CRYPT_OK) return err;
+         if (buflen > 0 &&
+             (err = ctr_decrypt(buf, buf, buflen, &st->u.ch.ctr)) != CRYPT_OK)     return err;
+         return CRYPT_OK;
+      }
+#endif
+      default:
+         return CRYPT_INVALID_ARG;
+   }
+
+   /* AEAD suites decrypt before the tag is known: wipe on mismatch so a
+      caller who ignores the return value never sees the bogus payload */
+   if (mem_neq(tag, buf + buflen, st->taglen) != 0) {
+      zeromem(buf, buflen);
+      return CRYPT_ERROR;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Terminate a seal state, wiping the keys
+  @param st   The seal state
+  @return CRYPT_OK on success
+*/
+int ltc_seal_done(ltc_seal_state *st)
+{
+   LTC_ARGCHK(st != NULL);
+#if defined(LTC_CTR_MODE) && defined(LTC_HMAC)
+   if (st->suite == LTC_SEAL_CTR_HMAC) {
+      ctr_done(&st->u.ch.ctr);
+   }
+#endif
+   zeromem(st, sizeof(*st));
+   return CRYPT_OK;
+}
+
+#endif /* LTC_SEAL */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
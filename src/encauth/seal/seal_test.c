@@ -0,0 +1,187 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file seal_test.c
+  Record seal/open self-test: the one-shots must agree with the
+  underlying call sequences, round-trip, and reject tampering
+*/
+
+#ifdef LTC_SEAL
+
+int ltc_seal_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   unsigned char key[32], key2[32], nonce[12], header[13];
+   unsigned char pt[64], buf[64 + 16], ref[64], reftag[16];
+   unsigned long x, reftaglen;
+   ltc_seal_state st;
+   int err;
+
+   for (x = 0; x < sizeof(key);    x++) key[x]    = (unsigned char)x;
+   for (x = 0; x < sizeof(key2);   x++) key2[x]   = (unsigned char)(0xA0 ^ x);
+   for (x = 0; x < sizeof(nonce);  x++) nonce[x]  = (unsigned char)(x + 1);
+   for (x = 0; x < sizeof(header); x++) header[x] = (unsigned char)(0x40 + x);
+   for (x = 0; x < sizeof(pt);     x++) pt[x]     = (unsigned char)(0x80 + x);
+
+#ifdef LTC_GCM_MODE
+   {
+      int cipher = find_cipher("aes");
+      if (cipher != -1) {
+         /* against gcm_memory */
+         reftaglen = 16;
+         if ((err = gcm_memory(cipher, key, 32, nonce, sizeof(nonce),
+                               header, sizeof(header), pt, sizeof(pt), ref,
+                               reftag, &reftaglen, GCM_ENCRYPT)) != CRYPT_OK) {
+            return err;
+         }
+         if ((err = ltc_seal_init_gcm(&st, cipher, key, 32, 16)) != CRYPT_OK) {
+            return err;
+         }
+         XMEMCPY(buf, pt, sizeof(pt));
+         if ((err = ltc_seal(&st, nonce, sizeof(nonce), header, sizeof(header),
+                             buf, sizeof(pt))) != CRYPT_OK) {
+            return err;
+         }
+         if (XMEMCMP(buf, ref, sizeof(pt)) != 0 ||
+             XMEMCMP(buf + sizeof(pt), reftag, 16) != 0) {
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+         /* open restores the payload */
+         if ((err = ltc_open(&st, nonce, sizeof(nonce), header, sizeof(header),
+                             buf, sizeof(pt))) != CRYPT_OK) {
+            return err;
+         }
+         if (XMEMCMP(buf, pt, sizeof(pt)) != 0) {
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+         /* flipped tag bit must fail and wipe */
+         XMEMCPY(buf, ref, sizeof(pt));
+         XMEMCPY(buf + sizeof(pt), reftag, 16);
+         buf[sizeof(pt)] ^= 0x01;
+         if (ltc_open(&st, nonce, sizeof(nonce), header, sizeof(header),
+                      buf, sizeof(pt)) != CRYPT_ERROR) {
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+         for (x = 0; x < sizeof(pt); x++) {
+            if (buf[x] != 0) return CRYPT_FAIL_TESTVECTOR;
+         }
+         /* flipped header bit must fail */
+         XMEMCPY(buf, ref, sizeof(pt));
+         XMEMCPY(buf + sizeof(pt), reftag, 16);
+         header[0] ^= 0x01;
+         if (ltc_open(&st, nonce, sizeof(nonce), header, sizeof(header),
+                      buf, sizeof(pt)) != CRYPT_ERROR) {
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+         header[0] ^= 0x01;
+         if ((err = ltc_seal_done(&st)) != CRYPT_OK) {
+            return err;
+         }
+      }
+   }
+#endif
+
+#ifdef LTC_CHACHA20POLY1305_MODE
+   /* against chacha20poly1305_memory */
+   reftaglen = 16;
+   if ((err = chacha20poly1305_memory(key, 32, nonce, sizeof(nonce),
+                                      header, sizeof(header), pt, sizeof(pt), ref,
+                                      reftag, &reftaglen,
+                                      CHCHA20POLY1305_ENCRYPT)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = ltc_seal_init_chachapoly(&st, key, 32, 16)) != CRYPT_OK) {
+      return err;
+   }
+   XMEMCPY(buf, pt, sizeof(pt));
+   if ((err = ltc_seal(&st, nonce, sizeof(nonce), header, sizeof(header),
+                       buf, sizeof(pt))) != CRYPT_OK) {
+      return err;
+   }
+   if (XMEMCMP(buf, ref, sizeof(pt)) != 0 ||
+       XMEMCMP(buf + sizeof(pt), reftag, 16) != 0) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+   if ((err = ltc_open(&st, nonce, sizeof(nonce), header, sizeof(header),
+                       buf, sizeof(pt))) != CRYPT_OK) {
+      return err;
+   }
+   if (XMEMCMP(buf, pt, sizeof(pt)) != 0) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+   buf[sizeof(pt) + 3] ^= 0x80;
+   XMEMCPY(buf, ref, sizeof(pt));
+   if (ltc_open(&st, nonce, sizeof(nonce), header, sizeof(header),
+                buf, sizeof(pt)) != CRYPT_ERROR) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+   if ((err = ltc_seal_done(&st)) != CRYPT_OK) {
+      return err;
+   }
+#endif
+
+#if defined(LTC_CTR_MODE) && defined(LTC_HMAC)
+   {
+      int cipher = find_cipher("aes");
+      int hash   = find_hash("sha256");
+      if (cipher != -1 && hash != -1) {
+         unsigned long i;
+         if ((err = ltc_seal_init_ctr_hmac(&st, cipher, hash, key, 32,
+                                           key2, 32, 16)) != CRYPT_OK) {
+            return err;
+         }
+         /* round-trip several records on one state, including empty ones */
+         for (i = 0; i <= sizeof(pt); i += 21) {
+            nonce[0] = (unsigned char)i;
+            XMEMCPY(buf, pt, i);
+            if ((err = ltc_seal(&st, nonce, sizeof(nonce), header, sizeof(header),
+                                buf, i)) != CRYPT_OK) {
+               return err;
+            }
+            if (i > 0 && XMEMCMP(buf, pt, i) == 0) {
+               return CRYPT_FAIL_TESTVECTOR;
+            }
+            if ((err = ltc_open(&st, nonce, sizeof(nonce), header, sizeof(header),
+                                buf, i)) != CRYPT_OK) {
+               return err;
+            }
+            if (XMEMCMP(buf, pt, i) != 0) {
+               return CRYPT_FAIL_TESTVECTOR;
+            }
+            /* truncated-payload forgery: shift the split point */
+            if (i >= 21 &&
+                ltc_seal(&st, nonce, sizeof(nonce), header, sizeof(header),
+                         buf, i) == CRYPT_OK &&
+                ltc_open(&st, nonce, sizeof(nonce), header, sizeof(header),
+                         buf, i - 16) != CRYPT_ERROR) {
+               return CRYPT_FAIL_TESTVECTOR;
+            }
+         }
+         if ((err = ltc_seal_done(&st)) != CRYPT_OK) {
+            return err;
+         }
+      }
+   }
+#endif
+
+   return CRYPT_OK;
+#endif /* LTC_TEST */
+}
+
+#endif /* LTC_SEAL */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -81,6 +81,8 @@ const struct ltc_hash_descriptor blake2b_160_desc =
     &blake2b_process,
     &blake2b_done,
     &blake2b_160_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -96,6 +98,8 @@ const struct ltc_hash_descriptor blake2b_256_desc =
     &blake2b_process,
     &blake2b_done,
     &blake2b_256_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -111,6 +115,8 @@ const struct ltc_hash_descriptor blake2b_384_desc =
     &blake2b_process,
     &blake2b_done,
     &blake2b_384_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -126,6 +132,8 @@ const struct ltc_hash_descriptor blake2b_512_desc =
     &blake2b_process,
     &blake2b_done,
     &blake2b_512_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -153,49 +161,49 @@ static const unsigned char blake2b_sigma[12][16] =
   { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
 };
 
-static void blake2b_set_lastnode(hash_state *md) { md->blake2b.f[1] = CONST64(0xffffffffffffffff); }
+static void blake2b_set_lastnode(struct blake2b_state *S) { S->f[1] = CONST64(0xffffffffffffffff); }
 
 /* Some helper functions, not necessarily useful */
-static int blake2b_is_lastblock(const hash_state *md) { return md->blake2b.f[0] != 0; }
+static int blake2b_is_lastblock(const struct blake2b_state *S) { return S->f[0] != 0; }
 
-static void blake2b_set_lastblock(hash_state *md)
+static void blake2b_set_lastblock(struct blake2b_state *S)
 {
-   if (md->blake2b.last_node)
-      blake2b_set_lastnode(md);
+   if (S->last_node)
+      blake2b_set_lastnode(S);
 
-   md->blake2b.f[0] = CONST64(0xffffffffffffffff);
+   S->f[0] = CONST64(0xffffffffffffffff);
 }
 
-static void blake2b_increment_counter(hash_state *md, ulong64 inc)
+static void blake2b_increment_counter(struct blake2b_state *S, ulong64 inc)
 {
-   md->blake2b.t[0] += inc;
-   md->blake2b.t[1] += (md->blake2b.t[0] < inc);
+   S->t[0] += inc;
+   S->t[1] += (S->t[0] < inc);
 }
 
-static void blake2b_init0(hash_state *md)
+static void blake2b_init0(struct blake2b_state *S)
 {
    unsigned long i;
-   XMEMSET(&md->blake2b, 0, sizeof(md->blake2b));
+   XMEMSET(S, 0, sizeof(*S));
 
    for (i = 0; i < 8; ++i)
-      md->blake2b.h[i] = blake2b_IV[i];
+      S->h[i] = blake2b_IV[i];
 }
 
 /* init xors IV with input parameter block */
-static int blake2b_init_param(hash_state *md, const unsigned char *P)
+int blake2b_int_init_param(struct blake2b_state *S, const unsigned char *P)
 {
    unsigned long i;
 
-   blake2b_init0(md);
+   blake2b_init0(S);
 
    /* IV XOR ParamBlock */
    for (i = 0; i < 8; ++i) {
       ulong64 tmp;
       LOAD64L(tmp, P + i * 8);
-      md->blake2b.h[i] ^= tmp;
+      S->h[i] ^= tmp;
    }
 
-   md->blake2b.outlen = P[O_DIGEST_LENGTH];
+   S->outlen = P[O_DIGEST_LENGTH];
    return CRYPT_OK;
 }
 
@@ -219,7 +227,7 @@ int blake2b_init(hash_state *md, unsigned long outlen, const unsigned char *key,
    P[O_FANOUT] = 1;
    P[O_DEPTH] = 1;
 
-   err = blake2b_init_param(md, P);
+   err = blake2b_int_init_param(&md->blake2b, P);
    if (err != CRYPT_OK) return err;
 
    if (key) {
@@ -270,31 +278,37 @@ int blake2b_512_init(hash_state *md) { return blake2b_init(md, 64, NULL, 0); }
    } while (0)
 
 #ifdef LTC_CLEAN_STACK
-static int _blake2b_compress(hash_state *md, const unsigned char *buf)
+static int _blake2b_compress(struct blake2b_state *S, const unsigned char *buf)
 #else
-static int blake2b_compress(hash_state *md, const unsigned char *buf)
+static int blake2b_compress(struct blake2b_state *S, const unsigned char *buf)
 #endif
 {
    ulong64 m[16];
    ulong64 v[16];
    unsigned long i;
 
+#ifdef LTC_BLAKE2B_AVX2
+   if (blake2b_avx2_enabled()) {
+      return blake2b_avx2_compress(S, buf);
+   }
+#endif
+
    for (i = 0; i < 16; ++i) {
       LOAD64L(m[i], buf + i * sizeof(m[i]));
    }
 
    for (i = 0; i < 8; ++i) {
-      v[i] = md->blake2b.h[i];
+      v[i] = S->h[i];
    }
 
    v[8] = blake2b_IV[0];
    v[9] = blake2b_IV[1];
    v[10] = blake2b_IV[2];
    v[11] = blake2b_IV[3];
-   v[12] = blake2b_IV[4] ^ md->blake2b.t[0];
-   v[13] = blake2b_IV[5] ^ md->blake2b.t[1];
-   v[14] = blake2b_IV[6] ^ md->blake2b.f[0];
-   v[15] = blake2b_IV[7] ^ md->blake2b.f[1];
+   v[12] = blake2b_IV[4] ^ S->t[0];
+   v[13] = blake2b_IV[5] ^ S->t[1];
+   v[14] = blake2b_IV[6] ^ S->f[0];
+   v[15] = blake2b_IV[7] ^ S->f[1];
 
    ROUND(0);
    ROUND(1);
@@ -310,7 +324,7 @@ static int blake2b_compress(hash_state *md, const unsigned char *buf)
    ROUND(11);
 
    for (i = 0; i < 8; ++i) {
-      md->blake2b.h[i] = md->blake2b.h[i] ^ v[i] ^ v[i + 8];
+      S->h[i] = S->h[i] ^ v[i] ^ v[i + 8];
    }
    return CRYPT_OK;
 }
@@ -319,76 +333,92 @@ static int blake2b_compress(hash_state *md, const unsigned char *buf)
 #undef ROUND
 
 #ifdef LTC_CLEAN_STACK
-static int blake2b_compress(hash_state *md, const unsigned char *buf)
+static int blake2b_compress(struct blake2b_state *S, const unsigned char *buf)
 {
    int err;
-   err = _blake2b_compress(md, buf);
+   err = _blake2b_compress(S, buf);
    burn_stack(sizeof(ulong64) * 32 + sizeof(unsigned long));
    return err;
 }
 #endif
 
-int blake2b_process(hash_state *md, const unsigned char *in, unsigned long inlen)
+int blake2b_int_process(struct blake2b_state *S, const unsigned char *in, unsigned long inlen)
 {
-   LTC_ARGCHK(md != NULL);
-   LTC_ARGCHK(in != NULL);
-
-   if (md->blake2b.curlen > sizeof(md->blake2b.buf)) {
+   if (S->curlen > sizeof(S->buf)) {
       return CRYPT_INVALID_ARG;
    }
 
    if (inlen > 0) {
-      unsigned long left = md->blake2b.curlen;
+      unsigned long left = S->curlen;
       unsigned long fill = BLAKE2B_BLOCKBYTES - left;
       if (inlen > fill) {
-         md->blake2b.curlen = 0;
-         XMEMCPY(md->blake2b.buf + left, in, fill); /* Fill buffer */
-         blake2b_increment_counter(md, BLAKE2B_BLOCKBYTES);
-         blake2b_compress(md, md->blake2b.buf); /* Compress */
+         S->curlen = 0;
+         XMEMCPY(S->buf + left, in, fill); /* Fill buffer */
+         blake2b_increment_counter(S, BLAKE2B_BLOCKBYTES);
+         blake2b_compress(S, S->buf); /* Compress */
          in += fill;
          inlen -= fill;
          while (inlen > BLAKE2B_BLOCKBYTES) {
-            blake2b_increment_counter(md, BLAKE2B_BLOCKBYTES);
-            blake2b_compress(md, in);
+            blake2b_increment_counter(S, BLAKE2B_BLOCKBYTES);
+            blake2b_compress(S, in);
             in += BLAKE2B_BLOCKBYTES;
             inlen -= BLAKE2B_BLOCKBYTES;
          }
       }
-      XMEMCPY(md->blake2b.buf + md->blake2b.curlen, in, inlen);
-      md->blake2b.curlen += inlen;
+      XMEMCPY(S->buf + S->curlen, in, inlen);
+      S->curlen += inlen;
    }
    return CRYPT_OK;
 }
 
-int blake2b_done(hash_state *md, unsigned char *out)
+int blake2b_process(hash_state *md, const unsigned char *in, unsigned long inlen)
 {
-   unsigned char buffer[BLAKE2B_OUTBYTES] = { 0 };
-   unsigned long i;
-
    LTC_ARGCHK(md != NULL);
-   LTC_ARGCHK(out != NULL);
+   LTC_ARGCHK(in != NULL);
 
-   /* if(md->blakebs.outlen != outlen) return CRYPT_INVALID_ARG; */
+   return blake2b_int_process(&md->blake2b, in, inlen);
+}
 
-   if (blake2b_is_lastblock(md))
+int blake2b_int_done(struct blake2b_state *S, unsigned char *out)
+{
+   unsigned char buffer[BLAKE2B_OUTBYTES] = { 0 };
+   unsigned long i;
+
+   if (blake2b_is_lastblock(S))
       return CRYPT_ERROR;
 
-   blake2b_increment_counter(md, md->blake2b.curlen);
-   blake2b_set_lastblock(md);
-   XMEMSET(md->blake2b.buf + md->blake2b.curlen, 0, BLAKE2B_BLOCKBYTES - md->blake2b.curlen); /* Padding */
-   blake2b_compress(md, md->blake2b.buf);
+   blake2b_increment_counter(S, S->curlen);
+   blake2b_set_lastblock(S);
+   XMEMSET(S->buf + S->curlen, 0, BLAKE2B_BLOCKBYTES - S->curlen); /* Padding */
+   blake2b_compress(S, S->buf);
 
    for (i = 0; i < 8; ++i) /* Output full hash to temp buffer */
-      STORE64L(md->blake2b.h[i], buffer + i * 8);
+      STORE64L(S->h[i], buffer + i * 8);
 
-   XMEMCPY(out, buffer, md->blake2b.outlen);
-   zeromem(md, sizeof(hash_state));
+   XMEMCPY(out, buffer, S->outlen);
+   zeromem(S, sizeof(*S));
 #ifdef LTC_CLEAN_STACK
    zeromem(buffer, sizeof(buffer));
 #endif
    return CRYPT_OK;
 }
 
+int blake2b_done(hash_state *md, unsigned char *out)
+{
+   int err;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(out != NULL);
+
+   /* if(md->blakebs.outlen != outlen) return CRYPT_INVALID_ARG; */
+
+   if ((err = blake2b_int_done(&md->blake2b, out)) != CRYPT_OK) {
+      return err;
+   }
+   zeromem(md, sizeof(hash_state));
+   return CRYPT_OK;
+}
+
 /**
   Self-test the hash
   @return CRYPT_OK if successful, CRYPT_NOP if self-tests have been disabled
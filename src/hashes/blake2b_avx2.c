@@ -0,0 +1,158 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+  @file blake2b_avx2.c
+  AVX2 BLAKE2b compression function: the sixteen working words live in
+  four 256-bit rows, the column and diagonal half-rounds run on whole
+  rows and the 16/24/32-bit rotations are byte shuffles
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_BLAKE2B_AVX2
+
+/* immintrin.h drags in AVX-512 headers that are not C90 clean */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+#define LTC_BLAKE2B_AVX2_CALL __attribute__((target("avx2")))
+
+static const ulong64 blake2b_IV[8] =
+{
+  CONST64(0x6a09e667f3bcc908), CONST64(0xbb67ae8584caa73b),
+  CONST64(0x3c6ef372fe94f82b), CONST64(0xa54ff53a5f1d36f1),
+  CONST64(0x510e527fade682d1), CONST64(0x9b05688c2b3e6c1f),
+  CONST64(0x1f83d9abfb41bd6b), CONST64(0x5be0cd19137e2179)
+};
+
+static const unsigned char blake2b_sigma[12][16] =
+{
+  {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 } ,
+  { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 } ,
+  { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 } ,
+  {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 } ,
+  {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 } ,
+  {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 } ,
+  { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 } ,
+  { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 } ,
+  {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 } ,
+  { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13 , 0 } ,
+  {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 } ,
+  { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
+};
+
+int blake2b_avx2_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_AVX2) != 0;
+}
+
+/* rotations: 32 is a dword shuffle, 24 and 16 are byte shuffles, only 63
+ * needs real shifts */
+#define V_ROR32(x)    _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1))
+#define V_ROR24(x, r) _mm256_shuffle_epi8(x, r)
+#define V_ROR16(x, r) _mm256_shuffle_epi8(x, r)
+#define V_ROR63(x)    _mm256_or_si256(_mm256_srli_epi64(x, 63), _mm256_add_epi64(x, x))
+
+/* one lane per column; the b0 vector carries the four message words */
+#define V_G1(a, b, c, d, b0)                                     \
+   do {                                                          \
+      a = _mm256_add_epi64(_mm256_add_epi64(a, b), b0);          \
+      d = V_ROR32(_mm256_xor_si256(d, a));                       \
+      c = _mm256_add_epi64(c, d);                                \
+      b = V_ROR24(_mm256_xor_si256(b, c), r24);                  \
+   } while (0)
+
+#define V_G2(a, b, c, d, b0)                                     \
+   do {                                                          \
+      a = _mm256_add_epi64(_mm256_add_epi64(a, b), b0);          \
+      d = V_ROR16(_mm256_xor_si256(d, a), r16);                  \
+      c = _mm256_add_epi64(c, d);                                \
+      b = V_ROR63(_mm256_xor_si256(b, c));                       \
+   } while (0)
+
+#define V_DIAGONALIZE(b, c, d)                                   \
+   do {                                                          \
+      b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));  \
+      c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));  \
+      d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));  \
+   } while (0)
+
+#define V_UNDIAGONALIZE(b, c, d)                                 \
+   do {                                                          \
+      b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));  \
+      c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));  \
+      d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));  \
+   } while (0)
+
+#define V_MSG(x0, x1, x2, x3) \
+   _mm256_set_epi64x((long long)m[x3], (long long)m[x2], (long long)m[x1], (long long)m[x0])
+
+#define V_ROUND(r)                                                                                             \
+   do {                                                                                                        \
+      V_G1(a, b, c, d, V_MSG(blake2b_sigma[r][0], blake2b_sigma[r][2], blake2b_sigma[r][4], blake2b_sigma[r][6]));   \
+      V_G2(a, b, c, d, V_MSG(blake2b_sigma[r][1], blake2b_sigma[r][3], blake2b_sigma[r][5], blake2b_sigma[r][7]));   \
+      V_DIAGONALIZE(b, c, d);                                                                                  \
+      V_G1(a, b, c, d, V_MSG(blake2b_sigma[r][8], blake2b_sigma[r][10], blake2b_sigma[r][12], blake2b_sigma[r][14])); \
+      V_G2(a, b, c, d, V_MSG(blake2b_sigma[r][9], blake2b_sigma[r][11], blake2b_sigma[r][13], blake2b_sigma[r][15])); \
+      V_UNDIAGONALIZE(b, c, d);                                                                                \
+   } while (0)
+
+LTC_BLAKE2B_AVX2_CALL
+int blake2b_avx2_compress(struct blake2b_state *S, const unsigned char *buf)
+{
+   __m256i a, b, c, d;
+   const __m256i r24 = _mm256_setr_epi8( 3,  4,  5,  6,  7,  0,  1,  2, 11, 12, 13, 14, 15,  8,  9, 10,
+                                         3,  4,  5,  6,  7,  0,  1,  2, 11, 12, 13, 14, 15,  8,  9, 10);
+   const __m256i r16 = _mm256_setr_epi8( 2,  3,  4,  5,  6,  7,  0,  1, 10, 11, 12, 13, 14, 15,  8,  9,
+                                         2,  3,  4,  5,  6,  7,  0,  1, 10, 11, 12, 13, 14, 15,  8,  9);
+   ulong64 m[16];
+   unsigned long i;
+
+   for (i = 0; i < 16; ++i) {
+      LOAD64L(m[i], buf + i * sizeof(m[i]));
+   }
+
+   a = _mm256_loadu_si256((const __m256i *)&S->h[0]);
+   b = _mm256_loadu_si256((const __m256i *)&S->h[4]);
+   c = _mm256_loadu_si256((const __m256i *)&blake2b_IV[0]);
+   d = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&blake2b_IV[4]),
+                        _mm256_set_epi64x((long long)S->f[1], (long long)S->f[0],
+                                          (long long)S->t[1], (long long)S->t[0]));
+
+   V_ROUND(0);
+   V_ROUND(1);
+   V_ROUND(2);
+   V_ROUND(3);
+   V_ROUND(4);
+   V_ROUND(5);
+   V_ROUND(6);
+   V_ROUND(7);
+   V_ROUND(8);
+   V_ROUND(9);
+   V_ROUND(10);
+   V_ROUND(11);
+
+   a = _mm256_xor_si256(a, _mm256_xor_si256(c, _mm256_loadu_si256((const __m256i *)&S->h[0])));
+   b = _mm256_xor_si256(b, _mm256_xor_si256(d, _mm256_loadu_si256((const __m256i *)&S->h[4])));
+   _mm256_storeu_si256((__m256i *)&S->h[0], a);
+   _mm256_storeu_si256((__m256i *)&S->h[4], b);
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(m, sizeof(m));
+#endif
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,260 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/* see https://blake2.net and the BLAKE2 reference source code package;
+ * BLAKE2bp is the four-lane parallel tree mode of BLAKE2b: the input is
+ * dealt round robin, one 128 byte block at a time, to four independent
+ * leaves whose digests are absorbed by a depth-1 root node.  The leaves
+ * never depend on each other, so they can be driven by the vector units
+ * or by one thread per lane without changing the digest. */
+
+#include "tomcrypt.h"
+
+#ifdef LTC_BLAKE2BP
+
+enum blake2bp_constant {
+   BLAKE2BP_PARALLELISM = 4,
+   BLAKE2BP_BLOCKBYTES = 128,
+   BLAKE2BP_OUTBYTES = 64,
+   BLAKE2BP_KEYBYTES = 64,
+   BLAKE2BP_PARAM_SIZE = 64
+};
+
+/* param offsets, same layout as blake2b.c */
+enum {
+   O_DIGEST_LENGTH = 0,
+   O_KEY_LENGTH = 1,
+   O_FANOUT = 2,
+   O_DEPTH = 3,
+   O_LEAF_LENGTH = 4,
+   O_NODE_OFFSET = 8,
+   O_NODE_DEPTH = 16,
+   O_INNER_LENGTH = 17
+};
+
+const struct ltc_hash_descriptor blake2bp_desc =
+{
+    "blake2bp",
+    29,
+    64,
+    128,
+    { 0 },
+    0,
+    &blake2bp_512_init,
+    &blake2bp_process,
+    &blake2bp_done,
+    &blake2bp_512_test,
+    NULL,
+    NULL,
+    NULL
+};
+
+/**
+   Initialize the BLAKE2bp state
+   @param md      The hash state you wish to initialize
+   @param outlen  The desired digest length (octets, 1..64)
+   @param key     The secret key (or NULL for unkeyed mode)
+   @param keylen  The length of the secret key (octets, at most 64)
+   @return CRYPT_OK if successful
+*/
+int blake2bp_init(hash_state *md, unsigned long outlen, const unsigned char *key, unsigned long keylen)
+{
+   unsigned char P[BLAKE2BP_PARAM_SIZE];
+   unsigned long i;
+   int err;
+
+   LTC_ARGCHK(md != NULL);
+
+   if ((!outlen) || (outlen > BLAKE2BP_OUTBYTES))
+      return CRYPT_INVALID_ARG;
+
+   if ((key && !keylen) || (keylen && !key) || (keylen > BLAKE2BP_KEYBYTES))
+      return CRYPT_INVALID_ARG;
+
+   XMEMSET(&md->blake2bp, 0, sizeof(md->blake2bp));
+
+   XMEMSET(P, 0, sizeof(P));
+   P[O_DIGEST_LENGTH] = (unsigned char)outlen;
+   P[O_KEY_LENGTH] = (unsigned char)keylen;
+   P[O_FANOUT] = BLAKE2BP_PARALLELISM;
+   P[O_DEPTH] = 2;
+   P[O_INNER_LENGTH] = BLAKE2BP_OUTBYTES;
+
+   /* the root node sits at depth 1 and hashes only the leaf digests */
+   P[O_NODE_DEPTH] = 1;
+   if ((err = blake2b_int_init_param(&md->blake2bp.root, P)) != CRYPT_OK) {
+      return err;
+   }
+   md->blake2bp.root.last_node = 1;
+
+   /* the leaves differ only in their node offset */
+   P[O_NODE_DEPTH] = 0;
+   for (i = 0; i < BLAKE2BP_PARALLELISM; i++) {
+      STORE32L(i, P + O_NODE_OFFSET);
+      if ((err = blake2b_int_init_param(&md->blake2bp.leaf[i], P)) != CRYPT_OK) {
+         return err;
+      }
+      /* every leaf emits its full chain value regardless of outlen */
+      md->blake2bp.leaf[i].outlen = BLAKE2BP_OUTBYTES;
+   }
+   md->blake2bp.leaf[BLAKE2BP_PARALLELISM - 1].last_node = 1;
+
+   if (key) {
+      unsigned char block[BLAKE2BP_BLOCKBYTES];
+
+      XMEMSET(block, 0, BLAKE2BP_BLOCKBYTES);
+      XMEMCPY(block, key, keylen);
+      for (i = 0; i < BLAKE2BP_PARALLELISM; i++) {
+         if ((err = blake2b_int_process(&md->blake2bp.leaf[i], block, BLAKE2BP_BLOCKBYTES)) != CRYPT_OK) {
+            return err;
+         }
+      }
+
+#ifdef LTC_CLEAN_STACK
+      zeromem(block, sizeof(block));
+#endif
+   }
+
+   return CRYPT_OK;
+}
+
+int blake2bp_512_init(hash_state *md) { return blake2bp_init(md, 64, NULL, 0); }
+
+/**
+   Process a block of memory through the hash
+   @param md     The hash state
+   @param in     The data to hash
+   @param inlen  The length of the data (octets)
+   @return CRYPT_OK if successful
+*/
+int blake2bp_process(hash_state *md, const unsigned char *in, unsigned long inlen)
+{
+   unsigned long i, left, n;
+   int err;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(in != NULL);
+
+   /* deal the input round robin, one block per leaf */
+   while (inlen > 0) {
+      i    = (unsigned long)(md->blake2bp.pos >> 7) & (BLAKE2BP_PARALLELISM - 1);
+      left = (unsigned long)md->blake2bp.pos & (BLAKE2BP_BLOCKBYTES - 1);
+      n    = MIN(BLAKE2BP_BLOCKBYTES - left, inlen);
+      if ((err = blake2b_int_process(&md->blake2bp.leaf[i], in, n)) != CRYPT_OK) {
+         return err;
+      }
+      md->blake2bp.pos += n;
+      in    += n;
+      inlen -= n;
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Terminate the hash to get the digest
+   @param md   The hash state
+   @param out  [out] The destination of the hash (outlen octets)
+   @return CRYPT_OK if successful
+*/
+int blake2bp_done(hash_state *md, unsigned char *out)
+{
+   unsigned char hash[BLAKE2BP_PARALLELISM][BLAKE2BP_OUTBYTES];
+   unsigned long i;
+   int err;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(out != NULL);
+
+   for (i = 0; i < BLAKE2BP_PARALLELISM; i++) {
+      if ((err = blake2b_int_done(&md->blake2bp.leaf[i], hash[i])) != CRYPT_OK) {
+         return err;
+      }
+   }
+
+   if ((err = blake2b_int_process(&md->blake2bp.root, hash[0], sizeof(hash))) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = blake2b_int_done(&md->blake2bp.root, out)) != CRYPT_OK) {
+      return err;
+   }
+
+   zeromem(md, sizeof(hash_state));
+#ifdef LTC_CLEAN_STACK
+   zeromem(hash, sizeof(hash));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Self-test the hash
+  @return CRYPT_OK if successful, CRYPT_NOP if self-tests have been disabled
+*/
+int blake2bp_512_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   static const struct {
+      unsigned long len;
+      unsigned char hash[64];
+   } tests[] = {
+      { 0,
+        { 0xb5, 0xef, 0x81, 0x1a, 0x80, 0x38, 0xf7, 0x0b,
+          0x62, 0x8f, 0xa8, 0xb2, 0x94, 0xda, 0xae, 0x74,
+          0x92, 0xb1, 0xeb, 0xe3, 0x43, 0xa8, 0x0e, 0xaa,
+          0xbb, 0xf1, 0xf6, 0xae, 0x66, 0x4d, 0xd6, 0x7b,
+          0x9d, 0x90, 0xb0, 0x12, 0x07, 0x91, 0xea, 0xb8,
+          0x1d, 0xc9, 0x69, 0x85, 0xf2, 0x88, 0x49, 0xf6,
+          0xa3, 0x05, 0x18, 0x6a, 0x85, 0x50, 0x1b, 0x40,
+          0x51, 0x14, 0xbf, 0xa6, 0x78, 0xdf, 0x93, 0x80 } },
+      { 1,
+        { 0xa1, 0x39, 0x28, 0x0e, 0x72, 0x75, 0x7b, 0x72,
+          0x3e, 0x64, 0x73, 0xd5, 0xbe, 0x59, 0xf3, 0x6e,
+          0x9d, 0x50, 0xfc, 0x5c, 0xd7, 0xd4, 0x58, 0x5c,
+          0xbc, 0x09, 0x80, 0x48, 0x95, 0xa3, 0x6c, 0x52,
+          0x12, 0x42, 0xfb, 0x27, 0x89, 0xf8, 0x5c, 0xb9,
+          0xe3, 0x54, 0x91, 0xf3, 0x1d, 0x4a, 0x69, 0x52,
+          0xf9, 0xd8, 0xe0, 0x97, 0xae, 0xf9, 0x4f, 0xa1,
+          0xca, 0x0b, 0x12, 0x52, 0x57, 0x21, 0xf0, 0x3d } },
+      { 256,
+        { 0xef, 0x11, 0x32, 0xd8, 0x66, 0x05, 0x58, 0x76,
+          0xc1, 0x59, 0x59, 0x55, 0x7d, 0x79, 0xcf, 0xf0,
+          0x53, 0x9b, 0x93, 0xb2, 0x6f, 0x47, 0xbf, 0x41,
+          0x83, 0x74, 0x89, 0x21, 0xdf, 0x72, 0xc3, 0xed,
+          0x94, 0xb0, 0xa5, 0xe9, 0x5e, 0x17, 0xa4, 0xbb,
+          0xc5, 0x94, 0x37, 0xf3, 0x45, 0x64, 0xe6, 0x0d,
+          0x20, 0x92, 0x3d, 0xd6, 0x43, 0x42, 0x0f, 0x5c,
+          0xa2, 0x5b, 0x2c, 0xa7, 0xec, 0x1c, 0xed, 0xa4 } }
+   };
+
+   unsigned char in[256], tmp[64];
+   unsigned long i, x;
+   hash_state md;
+
+   for (i = 0; i < sizeof(in); i++) {
+      in[i] = (unsigned char)i;
+   }
+
+   for (x = 0; x < (unsigned long)(sizeof(tests) / sizeof(tests[0])); x++) {
+      blake2bp_512_init(&md);
+      blake2bp_process(&md, in, tests[x].len);
+      blake2bp_done(&md, tmp);
+      if (compare_testvector(tmp, sizeof(tmp), tests[x].hash, sizeof(tests[x].hash), "BLAKE2BP", x)) {
+         return CRYPT_FAIL_TESTVECTOR;
+      }
+   }
+   return CRYPT_OK;
+#endif
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -79,6 +79,8 @@ const struct ltc_hash_descriptor blake2s_128_desc =
     &blake2s_process,
     &blake2s_done,
     &blake2s_128_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -94,6 +96,8 @@ const struct ltc_hash_descriptor blake2s_160_desc =
     &blake2s_process,
     &blake2s_done,
     &blake2s_160_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -109,6 +113,8 @@ const struct ltc_hash_descriptor blake2s_224_desc =
     &blake2s_process,
     &blake2s_done,
     &blake2s_224_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -124,6 +130,8 @@ const struct ltc_hash_descriptor blake2s_256_desc =
     &blake2s_process,
     &blake2s_done,
     &blake2s_256_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -31,6 +31,8 @@ const struct ltc_hash_descriptor chc_desc = {
    &chc_process,
    &chc_done,
    &chc_test,
+   NULL,
+   NULL,
    NULL
 };
 
@@ -16,6 +16,17 @@
   Hash a file, Tom St Denis
 */
 
+typedef struct {
+   int        hash;
+   hash_state md;
+} _hash_file_state;
+
+static int _hash_file_process(void *state, const unsigned char *buf, unsigned long len)
+{
+   _hash_file_state *h = state;
+   return hash_descriptor[h->hash].process(&h->md, buf, len);
+}
+
 /**
   @param hash   The index of the hash desired
   @param fname  The name of the file you wish to hash
@@ -25,7 +36,7 @@
 */
 int hash_file(int hash, const char *fname, unsigned char *out, unsigned long *outlen)
 {
-    FILE *in;
+    _hash_file_state h;
     int err;
     LTC_ARGCHK(fname  != NULL);
     LTC_ARGCHK(out    != NULL);
@@ -35,16 +46,25 @@ int hash_file(int hash, const char *fname, unsigned char *out, unsigned long *ou
         return err;
     }
 
-    in = fopen(fname, "rb");
-    if (in == NULL) {
-       return CRYPT_FILE_NOTFOUND;
+    if (*outlen < hash_descriptor[hash].hashsize) {
+       *outlen = hash_descriptor[hash].hashsize;
+       return CRYPT_BUFFER_OVERFLOW;
+    }
+    if ((err = hash_descriptor[hash].init(&h.md)) != CRYPT_OK) {
+       return err;
     }
 
-    err = hash_filehandle(hash, in, out, outlen);
-    if (fclose(in) != 0) {
-       return CRYPT_ERROR;
+    *outlen = hash_descriptor[hash].hashsize;
+    h.hash = hash;
+    if ((err = file_process(fname, _hash_file_process, &h)) != CRYPT_OK) {
+       goto LBL_ERR;
     }
+    err = hash_descriptor[hash].done(&h.md, out);
 
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+    zeromem(&h, sizeof(h));
+#endif
     return err;
 }
 #endif /* #ifndef LTC_NO_FILE */
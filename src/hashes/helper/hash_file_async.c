@@ -0,0 +1,87 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+#ifndef LTC_NO_FILE
+/**
+  @file hash_file_async.c
+  Hash a file with overlapped I/O, Tom St Denis
+*/
+
+typedef struct {
+   int        hash;
+   hash_state md;
+} _hash_file_state;
+
+static int _hash_file_process(void *state, const unsigned char *buf, unsigned long len)
+{
+   _hash_file_state *h = state;
+   return hash_descriptor[h->hash].process(&h->md, buf, len);
+}
+
+/**
+  Hash a file, keeping a read in flight while the previous chunk is
+  compressed (see file_process_overlapped()).  The call itself blocks
+  until the digest is complete - the library never spawns threads - and
+  the completion callback is invoked exactly once before it returns,
+  with the digest on success or a NULL digest on failure.
+  @param hash   The index of the hash desired
+  @param fname  The name of the file you wish to hash
+  @param done   Completion callback, called as done(ctx, err, digest, digestlen)
+  @param ctx    Opaque context handed to the callback
+  @result CRYPT_OK if successful (the same err the callback saw)
+*/
+int hash_file_async(int hash, const char *fname,
+                    void (*done)(void *ctx, int err, const unsigned char *digest, unsigned long digestlen),
+                    void *ctx)
+{
+    _hash_file_state h;
+    unsigned char    digest[MAXBLOCKSIZE];
+    int err;
+
+    LTC_ARGCHK(fname != NULL);
+    LTC_ARGCHK(done  != NULL);
+
+    if ((err = hash_is_valid(hash)) != CRYPT_OK) {
+        done(ctx, err, NULL, 0);
+        return err;
+    }
+    if ((err = hash_descriptor[hash].init(&h.md)) != CRYPT_OK) {
+        done(ctx, err, NULL, 0);
+        return err;
+    }
+
+    h.hash = hash;
+    if ((err = file_process_overlapped(fname, _hash_file_process, &h)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    if ((err = hash_descriptor[hash].done(&h.md, digest)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    done(ctx, CRYPT_OK, digest, hash_descriptor[hash].hashsize);
+    err = CRYPT_OK;
+    goto LBL_CLEAN;
+
+LBL_ERR:
+    done(ctx, err, NULL, 0);
+LBL_CLEAN:
+#ifdef LTC_CLEAN_STACK
+    zeromem(&h, sizeof(h));
+    zeromem(digest, sizeof(digest));
+#endif
+    return err;
+}
+#endif /* #ifndef LTC_NO_FILE */
+
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -16,6 +16,17 @@
    Hash open files, Tom St Denis
 */
 
+typedef struct {
+   int        hash;
+   hash_state md;
+} _hash_file_state;
+
+static int _hash_file_process(void *state, const unsigned char *buf, unsigned long len)
+{
+   _hash_file_state *h = state;
+   return hash_descriptor[h->hash].process(&h->md, buf, len);
+}
+
 /**
   Hash data from an open file handle.
   @param hash   The index of the hash you want to use
@@ -26,45 +37,36 @@
 */
 int hash_filehandle(int hash, FILE *in, unsigned char *out, unsigned long *outlen)
 {
-    hash_state md;
-    unsigned char *buf;
-    size_t x;
+    _hash_file_state h;
     int err;
 
     LTC_ARGCHK(out    != NULL);
     LTC_ARGCHK(outlen != NULL);
     LTC_ARGCHK(in     != NULL);
 
-    if ((buf = XMALLOC(LTC_FILE_READ_BUFSIZE)) == NULL) {
-        return CRYPT_MEM;
-    }
-
     if ((err = hash_is_valid(hash)) != CRYPT_OK) {
-        goto LBL_ERR;
+        return err;
     }
 
     if (*outlen < hash_descriptor[hash].hashsize) {
        *outlen = hash_descriptor[hash].hashsize;
-       err = CRYPT_BUFFER_OVERFLOW;
-       goto LBL_ERR;
+       return CRYPT_BUFFER_OVERFLOW;
     }
-    if ((err = hash_descriptor[hash].init(&md)) != CRYPT_OK) {
-       goto LBL_ERR;
+    if ((err = hash_descriptor[hash].init(&h.md)) != CRYPT_OK) {
+       return err;
     }
 
     *outlen = hash_descriptor[hash].hashsize;
-    do {
-        x = fread(buf, 1, LTC_FILE_READ_BUFSIZE, in);
-        if ((err = hash_descriptor[hash].process(&md, buf, (unsigned long)x)) != CRYPT_OK) {
-           goto LBL_CLEANBUF;
-        }
-    } while (x == LTC_FILE_READ_BUFSIZE);
-    err = hash_descriptor[hash].done(&md, out);
+    h.hash = hash;
+    if ((err = file_process_filehandle(in, _hash_file_process, &h)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    err = hash_descriptor[hash].done(&h.md, out);
 
-LBL_CLEANBUF:
-    zeromem(buf, LTC_FILE_READ_BUFSIZE);
 LBL_ERR:
-    XFREE(buf);
+#ifdef LTC_CLEAN_STACK
+    zeromem(&h, sizeof(h));
+#endif
     return err;
 }
 #endif /* #ifndef LTC_NO_FILE */
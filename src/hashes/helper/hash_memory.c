@@ -27,7 +27,7 @@
 */
 int hash_memory(int hash, const unsigned char *in, unsigned long inlen, unsigned char *out, unsigned long *outlen)
 {
-    hash_state *md;
+    hash_state md;
     int err;
 
     LTC_ARGCHK(in     != NULL);
@@ -43,24 +43,22 @@ int hash_memory(int hash, const unsigned char *in, unsigned long inlen, unsigned
        return CRYPT_BUFFER_OVERFLOW;
     }
 
-    md = XMALLOC(sizeof(hash_state));
-    if (md == NULL) {
-       return CRYPT_MEM;
-    }
+    LTC_STATS_BUMP(LTC_STAT_HASH, hash, inlen, 0);
 
-    if ((err = hash_descriptor[hash].init(md)) != CRYPT_OK) {
+    /* the state lives on the stack; at millions of short hashes per
+     * second a heap allocation per call dominates the hash itself */
+    if ((err = hash_descriptor[hash].init(&md)) != CRYPT_OK) {
        goto LBL_ERR;
     }
-    if ((err = hash_descriptor[hash].process(md, in, inlen)) != CRYPT_OK) {
+    if ((err = hash_descriptor[hash].process(&md, in, inlen)) != CRYPT_OK) {
        goto LBL_ERR;
     }
-    err = hash_descriptor[hash].done(md, out);
+    err = hash_descriptor[hash].done(&md, out);
     *outlen = hash_descriptor[hash].hashsize;
 LBL_ERR:
 #ifdef LTC_CLEAN_STACK
-    zeromem(md, sizeof(hash_state));
+    zeromem(&md, sizeof(hash_state));
 #endif
-    XFREE(md);
 
     return err;
 }
@@ -30,7 +30,7 @@
 int hash_memory_multi(int hash, unsigned char *out, unsigned long *outlen,
                       const unsigned char *in, unsigned long inlen, ...)
 {
-    hash_state          *md;
+    hash_state           md;
     int                  err;
     va_list              args;
     const unsigned char *curptr;
@@ -49,13 +49,8 @@ int hash_memory_multi(int hash, unsigned char *out, unsigned long *outlen,
        return CRYPT_BUFFER_OVERFLOW;
     }
 
-    md = XMALLOC(sizeof(hash_state));
-    if (md == NULL) {
-       return CRYPT_MEM;
-    }
-
-    if ((err = hash_descriptor[hash].init(md)) != CRYPT_OK) {
-       goto LBL_ERR;
+    if ((err = hash_descriptor[hash].init(&md)) != CRYPT_OK) {
+       goto LBL_ERR_NOARGS;
     }
 
     va_start(args, inlen);
@@ -63,7 +58,7 @@ int hash_memory_multi(int hash, unsigned char *out, unsigned long *outlen,
     curlen = inlen;
     for (;;) {
        /* process buf */
-       if ((err = hash_descriptor[hash].process(md, curptr, curlen)) != CRYPT_OK) {
+       if ((err = hash_descriptor[hash].process(&md, curptr, curlen)) != CRYPT_OK) {
           goto LBL_ERR;
        }
        /* step to next */
@@ -73,14 +68,14 @@ int hash_memory_multi(int hash, unsigned char *out, unsigned long *outlen,
        }
        curlen = va_arg(args, unsigned long);
     }
-    err = hash_descriptor[hash].done(md, out);
+    err = hash_descriptor[hash].done(&md, out);
     *outlen = hash_descriptor[hash].hashsize;
 LBL_ERR:
+    va_end(args);
+LBL_ERR_NOARGS:
 #ifdef LTC_CLEAN_STACK
-    zeromem(md, sizeof(hash_state));
+    zeromem(&md, sizeof(hash_state));
 #endif
-    XFREE(md);
-    va_end(args);
     return err;
 }
 #endif /* #ifdef LTC_HASH_HELPERS */
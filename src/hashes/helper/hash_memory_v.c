@@ -0,0 +1,74 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+#ifdef LTC_HASH_HELPERS
+/**
+  @file hash_memory_v.c
+  Hash a scattered buffer given as a fragment array, Tom St Denis
+*/
+
+/**
+  Hash a fragment chain of memory and store the digest.  Unlike
+  hash_memory_multi() the fragments come as an array rather than
+  varargs, so the caller can build the list at runtime, and the hash
+  state lives on the stack so the call performs no allocation.
+  @param hash   The index of the hash you wish to use
+  @param iov    The array of fragments to hash, in order
+  @param iovcnt The number of fragments
+  @param out    [out] Where to store the digest
+  @param outlen [in/out] Max size and resulting size of the digest
+  @return CRYPT_OK if successful
+*/
+int hash_memory_v(int hash, const ltc_iovec *iov, int iovcnt,
+                  unsigned char *out, unsigned long *outlen)
+{
+    hash_state md;
+    int        x, err;
+
+    LTC_ARGCHK(iov    != NULL || iovcnt == 0);
+    LTC_ARGCHK(out    != NULL);
+    LTC_ARGCHK(outlen != NULL);
+
+    if ((err = hash_is_valid(hash)) != CRYPT_OK) {
+        return err;
+    }
+
+    if (*outlen < hash_descriptor[hash].hashsize) {
+       *outlen = hash_descriptor[hash].hashsize;
+       return CRYPT_BUFFER_OVERFLOW;
+    }
+
+    if ((err = hash_descriptor[hash].init(&md)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    for (x = 0; x < iovcnt; x++) {
+       if (iov[x].len == 0) {
+          continue;
+       }
+       if ((err = hash_descriptor[hash].process(&md, iov[x].data, iov[x].len)) != CRYPT_OK) {
+          goto LBL_ERR;
+       }
+    }
+    err = hash_descriptor[hash].done(&md, out);
+    *outlen = hash_descriptor[hash].hashsize;
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+    zeromem(&md, sizeof(hash_state));
+#endif
+
+    return err;
+}
+#endif /* #ifdef LTC_HASH_HELPERS */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
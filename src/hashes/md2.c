@@ -32,6 +32,8 @@ const struct ltc_hash_descriptor md2_desc =
     &md2_process,
     &md2_done,
     &md2_test,
+    NULL,
+    NULL,
     NULL
 };
 
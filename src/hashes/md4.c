@@ -32,6 +32,8 @@ const struct ltc_hash_descriptor md4_desc =
     &md4_process,
     &md4_done,
     &md4_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -33,7 +33,9 @@ const struct ltc_hash_descriptor md5_desc =
     &md5_process,
     &md5_done,
     &md5_test,
-    NULL
+    NULL,
+    &md5_export,
+    &md5_import
 };
 
 #define F(x,y,z)  (z ^ (x & (y ^ z)))
@@ -306,6 +308,71 @@ int md5_done(hash_state * md, unsigned char *out)
     return CRYPT_OK;
 }
 
+/**
+   Export the hash midstate so hashing can resume from a checkpoint
+   @param out     [out] The destination of the serialized midstate
+   @param outlen  [in/out] The max size and resulting size of the midstate
+   @param md      The hash state to serialize
+   @return CRYPT_OK if successful
+*/
+int md5_export(unsigned char *out, unsigned long *outlen, const hash_state *md)
+{
+    unsigned long n;
+    int i;
+
+    LTC_ARGCHK(out    != NULL);
+    LTC_ARGCHK(outlen != NULL);
+    LTC_ARGCHK(md     != NULL);
+
+    if (md->md5.curlen >= sizeof(md->md5.buf)) {
+       return CRYPT_INVALID_ARG;
+    }
+    n = 28 + md->md5.curlen;
+    if (*outlen < n) {
+       *outlen = n;
+       return CRYPT_BUFFER_OVERFLOW;
+    }
+    STORE64H(md->md5.length, out);
+    for (i = 0; i < 4; i++) {
+        STORE32H(md->md5.state[i], out + 8 + 4 * i);
+    }
+    STORE32H(md->md5.curlen, out + 24);
+    XMEMCPY(out + 28, md->md5.buf, md->md5.curlen);
+    *outlen = n;
+    return CRYPT_OK;
+}
+
+/**
+   Import a hash midstate previously made with md5_export
+   @param md     The hash state to restore into
+   @param in     The serialized midstate
+   @param inlen  The length of the serialized midstate (octets)
+   @return CRYPT_OK if successful
+*/
+int md5_import(hash_state *md, const unsigned char *in, unsigned long inlen)
+{
+    ulong32 curlen;
+    int i;
+
+    LTC_ARGCHK(md != NULL);
+    LTC_ARGCHK(in != NULL);
+
+    if (inlen < 28) {
+       return CRYPT_INVALID_PACKET;
+    }
+    LOAD32H(curlen, in + 24);
+    if (curlen >= sizeof(md->md5.buf) || inlen != 28 + curlen) {
+       return CRYPT_INVALID_PACKET;
+    }
+    LOAD64H(md->md5.length, in);
+    for (i = 0; i < 4; i++) {
+        LOAD32H(md->md5.state[i], in + 8 + 4 * i);
+    }
+    md->md5.curlen = curlen;
+    XMEMCPY(md->md5.buf, in + 28, curlen);
+    return CRYPT_OK;
+}
+
 /**
   Self-test the hash
   @return CRYPT_OK if successful, CRYPT_NOP if self-tests have been disabled
@@ -0,0 +1,286 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file md5_mb.c
+  Multi-buffer MD5: hash several independent messages in lock step so the
+  vector units stay full, for bulk legacy manifest verification
+*/
+
+#ifdef LTC_MD5
+
+#ifdef LTC_MD5_AVX2
+
+/* immintrin.h drags in AVX-512 headers that are not C90 clean */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+#define LTC_MD5_AVX2_CALL __attribute__((target("avx2")))
+
+static const ulong32 T[64] = {
+   0xd76aa478UL, 0xe8c7b756UL, 0x242070dbUL, 0xc1bdceeeUL,
+   0xf57c0fafUL, 0x4787c62aUL, 0xa8304613UL, 0xfd469501UL,
+   0x698098d8UL, 0x8b44f7afUL, 0xffff5bb1UL, 0x895cd7beUL,
+   0x6b901122UL, 0xfd987193UL, 0xa679438eUL, 0x49b40821UL,
+   0xf61e2562UL, 0xc040b340UL, 0x265e5a51UL, 0xe9b6c7aaUL,
+   0xd62f105dUL, 0x02441453UL, 0xd8a1e681UL, 0xe7d3fbc8UL,
+   0x21e1cde6UL, 0xc33707d6UL, 0xf4d50d87UL, 0x455a14edUL,
+   0xa9e3e905UL, 0xfcefa3f8UL, 0x676f02d9UL, 0x8d2a4c8aUL,
+   0xfffa3942UL, 0x8771f681UL, 0x6d9d6122UL, 0xfde5380cUL,
+   0xa4beea44UL, 0x4bdecfa9UL, 0xf6bb4b60UL, 0xbebfbc70UL,
+   0x289b7ec6UL, 0xeaa127faUL, 0xd4ef3085UL, 0x04881d05UL,
+   0xd9d4d039UL, 0xe6db99e5UL, 0x1fa27cf8UL, 0xc4ac5665UL,
+   0xf4292244UL, 0x432aff97UL, 0xab9423a7UL, 0xfc93a039UL,
+   0x655b59c3UL, 0x8f0ccc92UL, 0xffeff47dUL, 0x85845dd1UL,
+   0x6fa87e4fUL, 0xfe2ce6e0UL, 0xa3014314UL, 0x4e0811a1UL,
+   0xf7537e82UL, 0xbd3af235UL, 0x2ad7d2bbUL, 0xeb86d391UL
+};
+
+static const unsigned char Worder[64] = {
+   0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+   1, 6, 11, 0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12,
+   5, 8, 11, 14, 1, 4, 7, 10, 13, 0, 3, 6, 9, 12, 15, 2,
+   0, 7, 14, 5, 12, 3, 10, 1, 8, 15, 6, 13, 4, 11, 2, 9
+};
+
+static const unsigned char Rorder[64] = {
+   7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+   5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+   4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+   6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+static int _md5_avx2_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_AVX2) != 0;
+}
+
+/* the scalar round helpers, one lane per 32-bit element */
+#define V_ROL(x, n)   _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+#define V_ADD(x, y)   _mm256_add_epi32(x, y)
+#define V_XOR(x, y)   _mm256_xor_si256(x, y)
+#define V_F(x, y, z)  V_XOR(z, _mm256_and_si256(x, V_XOR(y, z)))
+#define V_G(x, y, z)  V_XOR(y, _mm256_and_si256(z, V_XOR(x, y)))
+#define V_H(x, y, z)  V_XOR(V_XOR(x, y), z)
+#define V_I(x, y, z)  V_XOR(y, _mm256_or_si256(x, V_XOR(z, _mm256_set1_epi32(-1))))
+
+/* 8x8 transpose of 32-bit words so W[t] holds word t of every lane */
+#define V_TRANSPOSE(w, r0, r1, r2, r3, r4, r5, r6, r7)             \
+   t0 = _mm256_unpacklo_epi32(r0, r1); t1 = _mm256_unpackhi_epi32(r0, r1); \
+   t2 = _mm256_unpacklo_epi32(r2, r3); t3 = _mm256_unpackhi_epi32(r2, r3); \
+   t4 = _mm256_unpacklo_epi32(r4, r5); t5 = _mm256_unpackhi_epi32(r4, r5); \
+   t6 = _mm256_unpacklo_epi32(r6, r7); t7 = _mm256_unpackhi_epi32(r6, r7); \
+   r0 = _mm256_unpacklo_epi64(t0, t2); r1 = _mm256_unpackhi_epi64(t0, t2); \
+   r2 = _mm256_unpacklo_epi64(t1, t3); r3 = _mm256_unpackhi_epi64(t1, t3); \
+   r4 = _mm256_unpacklo_epi64(t4, t6); r5 = _mm256_unpackhi_epi64(t4, t6); \
+   r6 = _mm256_unpacklo_epi64(t5, t7); r7 = _mm256_unpackhi_epi64(t5, t7); \
+   (w)[0] = _mm256_permute2x128_si256(r0, r4, 0x20);                       \
+   (w)[1] = _mm256_permute2x128_si256(r1, r5, 0x20);                       \
+   (w)[2] = _mm256_permute2x128_si256(r2, r6, 0x20);                       \
+   (w)[3] = _mm256_permute2x128_si256(r3, r7, 0x20);                       \
+   (w)[4] = _mm256_permute2x128_si256(r0, r4, 0x31);                       \
+   (w)[5] = _mm256_permute2x128_si256(r1, r5, 0x31);                       \
+   (w)[6] = _mm256_permute2x128_si256(r2, r6, 0x31);                       \
+   (w)[7] = _mm256_permute2x128_si256(r3, r7, 0x31);
+
+/* compress nblocks 64-byte blocks for eight lanes at once; p[l] points at
+ * lane l's data and every lane state has an empty buffer */
+LTC_MD5_AVX2_CALL
+static void _md5_mb_blocks8(hash_state *md, const unsigned char **p, unsigned long nblocks)
+{
+   __m256i st[4], W[16], t0, t1, t2, t3, t4, t5, t6, t7;
+   __m256i a, b, c, d, t;
+   ulong32 outw[8];
+   unsigned long blk;
+   int i, l;
+
+   for (i = 0; i < 4; i++) {
+      st[i] = _mm256_set_epi32((int)md[7].md5.state[i], (int)md[6].md5.state[i],
+                               (int)md[5].md5.state[i], (int)md[4].md5.state[i],
+                               (int)md[3].md5.state[i], (int)md[2].md5.state[i],
+                               (int)md[1].md5.state[i], (int)md[0].md5.state[i]);
+   }
+
+   for (blk = 0; blk < nblocks; blk++) {
+      /* gather+transpose the blocks; the message is little endian 32-bit words */
+#define V_LOADROW(l, half) \
+      _mm256_loadu_si256((const __m256i *)(p[l] + (blk << 6) + (half) * 32))
+      t0 = V_LOADROW(0, 0); t1 = V_LOADROW(1, 0); t2 = V_LOADROW(2, 0); t3 = V_LOADROW(3, 0);
+      t4 = V_LOADROW(4, 0); t5 = V_LOADROW(5, 0); t6 = V_LOADROW(6, 0); t7 = V_LOADROW(7, 0);
+      {
+         __m256i r0 = t0, r1 = t1, r2 = t2, r3 = t3, r4 = t4, r5 = t5, r6 = t6, r7 = t7;
+         V_TRANSPOSE(W, r0, r1, r2, r3, r4, r5, r6, r7)
+      }
+      t0 = V_LOADROW(0, 1); t1 = V_LOADROW(1, 1); t2 = V_LOADROW(2, 1); t3 = V_LOADROW(3, 1);
+      t4 = V_LOADROW(4, 1); t5 = V_LOADROW(5, 1); t6 = V_LOADROW(6, 1); t7 = V_LOADROW(7, 1);
+      {
+         __m256i r0 = t0, r1 = t1, r2 = t2, r3 = t3, r4 = t4, r5 = t5, r6 = t6, r7 = t7;
+         V_TRANSPOSE(W + 8, r0, r1, r2, r3, r4, r5, r6, r7)
+      }
+#undef V_LOADROW
+
+      a = st[0]; b = st[1]; c = st[2]; d = st[3];
+
+      for (i = 0; i < 64; i++) {
+         if (i < 16)      { t = V_F(b, c, d); }
+         else if (i < 32) { t = V_G(b, c, d); }
+         else if (i < 48) { t = V_H(b, c, d); }
+         else             { t = V_I(b, c, d); }
+         t = V_ADD(V_ADD(a, t), V_ADD(W[Worder[i]], _mm256_set1_epi32((int)T[i])));
+         a = d; d = c; c = b;
+         b = V_ADD(b, V_ROL(t, Rorder[i]));
+      }
+
+      st[0] = V_ADD(st[0], a); st[1] = V_ADD(st[1], b);
+      st[2] = V_ADD(st[2], c); st[3] = V_ADD(st[3], d);
+   }
+
+   for (i = 0; i < 4; i++) {
+      _mm256_storeu_si256((__m256i *)outw, st[i]);
+      for (l = 0; l < 8; l++) {
+         md[l].md5.state[i] = outw[l];
+      }
+   }
+   for (l = 0; l < 8; l++) {
+      md[l].md5.length += (ulong64)nblocks * 512;
+   }
+}
+
+#endif /* LTC_MD5_AVX2 */
+
+/**
+   Initialize an array of hash states for multi-buffer hashing
+   @param md     Array of hash states
+   @param lanes  Number of lanes (states/messages)
+   @return CRYPT_OK if successful
+*/
+int md5_mb_init(hash_state *md, int lanes)
+{
+   int l, err;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(lanes >= 0);
+
+   for (l = 0; l < lanes; l++) {
+      if ((err = md5_init(&md[l])) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Process one buffer per lane through the hash states.  The result per
+   lane is identical to calling md5_process(&md[l], in[l], inlen[l]);
+   full groups of eight lanes are driven through the vector units together
+   when the CPU allows it.
+   @param md     Array of hash states
+   @param in     One input buffer per lane
+   @param inlen  The length of each input buffer (octets)
+   @param lanes  Number of lanes
+   @return CRYPT_OK if successful
+*/
+int md5_mb_process(hash_state *md, const unsigned char **in, const unsigned long *inlen, int lanes)
+{
+   unsigned long off[8], n;
+   int base, g, l, err;
+
+   LTC_ARGCHK(md    != NULL);
+   LTC_ARGCHK(in    != NULL || lanes == 0);
+   LTC_ARGCHK(inlen != NULL || lanes == 0);
+   LTC_ARGCHK(lanes >= 0);
+
+   for (base = 0; base < lanes; base += g) {
+      g = MIN(8, lanes - base);
+      for (l = 0; l < g; l++) {
+         off[l] = 0;
+      }
+
+      /* drain buffered partial blocks so every lane is block aligned */
+      for (l = 0; l < g; l++) {
+         if (md[base + l].md5.curlen > 0) {
+            n = MIN(64 - md[base + l].md5.curlen, inlen[base + l]);
+            if ((err = md5_process(&md[base + l], in[base + l], n)) != CRYPT_OK) {
+               return err;
+            }
+            off[l] = n;
+         }
+      }
+
+#ifdef LTC_MD5_AVX2
+      if (g == 8 && _md5_avx2_enabled()) {
+         const unsigned char *p[8];
+         unsigned long common, blocks;
+         int ok;
+
+         /* march all eight lanes through their common whole blocks */
+         common = (unsigned long)-1;
+         ok     = 1;
+         for (l = 0; l < 8; l++) {
+            if (md[base + l].md5.curlen != 0) {
+               ok = 0; /* lane ran out of data mid-block above */
+               break;
+            }
+            blocks = (inlen[base + l] - off[l]) >> 6;
+            common = MIN(common, blocks);
+            p[l]   = in[base + l] + off[l];
+         }
+         if (ok && common > 0) {
+            _md5_mb_blocks8(&md[base], p, common);
+            for (l = 0; l < 8; l++) {
+               off[l] += common << 6;
+            }
+         }
+      }
+#endif
+
+      /* whatever is left runs through the ordinary path */
+      for (l = 0; l < g; l++) {
+         if (inlen[base + l] > off[l]) {
+            if ((err = md5_process(&md[base + l], in[base + l] + off[l], inlen[base + l] - off[l])) != CRYPT_OK) {
+               return err;
+            }
+         }
+      }
+   }
+
+   return CRYPT_OK;
+}
+
+/**
+   Terminate all lanes and emit one digest per lane
+   @param md     Array of hash states
+   @param out    One 16-byte digest destination per lane
+   @param lanes  Number of lanes
+   @return CRYPT_OK if successful
+*/
+int md5_mb_done(hash_state *md, unsigned char **out, int lanes)
+{
+   int l, err;
+
+   LTC_ARGCHK(md  != NULL);
+   LTC_ARGCHK(out != NULL || lanes == 0);
+   LTC_ARGCHK(lanes >= 0);
+
+   for (l = 0; l < lanes; l++) {
+      if ((err = md5_done(&md[l], out[l])) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+#endif /* LTC_MD5 */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
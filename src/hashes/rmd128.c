@@ -38,6 +38,8 @@ const struct ltc_hash_descriptor rmd128_desc =
     &rmd128_process,
     &rmd128_done,
     &rmd128_test,
+    NULL,
+    NULL,
     NULL
 };
 
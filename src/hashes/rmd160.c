@@ -38,6 +38,8 @@ const struct ltc_hash_descriptor rmd160_desc =
     &rmd160_process,
     &rmd160_done,
     &rmd160_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -32,6 +32,8 @@ const struct ltc_hash_descriptor rmd256_desc =
     &rmd256_process,
     &rmd256_done,
     &rmd256_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -33,6 +33,8 @@ const struct ltc_hash_descriptor rmd320_desc =
     &rmd320_process,
     &rmd320_done,
     &rmd320_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -33,7 +33,9 @@ const struct ltc_hash_descriptor sha1_desc =
     &sha1_process,
     &sha1_done,
     &sha1_test,
-    NULL
+    NULL,
+    &sha1_export,
+    &sha1_import
 };
 
 #define F0(x,y,z)  (z ^ (x & (y ^ z)))
@@ -238,6 +240,71 @@ int sha1_done(hash_state * md, unsigned char *out)
     return CRYPT_OK;
 }
 
+/**
+   Export the hash midstate so hashing can resume from a checkpoint
+   @param out     [out] The destination of the serialized midstate
+   @param outlen  [in/out] The max size and resulting size of the midstate
+   @param md      The hash state to serialize
+   @return CRYPT_OK if successful
+*/
+int sha1_export(unsigned char *out, unsigned long *outlen, const hash_state *md)
+{
+    unsigned long n;
+    int i;
+
+    LTC_ARGCHK(out    != NULL);
+    LTC_ARGCHK(outlen != NULL);
+    LTC_ARGCHK(md     != NULL);
+
+    if (md->sha1.curlen >= sizeof(md->sha1.buf)) {
+       return CRYPT_INVALID_ARG;
+    }
+    n = 32 + md->sha1.curlen;
+    if (*outlen < n) {
+       *outlen = n;
+       return CRYPT_BUFFER_OVERFLOW;
+    }
+    STORE64H(md->sha1.length, out);
+    for (i = 0; i < 5; i++) {
+        STORE32H(md->sha1.state[i], out + 8 + 4 * i);
+    }
+    STORE32H(md->sha1.curlen, out + 28);
+    XMEMCPY(out + 32, md->sha1.buf, md->sha1.curlen);
+    *outlen = n;
+    return CRYPT_OK;
+}
+
+/**
+   Import a hash midstate previously made with sha1_export
+   @param md     The hash state to restore into
+   @param in     The serialized midstate
+   @param inlen  The length of the serialized midstate (octets)
+   @return CRYPT_OK if successful
+*/
+int sha1_import(hash_state *md, const unsigned char *in, unsigned long inlen)
+{
+    ulong32 curlen;
+    int i;
+
+    LTC_ARGCHK(md != NULL);
+    LTC_ARGCHK(in != NULL);
+
+    if (inlen < 32) {
+       return CRYPT_INVALID_PACKET;
+    }
+    LOAD32H(curlen, in + 28);
+    if (curlen >= sizeof(md->sha1.buf) || inlen != 32 + curlen) {
+       return CRYPT_INVALID_PACKET;
+    }
+    LOAD64H(md->sha1.length, in);
+    for (i = 0; i < 5; i++) {
+        LOAD32H(md->sha1.state[i], in + 8 + 4 * i);
+    }
+    md->sha1.curlen = curlen;
+    XMEMCPY(md->sha1.buf, in + 32, curlen);
+    return CRYPT_OK;
+}
+
 /**
   Self-test the hash
   @return CRYPT_OK if successful, CRYPT_NOP if self-tests have been disabled
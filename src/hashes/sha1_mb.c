@@ -0,0 +1,263 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file sha1_mb.c
+  Multi-buffer SHA-1: hash several independent messages in lock step so
+  the vector units stay full, for bulk legacy manifest verification
+*/
+
+#ifdef LTC_SHA1
+
+#ifdef LTC_SHA1_AVX2
+
+/* immintrin.h drags in AVX-512 headers that are not C90 clean */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+#define LTC_SHA1_AVX2_CALL __attribute__((target("avx2")))
+
+static int _sha1_avx2_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_AVX2) != 0;
+}
+
+/* the scalar round helpers, one lane per 32-bit element */
+#define V_ROL(x, n)   _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+#define V_ADD(x, y)   _mm256_add_epi32(x, y)
+#define V_XOR(x, y)   _mm256_xor_si256(x, y)
+#define V_F0(x, y, z) V_XOR(z, _mm256_and_si256(x, V_XOR(y, z)))
+#define V_F1(x, y, z) V_XOR(V_XOR(x, y), z)
+#define V_F2(x, y, z) _mm256_or_si256(_mm256_and_si256(x, y), _mm256_and_si256(z, _mm256_or_si256(x, y)))
+
+/* 8x8 transpose of 32-bit words so W[t] holds word t of every lane */
+#define V_TRANSPOSE(w, r0, r1, r2, r3, r4, r5, r6, r7)             \
+   t0 = _mm256_unpacklo_epi32(r0, r1); t1 = _mm256_unpackhi_epi32(r0, r1); \
+   t2 = _mm256_unpacklo_epi32(r2, r3); t3 = _mm256_unpackhi_epi32(r2, r3); \
+   t4 = _mm256_unpacklo_epi32(r4, r5); t5 = _mm256_unpackhi_epi32(r4, r5); \
+   t6 = _mm256_unpacklo_epi32(r6, r7); t7 = _mm256_unpackhi_epi32(r6, r7); \
+   r0 = _mm256_unpacklo_epi64(t0, t2); r1 = _mm256_unpackhi_epi64(t0, t2); \
+   r2 = _mm256_unpacklo_epi64(t1, t3); r3 = _mm256_unpackhi_epi64(t1, t3); \
+   r4 = _mm256_unpacklo_epi64(t4, t6); r5 = _mm256_unpackhi_epi64(t4, t6); \
+   r6 = _mm256_unpacklo_epi64(t5, t7); r7 = _mm256_unpackhi_epi64(t5, t7); \
+   (w)[0] = _mm256_permute2x128_si256(r0, r4, 0x20);                       \
+   (w)[1] = _mm256_permute2x128_si256(r1, r5, 0x20);                       \
+   (w)[2] = _mm256_permute2x128_si256(r2, r6, 0x20);                       \
+   (w)[3] = _mm256_permute2x128_si256(r3, r7, 0x20);                       \
+   (w)[4] = _mm256_permute2x128_si256(r0, r4, 0x31);                       \
+   (w)[5] = _mm256_permute2x128_si256(r1, r5, 0x31);                       \
+   (w)[6] = _mm256_permute2x128_si256(r2, r6, 0x31);                       \
+   (w)[7] = _mm256_permute2x128_si256(r3, r7, 0x31);
+
+/* compress nblocks 64-byte blocks for eight lanes at once; p[l] points at
+ * lane l's data and every lane state has an empty buffer */
+LTC_SHA1_AVX2_CALL
+static void _sha1_mb_blocks8(hash_state *md, const unsigned char **p, unsigned long nblocks)
+{
+   const __m256i bswap = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                           0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+   __m256i st[5], W[80], t0, t1, t2, t3, t4, t5, t6, t7;
+   __m256i a, b, c, d, e, f, k;
+   ulong32 outw[8];
+   unsigned long blk;
+   int i, l;
+
+   for (i = 0; i < 5; i++) {
+      st[i] = _mm256_set_epi32((int)md[7].sha1.state[i], (int)md[6].sha1.state[i],
+                               (int)md[5].sha1.state[i], (int)md[4].sha1.state[i],
+                               (int)md[3].sha1.state[i], (int)md[2].sha1.state[i],
+                               (int)md[1].sha1.state[i], (int)md[0].sha1.state[i]);
+   }
+
+   for (blk = 0; blk < nblocks; blk++) {
+      /* gather+transpose the blocks; the message is big endian 32-bit words */
+#define V_LOADROW(l, half) \
+      _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(p[l] + (blk << 6) + (half) * 32)), bswap)
+      t0 = V_LOADROW(0, 0); t1 = V_LOADROW(1, 0); t2 = V_LOADROW(2, 0); t3 = V_LOADROW(3, 0);
+      t4 = V_LOADROW(4, 0); t5 = V_LOADROW(5, 0); t6 = V_LOADROW(6, 0); t7 = V_LOADROW(7, 0);
+      {
+         __m256i r0 = t0, r1 = t1, r2 = t2, r3 = t3, r4 = t4, r5 = t5, r6 = t6, r7 = t7;
+         V_TRANSPOSE(W, r0, r1, r2, r3, r4, r5, r6, r7)
+      }
+      t0 = V_LOADROW(0, 1); t1 = V_LOADROW(1, 1); t2 = V_LOADROW(2, 1); t3 = V_LOADROW(3, 1);
+      t4 = V_LOADROW(4, 1); t5 = V_LOADROW(5, 1); t6 = V_LOADROW(6, 1); t7 = V_LOADROW(7, 1);
+      {
+         __m256i r0 = t0, r1 = t1, r2 = t2, r3 = t3, r4 = t4, r5 = t5, r6 = t6, r7 = t7;
+         V_TRANSPOSE(W + 8, r0, r1, r2, r3, r4, r5, r6, r7)
+      }
+#undef V_LOADROW
+
+      for (i = 16; i < 80; i++) {
+         W[i] = V_ROL(V_XOR(V_XOR(W[i - 3], W[i - 8]), V_XOR(W[i - 14], W[i - 16])), 1);
+      }
+
+      a = st[0]; b = st[1]; c = st[2]; d = st[3]; e = st[4];
+
+      for (i = 0; i < 80; i++) {
+         if (i < 20) {
+            f = V_F0(b, c, d); k = _mm256_set1_epi32((int)0x5a827999UL);
+         } else if (i < 40) {
+            f = V_F1(b, c, d); k = _mm256_set1_epi32((int)0x6ed9eba1UL);
+         } else if (i < 60) {
+            f = V_F2(b, c, d); k = _mm256_set1_epi32((int)0x8f1bbcdcUL);
+         } else {
+            f = V_F1(b, c, d); k = _mm256_set1_epi32((int)0xca62c1d6UL);
+         }
+         t0 = V_ADD(V_ADD(V_ROL(a, 5), f), V_ADD(V_ADD(e, k), W[i]));
+         e = d; d = c; c = V_ROL(b, 30); b = a; a = t0;
+      }
+
+      st[0] = V_ADD(st[0], a); st[1] = V_ADD(st[1], b);
+      st[2] = V_ADD(st[2], c); st[3] = V_ADD(st[3], d);
+      st[4] = V_ADD(st[4], e);
+   }
+
+   for (i = 0; i < 5; i++) {
+      _mm256_storeu_si256((__m256i *)outw, st[i]);
+      for (l = 0; l < 8; l++) {
+         md[l].sha1.state[i] = outw[l];
+      }
+   }
+   for (l = 0; l < 8; l++) {
+      md[l].sha1.length += (ulong64)nblocks * 512;
+   }
+}
+
+#endif /* LTC_SHA1_AVX2 */
+
+/**
+   Initialize an array of hash states for multi-buffer hashing
+   @param md     Array of hash states
+   @param lanes  Number of lanes (states/messages)
+   @return CRYPT_OK if successful
+*/
+int sha1_mb_init(hash_state *md, int lanes)
+{
+   int l, err;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(lanes >= 0);
+
+   for (l = 0; l < lanes; l++) {
+      if ((err = sha1_init(&md[l])) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Process one buffer per lane through the hash states.  The result per
+   lane is identical to calling sha1_process(&md[l], in[l], inlen[l]);
+   full groups of eight lanes are driven through the vector units together
+   when the CPU allows it.
+   @param md     Array of hash states
+   @param in     One input buffer per lane
+   @param inlen  The length of each input buffer (octets)
+   @param lanes  Number of lanes
+   @return CRYPT_OK if successful
+*/
+int sha1_mb_process(hash_state *md, const unsigned char **in, const unsigned long *inlen, int lanes)
+{
+   unsigned long off[8], n;
+   int base, g, l, err;
+
+   LTC_ARGCHK(md    != NULL);
+   LTC_ARGCHK(in    != NULL || lanes == 0);
+   LTC_ARGCHK(inlen != NULL || lanes == 0);
+   LTC_ARGCHK(lanes >= 0);
+
+   for (base = 0; base < lanes; base += g) {
+      g = MIN(8, lanes - base);
+      for (l = 0; l < g; l++) {
+         off[l] = 0;
+      }
+
+      /* drain buffered partial blocks so every lane is block aligned */
+      for (l = 0; l < g; l++) {
+         if (md[base + l].sha1.curlen > 0) {
+            n = MIN(64 - md[base + l].sha1.curlen, inlen[base + l]);
+            if ((err = sha1_process(&md[base + l], in[base + l], n)) != CRYPT_OK) {
+               return err;
+            }
+            off[l] = n;
+         }
+      }
+
+#ifdef LTC_SHA1_AVX2
+      if (g == 8 && _sha1_avx2_enabled()) {
+         const unsigned char *p[8];
+         unsigned long common, blocks;
+         int ok;
+
+         /* march all eight lanes through their common whole blocks */
+         common = (unsigned long)-1;
+         ok     = 1;
+         for (l = 0; l < 8; l++) {
+            if (md[base + l].sha1.curlen != 0) {
+               ok = 0; /* lane ran out of data mid-block above */
+               break;
+            }
+            blocks = (inlen[base + l] - off[l]) >> 6;
+            common = MIN(common, blocks);
+            p[l]   = in[base + l] + off[l];
+         }
+         if (ok && common > 0) {
+            _sha1_mb_blocks8(&md[base], p, common);
+            for (l = 0; l < 8; l++) {
+               off[l] += common << 6;
+            }
+         }
+      }
+#endif
+
+      /* whatever is left runs through the ordinary path */
+      for (l = 0; l < g; l++) {
+         if (inlen[base + l] > off[l]) {
+            if ((err = sha1_process(&md[base + l], in[base + l] + off[l], inlen[base + l] - off[l])) != CRYPT_OK) {
+               return err;
+            }
+         }
+      }
+   }
+
+   return CRYPT_OK;
+}
+
+/**
+   Terminate all lanes and emit one digest per lane
+   @param md     Array of hash states
+   @param out    One 20-byte digest destination per lane
+   @param lanes  Number of lanes
+   @return CRYPT_OK if successful
+*/
+int sha1_mb_done(hash_state *md, unsigned char **out, int lanes)
+{
+   int l, err;
+
+   LTC_ARGCHK(md  != NULL);
+   LTC_ARGCHK(out != NULL || lanes == 0);
+   LTC_ARGCHK(lanes >= 0);
+
+   for (l = 0; l < lanes; l++) {
+      if ((err = sha1_done(&md[l], out[l])) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+#endif /* LTC_SHA1 */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -32,7 +32,9 @@ const struct ltc_hash_descriptor sha224_desc =
     &sha256_process,
     &sha224_done,
     &sha224_test,
-    NULL
+    NULL,
+    &sha256_export,
+    &sha256_import
 };
 
 /* init the sha256 er... sha224 state ;-) */
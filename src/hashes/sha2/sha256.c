@@ -32,7 +32,9 @@ const struct ltc_hash_descriptor sha256_desc =
     &sha256_process,
     &sha256_done,
     &sha256_test,
-    NULL
+    NULL,
+    &sha256_export,
+    &sha256_import
 };
 
 #ifdef LTC_SMALL_CODE
@@ -77,6 +79,17 @@ static int  sha256_compress(hash_state * md, unsigned char *buf)
 #endif
     int i;
 
+#ifdef LTC_SHA256_NI
+    if (sha256_ni_enabled()) {
+       return sha256_ni_compress(md, buf);
+    }
+#endif
+#ifdef LTC_SHA256_ARMV8
+    if (sha256_armv8_enabled()) {
+       return sha256_armv8_compress(md, buf);
+    }
+#endif
+
     /* copy state into S */
     for (i = 0; i < 8; i++) {
         S[i] = md->sha256.state[i];
@@ -284,6 +297,71 @@ int sha256_done(hash_state * md, unsigned char *out)
     return CRYPT_OK;
 }
 
+/**
+   Export the hash midstate so hashing can resume from a checkpoint
+   @param out     [out] The destination of the serialized midstate
+   @param outlen  [in/out] The max size and resulting size of the midstate
+   @param md      The hash state to serialize
+   @return CRYPT_OK if successful
+*/
+int sha256_export(unsigned char *out, unsigned long *outlen, const hash_state *md)
+{
+    unsigned long n;
+    int i;
+
+    LTC_ARGCHK(out    != NULL);
+    LTC_ARGCHK(outlen != NULL);
+    LTC_ARGCHK(md     != NULL);
+
+    if (md->sha256.curlen >= sizeof(md->sha256.buf)) {
+       return CRYPT_INVALID_ARG;
+    }
+    n = 44 + md->sha256.curlen;
+    if (*outlen < n) {
+       *outlen = n;
+       return CRYPT_BUFFER_OVERFLOW;
+    }
+    STORE64H(md->sha256.length, out);
+    for (i = 0; i < 8; i++) {
+        STORE32H(md->sha256.state[i], out + 8 + 4 * i);
+    }
+    STORE32H(md->sha256.curlen, out + 40);
+    XMEMCPY(out + 44, md->sha256.buf, md->sha256.curlen);
+    *outlen = n;
+    return CRYPT_OK;
+}
+
+/**
+   Import a hash midstate previously made with sha256_export
+   @param md     The hash state to restore into
+   @param in     The serialized midstate
+   @param inlen  The length of the serialized midstate (octets)
+   @return CRYPT_OK if successful
+*/
+int sha256_import(hash_state *md, const unsigned char *in, unsigned long inlen)
+{
+    ulong32 curlen;
+    int i;
+
+    LTC_ARGCHK(md != NULL);
+    LTC_ARGCHK(in != NULL);
+
+    if (inlen < 44) {
+       return CRYPT_INVALID_PACKET;
+    }
+    LOAD32H(curlen, in + 40);
+    if (curlen >= sizeof(md->sha256.buf) || inlen != 44 + curlen) {
+       return CRYPT_INVALID_PACKET;
+    }
+    LOAD64H(md->sha256.length, in);
+    for (i = 0; i < 8; i++) {
+        LOAD32H(md->sha256.state[i], in + 8 + 4 * i);
+    }
+    md->sha256.curlen = curlen;
+    XMEMCPY(md->sha256.buf, in + 44, curlen);
+    return CRYPT_OK;
+}
+
 /**
   Self-test the hash
   @return CRYPT_OK if successful, CRYPT_NOP if self-tests have been disabled
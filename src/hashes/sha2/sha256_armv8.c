@@ -0,0 +1,130 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file sha256_armv8.c
+  SHA-256 compression using the ARMv8 Crypto Extensions (SHA256H/SHA256H2/
+  SHA256SU0/SHA256SU1), selected at run-time from sha256.c
+*/
+
+#if defined(LTC_SHA256) && defined(LTC_SHA256_ARMV8)
+
+#include <arm_neon.h>
+
+static const ulong32 K[64] = {
+    0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL,
+    0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL, 0xd807aa98UL, 0x12835b01UL,
+    0x243185beUL, 0x550c7dc3UL, 0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL,
+    0xc19bf174UL, 0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL,
+    0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL, 0x983e5152UL,
+    0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL,
+    0x06ca6351UL, 0x14292967UL, 0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL,
+    0x53380d13UL, 0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL,
+    0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL, 0xd192e819UL,
+    0xd6990624UL, 0xf40e3585UL, 0x106aa070UL, 0x19a4c116UL, 0x1e376c08UL,
+    0x2748774cUL, 0x34b0bcb5UL, 0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL,
+    0x682e6ff3UL, 0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL,
+    0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
+};
+
+/**
+  Query whether the CPU executing us provides the SHA-256 instructions.
+  The result is cached by ltc_cpu_features().
+  @return 1 if the ARMv8 SHA-2 extension is available, 0 otherwise
+*/
+int sha256_armv8_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_SHA) != 0;
+}
+
+/**
+  Compress 512 bits of data with the ARMv8 SHA-2 extension
+  @param md   The hash state
+  @param buf  The 64 byte block to compress
+  @return CRYPT_OK if successful
+*/
+int sha256_armv8_compress(hash_state *md, const unsigned char *buf)
+{
+   uint32x4_t s0, s1, abef, cdgh, m0, m1, m2, m3, t0, t1;
+   int        i;
+
+   s0 = vld1q_u32(&md->sha256.state[0]);
+   s1 = vld1q_u32(&md->sha256.state[4]);
+
+   /* the message is big endian 32-bit words */
+   m0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(buf +  0)));
+   m1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(buf + 16)));
+   m2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(buf + 32)));
+   m3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(buf + 48)));
+
+   abef = s0;
+   cdgh = s1;
+
+   t0 = vaddq_u32(m0, vld1q_u32(&K[0]));
+   for (i = 0; i < 48; i += 16) {
+      /* sixteen rounds per trip with on-the-fly schedule expansion */
+      t1   = vaddq_u32(m1, vld1q_u32(&K[i + 4]));
+      m0   = vsha256su1q_u32(vsha256su0q_u32(m0, m1), m2, m3);
+      s0   = abef;
+      abef = vsha256hq_u32(abef, cdgh, t0);
+      cdgh = vsha256h2q_u32(cdgh, s0, t0);
+
+      t0   = vaddq_u32(m2, vld1q_u32(&K[i + 8]));
+      m1   = vsha256su1q_u32(vsha256su0q_u32(m1, m2), m3, m0);
+      s0   = abef;
+      abef = vsha256hq_u32(abef, cdgh, t1);
+      cdgh = vsha256h2q_u32(cdgh, s0, t1);
+
+      t1   = vaddq_u32(m3, vld1q_u32(&K[i + 12]));
+      m2   = vsha256su1q_u32(vsha256su0q_u32(m2, m3), m0, m1);
+      s0   = abef;
+      abef = vsha256hq_u32(abef, cdgh, t0);
+      cdgh = vsha256h2q_u32(cdgh, s0, t0);
+
+      t0   = vaddq_u32(m0, vld1q_u32(&K[i + 16]));
+      m3   = vsha256su1q_u32(vsha256su0q_u32(m3, m0), m1, m2);
+      s0   = abef;
+      abef = vsha256hq_u32(abef, cdgh, t1);
+      cdgh = vsha256h2q_u32(cdgh, s0, t1);
+   }
+
+   /* last 16 rounds, no more schedule to expand */
+   t1   = vaddq_u32(m1, vld1q_u32(&K[52]));
+   s0   = abef;
+   abef = vsha256hq_u32(abef, cdgh, t0);
+   cdgh = vsha256h2q_u32(cdgh, s0, t0);
+
+   t0   = vaddq_u32(m2, vld1q_u32(&K[56]));
+   s0   = abef;
+   abef = vsha256hq_u32(abef, cdgh, t1);
+   cdgh = vsha256h2q_u32(cdgh, s0, t1);
+
+   t1   = vaddq_u32(m3, vld1q_u32(&K[60]));
+   s0   = abef;
+   abef = vsha256hq_u32(abef, cdgh, t0);
+   cdgh = vsha256h2q_u32(cdgh, s0, t0);
+
+   s0   = abef;
+   abef = vsha256hq_u32(abef, cdgh, t1);
+   cdgh = vsha256h2q_u32(cdgh, s0, t1);
+
+   vst1q_u32(&md->sha256.state[0], vaddq_u32(vld1q_u32(&md->sha256.state[0]), abef));
+   vst1q_u32(&md->sha256.state[4], vaddq_u32(vld1q_u32(&md->sha256.state[4]), cdgh));
+
+   return CRYPT_OK;
+}
+
+#endif /* LTC_SHA256 && LTC_SHA256_ARMV8 */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
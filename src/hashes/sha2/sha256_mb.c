@@ -0,0 +1,284 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file sha256_mb.c
+  Multi-buffer SHA-256: hash several independent messages in lock step so
+  the vector units stay full, by Tom St Denis
+*/
+
+#ifdef LTC_SHA256
+
+#ifdef LTC_SHA256_AVX2
+
+/* immintrin.h drags in AVX-512 headers that are not C90 clean */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+#define LTC_SHA256_AVX2_CALL __attribute__((target("avx2")))
+
+static const ulong32 K[64] = {
+    0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL,
+    0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL, 0xd807aa98UL, 0x12835b01UL,
+    0x243185beUL, 0x550c7dc3UL, 0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL,
+    0xc19bf174UL, 0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL,
+    0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL, 0x983e5152UL,
+    0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL,
+    0x06ca6351UL, 0x14292967UL, 0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL,
+    0x53380d13UL, 0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL,
+    0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL, 0xd192e819UL,
+    0xd6990624UL, 0xf40e3585UL, 0x106aa070UL, 0x19a4c116UL, 0x1e376c08UL,
+    0x2748774cUL, 0x34b0bcb5UL, 0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL,
+    0x682e6ff3UL, 0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL,
+    0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
+};
+
+static int _sha256_avx2_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_AVX2) != 0;
+}
+
+/* the scalar round helpers, one lane per 32-bit element */
+#define V_ROR(x, n)   _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define V_ADD(x, y)   _mm256_add_epi32(x, y)
+#define V_XOR(x, y)   _mm256_xor_si256(x, y)
+#define V_CH(x, y, z)  V_XOR(z, _mm256_and_si256(x, V_XOR(y, z)))
+#define V_MAJ(x, y, z) _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(x, y), z), _mm256_and_si256(x, y))
+#define V_SIGMA0(x)   V_XOR(V_XOR(V_ROR(x,  2), V_ROR(x, 13)), V_ROR(x, 22))
+#define V_SIGMA1(x)   V_XOR(V_XOR(V_ROR(x,  6), V_ROR(x, 11)), V_ROR(x, 25))
+#define V_GAMMA0(x)   V_XOR(V_XOR(V_ROR(x,  7), V_ROR(x, 18)), _mm256_srli_epi32(x,  3))
+#define V_GAMMA1(x)   V_XOR(V_XOR(V_ROR(x, 17), V_ROR(x, 19)), _mm256_srli_epi32(x, 10))
+
+/* 8x8 transpose of 32-bit words so W[t] holds word t of every lane */
+#define V_TRANSPOSE(w, r0, r1, r2, r3, r4, r5, r6, r7)             \
+   t0 = _mm256_unpacklo_epi32(r0, r1); t1 = _mm256_unpackhi_epi32(r0, r1); \
+   t2 = _mm256_unpacklo_epi32(r2, r3); t3 = _mm256_unpackhi_epi32(r2, r3); \
+   t4 = _mm256_unpacklo_epi32(r4, r5); t5 = _mm256_unpackhi_epi32(r4, r5); \
+   t6 = _mm256_unpacklo_epi32(r6, r7); t7 = _mm256_unpackhi_epi32(r6, r7); \
+   r0 = _mm256_unpacklo_epi64(t0, t2); r1 = _mm256_unpackhi_epi64(t0, t2); \
+   r2 = _mm256_unpacklo_epi64(t1, t3); r3 = _mm256_unpackhi_epi64(t1, t3); \
+   r4 = _mm256_unpacklo_epi64(t4, t6); r5 = _mm256_unpackhi_epi64(t4, t6); \
+   r6 = _mm256_unpacklo_epi64(t5, t7); r7 = _mm256_unpackhi_epi64(t5, t7); \
+   (w)[0] = _mm256_permute2x128_si256(r0, r4, 0x20);                       \
+   (w)[1] = _mm256_permute2x128_si256(r1, r5, 0x20);                       \
+   (w)[2] = _mm256_permute2x128_si256(r2, r6, 0x20);                       \
+   (w)[3] = _mm256_permute2x128_si256(r3, r7, 0x20);                       \
+   (w)[4] = _mm256_permute2x128_si256(r0, r4, 0x31);                       \
+   (w)[5] = _mm256_permute2x128_si256(r1, r5, 0x31);                       \
+   (w)[6] = _mm256_permute2x128_si256(r2, r6, 0x31);                       \
+   (w)[7] = _mm256_permute2x128_si256(r3, r7, 0x31);
+
+/* compress nblocks 64-byte blocks for eight lanes at once; p[l] points at
+ * lane l's data and every lane state has an empty buffer */
+LTC_SHA256_AVX2_CALL
+static void _sha256_mb_blocks8(hash_state *md, const unsigned char **p, unsigned long nblocks)
+{
+   const __m256i bswap = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                           0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+   __m256i st[8], W[64], t0, t1, t2, t3, t4, t5, t6, t7;
+   __m256i a, b, c, d, e, f, g, h;
+   ulong32 outw[8];
+   unsigned long blk;
+   int i, l;
+
+   for (i = 0; i < 8; i++) {
+      st[i] = _mm256_set_epi32((int)md[7].sha256.state[i], (int)md[6].sha256.state[i],
+                               (int)md[5].sha256.state[i], (int)md[4].sha256.state[i],
+                               (int)md[3].sha256.state[i], (int)md[2].sha256.state[i],
+                               (int)md[1].sha256.state[i], (int)md[0].sha256.state[i]);
+   }
+
+   for (blk = 0; blk < nblocks; blk++) {
+      /* gather+transpose the blocks; the message is big endian 32-bit words */
+#define V_LOADROW(l, half) \
+      _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(p[l] + (blk << 6) + (half) * 32)), bswap)
+      t0 = V_LOADROW(0, 0); t1 = V_LOADROW(1, 0); t2 = V_LOADROW(2, 0); t3 = V_LOADROW(3, 0);
+      t4 = V_LOADROW(4, 0); t5 = V_LOADROW(5, 0); t6 = V_LOADROW(6, 0); t7 = V_LOADROW(7, 0);
+      {
+         __m256i r0 = t0, r1 = t1, r2 = t2, r3 = t3, r4 = t4, r5 = t5, r6 = t6, r7 = t7;
+         V_TRANSPOSE(W, r0, r1, r2, r3, r4, r5, r6, r7)
+      }
+      t0 = V_LOADROW(0, 1); t1 = V_LOADROW(1, 1); t2 = V_LOADROW(2, 1); t3 = V_LOADROW(3, 1);
+      t4 = V_LOADROW(4, 1); t5 = V_LOADROW(5, 1); t6 = V_LOADROW(6, 1); t7 = V_LOADROW(7, 1);
+      {
+         __m256i r0 = t0, r1 = t1, r2 = t2, r3 = t3, r4 = t4, r5 = t5, r6 = t6, r7 = t7;
+         V_TRANSPOSE(W + 8, r0, r1, r2, r3, r4, r5, r6, r7)
+      }
+#undef V_LOADROW
+
+      for (i = 16; i < 64; i++) {
+         W[i] = V_ADD(V_ADD(V_GAMMA1(W[i - 2]), W[i - 7]),
+                      V_ADD(V_GAMMA0(W[i - 15]), W[i - 16]));
+      }
+
+      a = st[0]; b = st[1]; c = st[2]; d = st[3];
+      e = st[4]; f = st[5]; g = st[6]; h = st[7];
+
+      for (i = 0; i < 64; i++) {
+         t0 = V_ADD(V_ADD(V_ADD(h, V_SIGMA1(e)), V_CH(e, f, g)),
+                    V_ADD(_mm256_set1_epi32((int)K[i]), W[i]));
+         t1 = V_ADD(V_SIGMA0(a), V_MAJ(a, b, c));
+         h = g; g = f; f = e; e = V_ADD(d, t0);
+         d = c; c = b; b = a; a = V_ADD(t0, t1);
+      }
+
+      st[0] = V_ADD(st[0], a); st[1] = V_ADD(st[1], b);
+      st[2] = V_ADD(st[2], c); st[3] = V_ADD(st[3], d);
+      st[4] = V_ADD(st[4], e); st[5] = V_ADD(st[5], f);
+      st[6] = V_ADD(st[6], g); st[7] = V_ADD(st[7], h);
+   }
+
+   for (i = 0; i < 8; i++) {
+      _mm256_storeu_si256((__m256i *)outw, st[i]);
+      for (l = 0; l < 8; l++) {
+         md[l].sha256.state[i] = outw[l];
+      }
+   }
+   for (l = 0; l < 8; l++) {
+      md[l].sha256.length += (ulong64)nblocks * 512;
+   }
+}
+
+#endif /* LTC_SHA256_AVX2 */
+
+/**
+   Initialize an array of hash states for multi-buffer hashing
+   @param md     Array of hash states
+   @param lanes  Number of lanes (states/messages)
+   @return CRYPT_OK if successful
+*/
+int sha256_mb_init(hash_state *md, int lanes)
+{
+   int l, err;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(lanes >= 0);
+
+   for (l = 0; l < lanes; l++) {
+      if ((err = sha256_init(&md[l])) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Process one buffer per lane through the hash states.  The result per
+   lane is identical to calling sha256_process(&md[l], in[l], inlen[l]);
+   full groups of eight lanes are driven through the vector units together
+   when the CPU allows it.
+   @param md     Array of hash states
+   @param in     One input buffer per lane
+   @param inlen  The length of each input buffer (octets)
+   @param lanes  Number of lanes
+   @return CRYPT_OK if successful
+*/
+int sha256_mb_process(hash_state *md, const unsigned char **in, const unsigned long *inlen, int lanes)
+{
+   unsigned long off[8], n;
+   int base, g, l, err;
+
+   LTC_ARGCHK(md    != NULL);
+   LTC_ARGCHK(in    != NULL || lanes == 0);
+   LTC_ARGCHK(inlen != NULL || lanes == 0);
+   LTC_ARGCHK(lanes >= 0);
+
+   for (base = 0; base < lanes; base += g) {
+      g = MIN(8, lanes - base);
+      for (l = 0; l < g; l++) {
+         off[l] = 0;
+      }
+
+      /* drain buffered partial blocks so every lane is block aligned */
+      for (l = 0; l < g; l++) {
+         if (md[base + l].sha256.curlen > 0) {
+            n = MIN(64 - md[base + l].sha256.curlen, inlen[base + l]);
+            if ((err = sha256_process(&md[base + l], in[base + l], n)) != CRYPT_OK) {
+               return err;
+            }
+            off[l] = n;
+         }
+      }
+
+#ifdef LTC_SHA256_AVX2
+      if (g == 8 && _sha256_avx2_enabled()) {
+         const unsigned char *p[8];
+         unsigned long common, blocks;
+         int ok;
+
+         /* march all eight lanes through their common whole blocks */
+         for (;;) {
+            common = (unsigned long)-1;
+            ok     = 1;
+            for (l = 0; l < 8; l++) {
+               if (md[base + l].sha256.curlen != 0) {
+                  ok = 0; /* lane ran out of data mid-block above */
+                  break;
+               }
+               blocks = (inlen[base + l] - off[l]) >> 6;
+               common = MIN(common, blocks);
+               p[l]   = in[base + l] + off[l];
+            }
+            if (!ok || common == 0) {
+               break;
+            }
+            _sha256_mb_blocks8(&md[base], p, common);
+            for (l = 0; l < 8; l++) {
+               off[l] += common << 6;
+            }
+         }
+      }
+#endif
+
+      /* whatever is left runs through the ordinary path */
+      for (l = 0; l < g; l++) {
+         if (inlen[base + l] > off[l]) {
+            if ((err = sha256_process(&md[base + l], in[base + l] + off[l], inlen[base + l] - off[l])) != CRYPT_OK) {
+               return err;
+            }
+         }
+      }
+   }
+
+   return CRYPT_OK;
+}
+
+/**
+   Terminate all lanes and emit one digest per lane
+   @param md     Array of hash states
+   @param out    One 32-byte digest destination per lane
+   @param lanes  Number of lanes
+   @return CRYPT_OK if successful
+*/
+int sha256_mb_done(hash_state *md, unsigned char **out, int lanes)
+{
+   int l, err;
+
+   LTC_ARGCHK(md  != NULL);
+   LTC_ARGCHK(out != NULL || lanes == 0);
+   LTC_ARGCHK(lanes >= 0);
+
+   for (l = 0; l < lanes; l++) {
+      if ((err = sha256_done(&md[l], out[l])) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+#endif /* LTC_SHA256 */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
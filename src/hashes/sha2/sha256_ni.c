@@ -0,0 +1,147 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file sha256_ni.c
+  SHA-256 compression using the x86 SHA extensions (SHA256RNDS2/
+  SHA256MSG1/SHA256MSG2), selected at run-time from sha256.c
+*/
+
+#if defined(LTC_SHA256) && defined(LTC_SHA256_NI)
+
+/* immintrin.h drags in AVX-512 headers that are not C90 clean */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+#define LTC_SHANI_CALL __attribute__((target("sha,sse4.1,ssse3,sse2")))
+
+static const ulong32 K[64] = {
+    0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL,
+    0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL, 0xd807aa98UL, 0x12835b01UL,
+    0x243185beUL, 0x550c7dc3UL, 0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL,
+    0xc19bf174UL, 0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL,
+    0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL, 0x983e5152UL,
+    0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL,
+    0x06ca6351UL, 0x14292967UL, 0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL,
+    0x53380d13UL, 0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL,
+    0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL, 0xd192e819UL,
+    0xd6990624UL, 0xf40e3585UL, 0x106aa070UL, 0x19a4c116UL, 0x1e376c08UL,
+    0x2748774cUL, 0x34b0bcb5UL, 0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL,
+    0x682e6ff3UL, 0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL,
+    0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
+};
+
+/**
+  Query whether the CPU executing us provides the SHA instructions.
+  The result is cached so the CPUID dance only happens once.
+  @return 1 if the x86 SHA extension is available, 0 otherwise
+*/
+int sha256_ni_enabled(void)
+{
+   return (ltc_cpu_features() & (LTC_CPU_SHA | LTC_CPU_SSE41)) ==
+          (LTC_CPU_SHA | LTC_CPU_SSE41);
+}
+
+/* four rounds; SHA256RNDS2 does two at a time, eating the low two dwords
+ * of the round constant + schedule word */
+#define RNDS4(wk)                                              \
+   t    = wk;                                                  \
+   cdgh = _mm_sha256rnds2_epu32(cdgh, abef, t);                \
+   t    = _mm_shuffle_epi32(t, 0x0E);                          \
+   abef = _mm_sha256rnds2_epu32(abef, cdgh, t);
+
+/* expand four more schedule words from the last sixteen */
+#define SCHED(w0, w1, w2, w3)                                  \
+   _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(w0, w1), \
+                                      _mm_alignr_epi8(w3, w2, 4)), w3)
+
+#define KLOAD(i) _mm_loadu_si128((const __m128i *)&K[i])
+
+/**
+  Compress 512 bits of data with the x86 SHA extension
+  @param md   The hash state
+  @param buf  The 64 byte block to compress
+  @return CRYPT_OK if successful
+*/
+LTC_SHANI_CALL
+int sha256_ni_compress(hash_state *md, const unsigned char *buf)
+{
+   const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+   __m128i abef, cdgh, save0, save1, m0, m1, m2, m3, t, t0, t1;
+   int i;
+
+   /* pack the state words into the ABEF/CDGH layout the rounds expect */
+   t0   = _mm_loadu_si128((const __m128i *)&md->sha256.state[0]); /* DCBA */
+   t1   = _mm_loadu_si128((const __m128i *)&md->sha256.state[4]); /* HGFE */
+   t0   = _mm_shuffle_epi32(t0, 0xB1);                            /* CDAB */
+   t1   = _mm_shuffle_epi32(t1, 0x1B);                            /* EFGH */
+   abef = _mm_alignr_epi8(t0, t1, 8);                             /* ABEF */
+   cdgh = _mm_blend_epi16(t1, t0, 0xF0);                          /* CDGH */
+
+   save0 = abef;
+   save1 = cdgh;
+
+   /* the message is big endian 32-bit words */
+   m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf +  0)), bswap);
+   m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf + 16)), bswap);
+   m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf + 32)), bswap);
+   m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf + 48)), bswap);
+
+   t0 = _mm_add_epi32(m0, KLOAD(0));
+   for (i = 0; i < 48; i += 16) {
+      /* sixteen rounds per trip with on-the-fly schedule expansion */
+      t1 = _mm_add_epi32(m1, KLOAD(i + 4));
+      m0 = SCHED(m0, m1, m2, m3);
+      RNDS4(t0)
+
+      t0 = _mm_add_epi32(m2, KLOAD(i + 8));
+      m1 = SCHED(m1, m2, m3, m0);
+      RNDS4(t1)
+
+      t1 = _mm_add_epi32(m3, KLOAD(i + 12));
+      m2 = SCHED(m2, m3, m0, m1);
+      RNDS4(t0)
+
+      t0 = _mm_add_epi32(m0, KLOAD(i + 16));
+      m3 = SCHED(m3, m0, m1, m2);
+      RNDS4(t1)
+   }
+
+   /* last 16 rounds, no more schedule to expand */
+   t1 = _mm_add_epi32(m1, KLOAD(52));
+   RNDS4(t0)
+   t0 = _mm_add_epi32(m2, KLOAD(56));
+   RNDS4(t1)
+   t1 = _mm_add_epi32(m3, KLOAD(60));
+   RNDS4(t0)
+   RNDS4(t1)
+
+   /* feedback and unpack */
+   abef = _mm_add_epi32(abef, save0);
+   cdgh = _mm_add_epi32(cdgh, save1);
+   t0   = _mm_shuffle_epi32(abef, 0x1B);                          /* FEBA */
+   t1   = _mm_shuffle_epi32(cdgh, 0xB1);                          /* DCHG */
+   abef = _mm_blend_epi16(t0, t1, 0xF0);                          /* DCBA */
+   cdgh = _mm_alignr_epi8(t1, t0, 8);                             /* HGFE */
+   _mm_storeu_si128((__m128i *)&md->sha256.state[0], abef);
+   _mm_storeu_si128((__m128i *)&md->sha256.state[4], cdgh);
+
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -32,7 +32,9 @@ const struct ltc_hash_descriptor sha384_desc =
     &sha512_process,
     &sha384_done,
     &sha384_test,
-    NULL
+    NULL,
+    &sha512_export,
+    &sha512_import
 };
 
 /**
@@ -32,7 +32,9 @@ const struct ltc_hash_descriptor sha512_desc =
     &sha512_process,
     &sha512_done,
     &sha512_test,
-    NULL
+    NULL,
+    &sha512_export,
+    &sha512_import
 };
 
 /* the K array */
@@ -99,6 +101,12 @@ static int  sha512_compress(hash_state * md, unsigned char *buf)
     ulong64 S[8], W[80], t0, t1;
     int i;
 
+#ifdef LTC_SHA512_AVX2
+    if (sha512_avx2_enabled()) {
+       return sha512_avx2_compress(md, buf);
+    }
+#endif
+
     /* copy state into S */
     for (i = 0; i < 8; i++) {
         S[i] = md->sha512.state[i];
@@ -254,6 +262,71 @@ int sha512_done(hash_state * md, unsigned char *out)
     return CRYPT_OK;
 }
 
+/**
+   Export the hash midstate so hashing can resume from a checkpoint
+   @param out     [out] The destination of the serialized midstate
+   @param outlen  [in/out] The max size and resulting size of the midstate
+   @param md      The hash state to serialize
+   @return CRYPT_OK if successful
+*/
+int sha512_export(unsigned char *out, unsigned long *outlen, const hash_state *md)
+{
+    unsigned long n;
+    int i;
+
+    LTC_ARGCHK(out    != NULL);
+    LTC_ARGCHK(outlen != NULL);
+    LTC_ARGCHK(md     != NULL);
+
+    if (md->sha512.curlen >= sizeof(md->sha512.buf)) {
+       return CRYPT_INVALID_ARG;
+    }
+    n = 76 + md->sha512.curlen;
+    if (*outlen < n) {
+       *outlen = n;
+       return CRYPT_BUFFER_OVERFLOW;
+    }
+    STORE64H(md->sha512.length, out);
+    for (i = 0; i < 8; i++) {
+        STORE64H(md->sha512.state[i], out + 8 + 8 * i);
+    }
+    STORE32H(md->sha512.curlen, out + 72);
+    XMEMCPY(out + 76, md->sha512.buf, md->sha512.curlen);
+    *outlen = n;
+    return CRYPT_OK;
+}
+
+/**
+   Import a hash midstate previously made with sha512_export
+   @param md     The hash state to restore into
+   @param in     The serialized midstate
+   @param inlen  The length of the serialized midstate (octets)
+   @return CRYPT_OK if successful
+*/
+int sha512_import(hash_state *md, const unsigned char *in, unsigned long inlen)
+{
+    ulong32 curlen;
+    int i;
+
+    LTC_ARGCHK(md != NULL);
+    LTC_ARGCHK(in != NULL);
+
+    if (inlen < 76) {
+       return CRYPT_INVALID_PACKET;
+    }
+    LOAD32H(curlen, in + 72);
+    if (curlen >= sizeof(md->sha512.buf) || inlen != 76 + curlen) {
+       return CRYPT_INVALID_PACKET;
+    }
+    LOAD64H(md->sha512.length, in);
+    for (i = 0; i < 8; i++) {
+        LOAD64H(md->sha512.state[i], in + 8 + 8 * i);
+    }
+    md->sha512.curlen = curlen;
+    XMEMCPY(md->sha512.buf, in + 76, curlen);
+    return CRYPT_OK;
+}
+
 /**
   Self-test the hash
   @return CRYPT_OK if successful, CRYPT_NOP if self-tests have been disabled
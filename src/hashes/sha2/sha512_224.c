@@ -32,7 +32,9 @@ const struct ltc_hash_descriptor sha512_224_desc =
     &sha512_process,
     &sha512_224_done,
     &sha512_224_test,
-    NULL
+    NULL,
+    &sha512_export,
+    &sha512_import
 };
 
 /**
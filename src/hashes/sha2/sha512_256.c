@@ -32,7 +32,9 @@ const struct ltc_hash_descriptor sha512_256_desc =
     &sha512_process,
     &sha512_256_done,
     &sha512_256_test,
-    NULL
+    NULL,
+    &sha512_export,
+    &sha512_import
 };
 
 /**
@@ -0,0 +1,171 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file sha512_avx2.c
+  SHA-512 compression with the message schedule expanded four words at a
+  time in AVX2 registers, selected at run-time from sha512.c
+*/
+
+#if defined(LTC_SHA512) && defined(LTC_SHA512_AVX2)
+
+/* immintrin.h drags in AVX-512 headers that are not C90 clean */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+#define LTC_SHA512_AVX2_CALL __attribute__((target("avx2")))
+
+static const ulong64 K[80] = {
+CONST64(0x428a2f98d728ae22), CONST64(0x7137449123ef65cd),
+CONST64(0xb5c0fbcfec4d3b2f), CONST64(0xe9b5dba58189dbbc),
+CONST64(0x3956c25bf348b538), CONST64(0x59f111f1b605d019),
+CONST64(0x923f82a4af194f9b), CONST64(0xab1c5ed5da6d8118),
+CONST64(0xd807aa98a3030242), CONST64(0x12835b0145706fbe),
+CONST64(0x243185be4ee4b28c), CONST64(0x550c7dc3d5ffb4e2),
+CONST64(0x72be5d74f27b896f), CONST64(0x80deb1fe3b1696b1),
+CONST64(0x9bdc06a725c71235), CONST64(0xc19bf174cf692694),
+CONST64(0xe49b69c19ef14ad2), CONST64(0xefbe4786384f25e3),
+CONST64(0x0fc19dc68b8cd5b5), CONST64(0x240ca1cc77ac9c65),
+CONST64(0x2de92c6f592b0275), CONST64(0x4a7484aa6ea6e483),
+CONST64(0x5cb0a9dcbd41fbd4), CONST64(0x76f988da831153b5),
+CONST64(0x983e5152ee66dfab), CONST64(0xa831c66d2db43210),
+CONST64(0xb00327c898fb213f), CONST64(0xbf597fc7beef0ee4),
+CONST64(0xc6e00bf33da88fc2), CONST64(0xd5a79147930aa725),
+CONST64(0x06ca6351e003826f), CONST64(0x142929670a0e6e70),
+CONST64(0x27b70a8546d22ffc), CONST64(0x2e1b21385c26c926),
+CONST64(0x4d2c6dfc5ac42aed), CONST64(0x53380d139d95b3df),
+CONST64(0x650a73548baf63de), CONST64(0x766a0abb3c77b2a8),
+CONST64(0x81c2c92e47edaee6), CONST64(0x92722c851482353b),
+CONST64(0xa2bfe8a14cf10364), CONST64(0xa81a664bbc423001),
+CONST64(0xc24b8b70d0f89791), CONST64(0xc76c51a30654be30),
+CONST64(0xd192e819d6ef5218), CONST64(0xd69906245565a910),
+CONST64(0xf40e35855771202a), CONST64(0x106aa07032bbd1b8),
+CONST64(0x19a4c116b8d2d0c8), CONST64(0x1e376c085141ab53),
+CONST64(0x2748774cdf8eeb99), CONST64(0x34b0bcb5e19b48a8),
+CONST64(0x391c0cb3c5c95a63), CONST64(0x4ed8aa4ae3418acb),
+CONST64(0x5b9cca4f7763e373), CONST64(0x682e6ff3d6b2b8a3),
+CONST64(0x748f82ee5defb2fc), CONST64(0x78a5636f43172f60),
+CONST64(0x84c87814a1f0ab72), CONST64(0x8cc702081a6439ec),
+CONST64(0x90befffa23631e28), CONST64(0xa4506cebde82bde9),
+CONST64(0xbef9a3f7b2c67915), CONST64(0xc67178f2e372532b),
+CONST64(0xca273eceea26619c), CONST64(0xd186b8c721c0c207),
+CONST64(0xeada7dd6cde0eb1e), CONST64(0xf57d4f7fee6ed178),
+CONST64(0x06f067aa72176fba), CONST64(0x0a637dc5a2c898a6),
+CONST64(0x113f9804bef90dae), CONST64(0x1b710b35131c471b),
+CONST64(0x28db77f523047d84), CONST64(0x32caab7b40c72493),
+CONST64(0x3c9ebe0a15c9bebc), CONST64(0x431d67c49c100d4c),
+CONST64(0x4cc5d4becb3e42b6), CONST64(0x597f299cfc657e2a),
+CONST64(0x5fcb6fab3ad6faec), CONST64(0x6c44198c4a475817)
+};
+
+/* the scalar round helpers, as in sha512.c */
+#define Ch(x,y,z)       (z ^ (x & (y ^ z)))
+#define Maj(x,y,z)      (((x | y) & z) | (x & y))
+#define Sg(x, n)        ROR64c(x, n)
+#define Sigma0(x)       (Sg(x, 28) ^ Sg(x, 34) ^ Sg(x, 39))
+#define Sigma1(x)       (Sg(x, 14) ^ Sg(x, 18) ^ Sg(x, 41))
+
+/* their vector twins for the schedule, 64-bit lanes */
+#define V4_ROR(x, n)    _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+#define V4_GAMMA0(x)    _mm256_xor_si256(_mm256_xor_si256(V4_ROR(x,  1), V4_ROR(x,  8)), _mm256_srli_epi64(x, 7))
+#define V4_GAMMA1(x)    _mm256_xor_si256(_mm256_xor_si256(V4_ROR(x, 19), V4_ROR(x, 61)), _mm256_srli_epi64(x, 6))
+#define V2_ROR(x, n)    _mm_or_si128(_mm_srli_epi64(x, n), _mm_slli_epi64(x, 64 - (n)))
+#define V2_GAMMA1(x)    _mm_xor_si128(_mm_xor_si128(V2_ROR(x, 19), V2_ROR(x, 61)), _mm_srli_epi64(x, 6))
+
+/**
+  Query whether the CPU executing us provides AVX2.
+  The result is cached so the CPUID dance only happens once.
+  @return 1 if AVX2 is available, 0 otherwise
+*/
+int sha512_avx2_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_AVX2) != 0;
+}
+
+/**
+  Compress 1024 bits of data with the schedule in AVX2 registers
+  @param md   The hash state
+  @param buf  The 128 byte block to compress
+  @return CRYPT_OK if successful
+*/
+LTC_SHA512_AVX2_CALL
+int sha512_avx2_compress(hash_state *md, const unsigned char *buf)
+{
+   const __m256i bswap = _mm256_set_epi8( 8, 9,10,11,12,13,14,15,  0, 1, 2, 3, 4, 5, 6, 7,
+                                          8, 9,10,11,12,13,14,15,  0, 1, 2, 3, 4, 5, 6, 7);
+   ulong64 S[8], W[80], t0, t1;
+   __m256i part, g1;
+   __m128i lo, hi;
+   int i;
+
+   /* the message is big endian 64-bit words */
+   for (i = 0; i < 16; i += 4) {
+      _mm256_storeu_si256((__m256i *)&W[i],
+         _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(buf + (i << 3))), bswap));
+   }
+
+   /* fill W[16..79], four words per trip.  W[i+2] and W[i+3] need the
+    * Gamma1 of W[i] and W[i+1], so the low half is finished first and its
+    * Gamma1 folded into the high half */
+   for (i = 16; i < 80; i += 4) {
+      part = _mm256_loadu_si256((const __m256i *)&W[i - 16]);
+      part = _mm256_add_epi64(part, _mm256_loadu_si256((const __m256i *)&W[i - 7]));
+      part = _mm256_add_epi64(part, V4_GAMMA0(_mm256_loadu_si256((const __m256i *)&W[i - 15])));
+      g1   = V4_GAMMA1(_mm256_loadu_si256((const __m256i *)&W[i - 2]));  /* only the low two lanes are valid */
+      lo   = _mm_add_epi64(_mm256_castsi256_si128(part), _mm256_castsi256_si128(g1));
+      _mm_storeu_si128((__m128i *)&W[i], lo);
+      hi   = _mm_add_epi64(_mm256_extracti128_si256(part, 1), V2_GAMMA1(lo));
+      _mm_storeu_si128((__m128i *)&W[i + 2], hi);
+   }
+
+   /* the 80 rounds are one long dependency chain and stay scalar */
+   for (i = 0; i < 8; i++) {
+      S[i] = md->sha512.state[i];
+   }
+
+#define RND(a,b,c,d,e,f,g,h,i)                           \
+     t0 = h + Sigma1(e) + Ch(e, f, g) + K[i] + W[i];     \
+     t1 = Sigma0(a) + Maj(a, b, c);                      \
+     d += t0;                                            \
+     h  = t0 + t1;
+
+   for (i = 0; i < 80; i += 8) {
+      RND(S[0],S[1],S[2],S[3],S[4],S[5],S[6],S[7],i+0);
+      RND(S[7],S[0],S[1],S[2],S[3],S[4],S[5],S[6],i+1);
+      RND(S[6],S[7],S[0],S[1],S[2],S[3],S[4],S[5],i+2);
+      RND(S[5],S[6],S[7],S[0],S[1],S[2],S[3],S[4],i+3);
+      RND(S[4],S[5],S[6],S[7],S[0],S[1],S[2],S[3],i+4);
+      RND(S[3],S[4],S[5],S[6],S[7],S[0],S[1],S[2],i+5);
+      RND(S[2],S[3],S[4],S[5],S[6],S[7],S[0],S[1],i+6);
+      RND(S[1],S[2],S[3],S[4],S[5],S[6],S[7],S[0],i+7);
+   }
+#undef RND
+
+   /* feedback */
+   for (i = 0; i < 8; i++) {
+      md->sha512.state[i] = md->sha512.state[i] + S[i];
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(W, sizeof(W));
+   zeromem(S, sizeof(S));
+#endif
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
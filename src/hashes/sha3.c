@@ -25,6 +25,8 @@ const struct ltc_hash_descriptor sha3_224_desc =
    &sha3_process,
    &sha3_done,
    &sha3_224_test,
+   NULL,
+   NULL,
    NULL
 };
 
@@ -40,6 +42,8 @@ const struct ltc_hash_descriptor sha3_256_desc =
    &sha3_process,
    &sha3_done,
    &sha3_256_test,
+   NULL,
+   NULL,
    NULL
 };
 
@@ -55,6 +59,8 @@ const struct ltc_hash_descriptor sha3_384_desc =
    &sha3_process,
    &sha3_done,
    &sha3_384_test,
+   NULL,
+   NULL,
    NULL
 };
 
@@ -70,6 +76,8 @@ const struct ltc_hash_descriptor sha3_512_desc =
    &sha3_process,
    &sha3_done,
    &sha3_512_test,
+   NULL,
+   NULL,
    NULL
 };
 
@@ -91,6 +99,7 @@ static const ulong64 keccakf_rndc[24] = {
    CONST64(0x0000000080000001), CONST64(0x8000000080008008)
 };
 
+#ifdef LTC_SMALL_CODE
 static const unsigned keccakf_rotc[24] = {
    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
 };
@@ -98,6 +107,74 @@ static const unsigned keccakf_rotc[24] = {
 static const unsigned keccakf_piln[24] = {
    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
 };
+#endif
+
+#ifndef LTC_SMALL_CODE
+
+static void keccakf(ulong64 s[25])
+{
+   ulong64 b0, b1, b2, b3, b4, t;
+   int round;
+
+   for(round = 0; round < SHA3_KECCAK_ROUNDS; round++) {
+      /* Theta */
+      b0 = s[0] ^ s[5] ^ s[10] ^ s[15] ^ s[20];
+      b1 = s[1] ^ s[6] ^ s[11] ^ s[16] ^ s[21];
+      b2 = s[2] ^ s[7] ^ s[12] ^ s[17] ^ s[22];
+      b3 = s[3] ^ s[8] ^ s[13] ^ s[18] ^ s[23];
+      b4 = s[4] ^ s[9] ^ s[14] ^ s[19] ^ s[24];
+      t = b4 ^ ROL64(b1, 1); s[0] ^= t; s[5] ^= t; s[10] ^= t; s[15] ^= t; s[20] ^= t;
+      t = b0 ^ ROL64(b2, 1); s[1] ^= t; s[6] ^= t; s[11] ^= t; s[16] ^= t; s[21] ^= t;
+      t = b1 ^ ROL64(b3, 1); s[2] ^= t; s[7] ^= t; s[12] ^= t; s[17] ^= t; s[22] ^= t;
+      t = b2 ^ ROL64(b4, 1); s[3] ^= t; s[8] ^= t; s[13] ^= t; s[18] ^= t; s[23] ^= t;
+      t = b3 ^ ROL64(b0, 1); s[4] ^= t; s[9] ^= t; s[14] ^= t; s[19] ^= t; s[24] ^= t;
+
+      /* Rho Pi, the table walk from the rolled version written out so every
+       * index and rotation count is a constant */
+      t     = s[1];
+      s[1]  = ROL64(s[6],  44);
+      s[6]  = ROL64(s[9],  20);
+      s[9]  = ROL64(s[22], 61);
+      s[22] = ROL64(s[14], 39);
+      s[14] = ROL64(s[20], 18);
+      s[20] = ROL64(s[2],  62);
+      s[2]  = ROL64(s[12], 43);
+      s[12] = ROL64(s[13], 25);
+      s[13] = ROL64(s[19],  8);
+      s[19] = ROL64(s[23], 56);
+      s[23] = ROL64(s[15], 41);
+      s[15] = ROL64(s[4],  27);
+      s[4]  = ROL64(s[24], 14);
+      s[24] = ROL64(s[21],  2);
+      s[21] = ROL64(s[8],  55);
+      s[8]  = ROL64(s[16], 45);
+      s[16] = ROL64(s[5],  36);
+      s[5]  = ROL64(s[3],  28);
+      s[3]  = ROL64(s[18], 21);
+      s[18] = ROL64(s[17], 15);
+      s[17] = ROL64(s[11], 10);
+      s[11] = ROL64(s[7],   6);
+      s[7]  = ROL64(s[10],  3);
+      s[10] = ROL64(t,      1);
+
+      /* Chi */
+      b0 = s[0];  b1 = s[1];  b2 = s[2];  b3 = s[3];  b4 = s[4];
+      s[0]  ^= (~b1) & b2; s[1]  ^= (~b2) & b3; s[2]  ^= (~b3) & b4; s[3]  ^= (~b4) & b0; s[4]  ^= (~b0) & b1;
+      b0 = s[5];  b1 = s[6];  b2 = s[7];  b3 = s[8];  b4 = s[9];
+      s[5]  ^= (~b1) & b2; s[6]  ^= (~b2) & b3; s[7]  ^= (~b3) & b4; s[8]  ^= (~b4) & b0; s[9]  ^= (~b0) & b1;
+      b0 = s[10]; b1 = s[11]; b2 = s[12]; b3 = s[13]; b4 = s[14];
+      s[10] ^= (~b1) & b2; s[11] ^= (~b2) & b3; s[12] ^= (~b3) & b4; s[13] ^= (~b4) & b0; s[14] ^= (~b0) & b1;
+      b0 = s[15]; b1 = s[16]; b2 = s[17]; b3 = s[18]; b4 = s[19];
+      s[15] ^= (~b1) & b2; s[16] ^= (~b2) & b3; s[17] ^= (~b3) & b4; s[18] ^= (~b4) & b0; s[19] ^= (~b0) & b1;
+      b0 = s[20]; b1 = s[21]; b2 = s[22]; b3 = s[23]; b4 = s[24];
+      s[20] ^= (~b1) & b2; s[21] ^= (~b2) & b3; s[22] ^= (~b3) & b4; s[23] ^= (~b4) & b0; s[24] ^= (~b0) & b1;
+
+      /* Iota */
+      s[0] ^= keccakf_rndc[round];
+   }
+}
+
+#else /* LTC_SMALL_CODE */
 
 static void keccakf(ulong64 s[25])
 {
@@ -134,6 +211,8 @@ static void keccakf(ulong64 s[25])
    }
 }
 
+#endif /* LTC_SMALL_CODE */
+
 /* Public Inteface */
 
 int sha3_224_init(hash_state *md)
@@ -0,0 +1,220 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+  @file sha3_mb.c
+  Multi-buffer SHA-3/SHAKE absorption: four independent sponges in lock
+  step, one 64-bit lane per message
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_SHA3
+
+#ifdef LTC_SHA3_AVX2
+
+/* immintrin.h drags in AVX-512 headers that are not C90 clean */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+#define LTC_SHA3_AVX2_CALL __attribute__((target("avx2")))
+
+static const ulong64 keccakf_rndc[24] = {
+   CONST64(0x0000000000000001), CONST64(0x0000000000008082),
+   CONST64(0x800000000000808a), CONST64(0x8000000080008000),
+   CONST64(0x000000000000808b), CONST64(0x0000000080000001),
+   CONST64(0x8000000080008081), CONST64(0x8000000000008009),
+   CONST64(0x000000000000008a), CONST64(0x0000000000000088),
+   CONST64(0x0000000080008009), CONST64(0x000000008000000a),
+   CONST64(0x000000008000808b), CONST64(0x800000000000008b),
+   CONST64(0x8000000000008089), CONST64(0x8000000000008003),
+   CONST64(0x8000000000008002), CONST64(0x8000000000000080),
+   CONST64(0x000000000000800a), CONST64(0x800000008000000a),
+   CONST64(0x8000000080008081), CONST64(0x8000000000008080),
+   CONST64(0x0000000080000001), CONST64(0x8000000080008008)
+};
+
+static const unsigned keccakf_rotc[24] = {
+   1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+
+static const unsigned keccakf_piln[24] = {
+   10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+static int _sha3_avx2_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_AVX2) != 0;
+}
+
+#define V_ROL64(x, n) _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - (n)))
+
+/* absorb nblocks rate-sized blocks into four sponges at once; p[l] points at
+ * lane l's data and every lane is at a block boundary */
+LTC_SHA3_AVX2_CALL
+static void _sha3_mb_blocks4(hash_state *md, const unsigned char **p, unsigned long nblocks, int rate_words)
+{
+   __m256i st[25], bc[5], t;
+   ulong64 w0, w1, w2, w3, outw[4];
+   unsigned long blk, off;
+   int i, j, l, round;
+
+   for (i = 0; i < 25; i++) {
+      st[i] = _mm256_set_epi64x((long long)md[3].sha3.s[i], (long long)md[2].sha3.s[i],
+                                (long long)md[1].sha3.s[i], (long long)md[0].sha3.s[i]);
+   }
+
+   for (blk = 0; blk < nblocks; blk++) {
+      /* gather one rate worth of little endian words per lane */
+      off = blk * ((unsigned long)rate_words << 3);
+      for (i = 0; i < rate_words; i++) {
+         LOAD64L(w0, p[0] + off + ((unsigned long)i << 3));
+         LOAD64L(w1, p[1] + off + ((unsigned long)i << 3));
+         LOAD64L(w2, p[2] + off + ((unsigned long)i << 3));
+         LOAD64L(w3, p[3] + off + ((unsigned long)i << 3));
+         st[i] = _mm256_xor_si256(st[i], _mm256_set_epi64x((long long)w3, (long long)w2,
+                                                           (long long)w1, (long long)w0));
+      }
+
+      /* Keccak-f[1600], the rolled sha3.c loops lifted to 64-bit lanes */
+      for (round = 0; round < 24; round++) {
+         /* Theta */
+         for (i = 0; i < 5; i++) {
+            bc[i] = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(st[i], st[i + 5]),
+                                                      _mm256_xor_si256(st[i + 10], st[i + 15])), st[i + 20]);
+         }
+         for (i = 0; i < 5; i++) {
+            t = _mm256_xor_si256(bc[(i + 4) % 5], V_ROL64(bc[(i + 1) % 5], 1));
+            for (j = 0; j < 25; j += 5) {
+               st[j + i] = _mm256_xor_si256(st[j + i], t);
+            }
+         }
+         /* Rho Pi */
+         t = st[1];
+         for (i = 0; i < 24; i++) {
+            j = (int)keccakf_piln[i];
+            bc[0] = st[j];
+            st[j] = V_ROL64(t, (int)keccakf_rotc[i]);
+            t = bc[0];
+         }
+         /* Chi */
+         for (j = 0; j < 25; j += 5) {
+            for (i = 0; i < 5; i++) {
+               bc[i] = st[j + i];
+            }
+            for (i = 0; i < 5; i++) {
+               st[j + i] = _mm256_xor_si256(st[j + i], _mm256_andnot_si256(bc[(i + 1) % 5], bc[(i + 2) % 5]));
+            }
+         }
+         /* Iota */
+         st[0] = _mm256_xor_si256(st[0], _mm256_set1_epi64x((long long)keccakf_rndc[round]));
+      }
+   }
+
+   for (i = 0; i < 25; i++) {
+      _mm256_storeu_si256((__m256i *)outw, st[i]);
+      for (l = 0; l < 4; l++) {
+         md[l].sha3.s[i] = outw[l];
+      }
+   }
+}
+
+#endif /* LTC_SHA3_AVX2 */
+
+/**
+   Process one buffer per lane through independent SHA-3/SHAKE states.
+   The lanes are ordinary states made with sha3_224_init and friends and
+   finished with sha3_done/sha3_shake_done; the result per lane is
+   identical to calling sha3_process(&md[l], in[l], inlen[l]).  Full
+   groups of four lanes with the same capacity are absorbed through the
+   vector units together when the CPU allows it.
+   @param md     Array of hash states
+   @param in     One input buffer per lane
+   @param inlen  The length of each input buffer (octets)
+   @param lanes  Number of lanes
+   @return CRYPT_OK if successful
+*/
+int sha3_mb_process(hash_state *md, const unsigned char **in, const unsigned long *inlen, int lanes)
+{
+   unsigned long off[4], n, rate;
+   int base, g, l, err;
+
+   LTC_ARGCHK(md    != NULL);
+   LTC_ARGCHK(in    != NULL || lanes == 0);
+   LTC_ARGCHK(inlen != NULL || lanes == 0);
+   LTC_ARGCHK(lanes >= 0);
+
+   for (base = 0; base < lanes; base += g) {
+      g = MIN(4, lanes - base);
+      for (l = 0; l < g; l++) {
+         off[l] = 0;
+      }
+
+      /* drain partially absorbed blocks so every lane is block aligned */
+      for (l = 0; l < g; l++) {
+         rate = (25 - (unsigned long)md[base + l].sha3.capacity_words) << 3;
+         n = ((unsigned long)md[base + l].sha3.word_index << 3) + md[base + l].sha3.byte_index;
+         if (n > 0) {
+            n = MIN(rate - n, inlen[base + l]);
+            if ((err = sha3_process(&md[base + l], in[base + l], n)) != CRYPT_OK) {
+               return err;
+            }
+            off[l] = n;
+         }
+      }
+
+#ifdef LTC_SHA3_AVX2
+      if (g == 4 && _sha3_avx2_enabled() &&
+          md[base + 1].sha3.capacity_words == md[base].sha3.capacity_words &&
+          md[base + 2].sha3.capacity_words == md[base].sha3.capacity_words &&
+          md[base + 3].sha3.capacity_words == md[base].sha3.capacity_words) {
+         const unsigned char *p[4];
+         unsigned long common, blocks;
+         int ok;
+
+         rate = (25 - (unsigned long)md[base].sha3.capacity_words) << 3;
+         common = (unsigned long)-1;
+         ok     = 1;
+         for (l = 0; l < 4; l++) {
+            if (md[base + l].sha3.word_index != 0 || md[base + l].sha3.byte_index != 0) {
+               ok = 0; /* lane ran out of data mid-block above */
+               break;
+            }
+            blocks = (inlen[base + l] - off[l]) / rate;
+            common = MIN(common, blocks);
+            p[l]   = in[base + l] + off[l];
+         }
+         if (ok && common > 0) {
+            _sha3_mb_blocks4(&md[base], p, common, (int)(rate >> 3));
+            for (l = 0; l < 4; l++) {
+               off[l] += common * rate;
+            }
+         }
+      }
+#endif
+
+      /* whatever is left runs through the ordinary path */
+      for (l = 0; l < g; l++) {
+         if (inlen[base + l] > off[l]) {
+            if ((err = sha3_process(&md[base + l], in[base + l] + off[l], inlen[base + l] - off[l])) != CRYPT_OK) {
+               return err;
+            }
+         }
+      }
+   }
+
+   return CRYPT_OK;
+}
+
+#endif /* LTC_SHA3 */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
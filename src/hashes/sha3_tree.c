@@ -0,0 +1,349 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+  @file sha3_tree.c
+  Tree-hashed SHAKE XOF, by Tom St Denis
+
+  A depth-1 tree over SHAKE128/256 for stream fingerprinting: the
+  input is cut into fixed LTC_SHAKE_TREE_CHUNK leaves, each leaf is an
+  independent SHAKE permutation squeezed to a chaining value, and a
+  root SHAKE absorbs a header, the chaining values in order and the
+  total length, then squeezes the output like any XOF.
+
+  Leaves never depend on each other, so shake_tree_memory() can fan
+  the leaf work out across threads (LTC_SHAKE_TREE_CONCURRENT, opt-in
+  like LTC_RSA_CRT_CONCURRENT) and still produce, octet for octet, the
+  digest of the single-threaded streaming path.  The digest does NOT
+  match flat SHAKE over the same data -- the tree is its own mode.
+*/
+
+#include "tomcrypt.h"
+
+#ifdef LTC_SHAKE_TREE
+
+#ifdef LTC_SHAKE_TREE_CONCURRENT
+#include <pthread.h>
+#endif
+
+/* chaining value length: twice the SHAKE security level */
+#define CVLEN(num) ((num) == 128 ? 32UL : 64UL)
+
+/* finalize the current leaf into the root and restart it */
+static int s_flush_leaf(shake_tree_state *st)
+{
+   unsigned char cv[64];
+   int err;
+
+   if ((err = sha3_shake_done(&st->leaf, cv, CVLEN(st->num)))        != CRYPT_OK ||
+       (err = sha3_shake_process(&st->root, cv, CVLEN(st->num)))     != CRYPT_OK ||
+       (err = sha3_shake_init(&st->leaf, st->num))                   != CRYPT_OK) {
+      return err;
+   }
+   st->leaf_fill = 0;
+   st->leaf_count++;
+   return CRYPT_OK;
+}
+
+/**
+  Initialize a tree-SHAKE state
+  @param st    The state to initialize
+  @param num   The SHAKE variant (128 or 256)
+  @return CRYPT_OK on success
+*/
+int shake_tree_init(shake_tree_state *st, int num)
+{
+   unsigned char hdr[8];
+   int err;
+
+   LTC_ARGCHK(st != NULL);
+   if (num != 128 && num != 256) {
+      return CRYPT_INVALID_ARG;
+   }
+   st->num        = num;
+   st->leaf_fill  = 0;
+   st->leaf_count = 0;
+   st->totlen     = 0;
+   st->squeezing  = 0;
+   if ((err = sha3_shake_init(&st->leaf, num)) != CRYPT_OK ||
+       (err = sha3_shake_init(&st->root, num)) != CRYPT_OK) {
+      return err;
+   }
+   /* header pins the mode and geometry into the digest */
+   XMEMCPY(hdr, "LTCTREE", 7);
+   hdr[7] = (num == 128) ? 1 : 2;
+   if ((err = sha3_shake_process(&st->root, hdr, 8)) != CRYPT_OK) {
+      return err;
+   }
+   STORE32L((ulong32)LTC_SHAKE_TREE_CHUNK, hdr);
+   return sha3_shake_process(&st->root, hdr, 4);
+}
+
+/**
+  Absorb data into a tree-SHAKE state
+  @param st     The state
+  @param in     The data to absorb
+  @param inlen  The length of the data (octets)
+  @return CRYPT_OK on success
+*/
+int shake_tree_process(shake_tree_state *st, const unsigned char *in, unsigned long inlen)
+{
+   unsigned long n;
+   int err;
+
+   if (inlen == 0) return CRYPT_OK;
+   LTC_ARGCHK(st != NULL);
+   LTC_ARGCHK(in != NULL);
+   if (st->squeezing) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   while (inlen > 0) {
+      n = MIN(inlen, LTC_SHAKE_TREE_CHUNK - st->leaf_fill);
+      if ((err = sha3_shake_process(&st->leaf, in, n)) != CRYPT_OK) {
+         return err;
+      }
+      st->leaf_fill += n;
+      st->totlen    += n;
+      in    += n;
+      inlen -= n;
+      if (st->leaf_fill == LTC_SHAKE_TREE_CHUNK) {
+         if ((err = s_flush_leaf(st)) != CRYPT_OK) {
+            return err;
+         }
+      }
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Squeeze output from a tree-SHAKE state; callable any number of times,
+  the first call finalizes the tree
+  @param st      The state
+  @param out     [out] The output
+  @param outlen  The number of octets to squeeze
+  @return CRYPT_OK on success
+*/
+int shake_tree_squeeze(shake_tree_state *st, unsigned char *out, unsigned long outlen)
+{
+   unsigned char buf[8];
+   int err;
+
+   LTC_ARGCHK(st != NULL);
+
+   if (!st->squeezing) {
+      /* a trailing partial leaf -- or the only, empty, leaf -- still counts */
+      if (st->leaf_fill > 0 || st->leaf_count == 0) {
+         if ((err = s_flush_leaf(st)) != CRYPT_OK) {
+            return err;
+         }
+      }
+      STORE64L(st->totlen, buf);
+      if ((err = sha3_shake_process(&st->root, buf, 8)) != CRYPT_OK) {
+         return err;
+      }
+      st->squeezing = 1;
+   }
+   return sha3_shake_done(&st->root, out, outlen);
+}
+
+#ifdef LTC_SHAKE_TREE_CONCURRENT
+/* a worker owns a contiguous run of full leaves; self-contained so it
+ * can run via pthread_create */
+struct shake_tree_job {
+   int                  num;
+   const unsigned char *in;
+   unsigned char       *cv;       /* cvlen octets per leaf */
+   unsigned long        nleaves;
+   int                  err;
+};
+
+static void *s_shake_tree_worker(void *arg)
+{
+   struct shake_tree_job *j = arg;
+   unsigned long i, cvlen = CVLEN(j->num);
+   hash_state md;
+   int err;
+
+   for (i = 0; i < j->nleaves; i++) {
+      if ((err = sha3_shake_init(&md, j->num)) != CRYPT_OK ||
+          (err = sha3_shake_process(&md, j->in + i * LTC_SHAKE_TREE_CHUNK,
+                                    LTC_SHAKE_TREE_CHUNK)) != CRYPT_OK ||
+          (err = sha3_shake_done(&md, j->cv + i * cvlen, cvlen)) != CRYPT_OK) {
+         j->err = err;
+         return NULL;
+      }
+   }
+   j->err = CRYPT_OK;
+   return NULL;
+}
+#endif
+
+/**
+  Tree-SHAKE a buffer in one call; with LTC_SHAKE_TREE_CONCURRENT the
+  leaves run on LTC_SHAKE_TREE_THREADS threads, with the identical
+  digest either way
+  @param num     The SHAKE variant (128 or 256)
+  @param in      The data to hash
+  @param inlen   The length of the data (octets)
+  @param out     [out] The output
+  @param outlen  The number of octets to squeeze
+  @return CRYPT_OK on success
+*/
+int shake_tree_memory(int num, const unsigned char *in, unsigned long inlen,
+                      unsigned char *out, unsigned long outlen)
+{
+   shake_tree_state st;
+   int err;
+
+   LTC_ARGCHK(out != NULL);
+   if (inlen > 0) {
+      LTC_ARGCHK(in != NULL);
+   }
+
+   if ((err = shake_tree_init(&st, num)) != CRYPT_OK) {
+      return err;
+   }
+
+#ifdef LTC_SHAKE_TREE_CONCURRENT
+   if (inlen >= 2 * LTC_SHAKE_TREE_CHUNK) {
+      struct shake_tree_job job[LTC_SHAKE_TREE_THREADS];
+      pthread_t             tid[LTC_SHAKE_TREE_THREADS];
+      int                   spawned[LTC_SHAKE_TREE_THREADS];
+      unsigned char        *cv;
+      unsigned long         nleaves, cvlen, base, extra, off, x;
+      int                   t, nt;
+
+      nleaves = inlen / LTC_SHAKE_TREE_CHUNK;
+      cvlen   = CVLEN(num);
+      cv      = XMALLOC(nleaves * cvlen);
+      if (cv == NULL) {
+         return CRYPT_MEM;
+      }
+      nt    = (nleaves < LTC_SHAKE_TREE_THREADS) ? (int)nleaves : LTC_SHAKE_TREE_THREADS;
+      base  = nleaves / nt;
+      extra = nleaves % nt;
+      off   = 0;
+      for (t = 0; t < nt; t++) {
+         job[t].num     = num;
+         job[t].in      = in + off * LTC_SHAKE_TREE_CHUNK;
+         job[t].cv      = cv + off * cvlen;
+         job[t].nleaves = base + ((unsigned long)t < extra ? 1 : 0);
+         job[t].err     = CRYPT_OK;
+         off += job[t].nleaves;
+         spawned[t] = (t > 0) &&
+                      (pthread_create(&tid[t], NULL, s_shake_tree_worker, &job[t]) == 0);
+      }
+      s_shake_tree_worker(&job[0]);
+      for (t = 1; t < nt; t++) {
+         if (spawned[t]) {
+            pthread_join(tid[t], NULL);
+         } else {
+            s_shake_tree_worker(&job[t]);
+         }
+      }
+      err = CRYPT_OK;
+      for (t = 0; t < nt; t++) {
+         if (job[t].err != CRYPT_OK) {
+            err = job[t].err;
+         }
+      }
+      if (err == CRYPT_OK) {
+         /* feed the precomputed chaining values straight to the root */
+         for (x = 0; x < nleaves; x++) {
+            if ((err = sha3_shake_process(&st.root, cv + x * cvlen, cvlen)) != CRYPT_OK) {
+               break;
+            }
+         }
+         st.leaf_count = nleaves;
+         st.totlen     = nleaves * LTC_SHAKE_TREE_CHUNK;
+      }
+      XFREE(cv);
+      if (err != CRYPT_OK) {
+         return err;
+      }
+      in    += nleaves * LTC_SHAKE_TREE_CHUNK;
+      inlen -= nleaves * LTC_SHAKE_TREE_CHUNK;
+   }
+#endif
+
+   if ((err = shake_tree_process(&st, in, inlen)) != CRYPT_OK) {
+      return err;
+   }
+   return shake_tree_squeeze(&st, out, outlen);
+}
+
+/**
+  Test the tree-SHAKE construction
+  @return CRYPT_OK on success
+*/
+int shake_tree_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   unsigned char    *msg, out1[64], out2[64], out3[32];
+   shake_tree_state  st;
+   unsigned long     x, n;
+   int               err;
+
+   n = 3 * LTC_SHAKE_TREE_CHUNK + 123;   /* full leaves plus a tail */
+   msg = XMALLOC(n);
+   if (msg == NULL) {
+      return CRYPT_MEM;
+   }
+   for (x = 0; x < n; x++) {
+      msg[x] = (unsigned char)(x * 7 + 1);
+   }
+
+   /* streaming in awkward chunk sizes must match the one-shot */
+   if ((err = shake_tree_memory(256, msg, n, out1, sizeof(out1))) != CRYPT_OK) {
+      goto error;
+   }
+   if ((err = shake_tree_init(&st, 256)) != CRYPT_OK) {
+      goto error;
+   }
+   for (x = 0; x < n; x += 997) {
+      if ((err = shake_tree_process(&st, msg + x, MIN(997, n - x))) != CRYPT_OK) {
+         goto error;
+      }
+   }
+   /* split squeeze must match the flat squeeze */
+   if ((err = shake_tree_squeeze(&st, out2, 13))                   != CRYPT_OK ||
+       (err = shake_tree_squeeze(&st, out2 + 13, sizeof(out2) - 13)) != CRYPT_OK) {
+      goto error;
+   }
+   if (compare_testvector(out2, sizeof(out2), out1, sizeof(out1), "SHAKE-TREE", 0) != 0) {
+      err = CRYPT_FAIL_TESTVECTOR;
+      goto error;
+   }
+
+   /* 128 and 256 must separate, and the empty message must work */
+   if ((err = shake_tree_memory(128, msg, n, out3, sizeof(out3))) != CRYPT_OK) {
+      goto error;
+   }
+   if (XMEMCMP(out3, out1, sizeof(out3)) == 0) {
+      err = CRYPT_FAIL_TESTVECTOR;
+      goto error;
+   }
+   if ((err = shake_tree_memory(256, NULL, 0, out1, sizeof(out1))) != CRYPT_OK) {
+      goto error;
+   }
+   err = CRYPT_OK;
+error:
+   XFREE(msg);
+   return err;
+#endif
+}
+
+#endif /* LTC_SHAKE_TREE */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
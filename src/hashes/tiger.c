@@ -33,6 +33,8 @@ const struct ltc_hash_descriptor tiger_desc =
     &tiger_process,
     &tiger_done,
     &tiger_test,
+    NULL,
+    NULL,
     NULL
 };
 
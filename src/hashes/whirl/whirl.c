@@ -33,6 +33,8 @@ const struct ltc_hash_descriptor whirlpool_desc =
     &whirlpool_process,
     &whirlpool_done,
     &whirlpool_test,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -54,11 +56,26 @@ const struct ltc_hash_descriptor whirlpool_desc =
     SB6(GB(a, i-6, 1)) ^                 \
     SB7(GB(a, i-7, 0)))
 
-#ifdef LTC_CLEAN_STACK
-static int _whirlpool_compress(hash_state *md, unsigned char *buf)
-#else
-static int whirlpool_compress(hash_state *md, unsigned char *buf)
-#endif
+#ifndef LTC_SMALL_CODE
+
+/* cache compact variant: only sbox0's 2KB are touched, the other seven
+ * tables are its rotations */
+#define theta_pi_gamma_compact(a, i)             \
+   (sbox0[GB(a, i-0, 7)] ^                       \
+    ROR64c(sbox0[GB(a, i-1, 6)],  8) ^           \
+    ROR64c(sbox0[GB(a, i-2, 5)], 16) ^           \
+    ROR64c(sbox0[GB(a, i-3, 4)], 24) ^           \
+    ROR64c(sbox0[GB(a, i-4, 3)], 32) ^           \
+    ROR64c(sbox0[GB(a, i-5, 2)], 40) ^           \
+    ROR64c(sbox0[GB(a, i-6, 1)], 48) ^           \
+    ROR64c(sbox0[GB(a, i-7, 0)], 56))
+
+/* when set, compress through the single table variant; trades a little
+ * throughput for a 2KB instead of 16KB L1 footprint when Whirlpool runs
+ * next to other table driven kernels */
+static int whirlpool_compact = 0;
+
+static int _whirlpool_compress_compact(hash_state *md, unsigned char *buf)
 {
    ulong64 K[2][8], T[3][8];
    int x, y;
@@ -77,27 +94,114 @@ static int whirlpool_compress(hash_state *md, unsigned char *buf)
        /* odd round */
        /* apply main transform to K[0] into K[1] */
        for (y = 0; y < 8; y++) {
-           K[1][y] = theta_pi_gamma(K[0], y);
+           K[1][y] = theta_pi_gamma_compact(K[0], y);
        }
        /* xor the constant */
        K[1][0] ^= cont[x];
 
        /* apply main transform to T[0] into T[1] */
        for (y = 0; y < 8; y++) {
-           T[1][y] = theta_pi_gamma(T[0], y) ^ K[1][y];
+           T[1][y] = theta_pi_gamma_compact(T[0], y) ^ K[1][y];
        }
 
        /* even round */
        /* apply main transform to K[1] into K[0] */
        for (y = 0; y < 8; y++) {
-           K[0][y] = theta_pi_gamma(K[1], y);
+           K[0][y] = theta_pi_gamma_compact(K[1], y);
        }
        /* xor the constant */
        K[0][0] ^= cont[x+1];
 
        /* apply main transform to T[1] into T[0] */
        for (y = 0; y < 8; y++) {
-           T[0][y] = theta_pi_gamma(T[1], y) ^ K[0][y];
+           T[0][y] = theta_pi_gamma_compact(T[1], y) ^ K[0][y];
+       }
+   }
+
+   /* store state */
+   for (x = 0; x < 8; x++) {
+      md->whirlpool.state[x] ^= T[0][x] ^ T[2][x];
+   }
+
+   return CRYPT_OK;
+}
+
+#endif /* LTC_SMALL_CODE */
+
+/**
+   Select the cache compact Whirlpool compression function.  With
+   LTC_SMALL_CODE the single table variant is the only one compiled and
+   this call has no effect.
+   @param enable  Nonzero to compress through the 2KB table, zero for the
+                  full 16KB tables
+   @return The previous setting
+*/
+int whirlpool_compact_mode(int enable)
+{
+#ifdef LTC_SMALL_CODE
+   LTC_UNUSED_PARAM(enable);
+   return 1;
+#else
+   int prev = whirlpool_compact;
+   whirlpool_compact = enable ? 1 : 0;
+   return prev;
+#endif
+}
+
+#ifdef LTC_CLEAN_STACK
+static int _whirlpool_compress(hash_state *md, unsigned char *buf)
+#else
+static int whirlpool_compress(hash_state *md, unsigned char *buf)
+#endif
+{
+   ulong64 K[2][8], T[3][8];
+   int x, y;
+
+#ifndef LTC_SMALL_CODE
+   if (whirlpool_compact) {
+      return _whirlpool_compress_compact(md, buf);
+   }
+#endif
+
+   /* pull the next message block in while this one runs; harmless past
+    * the end of the buffer, prefetch never faults */
+   LTC_PREFETCH_R(buf +  64);
+   LTC_PREFETCH_R(buf + 127);
+
+   /* load the block/state */
+   for (x = 0; x < 8; x++) {
+      K[0][x] = md->whirlpool.state[x];
+
+      LOAD64H(T[0][x], buf + (8 * x));
+      T[2][x]  = T[0][x];
+      T[0][x] ^= K[0][x];
+   }
+
+   /* do rounds 1..10.  The key-schedule and data lanes of one round are
+    * independent, so they run interleaved: sixteen 8-load streams in
+    * flight per iteration instead of eight, which is what
+    * memory-latency-bound cores want.  The round constant and the
+    * K-into-T xor are applied after the lookups so the interleave does
+    * not change the result. */
+   for (x = 0; x < 10; x += 2) {
+       /* odd round */
+       for (y = 0; y < 8; y++) {
+           K[1][y] = theta_pi_gamma(K[0], y);
+           T[1][y] = theta_pi_gamma(T[0], y);
+       }
+       K[1][0] ^= cont[x];
+       for (y = 0; y < 8; y++) {
+           T[1][y] ^= K[1][y];
+       }
+
+       /* even round */
+       for (y = 0; y < 8; y++) {
+           K[0][y] = theta_pi_gamma(K[1], y);
+           T[0][y] = theta_pi_gamma(T[1], y);
+       }
+       K[0][0] ^= cont[x+1];
+       for (y = 0; y < 8; y++) {
+           T[0][y] ^= K[0][y];
        }
    }
 
@@ -223,6 +223,24 @@ typedef ulong64 ltc_mp_digit;
 typedef ulong32 ltc_mp_digit;
 #endif
 
+/* cache-line alignment for in-struct lookup tables (GCM/LRW PC tables);
+ * placed before the member declaration */
+#if defined(__GNUC__) || defined(__clang__)
+   #define LTC_TABLE_ALIGN __attribute__((aligned(64)))
+#elif defined(_MSC_VER)
+   #define LTC_TABLE_ALIGN __declspec(align(64))
+#else
+   #define LTC_TABLE_ALIGN
+#endif
+
+/* read prefetch hint for table-driven primitives; a no-op where the
+ * compiler offers nothing */
+#if defined(__GNUC__) || defined(__clang__)
+   #define LTC_PREFETCH_R(p) __builtin_prefetch((const void *)(p), 0, 3)
+#else
+   #define LTC_PREFETCH_R(p)
+#endif
+
 /* No asm is a quick way to disable anything "not portable" */
 #ifdef LTC_NO_ASM
    #define ENDIAN_NEUTRAL
@@ -34,6 +34,9 @@ struct saferp_key {
 struct rijndael_key {
    ulong32 eK[60], dK[60];
    int Nr;
+#ifdef LTC_AES_COMPACT
+   int compact;
+#endif
 };
 #endif
 
@@ -61,6 +64,10 @@ struct xtea_key {
 #ifndef LTC_TWOFISH_SMALL
    struct twofish_key {
       ulong32 S[4][256], K[40];
+      /* key material for the on-the-fly path plus a flag saying whether
+       * the big tables above were built (see twofish_setup_ex) */
+      unsigned char SK[32], start;
+      int tabs;
    };
 #else
    struct twofish_key {
@@ -207,6 +214,12 @@ typedef union Symmetric_key {
    void   *data;
 } symmetric_key;
 
+/* tag stored by the *_start() of a chaining mode once its state has
+   been validated; per-call state checks are skipped while the tag is
+   intact.  Hand-built states should leave the field zero to keep the
+   full per-call checking. */
+#define LTC_STATE_SEALED 0x5EA1EDUL
+
 #ifdef LTC_ECB_MODE
 /** A block cipher ECB structure */
 typedef struct {
@@ -214,6 +227,8 @@ typedef struct {
    int                 cipher,
    /** The block size of the given cipher */
                        blocklen;
+   /** LTC_STATE_SEALED once validated by ecb_start() */
+   unsigned long       sealed;
    /** The scheduled key */
    symmetric_key       key;
 } symmetric_ECB;
@@ -262,6 +277,8 @@ typedef struct {
                        blocklen;
    /** The current IV */
    unsigned char       IV[MAXBLOCKSIZE];
+   /** LTC_STATE_SEALED once validated by cbc_start() */
+   unsigned long       sealed;
    /** The scheduled key */
    symmetric_key       key;
 } symmetric_CBC;
@@ -269,6 +286,9 @@ typedef struct {
 
 
 #ifdef LTC_CTR_MODE
+/* keystream blocks held in the optional CTR lookahead window */
+#define LTC_CTR_LOOKAHEAD_BLOCKS 8
+
 /** A block cipher CTR structure */
 typedef struct {
    /** The index of the cipher chosen */
@@ -280,12 +300,22 @@ typedef struct {
    /** The mode (endianess) of the CTR, 0==little, 1==big */
                        mode,
    /** counter width */
-                       ctrlen;
+                       ctrlen,
+   /** nonzero when keystream lookahead was requested (LTC_CTR_PREFETCH) */
+                       lookahead_on,
+   /** read offset into the lookahead window */
+                       lookahead_off,
+   /** unconsumed octets in the lookahead window */
+                       lookahead_len;
 
    /** The counter */
    unsigned char       ctr[MAXBLOCKSIZE],
    /** The pad used to encrypt/decrypt */
-                       pad[MAXBLOCKSIZE];
+                       pad[MAXBLOCKSIZE],
+   /** Keystream generated ahead of consumption */
+                       lookahead[LTC_CTR_LOOKAHEAD_BLOCKS * MAXBLOCKSIZE];
+   /** LTC_STATE_SEALED once validated by ctr_start() */
+   unsigned long       sealed;
    /** The scheduled key */
    symmetric_key       key;
 } symmetric_CTR;
@@ -310,9 +340,14 @@ typedef struct {
     /** The scheduled symmetric key */
     symmetric_key     key;
 
+#ifdef LTC_GF_CLMUL
+    /** nonzero when the carry-less multiply backend serves this key */
+    int               clmul;
+#endif
+
 #ifdef LTC_LRW_TABLES
     /** The pre-computed multiplication table */
-    unsigned char     PC[16][256][16];
+    LTC_TABLE_ALIGN unsigned char PC[16][256][16];
 #endif
 } symmetric_LRW;
 #endif
@@ -676,10 +711,66 @@ int rijndael_enc_setup(const unsigned char *key, int keylen, int num_rounds, sym
 int rijndael_enc_ecb_encrypt(const unsigned char *pt, unsigned char *ct, symmetric_key *skey);
 void rijndael_enc_done(symmetric_key *skey);
 int rijndael_enc_keysize(int *keysize);
+
+#ifdef LTC_AES_NI
+int rijndael_aesni_enabled(void);
+void rijndael_aesni_setup(symmetric_key *skey);
+void rijndael_aesni_ecb_encrypt(const unsigned char *pt, unsigned char *ct, const symmetric_key *skey);
+void rijndael_aesni_ecb_decrypt(const unsigned char *ct, unsigned char *pt, const symmetric_key *skey);
+int rijndael_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey);
+int rijndael_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey);
+int rijndael_accel_cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, symmetric_key *skey);
+#endif
+
+#ifdef LTC_AES_KEYCACHE
+int rijndael_keycache_lookup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey);
+void rijndael_keycache_store(const unsigned char *key, int keylen, int num_rounds, const symmetric_key *skey);
+void rijndael_keycache_flush(void);
+#endif
+
+#ifdef LTC_AES_BITSLICE
+int rijndael_bitslice_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey);
+#endif
+
+#ifdef LTC_AES_COMPACT
+int rijndael_setup_compact(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey);
+int rijndael_compact_ecb_encrypt(const unsigned char *pt, unsigned char *ct, const symmetric_key *skey);
+int rijndael_compact_ecb_decrypt(const unsigned char *ct, unsigned char *pt, const symmetric_key *skey);
+#endif
+
+#ifdef LTC_AES_ARMV8
+int rijndael_armv8_enabled(void);
+void rijndael_armv8_setup(symmetric_key *skey);
+void rijndael_armv8_ecb_encrypt(const unsigned char *pt, unsigned char *ct, const symmetric_key *skey);
+void rijndael_armv8_ecb_decrypt(const unsigned char *ct, unsigned char *pt, const symmetric_key *skey);
+#endif
+
 extern const struct ltc_cipher_descriptor rijndael_desc, aes_desc;
 extern const struct ltc_cipher_descriptor rijndael_enc_desc, aes_enc_desc;
 #endif
 
+/* The modes of operation call the block cipher through these macros.  By
+ * default that is the usual cipher_descriptor[] indirection; with
+ * LTC_STATIC_AES the AES entry points are bound at compile time (behind a
+ * cheap, well-predicted pointer compare so other registered ciphers keep
+ * working), which lets the compiler inline the cipher into the mode loop
+ * when building with LTO. */
+#if defined(LTC_STATIC_AES) && defined(LTC_RIJNDAEL)
+   #define LTC_CIPHER_ECB_ENCRYPT(cipher, pt, ct, skey)                    \
+      ((cipher_descriptor[cipher].ecb_encrypt == rijndael_ecb_encrypt)     \
+         ? rijndael_ecb_encrypt(pt, ct, skey)                              \
+         : cipher_descriptor[cipher].ecb_encrypt(pt, ct, skey))
+   #define LTC_CIPHER_ECB_DECRYPT(cipher, ct, pt, skey)                    \
+      ((cipher_descriptor[cipher].ecb_decrypt == rijndael_ecb_decrypt)     \
+         ? rijndael_ecb_decrypt(ct, pt, skey)                              \
+         : cipher_descriptor[cipher].ecb_decrypt(ct, pt, skey))
+#else
+   #define LTC_CIPHER_ECB_ENCRYPT(cipher, pt, ct, skey)                    \
+      cipher_descriptor[cipher].ecb_encrypt(pt, ct, skey)
+   #define LTC_CIPHER_ECB_DECRYPT(cipher, ct, pt, skey)                    \
+      cipher_descriptor[cipher].ecb_decrypt(ct, pt, skey)
+#endif
+
 #ifdef LTC_XTEA
 int xtea_setup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey);
 int xtea_ecb_encrypt(const unsigned char *pt, unsigned char *ct, symmetric_key *skey);
@@ -692,6 +783,7 @@ extern const struct ltc_cipher_descriptor xtea_desc;
 
 #ifdef LTC_TWOFISH
 int twofish_setup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey);
+int twofish_setup_ex(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey, int build_tabs);
 int twofish_ecb_encrypt(const unsigned char *pt, unsigned char *ct, symmetric_key *skey);
 int twofish_ecb_decrypt(const unsigned char *ct, unsigned char *pt, symmetric_key *skey);
 int twofish_test(void);
@@ -713,6 +805,8 @@ int des3_ecb_decrypt(const unsigned char *ct, unsigned char *pt, symmetric_key *
 int des3_test(void);
 void des3_done(symmetric_key *skey);
 int des3_keysize(int *keysize);
+int des3_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey);
+int des3_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey);
 extern const struct ltc_cipher_descriptor des_desc, des3_desc;
 #endif
 
@@ -780,6 +874,12 @@ extern const struct ltc_cipher_descriptor kseed_desc;
 int kasumi_setup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey);
 int kasumi_ecb_encrypt(const unsigned char *pt, unsigned char *ct, symmetric_key *skey);
 int kasumi_ecb_decrypt(const unsigned char *ct, unsigned char *pt, symmetric_key *skey);
+int kasumi_ecb_encrypt_packets(const unsigned char * const *pt, unsigned char * const *ct,
+                               unsigned long packets, unsigned long packet_len,
+                               symmetric_key *skey);
+int kasumi_ecb_decrypt_packets(const unsigned char * const *ct, unsigned char * const *pt,
+                               unsigned long packets, unsigned long packet_len,
+                               symmetric_key *skey);
 int kasumi_test(void);
 void kasumi_done(symmetric_key *skey);
 int kasumi_keysize(int *keysize);
@@ -791,6 +891,12 @@ extern const struct ltc_cipher_descriptor kasumi_desc;
 int multi2_setup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey);
 int multi2_ecb_encrypt(const unsigned char *pt, unsigned char *ct, symmetric_key *skey);
 int multi2_ecb_decrypt(const unsigned char *ct, unsigned char *pt, symmetric_key *skey);
+int multi2_ecb_encrypt_packets(const unsigned char * const *pt, unsigned char * const *ct,
+                               unsigned long packets, unsigned long packet_len,
+                               symmetric_key *skey);
+int multi2_ecb_decrypt_packets(const unsigned char * const *ct, unsigned char * const *pt,
+                               unsigned long packets, unsigned long packet_len,
+                               symmetric_key *skey);
 int multi2_test(void);
 void multi2_done(symmetric_key *skey);
 int multi2_keysize(int *keysize);
@@ -804,6 +910,8 @@ int camellia_ecb_decrypt(const unsigned char *ct, unsigned char *pt, symmetric_k
 int camellia_test(void);
 void camellia_done(symmetric_key *skey);
 int camellia_keysize(int *keysize);
+int camellia_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey);
+int camellia_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey);
 extern const struct ltc_cipher_descriptor camellia_desc;
 #endif
 
@@ -850,6 +958,7 @@ int cbc_done(symmetric_CBC *cbc);
 #define CTR_COUNTER_LITTLE_ENDIAN    0x0000
 #define CTR_COUNTER_BIG_ENDIAN       0x1000
 #define LTC_CTR_RFC3686              0x2000
+#define LTC_CTR_PREFETCH             0x4000
 
 int ctr_start(               int   cipher,
               const unsigned char *IV,
@@ -893,6 +1002,9 @@ int f8_start(                int  cipher, const unsigned char *IV,
                              int  num_rounds,   symmetric_F8  *f8);
 int f8_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, symmetric_F8 *f8);
 int f8_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long len, symmetric_F8 *f8);
+int f8_encrypt_packets(const unsigned char * const *pt, unsigned char * const *ct,
+                       const unsigned long *lens, const unsigned char * const *IVs,
+                       unsigned long packets, symmetric_F8 *f8);
 int f8_getiv(unsigned char *IV, unsigned long *len, symmetric_F8 *f8);
 int f8_setiv(const unsigned char *IV, unsigned long len, symmetric_F8 *f8);
 int f8_done(symmetric_F8 *f8);
@@ -900,9 +1012,14 @@ int f8_test_mode(void);
 #endif
 
 #ifdef LTC_XTS_MODE
+/* tweak values precomputed per trip through the XTS bulk path */
+#define LTC_XTS_BULK_BLOCKS 32
+
 typedef struct {
    symmetric_key  key1, key2;
    int            cipher;
+   /* scratch table of consecutive tweak values for the bulk path */
+   unsigned char  tweak_tab[16 * LTC_XTS_BULK_BLOCKS];
 } symmetric_xts;
 
 int xts_start(                int  cipher,
@@ -923,18 +1040,152 @@ int xts_decrypt(
          unsigned char *tweak,
          symmetric_xts *xts);
 
+int xts_encrypt_sectors(const unsigned char * const *pt, unsigned char * const *ct,
+                        unsigned long sectors, unsigned long sector_size,
+                        const ulong64 *sector_nums, symmetric_xts *xts);
+int xts_decrypt_sectors(const unsigned char * const *ct, unsigned char * const *pt,
+                        unsigned long sectors, unsigned long sector_size,
+                        const ulong64 *sector_nums, symmetric_xts *xts);
+
+/** Per-sector tweak policy for the _ex sector batches; fills the
+    16-octet tweak for one data unit (see xts_sectors_ex.c) */
+typedef int (*ltc_xts_tweak_fn)(ulong64 sector_num, unsigned char *tweak, void *ctx);
+
+/** ESSIV tweak policy context: the sector number is encrypted under a
+    digest of the disk key (dm-crypt style) */
+typedef struct {
+   symmetric_key K;
+   int           cipher;
+} ltc_xts_essiv;
+
+int xts_essiv_init(ltc_xts_essiv *essiv, int cipher, int hash,
+                   const unsigned char *key, unsigned long keylen);
+int xts_essiv_tweak(ulong64 sector_num, unsigned char *tweak, void *ctx);
+int xts_essiv_done(ltc_xts_essiv *essiv);
+
+int xts_encrypt_sectors_ex(const unsigned char * const *pt, unsigned char * const *ct,
+                           unsigned long sectors, unsigned long sector_size,
+                           const ulong64 *sector_nums,
+                           ltc_xts_tweak_fn tweak_fn, void *tweak_ctx,
+                           symmetric_xts *xts);
+int xts_decrypt_sectors_ex(const unsigned char * const *ct, unsigned char * const *pt,
+                           unsigned long sectors, unsigned long sector_size,
+                           const ulong64 *sector_nums,
+                           ltc_xts_tweak_fn tweak_fn, void *tweak_ctx,
+                           symmetric_xts *xts);
+
 void xts_done(symmetric_xts *xts);
 int  xts_test(void);
 void xts_mult_x(unsigned char *I);
 #endif
 
+/** One fragment of a scattered buffer (packet chains and the like); the
+    iovec-style AEAD entry points process these in place */
+typedef struct {
+   /** start of the fragment */
+   unsigned char *data;
+   /** length of the fragment (octets) */
+   unsigned long  len;
+} ltc_iovec;
+
+/* scatter-gather entry points for the symmetric modes; fragments are
+   processed in place and may split cipher blocks anywhere */
+#ifdef LTC_CTR_MODE
+int ctr_encrypt_v(const ltc_iovec *iov, int iovcnt, symmetric_CTR *ctr);
+int ctr_decrypt_v(const ltc_iovec *iov, int iovcnt, symmetric_CTR *ctr);
+#endif
+#ifdef LTC_CBC_MODE
+int cbc_encrypt_v(const ltc_iovec *iov, int iovcnt, symmetric_CBC *cbc);
+int cbc_decrypt_v(const ltc_iovec *iov, int iovcnt, symmetric_CBC *cbc);
+#endif
+#ifdef LTC_XTS_MODE
+int xts_encrypt_v(const ltc_iovec *iov, int iovcnt, unsigned char *tweak, symmetric_xts *xts);
+int xts_decrypt_v(const ltc_iovec *iov, int iovcnt, unsigned char *tweak, symmetric_xts *xts);
+#endif
+
+/** One slice of a buffer handed to the parallel-modes layer */
+typedef struct ltc_parallel_job {
+   /** worker to execute for this slice, set by the library */
+   int                  (*fn)(struct ltc_parallel_job *job);
+   /** input of the slice */
+   const unsigned char  *in;
+   /** output of the slice */
+   unsigned char        *out;
+   /** length of the slice (octets) */
+   unsigned long         len;
+   /** starting tweak of the slice (XTS only) */
+   unsigned char         tweak[16];
+   /** per-slice mode state, owned by the library */
+   void                 *state;
+   /** result of fn */
+   int                   err;
+} ltc_parallel_job;
+
+/** How to fan work out; the library computes the per-slice counter/tweak
+    offsets, the caller decides where the slices actually run */
+typedef struct {
+   /** opaque user context (e.g. a thread pool handle) passed to map */
+   void          *pool;
+   /** octets per slice, rounded up to the cipher block size (0 == 64KB) */
+   unsigned long  chunk_size;
+   /** execute every job to completion, in any order and on any threads,
+       by calling job->fn(job); NULL runs them serially in the caller */
+   int           (*map)(ltc_parallel_job *jobs, unsigned long count, void *pool);
+} ltc_parallel_spec;
+
+int ltc_parallel_run(ltc_parallel_job *jobs, unsigned long count, const ltc_parallel_spec *spec);
+
+#ifdef LTC_ECB_MODE
+int ecb_encrypt_par(const unsigned char *pt, unsigned char *ct, unsigned long len,
+                    const ltc_parallel_spec *spec, symmetric_ECB *ecb);
+#endif
+#ifdef LTC_CTR_MODE
+int ctr_encrypt_par(const unsigned char *pt, unsigned char *ct, unsigned long len,
+                    const ltc_parallel_spec *spec, symmetric_CTR *ctr);
+#endif
+#ifdef LTC_XTS_MODE
+int xts_encrypt_par(const unsigned char *pt, unsigned long ptlen, unsigned char *ct,
+                    unsigned char *tweak, const ltc_parallel_spec *spec, symmetric_xts *xts);
+#endif
+
+/* file-handle helpers over the overlapped I/O pipeline (file_pipeline.c) */
+#ifndef LTC_NO_FILE
+#ifdef LTC_CTR_MODE
+int ctr_encrypt_filehandle(FILE *in, FILE *out, symmetric_CTR *ctr);
+#endif
+#ifdef LTC_XTS_MODE
+int xts_encrypt_filehandle(FILE *in, FILE *out, unsigned long sector_size,
+                           ulong64 first_sector, symmetric_xts *xts);
+int xts_decrypt_filehandle(FILE *in, FILE *out, unsigned long sector_size,
+                           ulong64 first_sector, symmetric_xts *xts);
+#endif
+#endif
+
 int find_cipher(const char *name);
+/* drop the cached name index; called by (un)register_cipher with ltc_cipher_mutex held */
+void cipher_name_index_invalidate(void);
 int find_cipher_any(const char *name, int blocklen, int keylen);
 int find_cipher_id(unsigned char ID);
 int register_cipher(const struct ltc_cipher_descriptor *cipher);
 int unregister_cipher(const struct ltc_cipher_descriptor *cipher);
 int cipher_is_valid(int idx);
 
+#ifdef LTC_KEY_CACHE
+/* entries kept by the global scheduled-key cache */
+#ifndef LTC_KEY_CACHE_SIZE
+#define LTC_KEY_CACHE_SIZE   16
+#endif
+/* raw keys longer than this bypass the cache */
+#define LTC_KEY_CACHE_MAXKEY 64
+int cipher_setup_cached(int cipher, const unsigned char *key, int keylen,
+                        int num_rounds, symmetric_key *skey);
+int cipher_key_cache_purge(void);
+void cipher_key_cache_stats(ulong64 *hits, ulong64 *misses);
+#else
+/* without the cache the call collapses to the descriptor setup */
+#define cipher_setup_cached(cipher, key, keylen, num_rounds, skey)    cipher_descriptor[(cipher)].setup((key), (keylen), (num_rounds), (skey))
+#endif
+
 LTC_MUTEX_PROTO(ltc_cipher_mutex)
 
 /* ---- stream ciphers ---- */
@@ -943,15 +1194,23 @@ LTC_MUTEX_PROTO(ltc_cipher_mutex)
 
 typedef struct {
    ulong32 input[16];
-   unsigned char kstream[64];
+   /* four blocks of buffered keystream; chacha_keystream refills it in
+    * one batched fill so small draws do not pay a block each */
+   unsigned char kstream[256];
    unsigned long ksleft;
    unsigned long ivlen;
    int rounds;
+   /* XChaCha: the key words as loaded at setup plus the HChaCha
+    * subkey cached for the last seen 16-byte nonce prefix */
+   ulong32 xkey[8], xsub[8];
+   unsigned char xprefix[16];
+   int xvalid;
 } chacha_state;
 
 int chacha_setup(chacha_state *st, const unsigned char *key, unsigned long keylen, int rounds);
 int chacha_ivctr32(chacha_state *st, const unsigned char *iv, unsigned long ivlen, ulong32 counter);
 int chacha_ivctr64(chacha_state *st, const unsigned char *iv, unsigned long ivlen, ulong64 counter);
+int chacha_xivctr64(chacha_state *st, const unsigned char *iv, unsigned long ivlen, ulong64 counter);
 int chacha_crypt(chacha_state *st, const unsigned char *in, unsigned long inlen, unsigned char *out);
 int chacha_keystream(chacha_state *st, unsigned char *out, unsigned long outlen);
 int chacha_done(chacha_state *st);
@@ -2,6 +2,8 @@
 #define TOMCRYPT_CUSTOM_H_
 
 /* macros for various libc functions you can change for embedded targets */
+/* with LTC_SECURE_POOL these may be pointed at the secure_pool functions
+ * (see tomcrypt_misc.h) to serve key-bearing structs from locked memory */
 #ifndef XMALLOC
 #define XMALLOC  malloc
 #endif
@@ -15,6 +17,16 @@
 #define XFREE    free
 #endif
 
+/* aligned allocations for precomputed tables (64 octet minimum); the
+ * defaults over-allocate through XMALLOC, see aligned_alloc.c.
+ * Override the pair together. */
+#ifndef XMALLOC_ALIGNED
+#define XMALLOC_ALIGNED ltc_malloc_aligned
+#define XFREE_ALIGNED   ltc_free_aligned
+#endif
+/* back aligned allocations of 2MB+ with MADV_HUGEPAGE mappings (Linux) */
+/* #define LTC_ALIGNED_HUGEPAGES */
+
 #ifndef XMEMSET
 #define XMEMSET  memset
 #endif
@@ -165,6 +177,64 @@
 #define LTC_RC6
 #define LTC_SAFERP
 #define LTC_RIJNDAEL
+/* LTC_AES_NI uses the x86 AES instructions at run-time when the CPU has them,
+ * falling back to the table driven code otherwise */
+#if defined(LTC_RIJNDAEL) && !defined(LTC_NO_ASM) && \
+    defined(__GNUC__) && defined(__x86_64__)
+   #define LTC_AES_NI
+#endif
+/* LTC_GF_CLMUL compiles a PCLMULQDQ-based GF(2^128) multiply used by GCM
+ * and LRW when the CPU advertises the instruction at runtime */
+#if !defined(LTC_NO_ASM) && defined(__GNUC__) && defined(__x86_64__)
+   #define LTC_GF_CLMUL
+#endif
+/* LTC_CHACHA_SSSE3 compiles a four-block SSSE3 ChaCha core selected at
+ * runtime by chacha_crypt (and everything layered on it);
+ * LTC_CHACHA_AVX2 adds an eight-block AVX2 core preferred when the CPU
+ * has it */
+#if !defined(LTC_NO_ASM) && defined(__GNUC__) && defined(__x86_64__)
+   #define LTC_CHACHA_SSSE3
+   #define LTC_CHACHA_AVX2
+#endif
+/* LTC_CHACHA_NEON compiles a four-block NEON ChaCha core; AdvSIMD is
+ * architectural on AArch64 so there is nothing to probe at runtime */
+#if !defined(LTC_NO_ASM) && defined(__GNUC__) && defined(__aarch64__)
+   #define LTC_CHACHA_NEON
+#endif
+/* LTC_POLY1305_X64 compiles a radix 2^44 Poly1305 block core using
+ * 64x64->128 bit multiplies plus a four-block AVX2 core, selected at
+ * runtime by poly1305_process */
+#if !defined(LTC_NO_ASM) && defined(__GNUC__) && defined(__x86_64__)
+   #define LTC_POLY1305_X64
+#endif
+/* LTC_AES_ARMV8 is the same idea for the ARMv8 Crypto Extensions; it needs
+ * the compiler to target them (-march=armv8-a+crypto) and still checks
+ * HWCAP at run-time */
+#if defined(LTC_RIJNDAEL) && !defined(LTC_NO_ASM) && \
+    defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+   #define LTC_AES_ARMV8
+#endif
+/* LTC_AES_BITSLICE adds a constant-time batched AES encrypt (four blocks
+ * per call) used for accel_ecb when no hardware AES is available */
+#ifdef LTC_RIJNDAEL
+   #define LTC_AES_BITSLICE
+#endif
+/* LTC_AES_COMPACT adds rijndael_setup_compact, which marks a key so that
+ * en/decryption runs off a single 256-byte sbox with on-the-fly MixColumns
+ * instead of the 4x1KB lookup tables; slower per block but with a far
+ * smaller cache footprint under concurrency */
+#ifdef LTC_RIJNDAEL
+   #define LTC_AES_COMPACT
+#endif
+/* LTC_AES_KEYCACHE keeps a bounded LRU cache of expanded AES schedules so
+ * repeated rijndael_setup calls with recently seen keys skip the expansion;
+ * it stores raw key bytes, hence strictly opt-in */
+/* #define LTC_AES_KEYCACHE */
+/* LTC_STATIC_AES binds the block-cipher calls inside the modes of
+ * operation to the AES entry points at compile time (other registered
+ * ciphers still work, via a pointer compare); pair with -flto so the
+ * compiler can inline the cipher into the mode loops */
+/* #define LTC_STATIC_AES */
 #define LTC_XTEA
 /* _TABLES tells it to use tables during setup, _SMALL means to use the smaller scheduled key format
  * (saves 4KB of ram), _ALL_TABLES enables all tables during setup */
@@ -227,11 +297,52 @@
 #define LTC_CHC_HASH
 #define LTC_WHIRLPOOL
 #define LTC_SHA3
+/* tree-hashed SHAKE XOF with independent leaves (see sha3_tree.c) */
+#define LTC_SHAKE_TREE
+#ifndef LTC_SHAKE_TREE_CHUNK
+   #define LTC_SHAKE_TREE_CHUNK 8192
+#endif
+/* fan the leaves of shake_tree_memory out over worker threads; opt in
+ * explicitly since it requires LTC_PTHREAD */
+/* #define LTC_SHAKE_TREE_CONCURRENT */
+#ifndef LTC_SHAKE_TREE_THREADS
+   #define LTC_SHAKE_TREE_THREADS 4
+#endif
 #define LTC_SHA512
 #define LTC_SHA512_256
 #define LTC_SHA512_224
 #define LTC_SHA384
 #define LTC_SHA256
+/* LTC_SHA256_ARMV8 uses the ARMv8 SHA-2 instructions at run-time when the
+ * CPU has them; like LTC_AES_ARMV8 it needs -march=armv8-a+crypto */
+#if defined(LTC_SHA256) && !defined(LTC_NO_ASM) && \
+    defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+   #define LTC_SHA256_ARMV8
+#endif
+/* LTC_SHA256_NI is the x86 counterpart (SHA256RNDS2/SHA256MSG1/SHA256MSG2),
+ * probed with CPUID at run-time */
+#if defined(LTC_SHA256) && !defined(LTC_NO_ASM) && \
+    defined(__GNUC__) && defined(__x86_64__)
+   #define LTC_SHA256_NI
+#endif
+/* LTC_SHA256_AVX2 compiles the eight-lane AVX2 compressor behind the
+ * multi-buffer interface, again probed at run-time */
+#if defined(LTC_SHA256) && !defined(LTC_NO_ASM) && \
+    defined(__GNUC__) && defined(__x86_64__)
+   #define LTC_SHA256_AVX2
+#endif
+/* LTC_SHA512_AVX2 expands the SHA-512 message schedule in AVX2 registers,
+ * probed at run-time */
+#if defined(LTC_SHA512) && !defined(LTC_NO_ASM) && \
+    defined(__GNUC__) && defined(__x86_64__)
+   #define LTC_SHA512_AVX2
+#endif
+/* LTC_SHA3_AVX2 compiles the four-lane AVX2 Keccak permutation behind the
+ * multi-buffer interface, probed at run-time */
+#if defined(LTC_SHA3) && !defined(LTC_NO_ASM) && \
+    defined(__GNUC__) && defined(__x86_64__)
+   #define LTC_SHA3_AVX2
+#endif
 #define LTC_SHA224
 #define LTC_TIGER
 #define LTC_SHA1
@@ -245,6 +356,29 @@
 #define LTC_BLAKE2S
 #define LTC_BLAKE2B
 
+/* BLAKE2bp, the four lane parallel tree mode of BLAKE2b */
+#ifdef LTC_BLAKE2B
+   #define LTC_BLAKE2BP
+#endif
+
+/* LTC_BLAKE2B_AVX2 compiles the row-parallel AVX2 BLAKE2b compression
+ * function, probed at run-time */
+#if defined(LTC_BLAKE2B) && !defined(LTC_NO_ASM) && \
+    defined(__GNUC__) && defined(__x86_64__)
+   #define LTC_BLAKE2B_AVX2
+#endif
+
+/* LTC_MD5_AVX2/LTC_SHA1_AVX2 compile the eight-lane AVX2 compression
+ * functions behind the multi-buffer interfaces, probed at run-time */
+#if defined(LTC_MD5) && !defined(LTC_NO_ASM) && \
+    defined(__GNUC__) && defined(__x86_64__)
+   #define LTC_MD5_AVX2
+#endif
+#if defined(LTC_SHA1) && !defined(LTC_NO_ASM) && \
+    defined(__GNUC__) && defined(__x86_64__)
+   #define LTC_SHA1_AVX2
+#endif
+
 #define LTC_HASH_HELPERS
 
 #endif /* LTC_NO_HASHES */
@@ -260,6 +394,17 @@
 #define LTC_F9_MODE
 #define LTC_PELICAN
 #define LTC_POLY1305
+/* SipHash short-input keyed PRF (hash tables, load balancers) */
+#define LTC_SIPHASH
+/* NH universal-hash MAC (UMAC/VMAC-style) for line-rate links */
+#define LTC_NHMAC
+/* keyed BLAKE2 as a MAC: half the compression calls of HMAC-BLAKE2 */
+#ifdef LTC_BLAKE2B
+   #define LTC_BLAKE2BMAC
+#endif
+#ifdef LTC_BLAKE2S
+   #define LTC_BLAKE2SMAC
+#endif
 
 /* ---> Encrypt + Authenticate Modes <--- */
 
@@ -269,6 +414,10 @@
 #define LTC_OCB3_MODE
 #define LTC_CCM_MODE
 #define LTC_GCM_MODE
+#define LTC_GCM_SIV_MODE
+
+/* TLS-style record seal/open one-shots */
+#define LTC_SEAL
 #define LTC_CHACHA20POLY1305_MODE
 
 /* Use 64KiB tables */
@@ -302,6 +451,11 @@
 /* Fortuna PRNG */
 #define LTC_FORTUNA
 
+/* NIST SP 800-90A CTR_DRBG on AES-256; generation runs through the
+ * AES accel hooks, so it is the fastest option for bulk draws on
+ * hardware with AES instructions */
+#define LTC_CTR_DRBG
+
 /* Greg's LTC_SOBER128 PRNG ;-0 */
 #define LTC_SOBER128
 
@@ -344,6 +498,13 @@
 #define LTC_FORTUNA_POOLS 32
 #endif
 
+#ifndef LTC_FORTUNA_EVENT_BUF
+/* bytes of entropy events batched before being folded into a pool;
+ * high-rate sources (packet timings) then pay one hash call per batch
+ * instead of one per event */
+#define LTC_FORTUNA_EVENT_BUF 512
+#endif
+
 #endif /* LTC_FORTUNA */
 
 
@@ -390,6 +551,24 @@
 /* do we want fixed point ECC */
 /* #define LTC_MECC_FP */
 
+/* X25519 key exchange; self-contained 51-bit limb field arithmetic,
+ * needs a compiler with a 64x64->128 bit multiply */
+#if defined(__GNUC__) && defined(__SIZEOF_INT128__)
+   #define LTC_CURVE25519
+#endif
+
+/* Ed25519 signatures on the same field arithmetic; needs SHA-512 */
+#if defined(LTC_CURVE25519) && defined(LTC_SHA512)
+   #define LTC_ED25519
+#endif
+
+/* constant-time fixed 4x64 limb backend for point multiplication on
+ * the NIST P-256 prime; picked automatically by ltc_ecc_mulmod when
+ * the modulus matches, any other curve takes the generic path */
+#if defined(LTC_MECC) && defined(__GNUC__) && defined(__SIZEOF_INT128__)
+   #define LTC_ECC_P256
+#endif
+
 #endif /* LTC_NO_PK */
 
 #if defined(LTC_MRSA) && !defined(LTC_NO_RSA_BLINDING)
@@ -457,10 +636,29 @@
 #define LTC_HKDF
 #endif /* LTC_NO_HKDF */
 
+/* memory-hard KDF with parallel lanes (see mhkdf.c) */
+#define LTC_MHKDF
+/* run the lanes on their own threads; opt in explicitly since it
+ * requires LTC_PTHREAD */
+/* #define LTC_MHKDF_CONCURRENT */
+
 #define LTC_ADLER32
 
 #define LTC_CRC32
 
+/* counter-based deterministic IV sequencer */
+#define LTC_IVSEQ
+
+/* LRU cache of expanded symmetric keys shared by the mode *_start
+ * functions; see key_cache.c.  Opt-in like LTC_MECC_FP: the cache is
+ * global state (it needs LTC_PTHREAD for the mutexes to be real) and
+ * it retains raw key bytes for the life of the process */
+/* #define LTC_KEY_CACHE */
+
+/* per-NUMA-node replicas of read-only precomputed contexts; opt-in
+ * for the same reasons */
+/* #define LTC_NUMA_REPLICA */
+
 #endif /* LTC_NO_MISC */
 
 /* cleanup */
@@ -513,14 +711,55 @@
    #error PK requires ASN.1 DER functionality, make sure LTC_DER is enabled
 #endif
 
+#if defined(LTC_GCM_SIV_MODE) && !defined(LTC_GCM_MODE)
+   #error LTC_GCM_SIV_MODE requires LTC_GCM_MODE (for the GF(2^128) multiplier)
+#endif
+
+#if defined(LTC_SEAL) && !defined(LTC_GCM_MODE) && !defined(LTC_CHACHA20POLY1305_MODE) && !(defined(LTC_CTR_MODE) && defined(LTC_HMAC))
+   #error LTC_SEAL requires at least one suite (LTC_GCM_MODE, LTC_CHACHA20POLY1305_MODE or LTC_CTR_MODE+LTC_HMAC)
+#endif
+
 #if defined(LTC_CHACHA20POLY1305_MODE) && (!defined(LTC_CHACHA) || !defined(LTC_POLY1305))
    #error LTC_CHACHA20POLY1305_MODE requires LTC_CHACHA + LTC_POLY1305
 #endif
 
+#if defined(LTC_CTR_DRBG) && !defined(LTC_RIJNDAEL)
+   #error LTC_CTR_DRBG requires LTC_RIJNDAEL (AES)
+#endif
+
 #if defined(LTC_CHACHA20_PRNG) && !defined(LTC_CHACHA)
    #error LTC_CHACHA20_PRNG requires LTC_CHACHA
 #endif
 
+/* run the two half-size CRT exponentiations of rsa_exptmod on two
+ * threads; opt in explicitly since it requires LTC_PTHREAD and a
+ * thread-safe math provider */
+/* #define LTC_RSA_CRT_CONCURRENT */
+
+#if defined(LTC_RSA_CRT_CONCURRENT) && !defined(LTC_PTHREAD)
+   #error LTC_RSA_CRT_CONCURRENT requires LTC_PTHREAD
+#endif
+
+#if defined(LTC_MHKDF) && (!defined(LTC_HMAC) || !defined(LTC_HKDF))
+   #error LTC_MHKDF requires LTC_HMAC and LTC_HKDF
+#endif
+
+#if defined(LTC_MHKDF_CONCURRENT) && !defined(LTC_PTHREAD)
+   #error LTC_MHKDF_CONCURRENT requires LTC_PTHREAD
+#endif
+
+#if defined(LTC_NHMAC) && !defined(LTC_GCM_MODE)
+   #error LTC_NHMAC requires LTC_GCM_MODE (for the GF(2^128) layer)
+#endif
+
+#if defined(LTC_SHAKE_TREE) && !defined(LTC_SHA3)
+   #error LTC_SHAKE_TREE requires LTC_SHA3
+#endif
+
+#if defined(LTC_SHAKE_TREE_CONCURRENT) && !defined(LTC_PTHREAD)
+   #error LTC_SHAKE_TREE_CONCURRENT requires LTC_PTHREAD
+#endif
+
 /* THREAD management */
 #ifdef LTC_PTHREAD
 
@@ -533,6 +772,17 @@
 #define LTC_MUTEX_LOCK(x)     pthread_mutex_lock(x);
 #define LTC_MUTEX_UNLOCK(x)   pthread_mutex_unlock(x);
 
+/* reader/writer locks for read-mostly shared state (e.g. the ECC
+ * fixed point cache); degrade to no-ops without LTC_PTHREAD just
+ * like the mutexes */
+#define LTC_RWLOCK_GLOBAL(x)  pthread_rwlock_t x = PTHREAD_RWLOCK_INITIALIZER;
+#define LTC_RWLOCK_PROTO(x)   extern pthread_rwlock_t x;
+#define LTC_RWLOCK_TYPE(x)    pthread_rwlock_t x;
+#define LTC_RWLOCK_INIT(x)    pthread_rwlock_init(x, NULL);
+#define LTC_RWLOCK_RDLOCK(x)  pthread_rwlock_rdlock(x);
+#define LTC_RWLOCK_WRLOCK(x)  pthread_rwlock_wrlock(x);
+#define LTC_RWLOCK_UNLOCK(x)  pthread_rwlock_unlock(x);
+
 #else
 
 /* default no functions */
@@ -543,6 +793,14 @@
 #define LTC_MUTEX_LOCK(x)
 #define LTC_MUTEX_UNLOCK(x)
 
+#define LTC_RWLOCK_GLOBAL(x)
+#define LTC_RWLOCK_PROTO(x)
+#define LTC_RWLOCK_TYPE(x)
+#define LTC_RWLOCK_INIT(x)
+#define LTC_RWLOCK_RDLOCK(x)
+#define LTC_RWLOCK_WRLOCK(x)
+#define LTC_RWLOCK_UNLOCK(x)
+
 #endif
 
 /* Debuggers */
@@ -557,6 +815,12 @@
    #ifndef LTC_FILE_READ_BUFSIZE
    #define LTC_FILE_READ_BUFSIZE 8192
    #endif
+
+   /* use open/mmap/madvise in the shared file driver so the kernel
+    * fetches ahead of the compute loop */
+   #if !defined(LTC_FILE_POSIX) && (defined(__unix__) || (defined(__APPLE__) && defined(__MACH__)))
+   #define LTC_FILE_POSIX
+   #endif
 #endif
 
 /* $Source$ */
@@ -137,6 +137,14 @@ struct blake2b_state {
 };
 #endif
 
+#ifdef LTC_BLAKE2BP
+struct blake2bp_state {
+    struct blake2b_state leaf[4];
+    struct blake2b_state root;
+    ulong64 pos;
+};
+#endif
+
 typedef union Hash_state {
     char dummy[1];
 #ifdef LTC_CHC_HASH
@@ -187,6 +195,9 @@ typedef union Hash_state {
 #ifdef LTC_BLAKE2B
     struct blake2b_state blake2b;
 #endif
+#ifdef LTC_BLAKE2BP
+    struct blake2bp_state blake2bp;
+#endif
 
     void *data;
 } hash_state;
@@ -234,6 +245,21 @@ extern  struct ltc_hash_descriptor {
                        const unsigned char *in,  unsigned long  inlen,
                              unsigned char *out, unsigned long *outlen);
 
+    /** Export a midstate checkpoint so hashing can resume later (may be NULL)
+      @param out     [out] The destination of the serialized midstate
+      @param outlen  [in/out] The max size and resulting size of the midstate
+      @param md      The hash state to serialize
+      @return CRYPT_OK if successful
+    */
+    int (*hash_export)(unsigned char *out, unsigned long *outlen, const hash_state *md);
+    /** Import a midstate checkpoint (may be NULL)
+      @param md     The hash state to restore into
+      @param in     The serialized midstate
+      @param inlen  The length of the serialized midstate (octets)
+      @return CRYPT_OK if successful
+    */
+    int (*hash_import)(hash_state *md, const unsigned char *in, unsigned long inlen);
+
 } hash_descriptor[];
 
 #ifdef LTC_CHC_HASH
@@ -250,6 +276,7 @@ int whirlpool_init(hash_state * md);
 int whirlpool_process(hash_state * md, const unsigned char *in, unsigned long inlen);
 int whirlpool_done(hash_state * md, unsigned char *hash);
 int whirlpool_test(void);
+int whirlpool_compact_mode(int enable);
 extern const struct ltc_hash_descriptor whirlpool_desc;
 #endif
 
@@ -269,12 +296,33 @@ extern const struct ltc_hash_descriptor sha3_224_desc;
 /* process + done are the same for all variants */
 int sha3_process(hash_state * md, const unsigned char *in, unsigned long inlen);
 int sha3_done(hash_state *md, unsigned char *hash);
+/* multi-buffer absorption over independent states, one buffer per lane */
+int sha3_mb_process(hash_state *md, const unsigned char **in, const unsigned long *inlen, int lanes);
 /* SHAKE128 + SHAKE256 */
 int sha3_shake_init(hash_state *md, int num);
 #define sha3_shake_process(a,b,c) sha3_process(a,b,c)
 int sha3_shake_done(hash_state *md, unsigned char *out, unsigned long outlen);
 int sha3_shake_test(void);
 int sha3_shake_memory(int num, const unsigned char *in, unsigned long inlen, unsigned char *out, unsigned long *outlen);
+
+#ifdef LTC_SHAKE_TREE
+/* depth-1 tree over SHAKE for parallel stream fingerprinting (see
+   sha3_tree.c); output is NOT flat SHAKE over the same data */
+typedef struct {
+   hash_state    leaf, root;
+   int           num;           /* 128 or 256 */
+   unsigned long leaf_fill;     /* octets absorbed into current leaf */
+   ulong64       leaf_count, totlen;
+   int           squeezing;
+} shake_tree_state;
+
+int shake_tree_init(shake_tree_state *st, int num);
+int shake_tree_process(shake_tree_state *st, const unsigned char *in, unsigned long inlen);
+int shake_tree_squeeze(shake_tree_state *st, unsigned char *out, unsigned long outlen);
+int shake_tree_memory(int num, const unsigned char *in, unsigned long inlen,
+                      unsigned char *out, unsigned long outlen);
+int shake_tree_test(void);
+#endif /* LTC_SHAKE_TREE */
 #endif
 
 #ifdef LTC_SHA512
@@ -282,7 +330,14 @@ int sha512_init(hash_state * md);
 int sha512_process(hash_state * md, const unsigned char *in, unsigned long inlen);
 int sha512_done(hash_state * md, unsigned char *hash);
 int sha512_test(void);
+int sha512_export(unsigned char *out, unsigned long *outlen, const hash_state *md);
+int sha512_import(hash_state *md, const unsigned char *in, unsigned long inlen);
 extern const struct ltc_hash_descriptor sha512_desc;
+
+#ifdef LTC_SHA512_AVX2
+int sha512_avx2_enabled(void);
+int sha512_avx2_compress(hash_state *md, const unsigned char *buf);
+#endif
 #endif
 
 #ifdef LTC_SHA384
@@ -323,8 +378,25 @@ int sha256_init(hash_state * md);
 int sha256_process(hash_state * md, const unsigned char *in, unsigned long inlen);
 int sha256_done(hash_state * md, unsigned char *hash);
 int sha256_test(void);
+int sha256_export(unsigned char *out, unsigned long *outlen, const hash_state *md);
+int sha256_import(hash_state *md, const unsigned char *in, unsigned long inlen);
 extern const struct ltc_hash_descriptor sha256_desc;
 
+#ifdef LTC_SHA256_ARMV8
+int sha256_armv8_enabled(void);
+int sha256_armv8_compress(hash_state *md, const unsigned char *buf);
+#endif
+
+#ifdef LTC_SHA256_NI
+int sha256_ni_enabled(void);
+int sha256_ni_compress(hash_state *md, const unsigned char *buf);
+#endif
+
+/* multi-buffer interface: one state, buffer and digest per lane */
+int sha256_mb_init(hash_state *md, int lanes);
+int sha256_mb_process(hash_state *md, const unsigned char **in, const unsigned long *inlen, int lanes);
+int sha256_mb_done(hash_state *md, unsigned char **out, int lanes);
+
 #ifdef LTC_SHA224
 #ifndef LTC_SHA256
    #error LTC_SHA256 is required for LTC_SHA224
@@ -342,7 +414,14 @@ int sha1_init(hash_state * md);
 int sha1_process(hash_state * md, const unsigned char *in, unsigned long inlen);
 int sha1_done(hash_state * md, unsigned char *hash);
 int sha1_test(void);
+int sha1_export(unsigned char *out, unsigned long *outlen, const hash_state *md);
+int sha1_import(hash_state *md, const unsigned char *in, unsigned long inlen);
 extern const struct ltc_hash_descriptor sha1_desc;
+
+/* multi-buffer interface: one state, buffer and digest per lane */
+int sha1_mb_init(hash_state *md, int lanes);
+int sha1_mb_process(hash_state *md, const unsigned char **in, const unsigned long *inlen, int lanes);
+int sha1_mb_done(hash_state *md, unsigned char **out, int lanes);
 #endif
 
 #ifdef LTC_BLAKE2S
@@ -387,6 +466,26 @@ int blake2b_160_test(void);
 int blake2b_init(hash_state * md, unsigned long outlen, const unsigned char *key, unsigned long keylen);
 int blake2b_process(hash_state * md, const unsigned char *in, unsigned long inlen);
 int blake2b_done(hash_state * md, unsigned char *hash);
+
+/* single node internals, shared with the blake2bp tree mode */
+int blake2b_int_init_param(struct blake2b_state *S, const unsigned char *P);
+int blake2b_int_process(struct blake2b_state *S, const unsigned char *in, unsigned long inlen);
+int blake2b_int_done(struct blake2b_state *S, unsigned char *out);
+
+#ifdef LTC_BLAKE2B_AVX2
+int blake2b_avx2_enabled(void);
+int blake2b_avx2_compress(struct blake2b_state *S, const unsigned char *buf);
+#endif
+#endif
+
+#ifdef LTC_BLAKE2BP
+extern const struct ltc_hash_descriptor blake2bp_desc;
+int blake2bp_512_init(hash_state * md);
+int blake2bp_512_test(void);
+
+int blake2bp_init(hash_state * md, unsigned long outlen, const unsigned char *key, unsigned long keylen);
+int blake2bp_process(hash_state * md, const unsigned char *in, unsigned long inlen);
+int blake2bp_done(hash_state * md, unsigned char *hash);
 #endif
 
 #ifdef LTC_MD5
@@ -394,7 +493,14 @@ int md5_init(hash_state * md);
 int md5_process(hash_state * md, const unsigned char *in, unsigned long inlen);
 int md5_done(hash_state * md, unsigned char *hash);
 int md5_test(void);
+int md5_export(unsigned char *out, unsigned long *outlen, const hash_state *md);
+int md5_import(hash_state *md, const unsigned char *in, unsigned long inlen);
 extern const struct ltc_hash_descriptor md5_desc;
+
+/* multi-buffer interface: one state, buffer and digest per lane */
+int md5_mb_init(hash_state *md, int lanes);
+int md5_mb_process(hash_state *md, const unsigned char **in, const unsigned long *inlen, int lanes);
+int md5_mb_done(hash_state *md, unsigned char **out, int lanes);
 #endif
 
 #ifdef LTC_MD4
@@ -457,6 +563,10 @@ extern const struct ltc_hash_descriptor rmd320_desc;
 int find_hash(const char *name);
 int find_hash_id(unsigned char ID);
 int find_hash_oid(const unsigned long *ID, unsigned long IDlen);
+/* drop the cached OID index; called by (un)register_hash with ltc_hash_mutex held */
+void hash_oid_index_invalidate(void);
+/* drop the cached name index; called by (un)register_hash with ltc_hash_mutex held */
+void hash_name_index_invalidate(void);
 int find_hash_any(const char *name, int digestlen);
 int register_hash(const struct ltc_hash_descriptor *hash);
 int unregister_hash(const struct ltc_hash_descriptor *hash);
@@ -469,10 +579,17 @@ int hash_memory(int hash,
                       unsigned char *out, unsigned long *outlen);
 int hash_memory_multi(int hash, unsigned char *out, unsigned long *outlen,
                       const unsigned char *in, unsigned long inlen, ...);
+int hash_memory_v(int hash, const ltc_iovec *iov, int iovcnt,
+                  unsigned char *out, unsigned long *outlen);
 
 #ifndef LTC_NO_FILE
 int hash_filehandle(int hash, FILE *in, unsigned char *out, unsigned long *outlen);
 int hash_file(int hash, const char *fname, unsigned char *out, unsigned long *outlen);
+/* hash_file with overlapped I/O; the completion callback fires (once,
+   before return) with the digest, or a NULL digest on error */
+int hash_file_async(int hash, const char *fname,
+                    void (*done)(void *ctx, int err, const unsigned char *digest, unsigned long digestlen),
+                    void *ctx);
 #endif
 
 /* a simple macro for making hash "process" functions */
@@ -4,16 +4,35 @@ typedef struct Hmac_state {
      int            hash;
      hash_state     hashstate;
      unsigned char  *key;
+     /** nonzero when keyed from an hmac_precomputed: md restores from
+         imd, the outer pass runs from omd and no key memory is owned */
+     int            precomputed;
+     hash_state     imd, omd;
 } hmac_state;
 
+/** The hash midstates of one HMAC key, just past the ipad and opad
+    blocks; compute once per key, then key any number of hmac_states
+    from it by struct copy */
+typedef struct {
+     int            hash;
+     hash_state     imd, omd;
+} hmac_precomputed;
+
 int hmac_init(hmac_state *hmac, int hash, const unsigned char *key, unsigned long keylen);
 int hmac_process(hmac_state *hmac, const unsigned char *in, unsigned long inlen);
 int hmac_done(hmac_state *hmac, unsigned char *out, unsigned long *outlen);
+int hmac_precompute(hmac_precomputed *pre, int hash, const unsigned char *key, unsigned long keylen);
+int hmac_init_from_precomputed(hmac_state *hmac, const hmac_precomputed *pre);
+int hmac_reset(hmac_state *hmac);
 int hmac_test(void);
 int hmac_memory(int hash,
                 const unsigned char *key, unsigned long keylen,
                 const unsigned char *in,  unsigned long inlen,
                       unsigned char *out, unsigned long *outlen);
+int hmac_memory_stack(hmac_state *hmac, int hash,
+                const unsigned char *key, unsigned long keylen,
+                const unsigned char *in,  unsigned long inlen,
+                      unsigned char *out, unsigned long *outlen);
 int hmac_memory_multi(int hash,
                 const unsigned char *key,  unsigned long keylen,
                       unsigned char *out,  unsigned long *outlen,
@@ -38,10 +57,15 @@ typedef struct {
 int omac_init(omac_state *omac, int cipher, const unsigned char *key, unsigned long keylen);
 int omac_process(omac_state *omac, const unsigned char *in, unsigned long inlen);
 int omac_done(omac_state *omac, unsigned char *out, unsigned long *outlen);
+int omac_reset(omac_state *omac);
 int omac_memory(int cipher,
                const unsigned char *key, unsigned long keylen,
                const unsigned char *in,  unsigned long inlen,
                      unsigned char *out, unsigned long *outlen);
+int omac_memory_stack(omac_state *omac, int cipher,
+               const unsigned char *key, unsigned long keylen,
+               const unsigned char *in,  unsigned long inlen,
+                     unsigned char *out, unsigned long *outlen);
 int omac_memory_multi(int cipher,
                 const unsigned char *key, unsigned long keylen,
                       unsigned char *out, unsigned long *outlen,
@@ -114,14 +138,83 @@ int poly1305_memory(const unsigned char *key, unsigned long keylen, const unsign
 int poly1305_memory_multi(const unsigned char *key, unsigned long keylen, unsigned char *mac, unsigned long *maclen, const unsigned char *in,  unsigned long inlen, ...);
 int poly1305_file(const char *fname, const unsigned char *key, unsigned long keylen, unsigned char *mac, unsigned long *maclen);
 int poly1305_test(void);
+
+#ifdef LTC_POLY1305_X64
+/* internal x86-64 block cores, poly1305_x64.c */
+int poly1305_x64_blocks(poly1305_state *st, const unsigned char *in, unsigned long inlen);
+int poly1305_avx2_enabled(void);
+int poly1305_avx2_blocks(poly1305_state *st, const unsigned char *in, unsigned long inlen);
+#endif
 #endif /* LTC_POLY1305 */
 
+#ifdef LTC_SIPHASH
+/* one-shot, allocation-free keyed short-input PRF; *taglen selects the
+   64- or 128-bit variant (8 or 16) */
+int siphash_memory(const unsigned char *key,
+                   const unsigned char *in,  unsigned long inlen,
+                         unsigned char *tag, unsigned long *taglen);
+int siphash_memory_ex(const unsigned char *key,
+                      const unsigned char *in,  unsigned long inlen,
+                      int crounds, int drounds,
+                      unsigned char *tag, unsigned long *taglen);
+int siphash_test(void);
+#endif /* LTC_SIPHASH */
+
+#ifdef LTC_NHMAC
+/* NH inner hash + GCM polynomial layer + one cipher call (see nhmac.c);
+   deterministic, 64- or 128-bit tags */
+typedef struct {
+   ulong64        nhkey[16];          /* NH key, one 128-octet block  */
+   unsigned char  H[16];              /* GF(2^128) polynomial key     */
+   unsigned char  X[16];              /* polynomial accumulator       */
+   unsigned char  buf[128];           /* partial NH block             */
+   symmetric_key  K2;                 /* finalization key             */
+   ulong64        totlen;
+   int            cipher, buflen;
+} nhmac_state;
+
+int nhmac_init(nhmac_state *st, int cipher, const unsigned char *key, unsigned long keylen);
+int nhmac_process(nhmac_state *st, const unsigned char *in, unsigned long inlen);
+int nhmac_done(nhmac_state *st, unsigned char *tag, unsigned long *taglen);
+int nhmac_memory(int cipher,
+                 const unsigned char *key, unsigned long keylen,
+                 const unsigned char *in,  unsigned long inlen,
+                       unsigned char *tag, unsigned long *taglen);
+int nhmac_test(void);
+#endif /* LTC_NHMAC */
+
+#ifdef LTC_BLAKE2BMAC
+typedef hash_state blake2bmac_state;
+int blake2bmac_init(blake2bmac_state *st, const unsigned char *key, unsigned long keylen, unsigned long maclen);
+int blake2bmac_process(blake2bmac_state *st, const unsigned char *in, unsigned long inlen);
+int blake2bmac_done(blake2bmac_state *st, unsigned char *mac, unsigned long *maclen);
+int blake2bmac_memory(const unsigned char *key, unsigned long keylen,
+                      const unsigned char *in,  unsigned long inlen,
+                            unsigned char *mac, unsigned long *maclen);
+int blake2bmac_test(void);
+#endif /* LTC_BLAKE2BMAC */
+
+#ifdef LTC_BLAKE2SMAC
+typedef hash_state blake2smac_state;
+int blake2smac_init(blake2smac_state *st, const unsigned char *key, unsigned long keylen, unsigned long maclen);
+int blake2smac_process(blake2smac_state *st, const unsigned char *in, unsigned long inlen);
+int blake2smac_done(blake2smac_state *st, unsigned char *mac, unsigned long *maclen);
+int blake2smac_memory(const unsigned char *key, unsigned long keylen,
+                      const unsigned char *in,  unsigned long inlen,
+                            unsigned char *mac, unsigned long *maclen);
+int blake2smac_test(void);
+#endif /* LTC_BLAKE2SMAC */
+
 #ifdef LTC_EAX_MODE
 
 #if !(defined(LTC_OMAC) && defined(LTC_CTR_MODE))
    #error LTC_EAX_MODE requires LTC_OMAC and CTR
 #endif
 
+/* span fed to each lane before switching; sized to stay resident in L1 so
+   the OMAC pass re-reads the ciphertext from cache, not from memory */
+#define LTC_EAX_FUSE_CHUNK 1024
+
 typedef struct {
    unsigned char N[MAXBLOCKSIZE];
    symmetric_CTR ctr;
@@ -134,6 +227,8 @@ int eax_init(eax_state *eax, int cipher, const unsigned char *key, unsigned long
 
 int eax_encrypt(eax_state *eax, const unsigned char *pt, unsigned char *ct, unsigned long length);
 int eax_decrypt(eax_state *eax, const unsigned char *ct, unsigned char *pt, unsigned long length);
+int eax_encrypt_v(eax_state *eax, const ltc_iovec *iov, int iovcnt);
+int eax_decrypt_v(eax_state *eax, const ltc_iovec *iov, int iovcnt);
 int eax_addheader(eax_state *eax, const unsigned char *header, unsigned long length);
 int eax_done(eax_state *eax, unsigned char *tag, unsigned long *taglen);
 
@@ -335,6 +430,12 @@ int ccm_test(void);
 void gcm_gf_mult(const unsigned char *a, const unsigned char *b, unsigned char *c);
 #endif
 
+#ifdef LTC_GF_CLMUL
+int  gcm_gf_mult_clmul_enabled(void);
+void gcm_gf_mult_clmul(const unsigned char *a, const unsigned char *b, unsigned char *c);
+void gcm_gf_mult_clmul_fold8(const unsigned char *hp, const unsigned char *ct, unsigned char *x);
+#endif
+
 
 /* table shared between GCM and LRW */
 #if defined(LTC_GCM_TABLES) || defined(LTC_LRW_TABLES) || ((defined(LTC_GCM_MODE) || defined(LTC_GCM_MODE)) && defined(LTC_FAST))
@@ -350,10 +451,31 @@ extern const unsigned char gcm_shift_table[];
 #define LTC_GCM_MODE_AAD   1
 #define LTC_GCM_MODE_TEXT  2
 
+/** Precomputed GCM key material; read-only after setup, so one object may
+    be shared by any number of gcm_states under the same key */
 typedef struct {
-   symmetric_key       K;
-   unsigned char       H[16],        /* multiplier */
-                       X[16],        /* accumulator */
+   symmetric_key       K;            /* scheduled cipher key */
+   unsigned char       H[16];        /* multiplier */
+
+   int                 cipher;       /* which cipher */
+
+#ifdef LTC_GF_CLMUL
+   int                 clmul;        /* nonzero when the carry-less multiply backend serves this key */
+   unsigned char       HP[8][16];    /* H^1 .. H^8 for the aggregated reduction */
+#endif
+
+#ifdef LTC_GCM_TABLES
+   /* 16 tables of 8x128; cache-line aligned, which also satisfies the
+    * 16-octet requirement of LTC_GCM_TABLES_SSE2 */
+   LTC_TABLE_ALIGN unsigned char PC[16][256][16];
+#endif
+} gcm_precomp;
+
+typedef struct {
+   gcm_precomp        *pre;          /* key material in use: &own or a shared object */
+   gcm_precomp         own;          /* per-state material, filled by gcm_init */
+
+   unsigned char       X[16],        /* accumulator */
                        Y[16],        /* counter */
                        Y_0[16],      /* initial counter */
                        buf[16];      /* buffer for stuff */
@@ -365,21 +487,20 @@ typedef struct {
 
    ulong64             totlen,       /* 64-bit counter used for IV and AAD */
                        pttotlen;     /* 64-bit counter for the PT */
-
-#ifdef LTC_GCM_TABLES
-   unsigned char       PC[16][256][16]  /* 16 tables of 8x128 */
-#ifdef LTC_GCM_TABLES_SSE2
-__attribute__ ((aligned (16)))
-#endif
-;
-#endif
 } gcm_state;
 
 void gcm_mult_h(gcm_state *gcm, unsigned char *I);
 
+int gcm_precompute(gcm_precomp *pre, int cipher,
+                   const unsigned char *key, int keylen);
+
+int gcm_precompute_done(gcm_precomp *pre);
+
 int gcm_init(gcm_state *gcm, int cipher,
              const unsigned char *key, int keylen);
 
+int gcm_init_ex(gcm_state *gcm, gcm_precomp *pre);
+
 int gcm_reset(gcm_state *gcm);
 
 int gcm_add_iv(gcm_state *gcm,
@@ -393,6 +514,10 @@ int gcm_process(gcm_state *gcm,
                      unsigned char *ct,
                      int direction);
 
+int gcm_process_v(gcm_state *gcm,
+                     const ltc_iovec *iov,  int iovcnt,
+                     int direction);
+
 int gcm_done(gcm_state *gcm,
                      unsigned char *tag,    unsigned long *taglen);
 
@@ -406,8 +531,68 @@ int gcm_memory(      int           cipher,
                                int direction);
 int gcm_test(void);
 
+/** GMAC: GCM's GHASH as a standalone MAC; the data path makes no
+    cipher calls, only gmac_start() pays one for the tag mask */
+typedef struct {
+   gcm_state     gcm;        /* key material and GHASH accumulator */
+   unsigned char mask[16];   /* E(K, Y0) for the current message */
+   int           started;
+} gmac_state;
+
+int gmac_init(gmac_state *st, int cipher, const unsigned char *key, unsigned long keylen);
+int gmac_init_ex(gmac_state *st, gcm_precomp *pre);
+int gmac_start(gmac_state *st, const unsigned char *iv, unsigned long ivlen);
+int gmac_process(gmac_state *st, const unsigned char *in, unsigned long inlen);
+int gmac_done(gmac_state *st, unsigned char *tag, unsigned long *taglen);
+int gmac_memory(      int           cipher,
+                const unsigned char *key, unsigned long keylen,
+                const unsigned char *iv,  unsigned long ivlen,
+                const unsigned char *in,  unsigned long inlen,
+                      unsigned char *tag, unsigned long *taglen);
+int gmac_test(void);
+
 #endif /* LTC_GCM_MODE */
 
+#ifdef LTC_GCM_SIV_MODE
+
+/** AES-GCM-SIV (RFC 8452) shareable key material: only the scheduled
+    key-generating key -- the per-message keys come out of the nonce */
+typedef struct {
+   symmetric_key K;       /* scheduled key-generating key */
+   int           cipher;  /* index of the cipher */
+   int           keylen;  /* 16 or 32 */
+} gcmsiv_precomp;
+
+int gcmsiv_precompute(gcmsiv_precomp *pre, int cipher,
+                      const unsigned char *key, unsigned long keylen);
+
+int gcmsiv_precompute_done(gcmsiv_precomp *pre);
+
+void gcmsiv_polyval(const unsigned char *h,
+                    const unsigned char *aad, unsigned long aadlen,
+                    const unsigned char *pt,  unsigned long ptlen,
+                          unsigned char *out);
+
+int gcmsiv_memory_ex(const gcmsiv_precomp *pre,
+               const unsigned char *IV,     unsigned long IVlen,
+               const unsigned char *adata,  unsigned long adatalen,
+                     unsigned char *pt,     unsigned long ptlen,
+                     unsigned char *ct,
+                     unsigned char *tag,    unsigned long *taglen,
+                               int direction);
+
+int gcmsiv_memory(   int            cipher,
+               const unsigned char *key,    unsigned long keylen,
+               const unsigned char *IV,     unsigned long IVlen,
+               const unsigned char *adata,  unsigned long adatalen,
+                     unsigned char *pt,     unsigned long ptlen,
+                     unsigned char *ct,
+                     unsigned char *tag,    unsigned long *taglen,
+                               int direction);
+int gcmsiv_test(void);
+
+#endif /* LTC_GCM_SIV_MODE */
+
 #ifdef LTC_PELICAN
 
 typedef struct pelican_state
@@ -420,8 +605,17 @@ typedef struct pelican_state
 int pelican_init(pelican_state *pelmac, const unsigned char *key, unsigned long keylen);
 int pelican_process(pelican_state *pelmac, const unsigned char *in, unsigned long inlen);
 int pelican_done(pelican_state *pelmac, unsigned char *out);
+int pelican_memory_batch(const unsigned char *key, unsigned long keylen,
+                         const unsigned char * const *in, const unsigned long *inlen,
+                         unsigned char * const *out, int msgs);
 int pelican_test(void);
 
+#ifdef LTC_AES_NI
+/* internal AES-NI round cores, pelican_ni.c */
+int pelican_aesni_blocks(pelican_state *pelmac, const unsigned char *in, unsigned long blocks);
+int pelican_aesni_blocks4(pelican_state **st, const unsigned char **in, unsigned long blocks);
+#endif
+
 int pelican_memory(const unsigned char *key, unsigned long keylen,
                    const unsigned char *in, unsigned long inlen,
                          unsigned char *out);
@@ -447,6 +641,7 @@ typedef struct {
 int xcbc_init(xcbc_state *xcbc, int cipher, const unsigned char *key, unsigned long keylen);
 int xcbc_process(xcbc_state *xcbc, const unsigned char *in, unsigned long inlen);
 int xcbc_done(xcbc_state *xcbc, unsigned char *out, unsigned long *outlen);
+int xcbc_reset(xcbc_state *xcbc);
 int xcbc_memory(int cipher,
                const unsigned char *key, unsigned long keylen,
                const unsigned char *in,  unsigned long inlen,
@@ -459,6 +654,10 @@ int xcbc_file(int cipher,
               const unsigned char *key, unsigned long keylen,
               const          char *filename,
                     unsigned char *out, unsigned long *outlen);
+int xcbc_memory_batch(int cipher,
+               const unsigned char *key, unsigned long keylen,
+               const unsigned char * const *in, const unsigned long *inlen,
+                     unsigned char * const *out, unsigned long *outlen, int msgs);
 int xcbc_test(void);
 
 #endif
@@ -493,12 +692,20 @@ int f9_file(int cipher,
               const unsigned char *key, unsigned long keylen,
               const          char *filename,
                     unsigned char *out, unsigned long *outlen);
+int f9_memory_batch(int cipher,
+               const unsigned char *key, unsigned long keylen,
+               const unsigned char * const *in, const unsigned long *inlen,
+                     unsigned char * const *out, unsigned long *outlen, int msgs);
 int f9_test(void);
 
 #endif
 
 #ifdef LTC_CHACHA20POLY1305_MODE
 
+/* span fed to each lane before switching so the Poly1305 pass reads the
+   ciphertext back out of L1 instead of memory */
+#define LTC_CHACHAPOLY_FUSE_CHUNK 1024
+
 typedef struct {
    poly1305_state poly;
    chacha_state chacha;
@@ -524,10 +731,73 @@ int chacha20poly1305_memory(const unsigned char *key, unsigned long keylen,
                                   unsigned char *out,
                                   unsigned char *tag, unsigned long *taglen,
                             int direction);
+int chacha20poly1305_memory_v(const unsigned char *key, unsigned long keylen,
+                            const unsigned char *iv,  unsigned long ivlen,
+                            const unsigned char *aad, unsigned long aadlen,
+                            const ltc_iovec *iov, int iovcnt,
+                                  unsigned char *tag, unsigned long *taglen,
+                            int direction);
 int chacha20poly1305_test(void);
 
 #endif /* LTC_CHACHA20POLY1305_MODE */
 
+#ifdef LTC_SEAL
+
+/* record seal/open suites */
+#define LTC_SEAL_GCM        1
+#define LTC_SEAL_CHACHAPOLY 2
+#define LTC_SEAL_CTR_HMAC   3
+
+typedef struct {
+   /** which LTC_SEAL_* suite the state was initialized for */
+   int           suite;
+   /** tag octets appended per record */
+   unsigned long taglen;
+   union {
+#ifdef LTC_GCM_MODE
+      gcm_state gcm;
+#endif
+#ifdef LTC_CHACHA20POLY1305_MODE
+      chacha20poly1305_state chachapoly;
+#endif
+#if defined(LTC_CTR_MODE) && defined(LTC_HMAC)
+      struct {
+         symmetric_CTR    ctr;
+         hmac_precomputed hmac;
+      } ch;
+#endif
+   } u;
+} ltc_seal_state;
+
+#ifdef LTC_GCM_MODE
+int ltc_seal_init_gcm(ltc_seal_state *st, int cipher,
+                      const unsigned char *key, unsigned long keylen,
+                      unsigned long taglen);
+#endif
+#ifdef LTC_CHACHA20POLY1305_MODE
+int ltc_seal_init_chachapoly(ltc_seal_state *st,
+                             const unsigned char *key, unsigned long keylen,
+                             unsigned long taglen);
+#endif
+#if defined(LTC_CTR_MODE) && defined(LTC_HMAC)
+int ltc_seal_init_ctr_hmac(ltc_seal_state *st, int cipher, int hash,
+                           const unsigned char *enckey, unsigned long enckeylen,
+                           const unsigned char *mackey, unsigned long mackeylen,
+                           unsigned long taglen);
+#endif
+int ltc_seal(ltc_seal_state *st,
+             const unsigned char *nonce, unsigned long noncelen,
+             const unsigned char *header, unsigned long headerlen,
+             unsigned char *buf, unsigned long buflen);
+int ltc_open(ltc_seal_state *st,
+             const unsigned char *nonce, unsigned long noncelen,
+             const unsigned char *header, unsigned long headerlen,
+             unsigned char *buf, unsigned long buflen);
+int ltc_seal_done(ltc_seal_state *st);
+int ltc_seal_test(void);
+
+#endif /* LTC_SEAL */
+
 /* $Source$ */
 /* $Revision$ */
 /* $Date$ */
@@ -441,6 +441,26 @@ typedef struct {
    */
    int (*rand)(void *a, int size);
 
+   /** simultaneous exponentiation, optional (NULL on older descriptors)
+      @param a1    The first base
+      @param b1    The first exponent
+      @param a2    The second base
+      @param b2    The second exponent
+      @param c     The modulus
+      @param d     [out] The destination of a1^b1 * a2^b2 mod c
+      @return CRYPT_OK on success
+   */
+   int (*multi_exptmod)(void *a1, void *b1, void *a2, void *b2, void *c, void *d);
+
+   /** timing resistant exponentiation, optional (NULL on older descriptors)
+      @param a     The base
+      @param b     The exponent
+      @param c     The (odd) modulus
+      @param d     [out] The destination of a^b mod c
+      @return CRYPT_OK on success
+   */
+   int (*exptmod_ct)(void *a, void *b, void *c, void *d);
+
 } ltc_math_descriptor;
 
 extern ltc_math_descriptor ltc_mp;
@@ -448,6 +468,60 @@ extern ltc_math_descriptor ltc_mp;
 int ltc_init_multi(void **a, ...);
 void ltc_deinit_multi(void *a, ...);
 
+/* exponentiation with a caller supplied Montgomery context, mont_exptmod.c */
+int ltc_mp_exptmod_mont(void *a, void *b, void *c, void *mont, void *R, void *d);
+
+/* Miller-Rabin rounds sharing one Montgomery context, prime_rounds.c */
+int ltc_mp_prime_rounds(void *N, int rounds, prng_state *prng, int wprng, int *result);
+
+/* batch modular inversion by Montgomery's trick, invmod_multi.c */
+int ltc_mp_invmod_multi(void **a, int num, void *c);
+
+/* Shamir/Straus interleaved double exponentiation, multi_exptmod.c */
+int ltc_mp_multi_exptmod(void *a1, void *b1, void *a2, void *b2, void *c, void *d);
+
+/* timing resistant exponentiation with scanned window loads, exptmod_ct.c */
+int ltc_mp_exptmod_ct(void *a, void *b, void *c, void *d);
+
+/* ---- asynchronous exponentiation queue, exptmod_queue.c ---- */
+
+#define LTC_EXPTMOD_QUEUED   0
+#define LTC_EXPTMOD_RUNNING  1
+#define LTC_EXPTMOD_DONE     2
+
+/** One R = G^X mod P job; every bignum stays caller owned */
+typedef struct ltc_exptmod_job {
+   /** base, exponent and modulus */
+   void *G, *X, *P;
+   /** destination, an initialized bignum */
+   void *R;
+   /** optional per-key Montgomery context: the setup digit and the
+       normalization residue (e.g. from rsa_mont_setup), NULL to derive
+       the constants inside the call */
+   void *mont, *mont_R;
+   /** optional completion hook, runs on the worker thread */
+   void (*callback)(struct ltc_exptmod_job *job);
+   /** caller context for the callback */
+   void *user;
+   /** LTC_EXPTMOD_QUEUED/RUNNING/DONE */
+   int   state;
+   /** the job's result code, valid once state is DONE */
+   int   err;
+   struct ltc_exptmod_job *next;
+} ltc_exptmod_job;
+
+int ltc_exptmod_submit(ltc_exptmod_job *job);
+int ltc_exptmod_run(int max, int *ran);
+int ltc_exptmod_done(ltc_exptmod_job *job);
+int ltc_exptmod_wait(ltc_exptmod_job *job);
+
+/* scratch pool of initialized bignum temporaries, mp_pool.c */
+int  ltc_mp_pool_get(void **a);
+void ltc_mp_pool_put(void *a);
+int  ltc_mp_pool_get_multi(void **a, ...);
+void ltc_mp_pool_put_multi(void *a, ...);
+void ltc_mp_pool_free(void);
+
 #ifdef LTM_DESC
 extern const ltc_math_descriptor ltm_desc;
 #endif
@@ -462,62 +536,75 @@ extern const ltc_math_descriptor gmp_desc;
 
 #if !defined(DESC_DEF_ONLY) && defined(LTC_SOURCE)
 
-#define MP_DIGIT_BIT                 ltc_mp.bits_per_digit
+/* When LTC_MP_STATIC is defined to the name of one of the const math
+   descriptors above (e.g. -DLTC_MP_STATIC=tfm_desc) the mp_* macros
+   below bind to that descriptor at compile time instead of reading the
+   run-time ltc_mp table.  The descriptor is const, so the compiler can
+   resolve the function pointers and, with LTO, inline across the
+   calls.  ltc_mp must still be set to the same descriptor as usual;
+   code that dispatches through it explicitly is unaffected. */
+#ifdef LTC_MP_STATIC
+#define LTC_MP_DISPATCH              LTC_MP_STATIC
+#else
+#define LTC_MP_DISPATCH              ltc_mp
+#endif
+
+#define MP_DIGIT_BIT                 LTC_MP_DISPATCH.bits_per_digit
 
 /* some handy macros */
-#define mp_init(a)                   ltc_mp.init(a)
+#define mp_init(a)                   LTC_MP_DISPATCH.init(a)
 #define mp_init_multi                ltc_init_multi
-#define mp_clear(a)                  ltc_mp.deinit(a)
+#define mp_clear(a)                  LTC_MP_DISPATCH.deinit(a)
 #define mp_clear_multi               ltc_deinit_multi
-#define mp_init_copy(a, b)           ltc_mp.init_copy(a, b)
-
-#define mp_neg(a, b)                 ltc_mp.neg(a, b)
-#define mp_copy(a, b)                ltc_mp.copy(a, b)
-
-#define mp_set(a, b)                 ltc_mp.set_int(a, b)
-#define mp_set_int(a, b)             ltc_mp.set_int(a, b)
-#define mp_get_int(a)                ltc_mp.get_int(a)
-#define mp_get_digit(a, n)           ltc_mp.get_digit(a, n)
-#define mp_get_digit_count(a)        ltc_mp.get_digit_count(a)
-#define mp_cmp(a, b)                 ltc_mp.compare(a, b)
-#define mp_cmp_d(a, b)               ltc_mp.compare_d(a, b)
-#define mp_count_bits(a)             ltc_mp.count_bits(a)
-#define mp_cnt_lsb(a)                ltc_mp.count_lsb_bits(a)
-#define mp_2expt(a, b)               ltc_mp.twoexpt(a, b)
-
-#define mp_read_radix(a, b, c)       ltc_mp.read_radix(a, b, c)
-#define mp_toradix(a, b, c)          ltc_mp.write_radix(a, b, c)
-#define mp_unsigned_bin_size(a)      ltc_mp.unsigned_size(a)
-#define mp_to_unsigned_bin(a, b)     ltc_mp.unsigned_write(a, b)
-#define mp_read_unsigned_bin(a, b, c) ltc_mp.unsigned_read(a, b, c)
-
-#define mp_add(a, b, c)              ltc_mp.add(a, b, c)
-#define mp_add_d(a, b, c)            ltc_mp.addi(a, b, c)
-#define mp_sub(a, b, c)              ltc_mp.sub(a, b, c)
-#define mp_sub_d(a, b, c)            ltc_mp.subi(a, b, c)
-#define mp_mul(a, b, c)              ltc_mp.mul(a, b, c)
-#define mp_mul_d(a, b, c)            ltc_mp.muli(a, b, c)
-#define mp_sqr(a, b)                 ltc_mp.sqr(a, b)
-#define mp_div(a, b, c, d)           ltc_mp.mpdiv(a, b, c, d)
-#define mp_div_2(a, b)               ltc_mp.div_2(a, b)
-#define mp_mod(a, b, c)              ltc_mp.mpdiv(a, b, NULL, c)
-#define mp_mod_d(a, b, c)            ltc_mp.modi(a, b, c)
-#define mp_gcd(a, b, c)              ltc_mp.gcd(a, b, c)
-#define mp_lcm(a, b, c)              ltc_mp.lcm(a, b, c)
-
-#define mp_addmod(a, b, c, d)        ltc_mp.addmod(a, b, c, d)
-#define mp_submod(a, b, c, d)        ltc_mp.submod(a, b, c, d)
-#define mp_mulmod(a, b, c, d)        ltc_mp.mulmod(a, b, c, d)
-#define mp_sqrmod(a, b, c)           ltc_mp.sqrmod(a, b, c)
-#define mp_invmod(a, b, c)           ltc_mp.invmod(a, b, c)
-
-#define mp_montgomery_setup(a, b)    ltc_mp.montgomery_setup(a, b)
-#define mp_montgomery_normalization(a, b) ltc_mp.montgomery_normalization(a, b)
-#define mp_montgomery_reduce(a, b, c)   ltc_mp.montgomery_reduce(a, b, c)
-#define mp_montgomery_free(a)        ltc_mp.montgomery_deinit(a)
-
-#define mp_exptmod(a,b,c,d)          ltc_mp.exptmod(a,b,c,d)
-#define mp_prime_is_prime(a, b, c)   ltc_mp.isprime(a, b, c)
+#define mp_init_copy(a, b)           LTC_MP_DISPATCH.init_copy(a, b)
+
+#define mp_neg(a, b)                 LTC_MP_DISPATCH.neg(a, b)
+#define mp_copy(a, b)                LTC_MP_DISPATCH.copy(a, b)
+
+#define mp_set(a, b)                 LTC_MP_DISPATCH.set_int(a, b)
+#define mp_set_int(a, b)             LTC_MP_DISPATCH.set_int(a, b)
+#define mp_get_int(a)                LTC_MP_DISPATCH.get_int(a)
+#define mp_get_digit(a, n)           LTC_MP_DISPATCH.get_digit(a, n)
+#define mp_get_digit_count(a)        LTC_MP_DISPATCH.get_digit_count(a)
+#define mp_cmp(a, b)                 LTC_MP_DISPATCH.compare(a, b)
+#define mp_cmp_d(a, b)               LTC_MP_DISPATCH.compare_d(a, b)
+#define mp_count_bits(a)             LTC_MP_DISPATCH.count_bits(a)
+#define mp_cnt_lsb(a)                LTC_MP_DISPATCH.count_lsb_bits(a)
+#define mp_2expt(a, b)               LTC_MP_DISPATCH.twoexpt(a, b)
+
+#define mp_read_radix(a, b, c)       LTC_MP_DISPATCH.read_radix(a, b, c)
+#define mp_toradix(a, b, c)          LTC_MP_DISPATCH.write_radix(a, b, c)
+#define mp_unsigned_bin_size(a)      LTC_MP_DISPATCH.unsigned_size(a)
+#define mp_to_unsigned_bin(a, b)     LTC_MP_DISPATCH.unsigned_write(a, b)
+#define mp_read_unsigned_bin(a, b, c) LTC_MP_DISPATCH.unsigned_read(a, b, c)
+
+#define mp_add(a, b, c)              LTC_MP_DISPATCH.add(a, b, c)
+#define mp_add_d(a, b, c)            LTC_MP_DISPATCH.addi(a, b, c)
+#define mp_sub(a, b, c)              LTC_MP_DISPATCH.sub(a, b, c)
+#define mp_sub_d(a, b, c)            LTC_MP_DISPATCH.subi(a, b, c)
+#define mp_mul(a, b, c)              LTC_MP_DISPATCH.mul(a, b, c)
+#define mp_mul_d(a, b, c)            LTC_MP_DISPATCH.muli(a, b, c)
+#define mp_sqr(a, b)                 LTC_MP_DISPATCH.sqr(a, b)
+#define mp_div(a, b, c, d)           LTC_MP_DISPATCH.mpdiv(a, b, c, d)
+#define mp_div_2(a, b)               LTC_MP_DISPATCH.div_2(a, b)
+#define mp_mod(a, b, c)              LTC_MP_DISPATCH.mpdiv(a, b, NULL, c)
+#define mp_mod_d(a, b, c)            LTC_MP_DISPATCH.modi(a, b, c)
+#define mp_gcd(a, b, c)              LTC_MP_DISPATCH.gcd(a, b, c)
+#define mp_lcm(a, b, c)              LTC_MP_DISPATCH.lcm(a, b, c)
+
+#define mp_addmod(a, b, c, d)        LTC_MP_DISPATCH.addmod(a, b, c, d)
+#define mp_submod(a, b, c, d)        LTC_MP_DISPATCH.submod(a, b, c, d)
+#define mp_mulmod(a, b, c, d)        LTC_MP_DISPATCH.mulmod(a, b, c, d)
+#define mp_sqrmod(a, b, c)           LTC_MP_DISPATCH.sqrmod(a, b, c)
+#define mp_invmod(a, b, c)           LTC_MP_DISPATCH.invmod(a, b, c)
+
+#define mp_montgomery_setup(a, b)    LTC_MP_DISPATCH.montgomery_setup(a, b)
+#define mp_montgomery_normalization(a, b) LTC_MP_DISPATCH.montgomery_normalization(a, b)
+#define mp_montgomery_reduce(a, b, c)   LTC_MP_DISPATCH.montgomery_reduce(a, b, c)
+#define mp_montgomery_free(a)        LTC_MP_DISPATCH.montgomery_deinit(a)
+
+#define mp_exptmod(a,b,c,d)          LTC_MP_DISPATCH.exptmod(a,b,c,d)
+#define mp_prime_is_prime(a, b, c)   LTC_MP_DISPATCH.isprime(a, b, c)
 
 #define mp_iszero(a)                 (mp_cmp_d(a, 0) == LTC_MP_EQ ? LTC_MP_YES : LTC_MP_NO)
 #define mp_isodd(a)                  (mp_get_digit_count(a) > 0 ? (mp_get_digit(a, 0) & 1 ? LTC_MP_YES : LTC_MP_NO) : LTC_MP_NO)
@@ -525,7 +612,7 @@ extern const ltc_math_descriptor gmp_desc;
 
 #define mp_tohex(a, b)               mp_toradix(a, b, 16)
 
-#define mp_rand(a, b)                ltc_mp.rand(a, b)
+#define mp_rand(a, b)                LTC_MP_DISPATCH.rand(a, b)
 
 #endif
 
@@ -21,6 +21,53 @@ int base64url_strict_decode(const unsigned char *in,  unsigned long len,
                         unsigned char *out, unsigned long *outlen);
 #endif
 
+#if defined(LTC_BASE64) || defined(LTC_BASE64_URL)
+/** incremental base64 encoder: up to two raw octets carry over
+    between process calls so chunks of any size transcode in
+    constant memory */
+typedef struct {
+   const char   *codes;       /* the alphabet in use */
+   int           pad;         /* emit '=' padding at the end */
+   unsigned long carrylen;    /* raw octets held over (0..2) */
+   unsigned char carry[3];
+} base64_encode_state;
+
+/** incremental base64 decoder: a partial 4-character group is held
+    in the accumulator between process calls */
+typedef struct {
+   unsigned char map[256];    /* character -> sextet, 254='=', 255=junk */
+   int           is_strict;
+   int           is_url;
+   int           g;           /* '=' characters seen */
+   unsigned long y;           /* characters gathered in t (0..3) */
+   ulong32       t;           /* sextet accumulator */
+} base64_decode_state;
+
+int base64_encode_process(base64_encode_state *st,
+                          const unsigned char *in,  unsigned long inlen,
+                                unsigned char *out, unsigned long *outlen);
+int base64_encode_done(base64_encode_state *st,
+                             unsigned char *out, unsigned long *outlen);
+int base64_decode_process(base64_decode_state *st,
+                          const unsigned char *in,  unsigned long inlen,
+                                unsigned char *out, unsigned long *outlen);
+int base64_decode_done(base64_decode_state *st,
+                             unsigned char *out, unsigned long *outlen);
+#endif
+
+#ifdef LTC_BASE64
+int base64_encode_init(base64_encode_state *st);
+int base64_decode_init(base64_decode_state *st);
+int base64_strict_decode_init(base64_decode_state *st);
+#endif
+
+#ifdef LTC_BASE64_URL
+int base64url_encode_init(base64_encode_state *st);
+int base64url_strict_encode_init(base64_encode_state *st);
+int base64url_decode_init(base64_decode_state *st);
+int base64url_strict_decode_init(base64_decode_state *st);
+#endif
+
 /* ===> LTC_HKDF -- RFC5869 HMAC-based Key Derivation Function <=== */
 #ifdef LTC_HKDF
 
@@ -42,17 +89,162 @@ int hkdf(int hash_idx,
          const unsigned char *in,   unsigned long inlen,
                unsigned char *out,  unsigned long outlen);
 
+/* reusable extracted-key context: extract once, expand many times off
+   the precomputed PRK-keyed HMAC midstates (see hkdf_prk.c) */
+typedef struct {
+   int              hash_idx;
+   unsigned long    hashsize;
+   hmac_precomputed hmac;       /* keyed with the PRK */
+} hkdf_prk;
+
+/* one entry of a batched expand */
+typedef struct {
+   const unsigned char *info;
+   unsigned long        infolen;
+   unsigned char       *out;
+   unsigned long        outlen;
+} hkdf_label;
+
+int hkdf_extract_prk(int hash_idx,
+                     const unsigned char *salt, unsigned long saltlen,
+                     const unsigned char *in,   unsigned long inlen,
+                     hkdf_prk *prk);
+
+int hkdf_expand_prk(const hkdf_prk *prk,
+                    const unsigned char *info, unsigned long infolen,
+                          unsigned char *out,  unsigned long outlen);
+
+int hkdf_expand_multi(const hkdf_prk *prk,
+                      const hkdf_label *labels, unsigned int nlabels);
+
+int hkdf_prk_done(hkdf_prk *prk);
+
 #endif  /* LTC_HKDF */
 
+/* ===> LTC_MHKDF -- memory-hard key derivation <=== */
+#ifdef LTC_MHKDF
+
+int mhkdf_test(void);
+
+/* scrypt-style ROMix over the hash descriptors; memory per lane is
+   cost * hashsize octets and with LTC_MHKDF_CONCURRENT the lanes run
+   on their own threads (see mhkdf.c) */
+int mhkdf(int hash_idx,
+          const unsigned char *password, unsigned long password_len,
+          const unsigned char *salt,     unsigned long salt_len,
+                unsigned long  cost,     unsigned int  lanes,
+                unsigned char *out,      unsigned long outlen);
+
+#endif  /* LTC_MHKDF */
+
 /* ---- MEM routines ---- */
 int mem_neq(const void *a, const void *b, size_t len);
+/* bulk dst = a ^ b with the word width probed at first use (see
+   xor_block.c); pin it with -DLTC_XORBUF_WIDTH=32|64|128 */
+void ltc_xorbuf(unsigned char *dst, const unsigned char *a,
+                const unsigned char *b, unsigned long len);
 void zeromem(volatile void *dst, size_t len);
+
+/* aligned-table allocator behind XMALLOC_ALIGNED/XFREE_ALIGNED */
+void *ltc_malloc_aligned(size_t size, size_t align);
+void ltc_free_aligned(void *ptr);
+
+#ifdef LTC_NUMA_REPLICA
+/* per-NUMA-node replication of read-only contexts (numa_replica.c) */
+#ifndef LTC_NUMA_MAX_NODES
+#define LTC_NUMA_MAX_NODES 8
+#endif
+typedef struct {
+   const void    *master;
+   unsigned long  size;
+   void          *replica[LTC_NUMA_MAX_NODES];
+   LTC_MUTEX_TYPE(lock)
+} ltc_replica_set;
+
+int ltc_numa_node(void);
+int ltc_replica_init(ltc_replica_set *set, const void *master, unsigned long size);
+int ltc_replica_get(ltc_replica_set *set, const void **ctx);
+int ltc_replica_done(ltc_replica_set *set);
+#endif
 void burn_stack(unsigned long len);
+/* deferred stack hygiene: with a nonzero policy burn_stack() only
+   records the largest requested length and burn_stack_flush() performs
+   one burn per batch (the bulk cipher modes flush per buffer).
+   Global, like the rest of LTC_CLEAN_STACK. */
+int  burn_stack_policy(int deferred);
+void burn_stack_flush(void);
+
+#ifdef LTC_SECURE_POOL
+/* mlock()ed slab arena for key-bearing allocations; point the
+   XMALLOC/XREALLOC/XCALLOC/XFREE hooks at the secure_pool functions to
+   keep key schedules and PRNG state off the swap device.  Requests
+   larger than the biggest size class (bulk buffers) still come from
+   the libc heap. */
+int  secure_pool_init(size_t poolsize);
+void secure_pool_done(void);
+void *secure_pool_alloc(size_t n);
+void *secure_pool_realloc(void *p, size_t n);
+void *secure_pool_calloc(size_t n, size_t s);
+void secure_pool_free(void *p);
+#endif
+
+#ifdef LTC_MEM_ACCOUNTING
+/* allocator accounting (see mem_accounting.c); point the XMALLOC hooks
+   at the ltc_acct_* functions and query live/peak bytes and call
+   counts per tag bucket.  Allocating entry points mark their bucket
+   with LTC_MEM_TAG before their first allocation. */
+typedef struct {
+   ulong64 allocs, frees, reallocs, live_bytes, peak_bytes;
+} ltc_mem_acct;
+
+void *ltc_acct_malloc(size_t n);
+void *ltc_acct_realloc(void *p, size_t n);
+void *ltc_acct_calloc(size_t n, size_t s);
+void ltc_acct_free(void *p);
+
+void ltc_mem_acct_tag(const char *tag);
+int  ltc_mem_acct_get(const char *tag, ltc_mem_acct *out);
+void ltc_mem_acct_reset(void);
+
+#define LTC_MEM_TAG(tag) ltc_mem_acct_tag(tag)
+#else
+#define LTC_MEM_TAG(tag)
+#endif
+
+#ifndef LTC_NO_FILE
+/* ---- chunked file driver shared by the *_file helpers ---- */
+int file_process(const char *fname,
+                 int (*process)(void *state, const unsigned char *buf, unsigned long len),
+                 void *state);
+int file_process_filehandle(FILE *in,
+                 int (*process)(void *state, const unsigned char *buf, unsigned long len),
+                 void *state);
+/* as file_process() but with a read in flight while the callback runs */
+int file_process_overlapped(const char *fname,
+                 int (*process)(void *state, const unsigned char *buf, unsigned long len),
+                 void *state);
+/* read/transform/write pipeline with all three stages overlapped; the
+   transform may grow its chunk in place by up to MAXBLOCKSIZE (padding)
+   or shrink it, and sees final nonzero exactly once, on the last chunk */
+int file_pipeline_filehandle(FILE *in, FILE *out,
+                 int (*transform)(void *state, unsigned char *buf, unsigned long *len, int final),
+                 void *state);
+#endif
 
 const char *error_to_string(int err);
 
 extern const char *crypt_build_settings;
 
+/* ---- read-mostly descriptor registry ---- */
+/* call once after all register_*() calls at startup; afterwards
+   find_*() and *_is_valid() are plain loads with no registry mutex and
+   further (un)registration is refused.  There is no unseal. */
+extern int ltc_registry_sealed;
+int crypt_registry_seal(void);
+/* seed the (empty) descriptor tables with every built-in algorithm in
+   one pass; pair with crypt_registry_seal() for two-call library init */
+int crypt_register_all_descriptors(void);
+
 /* ---- HMM ---- */
 int crypt_fsa(void *mp, ...);
 
@@ -60,6 +252,46 @@ int crypt_fsa(void *mp, ...);
 int crypt_get_constant(const char* namein, int *valueout);
 int crypt_list_all_constants(char *names_list, unsigned int *names_list_size);
 
+#ifdef LTC_STATS
+/* usage counters kept by the bulk entry points (see crypt_stats.c);
+   "slow" counts calls that could not take the fast path.  Updates are
+   unsynchronized on purpose -- treat snapshots as statistics. */
+enum {
+   LTC_STAT_ECB_ENCRYPT = 0,
+   LTC_STAT_ECB_DECRYPT,
+   LTC_STAT_CBC_ENCRYPT,
+   LTC_STAT_CBC_DECRYPT,
+   LTC_STAT_CTR_ENCRYPT,
+   LTC_STAT_GCM_PROCESS,
+   LTC_STAT_HASH,
+   LTC_STAT_OPS
+};
+
+typedef struct {
+   ulong64 calls, bytes, slow;
+} ltc_stat;
+
+void crypt_stats_bump(int op, int idx, unsigned long nbytes, int slow);
+int  crypt_stats_get(int op, int idx, ltc_stat *out);
+void crypt_stats_reset(void);
+
+#define LTC_STATS_BUMP(op, idx, nbytes, slow) crypt_stats_bump(op, idx, nbytes, slow)
+#else
+#define LTC_STATS_BUMP(op, idx, nbytes, slow)
+#endif
+
+/* runtime CPU capabilities, probed once and cached (see
+   crypt_cpu_features.c for the dispatch convention accelerated
+   backends follow).  Flag names are architecture neutral: LTC_CPU_AES
+   covers both AES-NI and the ARMv8 extension. */
+#define LTC_CPU_AES     0x00000001UL  /* hardware AES rounds          */
+#define LTC_CPU_CLMUL   0x00000002UL  /* carryless multiply (PCLMUL/PMULL) */
+#define LTC_CPU_SHA     0x00000004UL  /* SHA-1/SHA-256 instructions   */
+#define LTC_CPU_SSSE3   0x00000008UL  /* x86 only                     */
+#define LTC_CPU_SSE41   0x00000010UL  /* x86 only                     */
+#define LTC_CPU_AVX2    0x00000020UL  /* x86 only                     */
+unsigned long ltc_cpu_features(void);
+
 int crypt_get_size(const char* namein, unsigned int *sizeout);
 int crypt_list_all_sizes(char *names_list, unsigned int *names_list_size);
 
@@ -74,6 +306,9 @@ void init_TFM(void);
 void init_GMP(void);
 #endif
 */
+#if defined(LTM_DESC) && defined(TFM_DESC)
+int init_AUTO(int bits);
+#endif
 
 #ifdef LTC_ADLER32
 typedef struct adler32_state_s
@@ -99,6 +334,23 @@ void crc32_finish(crc32_state *ctx, void *hash, unsigned long size);
 int crc32_test(void);
 #endif
 
+#ifdef LTC_IVSEQ
+/* deterministic IV sequencer: 4 byte random prefix || 8 byte counter,
+ * 12 bytes total to suit the GCM/CCM short-IV fast path */
+#define LTC_IVSEQ_IVLEN 12
+
+typedef struct ivseq_state_s
+{
+   unsigned char prefix[4];   /* per-context random prefix */
+   ulong64       ctr;         /* next counter value */
+} ivseq_state;
+
+int ivseq_start(int wprng, prng_state *prng, ivseq_state *seq);
+int ivseq_next(ivseq_state *seq, unsigned char *IV, unsigned long *IVlen);
+int ivseq_done(ivseq_state *seq);
+int ivseq_test(void);
+#endif
+
 /* yeah it's not exactly in misc in the library, but in testprof/x86_prof.c */
 #if defined(LTC_TEST) && defined(LTC_TEST_DBG)
 void print_hex(const char* what, const void* v, const unsigned long l);
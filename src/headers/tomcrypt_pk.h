@@ -48,6 +48,25 @@ typedef struct Rsa_key {
     void *dP;
     /** The d mod (q - 1) CRT param */
     void *dQ;
+    /** Cached Montgomery reduction digits for p, q and N, from
+        mp_montgomery_setup().  Populated by rsa_mont_setup() (which
+        rsa_make_key and rsa_import call); NULL when absent.  Keys
+        filled in by hand must set these to NULL. */
+    void *mont_p, *mont_q, *mont_N;
+    /** Cached Montgomery normalization residues matching the above */
+    void *R_p, *R_q, *R_N;
+    /** Cached blinding pair (Vf = r^e mod N, Vi = 1/r mod N), seeded on
+        the first private operation and squared per use so fresh blinding
+        costs two modular multiplies instead of an exptmod.  NULL until
+        seeded; keys filled in by hand must set these to NULL. */
+    void *Vf, *Vi;
+    /** Cached DER public exports (raw RSAPublicKey and the PK_STD
+        SubjectPublicKeyInfo form), filled on the first public
+        rsa_export() so repeat exports are a memcpy.  NULL until then,
+        freed by rsa_free(); keys filled in by hand must set these to
+        NULL. */
+    unsigned char *pub_der, *pub_der_std;
+    unsigned long pub_der_len, pub_der_std_len;
 } rsa_key;
 
 int rsa_make_key(prng_state *prng, int wprng, int size, long e, rsa_key *key);
@@ -60,6 +79,9 @@ int rsa_exptmod(const unsigned char *in,   unsigned long inlen,
 
 void rsa_free(rsa_key *key);
 
+int rsa_mont_setup(rsa_key *key);
+void rsa_mont_free(rsa_key *key);
+
 /* These use PKCS #1 v2.0 padding */
 #define rsa_encrypt_key(_in, _inlen, _out, _outlen, _lparam, _lparamlen, _prng, _prng_idx, _hash_idx, _key) \
   rsa_encrypt_key_ex(_in, _inlen, _out, _outlen, _lparam, _lparamlen, _prng, _prng_idx, _hash_idx, LTC_PKCS_1_OAEP, _key)
@@ -88,6 +110,11 @@ int rsa_decrypt_key_ex(const unsigned char *in,       unsigned long  inlen,
                              int            hash_idx, int            padding,
                              int           *stat,     rsa_key       *key);
 
+int rsa_decrypt_key_ct(const unsigned char *in,      unsigned long  inlen,
+                             unsigned char *out,     unsigned long *outlen,
+                             unsigned char *scratch, unsigned long  scratchlen,
+                             int           *stat,    rsa_key       *key);
+
 int rsa_sign_hash_ex(const unsigned char *in,       unsigned long  inlen,
                            unsigned char *out,      unsigned long *outlen,
                            int            padding,
@@ -101,6 +128,12 @@ int rsa_verify_hash_ex(const unsigned char *sig,      unsigned long siglen,
                              int            hash_idx, unsigned long saltlen,
                              int           *stat,     rsa_key      *key);
 
+int rsa_verify_hash_batch(const unsigned char * const *sigs,   const unsigned long *siglens,
+                          const unsigned char * const *hashes, const unsigned long *hashlens,
+                                int            padding,
+                                int            hash_idx, unsigned long saltlen,
+                                int           *stat,     rsa_key * const *keys, int msgs);
+
 int rsa_sign_saltlen_get_max_ex(int padding, int hash_idx, rsa_key *key);
 
 /* PKCS #1 import/export */
@@ -181,6 +214,7 @@ int dh_get_size(dh_key *key);
 
 int dh_make_key(prng_state *prng, int wprng, int keysize, dh_key *key);
 void dh_free(dh_key *key);
+void dh_fixed_base_free(void);
 
 int dh_export(unsigned char *out, unsigned long *outlen, int type, dh_key *key);
 int dh_import(const unsigned char *in, unsigned long inlen, dh_key *key);
@@ -208,6 +242,62 @@ int dh_verify_hash(const unsigned char *sig,  unsigned long siglen,
 
 #endif
 
+/* ---- X25519 Routines ---- */
+#ifdef LTC_CURVE25519
+
+/** X25519 key (RFC 7748); fixed 32-octet scalars and u-coordinates,
+    no multiple precision state */
+typedef struct {
+   /** The key type, PK_PRIVATE or PK_PUBLIC */
+   int type;
+
+   /** The clamped private scalar */
+   unsigned char priv[32];
+
+   /** The public u-coordinate */
+   unsigned char pub[32];
+} x25519_key;
+
+int x25519_make_key(prng_state *prng, int wprng, x25519_key *key);
+int x25519_shared_secret(const x25519_key *private_key, const x25519_key *public_key,
+                         unsigned char *out, unsigned long *outlen);
+int x25519_export(unsigned char *out, unsigned long *outlen, int type, const x25519_key *key);
+int x25519_import(const unsigned char *in, unsigned long inlen, int type, x25519_key *key);
+void x25519_free(x25519_key *key);
+
+#endif
+
+/* ---- Ed25519 Routines ---- */
+#ifdef LTC_ED25519
+
+/** Ed25519 key (RFC 8032); fixed 32-octet seed and public point */
+typedef struct {
+   /** The key type, PK_PRIVATE or PK_PUBLIC */
+   int type;
+
+   /** The private seed */
+   unsigned char seed[32];
+
+   /** The compressed public point */
+   unsigned char pub[32];
+} ed25519_key;
+
+int ed25519_make_key(prng_state *prng, int wprng, ed25519_key *key);
+int ed25519_sign(const unsigned char *msg, unsigned long msglen,
+                       unsigned char *sig, unsigned long *siglen,
+                 const ed25519_key *key);
+int ed25519_verify(const unsigned char *msg, unsigned long msglen,
+                   const unsigned char *sig, unsigned long siglen,
+                   int *stat, const ed25519_key *key);
+int ed25519_verify_batch(const unsigned char * const *msgs, const unsigned long *msglens,
+                         const unsigned char * const *sigs, const unsigned long *siglens,
+                         int *stat, const ed25519_key * const *keys, int num,
+                         prng_state *prng, int wprng);
+int ed25519_export(unsigned char *out, unsigned long *outlen, int type, const ed25519_key *key);
+int ed25519_import(const unsigned char *in, unsigned long inlen, int type, ed25519_key *key);
+void ed25519_free(ed25519_key *key);
+
+#endif
 
 /* ---- ECC Routines ---- */
 #ifdef LTC_MECC
@@ -270,6 +360,18 @@ typedef struct {
 
     /** The private key */
     void *k;
+
+    /** Cached DER public export, filled on the first public
+        ecc_export() so repeat exports are a memcpy.  NULL until then,
+        freed by ecc_free(); keys filled in by hand must set this to
+        NULL. */
+    unsigned char *pub_der;
+    unsigned long pub_der_len;
+
+    /** Nonzero once ecc_key_seal() has fully validated this key; the
+        import paths clear it.  Sealed keys skip per-call re-validation
+        in the hot entry points. */
+    int sealed;
 } ecc_key;
 
 /** the ECC params provided */
@@ -290,10 +392,34 @@ int  ecc_import_ex(const unsigned char *in, unsigned long inlen, ecc_key *key, c
 int ecc_ansi_x963_export(ecc_key *key, unsigned char *out, unsigned long *outlen);
 int ecc_ansi_x963_import(const unsigned char *in, unsigned long inlen, ecc_key *key);
 int ecc_ansi_x963_import_ex(const unsigned char *in, unsigned long inlen, ecc_key *key, ltc_ecc_set_type *dp);
+int ecc_ansi_x963_import_raw(const unsigned char *in, unsigned long inlen, ecc_key *key, ltc_ecc_set_type *dp);
+int ecc_key_prealloc(ecc_key *key, const ltc_ecc_set_type *dp);
+int ecc_key_seal(ecc_key *key);
 
 int  ecc_shared_secret(ecc_key *private_key, ecc_key *public_key,
                        unsigned char *out, unsigned long *outlen);
 
+/** reusable scratch state for repeated EC-DH; saves the per-call
+    point/prime allocations of ecc_shared_secret() */
+typedef struct {
+   /** scratch point for the multiplied result */
+   ecc_point *result;
+   /** prime of the curve used on the last call */
+   void      *prime;
+   /** curve index the prime belongs to, -1 if none yet */
+   int        idx;
+} ecc_shared_ctx;
+
+int  ecc_shared_secret_ctx_init(ecc_shared_ctx *ctx);
+int  ecc_shared_secret_ctx(ecc_shared_ctx *ctx,
+                           ecc_key *private_key, ecc_key *public_key,
+                           unsigned char *out, unsigned long *outlen);
+int  ecc_shared_secret_batch(ecc_shared_ctx *ctx,
+                             ecc_key *private_key, ecc_key **public_keys,
+                             unsigned char **outs, unsigned long *outlens,
+                             int num);
+void ecc_shared_secret_ctx_free(ecc_shared_ctx *ctx);
+
 int  ecc_encrypt_key(const unsigned char *in,   unsigned long inlen,
                            unsigned char *out,  unsigned long *outlen,
                            prng_state *prng, int wprng, int hash,
@@ -319,6 +445,10 @@ int  ecc_verify_hash(const unsigned char *sig,  unsigned long siglen,
                      const unsigned char *hash, unsigned long hashlen,
                      int *stat, ecc_key *key);
 
+int  ecc_verify_hash_batch(const unsigned char **sigs,   const unsigned long *siglens,
+                           const unsigned char **hashes, const unsigned long *hashlens,
+                           int *stats, int num, ecc_key **keys);
+
 /* low level functions */
 ecc_point *ltc_ecc_new_point(void);
 void       ltc_ecc_del_point(ecc_point *p);
@@ -340,6 +470,10 @@ int ltc_ecc_fp_mulmod(void *k, ecc_point *G, ecc_point *R, void *modulus, int ma
 /* functions for saving/loading/freeing/adding to fixed point cache */
 int ltc_ecc_fp_save_state(unsigned char **out, unsigned long *outlen);
 int ltc_ecc_fp_restore_state(unsigned char *in, unsigned long inlen);
+#ifndef LTC_NO_FILE
+int ltc_ecc_fp_save_state_file(const char *fname);
+int ltc_ecc_fp_restore_state_file(const char *fname);
+#endif
 void ltc_ecc_fp_free(void);
 int ltc_ecc_fp_add_point(ecc_point *g, void *modulus, int lock);
 
@@ -350,6 +484,21 @@ void ltc_ecc_fp_tablelock(int lock);
 /* R = kG */
 int ltc_ecc_mulmod(void *k, ecc_point *G, ecc_point *R, void *modulus, int map);
 
+/* per-process cache of the Montgomery constants of a curve prime */
+int  ltc_ecc_mont_get(void *modulus, void **mp, void **mu, int *cached);
+void ltc_ecc_mont_cache_free(void);
+
+/* fixed base point multiplication off per-curve generator tables */
+int  ltc_ecc_fb_set_idx(const ltc_ecc_set_type *dp);
+int  ltc_ecc_fb_mulmod(int idx, void *k, ecc_point *R, void *modulus);
+void ltc_ecc_fixed_base_free(void);
+
+#ifdef LTC_ECC_P256
+/* constant-time fixed-limb backend for the NIST P-256 prime */
+int ltc_ecc_p256_accel_ok(void *k, ecc_point *G, void *modulus, int map);
+int ltc_ecc_p256_mulmod(void *k, ecc_point *G, ecc_point *R);
+#endif
+
 #ifdef LTC_ECC_SHAMIR
 /* kA*A + kB*B = C */
 int ltc_ecc_mul2add(ecc_point *A, void *kA,
@@ -380,6 +529,9 @@ int ltc_ecc_map(ecc_point *P, void *modulus, void *mp);
 /* Max DSA group size in bytes (default allows 4k-bit groups) */
 #define LTC_MDSA_MAX_GROUP 512
 
+/* Max precomputed {1/k, r} signing nonces held per key */
+#define LTC_MDSA_NONCE_POOL 16
+
 /** DSA key structure */
 typedef struct {
    /** The key type, PK_PRIVATE or PK_PUBLIC */
@@ -402,6 +554,21 @@ typedef struct {
 
    /** The public key */
    void *y;
+
+   /** Precomputed signing nonces, filled by dsa_presign() and consumed
+       by dsa_sign_hash_raw(); set nonce_count to zero on keys you fill
+       in by hand */
+   void *nonce_kinv[LTC_MDSA_NONCE_POOL];
+   void *nonce_r[LTC_MDSA_NONCE_POOL];
+   int   nonce_count;
+
+   /** Cached Montgomery context for p -- the reduction digit from
+       mp_montgomery_setup() and the normalization residue.  Filled by
+       dsa_mont_setup() (importers call it), consumed by the sign and
+       verify exponentiations, released by dsa_free().  Both stay NULL
+       when the math provider lacks the Montgomery hooks */
+   void *mont_p;
+   void *mont_pR;
 } dsa_key;
 
 int dsa_make_key(prng_state *prng, int wprng, int group_size, int modulus_size, dsa_key *key);
@@ -420,6 +587,10 @@ int dsa_sign_hash(const unsigned char *in,  unsigned long inlen,
                         unsigned char *out, unsigned long *outlen,
                         prng_state *prng, int wprng, dsa_key *key);
 
+int dsa_presign(prng_state *prng, int wprng, int count, dsa_key *key);
+
+int dsa_mont_setup(dsa_key *key);
+
 int dsa_verify_hash_raw(         void *r,          void *s,
                     const unsigned char *hash, unsigned long hashlen,
                                     int *stat,      dsa_key *key);
@@ -428,6 +599,25 @@ int dsa_verify_hash(const unsigned char *sig,  unsigned long siglen,
                     const unsigned char *hash, unsigned long hashlen,
                           int           *stat, dsa_key       *key);
 
+/** Fixed-base tables for batch verification under one key; the key is
+    borrowed and must outlive the context (dsa_verify_hash_batch.c) */
+typedef struct {
+   dsa_key *key;
+   int      digits;   /* 4-bit exponent digits per table */
+   void   **gtab;     /* generator table */
+   void   **ytab;     /* public-key table */
+} dsa_verify_ctx;
+
+int dsa_verify_ctx_init(dsa_verify_ctx *ctx, dsa_key *key);
+int dsa_verify_ctx_raw(dsa_verify_ctx *ctx, void *r, void *s,
+                       const unsigned char *hash, unsigned long hashlen,
+                       int *stat);
+int dsa_verify_hash_batch(dsa_verify_ctx *ctx,
+                          const unsigned char **sigs,  const unsigned long *siglens,
+                          const unsigned char **hashes, const unsigned long *hashlens,
+                          int *stats, unsigned long num);
+int dsa_verify_ctx_done(dsa_verify_ctx *ctx);
+
 int dsa_encrypt_key(const unsigned char *in,   unsigned long inlen,
                           unsigned char *out,  unsigned long *outlen,
                           prng_state *prng, int wprng, int hash,
@@ -504,6 +694,9 @@ typedef struct ltc_asn1_list_ {
    } while (0)
 
 /* SEQUENCE */
+int der_encode_sequence_single(ltc_asn1_list *list, unsigned long inlen,
+                               unsigned char *out,  unsigned long *outlen);
+
 int der_encode_sequence_ex(ltc_asn1_list *list, unsigned long inlen,
                            unsigned char *out,  unsigned long *outlen, int type_of);
 
@@ -543,6 +736,59 @@ int der_decode_sequence_multi(const unsigned char *in, unsigned long inlen, ...)
 int  der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc_asn1_list **out);
 #define der_free_sequence_flexi         der_sequence_free
 void der_sequence_free(ltc_asn1_list *in);
+
+/* caller supplied bump arena for der_decode_sequence_flexi_arena */
+typedef struct {
+   unsigned char *base;   /* start of the arena memory */
+   unsigned long  size;   /* total size of the arena in octets */
+   unsigned long  used;   /* octets carved so far, set to 0 before first use */
+} ltc_asn1_arena;
+
+int  der_decode_sequence_flexi_arena(const unsigned char *in, unsigned long *inlen, ltc_asn1_list **out, ltc_asn1_arena *arena);
+void der_sequence_arena_free(ltc_asn1_list *in);
+
+/* string-ish payloads borrow pointers into the (immutable) input instead of copying */
+#define LTC_DER_FLEXI_BORROW 0x0001
+
+int  der_decode_sequence_flexi_ex(const unsigned char *in, unsigned long *inlen, ltc_asn1_list **out, ltc_asn1_arena *arena, int flags);
+void der_sequence_free_ex(ltc_asn1_list *in, int flags);
+
+/* streaming DER decoder: feed chunks, receive TLV events, constant memory */
+#define LTC_DER_STREAM_DEPTH 32
+
+/* event codes passed to the der_stream callback */
+#define LTC_DER_STREAM_BEGIN 0   /* element header parsed; len is the content length */
+#define LTC_DER_STREAM_DATA  1   /* slice of a primitive element's content */
+#define LTC_DER_STREAM_END   2   /* element complete */
+
+typedef struct der_stream_st {
+   /** Receives the TLV events; data is NULL except for DATA slices.
+       Return CRYPT_OK to continue, anything else aborts the feed. */
+   int (*event)(int ev, unsigned long depth, unsigned long tag,
+                const unsigned char *data, unsigned long len, void *user);
+   void *user;
+
+   /* raw header octets of the element a BEGIN event reports */
+   unsigned char hdr[6];
+   unsigned long hdrlen;
+
+   /* internals */
+   int           state;
+   int           depth;
+   unsigned long tag;
+   unsigned long len;
+   unsigned long lenlen;
+   unsigned long need;
+   unsigned long tagstack[LTC_DER_STREAM_DEPTH];
+   unsigned long remain[LTC_DER_STREAM_DEPTH];
+} der_stream_state;
+
+int der_stream_init(der_stream_state *ds,
+                    int (*event)(int ev, unsigned long depth, unsigned long tag,
+                                 const unsigned char *data, unsigned long len, void *user),
+                    void *user);
+int der_stream_feed(der_stream_state *ds, const unsigned char *in, unsigned long inlen);
+int der_stream_done(der_stream_state *ds);
 void der_sequence_shrink(ltc_asn1_list *in);
 
 /* BOOLEAN */
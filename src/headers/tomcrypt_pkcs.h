@@ -90,6 +90,38 @@ int pkcs_5_alg2(const unsigned char *password, unsigned long password_len,
                 int iteration_count,           int hash_idx,
                 unsigned char *out,            unsigned long *outlen);
 
+/* Reusable derivation context: password (and, for v2, its HMAC
+   midstate) absorbed once at init, then each derive writes into caller
+   storage with no per-call allocation.  Algorithm 1 through the
+   context honors the full salt length instead of the fixed 8 octets
+   of the one-shot entry point. */
+#define LTC_PKCS_5_V1          1
+#define LTC_PKCS_5_V1_OPENSSL  2
+#define LTC_PKCS_5_V2          3
+
+typedef struct {
+   int              alg;
+   int              hash_idx;
+   int              iteration_count;
+   unsigned long    password_len;
+   unsigned long    salt_len;
+   /** one heap block holds password||salt; salt points into it */
+   unsigned char   *password;
+   unsigned char   *salt;
+   /** v2 PRF midstate: the password's padded key blocks, hashed once */
+   hmac_precomputed pre;
+} pkcs_5_state;
+
+int pkcs_5_init(pkcs_5_state *kdf, int alg,
+                const unsigned char *password, unsigned long password_len,
+                const unsigned char *salt,     unsigned long salt_len,
+                int iteration_count, int hash_idx);
+int pkcs_5_derive(pkcs_5_state *kdf, unsigned char *out, unsigned long *outlen);
+int pkcs_5_derive_salt(pkcs_5_state *kdf,
+                       const unsigned char *salt, unsigned long salt_len,
+                       unsigned char *out, unsigned long *outlen);
+int pkcs_5_done(pkcs_5_state *kdf);
+
 int pkcs_5_test (void);
 #endif  /* LTC_PKCS_5 */
 
@@ -37,7 +37,27 @@ struct fortuna_prng {
                   pool0_len,  /* length of 0'th pool */
                   wd;
 
+    unsigned char evbuf[LTC_FORTUNA_EVENT_BUF]; /* batched entropy events */
+    unsigned long evlen;      /* bytes used in evbuf */
+
+    unsigned char stage[32];  /* pool digest folded off the reader path */
+    int           stage_ready; /* stage holds a pending fold 0-1 */
+
     ulong64       reset_cnt;  /* number of times we have reset */
+    unsigned long pid;        /* process id at keying time, fork detection */
+    LTC_MUTEX_TYPE(prng_lock)
+};
+#endif
+
+#ifdef LTC_CTR_DRBG
+struct ctr_drbg_prng {
+    symmetric_key skey;
+    unsigned char K[32],      /* the current key */
+                  V[16];      /* the counter block */
+    unsigned char ent[48];    /* seed material before ready */
+    unsigned long idx;        /* seed material counter */
+    ulong64       reseed_cnt; /* generate requests since (re)seeding */
+    short ready;              /* ready flag 0-1 */
     LTC_MUTEX_TYPE(prng_lock)
 };
 #endif
@@ -70,6 +90,9 @@ typedef union Prng_state {
 #ifdef LTC_FORTUNA
     struct fortuna_prng   fortuna;
 #endif
+#ifdef LTC_CTR_DRBG
+    struct ctr_drbg_prng  ctr_drbg;
+#endif
 #ifdef LTC_SOBER128
     struct sober128_prng  sober128;
 #endif
@@ -128,6 +151,25 @@ extern struct ltc_prng_descriptor {
         @return CRYPT_OK if successful, CRYPT_NOP if self-testing has been disabled
     */
     int (*test)(void);
+    /** Fill a large buffer in one shot; state lock taken once and
+        blocks batched internally, so callers need no chunking loop.
+        Optional (NULL on PRNGs without one).
+        @param out     [out] Where to store the data
+        @param outlen  Length of data desired (octets)
+        @param prng    The PRNG state to read from
+        @return CRYPT_OK if the whole buffer was filled
+    */
+    int (*fill)(unsigned char *out, unsigned long outlen, prng_state *prng);
+    /** Instantiate directly from a seed in one call, skipping the
+        add_entropy/ready accumulation machinery; for one-off PRNGs
+        seeded from the system RNG.  Optional (NULL on PRNGs without
+        one).
+        @param in     The seed material
+        @param inlen  Length of the seed material (octets)
+        @param prng   [out] The PRNG state to instantiate
+        @return CRYPT_OK if successful
+    */
+    int (*seed)(const unsigned char *in, unsigned long inlen, prng_state *prng);
 } prng_descriptor[];
 
 #ifdef LTC_YARROW
@@ -148,10 +190,19 @@ int fortuna_add_entropy(const unsigned char *in, unsigned long inlen, prng_state
 int fortuna_ready(prng_state *prng);
 unsigned long fortuna_read(unsigned char *out, unsigned long outlen, prng_state *prng);
 int fortuna_done(prng_state *prng);
+int fortuna_fill(unsigned char *out, unsigned long outlen, prng_state *prng);
+int fortuna_seed(const unsigned char *in, unsigned long inlen, prng_state *prng);
+int fortuna_maintenance(prng_state *prng);
 int  fortuna_export(unsigned char *out, unsigned long *outlen, prng_state *prng);
 int  fortuna_import(const unsigned char *in, unsigned long inlen, prng_state *prng);
 int  fortuna_test(void);
 extern const struct ltc_prng_descriptor fortuna_desc;
+#ifdef LTC_PTHREAD
+/* per-thread output generators keyed from a shared state, fortuna_tl.c */
+int fortuna_tl_start(prng_state *prng);
+unsigned long fortuna_tl_read(unsigned char *out, unsigned long outlen);
+int fortuna_tl_done(void);
+#endif
 #endif
 
 #ifdef LTC_RC4
@@ -172,18 +223,36 @@ int chacha20_prng_add_entropy(const unsigned char *in, unsigned long inlen, prng
 int chacha20_prng_ready(prng_state *prng);
 unsigned long chacha20_prng_read(unsigned char *out, unsigned long outlen, prng_state *prng);
 int  chacha20_prng_done(prng_state *prng);
+int  chacha20_prng_fill(unsigned char *out, unsigned long outlen, prng_state *prng);
+int  chacha20_prng_seed(const unsigned char *in, unsigned long inlen, prng_state *prng);
 int  chacha20_prng_export(unsigned char *out, unsigned long *outlen, prng_state *prng);
 int  chacha20_prng_import(const unsigned char *in, unsigned long inlen, prng_state *prng);
 int  chacha20_prng_test(void);
 extern const struct ltc_prng_descriptor chacha20_prng_desc;
 #endif
 
+#ifdef LTC_CTR_DRBG
+int ctr_drbg_start(prng_state *prng);
+int ctr_drbg_add_entropy(const unsigned char *in, unsigned long inlen, prng_state *prng);
+int ctr_drbg_ready(prng_state *prng);
+unsigned long ctr_drbg_read(unsigned char *out, unsigned long outlen, prng_state *prng);
+int  ctr_drbg_done(prng_state *prng);
+int  ctr_drbg_fill(unsigned char *out, unsigned long outlen, prng_state *prng);
+int  ctr_drbg_seed(const unsigned char *in, unsigned long inlen, prng_state *prng);
+int  ctr_drbg_export(unsigned char *out, unsigned long *outlen, prng_state *prng);
+int  ctr_drbg_import(const unsigned char *in, unsigned long inlen, prng_state *prng);
+int  ctr_drbg_test(void);
+extern const struct ltc_prng_descriptor ctr_drbg_desc;
+#endif
+
 #ifdef LTC_SPRNG
 int sprng_start(prng_state *prng);
 int sprng_add_entropy(const unsigned char *in, unsigned long inlen, prng_state *prng);
 int sprng_ready(prng_state *prng);
 unsigned long sprng_read(unsigned char *out, unsigned long outlen, prng_state *prng);
 int sprng_done(prng_state *prng);
+int sprng_fill(unsigned char *out, unsigned long outlen, prng_state *prng);
+int sprng_seed(const unsigned char *in, unsigned long inlen, prng_state *prng);
 int  sprng_export(unsigned char *out, unsigned long *outlen, prng_state *prng);
 int  sprng_import(const unsigned char *in, unsigned long inlen, prng_state *prng);
 int  sprng_test(void);
@@ -203,6 +272,8 @@ extern const struct ltc_prng_descriptor sober128_desc;
 #endif
 
 int find_prng(const char *name);
+/* drop the cached name index; called by (un)register_prng with ltc_prng_mutex held */
+void prng_name_index_invalidate(void);
 int register_prng(const struct ltc_prng_descriptor *prng);
 int unregister_prng(const struct ltc_prng_descriptor *prng);
 int prng_is_valid(int idx);
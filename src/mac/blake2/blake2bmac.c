@@ -0,0 +1,76 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file blake2bmac.c
+   Keyed BLAKE2b as a MAC, by Tom St Denis
+
+   BLAKE2 keys through its parameter block, so the keyed hash IS the
+   MAC -- no ipad/opad, half the compression calls of HMAC-BLAKE2b.
+   Use HMAC only where the peer insists on it.
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_BLAKE2BMAC
+
+/**
+   Initialize a BLAKE2b MAC context
+   @param st      The BLAKE2b MAC state
+   @param key     The secret key
+   @param keylen  The length of the secret key (octets, 1..64)
+   @param maclen  The MAC output size (octets, 1..64)
+   @return CRYPT_OK on success
+*/
+int blake2bmac_init(blake2bmac_state *st, const unsigned char *key, unsigned long keylen, unsigned long maclen)
+{
+   LTC_ARGCHK(st  != NULL);
+   LTC_ARGCHK(key != NULL);
+   return blake2b_init(st, maclen, key, keylen);
+}
+
+/**
+   Process data through a BLAKE2b MAC
+   @param st     The BLAKE2b MAC state
+   @param in     The data to send through the MAC
+   @param inlen  The length of the data (octets)
+   @return CRYPT_OK on success
+*/
+int blake2bmac_process(blake2bmac_state *st, const unsigned char *in, unsigned long inlen)
+{
+   if (inlen == 0) return CRYPT_OK;
+   LTC_ARGCHK(st != NULL);
+   LTC_ARGCHK(in != NULL);
+   return blake2b_process(st, in, inlen);
+}
+
+/**
+   Terminate a BLAKE2b MAC
+   @param st      The BLAKE2b MAC state
+   @param mac     [out] The destination of the MAC
+   @param maclen  [in/out] The max size and resulting size of the MAC
+   @return CRYPT_OK on success
+*/
+int blake2bmac_done(blake2bmac_state *st, unsigned char *mac, unsigned long *maclen)
+{
+   LTC_ARGCHK(st     != NULL);
+   LTC_ARGCHK(mac    != NULL);
+   LTC_ARGCHK(maclen != NULL);
+   LTC_ARGCHK(*maclen >= st->blake2b.outlen);
+
+   *maclen = st->blake2b.outlen;
+   return blake2b_done(st, mac);
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
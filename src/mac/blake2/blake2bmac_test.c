@@ -0,0 +1,85 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file blake2bmac_test.c
+   Keyed BLAKE2b MAC self test, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_BLAKE2BMAC
+
+/**
+  Test the BLAKE2b MAC implementation
+  @return CRYPT_OK on success
+*/
+int blake2bmac_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   /* official BLAKE2b keyed KAT: key = 00..3f, msg = 00..n-1 */
+   static const unsigned char t0[64] = {
+      0x10,0xeb,0xb6,0x77,0x00,0xb1,0x86,0x8e,0xfb,0x44,0x17,0x98,0x7a,0xcf,0x46,0x90,
+      0xae,0x9d,0x97,0x2f,0xb7,0xa5,0x90,0xc2,0xf0,0x28,0x71,0x79,0x9a,0xaa,0x47,0x86,
+      0xb5,0xe9,0x96,0xe8,0xf0,0xf4,0xeb,0x98,0x1f,0xc2,0x14,0xb0,0x05,0xf4,0x2d,0x2f,
+      0xf4,0x23,0x34,0x99,0x39,0x16,0x53,0xdf,0x7a,0xef,0xcb,0xc1,0x3f,0xc5,0x15,0x68 };
+   static const unsigned char t1[64] = {
+      0x96,0x1f,0x6d,0xd1,0xe4,0xdd,0x30,0xf6,0x39,0x01,0x69,0x0c,0x51,0x2e,0x78,0xe4,
+      0xb4,0x5e,0x47,0x42,0xed,0x19,0x7c,0x3c,0x5e,0x45,0xc5,0x49,0xfd,0x25,0xf2,0xe4,
+      0x18,0x7b,0x0b,0xc9,0xfe,0x30,0x49,0x2b,0x16,0xb0,0xd0,0xbc,0x4e,0xf9,0xb0,0xf3,
+      0x4c,0x70,0x03,0xfa,0xc0,0x9a,0x5e,0xf1,0x53,0x2e,0x69,0x43,0x02,0x34,0xce,0xbd };
+   static const unsigned char t255[64] = {
+      0x14,0x27,0x09,0xd6,0x2e,0x28,0xfc,0xcc,0xd0,0xaf,0x97,0xfa,0xd0,0xf8,0x46,0x5b,
+      0x97,0x1e,0x82,0x20,0x1d,0xc5,0x10,0x70,0xfa,0xa0,0x37,0x2a,0xa4,0x3e,0x92,0x48,
+      0x4b,0xe1,0xc1,0xe7,0x3b,0xa1,0x09,0x06,0xd5,0xd1,0x85,0x3d,0xb6,0xa4,0x10,0x6e,
+      0x0a,0x7b,0xf9,0x80,0x0d,0x37,0x3d,0x6d,0xee,0x2d,0x46,0xd6,0x2e,0xf2,0xa4,0x61 };
+   /* 256-bit tag with a 32-octet key over "abc" */
+   static const unsigned char t32[32] = {
+      0xd6,0x3a,0x32,0xd3,0xe4,0x47,0x38,0xd7,0x90,0x7f,0x96,0x43,0x16,0xc2,0x41,0xad,
+      0xab,0xa0,0xab,0xfe,0xab,0xc3,0x23,0x49,0x67,0x75,0x78,0xa1,0x5a,0x20,0x3f,0x7f };
+   unsigned char key[64], msg[255], mac[64];
+   unsigned long maclen;
+   blake2bmac_state st;
+   int i, err;
+
+   for (i = 0; i < 64; i++)  key[i] = (unsigned char)i;
+   for (i = 0; i < 255; i++) msg[i] = (unsigned char)i;
+
+   maclen = sizeof(mac);
+   if ((err = blake2bmac_memory(key, 64, msg, 0, mac, &maclen)) != CRYPT_OK) return err;
+   if (compare_testvector(mac, maclen, t0, 64, "BLAKE2bMAC", 0) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   maclen = sizeof(mac);
+   if ((err = blake2bmac_memory(key, 64, msg, 1, mac, &maclen)) != CRYPT_OK) return err;
+   if (compare_testvector(mac, maclen, t1, 64, "BLAKE2bMAC", 1) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   maclen = sizeof(mac);
+   if ((err = blake2bmac_memory(key, 64, msg, 255, mac, &maclen)) != CRYPT_OK) return err;
+   if (compare_testvector(mac, maclen, t255, 64, "BLAKE2bMAC", 2) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   /* streaming in uneven chunks must agree, truncated output too */
+   if ((err = blake2bmac_init(&st, key, 32, 32)) != CRYPT_OK) return err;
+   if ((err = blake2bmac_process(&st, (const unsigned char *)"a", 1)) != CRYPT_OK) return err;
+   if ((err = blake2bmac_process(&st, (const unsigned char *)"bc", 2)) != CRYPT_OK) return err;
+   maclen = sizeof(mac);
+   if ((err = blake2bmac_done(&st, mac, &maclen)) != CRYPT_OK) return err;
+   if (compare_testvector(mac, maclen, t32, 32, "BLAKE2bMAC", 3) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   return CRYPT_OK;
+#endif
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
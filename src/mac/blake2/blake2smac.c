@@ -0,0 +1,76 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file blake2smac.c
+   Keyed BLAKE2s as a MAC, by Tom St Denis
+
+   BLAKE2 keys through its parameter block, so the keyed hash IS the
+   MAC -- no ipad/opad, half the compression calls of HMAC-BLAKE2s.
+   Use HMAC only where the peer insists on it.
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_BLAKE2SMAC
+
+/**
+   Initialize a BLAKE2s MAC context
+   @param st      The BLAKE2s MAC state
+   @param key     The secret key
+   @param keylen  The length of the secret key (octets, 1..32)
+   @param maclen  The MAC output size (octets, 1..32)
+   @return CRYPT_OK on success
+*/
+int blake2smac_init(blake2smac_state *st, const unsigned char *key, unsigned long keylen, unsigned long maclen)
+{
+   LTC_ARGCHK(st  != NULL);
+   LTC_ARGCHK(key != NULL);
+   return blake2s_init(st, maclen, key, keylen);
+}
+
+/**
+   Process data through a BLAKE2s MAC
+   @param st     The BLAKE2s MAC state
+   @param in     The data to send through the MAC
+   @param inlen  The length of the data (octets)
+   @return CRYPT_OK on success
+*/
+int blake2smac_process(blake2smac_state *st, const unsigned char *in, unsigned long inlen)
+{
+   if (inlen == 0) return CRYPT_OK;
+   LTC_ARGCHK(st != NULL);
+   LTC_ARGCHK(in != NULL);
+   return blake2s_process(st, in, inlen);
+}
+
+/**
+   Terminate a BLAKE2s MAC
+   @param st      The BLAKE2s MAC state
+   @param mac     [out] The destination of the MAC
+   @param maclen  [in/out] The max size and resulting size of the MAC
+   @return CRYPT_OK on success
+*/
+int blake2smac_done(blake2smac_state *st, unsigned char *mac, unsigned long *maclen)
+{
+   LTC_ARGCHK(st     != NULL);
+   LTC_ARGCHK(mac    != NULL);
+   LTC_ARGCHK(maclen != NULL);
+   LTC_ARGCHK(*maclen >= st->blake2s.outlen);
+
+   *maclen = st->blake2s.outlen;
+   return blake2s_done(st, mac);
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,57 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file blake2smac_memory.c
+   Keyed BLAKE2s MAC of a buffer in one call, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_BLAKE2SMAC
+
+/**
+   BLAKE2s MAC a block of memory to produce the authentication tag
+   @param key     The secret key
+   @param keylen  The length of the secret key (octets, 1..32)
+   @param in      The data to MAC
+   @param inlen   The length of the data (octets)
+   @param mac     [out] Destination of the authentication tag
+   @param maclen  [in/out] Max size and resulting size of authentication tag
+   @return CRYPT_OK on success
+*/
+int blake2smac_memory(const unsigned char *key, unsigned long keylen,
+                      const unsigned char *in,  unsigned long inlen,
+                            unsigned char *mac, unsigned long *maclen)
+{
+   blake2smac_state st;
+   int err;
+
+   LTC_ARGCHK(maclen != NULL);
+
+   if ((err = blake2smac_init(&st, key, keylen, MIN(*maclen, 32))) != CRYPT_OK) {
+      goto error;
+   }
+   if ((err = blake2smac_process(&st, in, inlen)) != CRYPT_OK) {
+      goto error;
+   }
+   err = blake2smac_done(&st, mac, maclen);
+error:
+#ifdef LTC_CLEAN_STACK
+   zeromem(&st, sizeof(st));
+#endif
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,70 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file blake2smac_test.c
+   Keyed BLAKE2s MAC self test, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_BLAKE2SMAC
+
+/**
+  Test the BLAKE2s MAC implementation
+  @return CRYPT_OK on success
+*/
+int blake2smac_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   /* official BLAKE2s keyed KAT: key = 00..1f, msg = 00..n-1 */
+   static const unsigned char t0[32] = {
+      0x48,0xa8,0x99,0x7d,0xa4,0x07,0x87,0x6b,0x3d,0x79,0xc0,0xd9,0x23,0x25,0xad,0x3b,
+      0x89,0xcb,0xb7,0x54,0xd8,0x6a,0xb7,0x1a,0xee,0x04,0x7a,0xd3,0x45,0xfd,0x2c,0x49 };
+   static const unsigned char t1[32] = {
+      0x40,0xd1,0x5f,0xee,0x7c,0x32,0x88,0x30,0x16,0x6a,0xc3,0xf9,0x18,0x65,0x0f,0x80,
+      0x7e,0x7e,0x01,0xe1,0x77,0x25,0x8c,0xdc,0x0a,0x39,0xb1,0x1f,0x59,0x80,0x66,0xf1 };
+   /* 128-bit tag with a 16-octet key over "abc" */
+   static const unsigned char t16[16] = {
+      0x75,0x29,0x6c,0x2d,0x2c,0x0f,0x51,0x21,0x0b,0x38,0x3f,0x38,0x6b,0xc8,0xb1,0xff };
+   unsigned char key[32], msg[1], mac[32];
+   unsigned long maclen;
+   blake2smac_state st;
+   int i, err;
+
+   for (i = 0; i < 32; i++) key[i] = (unsigned char)i;
+   msg[0] = 0;
+
+   maclen = sizeof(mac);
+   if ((err = blake2smac_memory(key, 32, msg, 0, mac, &maclen)) != CRYPT_OK) return err;
+   if (compare_testvector(mac, maclen, t0, 32, "BLAKE2sMAC", 0) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   maclen = sizeof(mac);
+   if ((err = blake2smac_memory(key, 32, msg, 1, mac, &maclen)) != CRYPT_OK) return err;
+   if (compare_testvector(mac, maclen, t1, 32, "BLAKE2sMAC", 1) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   if ((err = blake2smac_init(&st, key, 16, 16)) != CRYPT_OK) return err;
+   if ((err = blake2smac_process(&st, (const unsigned char *)"ab", 2)) != CRYPT_OK) return err;
+   if ((err = blake2smac_process(&st, (const unsigned char *)"c", 1)) != CRYPT_OK) return err;
+   maclen = sizeof(mac);
+   if ((err = blake2smac_done(&st, mac, &maclen)) != CRYPT_OK) return err;
+   if (compare_testvector(mac, maclen, t16, 16, "BLAKE2sMAC", 2) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   return CRYPT_OK;
+#endif
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,155 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file f9_memory_batch.c
+  f9 Support, many messages under one key
+*/
+
+#ifdef LTC_F9_MODE
+
+/** f9-MAC many messages under one key.  Both key schedules (the main
+  key and the key XORed with 0xAA used for the final encryption) run
+  once and are shared across the whole batch, where the one-shot path
+  pays for them on every message.  When the cipher provides
+  accel_ecb_encrypt the chains of four messages are interleaved four
+  blocks per call and the four tag encryptions go out as one call.
+  @param cipher  Index of cipher to use
+  @param key     [in]  Secret key
+  @param keylen  Length of secret key in octets
+  @param in      The array of messages
+  @param inlen   The lengths of the messages (octets)
+  @param out     [out] The array of destinations of the tags
+  @param outlen  [in/out] Destination size and final tag size (applies to every tag)
+  @param msgs    The number of messages
+  Return CRYPT_OK on success
+*/
+int f9_memory_batch(int cipher,
+               const unsigned char *key, unsigned long keylen,
+               const unsigned char * const *in, const unsigned long *inlen,
+                     unsigned char * const *out, unsigned long *outlen, int msgs)
+{
+   f9_state      tmpl, st[4];
+   symmetric_key akey;
+   unsigned long taglen, blklen, y;
+   int           err, x, j;
+
+   LTC_ARGCHK(key    != NULL);
+   LTC_ARGCHK(outlen != NULL);
+   LTC_ARGCHK(in     != NULL || msgs == 0);
+   LTC_ARGCHK(inlen  != NULL || msgs == 0);
+   LTC_ARGCHK(out    != NULL || msgs == 0);
+
+   if ((err = f9_init(&tmpl, cipher, key, keylen)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = cipher_descriptor[cipher].setup(tmpl.akey, keylen, 0, &akey)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   blklen = tmpl.blocksize;
+   taglen = *outlen;
+   if (taglen > blklen) {
+      taglen = blklen;
+   }
+
+   x = 0;
+   if (cipher_descriptor[cipher].accel_ecb_encrypt != NULL) {
+      while (msgs - x >= 4) {
+         unsigned char W[4*MAXBLOCKSIZE];
+         unsigned long blks, b, pos[4];
+
+         blks = inlen[x] / blklen;
+         for (j = 0; j < 4; j++) {
+            XMEMCPY(&st[j], &tmpl, sizeof(tmpl));
+            pos[j] = 0;
+            b = inlen[x + j] / blklen;
+            if (b < blks) {
+               blks = b;
+            }
+         }
+
+         /* the whole blocks every lane has, four chains interleaved */
+         for (b = 0; b < blks; b++) {
+            for (j = 0; j < 4; j++) {
+               for (y = 0; y < blklen; y++) {
+                  W[j*blklen + y] = st[j].IV[y] ^ in[x + j][pos[j] + y];
+               }
+            }
+            if ((err = cipher_descriptor[cipher].accel_ecb_encrypt(W, W, 4, &tmpl.key)) != CRYPT_OK) {
+               goto LBL_ERR2;
+            }
+            for (j = 0; j < 4; j++) {
+               XMEMCPY(st[j].IV, W + j*blklen, blklen);
+               for (y = 0; y < blklen; y++) {
+                  st[j].ACC[y] ^= st[j].IV[y];
+               }
+               pos[j] += blklen;
+            }
+         }
+
+         /* per-lane leftovers, then encrypt the four ACCs in one go */
+         for (j = 0; j < 4; j++) {
+            if ((err = f9_process(&st[j], in[x + j] + pos[j], inlen[x + j] - pos[j])) != CRYPT_OK) {
+               goto LBL_ERR2;
+            }
+            if (st[j].buflen != 0) {
+               cipher_descriptor[cipher].ecb_encrypt(st[j].IV, st[j].IV, &st[j].key);
+               for (y = 0; y < blklen; y++) {
+                  st[j].ACC[y] ^= st[j].IV[y];
+               }
+            }
+            XMEMCPY(W + j*blklen, st[j].ACC, blklen);
+         }
+         if ((err = cipher_descriptor[cipher].accel_ecb_encrypt(W, W, 4, &akey)) != CRYPT_OK) {
+            goto LBL_ERR2;
+         }
+         for (j = 0; j < 4; j++) {
+            XMEMCPY(out[x + j], W + j*blklen, taglen);
+         }
+         x += 4;
+      }
+   }
+
+   for (; x < msgs; x++) {
+      XMEMCPY(&st[0], &tmpl, sizeof(tmpl));
+      if ((err = f9_process(&st[0], in[x], inlen[x])) != CRYPT_OK) {
+         goto LBL_ERR2;
+      }
+      if (st[0].buflen != 0) {
+         cipher_descriptor[cipher].ecb_encrypt(st[0].IV, st[0].IV, &st[0].key);
+         for (y = 0; y < blklen; y++) {
+            st[0].ACC[y] ^= st[0].IV[y];
+         }
+      }
+      cipher_descriptor[cipher].ecb_encrypt(st[0].ACC, st[0].ACC, &akey);
+      XMEMCPY(out[x], st[0].ACC, taglen);
+   }
+
+   *outlen = taglen;
+   err = CRYPT_OK;
+LBL_ERR2:
+   cipher_descriptor[cipher].done(&akey);
+LBL_ERR:
+   cipher_descriptor[cipher].done(&tmpl.key);
+#ifdef LTC_CLEAN_STACK
+   zeromem(&tmpl, sizeof(tmpl));
+   zeromem(st, sizeof(st));
+   zeromem(&akey, sizeof(akey));
+#endif
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,68 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gmac_done.c
+   GMAC implementation, produce the tag, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_MODE
+
+/**
+  Terminate a GMAC message and emit the tag
+  @param st      The GMAC state
+  @param tag     [out] The destination for the MAC tag
+  @param taglen  [in/out] The length of the tag (octets, at most 16)
+  @return CRYPT_OK on success
+ */
+int gmac_done(gmac_state *st, unsigned char *tag, unsigned long *taglen)
+{
+   gcm_state *gcm;
+   unsigned long x;
+
+   LTC_ARGCHK(st     != NULL);
+   LTC_ARGCHK(tag    != NULL);
+   LTC_ARGCHK(taglen != NULL);
+
+   gcm = &st->gcm;
+   if (st->started != 1 || gcm->mode != LTC_GCM_MODE_AAD) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* flush a buffered partial block */
+   if (gcm->buflen) {
+      gcm->totlen += gcm->buflen * CONST64(8);
+      gcm_mult_h(gcm, gcm->X);
+   }
+
+   /* fold in len(A) || len(C); C is always empty for GMAC */
+   STORE64H(gcm->totlen, gcm->buf);
+   zeromem(gcm->buf + 8, 8);
+   for (x = 0; x < 16; x++) {
+      gcm->X[x] ^= gcm->buf[x];
+   }
+   gcm_mult_h(gcm, gcm->X);
+
+   /* mask with E(K, Y0) computed back in gmac_start() */
+   *taglen = MIN(*taglen, 16);
+   for (x = 0; x < *taglen; x++) {
+      tag[x] = gcm->X[x] ^ st->mask[x];
+   }
+   st->started = 0;
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,52 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gmac_init.c
+   GMAC implementation, initialize state, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_MODE
+
+/**
+  Initialize a GMAC state with a key
+
+  GMAC is GCM's GHASH over the message with no encryption: the only
+  cipher call per message is the tag mask in gmac_start().  Use this
+  instead of driving gcm_add_aad()/gcm_done() by hand when you only
+  authenticate -- the data path skips GCM's CTR setup entirely.
+
+  @param st      The GMAC state to initialize
+  @param cipher  The index of the cipher to use (must have a 128-bit block)
+  @param key     The secret key
+  @param keylen  The length of the secret key (octets)
+  @return CRYPT_OK on success
+ */
+int gmac_init(gmac_state *st, int cipher, const unsigned char *key, unsigned long keylen)
+{
+   int err;
+
+   LTC_ARGCHK(st  != NULL);
+   LTC_ARGCHK(key != NULL);
+
+   if ((err = gcm_init(&st->gcm, cipher, key, (int)keylen)) != CRYPT_OK) {
+      return err;
+   }
+   st->started = 0;
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
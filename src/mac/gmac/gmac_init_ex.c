@@ -0,0 +1,49 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gmac_init_ex.c
+   GMAC implementation, initialize from shared key material, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_MODE
+
+/**
+  Initialize a GMAC state against a shared precomp object
+
+  As gcm_init_ex(): pre must stay alive and unchanged for the life of
+  the state, and one precomp may back any number of GMAC (and GCM)
+  states under the same key.
+
+  @param st   The GMAC state to initialize
+  @param pre  Precomputed key material from gcm_precompute()
+  @return CRYPT_OK on success
+ */
+int gmac_init_ex(gmac_state *st, gcm_precomp *pre)
+{
+   int err;
+
+   LTC_ARGCHK(st  != NULL);
+   LTC_ARGCHK(pre != NULL);
+
+   if ((err = gcm_init_ex(&st->gcm, pre)) != CRYPT_OK) {
+      return err;
+   }
+   st->started = 0;
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,72 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gmac_memory.c
+   GMAC implementation, process a block of memory, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_MODE
+
+/**
+  GMAC a block of memory
+  @param cipher  The index of the cipher to use
+  @param key     The secret key
+  @param keylen  The length of the secret key (octets)
+  @param iv      The initialization vector
+  @param ivlen   The length of the IV (octets)
+  @param in      The data to authenticate
+  @param inlen   The length of the data (octets)
+  @param tag     [out] The destination for the MAC tag
+  @param taglen  [in/out] The length of the tag (octets, at most 16)
+  @return CRYPT_OK on success
+ */
+int gmac_memory(      int           cipher,
+                const unsigned char *key, unsigned long keylen,
+                const unsigned char *iv,  unsigned long ivlen,
+                const unsigned char *in,  unsigned long inlen,
+                      unsigned char *tag, unsigned long *taglen)
+{
+   gmac_state *st;
+   int err;
+
+   LTC_ARGCHK(key != NULL);
+   LTC_ARGCHK(iv  != NULL);
+
+   st = XMALLOC(sizeof(*st));
+   if (st == NULL) {
+      return CRYPT_MEM;
+   }
+
+   if ((err = gmac_init(st, cipher, key, keylen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = gmac_start(st, iv, ivlen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = gmac_process(st, in, inlen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   err = gmac_done(st, tag, taglen);
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(st, sizeof(*st));
+#endif
+   XFREE(st);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
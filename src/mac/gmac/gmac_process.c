@@ -0,0 +1,45 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gmac_process.c
+   GMAC implementation, authenticate data, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_MODE
+
+/**
+  Authenticate data with GMAC
+
+  Pure GHASH: bulk data goes through the aggregated eight-block
+  reduction when the carry-less multiplier serves this key, with no
+  cipher calls at all.
+
+  @param st     The GMAC state
+  @param in     The data to authenticate
+  @param inlen  The length of the data (octets)
+  @return CRYPT_OK on success
+ */
+int gmac_process(gmac_state *st, const unsigned char *in, unsigned long inlen)
+{
+   LTC_ARGCHK(st != NULL);
+   if (st->started != 1) {
+      return CRYPT_INVALID_ARG;
+   }
+   return gcm_add_aad(&st->gcm, in, inlen);
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
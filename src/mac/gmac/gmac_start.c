@@ -0,0 +1,60 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gmac_start.c
+   GMAC implementation, start a message, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_MODE
+
+/**
+  Start a GMAC message under a fresh IV
+
+  The tag mask E(K, Y0) is computed here -- the one cipher call of the
+  whole message -- so gmac_process() is pure GHASH.  A state may run
+  any number of messages; call gmac_start() again after gmac_done().
+
+  @param st     The GMAC state
+  @param iv     The initialization vector (never repeat one under a key)
+  @param ivlen  The length of the IV (octets, 12 is the fast path)
+  @return CRYPT_OK on success
+ */
+int gmac_start(gmac_state *st, const unsigned char *iv, unsigned long ivlen)
+{
+   int err;
+
+   LTC_ARGCHK(st != NULL);
+   LTC_ARGCHK(iv != NULL);
+
+   if ((err = gcm_reset(&st->gcm)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = gcm_add_iv(&st->gcm, iv, ivlen)) != CRYPT_OK) {
+      return err;
+   }
+   /* terminate the IV; leaves the state in AAD mode with Y_0 set */
+   if ((err = gcm_add_aad(&st->gcm, NULL, 0)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = cipher_descriptor[st->gcm.cipher].ecb_encrypt(st->gcm.Y_0, st->mask, &st->gcm.pre->K)) != CRYPT_OK) {
+      return err;
+   }
+   st->started = 1;
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
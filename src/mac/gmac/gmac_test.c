@@ -0,0 +1,77 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file gmac_test.c
+   GMAC implementation, self-test, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_GCM_MODE
+
+/**
+  Self-test the GMAC code
+  @return CRYPT_OK if successful, CRYPT_NOP if self-testing has been disabled
+*/
+int gmac_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   /* the empty-message tag under the all-zero key and IV (the classic
+    * GCM first vector: tag = E(K, Y0) with GHASH of nothing) */
+   static const unsigned char zkey[16] = { 0 };
+   static const unsigned char ziv[12]  = { 0 };
+   static const unsigned char ztag[16] = {
+      0x58, 0xe2, 0xfc, 0xce, 0xfa, 0x7e, 0x30, 0x61,
+      0x36, 0x7f, 0x1d, 0x57, 0xa4, 0xe7, 0x45, 0x5a };
+   unsigned char buf[384], tag[16], ref[16];
+   unsigned long taglen, reflen, x;
+   int err, idx;
+
+   idx = find_cipher("aes");
+   if (idx == -1) return CRYPT_NOP;
+
+   taglen = 16;
+   if ((err = gmac_memory(idx, zkey, 16, ziv, 12, NULL, 0, tag, &taglen)) != CRYPT_OK) {
+      return err;
+   }
+   if (compare_testvector(tag, taglen, ztag, sizeof(ztag), "GMAC-TV1", 1)) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+
+   /* GMAC must equal GCM run AAD-only, across block boundaries and
+    * partials (covers the aggregated bulk path) */
+   for (x = 0; x < sizeof(buf); x++) {
+      buf[x] = (unsigned char)x;
+   }
+   for (x = 1; x <= sizeof(buf); x = (x * 2) + 3) {
+      taglen = reflen = 16;
+      if ((err = gmac_memory(idx, buf, 16, buf, 12, buf, x, tag, &taglen)) != CRYPT_OK) {
+         return err;
+      }
+      if ((err = gcm_memory(idx, buf, 16, buf, 12, buf, x, NULL, 0, NULL, ref, &reflen, GCM_ENCRYPT)) != CRYPT_OK) {
+         return err;
+      }
+      if (compare_testvector(tag, taglen, ref, reflen, "GMAC-GCM", (int)x)) {
+         return CRYPT_FAIL_TESTVECTOR;
+      }
+   }
+
+   return CRYPT_OK;
+#endif
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
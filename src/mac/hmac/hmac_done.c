@@ -28,7 +28,7 @@
 */
 int hmac_done(hmac_state *hmac, unsigned char *out, unsigned long *outlen)
 {
-    unsigned char *buf, *isha;
+    unsigned char buf[MAXBLOCKSIZE], isha[MAXBLOCKSIZE];
     unsigned long hashsize, i;
     int hash, err;
 
@@ -44,35 +44,27 @@ int hmac_done(hmac_state *hmac, unsigned char *out, unsigned long *outlen)
     /* get the hash message digest size */
     hashsize = hash_descriptor[hash].hashsize;
 
-    /* allocate buffers */
-    buf  = XMALLOC(LTC_HMAC_BLOCKSIZE);
-    isha = XMALLOC(hashsize);
-    if (buf == NULL || isha == NULL) {
-       if (buf != NULL) {
-          XFREE(buf);
-       }
-       if (isha != NULL) {
-          XFREE(isha);
-       }
-       return CRYPT_MEM;
-    }
-
     /* Get the hash of the first HMAC vector plus the data */
     if ((err = hash_descriptor[hash].done(&hmac->md, isha)) != CRYPT_OK) {
        goto LBL_ERR;
     }
 
-    /* Create the second HMAC vector vector for step (3) */
-    for(i=0; i < LTC_HMAC_BLOCKSIZE; i++) {
-        buf[i] = hmac->key[i] ^ 0x5C;
-    }
+    if (hmac->precomputed) {
+       /* resume the outer hash from the cached post-opad midstate */
+       XMEMCPY(&hmac->md, &hmac->omd, sizeof(hmac->md));
+    } else {
+       /* Create the second HMAC vector vector for step (3) */
+       for(i=0; i < LTC_HMAC_BLOCKSIZE; i++) {
+           buf[i] = hmac->key[i] ^ 0x5C;
+       }
 
-    /* Now calculate the "outer" hash for step (5), (6), and (7) */
-    if ((err = hash_descriptor[hash].init(&hmac->md)) != CRYPT_OK) {
-       goto LBL_ERR;
-    }
-    if ((err = hash_descriptor[hash].process(&hmac->md, buf, LTC_HMAC_BLOCKSIZE)) != CRYPT_OK) {
-       goto LBL_ERR;
+       /* Now calculate the "outer" hash for step (5), (6), and (7) */
+       if ((err = hash_descriptor[hash].init(&hmac->md)) != CRYPT_OK) {
+          goto LBL_ERR;
+       }
+       if ((err = hash_descriptor[hash].process(&hmac->md, buf, LTC_HMAC_BLOCKSIZE)) != CRYPT_OK) {
+          goto LBL_ERR;
+       }
     }
     if ((err = hash_descriptor[hash].process(&hmac->md, isha, hashsize)) != CRYPT_OK) {
        goto LBL_ERR;
@@ -89,16 +81,15 @@ int hmac_done(hmac_state *hmac, unsigned char *out, unsigned long *outlen)
 
     err = CRYPT_OK;
 LBL_ERR:
-    XFREE(hmac->key);
+    if (!hmac->precomputed) {
+       XFREE(hmac->key);
+    }
 #ifdef LTC_CLEAN_STACK
-    zeromem(isha, hashsize);
-    zeromem(buf,  hashsize);
+    zeromem(isha, sizeof(isha));
+    zeromem(buf,  sizeof(buf));
     zeromem(hmac, sizeof(*hmac));
 #endif
 
-    XFREE(isha);
-    XFREE(buf);
-
     return err;
 }
 
@@ -17,6 +17,13 @@
 
 #ifdef LTC_HMAC
 
+#ifndef LTC_NO_FILE
+static int _hmac_file_process(void *state, const unsigned char *buf, unsigned long len)
+{
+   return hmac_process(state, buf, len);
+}
+#endif
+
 /**
   HMAC a file
   @param hash     The index of the hash you wish to use
@@ -35,9 +42,6 @@ int hmac_file(int hash, const char *fname,
     return CRYPT_NOP;
 #else
    hmac_state hmac;
-   FILE *in;
-   unsigned char *buf;
-   size_t x;
    int err;
 
    LTC_ARGCHK(fname  != NULL);
@@ -45,46 +49,24 @@ int hmac_file(int hash, const char *fname,
    LTC_ARGCHK(out    != NULL);
    LTC_ARGCHK(outlen != NULL);
 
-   if ((buf = XMALLOC(LTC_FILE_READ_BUFSIZE)) == NULL) {
-      return CRYPT_MEM;
-   }
-
    if ((err = hash_is_valid(hash)) != CRYPT_OK) {
-      goto LBL_ERR;
+      return err;
    }
 
    if ((err = hmac_init(&hmac, hash, key, keylen)) != CRYPT_OK) {
-      goto LBL_ERR;
+      return err;
    }
 
-   in = fopen(fname, "rb");
-   if (in == NULL) {
-      err = CRYPT_FILE_NOTFOUND;
+   if ((err = file_process(fname, _hmac_file_process, &hmac)) != CRYPT_OK) {
       goto LBL_ERR;
    }
 
-   do {
-      x = fread(buf, 1, LTC_FILE_READ_BUFSIZE, in);
-      if ((err = hmac_process(&hmac, buf, (unsigned long)x)) != CRYPT_OK) {
-         fclose(in); /* we don't trap this error since we're already returning an error! */
-         goto LBL_CLEANBUF;
-      }
-   } while (x == LTC_FILE_READ_BUFSIZE);
-
-   if (fclose(in) != 0) {
-      err = CRYPT_ERROR;
-      goto LBL_CLEANBUF;
-   }
-
    err = hmac_done(&hmac, out, outlen);
 
-LBL_CLEANBUF:
-   zeromem(buf, LTC_FILE_READ_BUFSIZE);
 LBL_ERR:
 #ifdef LTC_CLEAN_STACK
    zeromem(&hmac, sizeof(hmac_state));
 #endif
-   XFREE(buf);
    return err;
 #endif
 }
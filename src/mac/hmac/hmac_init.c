@@ -29,7 +29,7 @@
 */
 int hmac_init(hmac_state *hmac, int hash, const unsigned char *key, unsigned long keylen)
 {
-    unsigned char *buf;
+    unsigned char buf[MAXBLOCKSIZE];
     unsigned long hashsize;
     unsigned long i, z;
     int err;
@@ -41,24 +41,19 @@ int hmac_init(hmac_state *hmac, int hash, const unsigned char *key, unsigned lon
     if ((err = hash_is_valid(hash)) != CRYPT_OK) {
         return err;
     }
-    hmac->hash = hash;
-    hashsize   = hash_descriptor[hash].hashsize;
+    hmac->hash        = hash;
+    hmac->precomputed = 0;
+    hashsize          = hash_descriptor[hash].hashsize;
 
     /* valid key length? */
     if (keylen == 0) {
         return CRYPT_INVALID_KEYSIZE;
     }
 
-    /* allocate ram for buf */
-    buf = XMALLOC(LTC_HMAC_BLOCKSIZE);
-    if (buf == NULL) {
-       return CRYPT_MEM;
-    }
-
     /* allocate memory for key */
+    LTC_MEM_TAG("hmac");
     hmac->key = XMALLOC(LTC_HMAC_BLOCKSIZE);
     if (hmac->key == NULL) {
-       XFREE(buf);
        return CRYPT_MEM;
     }
 
@@ -96,10 +91,8 @@ LBL_ERR:
     XFREE(hmac->key);
 done:
 #ifdef LTC_CLEAN_STACK
-   zeromem(buf, LTC_HMAC_BLOCKSIZE);
+   zeromem(buf, sizeof(buf));
 #endif
-
-   XFREE(buf);
    return err;
 }
 
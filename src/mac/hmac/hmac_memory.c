@@ -33,51 +33,12 @@ int hmac_memory(int hash,
                 const unsigned char *in,   unsigned long inlen,
                       unsigned char *out,  unsigned long *outlen)
 {
-    hmac_state *hmac;
-    int         err;
+    hmac_state hmac;
 
-    LTC_ARGCHK(key    != NULL);
-    LTC_ARGCHK(in     != NULL);
-    LTC_ARGCHK(out    != NULL);
-    LTC_ARGCHK(outlen != NULL);
-
-    /* make sure hash descriptor is valid */
-    if ((err = hash_is_valid(hash)) != CRYPT_OK) {
-       return err;
-    }
-
-    /* is there a descriptor? */
-    if (hash_descriptor[hash].hmac_block != NULL) {
-        return hash_descriptor[hash].hmac_block(key, keylen, in, inlen, out, outlen);
-    }
-
-    /* nope, so call the hmac functions */
-    /* allocate ram for hmac state */
-    hmac = XMALLOC(sizeof(hmac_state));
-    if (hmac == NULL) {
-       return CRYPT_MEM;
-    }
-
-    if ((err = hmac_init(hmac, hash, key, keylen)) != CRYPT_OK) {
-       goto LBL_ERR;
-    }
-
-    if ((err = hmac_process(hmac, in, inlen)) != CRYPT_OK) {
-       goto LBL_ERR;
-    }
-
-    if ((err = hmac_done(hmac, out, outlen)) != CRYPT_OK) {
-       goto LBL_ERR;
-    }
-
-   err = CRYPT_OK;
-LBL_ERR:
-#ifdef LTC_CLEAN_STACK
-   zeromem(hmac, sizeof(hmac_state));
-#endif
-
-   XFREE(hmac);
-   return err;
+    /* the state lives on the stack and hmac_memory_stack keys it
+     * through the precomputed pad midstates, so the helper performs
+     * no heap allocation at all */
+    return hmac_memory_stack(&hmac, hash, key, keylen, in, inlen, out, outlen);
 }
 
 #endif
@@ -36,7 +36,8 @@ int hmac_memory_multi(int hash,
                 const unsigned char *in,   unsigned long inlen, ...)
 
 {
-    hmac_state          *hmac;
+    hmac_state           hmac;
+    hmac_precomputed     pre;
     int                  err;
     va_list              args;
     const unsigned char *curptr;
@@ -47,14 +48,12 @@ int hmac_memory_multi(int hash,
     LTC_ARGCHK(out    != NULL);
     LTC_ARGCHK(outlen != NULL);
 
-    /* allocate ram for hmac state */
-    hmac = XMALLOC(sizeof(hmac_state));
-    if (hmac == NULL) {
-       return CRYPT_MEM;
+    /* stack state keyed through the pad midstates: no heap allocation */
+    if ((err = hmac_precompute(&pre, hash, key, keylen)) != CRYPT_OK) {
+       return err;
     }
-
-    if ((err = hmac_init(hmac, hash, key, keylen)) != CRYPT_OK) {
-       goto LBL_ERR;
+    if ((err = hmac_init_from_precomputed(&hmac, &pre)) != CRYPT_OK) {
+       return err;
     }
 
     va_start(args, inlen);
@@ -62,7 +61,7 @@ int hmac_memory_multi(int hash,
     curlen = inlen;
     for (;;) {
        /* process buf */
-       if ((err = hmac_process(hmac, curptr, curlen)) != CRYPT_OK) {
+       if ((err = hmac_process(&hmac, curptr, curlen)) != CRYPT_OK) {
           goto LBL_ERR;
        }
        /* step to next */
@@ -72,14 +71,14 @@ int hmac_memory_multi(int hash,
        }
        curlen = va_arg(args, unsigned long);
     }
-    if ((err = hmac_done(hmac, out, outlen)) != CRYPT_OK) {
+    if ((err = hmac_done(&hmac, out, outlen)) != CRYPT_OK) {
        goto LBL_ERR;
     }
 LBL_ERR:
 #ifdef LTC_CLEAN_STACK
-   zeromem(hmac, sizeof(hmac_state));
+   zeromem(&hmac, sizeof(hmac));
+   zeromem(&pre,  sizeof(pre));
 #endif
-   XFREE(hmac);
    va_end(args);
    return err;
 }
@@ -0,0 +1,84 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file hmac_memory_stack.c
+  HMAC support, process a block of memory without allocating, Tom St Denis
+*/
+
+#ifdef LTC_HMAC
+
+/**
+   HMAC a block of memory using a caller provided state, performing no
+   heap allocations.  The key is folded in through the precomputed pad
+   midstates so the internal key buffer of hmac_init is never needed;
+   callers who cannot see the hmac_state layout can size the buffer via
+   crypt_get_size("hmac_state", ...).
+   @param hmac      The caller provided HMAC state (clobbered, not retained)
+   @param hash      The index of the hash to use
+   @param key       The secret key
+   @param keylen    The length of the secret key (octets)
+   @param in        The data to HMAC
+   @param inlen     The length of the data to HMAC (octets)
+   @param out       [out] Destination of the authentication tag
+   @param outlen    [in/out] Max size and resulting size of authentication tag
+   @return CRYPT_OK if successful
+*/
+int hmac_memory_stack(hmac_state *hmac, int hash,
+                const unsigned char *key,  unsigned long keylen,
+                const unsigned char *in,   unsigned long inlen,
+                      unsigned char *out,  unsigned long *outlen)
+{
+    hmac_precomputed pre;
+    int              err;
+
+    LTC_ARGCHK(hmac   != NULL);
+    LTC_ARGCHK(key    != NULL);
+    LTC_ARGCHK(in     != NULL);
+    LTC_ARGCHK(out    != NULL);
+    LTC_ARGCHK(outlen != NULL);
+
+    /* make sure hash descriptor is valid */
+    if ((err = hash_is_valid(hash)) != CRYPT_OK) {
+       return err;
+    }
+
+    /* is there a descriptor? */
+    if (hash_descriptor[hash].hmac_block != NULL) {
+        return hash_descriptor[hash].hmac_block(key, keylen, in, inlen, out, outlen);
+    }
+
+    if ((err = hmac_precompute(&pre, hash, key, keylen)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    if ((err = hmac_init_from_precomputed(hmac, &pre)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    if ((err = hmac_process(hmac, in, inlen)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    err = hmac_done(hmac, out, outlen);
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+    zeromem(&pre, sizeof(pre));
+    zeromem(hmac, sizeof(*hmac));
+#endif
+    return err;
+}
+
+#endif
+
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
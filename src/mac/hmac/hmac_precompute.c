@@ -0,0 +1,131 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file hmac_precompute.c
+  HMAC support, cache the key midstates for reuse, Tom St Denis
+*/
+
+#ifdef LTC_HMAC
+
+#define LTC_HMAC_BLOCKSIZE hash_descriptor[hash].blocksize
+
+/**
+   Hash the padded key blocks of an HMAC key once.  The stored midstates
+   make keying a fresh hmac_state a pair of struct copies, so a key that
+   authenticates many messages pays for its two key blocks only here.
+   @param pre      [out] The precomputed key midstates
+   @param hash     The index of the hash you want to use
+   @param key      The secret key
+   @param keylen   The length of the secret key (octets)
+   @return CRYPT_OK if successful
+*/
+int hmac_precompute(hmac_precomputed *pre, int hash, const unsigned char *key, unsigned long keylen)
+{
+    unsigned char kb[MAXBLOCKSIZE], buf[MAXBLOCKSIZE];
+    unsigned long hashsize, i, z;
+    int err;
+
+    LTC_ARGCHK(pre != NULL);
+    LTC_ARGCHK(key != NULL);
+
+    /* valid hash? */
+    if ((err = hash_is_valid(hash)) != CRYPT_OK) {
+        return err;
+    }
+    pre->hash = hash;
+    hashsize  = hash_descriptor[hash].hashsize;
+
+    /* valid key length? */
+    if (keylen == 0) {
+        return CRYPT_INVALID_KEYSIZE;
+    }
+
+    /* (1) make sure we have a large enough key */
+    if (keylen > LTC_HMAC_BLOCKSIZE) {
+        z = LTC_HMAC_BLOCKSIZE;
+        if ((err = hash_memory(hash, key, keylen, kb, &z)) != CRYPT_OK) {
+           goto LBL_ERR;
+        }
+        keylen = hashsize;
+    } else {
+        XMEMCPY(kb, key, (size_t)keylen);
+    }
+
+    if (keylen < LTC_HMAC_BLOCKSIZE) {
+       zeromem(kb + keylen, (size_t)(LTC_HMAC_BLOCKSIZE - keylen));
+    }
+
+    /* hash the ipad block into imd */
+    for (i = 0; i < LTC_HMAC_BLOCKSIZE; i++) {
+       buf[i] = kb[i] ^ 0x36;
+    }
+    if ((err = hash_descriptor[hash].init(&pre->imd)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    if ((err = hash_descriptor[hash].process(&pre->imd, buf, LTC_HMAC_BLOCKSIZE)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+
+    /* and the opad block into omd */
+    for (i = 0; i < LTC_HMAC_BLOCKSIZE; i++) {
+       buf[i] = kb[i] ^ 0x5C;
+    }
+    if ((err = hash_descriptor[hash].init(&pre->omd)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    if ((err = hash_descriptor[hash].process(&pre->omd, buf, LTC_HMAC_BLOCKSIZE)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+
+    err = CRYPT_OK;
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+    zeromem(kb,  sizeof(kb));
+    zeromem(buf, sizeof(buf));
+#endif
+    return err;
+}
+
+/**
+   Key an HMAC context from precomputed key midstates.  This is the
+   per-message counterpart of hmac_precompute and performs no hashing
+   and no allocation.
+   @param hmac     The HMAC state
+   @param pre      The precomputed key midstates
+   @return CRYPT_OK if successful
+*/
+int hmac_init_from_precomputed(hmac_state *hmac, const hmac_precomputed *pre)
+{
+    int err;
+
+    LTC_ARGCHK(hmac != NULL);
+    LTC_ARGCHK(pre  != NULL);
+
+    if ((err = hash_is_valid(pre->hash)) != CRYPT_OK) {
+        return err;
+    }
+
+    hmac->hash        = pre->hash;
+    hmac->key         = NULL;
+    hmac->precomputed = 1;
+    XMEMCPY(&hmac->imd, &pre->imd, sizeof(hmac->imd));
+    XMEMCPY(&hmac->omd, &pre->omd, sizeof(hmac->omd));
+    XMEMCPY(&hmac->md,  &pre->imd, sizeof(hmac->md));
+    return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,69 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file hmac_reset.c
+  HMAC support, restart a keyed state, Tom St Denis
+*/
+
+#ifdef LTC_HMAC
+
+#define LTC_HMAC_BLOCKSIZE hash_descriptor[hash].blocksize
+
+/**
+   Rewind an HMAC state to just after keying, discarding any data
+   processed so far.  For states keyed through
+   hmac_init_from_precomputed this is a struct copy; otherwise the ipad
+   block is rehashed from the stored key.  Only valid before hmac_done.
+   @param hmac    The HMAC state
+   @return CRYPT_OK if successful
+*/
+int hmac_reset(hmac_state *hmac)
+{
+    unsigned char buf[MAXBLOCKSIZE];
+    unsigned long i;
+    int hash, err;
+
+    LTC_ARGCHK(hmac != NULL);
+
+    hash = hmac->hash;
+    if ((err = hash_is_valid(hash)) != CRYPT_OK) {
+        return err;
+    }
+
+    if (hmac->precomputed) {
+       XMEMCPY(&hmac->md, &hmac->imd, sizeof(hmac->md));
+       return CRYPT_OK;
+    }
+
+    LTC_ARGCHK(hmac->key != NULL);
+
+    /* rebuild the inner hash from the stored key */
+    for (i = 0; i < LTC_HMAC_BLOCKSIZE; i++) {
+       buf[i] = hmac->key[i] ^ 0x36;
+    }
+    if ((err = hash_descriptor[hash].init(&hmac->md)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    err = hash_descriptor[hash].process(&hmac->md, buf, LTC_HMAC_BLOCKSIZE);
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+    zeromem(buf, sizeof(buf));
+#endif
+    return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
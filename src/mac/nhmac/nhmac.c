@@ -0,0 +1,277 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file nhmac.c
+   NH universal-hash MAC in the UMAC/VMAC mould, by Tom St Denis
+
+   Layered like UMAC/VMAC: the NH inner hash compresses each 128-octet
+   block to 16 octets with one 64x64 multiply-accumulate per 16 octets
+   of input, the chaining values run through the GCM GF(2^128)
+   polynomial layer (so the PCLMUL backend carries the outer hash over
+   an eighth of the data), and one block-cipher call over the digest
+   plus the absorbed length makes the tag.  Deterministic -- no nonce
+   to manage at line rate -- and the inner loop is pure 64-bit
+   multiply-accumulate.
+
+   This is our own composition, not wire-compatible with RFC 4418 UMAC
+   or draft VMAC (those need a 2^127-1 polynomial field we do not
+   carry); the security argument is the same Carter-Wegman stack.
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_NHMAC
+
+/* one NH block: 16 ulong64 words */
+#define NHMAC_BLOCKBYTES 128
+
+#ifdef __SIZEOF_INT128__
+typedef unsigned __int128 nhmac_u128;
+#define NH_MULADD(hi, lo, a, b)                          \
+   do {                                                  \
+      nhmac_u128 _p = (nhmac_u128)(a) * (b);             \
+      lo += (ulong64)_p;                                 \
+      hi += (ulong64)(_p >> 64) + (lo < (ulong64)_p);    \
+   } while (0)
+#else
+/* portable 64x64->128 via 32-bit halves */
+#define NH_MULADD(hi, lo, a, b)                                            \
+   do {                                                                    \
+      ulong64 _a0 = (a) & 0xFFFFFFFFUL, _a1 = (a) >> 32;                   \
+      ulong64 _b0 = (b) & 0xFFFFFFFFUL, _b1 = (b) >> 32;                   \
+      ulong64 _m0 = _a0 * _b0, _m1 = _a0 * _b1, _m2 = _a1 * _b0;           \
+      ulong64 _mid = (_m0 >> 32) + (_m1 & 0xFFFFFFFFUL) + (_m2 & 0xFFFFFFFFUL); \
+      ulong64 _lo = (_m0 & 0xFFFFFFFFUL) | (_mid << 32);                   \
+      ulong64 _hi = _a1 * _b1 + (_m1 >> 32) + (_m2 >> 32) + (_mid >> 32);  \
+      lo += _lo;                                                           \
+      hi += _hi + (lo < _lo);                                              \
+   } while (0)
+#endif
+
+static void s_gf_mult(const unsigned char *a, const unsigned char *b, unsigned char *c)
+{
+#ifdef LTC_GF_CLMUL
+   if (gcm_gf_mult_clmul_enabled()) {
+      gcm_gf_mult_clmul(a, b, c);
+      return;
+   }
+#endif
+   gcm_gf_mult(a, b, c);
+}
+
+/* NH over len octets (a multiple of 16, at most 128): 16-octet
+ * chaining value out */
+static void s_nh(const ulong64 *k, const unsigned char *m, unsigned long len,
+                 unsigned char *cv)
+{
+   ulong64 hi = 0, lo = 0, w0, w1;
+   unsigned long i;
+
+   for (i = 0; i < len; i += 16) {
+      LOAD64L(w0, m + i);
+      LOAD64L(w1, m + i + 8);
+      NH_MULADD(hi, lo, w0 + k[(i >> 3)], w1 + k[(i >> 3) + 1]);
+   }
+   STORE64H(hi, cv);
+   STORE64H(lo, cv + 8);
+}
+
+/* absorb one 16-octet chaining value into the polynomial layer */
+static void s_poly_cv(nhmac_state *st, const unsigned char *cv)
+{
+   unsigned char T[16];
+   int i;
+   for (i = 0; i < 16; i++) {
+      st->X[i] ^= cv[i];
+   }
+   s_gf_mult(st->X, st->H, T);
+   XMEMCPY(st->X, T, 16);
+}
+
+/**
+   Initialize an NH MAC context
+   @param st      The NH MAC state
+   @param cipher  The index of the cipher to use (must have a 128-bit block)
+   @param key     The secret key
+   @param keylen  The length of the secret key (octets)
+   @return CRYPT_OK on success
+*/
+int nhmac_init(nhmac_state *st, int cipher, const unsigned char *key, unsigned long keylen)
+{
+   symmetric_key *K;
+   unsigned char  blk[16], out[16], k2[32];
+   int            err, i;
+
+   LTC_ARGCHK(st  != NULL);
+   LTC_ARGCHK(key != NULL);
+
+   if ((err = cipher_is_valid(cipher)) != CRYPT_OK) {
+      return err;
+   }
+   if (cipher_descriptor[cipher].block_length != 16) {
+      return CRYPT_INVALID_CIPHER;
+   }
+
+   K = XMALLOC(sizeof(*K));
+   if (K == NULL) {
+      return CRYPT_MEM;
+   }
+   if ((err = cipher_descriptor[cipher].setup(key, (int)keylen, 0, K)) != CRYPT_OK) {
+      goto error;
+   }
+
+   /* subkeys by encrypting tagged counter blocks: 0x80 || 0^14 || i
+    * feeds NH, 0xC0 the polynomial key, 0xE0 the finalization key */
+   zeromem(blk, 16);
+   blk[0] = 0x80;
+   for (i = 0; i < 8; i++) {
+      blk[15] = (unsigned char)i;
+      if ((err = cipher_descriptor[cipher].ecb_encrypt(blk, out, K)) != CRYPT_OK) {
+         goto error;
+      }
+      LOAD64L(st->nhkey[2*i],     out);
+      LOAD64L(st->nhkey[2*i + 1], out + 8);
+   }
+   blk[0] = 0xC0;
+   blk[15] = 0;
+   if ((err = cipher_descriptor[cipher].ecb_encrypt(blk, st->H, K)) != CRYPT_OK) {
+      goto error;
+   }
+   blk[0] = 0xE0;
+   for (i = 0; i < 2; i++) {
+      blk[15] = (unsigned char)i;
+      if ((err = cipher_descriptor[cipher].ecb_encrypt(blk, k2 + 16*i, K)) != CRYPT_OK) {
+         goto error;
+      }
+   }
+   if ((err = cipher_descriptor[cipher].setup(k2, 16, 0, &st->K2)) != CRYPT_OK) {
+      goto error;
+   }
+
+   st->cipher = cipher;
+   st->buflen = 0;
+   st->totlen = 0;
+   zeromem(st->X, 16);
+   err = CRYPT_OK;
+error:
+   if (cipher_descriptor[cipher].done != NULL) {
+      cipher_descriptor[cipher].done(K);
+   }
+   zeromem(K, sizeof(*K));
+   XFREE(K);
+#ifdef LTC_CLEAN_STACK
+   zeromem(blk, sizeof(blk));
+   zeromem(out, sizeof(out));
+   zeromem(k2,  sizeof(k2));
+#endif
+   return err;
+}
+
+/**
+   Process data through an NH MAC
+   @param st     The NH MAC state
+   @param in     The data to send through the MAC
+   @param inlen  The length of the data (octets)
+   @return CRYPT_OK on success
+*/
+int nhmac_process(nhmac_state *st, const unsigned char *in, unsigned long inlen)
+{
+   unsigned char cv[16];
+   unsigned long n;
+
+   if (inlen == 0) return CRYPT_OK;
+   LTC_ARGCHK(st != NULL);
+   LTC_ARGCHK(in != NULL);
+
+   st->totlen += inlen;
+
+   /* top up a partial block first */
+   if (st->buflen > 0) {
+      n = MIN(inlen, (unsigned long)(NHMAC_BLOCKBYTES - st->buflen));
+      XMEMCPY(st->buf + st->buflen, in, n);
+      st->buflen += (int)n;
+      in    += n;
+      inlen -= n;
+      if (st->buflen == NHMAC_BLOCKBYTES) {
+         s_nh(st->nhkey, st->buf, NHMAC_BLOCKBYTES, cv);
+         s_poly_cv(st, cv);
+         st->buflen = 0;
+      }
+   }
+   /* whole blocks straight from the caller's buffer */
+   while (inlen >= NHMAC_BLOCKBYTES) {
+      s_nh(st->nhkey, in, NHMAC_BLOCKBYTES, cv);
+      s_poly_cv(st, cv);
+      in    += NHMAC_BLOCKBYTES;
+      inlen -= NHMAC_BLOCKBYTES;
+   }
+   if (inlen > 0) {
+      XMEMCPY(st->buf, in, inlen);
+      st->buflen = (int)inlen;
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Terminate an NH MAC
+   @param st      The NH MAC state
+   @param tag     [out] The destination of the tag
+   @param taglen  [in/out] The max size and resulting size of the tag (8 or 16)
+   @return CRYPT_OK on success
+*/
+int nhmac_done(nhmac_state *st, unsigned char *tag, unsigned long *taglen)
+{
+   unsigned char cv[16], full[16];
+   unsigned long n;
+   int err;
+
+   LTC_ARGCHK(st     != NULL);
+   LTC_ARGCHK(tag    != NULL);
+   LTC_ARGCHK(taglen != NULL);
+   if (*taglen < 8) {
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+
+   if (st->buflen > 0) {
+      /* zero pad the tail to a word pair; NH runs over used pairs only */
+      n = ((unsigned long)st->buflen + 15) & ~15UL;
+      zeromem(st->buf + st->buflen, n - st->buflen);
+      s_nh(st->nhkey, st->buf, n, cv);
+      s_poly_cv(st, cv);
+   }
+
+   /* absorb the bit length, then one cipher call makes the tag */
+   zeromem(cv, 16);
+   STORE64H(st->totlen << 3, cv + 8);
+   s_poly_cv(st, cv);
+
+   if ((err = cipher_descriptor[st->cipher].ecb_encrypt(st->X, full, &st->K2)) != CRYPT_OK) {
+      return err;
+   }
+   *taglen = MIN(*taglen, 16);
+   if (*taglen < 16) *taglen = 8;
+   XMEMCPY(tag, full, *taglen);
+
+   zeromem(st->X, 16);
+   st->buflen = 0;
+   st->totlen = 0;
+#ifdef LTC_CLEAN_STACK
+   zeromem(cv,   sizeof(cv));
+   zeromem(full, sizeof(full));
+#endif
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,60 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file nhmac_memory.c
+   NH MAC a buffer in one call, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_NHMAC
+
+/**
+   NH MAC a block of memory to produce the authentication tag
+   @param cipher  The index of the cipher to use
+   @param key     The secret key
+   @param keylen  The length of the secret key (octets)
+   @param in      The data to MAC
+   @param inlen   The length of the data (octets)
+   @param tag     [out] Destination of the authentication tag
+   @param taglen  [in/out] Max size and resulting size of the tag (8 or 16)
+   @return CRYPT_OK on success
+*/
+int nhmac_memory(int cipher,
+                 const unsigned char *key, unsigned long keylen,
+                 const unsigned char *in,  unsigned long inlen,
+                       unsigned char *tag, unsigned long *taglen)
+{
+   nhmac_state *st;
+   int err;
+
+   st = XMALLOC(sizeof(*st));
+   if (st == NULL) {
+      return CRYPT_MEM;
+   }
+   if ((err = nhmac_init(st, cipher, key, keylen)) != CRYPT_OK) {
+      goto error;
+   }
+   if ((err = nhmac_process(st, in, inlen)) != CRYPT_OK) {
+      goto error;
+   }
+   err = nhmac_done(st, tag, taglen);
+error:
+   zeromem(st, sizeof(*st));
+   XFREE(st);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,90 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file nhmac_test.c
+   NH MAC self test, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_NHMAC
+
+/**
+  Test the NH MAC implementation
+  @return CRYPT_OK on success
+*/
+int nhmac_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   /* nhmac is our own composition, so the vectors below are regression
+    * anchors generated from the implementation at introduction time */
+   static const unsigned char t0[16] = {
+      0x36,0xb5,0x91,0x70,0x4b,0x82,0x46,0xce,
+      0x97,0x93,0x50,0xa2,0xba,0xce,0xe8,0xf4 };
+   static const unsigned char t1[16] = {
+      0x14,0xbf,0xbf,0x0a,0xc7,0x1f,0xb6,0x04,
+      0xa0,0xbb,0x23,0x99,0x1b,0xa7,0xf1,0x80 };
+   unsigned char key[16], msg[1000], tag[16], tag2[16];
+   unsigned long taglen, x;
+   nhmac_state st;
+   int idx, err;
+
+   idx = find_cipher("aes");
+   if (idx == -1) {
+      idx = find_cipher("rijndael");
+   }
+   if (idx == -1) {
+      return CRYPT_NOP;
+   }
+
+   for (x = 0; x < 16; x++)   key[x] = (unsigned char)x;
+   for (x = 0; x < 1000; x++) msg[x] = (unsigned char)(x * 3 + 1);
+
+   taglen = 16;
+   if ((err = nhmac_memory(idx, key, 16, msg, 0, tag, &taglen)) != CRYPT_OK) return err;
+   if (compare_testvector(tag, taglen, t0, 16, "NHMAC", 0) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   taglen = 16;
+   if ((err = nhmac_memory(idx, key, 16, msg, 1000, tag, &taglen)) != CRYPT_OK) return err;
+   if (compare_testvector(tag, taglen, t1, 16, "NHMAC", 1) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   /* streaming in uneven chunks must match the one-shot */
+   if ((err = nhmac_init(&st, idx, key, 16)) != CRYPT_OK) return err;
+   for (x = 0; x < 1000; x += 77) {
+      if ((err = nhmac_process(&st, msg + x, MIN(77, 1000 - x))) != CRYPT_OK) return err;
+   }
+   taglen = 16;
+   if ((err = nhmac_done(&st, tag2, &taglen)) != CRYPT_OK) return err;
+   if (compare_testvector(tag2, taglen, tag, 16, "NHMAC", 2) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   /* a flipped message bit must change the tag */
+   msg[500] ^= 1;
+   taglen = 16;
+   if ((err = nhmac_memory(idx, key, 16, msg, 1000, tag2, &taglen)) != CRYPT_OK) return err;
+   if (XMEMCMP(tag2, tag, 16) == 0) return CRYPT_FAIL_TESTVECTOR;
+
+   /* 64-bit tags are the 128-bit tag truncated */
+   msg[500] ^= 1;
+   taglen = 8;
+   if ((err = nhmac_memory(idx, key, 16, msg, 1000, tag2, &taglen)) != CRYPT_OK) return err;
+   if (taglen != 8 || XMEMCMP(tag2, tag, 8) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   return CRYPT_OK;
+#endif
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
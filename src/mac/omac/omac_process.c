@@ -41,6 +41,33 @@ int omac_process(omac_state *omac, const unsigned char *in, unsigned long inlen)
       return CRYPT_INVALID_ARG;
    }
 
+   /* the OMAC chain is plain CBC over the message, so run whole spans
+    * through accel_cbc_encrypt when the cipher has one: prev is the IV
+    * and comes back as the last ciphertext block.  At least one byte is
+    * always held back so the final block lands in the buffer for
+    * omac_done */
+   if (omac->buflen == 0 &&
+       cipher_descriptor[omac->cipher_idx].accel_cbc_encrypt != NULL &&
+       inlen > (unsigned long)omac->blklen) {
+      unsigned char ct[16 * MAXBLOCKSIZE];
+      unsigned long blklen = omac->blklen, nblks;
+
+      while (inlen > blklen) {
+         nblks = (inlen - 1) / blklen;
+         if (nblks > 16) {
+            nblks = 16;
+         }
+         if ((err = cipher_descriptor[omac->cipher_idx].accel_cbc_encrypt(in, ct, nblks, omac->prev, &omac->key)) != CRYPT_OK) {
+            return err;
+         }
+         in    += nblks * blklen;
+         inlen -= nblks * blklen;
+      }
+#ifdef LTC_CLEAN_STACK
+      zeromem(ct, sizeof(ct));
+#endif
+   }
+
 #ifdef LTC_FAST
    {
      unsigned long blklen = cipher_descriptor[omac->cipher_idx].block_length;
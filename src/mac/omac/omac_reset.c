@@ -0,0 +1,47 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file omac_reset.c
+  OMAC1 support, restart a keyed state, Tom St Denis
+*/
+
+#ifdef LTC_OMAC
+
+/**
+   Rewind an OMAC state to just after omac_init, discarding any data
+   processed so far.  The scheduled key and the Lu subkeys are kept, so
+   authenticating the next message under the same key skips the key
+   setup and the two subkey derivations.
+   @param omac   The OMAC state
+   @return CRYPT_OK if successful
+*/
+int omac_reset(omac_state *omac)
+{
+   int err;
+
+   LTC_ARGCHK(omac != NULL);
+   if ((err = cipher_is_valid(omac->cipher_idx)) != CRYPT_OK) {
+      return err;
+   }
+
+   omac->buflen = 0;
+   zeromem(omac->prev,  sizeof(omac->prev));
+   zeromem(omac->block, sizeof(omac->block));
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -109,6 +109,20 @@ int pelican_process(pelican_state *pelmac, const unsigned char *in, unsigned lon
       return CRYPT_INVALID_ARG;
    }
 
+#ifdef LTC_AES_NI
+   /* the round function is four unkeyed AES rounds: AESENC against an
+    * all-zero round key, state pinned in a register across the run */
+   if (pelmac->buflen == 0 && (inlen >> 4) > 0 && rijndael_aesni_enabled()) {
+      unsigned long blks = inlen >> 4;
+      int err;
+      if ((err = pelican_aesni_blocks(pelmac, in, blks)) != CRYPT_OK) {
+         return err;
+      }
+      in    += blks << 4;
+      inlen -= blks << 4;
+   }
+#endif
+
 #ifdef LTC_FAST
    if (pelmac->buflen == 0) {
       while (inlen & ~15) {
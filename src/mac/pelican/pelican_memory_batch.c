@@ -0,0 +1,112 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file pelican_memory_batch.c
+  Pelican MAC many messages under one key, by Tom St Denis
+*/
+
+#ifdef LTC_PELICAN
+
+/**
+  Pelican block of memory, many messages under one key.  The key
+  schedule and the initial state encryption run once and are shared;
+  with AES-NI the messages are additionally interleaved four at a time
+  so their independent AESENC chains pipeline.
+  @param key     The key
+  @param keylen  The length of the key (octets)
+  @param in      The array of messages
+  @param inlen   The lengths of the messages (octets)
+  @param out     [out] The array of destinations of the tags (16 octets each)
+  @param msgs    The number of messages
+  @return CRYPT_OK if successful
+*/
+int pelican_memory_batch(const unsigned char *key, unsigned long keylen,
+                         const unsigned char * const *in, const unsigned long *inlen,
+                         unsigned char * const *out, int msgs)
+{
+   pelican_state tmpl, st[4];
+   int err, x, j;
+
+   LTC_ARGCHK(key   != NULL);
+   LTC_ARGCHK(in    != NULL || msgs == 0);
+   LTC_ARGCHK(inlen != NULL || msgs == 0);
+   LTC_ARGCHK(out   != NULL || msgs == 0);
+
+   if ((err = pelican_init(&tmpl, key, keylen)) != CRYPT_OK) {
+      return err;
+   }
+
+   x = 0;
+#ifdef LTC_AES_NI
+   if (rijndael_aesni_enabled()) {
+      while (msgs - x >= 4) {
+         pelican_state       *stp[4];
+         const unsigned char *p[4];
+         unsigned long        blks, b;
+
+         blks = inlen[x] >> 4;
+         for (j = 0; j < 4; j++) {
+            XMEMCPY(&st[j], &tmpl, sizeof(tmpl));
+            stp[j] = &st[j];
+            p[j]   = in[x + j];
+            b      = inlen[x + j] >> 4;
+            if (b < blks) {
+               blks = b;
+            }
+         }
+
+         /* the whole blocks every lane has, four chains at once */
+         if (blks > 0) {
+            if ((err = pelican_aesni_blocks4(stp, p, blks)) != CRYPT_OK) {
+               goto LBL_ERR;
+            }
+         }
+
+         /* per-lane leftovers and the tag */
+         for (j = 0; j < 4; j++) {
+            if ((err = pelican_process(&st[j], p[j] + (blks << 4), inlen[x + j] - (blks << 4))) != CRYPT_OK) {
+               goto LBL_ERR;
+            }
+            if ((err = pelican_done(&st[j], out[x + j])) != CRYPT_OK) {
+               goto LBL_ERR;
+            }
+         }
+         x += 4;
+      }
+   }
+#endif
+
+   for (; x < msgs; x++) {
+      XMEMCPY(&st[0], &tmpl, sizeof(tmpl));
+      if ((err = pelican_process(&st[0], in[x], inlen[x])) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = pelican_done(&st[0], out[x])) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+   }
+
+   err = CRYPT_OK;
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(&tmpl, sizeof(tmpl));
+   zeromem(st, sizeof(st));
+#endif
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,100 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file pelican_ni.c
+  Pelican MAC mixing function on AES-NI, selected at run-time from
+  pelican.c.  The Pelican round function is four unkeyed AES rounds,
+  which is exactly AESENC against an all-zero round key, so the whole
+  per-block update is one XOR and four instructions with the state held
+  in a register.
+*/
+
+#if defined(LTC_PELICAN) && defined(LTC_AES_NI)
+
+#include <wmmintrin.h>
+
+#define LTC_PELICAN_NI_CALL __attribute__((target("aes,sse2")))
+
+/**
+  Run whole 16 byte blocks through the Pelican state update.
+  @param pelmac  The Pelican MAC state
+  @param in      The input
+  @param blocks  The number of complete blocks to process
+  @return CRYPT_OK if successful
+*/
+LTC_PELICAN_NI_CALL
+int pelican_aesni_blocks(pelican_state *pelmac, const unsigned char *in, unsigned long blocks)
+{
+   __m128i s, z;
+
+   z = _mm_setzero_si128();
+   s = _mm_loadu_si128((__m128i*)pelmac->state);
+   while (blocks-- > 0) {
+      s = _mm_xor_si128(s, _mm_loadu_si128((const __m128i*)in));
+      s = _mm_aesenc_si128(s, z);
+      s = _mm_aesenc_si128(s, z);
+      s = _mm_aesenc_si128(s, z);
+      s = _mm_aesenc_si128(s, z);
+      in += 16;
+   }
+   _mm_storeu_si128((__m128i*)pelmac->state, s);
+   return CRYPT_OK;
+}
+
+/**
+  Run whole blocks of four independent messages through four Pelican
+  states at once.  The states carry no data dependency on each other,
+  so the four AESENC chains fill the pipeline that a single serial
+  chain leaves mostly idle.
+  @param st      Four Pelican MAC states
+  @param in      The four inputs
+  @param blocks  The number of complete blocks to take from every input
+  @return CRYPT_OK if successful
+*/
+LTC_PELICAN_NI_CALL
+int pelican_aesni_blocks4(pelican_state **st, const unsigned char **in, unsigned long blocks)
+{
+   __m128i s0, s1, s2, s3, z;
+   unsigned long b;
+
+   z  = _mm_setzero_si128();
+   s0 = _mm_loadu_si128((__m128i*)st[0]->state);
+   s1 = _mm_loadu_si128((__m128i*)st[1]->state);
+   s2 = _mm_loadu_si128((__m128i*)st[2]->state);
+   s3 = _mm_loadu_si128((__m128i*)st[3]->state);
+   for (b = 0; b < blocks; b++) {
+      s0 = _mm_xor_si128(s0, _mm_loadu_si128((const __m128i*)(in[0] + (b << 4))));
+      s1 = _mm_xor_si128(s1, _mm_loadu_si128((const __m128i*)(in[1] + (b << 4))));
+      s2 = _mm_xor_si128(s2, _mm_loadu_si128((const __m128i*)(in[2] + (b << 4))));
+      s3 = _mm_xor_si128(s3, _mm_loadu_si128((const __m128i*)(in[3] + (b << 4))));
+      s0 = _mm_aesenc_si128(s0, z); s1 = _mm_aesenc_si128(s1, z);
+      s2 = _mm_aesenc_si128(s2, z); s3 = _mm_aesenc_si128(s3, z);
+      s0 = _mm_aesenc_si128(s0, z); s1 = _mm_aesenc_si128(s1, z);
+      s2 = _mm_aesenc_si128(s2, z); s3 = _mm_aesenc_si128(s3, z);
+      s0 = _mm_aesenc_si128(s0, z); s1 = _mm_aesenc_si128(s1, z);
+      s2 = _mm_aesenc_si128(s2, z); s3 = _mm_aesenc_si128(s3, z);
+      s0 = _mm_aesenc_si128(s0, z); s1 = _mm_aesenc_si128(s1, z);
+      s2 = _mm_aesenc_si128(s2, z); s3 = _mm_aesenc_si128(s3, z);
+   }
+   _mm_storeu_si128((__m128i*)st[0]->state, s0);
+   _mm_storeu_si128((__m128i*)st[1]->state, s1);
+   _mm_storeu_si128((__m128i*)st[2]->state, s2);
+   _mm_storeu_si128((__m128i*)st[3]->state, s3);
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -42,6 +42,40 @@ int pmac_process(pmac_state *pmac, const unsigned char *in, unsigned long inlen)
       return CRYPT_INVALID_ARG;
    }
 
+   /* PMAC blocks are independent, so batch eight offset-XORed blocks
+    * per accel_ecb_encrypt call when the cipher has one; at least one
+    * byte is always held back so the final block lands in the buffer
+    * for pmac_done */
+   if (pmac->buflen == 0 &&
+       cipher_descriptor[pmac->cipher_idx].accel_ecb_encrypt != NULL &&
+       inlen > (unsigned long)(8 * pmac->block_len)) {
+      unsigned char W[8 * MAXBLOCKSIZE];
+      unsigned long blklen = pmac->block_len;
+      int           j;
+
+      while (inlen > 8 * blklen) {
+         for (j = 0; j < 8; j++) {
+            pmac_shift_xor(pmac);
+            for (x = 0; x < blklen; x++) {
+               W[j*blklen + x] = pmac->Li[x] ^ in[j*blklen + x];
+            }
+         }
+         if ((err = cipher_descriptor[pmac->cipher_idx].accel_ecb_encrypt(W, W, 8, &pmac->key)) != CRYPT_OK) {
+            return err;
+         }
+         for (j = 0; j < 8; j++) {
+            for (x = 0; x < blklen; x++) {
+               pmac->checksum[x] ^= W[j*blklen + x];
+            }
+         }
+         in    += 8 * blklen;
+         inlen -= 8 * blklen;
+      }
+#ifdef LTC_CLEAN_STACK
+      zeromem(W, sizeof(W));
+#endif
+   }
+
 #ifdef LTC_FAST
    if (pmac->buflen == 0 && inlen > 16) {
       unsigned long y;
@@ -148,9 +148,26 @@ int poly1305_process(poly1305_state *st, const unsigned char *in, unsigned long
    /* process full blocks */
    if (inlen >= 16) {
       unsigned long want = (inlen & ~(16 - 1));
+#ifdef LTC_POLY1305_X64
+      /* four blocks per AVX2 pass when the buffer is long enough to
+       * amortize raising r to its powers, radix 2^44 for the rest */
+      if (want >= 256 && st->final == 0 && poly1305_avx2_enabled()) {
+         unsigned long want4 = (want & ~(64UL - 1));
+         poly1305_avx2_blocks(st, in, want4);
+         in += want4;
+         inlen -= want4;
+         want -= want4;
+      }
+      if (want) {
+         poly1305_x64_blocks(st, in, want);
+         in += want;
+         inlen -= want;
+      }
+#else
       _poly1305_block(st, in, want);
       in += want;
       inlen -= want;
+#endif
    }
 
    /* store leftover */
@@ -0,0 +1,295 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file poly1305_x64.c
+  Poly1305 bulk block cores for x86-64: a radix 2^44 scalar core using
+  64x64->128 bit multiplies and a four block AVX2 core running against
+  precomputed r^1..r^4, both selected at run-time from poly1305.c.  The
+  poly1305_state keeps its portable radix 2^26 layout; the cores unpack
+  on entry and repack on exit, so the paths can be mixed freely within
+  one message.
+*/
+
+#if defined(LTC_POLY1305) && defined(LTC_POLY1305_X64)
+
+/* immintrin.h drags in AVX-512 headers that are not C90 clean */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+#define LTC_POLY1305_AVX2_CALL __attribute__((target("avx2")))
+
+typedef unsigned __int128 ulong128;
+
+#define M44 CONST64(0xfffffffffff)
+#define M42 CONST64(0x3ffffffffff)
+
+/**
+  Process whole 16 byte blocks with radix 2^44 limbs.  Three 128-bit
+  products replace the 32-bit path's twenty-five 64-bit ones.
+  @param st     The Poly1305 state
+  @param in     The data to process
+  @param inlen  The length of the data (octets, a multiple of 16)
+  @return CRYPT_OK if successful
+*/
+int poly1305_x64_blocks(poly1305_state *st, const unsigned char *in, unsigned long inlen)
+{
+   const ulong64 hibit = (st->final) ? 0 : (CONST64(1) << 40); /* 1 << 128 */
+   ulong64 r0, r1, r2, s1, s2, h0, h1, h2, c, t0, t1;
+   ulong128 d0, d1, d2;
+
+   /* unpack r and h from five 26 bit limbs to three of 44/44/42; the h
+    * limbs may carry a stray bit past 2^26, so they are summed in */
+   r0 =  (ulong64)st->r[0]        | ((ulong64)(st->r[1] & 0x3ffff) << 26);
+   r1 = ((ulong64)st->r[1] >> 18) | ((ulong64) st->r[2]            <<  8)
+                                  | ((ulong64)(st->r[3] & 0x3ff)   << 34);
+   r2 = ((ulong64)st->r[3] >> 10) | ((ulong64) st->r[4]            << 16);
+   s1 = r1 * 20; /* 5 << 2, the 2^88 limb sits 2 bits above 2^130/2^44 */
+   s2 = r2 * 20;
+
+   h0 =  (ulong64)st->h[0]        + (((ulong64)(st->h[1] & 0x3ffff)) << 26);
+   h1 = ((ulong64)st->h[1] >> 18) +  ((ulong64) st->h[2]             <<  8)
+                                  + (((ulong64)(st->h[3] & 0x3ff))   << 34);
+   h2 = ((ulong64)st->h[3] >> 10) +  ((ulong64) st->h[4]             << 16);
+
+   while (inlen >= 16) {
+      /* h += in[i] */
+      LOAD64L(t0, in + 0);
+      LOAD64L(t1, in + 8);
+      h0 += t0 & M44;
+      h1 += ((t0 >> 44) | (t1 << 20)) & M44;
+      h2 += ((t1 >> 24) & M42) | hibit;
+
+      /* h *= r */
+      d0 = ((ulong128)h0 * r0) + ((ulong128)h1 * s2) + ((ulong128)h2 * s1);
+      d1 = ((ulong128)h0 * r1) + ((ulong128)h1 * r0) + ((ulong128)h2 * s2);
+      d2 = ((ulong128)h0 * r2) + ((ulong128)h1 * r1) + ((ulong128)h2 * r0);
+
+      /* (partial) h %= p */
+                   c = (ulong64)(d0 >> 44); h0 = (ulong64)d0 & M44;
+      d1 += c;     c = (ulong64)(d1 >> 44); h1 = (ulong64)d1 & M44;
+      d2 += c;     c = (ulong64)(d2 >> 42); h2 = (ulong64)d2 & M42;
+      h0 += c * 5; c = h0 >> 44;            h0 &= M44;
+      h1 += c;
+
+      in += 16;
+      inlen -= 16;
+   }
+
+   /* one more carry round so every limb is strictly below its radix,
+    * then repack to radix 2^26 */
+   c = h1 >> 44; h1 &= M44; h2 += c;
+   c = h2 >> 42; h2 &= M42; h0 += c * 5;
+   c = h0 >> 44; h0 &= M44; h1 += c;
+   c = h1 >> 44; h1 &= M44; h2 += c;
+
+   st->h[0] = (ulong32)( h0                      ) & 0x3ffffff;
+   st->h[1] = (ulong32)((h0 >> 26) | (h1 << 18)) & 0x3ffffff;
+   st->h[2] = (ulong32)( h1 >>  8              ) & 0x3ffffff;
+   st->h[3] = (ulong32)((h1 >> 34) | (h2 << 10)) & 0x3ffffff;
+   st->h[4] = (ulong32)( h2 >> 16              );
+
+   return CRYPT_OK;
+}
+
+/**
+  Probe (once) whether the AVX2 core may be used.
+  @return 1 if AVX2 is available, 0 otherwise
+*/
+int poly1305_avx2_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_AVX2) != 0;
+}
+
+/* a = a * b mod p, radix 2^26, partially reduced; used to raise r to
+ * the small powers the lanes run against */
+static void _poly1305_mulmod(ulong32 *a, const ulong32 *b)
+{
+   ulong32 s1, s2, s3, s4, c;
+   ulong64 d0, d1, d2, d3, d4;
+
+   s1 = b[1] * 5;
+   s2 = b[2] * 5;
+   s3 = b[3] * 5;
+   s4 = b[4] * 5;
+
+   d0 = ((ulong64)a[0] * b[0]) + ((ulong64)a[1] * s4) + ((ulong64)a[2] * s3) + ((ulong64)a[3] * s2) + ((ulong64)a[4] * s1);
+   d1 = ((ulong64)a[0] * b[1]) + ((ulong64)a[1] * b[0]) + ((ulong64)a[2] * s4) + ((ulong64)a[3] * s3) + ((ulong64)a[4] * s2);
+   d2 = ((ulong64)a[0] * b[2]) + ((ulong64)a[1] * b[1]) + ((ulong64)a[2] * b[0]) + ((ulong64)a[3] * s4) + ((ulong64)a[4] * s3);
+   d3 = ((ulong64)a[0] * b[3]) + ((ulong64)a[1] * b[2]) + ((ulong64)a[2] * b[1]) + ((ulong64)a[3] * b[0]) + ((ulong64)a[4] * s4);
+   d4 = ((ulong64)a[0] * b[4]) + ((ulong64)a[1] * b[3]) + ((ulong64)a[2] * b[2]) + ((ulong64)a[3] * b[1]) + ((ulong64)a[4] * b[0]);
+
+                 c = (ulong32)(d0 >> 26); a[0] = (ulong32)d0 & 0x3ffffff;
+   d1 += c;      c = (ulong32)(d1 >> 26); a[1] = (ulong32)d1 & 0x3ffffff;
+   d2 += c;      c = (ulong32)(d2 >> 26); a[2] = (ulong32)d2 & 0x3ffffff;
+   d3 += c;      c = (ulong32)(d3 >> 26); a[3] = (ulong32)d3 & 0x3ffffff;
+   d4 += c;      c = (ulong32)(d4 >> 26); a[4] = (ulong32)d4 & 0x3ffffff;
+   a[0] += c * 5; c =          (a[0] >> 26); a[0] &= 0x3ffffff;
+   a[1] += c;
+}
+
+/* split four consecutive blocks into 26 bit limb vectors, one block per
+ * 64-bit lane, with the 2^128 bit already set */
+LTC_POLY1305_AVX2_CALL
+static void _poly1305_avx2_load(__m256i M[5], const unsigned char *in)
+{
+   ulong64 m[5][4];
+   ulong32 t;
+   int i, j;
+
+   for (j = 0; j < 4; j++) {
+      LOAD32L(t, in + 16*j +  0); m[0][j] = (t     ) & 0x3ffffff;
+      LOAD32L(t, in + 16*j +  3); m[1][j] = (t >> 2) & 0x3ffffff;
+      LOAD32L(t, in + 16*j +  6); m[2][j] = (t >> 4) & 0x3ffffff;
+      LOAD32L(t, in + 16*j +  9); m[3][j] = (t >> 6) & 0x3ffffff;
+      LOAD32L(t, in + 16*j + 12); m[4][j] = (t >> 8) | (1UL << 24);
+   }
+   for (i = 0; i < 5; i++) {
+      M[i] = _mm256_set_epi64x((long long)m[i][3], (long long)m[i][2],
+                               (long long)m[i][1], (long long)m[i][0]);
+   }
+}
+
+#define V_MUL(a, b)   _mm256_mul_epu32(a, b)
+#define V_ADD(a, b)   _mm256_add_epi64(a, b)
+#define V_MUL5(x)     V_ADD(x, _mm256_slli_epi64(x, 2))
+
+/* D = H * R, lane-wise, 26 bit limbs against precomputed 5*R limbs */
+#define V_MULR(D, H, R, S)                                                                                             \
+do {                                                                                                                   \
+   D[0] = V_ADD(V_ADD(V_MUL(H[0], R[0]), V_MUL(H[1], S[3])), V_ADD(V_ADD(V_MUL(H[2], S[2]), V_MUL(H[3], S[1])), V_MUL(H[4], S[0]))); \
+   D[1] = V_ADD(V_ADD(V_MUL(H[0], R[1]), V_MUL(H[1], R[0])), V_ADD(V_ADD(V_MUL(H[2], S[3]), V_MUL(H[3], S[2])), V_MUL(H[4], S[1]))); \
+   D[2] = V_ADD(V_ADD(V_MUL(H[0], R[2]), V_MUL(H[1], R[1])), V_ADD(V_ADD(V_MUL(H[2], R[0]), V_MUL(H[3], S[3])), V_MUL(H[4], S[2]))); \
+   D[3] = V_ADD(V_ADD(V_MUL(H[0], R[3]), V_MUL(H[1], R[2])), V_ADD(V_ADD(V_MUL(H[2], R[1]), V_MUL(H[3], R[0])), V_MUL(H[4], S[3]))); \
+   D[4] = V_ADD(V_ADD(V_MUL(H[0], R[4]), V_MUL(H[1], R[3])), V_ADD(V_ADD(V_MUL(H[2], R[2]), V_MUL(H[3], R[1])), V_MUL(H[4], R[0]))); \
+} while (0)
+
+/* carry D back down to (just above) 26 bits per limb, into H */
+#define V_CARRY(H, D, MSK)                                                \
+do {                                                                      \
+   __m256i _c;                                                            \
+   _c = _mm256_srli_epi64(D[0], 26); H[0] = _mm256_and_si256(D[0], MSK);  \
+   D[1] = V_ADD(D[1], _c);                                                \
+   _c = _mm256_srli_epi64(D[1], 26); H[1] = _mm256_and_si256(D[1], MSK);  \
+   D[2] = V_ADD(D[2], _c);                                                \
+   _c = _mm256_srli_epi64(D[2], 26); H[2] = _mm256_and_si256(D[2], MSK);  \
+   D[3] = V_ADD(D[3], _c);                                                \
+   _c = _mm256_srli_epi64(D[3], 26); H[3] = _mm256_and_si256(D[3], MSK);  \
+   D[4] = V_ADD(D[4], _c);                                                \
+   _c = _mm256_srli_epi64(D[4], 26); H[4] = _mm256_and_si256(D[4], MSK);  \
+   H[0] = V_ADD(H[0], V_MUL5(_c));                                        \
+   _c = _mm256_srli_epi64(H[0], 26); H[0] = _mm256_and_si256(H[0], MSK);  \
+   H[1] = V_ADD(H[1], _c);                                                \
+} while (0)
+
+/**
+  Process groups of four 16 byte blocks in AVX2 lanes.  Lane j holds the
+  running sum of blocks j, j+4, ... times powers of r^4; the lanes are
+  folded together against r^4..r^1 on exit, which matches the serial
+  evaluation exactly.  Only called mid-message, i.e. with st->final
+  clear.
+  @param st     The Poly1305 state
+  @param in     The data to process
+  @param inlen  The length of the data (octets, a multiple of 64)
+  @return CRYPT_OK if successful
+*/
+LTC_POLY1305_AVX2_CALL
+int poly1305_avx2_blocks(poly1305_state *st, const unsigned char *in, unsigned long inlen)
+{
+   ulong32 rp[4][5];     /* r^1 .. r^4 */
+   __m256i H[5], M[5], D[5], R[5], S[4], P[5], Q[4], MSK;
+   ulong64 d[5], lanes[4];
+   ulong64 c;
+   int i;
+
+   for (i = 0; i < 5; i++) {
+      rp[0][i] = st->r[i];
+      rp[1][i] = st->r[i];
+   }
+   _poly1305_mulmod(rp[1], rp[0]);        /* r^2 */
+   for (i = 0; i < 5; i++) rp[2][i] = rp[1][i];
+   _poly1305_mulmod(rp[2], rp[0]);        /* r^3 */
+   for (i = 0; i < 5; i++) rp[3][i] = rp[2][i];
+   _poly1305_mulmod(rp[3], rp[0]);        /* r^4 */
+
+   MSK = _mm256_set1_epi64x(0x3ffffff);
+   for (i = 0; i < 5; i++) {
+      R[i] = _mm256_set1_epi64x((long long)rp[3][i]);
+   }
+   for (i = 0; i < 4; i++) {
+      S[i] = _mm256_set1_epi64x((long long)(rp[3][i + 1] * 5));
+   }
+
+   /* the first group seeds the lanes; the running h joins lane 0, which
+    * carries the highest power of r */
+   _poly1305_avx2_load(H, in);
+   for (i = 0; i < 5; i++) {
+      H[i] = V_ADD(H[i], _mm256_set_epi64x(0, 0, 0, (long long)st->h[i]));
+   }
+   in    += 64;
+   inlen -= 64;
+
+   while (inlen >= 64) {
+      /* H = H * r^4 + next group */
+      V_MULR(D, H, R, S);
+      V_CARRY(H, D, MSK);
+      _poly1305_avx2_load(M, in);
+      for (i = 0; i < 5; i++) {
+         H[i] = V_ADD(H[i], M[i]);
+      }
+      in    += 64;
+      inlen -= 64;
+   }
+
+   /* fold: h = H0*r^4 + H1*r^3 + H2*r^2 + H3*r^1 */
+   for (i = 0; i < 5; i++) {
+      P[i] = _mm256_set_epi64x((long long)rp[0][i], (long long)rp[1][i],
+                               (long long)rp[2][i], (long long)rp[3][i]);
+   }
+   for (i = 0; i < 4; i++) {
+      Q[i] = _mm256_set_epi64x((long long)(rp[0][i + 1] * 5), (long long)(rp[1][i + 1] * 5),
+                               (long long)(rp[2][i + 1] * 5), (long long)(rp[3][i + 1] * 5));
+   }
+   V_MULR(D, H, P, Q);
+   for (i = 0; i < 5; i++) {
+      _mm256_storeu_si256((__m256i *)lanes, D[i]);
+      d[i] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+   }
+
+   /* (partial) h %= p */
+                c = d[0] >> 26; d[0] &= 0x3ffffff;
+   d[1] += c;   c = d[1] >> 26; d[1] &= 0x3ffffff;
+   d[2] += c;   c = d[2] >> 26; d[2] &= 0x3ffffff;
+   d[3] += c;   c = d[3] >> 26; d[3] &= 0x3ffffff;
+   d[4] += c;   c = d[4] >> 26; d[4] &= 0x3ffffff;
+   d[0] += c * 5; c = d[0] >> 26; d[0] &= 0x3ffffff;
+   d[1] += c;
+
+   for (i = 0; i < 5; i++) {
+      st->h[i] = (ulong32)d[i];
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(rp, sizeof(rp));
+   zeromem(d, sizeof(d));
+   zeromem(lanes, sizeof(lanes));
+#endif
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,140 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file siphash_memory.c
+   SipHash keyed short-input PRF (Aumasson & Bernstein), by Tom St Denis
+
+   Built for keyed hash tables and load balancers: a 16-octet key, a
+   64- or 128-bit tag, and a few dozen cycles on the 16-byte inputs
+   that cost hundreds through hmac_memory().  The whole thing runs on
+   four ulong64s of stack -- no context, no allocation.
+
+   SipHash is a PRF, not a collision-resistant hash: use it where the
+   key stays secret (flood-proofing table lookups), not in signatures.
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_SIPHASH
+
+#define SIPROUND(v0, v1, v2, v3)          \
+   do {                                   \
+      v0 += v1; v1 = ROL64(v1, 13);       \
+      v1 ^= v0; v0 = ROL64(v0, 32);       \
+      v2 += v3; v3 = ROL64(v3, 16);       \
+      v3 ^= v2;                           \
+      v0 += v3; v3 = ROL64(v3, 21);       \
+      v3 ^= v0;                           \
+      v2 += v1; v1 = ROL64(v1, 17);       \
+      v1 ^= v2; v2 = ROL64(v2, 32);       \
+   } while (0)
+
+/**
+  SipHash-c-d over a buffer
+
+  @param key      The secret key (16 octets)
+  @param in       The data to authenticate
+  @param inlen    The length of the data (octets)
+  @param crounds  Compression rounds per block (2 for SipHash-2-4, 1 for -1-3)
+  @param drounds  Finalization rounds (4 for SipHash-2-4, 3 for -1-3)
+  @param tag      [out] The tag
+  @param taglen   [in/out] The tag length (must be 8 or 16 on input)
+  @return CRYPT_OK on success
+*/
+int siphash_memory_ex(const unsigned char *key,
+                      const unsigned char *in,  unsigned long inlen,
+                      int crounds, int drounds,
+                      unsigned char *tag, unsigned long *taglen)
+{
+   ulong64 v0, v1, v2, v3, k0, k1, m;
+   unsigned long x;
+   int i;
+
+   LTC_ARGCHK(key    != NULL);
+   LTC_ARGCHK(tag    != NULL);
+   LTC_ARGCHK(taglen != NULL);
+   if (inlen > 0) {
+      LTC_ARGCHK(in != NULL);
+   }
+   if (crounds < 1 || drounds < 1) {
+      return CRYPT_INVALID_ARG;
+   }
+   if (*taglen != 8 && *taglen != 16) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   LOAD64L(k0, key);
+   LOAD64L(k1, key + 8);
+   v0 = k0 ^ CONST64(0x736f6d6570736575);
+   v1 = k1 ^ CONST64(0x646f72616e646f6d);
+   v2 = k0 ^ CONST64(0x6c7967656e657261);
+   v3 = k1 ^ CONST64(0x7465646279746573);
+   if (*taglen == 16) {
+      v1 ^= 0xEE;
+   }
+
+   for (x = 0; inlen - x >= 8; x += 8) {
+      LOAD64L(m, in + x);
+      v3 ^= m;
+      for (i = 0; i < crounds; i++) {
+         SIPROUND(v0, v1, v2, v3);
+      }
+      v0 ^= m;
+   }
+
+   /* last block: remaining octets little-endian, length in the top octet */
+   m = (ulong64)(inlen & 255) << 56;
+   for (i = 0; x + (unsigned long)i < inlen; i++) {
+      m |= (ulong64)in[x + i] << (8 * i);
+   }
+   v3 ^= m;
+   for (i = 0; i < crounds; i++) {
+      SIPROUND(v0, v1, v2, v3);
+   }
+   v0 ^= m;
+
+   v2 ^= (*taglen == 16) ? 0xEE : 0xFF;
+   for (i = 0; i < drounds; i++) {
+      SIPROUND(v0, v1, v2, v3);
+   }
+   STORE64L(v0 ^ v1 ^ v2 ^ v3, tag);
+
+   if (*taglen == 16) {
+      v1 ^= 0xDD;
+      for (i = 0; i < drounds; i++) {
+         SIPROUND(v0, v1, v2, v3);
+      }
+      STORE64L(v0 ^ v1 ^ v2 ^ v3, tag + 8);
+   }
+   return CRYPT_OK;
+}
+
+/**
+  SipHash-2-4 over a buffer (the standard parameters)
+  @param key     The secret key (16 octets)
+  @param in      The data to authenticate
+  @param inlen   The length of the data (octets)
+  @param tag     [out] The tag
+  @param taglen  [in/out] The tag length (must be 8 or 16 on input)
+  @return CRYPT_OK on success
+*/
+int siphash_memory(const unsigned char *key,
+                   const unsigned char *in,  unsigned long inlen,
+                         unsigned char *tag, unsigned long *taglen)
+{
+   return siphash_memory_ex(key, in, inlen, 2, 4, tag, taglen);
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
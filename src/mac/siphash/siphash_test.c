@@ -0,0 +1,108 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+   @file siphash_test.c
+   SipHash self test, by Tom St Denis
+*/
+#include "tomcrypt.h"
+
+#ifdef LTC_SIPHASH
+
+/**
+  Test the SipHash implementation
+  @return CRYPT_OK on success
+*/
+int siphash_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   /* reference-implementation vectors: key = 00..0f, msg = 00..n-1 */
+   static const struct {
+      int c, d, inlen;
+      unsigned char tag[16]; int taglen;
+   } tests[] = {
+      { 2, 4,  0, { 0x31,0x0e,0x0e,0xdd,0x47,0xdb,0x6f,0x72 }, 8 },
+      { 2, 4,  1, { 0xfd,0x67,0xdc,0x93,0xc5,0x39,0xf8,0x74 }, 8 },
+      { 2, 4,  2, { 0x5a,0x4f,0xa9,0xd9,0x09,0x80,0x6c,0x0d }, 8 },
+      { 2, 4,  3, { 0x2d,0x7e,0xfb,0xd7,0x96,0x66,0x67,0x85 }, 8 },
+      { 2, 4,  4, { 0xb7,0x87,0x71,0x27,0xe0,0x94,0x27,0xcf }, 8 },
+      { 2, 4,  5, { 0x8d,0xa6,0x99,0xcd,0x64,0x55,0x76,0x18 }, 8 },
+      { 2, 4,  6, { 0xce,0xe3,0xfe,0x58,0x6e,0x46,0xc9,0xcb }, 8 },
+      { 2, 4,  7, { 0x37,0xd1,0x01,0x8b,0xf5,0x00,0x02,0xab }, 8 },
+      { 2, 4, 15, { 0xe5,0x45,0xbe,0x49,0x61,0xca,0x29,0xa1 }, 8 },
+      { 2, 4,  0, { 0xa3,0x81,0x7f,0x04,0xba,0x25,0xa8,0xe6,
+                    0x6d,0xf6,0x72,0x14,0xc7,0x55,0x02,0x93 }, 16 },
+      { 2, 4,  1, { 0xda,0x87,0xc1,0xd8,0x6b,0x99,0xaf,0x44,
+                    0x34,0x76,0x59,0x11,0x9b,0x22,0xfc,0x45 }, 16 },
+      { 2, 4, 15, { 0x54,0x93,0xe9,0x99,0x33,0xb0,0xa8,0x11,
+                    0x7e,0x08,0xec,0x0f,0x97,0xcf,0xc3,0xd9 }, 16 },
+      { 1, 3,  0, { 0xdc,0xc4,0x0f,0x05,0x58,0x01,0xac,0xab }, 8 },
+      { 1, 3,  1, { 0x93,0xca,0x57,0x7d,0xf3,0x9b,0xf4,0xc9 }, 8 },
+      { 1, 3,  2, { 0x4d,0xd4,0xc7,0x4d,0x02,0x9b,0xcb,0x82 }, 8 },
+      { 1, 3,  3, { 0xfb,0xf7,0xdd,0xe7,0xb8,0x0a,0xf8,0x8b }, 8 },
+      { 1, 3,  4, { 0x28,0x83,0xd3,0x88,0x60,0x57,0x75,0xcf }, 8 },
+      { 1, 3,  5, { 0x67,0x3b,0x53,0x49,0x2f,0xd5,0xf9,0xde }, 8 },
+      { 1, 3,  6, { 0xa7,0x22,0x9f,0xc5,0x50,0x2b,0x0d,0xc5 }, 8 },
+      { 1, 3,  7, { 0x40,0x11,0xb1,0x9b,0x98,0x7d,0x92,0xd3 }, 8 },
+      { 1, 3,  0, { 0xe7,0x7e,0xbc,0xb2,0x27,0x88,0xa5,0xbe,
+                    0xfd,0x62,0xdb,0x6a,0xdd,0x30,0x30,0x01 }, 16 },
+      { 1, 3,  7, { 0x10,0x84,0xb9,0x23,0xf2,0xaa,0xe0,0xc3,
+                    0xa6,0x2f,0x2e,0xc8,0x08,0x48,0xab,0x77 }, 16 },
+   };
+   unsigned char key[16], msg[16], tag[16];
+   unsigned long taglen;
+   unsigned int  x;
+   int err, i;
+
+   for (i = 0; i < 16; i++) {
+      key[i] = (unsigned char)i;
+      msg[i] = (unsigned char)i;
+   }
+
+   for (x = 0; x < sizeof(tests)/sizeof(tests[0]); x++) {
+      taglen = tests[x].taglen;
+      if ((err = siphash_memory_ex(key, msg, tests[x].inlen,
+                                   tests[x].c, tests[x].d,
+                                   tag, &taglen)) != CRYPT_OK) {
+         return err;
+      }
+      if (compare_testvector(tag, taglen,
+                             tests[x].tag, (unsigned long)tests[x].taglen,
+                             "SipHash", x) != 0) {
+         return CRYPT_FAIL_TESTVECTOR;
+      }
+   }
+
+   /* the convenience wrapper is SipHash-2-4 */
+   taglen = 8;
+   if ((err = siphash_memory(key, msg, 7, tag, &taglen)) != CRYPT_OK) {
+      return err;
+   }
+   if (compare_testvector(tag, 8, tests[7].tag, 8, "SipHash-wrap", 0) != 0) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+
+   /* odd tag lengths must be refused */
+   taglen = 12;
+   if (siphash_memory(key, msg, 7, tag, &taglen) != CRYPT_INVALID_ARG) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+   return CRYPT_OK;
+#endif
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -17,6 +17,13 @@
 
 #ifdef LTC_XCBC
 
+#ifndef LTC_NO_FILE
+static int _xcbc_file_process(void *state, const unsigned char *buf, unsigned long len)
+{
+   return xcbc_process(state, buf, len);
+}
+#endif
+
 /**
    XCBC a file
    @param cipher   The index of the cipher desired
@@ -35,53 +42,28 @@ int xcbc_file(int cipher,
 #ifdef LTC_NO_FILE
    return CRYPT_NOP;
 #else
-   size_t x;
-   int err;
    xcbc_state xcbc;
-   FILE *in;
-   unsigned char *buf;
+   int err;
 
    LTC_ARGCHK(key      != NULL);
    LTC_ARGCHK(filename != NULL);
    LTC_ARGCHK(out      != NULL);
    LTC_ARGCHK(outlen   != NULL);
 
-   if ((buf = XMALLOC(LTC_FILE_READ_BUFSIZE)) == NULL) {
-      return CRYPT_MEM;
-   }
-
    if ((err = xcbc_init(&xcbc, cipher, key, keylen)) != CRYPT_OK) {
-      goto LBL_ERR;
+      return err;
    }
 
-   in = fopen(filename, "rb");
-   if (in == NULL) {
-      err = CRYPT_FILE_NOTFOUND;
+   if ((err = file_process(filename, _xcbc_file_process, &xcbc)) != CRYPT_OK) {
       goto LBL_ERR;
    }
 
-   do {
-      x = fread(buf, 1, LTC_FILE_READ_BUFSIZE, in);
-      if ((err = xcbc_process(&xcbc, buf, (unsigned long)x)) != CRYPT_OK) {
-         fclose(in);
-         goto LBL_CLEANBUF;
-      }
-   } while (x == LTC_FILE_READ_BUFSIZE);
-
-   if (fclose(in) != 0) {
-      err = CRYPT_ERROR;
-      goto LBL_CLEANBUF;
-   }
-
    err = xcbc_done(&xcbc, out, outlen);
 
-LBL_CLEANBUF:
-   zeromem(buf, LTC_FILE_READ_BUFSIZE);
 LBL_ERR:
 #ifdef LTC_CLEAN_STACK
    zeromem(&xcbc, sizeof(xcbc_state));
 #endif
-   XFREE(buf);
    return err;
 #endif
 }
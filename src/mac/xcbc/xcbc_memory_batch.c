@@ -0,0 +1,130 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file xcbc_memory_batch.c
+  XCBC Support, many messages under one key
+*/
+
+#ifdef LTC_XCBC
+
+/** XCBC-MAC many messages under one key.  The three subkey derivations
+  and the K1 key schedule run once on a template state which is then
+  copied per message.  When the cipher provides accel_ecb_encrypt the
+  CBC chains of four messages are interleaved, four blocks per call, so
+  hardware that pipelines independent blocks is kept busy despite each
+  chain being serial.
+  @param cipher  Index of cipher to use
+  @param key     [in]  Secret key
+  @param keylen  Length of secret key in octets
+  @param in      The array of messages
+  @param inlen   The lengths of the messages (octets)
+  @param out     [out] The array of destinations of the tags
+  @param outlen  [in/out] Destination size and final tag size (applies to every tag)
+  @param msgs    The number of messages
+  Return CRYPT_OK on success
+*/
+int xcbc_memory_batch(int cipher,
+               const unsigned char *key, unsigned long keylen,
+               const unsigned char * const *in, const unsigned long *inlen,
+                     unsigned char * const *out, unsigned long *outlen, int msgs)
+{
+   xcbc_state    tmpl, st[4];
+   unsigned long taglen, blklen;
+   int           err, x, j;
+
+   LTC_ARGCHK(key    != NULL);
+   LTC_ARGCHK(outlen != NULL);
+   LTC_ARGCHK(in     != NULL || msgs == 0);
+   LTC_ARGCHK(inlen  != NULL || msgs == 0);
+   LTC_ARGCHK(out    != NULL || msgs == 0);
+
+   if ((err = xcbc_init(&tmpl, cipher, key, keylen)) != CRYPT_OK) {
+      return err;
+   }
+   blklen = tmpl.blocksize;
+   taglen = *outlen;
+
+   x = 0;
+   if (cipher_descriptor[cipher].accel_ecb_encrypt != NULL) {
+      while (msgs - x >= 4) {
+         unsigned char W[4*MAXBLOCKSIZE];
+         unsigned long blks, b, y, pos[4];
+
+         /* every lane holds at least one block back for xcbc_done */
+         blks = inlen[x] > 0 ? (inlen[x] - 1) / blklen : 0;
+         for (j = 0; j < 4; j++) {
+            XMEMCPY(&st[j], &tmpl, sizeof(tmpl));
+            pos[j] = 0;
+            b = inlen[x + j] > 0 ? (inlen[x + j] - 1) / blklen : 0;
+            if (b < blks) {
+               blks = b;
+            }
+         }
+
+         /* the whole blocks every lane has, four chains interleaved */
+         for (b = 0; b < blks; b++) {
+            for (j = 0; j < 4; j++) {
+               for (y = 0; y < blklen; y++) {
+                  W[j*blklen + y] = st[j].IV[y] ^ in[x + j][pos[j] + y];
+               }
+            }
+            if ((err = cipher_descriptor[cipher].accel_ecb_encrypt(W, W, 4, &tmpl.key)) != CRYPT_OK) {
+               goto LBL_ERR;
+            }
+            for (j = 0; j < 4; j++) {
+               XMEMCPY(st[j].IV, W + j*blklen, blklen);
+               pos[j] += blklen;
+            }
+         }
+
+         /* per-lane leftovers and the tag */
+         for (j = 0; j < 4; j++) {
+            unsigned long olen = taglen;
+            if ((err = xcbc_process(&st[j], in[x + j] + pos[j], inlen[x + j] - pos[j])) != CRYPT_OK) {
+               goto LBL_ERR;
+            }
+            if ((err = xcbc_done(&st[j], out[x + j], &olen)) != CRYPT_OK) {
+               goto LBL_ERR;
+            }
+            *outlen = olen;
+         }
+         x += 4;
+      }
+   }
+
+   for (; x < msgs; x++) {
+      unsigned long olen = taglen;
+      XMEMCPY(&st[0], &tmpl, sizeof(tmpl));
+      if ((err = xcbc_process(&st[0], in[x], inlen[x])) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = xcbc_done(&st[0], out[x], &olen)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      *outlen = olen;
+   }
+
+   err = CRYPT_OK;
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(&tmpl, sizeof(tmpl));
+   zeromem(st, sizeof(st));
+#endif
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,45 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file xcbc_reset.c
+  XCBC Support, restart a keyed state
+*/
+
+#ifdef LTC_XCBC
+
+/** Rewind an XCBC-MAC state to just after xcbc_init, discarding any
+  data processed so far.  The three derived subkeys and the scheduled
+  K1 are kept, so the next message under the same key skips the key
+  setup and the three subkey derivations.
+  @param xcbc    The XCBC-MAC state
+  Return CRYPT_OK on success
+*/
+int xcbc_reset(xcbc_state *xcbc)
+{
+   int err;
+
+   LTC_ARGCHK(xcbc != NULL);
+   if ((err = cipher_is_valid(xcbc->cipher)) != CRYPT_OK) {
+      return err;
+   }
+
+   zeromem(xcbc->IV, sizeof(xcbc->IV));
+   xcbc->buflen = 0;
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,153 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file exptmod_ct.c
+  Timing resistant exponentiation, Tom St Denis
+
+  A fixed four-bit window exponentiation whose observable behaviour
+  does not depend on the exponent: the window count is derived from the
+  modulus size rather than the exponent length, every window runs four
+  squarings and exactly one multiply (table entry zero is the
+  Montgomery unit, so zero digits multiply by one), and the window
+  entry is picked by scanning the whole table -- each of the sixteen
+  entries is copied every window, to the selection or to a sink chosen
+  by index arithmetic, so the table read pattern is uniform.  True
+  cache-line interleaved storage is not expressible through the opaque
+  provider bignums, the full-table copy pass is the equivalent at this
+  layer.  Registered as the exptmod_ct hook of the bundled descriptors;
+  costs one window multiply per digit like the regular windowed code,
+  so the overhead over plain mp_exptmod stays small.
+*/
+
+#ifdef LTC_MPI
+
+int ltc_mp_exptmod_ct(void *a, void *b, void *c, void *d)
+{
+   void *tab[16], *r, *sel, *snk, *dst, *mont, *R;
+   int   err, x, y, w, bits, cbits, dbits;
+
+   LTC_ARGCHK(a != NULL);
+   LTC_ARGCHK(b != NULL);
+   LTC_ARGCHK(c != NULL);
+   LTC_ARGCHK(d != NULL);
+
+   if (ltc_mp.montgomery_reduce == NULL) {
+      return CRYPT_NOP;
+   }
+
+   mont = NULL;
+   R = r = sel = snk = NULL;
+   for (x = 0; x < 16; x++) {
+      tab[x] = NULL;
+   }
+
+   if ((err = mp_montgomery_setup(c, &mont)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = mp_init_multi(&R, &r, &sel, &snk, NULL)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = mp_montgomery_normalization(R, c)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   for (x = 0; x < 16; x++) {
+      if ((err = mp_init(&tab[x])) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+   }
+
+   /* tab[0] = the Montgomery unit, tab[x] = (a^x)R mod c */
+   if ((err = mp_copy(R, tab[0])) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = mp_mulmod(a, R, c, tab[1])) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   for (x = 2; x < 16; x++) {
+      if ((err = mp_mul(tab[x-1], tab[1], tab[x])) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = mp_montgomery_reduce(tab[x], c, mont)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+   }
+
+   if ((err = mp_copy(tab[0], r)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   /* pad the walk to the modulus size so the window count does not
+    * give away the exponent length (exponents beyond the modulus
+    * size still get their full walk) */
+   bits  = mp_count_bits(b);
+   cbits = mp_count_bits(c);
+   if (cbits > bits) {
+      bits = cbits;
+   }
+   dbits = MP_DIGIT_BIT;
+   for (x = ((bits + 3) & ~3) - 4; x >= 0; x -= 4) {
+      for (y = 0; y < 4; y++) {
+         if ((err = mp_sqr(r, r)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+         if ((err = mp_montgomery_reduce(r, c, mont)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+      }
+      w = 0;
+      for (y = 3; y >= 0; y--) {
+         w <<= 1;
+         if (x + y < mp_count_bits(b)) {
+            w |= (int)((mp_get_digit(b, (x + y) / dbits) >> ((unsigned)(x + y) % (unsigned)dbits)) & 1);
+         }
+      }
+      /* scan the whole table; the entry we want lands in sel, the
+       * other fifteen land in the sink */
+      for (y = 0; y < 16; y++) {
+         dst = (y == w) ? sel : snk;
+         if ((err = mp_copy(tab[y], dst)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+      }
+      if ((err = mp_mul(r, sel, r)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = mp_montgomery_reduce(r, c, mont)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+   }
+
+   /* take the result back out of the Montgomery domain */
+   if ((err = mp_montgomery_reduce(r, c, mont)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   err = mp_copy(r, d);
+
+LBL_ERR:
+   if (R != NULL) {
+      mp_clear_multi(R, r, sel, snk, NULL);
+   }
+   for (x = 0; x < 16; x++) {
+      if (tab[x] != NULL) {
+         mp_clear(tab[x]);
+      }
+   }
+   mp_montgomery_free(mont);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
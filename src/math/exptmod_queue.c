@@ -0,0 +1,165 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file exptmod_queue.c
+  Asynchronous exponentiation queue, Tom St Denis
+
+  A signer that computes one exptmod per request thread serializes its
+  cores behind the slowest call.  This module decouples submission from
+  execution: requests enqueue {base, exponent, modulus, result} jobs
+  and poll (or block) for completion, while any number of worker
+  threads drain the queue through ltc_exptmod_run().  As with the
+  parallel cipher modes the library never spawns threads itself -- the
+  application owns the pool and simply points its workers here.
+
+  Jobs carry an optional Montgomery context (mp_montgomery_setup plus
+  normalization residue, e.g. from rsa_mont_setup) so per-key constants
+  are derived once, not per signature.  All bignums in a job are caller
+  owned and must stay valid until the job completes.
+*/
+
+#ifdef LTC_MPI
+
+static ltc_exptmod_job *s_eq_head, *s_eq_tail;
+
+LTC_MUTEX_GLOBAL(ltc_exptmod_queue_lock)
+
+/* run one queued job; returns zero when the queue was empty */
+static int s_eq_run_one(void)
+{
+   ltc_exptmod_job *job;
+   int err;
+
+   LTC_MUTEX_LOCK(&ltc_exptmod_queue_lock);
+   job = s_eq_head;
+   if (job == NULL) {
+      LTC_MUTEX_UNLOCK(&ltc_exptmod_queue_lock);
+      return 0;
+   }
+   s_eq_head = job->next;
+   if (s_eq_head == NULL) {
+      s_eq_tail = NULL;
+   }
+   job->state = LTC_EXPTMOD_RUNNING;
+   LTC_MUTEX_UNLOCK(&ltc_exptmod_queue_lock);
+
+   if (job->mont != NULL && job->mont_R != NULL) {
+      err = ltc_mp_exptmod_mont(job->G, job->X, job->P, job->mont, job->mont_R, job->R);
+   } else {
+      err = mp_exptmod(job->G, job->X, job->P, job->R);
+   }
+
+   LTC_MUTEX_LOCK(&ltc_exptmod_queue_lock);
+   job->err   = err;
+   job->state = LTC_EXPTMOD_DONE;
+   LTC_MUTEX_UNLOCK(&ltc_exptmod_queue_lock);
+
+   if (job->callback != NULL) {
+      job->callback(job);
+   }
+   return 1;
+}
+
+/**
+   Submit an exponentiation job, R = G^X mod P
+   The G/X/P/R (and optional mont/mont_R) bignums stay caller owned and
+   must remain valid until the job reports done.
+   @param job  The job to queue; state and err are reset here
+   @return CRYPT_OK on success
+*/
+int ltc_exptmod_submit(ltc_exptmod_job *job)
+{
+   LTC_ARGCHK(job    != NULL);
+   LTC_ARGCHK(job->G != NULL);
+   LTC_ARGCHK(job->X != NULL);
+   LTC_ARGCHK(job->P != NULL);
+   LTC_ARGCHK(job->R != NULL);
+
+   job->state = LTC_EXPTMOD_QUEUED;
+   job->err   = CRYPT_OK;
+   job->next  = NULL;
+
+   LTC_MUTEX_LOCK(&ltc_exptmod_queue_lock);
+   if (s_eq_tail != NULL) {
+      s_eq_tail->next = job;
+   } else {
+      s_eq_head = job;
+   }
+   s_eq_tail = job;
+   LTC_MUTEX_UNLOCK(&ltc_exptmod_queue_lock);
+   return CRYPT_OK;
+}
+
+/**
+   Execute queued jobs on the calling (worker) thread
+   @param max  Run at most this many jobs, <= 0 to drain the queue
+   @param ran  [out] How many jobs this call executed (may be NULL)
+   @return CRYPT_OK (job failures are reported per job, not here)
+*/
+int ltc_exptmod_run(int max, int *ran)
+{
+   int n;
+
+   n = 0;
+   while ((max <= 0 || n < max) && s_eq_run_one() == 1) {
+      ++n;
+   }
+   if (ran != NULL) {
+      *ran = n;
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Poll a job for completion
+   @param job  The job to check
+   @return 1 if the job finished (job->err holds its result), 0 otherwise
+*/
+int ltc_exptmod_done(ltc_exptmod_job *job)
+{
+   int state;
+
+   LTC_ARGCHK(job != NULL);
+
+   LTC_MUTEX_LOCK(&ltc_exptmod_queue_lock);
+   state = job->state;
+   LTC_MUTEX_UNLOCK(&ltc_exptmod_queue_lock);
+   return state == LTC_EXPTMOD_DONE;
+}
+
+/**
+   Wait for a job, lending this thread to the queue meanwhile
+   Queued work is executed inline, so this degenerates to a synchronous
+   call when no worker threads exist.  If the job is being executed by
+   another thread the wait spins on its state.
+   @param job  The job to wait for
+   @return The job's own result code
+*/
+int ltc_exptmod_wait(ltc_exptmod_job *job)
+{
+   LTC_ARGCHK(job != NULL);
+
+   while (ltc_exptmod_done(job) == 0) {
+      if (s_eq_run_one() == 0 && ltc_exptmod_done(job) == 0) {
+         /* runs on another thread; nothing to lend a hand to */
+         continue;
+      }
+   }
+   return job->err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
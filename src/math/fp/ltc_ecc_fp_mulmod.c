@@ -18,6 +18,14 @@
 #if defined(LTC_MECC) && defined(LTC_MECC_FP)
 #include <limits.h>
 
+#if !defined(LTC_NO_FILE) && defined(LTC_FILE_POSIX)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 /* number of entries in the cache */
 #ifndef FP_ENTRIES
 #define FP_ENTRIES 16
@@ -41,7 +49,10 @@ static struct {
    int        lock;           /* flag to indicate cache eviction permitted (0) or not (1) */
 } fp_cache[FP_ENTRIES];
 
-LTC_MUTEX_GLOBAL(ltc_ecc_fp_lock)
+/* reader/writer lock on the cache: lookups that hit an entry with a
+ * built LUT share the lock, only misses and LUT builds take it
+ * exclusively */
+LTC_RWLOCK_GLOBAL(ltc_ecc_fp_lock)
 
 /* simple table to help direct the generation of the LUT */
 static const struct {
@@ -1119,7 +1130,28 @@ int ltc_ecc_fp_mul2add(ecc_point *A, void *kA,
 
    mp = NULL;
    mu = NULL;
-   LTC_MUTEX_LOCK(&ltc_ecc_fp_lock);
+
+   /* fast path: both bases cached with built LUTs need only a shared
+    * lock since accel_fp_mul2add just reads the tables */
+   LTC_RWLOCK_RDLOCK(&ltc_ecc_fp_lock);
+   idx1 = find_base(A);
+   idx2 = find_base(B);
+   if (idx1 >= 0 && idx2 >= 0 &&
+       fp_cache[idx1].lru_count >= 2 && fp_cache[idx2].lru_count >= 2) {
+      if ((err = mp_montgomery_setup(modulus, &mp)) != CRYPT_OK) {
+         LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
+         return err;
+      }
+      err = accel_fp_mul2add(idx1, idx2, kA, kB, C, modulus, mp);
+      LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
+      mp_montgomery_free(mp);
+      return err;
+   }
+   LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
+
+   /* slow path: may insert entries or build LUTs, so take the lock
+    * exclusively and redo the lookups */
+   LTC_RWLOCK_WRLOCK(&ltc_ecc_fp_lock);
       /* find point */
       idx1 = find_base(A);
 
@@ -1205,7 +1237,7 @@ int ltc_ecc_fp_mul2add(ecc_point *A, void *kA,
          err = ltc_ecc_mul2add(A, kA, B, kB, C, modulus);
       }
 LBL_ERR:
-    LTC_MUTEX_UNLOCK(&ltc_ecc_fp_lock);
+    LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
     if (mp != NULL) {
        mp_montgomery_free(mp);
     }
@@ -1231,7 +1263,28 @@ int ltc_ecc_fp_mulmod(void *k, ecc_point *G, ecc_point *R, void *modulus, int ma
 
    mp = NULL;
    mu = NULL;
-   LTC_MUTEX_LOCK(&ltc_ecc_fp_lock);
+
+   /* fast path: a cached base with a built LUT needs only a shared
+    * lock since accel_fp_mul just reads the table; the LRU counter is
+    * bumped on the exclusive path only, which merely coarsens the
+    * eviction order among cold entries */
+   LTC_RWLOCK_RDLOCK(&ltc_ecc_fp_lock);
+   idx = find_base(G);
+   if (idx >= 0 && fp_cache[idx].lru_count >= 2) {
+      if ((err = mp_montgomery_setup(modulus, &mp)) != CRYPT_OK) {
+         LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
+         return err;
+      }
+      err = accel_fp_mul(idx, k, R, modulus, mp, map);
+      LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
+      mp_montgomery_free(mp);
+      return err;
+   }
+   LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
+
+   /* slow path: may insert the entry or build its LUT, so take the
+    * lock exclusively and redo the lookup */
+   LTC_RWLOCK_WRLOCK(&ltc_ecc_fp_lock);
       /* find point */
       idx = find_base(G);
 
@@ -1281,7 +1334,7 @@ int ltc_ecc_fp_mulmod(void *k, ecc_point *G, ecc_point *R, void *modulus, int ma
          err = ltc_ecc_mulmod(k, G, R, modulus, map);
       }
 LBL_ERR:
-    LTC_MUTEX_UNLOCK(&ltc_ecc_fp_lock);
+    LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
     if (mp != NULL) {
        mp_montgomery_free(mp);
     }
@@ -1316,9 +1369,9 @@ static void ltc_ecc_fp_free_cache(void)
 /** Free the Fixed Point cache */
 void ltc_ecc_fp_free(void)
 {
-   LTC_MUTEX_LOCK(&ltc_ecc_fp_lock);
+   LTC_RWLOCK_WRLOCK(&ltc_ecc_fp_lock);
    ltc_ecc_fp_free_cache();
-   LTC_MUTEX_UNLOCK(&ltc_ecc_fp_lock);
+   LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
 }
 
 /** Add a point to the cache and initialize the LUT
@@ -1335,11 +1388,11 @@ ltc_ecc_fp_add_point(ecc_point *g, void *modulus, int lock)
    void *mp = NULL;
    void *mu = NULL;
 
-   LTC_MUTEX_LOCK(&ltc_ecc_fp_lock);
+   LTC_RWLOCK_WRLOCK(&ltc_ecc_fp_lock);
    if ((idx = find_base(g)) >= 0) {
       /* it is already in the cache ... just check that the LUT is initialized */
       if(fp_cache[idx].lru_count >= 2) {
-         LTC_MUTEX_UNLOCK(&ltc_ecc_fp_lock);
+         LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
          return CRYPT_OK;
       }
    }
@@ -1371,7 +1424,7 @@ ltc_ecc_fp_add_point(ecc_point *g, void *modulus, int lock)
    fp_cache[idx].lru_count = 2;
    fp_cache[idx].lock = lock;
 LBL_ERR:
-   LTC_MUTEX_UNLOCK(&ltc_ecc_fp_lock);
+   LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
    if (mp != NULL) {
       mp_montgomery_free(mp);
    }
@@ -1388,11 +1441,11 @@ void ltc_ecc_fp_tablelock(int lock)
 {
    int i;
 
-   LTC_MUTEX_LOCK(&ltc_ecc_fp_lock);
+   LTC_RWLOCK_WRLOCK(&ltc_ecc_fp_lock);
    for (i = 0; i < FP_ENTRIES; i++) {
       fp_cache[i].lock = lock;
    }
-   LTC_MUTEX_UNLOCK(&ltc_ecc_fp_lock);
+   LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
 }
 
 /** Export the current cache as a binary packet
@@ -1414,7 +1467,8 @@ int ltc_ecc_fp_save_state(unsigned char **out, unsigned long *outlen)
    fp_lut      = FP_LUT;
    num_entries = 0;
 
-   LTC_MUTEX_LOCK(&ltc_ecc_fp_lock);
+   /* only reads the cache, a shared lock suffices */
+   LTC_RWLOCK_RDLOCK(&ltc_ecc_fp_lock);
    /*
     * build the list;
       Cache DEFINITIONS ::=
@@ -1472,7 +1526,7 @@ int ltc_ecc_fp_save_state(unsigned char **out, unsigned long *outlen)
    err = der_encode_sequence(cache_entry, j, *out, outlen);
 save_err:
    XFREE(cache_entry);
-   LTC_MUTEX_UNLOCK(&ltc_ecc_fp_lock);
+   LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
    return err;
 }
 
@@ -1499,7 +1553,7 @@ int ltc_ecc_fp_restore_state(unsigned char *in, unsigned long inlen)
    j         = 0;
    asn1_list = NULL;
 
-   LTC_MUTEX_LOCK(&ltc_ecc_fp_lock);
+   LTC_RWLOCK_WRLOCK(&ltc_ecc_fp_lock);
    /*
     * start with an empty cache
     */
@@ -1568,15 +1622,117 @@ int ltc_ecc_fp_restore_state(unsigned char *in, unsigned long inlen)
       goto ERR_OUT;
    }
    XFREE(asn1_list);
-   LTC_MUTEX_UNLOCK(&ltc_ecc_fp_lock);
+   LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
    return CRYPT_OK;
 ERR_OUT:
    if(asn1_list)
       XFREE(asn1_list);
    ltc_ecc_fp_free_cache();
-   LTC_MUTEX_UNLOCK(&ltc_ecc_fp_lock);
+   LTC_RWLOCK_UNLOCK(&ltc_ecc_fp_lock);
+   return err;
+}
+
+#ifndef LTC_NO_FILE
+/** Export the current cache into a file
+    @param fname   The name of the file to (over)write
+    @return CRYPT_OK if successful
+*/
+int ltc_ecc_fp_save_state_file(const char *fname)
+{
+   unsigned char *buf;
+   unsigned long  buflen;
+   FILE          *out;
+   int            err;
+
+   LTC_ARGCHK(fname != NULL);
+
+   if ((err = ltc_ecc_fp_save_state(&buf, &buflen)) != CRYPT_OK) {
+      return err;
+   }
+
+   out = fopen(fname, "wb");
+   if (out == NULL) {
+      err = CRYPT_FILE_NOTFOUND;
+      goto LBL_FREE;
+   }
+   if (fwrite(buf, 1, buflen, out) != buflen) {
+      err = CRYPT_ERROR;
+   }
+   if (fclose(out) != 0 && err == CRYPT_OK) {
+      err = CRYPT_ERROR;
+   }
+LBL_FREE:
+   XFREE(buf);
+   return err;
+}
+
+/** Import a cache packet from a file
+    On POSIX hosts the file is mapped read-only and decoded straight out
+    of the mapping, so a cache shipped alongside the binary is shared
+    page-for-page between workers while it is being restored; elsewhere
+    it is read into a temporary buffer first.
+    @param fname   The name of the file to read
+    @return CRYPT_OK if successful
+*/
+int ltc_ecc_fp_restore_state_file(const char *fname)
+{
+   int err;
+
+   LTC_ARGCHK(fname != NULL);
+
+#ifdef LTC_FILE_POSIX
+   {
+      struct stat sb;
+      int fd;
+
+      fd = open(fname, O_RDONLY);
+      if (fd < 0) {
+         return CRYPT_FILE_NOTFOUND;
+      }
+      if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0) {
+         unsigned char *map;
+
+         map = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+         if (map != MAP_FAILED) {
+            err = ltc_ecc_fp_restore_state(map, (unsigned long)sb.st_size);
+            (void)munmap(map, (size_t)sb.st_size);
+            (void)close(fd);
+            return err;
+         }
+      }
+      (void)close(fd);
+   }
+#endif
+   {
+      unsigned char *buf;
+      long           sz;
+      FILE          *in;
+
+      in = fopen(fname, "rb");
+      if (in == NULL) {
+         return CRYPT_FILE_NOTFOUND;
+      }
+      if (fseek(in, 0, SEEK_END) != 0 || (sz = ftell(in)) <= 0 ||
+          fseek(in, 0, SEEK_SET) != 0) {
+         (void)fclose(in);
+         return CRYPT_ERROR;
+      }
+      if ((buf = XMALLOC((size_t)sz)) == NULL) {
+         (void)fclose(in);
+         return CRYPT_MEM;
+      }
+      if (fread(buf, 1, (size_t)sz, in) != (size_t)sz) {
+         (void)fclose(in);
+         XFREE(buf);
+         return CRYPT_ERROR;
+      }
+      (void)fclose(in);
+      err = ltc_ecc_fp_restore_state(buf, (unsigned long)sz);
+      XFREE(buf);
+   }
    return err;
 }
+#endif /* #ifndef LTC_NO_FILE */
 
 #endif
 
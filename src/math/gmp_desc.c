@@ -546,6 +546,8 @@ const ltc_math_descriptor gmp_desc = {
 
    &set_rand,
 
+   &ltc_mp_multi_exptmod,
+   &ltc_mp_exptmod_ct,
 };
 
 
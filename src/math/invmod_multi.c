@@ -0,0 +1,95 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file invmod_multi.c
+  Batch modular inversion via Montgomery's trick, Tom St Denis
+*/
+
+#ifdef LTC_MPI
+
+/**
+   Invert num values in place modulo c with a single real inversion.
+   Montgomery's trick: form the running products of all inputs, invert
+   the full product once, then peel each inverse back out, costing one
+   mp_invmod plus 3*(num-1) modular multiplies instead of num
+   inversions.  Every a[i] must be nonzero and coprime to c; on error
+   the array contents are unspecified.
+   @param a    Array of num values to invert, overwritten with the inverses
+   @param num  How many values
+   @param c    The modulus
+   @return CRYPT_OK if successful
+*/
+int ltc_mp_invmod_multi(void **a, int num, void *c)
+{
+   void **prod, *u, *t;
+   int    i, err;
+
+   LTC_ARGCHK(a != NULL);
+   LTC_ARGCHK(c != NULL);
+
+   if (num <= 0) {
+      return CRYPT_INVALID_ARG;
+   }
+   if (num == 1) {
+      return mp_invmod(a[0], c, a[0]);
+   }
+
+   prod = XCALLOC(num, sizeof(*prod));
+   if (prod == NULL) {
+      return CRYPT_MEM;
+   }
+   u = t = NULL;
+   for (i = 0; i < num; i++) {
+      if ((err = mp_init(&prod[i])) != CRYPT_OK) {
+         goto done;
+      }
+   }
+   if ((err = mp_init_multi(&u, &t, NULL)) != CRYPT_OK) {
+      goto done;
+   }
+
+   /* prod[i] = a[0] * ... * a[i] */
+   if ((err = mp_copy(a[0], prod[0])) != CRYPT_OK)                            { goto done; }
+   for (i = 1; i < num; i++) {
+      if ((err = mp_mulmod(prod[i-1], a[i], c, prod[i])) != CRYPT_OK)         { goto done; }
+   }
+
+   /* one inversion of the full product */
+   if ((err = mp_invmod(prod[num-1], c, u)) != CRYPT_OK)                      { goto done; }
+
+   /* peel: 1/a[i] = u * prod[i-1], then fold a[i] into u */
+   for (i = num - 1; i > 0; i--) {
+      if ((err = mp_mulmod(u, prod[i-1], c, t)) != CRYPT_OK)                  { goto done; }
+      if ((err = mp_mulmod(u, a[i], c, u)) != CRYPT_OK)                       { goto done; }
+      if ((err = mp_copy(t, a[i])) != CRYPT_OK)                               { goto done; }
+   }
+   err = mp_copy(u, a[0]);
+
+done:
+   if (u != NULL) {
+      mp_clear_multi(u, t, NULL);
+   }
+   for (i = 0; i < num; i++) {
+      if (prod[i] != NULL) {
+         mp_clear(prod[i]);
+      }
+   }
+   XFREE(prod);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -505,6 +505,8 @@ const ltc_math_descriptor ltm_desc = {
 
    &set_rand,
 
+   &ltc_mp_multi_exptmod,
+   &ltc_mp_exptmod_ct,
 };
 
 
@@ -0,0 +1,132 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file mont_exptmod.c
+  Modular exponentiation consuming a cached Montgomery context, Tom St Denis
+*/
+
+#ifdef LTC_MPI
+
+/**
+   Compute d = a^b mod c with a caller supplied Montgomery context, so
+   the per-call reduction setup of mp_exptmod is skipped.  Built on the
+   montgomery_* hooks of the active math descriptor; a fixed four-bit
+   window is used and the window multiply always runs (table entry zero
+   is the Montgomery unit) so the multiply pattern does not depend on
+   the exponent bits.
+   @param a    The base
+   @param b    The exponent (must not be negative)
+   @param c    The (odd) modulus
+   @param mont The reduction digit from mp_montgomery_setup(c, ...)
+   @param R    The residue from mp_montgomery_normalization(R, c)
+   @param d    The destination (may alias a)
+   @return CRYPT_OK if successful
+*/
+int ltc_mp_exptmod_mont(void *a, void *b, void *c, void *mont, void *R, void *d)
+{
+   void *tab[16], *r;
+   int   err, x, y, bits, dbits, w;
+
+   LTC_ARGCHK(a    != NULL);
+   LTC_ARGCHK(b    != NULL);
+   LTC_ARGCHK(c    != NULL);
+   LTC_ARGCHK(mont != NULL);
+   LTC_ARGCHK(R    != NULL);
+   LTC_ARGCHK(d    != NULL);
+
+   if (ltc_mp.montgomery_reduce == NULL) {
+      return CRYPT_NOP;
+   }
+
+   r = NULL;
+   for (x = 0; x < 16; x++) {
+      tab[x] = NULL;
+   }
+   for (x = 0; x < 16; x++) {
+      if ((err = mp_init(&tab[x])) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+   }
+   if ((err = mp_init(&r)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   /* tab[0] = the Montgomery unit, tab[x] = (a^x)R mod c */
+   if ((err = mp_copy(R, tab[0])) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = mp_mulmod(a, R, c, tab[1])) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   for (x = 2; x < 16; x++) {
+      if ((err = mp_mul(tab[x-1], tab[1], tab[x])) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = mp_montgomery_reduce(tab[x], c, mont)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+   }
+
+   if ((err = mp_copy(tab[0], r)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   bits  = mp_count_bits(b);
+   dbits = MP_DIGIT_BIT;
+   for (x = ((bits + 3) & ~3) - 4; x >= 0; x -= 4) {
+      for (y = 0; y < 4; y++) {
+         if ((err = mp_sqr(r, r)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+         if ((err = mp_montgomery_reduce(r, c, mont)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+      }
+      w = 0;
+      for (y = 3; y >= 0; y--) {
+         w <<= 1;
+         if (x + y < bits) {
+            w |= (int)((mp_get_digit(b, (x + y) / dbits) >> ((unsigned)(x + y) % (unsigned)dbits)) & 1);
+         }
+      }
+      if ((err = mp_mul(r, tab[w], r)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = mp_montgomery_reduce(r, c, mont)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+   }
+
+   /* take the result back out of the Montgomery domain */
+   if ((err = mp_montgomery_reduce(r, c, mont)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   err = mp_copy(r, d);
+
+LBL_ERR:
+   if (r != NULL) {
+      mp_clear(r);
+   }
+   for (x = 0; x < 16; x++) {
+      if (tab[x] != NULL) {
+         mp_clear(tab[x]);
+      }
+   }
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
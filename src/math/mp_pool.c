@@ -0,0 +1,146 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file mp_pool.c
+  Scratch pool for bignum temporaries, Tom St Denis
+
+  A point add spends a measurable share of its time in mp_init/mp_clear
+  churn for half a dozen short-lived bignums.  The provider owns the
+  representation, so the temporaries cannot be carved from a flat
+  region; instead initialized bignums are kept on a small free list and
+  handed out again, which removes the allocator round trip while the
+  numbers keep their grown capacity.  Values are zeroed on return to
+  the pool so a later caller never sees the previous user's data.
+*/
+
+#ifdef LTC_MPI
+#include <stdarg.h>
+
+#define LTC_MP_POOL_SIZE 64
+
+static void *s_mp_pool[LTC_MP_POOL_SIZE];
+static int   s_mp_pool_len;
+
+LTC_MUTEX_GLOBAL(ltc_mp_pool_lock)
+
+/**
+   Fetch an initialized bignum from the pool (or mp_init a fresh one)
+   @param a   [out] Where to store the bignum
+   @return CRYPT_OK on success
+*/
+int ltc_mp_pool_get(void **a)
+{
+   LTC_ARGCHK(a != NULL);
+
+   LTC_MUTEX_LOCK(&ltc_mp_pool_lock);
+   if (s_mp_pool_len > 0) {
+      *a = s_mp_pool[--s_mp_pool_len];
+      LTC_MUTEX_UNLOCK(&ltc_mp_pool_lock);
+      return CRYPT_OK;
+   }
+   LTC_MUTEX_UNLOCK(&ltc_mp_pool_lock);
+   return mp_init(a);
+}
+
+/**
+   Return a bignum to the pool (mp_clear when the pool is full)
+   @param a   The bignum to give back, NULL is ignored
+*/
+void ltc_mp_pool_put(void *a)
+{
+   if (a == NULL) {
+      return;
+   }
+   /* scrub the value before it can be handed to someone else */
+   if (mp_set(a, 0) != CRYPT_OK) {
+      mp_clear(a);
+      return;
+   }
+   LTC_MUTEX_LOCK(&ltc_mp_pool_lock);
+   if (s_mp_pool_len < LTC_MP_POOL_SIZE) {
+      s_mp_pool[s_mp_pool_len++] = a;
+      LTC_MUTEX_UNLOCK(&ltc_mp_pool_lock);
+      return;
+   }
+   LTC_MUTEX_UNLOCK(&ltc_mp_pool_lock);
+   mp_clear(a);
+}
+
+/**
+   Fetch several bignums at once, ltc_init_multi style
+   @param a   [out] First destination, terminate the list with NULL
+   @return CRYPT_OK on success
+*/
+int ltc_mp_pool_get_multi(void **a, ...)
+{
+   void    **cur = a;
+   int       np  = 0;
+   va_list   args;
+
+   va_start(args, a);
+   while (cur != NULL) {
+       if (ltc_mp_pool_get(cur) != CRYPT_OK) {
+          /* failed, give back what we took */
+          va_list clean_list;
+
+          va_start(clean_list, a);
+          cur = a;
+          while (np--) {
+              ltc_mp_pool_put(*cur);
+              cur = va_arg(clean_list, void**);
+          }
+          va_end(clean_list);
+          va_end(args);
+          return CRYPT_MEM;
+       }
+       ++np;
+       cur = va_arg(args, void**);
+   }
+   va_end(args);
+   return CRYPT_OK;
+}
+
+/**
+   Return several bignums at once, ltc_deinit_multi style
+   @param a   First bignum, terminate the list with NULL
+*/
+void ltc_mp_pool_put_multi(void *a, ...)
+{
+   void     *cur = a;
+   va_list   args;
+
+   va_start(args, a);
+   while (cur != NULL) {
+       ltc_mp_pool_put(cur);
+       cur = va_arg(args, void *);
+   }
+   va_end(args);
+}
+
+/**
+   Free every pooled bignum (process shutdown)
+*/
+void ltc_mp_pool_free(void)
+{
+   LTC_MUTEX_LOCK(&ltc_mp_pool_lock);
+   while (s_mp_pool_len > 0) {
+      mp_clear(s_mp_pool[--s_mp_pool_len]);
+   }
+   LTC_MUTEX_UNLOCK(&ltc_mp_pool_lock);
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,82 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file multi_exptmod.c
+  Simultaneous double exponentiation, Tom St Denis
+
+  Computes a1^b1 * a2^b2 mod c with one interleaved square-and-multiply
+  pass (Shamir's trick): the product a1*a2 is precomputed and the two
+  exponents are scanned together, so the whole evaluation costs one
+  squaring chain instead of the two a pair of mp_exptmod calls pays.
+  Registered as the multi_exptmod hook of the bundled descriptors; it
+  only leans on the generic mp_* primitives, so any provider can use it.
+  Not timing resistant -- meant for verification with public values.
+*/
+
+#ifdef LTC_MPI
+
+int ltc_mp_multi_exptmod(void *a1, void *b1, void *a2, void *b2, void *c, void *d)
+{
+   void *g12, *r;
+   int   i, s, bits, b1bits, b2bits, err;
+
+   LTC_ARGCHK(a1 != NULL);
+   LTC_ARGCHK(b1 != NULL);
+   LTC_ARGCHK(a2 != NULL);
+   LTC_ARGCHK(b2 != NULL);
+   LTC_ARGCHK(c  != NULL);
+   LTC_ARGCHK(d  != NULL);
+
+   if ((err = mp_init_multi(&g12, &r, NULL)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* g12 = a1 * a2 mod c, the multiplier for the 1/1 bit pattern */
+   if ((err = mp_mulmod(a1, a2, c, g12)) != CRYPT_OK)                         { goto done; }
+   if ((err = mp_set(r, 1)) != CRYPT_OK)                                      { goto done; }
+
+   b1bits = mp_count_bits(b1);
+   b2bits = mp_count_bits(b2);
+   bits   = MAX(b1bits, b2bits);
+
+   for (i = bits - 1; i >= 0; i--) {
+      if ((err = mp_sqrmod(r, c, r)) != CRYPT_OK)                             { goto done; }
+      s = 0;
+      if (i < b1bits) {
+         s |= (int)((mp_get_digit(b1, i / (int)MP_DIGIT_BIT) >>
+                     (i % (int)MP_DIGIT_BIT)) & 1);
+      }
+      if (i < b2bits) {
+         s |= (int)((mp_get_digit(b2, i / (int)MP_DIGIT_BIT) >>
+                     (i % (int)MP_DIGIT_BIT)) & 1) << 1;
+      }
+      if (s == 1) {
+         if ((err = mp_mulmod(r, a1, c, r)) != CRYPT_OK)                      { goto done; }
+      } else if (s == 2) {
+         if ((err = mp_mulmod(r, a2, c, r)) != CRYPT_OK)                      { goto done; }
+      } else if (s == 3) {
+         if ((err = mp_mulmod(r, g12, c, r)) != CRYPT_OK)                     { goto done; }
+      }
+   }
+
+   err = mp_copy(r, d);
+done:
+   mp_clear_multi(g12, r, NULL);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
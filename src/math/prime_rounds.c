@@ -0,0 +1,141 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file prime_rounds.c
+  Miller-Rabin rounds sharing one Montgomery context, Tom St Denis
+*/
+
+#if defined(LTC_MRSA) || (!defined(LTC_NO_MATH) && !defined(LTC_NO_PRNGS))
+
+/**
+   Run several Miller-Rabin rounds against one candidate with the
+   Montgomery context set up exactly once.  mp_prime_is_prime rebuilds
+   the reduction machinery inside every witness exponentiation even
+   though the modulus never changes; here mp_montgomery_setup runs once
+   per candidate and all rounds go through ltc_mp_exptmod_mont.  No
+   trial division is performed -- callers such as rand_prime sieve
+   before getting here.  Falls back to mp_prime_is_prime when the
+   active descriptor has no Montgomery hooks.
+   @param N       The candidate to test
+   @param rounds  Number of witness rounds (1 to 256)
+   @param prng    An active PRNG state (witness source)
+   @param wprng   The index of the PRNG desired
+   @param result  [out] LTC_MP_YES if probably prime, LTC_MP_NO if composite
+   @return CRYPT_OK if the test ran (check *result for the verdict)
+*/
+int ltc_mp_prime_rounds(void *N, int rounds, prng_state *prng, int wprng, int *result)
+{
+   void          *nm1, *nm3, *a, *y, *R, *mont;
+   unsigned char *buf;
+   unsigned long  len;
+   int            err, r, s, x, passed;
+
+   LTC_ARGCHK(N      != NULL);
+   LTC_ARGCHK(result != NULL);
+
+   *result = LTC_MP_NO;
+
+   if (rounds < 1 || rounds > 256) {
+      return CRYPT_INVALID_ARG;
+   }
+   if ((err = prng_is_valid(wprng)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* no Montgomery hooks, or candidates too small for the 2..N-2
+    * witness range; let the provider handle it */
+   if (ltc_mp.montgomery_reduce == NULL || mp_cmp_d(N, 5) == LTC_MP_LT) {
+      return mp_prime_is_prime(N, rounds, result);
+   }
+
+   /* even candidates are composite */
+   if ((mp_get_digit(N, 0) & 1) == 0) {
+      return CRYPT_OK;
+   }
+
+   mont = NULL;
+   if ((err = mp_init_multi(&nm1, &nm3, &a, &y, &R, NULL)) != CRYPT_OK) {
+      return err;
+   }
+
+   len = (unsigned long)mp_unsigned_bin_size(N);
+   buf = XMALLOC(len);
+   if (buf == NULL) {
+      err = CRYPT_MEM;
+      goto done;
+   }
+
+   /* N - 1 = 2^s * nm1 */
+   if ((err = mp_sub_d(N, 1, nm1)) != CRYPT_OK)        { goto done; }
+   if ((err = mp_sub_d(N, 3, nm3)) != CRYPT_OK)        { goto done; }
+   s = mp_cnt_lsb(nm1);
+   if ((err = mp_copy(nm1, a)) != CRYPT_OK)            { goto done; }
+   for (x = 0; x < s; x++) {
+      if ((err = mp_div_2(a, a)) != CRYPT_OK)          { goto done; }
+   }
+
+   /* the one-time reduction setup shared by every round */
+   if ((err = mp_montgomery_setup(N, &mont)) != CRYPT_OK)      { goto done; }
+   if ((err = mp_montgomery_normalization(R, N)) != CRYPT_OK)  { goto done; }
+
+   for (r = 0; r < rounds; r++) {
+      /* witness in [2, N-2]: PRNG bytes reduced mod N-3, plus 2 */
+      if (prng_descriptor[wprng].read(buf, len, prng) != len) {
+         err = CRYPT_ERROR_READPRNG;
+         goto done;
+      }
+      if ((err = mp_read_unsigned_bin(y, buf, (int)len)) != CRYPT_OK)  { goto done; }
+      if ((err = mp_mod(y, nm3, y)) != CRYPT_OK)                       { goto done; }
+      if ((err = mp_add_d(y, 2, y)) != CRYPT_OK)                       { goto done; }
+
+      /* y = witness^cofactor mod N through the shared context */
+      if ((err = ltc_mp_exptmod_mont(y, a, N, mont, R, y)) != CRYPT_OK) { goto done; }
+
+      passed = (mp_cmp_d(y, 1) == LTC_MP_EQ) || (mp_cmp(y, nm1) == LTC_MP_EQ);
+      for (x = 1; x < s && !passed; x++) {
+         if ((err = mp_sqrmod(y, N, y)) != CRYPT_OK)                   { goto done; }
+         if (mp_cmp_d(y, 1) == LTC_MP_EQ) {
+            /* nontrivial square root of one */
+            err = CRYPT_OK;
+            goto done;
+         }
+         passed = (mp_cmp(y, nm1) == LTC_MP_EQ);
+      }
+      if (!passed) {
+         err = CRYPT_OK;
+         goto done;
+      }
+   }
+
+   *result = LTC_MP_YES;
+   err     = CRYPT_OK;
+
+done:
+   if (mont != NULL) {
+      mp_montgomery_free(mont);
+   }
+   if (buf != NULL) {
+#ifdef LTC_CLEAN_STACK
+      zeromem(buf, len);
+#endif
+      XFREE(buf);
+   }
+   mp_clear_multi(R, y, a, nm3, nm1, NULL);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -10,6 +10,16 @@
 #include "tomcrypt.h"
 
 #ifdef LTC_MDSA
+
+/* a stack buffer covers every standardized group order; only larger
+ * requests pay for an allocation */
+#define LTC_RAND_BN_STACK 64
+
+/* candidates sliced from one PRNG read when searching a range; under
+ * Fortuna every read takes the state lock and reruns the key schedule,
+ * so rejection loops should not pay that per candidate */
+#define LTC_RAND_BN_BATCH 8
+
 /**
   Generate a random number N with given bitlength (note: MSB can be 0)
 */
@@ -17,7 +27,7 @@
 int rand_bn_bits(void *N, int bits, prng_state *prng, int wprng)
 {
    int res, bytes;
-   unsigned char *buf, mask;
+   unsigned char stack[LTC_RAND_BN_STACK], *buf, mask;
 
    LTC_ARGCHK(N != NULL);
    LTC_ARGCHK(bits > 1);
@@ -28,8 +38,12 @@ int rand_bn_bits(void *N, int bits, prng_state *prng, int wprng)
    bytes = (bits+7) >> 3;
    mask = 0xff << (8 - bits % 8);
 
-   /* allocate buffer */
-   if ((buf = XCALLOC(1, bytes)) == NULL) return CRYPT_MEM;
+   /* small draws run off the stack */
+   if (bytes <= LTC_RAND_BN_STACK) {
+      buf = stack;
+   } else if ((buf = XCALLOC(1, bytes)) == NULL) {
+      return CRYPT_MEM;
+   }
 
    /* generate random bytes */
    if (prng_descriptor[wprng].read(buf, bytes, prng) != (unsigned long)bytes) {
@@ -47,7 +61,9 @@ cleanup:
 #ifdef LTC_CLEAN_STACK
    zeromem(buf, bytes);
 #endif
-   XFREE(buf);
+   if (buf != stack) {
+      XFREE(buf);
+   }
    return res;
 }
 
@@ -56,16 +72,55 @@ cleanup:
 */
 int rand_bn_range(void *N, void *limit, prng_state *prng, int wprng)
 {
-   int res;
+   unsigned char *block, *cur;
+   unsigned long  blocklen;
+   unsigned char  mask;
+   int            res, bits, bytes, left;
 
    LTC_ARGCHK(N != NULL);
    LTC_ARGCHK(limit != NULL);
 
+   if ((res = prng_is_valid(wprng)) != CRYPT_OK) return res;
+
+   bits  = mp_count_bits(limit);
+   if (bits <= 1) {
+      return CRYPT_INVALID_ARG;
+   }
+   bytes = (bits+7) >> 3;
+   mask  = 0xff << (8 - bits % 8);
+
+   /* slice candidates from one bulk draw; a fresh block is only
+    * needed when the rejection loop outruns it */
+   blocklen = (unsigned long)bytes * LTC_RAND_BN_BATCH;
+   if ((block = XCALLOC(1, blocklen)) == NULL) {
+      return CRYPT_MEM;
+   }
+
+   left = 0;
+   cur  = block;
    do {
-     res = rand_bn_bits(N, mp_count_bits(limit), prng, wprng);
-     if (res != CRYPT_OK) return res;
+      if (left == 0) {
+         if (prng_descriptor[wprng].read(block, blocklen, prng) != blocklen) {
+            res = CRYPT_ERROR_READPRNG;
+            goto cleanup;
+         }
+         left = LTC_RAND_BN_BATCH;
+         cur  = block;
+      }
+      cur[0] &= ~mask;
+      res = mp_read_unsigned_bin(N, cur, bytes);
+      if (res != CRYPT_OK) goto cleanup;
+      cur += bytes;
+      --left;
    } while (mp_cmp(N, limit) != LTC_MP_LT);
 
-   return CRYPT_OK;
+   res = CRYPT_OK;
+
+cleanup:
+#ifdef LTC_CLEAN_STACK
+   zeromem(block, blocklen);
+#endif
+   XFREE(block);
+   return res;
 }
 #endif
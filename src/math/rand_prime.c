@@ -19,10 +19,36 @@
 
 #define USE_BBS 1
 
+/* small primes for the sieve pre-filter; one cheap mp_mod_d per prime
+ * per window replaces a Miller-Rabin run on roughly three candidates
+ * out of four */
+static const unsigned short s_small_primes[] = {
+      3,    5,    7,   11,   13,   17,   19,   23,   29,   31,   37,   41,
+     43,   47,   53,   59,   61,   67,   71,   73,   79,   83,   89,   97,
+    101,  103,  107,  109,  113,  127,  131,  137,  139,  149,  151,  157,
+    163,  167,  173,  179,  181,  191,  193,  197,  199,  211,  223,  227,
+    229,  233,  239,  241,  251,  257,  263,  269,  271,  277,  281,  283,
+    293,  307,  311,  313,  317,  331,  337,  347,  349,  353,  359,  367,
+    373,  379,  383,  389,  397,  401,  409,  419,  421,  431,  433,  439,
+    443,  449,  457,  461,  463,  467,  479,  487,  491,  499,  503,  509,
+    521,  523,  541,  547,  557,  563,  569,  571,  577,  587,  593,  599,
+    601,  607,  613,  617,  619,  631,  641,  643,  647,  653,  659,  661,
+    673,  677,  683,  691,  701,  709,  719,  727,  733,  739,  743,  751,
+    757,  761,  769,  773,  787,  797,  809,  811,  821,  823,  827,  829,
+    839,  853,  857,  859,  863,  877,  881,  883,  887,  907,  911,  919,
+    929,  937,  941,  947,  953,  967,  971,  977,  983,  991,  997, 1009
+};
+#define SMALL_PRIMES (int)(sizeof(s_small_primes)/sizeof(s_small_primes[0]))
+
+/* candidates examined per random starting point; n, n+step, ...,
+ * n+step*(SIEVE_WINDOW-1) share one set of small-prime residues */
+#define SIEVE_WINDOW 4096
+
 int rand_prime(void *N, long len, prng_state *prng, int wprng)
 {
-   int            err, res, type;
-   unsigned char *buf;
+   unsigned char *buf, *sieve;
+   unsigned long  r, j, j0, last, step, inv_step;
+   int            err, res, type, x, bits;
 
    LTC_ARGCHK(N != NULL);
 
@@ -44,17 +70,27 @@ int rand_prime(void *N, long len, prng_state *prng, int wprng)
       return err;
    }
 
-   /* allocate buffer to work with */
+   /* allocate buffers to work with */
    buf = XCALLOC(1, len);
    if (buf == NULL) {
        return CRYPT_MEM;
    }
+   sieve = XMALLOC(SIEVE_WINDOW);
+   if (sieve == NULL) {
+       XFREE(buf);
+       return CRYPT_MEM;
+   }
+
+   /* stepping by 2 keeps candidates odd; for BBS primes stepping by 4
+    * keeps them 3 mod 4 */
+   step = (type & USE_BBS) ? 4 : 2;
+   bits = (int)len * 8;
 
-   do {
-      /* generate value */
+   for (;;) {
+      /* generate the window base */
       if (prng_descriptor[wprng].read(buf, len, prng) != (unsigned long)len) {
-         XFREE(buf);
-         return CRYPT_ERROR_READPRNG;
+         err = CRYPT_ERROR_READPRNG;
+         goto done;
       }
 
       /* munge bits */
@@ -63,23 +99,62 @@ int rand_prime(void *N, long len, prng_state *prng, int wprng)
 
       /* load value */
       if ((err = mp_read_unsigned_bin(N, buf, len)) != CRYPT_OK) {
-         XFREE(buf);
-         return err;
+         goto done;
       }
 
-      /* test */
-      if ((err = mp_prime_is_prime(N, 8, &res)) != CRYPT_OK) {
-         XFREE(buf);
-         return err;
+      /* sieve the window: offset j is composite when
+       * base + step*j == 0 mod p, i.e. j == -r * 1/step mod p */
+      XMEMSET(sieve, 0, SIEVE_WINDOW);
+      for (x = 0; x < SMALL_PRIMES; x++) {
+         unsigned long p = s_small_primes[x];
+         if ((err = mp_mod_d(N, p, &r)) != CRYPT_OK) {
+            goto done;
+         }
+         inv_step = (p + 1) >> 1;            /* 1/2 mod p */
+         if (step == 4) {
+            inv_step = (inv_step * inv_step) % p;
+         }
+         j0 = ((p - r) % p) * inv_step % p;
+         for (j = j0; j < SIEVE_WINDOW; j += p) {
+            sieve[j] = 1;
+         }
       }
-   } while (res == LTC_MP_NO);
 
+      /* Miller-Rabin only on the survivors */
+      last = 0;
+      for (j = 0; j < SIEVE_WINDOW; j++) {
+         if (sieve[j]) {
+            continue;
+         }
+         if (j != last) {
+            if ((err = mp_add_d(N, (j - last) * step, N)) != CRYPT_OK) {
+               goto done;
+            }
+            last = j;
+         }
+         /* stepping must not have grown past the requested size */
+         if (mp_count_bits(N) != bits) {
+            break;
+         }
+         /* all 8 rounds share one Montgomery setup for the candidate */
+         if ((err = ltc_mp_prime_rounds(N, 8, prng, wprng, &res)) != CRYPT_OK) {
+            goto done;
+         }
+         if (res == LTC_MP_YES) {
+            err = CRYPT_OK;
+            goto done;
+         }
+      }
+      /* window exhausted, draw a fresh starting point */
+   }
+
+done:
 #ifdef LTC_CLEAN_STACK
    zeromem(buf, len);
 #endif
-
+   XFREE(sieve);
    XFREE(buf);
-   return CRYPT_OK;
+   return err;
 }
 
 #endif /* LTC_NO_MATH */
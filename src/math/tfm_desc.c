@@ -41,11 +41,28 @@ static int tfm_to_ltc_error(int err)
    return CRYPT_ERROR;
 }
 
+/* freed fp_int blocks are cached for reuse; a fresh block costs a heap
+ * allocation plus two full FP_MAX_SIZE clears (XCALLOC and fp_init),
+ * and pk operations churn through dozens of temporaries */
+#define TFM_DESC_CACHE 16
+static fp_int *s_fp_cache[TFM_DESC_CACHE];
+static int     s_fp_cache_len = 0;
+LTC_MUTEX_GLOBAL(ltc_tfm_cache_lock)
+
 static int init(void **a)
 {
    LTC_ARGCHK(a != NULL);
 
-   *a = XCALLOC(1, sizeof(fp_int));
+   LTC_MUTEX_LOCK(&ltc_tfm_cache_lock);
+   if (s_fp_cache_len > 0) {
+      /* cached blocks were scrubbed on the way in */
+      *a = s_fp_cache[--s_fp_cache_len];
+      LTC_MUTEX_UNLOCK(&ltc_tfm_cache_lock);
+      return CRYPT_OK;
+   }
+   LTC_MUTEX_UNLOCK(&ltc_tfm_cache_lock);
+
+   *a = XMALLOC(sizeof(fp_int));
    if (*a == NULL) {
       return CRYPT_MEM;
    }
@@ -56,6 +73,14 @@ static int init(void **a)
 static void deinit(void *a)
 {
    LTC_ARGCHKVD(a != NULL);
+   fp_init(a);
+   LTC_MUTEX_LOCK(&ltc_tfm_cache_lock);
+   if (s_fp_cache_len < TFM_DESC_CACHE) {
+      s_fp_cache[s_fp_cache_len++] = a;
+      LTC_MUTEX_UNLOCK(&ltc_tfm_cache_lock);
+      return;
+   }
+   LTC_MUTEX_UNLOCK(&ltc_tfm_cache_lock);
    XFREE(a);
 }
 
@@ -790,6 +815,8 @@ const ltc_math_descriptor tfm_desc = {
 
    NULL,
 
+   &ltc_mp_multi_exptmod,
+   &ltc_mp_exptmod_ct,
 };
 
 
@@ -20,6 +20,21 @@
 
 static const unsigned long _adler32_base = 65521;
 
+/* largest n such that 255*n*(n+1)/2 + (n+1)*(_adler32_base-1) still
+ * fits in 32 bits - the sums can run that long before a fold */
+#define LTC_ADLER32_NMAX 5552
+
+/* 16 byte inner step of the blocked loop */
+#define LTC_ADLER32_DO16(buf)                        \
+   s1 += (buf)[ 0]; s2 += s1; s1 += (buf)[ 1]; s2 += s1; \
+   s1 += (buf)[ 2]; s2 += s1; s1 += (buf)[ 3]; s2 += s1; \
+   s1 += (buf)[ 4]; s2 += s1; s1 += (buf)[ 5]; s2 += s1; \
+   s1 += (buf)[ 6]; s2 += s1; s1 += (buf)[ 7]; s2 += s1; \
+   s1 += (buf)[ 8]; s2 += s1; s1 += (buf)[ 9]; s2 += s1; \
+   s1 += (buf)[10]; s2 += s1; s1 += (buf)[11]; s2 += s1; \
+   s1 += (buf)[12]; s2 += s1; s1 += (buf)[13]; s2 += s1; \
+   s1 += (buf)[14]; s2 += s1; s1 += (buf)[15]; s2 += s1
+
 void adler32_init(adler32_state *ctx)
 {
    LTC_ARGCHKVD(ctx != NULL);
@@ -36,41 +51,30 @@ void adler32_update(adler32_state *ctx, const unsigned char *input, unsigned lon
    s1 = ctx->s[0];
    s2 = ctx->s[1];
 
-   if (length % 8 != 0) {
+   /* the modulo is deferred: the running sums stay below 2^32 for up
+    * to NMAX bytes, so whole blocks fold s1/s2 exactly once */
+   while (length >= LTC_ADLER32_NMAX) {
+      unsigned long n = LTC_ADLER32_NMAX / 16;
       do {
-         s1 += *input++;
-         s2 += s1;
-         length--;
-      } while (length % 8 != 0);
-
-      if (s1 >= _adler32_base)
-         s1 -= _adler32_base;
+         LTC_ADLER32_DO16(input);
+         input += 16;
+      } while (--n);
+      length -= LTC_ADLER32_NMAX;
+      s1 %= _adler32_base;
       s2 %= _adler32_base;
    }
 
-   while (length > 0) {
-      s1 += input[0];
-      s2 += s1;
-      s1 += input[1];
-      s2 += s1;
-      s1 += input[2];
-      s2 += s1;
-      s1 += input[3];
-      s2 += s1;
-      s1 += input[4];
-      s2 += s1;
-      s1 += input[5];
-      s2 += s1;
-      s1 += input[6];
-      s2 += s1;
-      s1 += input[7];
-      s2 += s1;
-
-      length -= 8;
-      input += 8;
-
-      if (s1 >= _adler32_base)
-         s1 -= _adler32_base;
+   if (length > 0) {
+      while (length >= 16) {
+         LTC_ADLER32_DO16(input);
+         input  += 16;
+         length -= 16;
+      }
+      while (length-- > 0) {
+         s1 += *input++;
+         s2 += s1;
+      }
+      s1 %= _adler32_base;
       s2 %= _adler32_base;
    }
 
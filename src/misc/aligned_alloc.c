@@ -0,0 +1,116 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file aligned_alloc.c
+  Aligned allocation for precomputed tables, Tom St Denis
+
+  XMALLOC makes no alignment promise beyond malloc's, so multi-KB
+  lookup tables (GCM/LRW PC tables, fixed-base point tables) start at
+  arbitrary offsets and straddle cache lines.  ltc_malloc_aligned()
+  over-allocates through XMALLOC and rounds the payload up to the
+  requested power-of-two alignment, remembering the raw pointer just
+  below the payload for ltc_free_aligned().  The pair is reached
+  through the XMALLOC_ALIGNED/XFREE_ALIGNED hooks in tomcrypt_custom.h
+  so embedders with posix_memalign or a locked arena can substitute
+  their own.
+
+  With LTC_ALIGNED_HUGEPAGES (Linux only), allocations of 2 MB and up
+  are instead backed by a private anonymous mapping flagged
+  MADV_HUGEPAGE, collapsing the table onto one TLB entry where
+  transparent huge pages are available.
+*/
+
+#if defined(LTC_ALIGNED_HUGEPAGES)
+#include <sys/mman.h>
+#endif
+
+/* bookkeeping kept immediately below the aligned payload */
+struct s_al_hdr {
+   void   *base;     /* what XMALLOC (or mmap) returned */
+   size_t  maplen;   /* nonzero: mmap'ed, length to munmap */
+};
+
+/**
+   Allocate size octets aligned to a power of two
+   @param size   Number of octets to allocate
+   @param align  Alignment in octets (power of two, at least sizeof(void *))
+   @return The aligned pointer, NULL on error
+*/
+void *ltc_malloc_aligned(size_t size, size_t align)
+{
+   struct s_al_hdr *hdr;
+   unsigned char   *raw, *ptr;
+   size_t           over;
+
+   if (size == 0 || align == 0 || (align & (align - 1)) != 0) {
+      return NULL;
+   }
+   if (align < sizeof(void *)) {
+      align = sizeof(void *);
+   }
+   over = size + align + sizeof(*hdr);
+   if (over < size) { /* overflow */
+      return NULL;
+   }
+
+#if defined(LTC_ALIGNED_HUGEPAGES)
+   if (size >= (size_t)2*1024*1024) {
+      raw = mmap(NULL, over, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (raw != MAP_FAILED) {
+         madvise(raw, over, MADV_HUGEPAGE);
+         ptr = (unsigned char *)(((size_t)(raw + sizeof(*hdr)) + align - 1) & ~(align - 1));
+         hdr = (struct s_al_hdr *)(void *)(ptr - sizeof(*hdr));
+         hdr->base   = raw;
+         hdr->maplen = over;
+         return ptr;
+      }
+      /* fall through to the heap on mmap failure */
+   }
+#endif
+
+   raw = XMALLOC(over);
+   if (raw == NULL) {
+      return NULL;
+   }
+   ptr = (unsigned char *)(((size_t)(raw + sizeof(*hdr)) + align - 1) & ~(align - 1));
+   hdr = (struct s_al_hdr *)(void *)(ptr - sizeof(*hdr));
+   hdr->base   = raw;
+   hdr->maplen = 0;
+   return ptr;
+}
+
+/**
+   Release an ltc_malloc_aligned() allocation (NULL is a no-op)
+   @param ptr   The aligned pointer
+*/
+void ltc_free_aligned(void *ptr)
+{
+   struct s_al_hdr *hdr;
+
+   if (ptr == NULL) {
+      return;
+   }
+   hdr = (struct s_al_hdr *)(void *)((unsigned char *)ptr - sizeof(*hdr));
+#if defined(LTC_ALIGNED_HUGEPAGES)
+   if (hdr->maplen != 0) {
+      munmap(hdr->base, hdr->maplen);
+      return;
+   }
+#endif
+   XFREE(hdr->base);
+}
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -91,6 +91,29 @@ static int _base64_decode_internal(const unsigned char *in,  unsigned long inlen
 
    g = 0; /* '=' counter */
    for (x = y = z = t = 0; x < inlen; x++) {
+       /* bulk path: grab four characters at a time and validate the
+        * whole group with one test; anything unusual (whitespace,
+        * padding, junk, a full output buffer) drops back to the
+        * character-at-a-time loop below */
+       while (y == 0 && g == 0 && inlen - x >= 4 && z + 3 <= *outlen) {
+          unsigned char c0, c1, c2, c3;
+          c0 = map[in[x]&0xFF];
+          c1 = map[in[x+1]&0xFF];
+          c2 = map[in[x+2]&0xFF];
+          c3 = map[in[x+3]&0xFF];
+          if (((c0 | c1 | c2 | c3) & 0xC0) != 0) {
+             break;
+          }
+          t = ((ulong32)c0 << 18) | ((ulong32)c1 << 12) | ((ulong32)c2 << 6) | c3;
+          out[z++] = (unsigned char)((t>>16)&255);
+          out[z++] = (unsigned char)((t>>8)&255);
+          out[z++] = (unsigned char)(t&255);
+          t  = 0;
+          x += 4;
+       }
+       if (x >= inlen) {
+          break;
+       }
        c = map[in[x]&0xFF];
        if (c == 254) {
           g++;
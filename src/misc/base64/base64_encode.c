@@ -48,7 +48,27 @@ static int _base64_encode_internal(const unsigned char *in,  unsigned long inlen
    }
    p = out;
    leven = 3*(inlen / 3);
-   for (i = 0; i < leven; i += 3) {
+   /* unrolled bulk path, four groups per iteration */
+   for (i = 0; leven - i >= 12; i += 12) {
+       *p++ = codes[(in[0] >> 2) & 0x3F];
+       *p++ = codes[(((in[0] & 3) << 4) + (in[1] >> 4)) & 0x3F];
+       *p++ = codes[(((in[1] & 0xf) << 2) + (in[2] >> 6)) & 0x3F];
+       *p++ = codes[in[2] & 0x3F];
+       *p++ = codes[(in[3] >> 2) & 0x3F];
+       *p++ = codes[(((in[3] & 3) << 4) + (in[4] >> 4)) & 0x3F];
+       *p++ = codes[(((in[4] & 0xf) << 2) + (in[5] >> 6)) & 0x3F];
+       *p++ = codes[in[5] & 0x3F];
+       *p++ = codes[(in[6] >> 2) & 0x3F];
+       *p++ = codes[(((in[6] & 3) << 4) + (in[7] >> 4)) & 0x3F];
+       *p++ = codes[(((in[7] & 0xf) << 2) + (in[8] >> 6)) & 0x3F];
+       *p++ = codes[in[8] & 0x3F];
+       *p++ = codes[(in[9] >> 2) & 0x3F];
+       *p++ = codes[(((in[9] & 3) << 4) + (in[10] >> 4)) & 0x3F];
+       *p++ = codes[(((in[10] & 0xf) << 2) + (in[11] >> 6)) & 0x3F];
+       *p++ = codes[in[11] & 0x3F];
+       in += 12;
+   }
+   for (; i < leven; i += 3) {
        *p++ = codes[(in[0] >> 2) & 0x3F];
        *p++ = codes[(((in[0] & 3) << 4) + (in[1] >> 4)) & 0x3F];
        *p++ = codes[(((in[1] & 0xf) << 2) + (in[2] >> 6)) & 0x3F];
@@ -0,0 +1,396 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file base64_stream.c
+  Incremental base64 codec, Tom St Denis
+
+  base64_encode()/base64_decode() are one-shot and want the whole
+  payload in memory, so transcoding a large PEM body means buffering
+  it twice.  The states here accept input in chunks of any size: the
+  encoder carries up to two raw octets between calls and the decoder
+  carries a partial 4-character group in its accumulator, so a fixed
+  pair of buffers can stream megabytes.  Full chunks still go through
+  the same unrolled group-at-a-time kernels as the one-shot calls -
+  the carry logic only runs at chunk boundaries.
+*/
+
+#if defined(LTC_BASE64) || defined(LTC_BASE64_URL)
+
+#if defined(LTC_BASE64)
+static const char * const s_codes_base64 =
+"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+#endif /* LTC_BASE64 */
+
+#if defined(LTC_BASE64_URL)
+static const char * const s_codes_base64url =
+"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+#endif /* LTC_BASE64_URL */
+
+static int s_encode_init(base64_encode_state *st, const char *codes, int pad)
+{
+   LTC_ARGCHK(st != NULL);
+   st->codes    = codes;
+   st->pad      = pad;
+   st->carrylen = 0;
+   return CRYPT_OK;
+}
+
+static int s_decode_init(base64_decode_state *st, const char *codes, int is_strict, int is_url)
+{
+   int i;
+
+   LTC_ARGCHK(st != NULL);
+   for (i = 0; i < 256; i++) {
+      st->map[i] = 255;
+   }
+   for (i = 0; i < 64; i++) {
+      st->map[(unsigned char)codes[i]] = (unsigned char)i;
+   }
+   st->map['='] = 254;
+   st->is_strict = is_strict;
+   st->is_url    = is_url;
+   st->g         = 0;
+   st->y         = 0;
+   st->t         = 0;
+   return CRYPT_OK;
+}
+
+/**
+   Feed a chunk of raw data into an incremental base64 encoder
+   @param st      The encoder state
+   @param in      The raw data
+   @param inlen   The length of the raw data (octets)
+   @param out     [out] The destination of the base64 characters
+   @param outlen  [in/out] The max size and resulting size; 4*((carry+inlen)/3) suffices
+   @return CRYPT_OK if successful
+*/
+int base64_encode_process(base64_encode_state *st,
+                          const unsigned char *in,  unsigned long inlen,
+                                unsigned char *out, unsigned long *outlen)
+{
+   const char    *codes;
+   unsigned long  i, leven, len2;
+   unsigned char *p;
+
+   LTC_ARGCHK(st     != NULL);
+   LTC_ARGCHK(in     != NULL);
+   LTC_ARGCHK(out    != NULL);
+   LTC_ARGCHK(outlen != NULL);
+
+   len2 = 4 * ((st->carrylen + inlen) / 3);
+   if (*outlen < len2) {
+      *outlen = len2;
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+   codes = st->codes;
+   p     = out;
+
+   /* top the carry up to a whole group first */
+   while (st->carrylen > 0 && st->carrylen < 3 && inlen > 0) {
+      st->carry[st->carrylen++] = *in++;
+      inlen--;
+   }
+   if (st->carrylen == 3) {
+      *p++ = codes[(st->carry[0] >> 2) & 0x3F];
+      *p++ = codes[(((st->carry[0] & 3) << 4) + (st->carry[1] >> 4)) & 0x3F];
+      *p++ = codes[(((st->carry[1] & 0xf) << 2) + (st->carry[2] >> 6)) & 0x3F];
+      *p++ = codes[st->carry[2] & 0x3F];
+      st->carrylen = 0;
+   }
+
+   leven = 3*(inlen / 3);
+   /* unrolled bulk path, four groups per iteration */
+   for (i = 0; leven - i >= 12; i += 12) {
+       *p++ = codes[(in[0] >> 2) & 0x3F];
+       *p++ = codes[(((in[0] & 3) << 4) + (in[1] >> 4)) & 0x3F];
+       *p++ = codes[(((in[1] & 0xf) << 2) + (in[2] >> 6)) & 0x3F];
+       *p++ = codes[in[2] & 0x3F];
+       *p++ = codes[(in[3] >> 2) & 0x3F];
+       *p++ = codes[(((in[3] & 3) << 4) + (in[4] >> 4)) & 0x3F];
+       *p++ = codes[(((in[4] & 0xf) << 2) + (in[5] >> 6)) & 0x3F];
+       *p++ = codes[in[5] & 0x3F];
+       *p++ = codes[(in[6] >> 2) & 0x3F];
+       *p++ = codes[(((in[6] & 3) << 4) + (in[7] >> 4)) & 0x3F];
+       *p++ = codes[(((in[7] & 0xf) << 2) + (in[8] >> 6)) & 0x3F];
+       *p++ = codes[in[8] & 0x3F];
+       *p++ = codes[(in[9] >> 2) & 0x3F];
+       *p++ = codes[(((in[9] & 3) << 4) + (in[10] >> 4)) & 0x3F];
+       *p++ = codes[(((in[10] & 0xf) << 2) + (in[11] >> 6)) & 0x3F];
+       *p++ = codes[in[11] & 0x3F];
+       in += 12;
+   }
+   for (; i < leven; i += 3) {
+       *p++ = codes[(in[0] >> 2) & 0x3F];
+       *p++ = codes[(((in[0] & 3) << 4) + (in[1] >> 4)) & 0x3F];
+       *p++ = codes[(((in[1] & 0xf) << 2) + (in[2] >> 6)) & 0x3F];
+       *p++ = codes[in[2] & 0x3F];
+       in += 3;
+   }
+
+   /* stash the ragged tail for the next call */
+   for (; i < inlen; i++) {
+      st->carry[st->carrylen++] = *in++;
+   }
+
+   *outlen = (unsigned long)(p - out);
+   return CRYPT_OK;
+}
+
+/**
+   Flush an incremental base64 encoder (NUL terminated)
+   @param st      The encoder state; reset for a new stream on success
+   @param out     [out] The destination of the final characters
+   @param outlen  [in/out] The max size and resulting size; 5 octets always suffice
+   @return CRYPT_OK if successful
+*/
+int base64_encode_done(base64_encode_state *st,
+                             unsigned char *out, unsigned long *outlen)
+{
+   const char    *codes;
+   unsigned long  need;
+   unsigned char *p;
+
+   LTC_ARGCHK(st     != NULL);
+   LTC_ARGCHK(out    != NULL);
+   LTC_ARGCHK(outlen != NULL);
+
+   need = (st->carrylen > 0 ? (st->pad ? 4 : st->carrylen + 1) : 0) + 1;
+   if (*outlen < need) {
+      *outlen = need;
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+   codes = st->codes;
+   p     = out;
+
+   if (st->carrylen > 0) {
+       unsigned a = st->carry[0];
+       unsigned b = (st->carrylen > 1) ? st->carry[1] : 0;
+
+       *p++ = codes[(a >> 2) & 0x3F];
+       *p++ = codes[(((a & 3) << 4) + (b >> 4)) & 0x3F];
+       if (st->pad) {
+         *p++ = (st->carrylen > 1) ? codes[(((b & 0xf) << 2)) & 0x3F] : '=';
+         *p++ = '=';
+       }
+       else {
+         if (st->carrylen > 1) *p++ = codes[(((b & 0xf) << 2)) & 0x3F];
+       }
+   }
+
+   /* append a NULL byte */
+   *p = '\0';
+
+   st->carrylen = 0;
+   *outlen = (unsigned long)(p - out);
+   return CRYPT_OK;
+}
+
+/**
+   Feed a chunk of base64 characters into an incremental decoder
+   @param st      The decoder state
+   @param in      The base64 data
+   @param inlen   The length of the base64 data (octets)
+   @param out     [out] The destination of the binary decoded data
+   @param outlen  [in/out] The max size and resulting size; 3*((carry+inlen)/4) suffices
+   @return CRYPT_OK if successful
+*/
+int base64_decode_process(base64_decode_state *st,
+                          const unsigned char *in,  unsigned long inlen,
+                                unsigned char *out, unsigned long *outlen)
+{
+   unsigned long x, z, len2;
+   unsigned char c;
+
+   LTC_ARGCHK(st     != NULL);
+   LTC_ARGCHK(in     != NULL);
+   LTC_ARGCHK(out    != NULL);
+   LTC_ARGCHK(outlen != NULL);
+
+   /* every emitted triple consumes four gathered characters, so this
+    * bound is exact and the loops below can never overflow */
+   len2 = 3 * ((st->y + inlen) / 4);
+   if (*outlen < len2) {
+      *outlen = len2;
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+
+   z = 0;
+   for (x = 0; x < inlen; x++) {
+       /* bulk path: grab four characters at a time and validate the
+        * whole group with one test; anything unusual (whitespace,
+        * padding, junk) drops back to the character-at-a-time loop */
+       while (st->y == 0 && st->g == 0 && inlen - x >= 4) {
+          unsigned char c0, c1, c2, c3;
+          c0 = st->map[in[x]&0xFF];
+          c1 = st->map[in[x+1]&0xFF];
+          c2 = st->map[in[x+2]&0xFF];
+          c3 = st->map[in[x+3]&0xFF];
+          if (((c0 | c1 | c2 | c3) & 0xC0) != 0) {
+             break;
+          }
+          st->t = ((ulong32)c0 << 18) | ((ulong32)c1 << 12) | ((ulong32)c2 << 6) | c3;
+          out[z++] = (unsigned char)((st->t>>16)&255);
+          out[z++] = (unsigned char)((st->t>>8)&255);
+          out[z++] = (unsigned char)(st->t&255);
+          st->t = 0;
+          x += 4;
+       }
+       if (x >= inlen) {
+          break;
+       }
+       c = st->map[in[x]&0xFF];
+       if (c == 254) {
+          st->g++;
+          continue;
+       }
+       else if (st->is_strict && st->g > 0) {
+          /* we only allow '=' to be at the end */
+          return CRYPT_INVALID_PACKET;
+       }
+       if (c == 255) {
+          if (st->is_strict)
+             return CRYPT_INVALID_PACKET;
+          else
+             continue;
+       }
+
+       st->t = (st->t<<6)|c;
+
+       if (++st->y == 4) {
+          out[z++] = (unsigned char)((st->t>>16)&255);
+          out[z++] = (unsigned char)((st->t>>8)&255);
+          out[z++] = (unsigned char)(st->t&255);
+          st->y = 0;
+          st->t = 0;
+       }
+   }
+
+   *outlen = z;
+   return CRYPT_OK;
+}
+
+/**
+   Flush an incremental base64 decoder
+   @param st      The decoder state; reset for a new stream on success
+   @param out     [out] The destination of the final octets
+   @param outlen  [in/out] The max size and resulting size; 2 octets always suffice
+   @return CRYPT_OK if successful
+*/
+int base64_decode_done(base64_decode_state *st,
+                             unsigned char *out, unsigned long *outlen)
+{
+   unsigned long z;
+
+   LTC_ARGCHK(st     != NULL);
+   LTC_ARGCHK(out    != NULL);
+   LTC_ARGCHK(outlen != NULL);
+
+   z = 0;
+   if (st->y != 0) {
+      if (st->y == 1) return CRYPT_INVALID_PACKET;
+      if ((st->y + st->g) != 4 && st->is_strict && !st->is_url) return CRYPT_INVALID_PACKET;
+      st->t = st->t << (6 * (4 - st->y));
+      if (*outlen < st->y - 1) {
+         *outlen = st->y - 1;
+         return CRYPT_BUFFER_OVERFLOW;
+      }
+      if (st->y >= 2) out[z++] = (unsigned char) ((st->t >> 16) & 255);
+      if (st->y == 3) out[z++] = (unsigned char) ((st->t >> 8) & 255);
+   }
+
+   st->g = 0;
+   st->y = 0;
+   st->t = 0;
+   *outlen = z;
+   return CRYPT_OK;
+}
+
+#if defined(LTC_BASE64)
+/**
+   Initialize an incremental base64 encoder (padded alphabet)
+   @param st   The state to initialize
+   @return CRYPT_OK if successful
+*/
+int base64_encode_init(base64_encode_state *st)
+{
+   return s_encode_init(st, s_codes_base64, 1);
+}
+
+/**
+   Initialize an incremental relaxed base64 decoder
+   @param st   The state to initialize
+   @return CRYPT_OK if successful
+*/
+int base64_decode_init(base64_decode_state *st)
+{
+   return s_decode_init(st, s_codes_base64, 0, 0);
+}
+
+/**
+   Initialize an incremental strict base64 decoder
+   @param st   The state to initialize
+   @return CRYPT_OK if successful
+*/
+int base64_strict_decode_init(base64_decode_state *st)
+{
+   return s_decode_init(st, s_codes_base64, 1, 0);
+}
+#endif /* LTC_BASE64 */
+
+#if defined(LTC_BASE64_URL)
+/**
+   Initialize an incremental base64 (URL Safe, RFC 4648 section 5) encoder
+   @param st   The state to initialize
+   @return CRYPT_OK if successful
+*/
+int base64url_encode_init(base64_encode_state *st)
+{
+   return s_encode_init(st, s_codes_base64url, 0);
+}
+
+/**
+   Initialize an incremental padded base64 (URL Safe) encoder
+   @param st   The state to initialize
+   @return CRYPT_OK if successful
+*/
+int base64url_strict_encode_init(base64_encode_state *st)
+{
+   return s_encode_init(st, s_codes_base64url, 1);
+}
+
+/**
+   Initialize an incremental relaxed base64 (URL Safe) decoder
+   @param st   The state to initialize
+   @return CRYPT_OK if successful
+*/
+int base64url_decode_init(base64_decode_state *st)
+{
+   return s_decode_init(st, s_codes_base64url, 0, 1);
+}
+
+/**
+   Initialize an incremental strict base64 (URL Safe) decoder
+   @param st   The state to initialize
+   @return CRYPT_OK if successful
+*/
+int base64url_strict_decode_init(base64_decode_state *st)
+{
+   return s_decode_init(st, s_codes_base64url, 1, 1);
+}
+#endif /* LTC_BASE64_URL */
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -15,6 +15,16 @@
    Burn stack, Tom St Denis
 */
 
+/* burn policy: immediate (historic behavior, every call smashes the
+ * stack) or deferred, where calls only record the largest requested
+ * length and burn_stack_flush() does one burn for a whole batch.  A
+ * bulk mode loop calling a cipher per 16-byte block otherwise pays for
+ * a full stack wipe per block.  The policy is global like the rest of
+ * the LTC_CLEAN_STACK machinery; with multiple threads the application
+ * should keep it immediate or fence batches itself. */
+static int           burn_deferred = 0;
+static unsigned long burn_pending  = 0;
+
 /**
    Burn some stack memory
    @param len amount of stack to burn in bytes
@@ -22,11 +32,60 @@
 void burn_stack(unsigned long len)
 {
    unsigned char buf[32];
+
+   if (burn_deferred) {
+      if (len > burn_pending) {
+         burn_pending = len;
+      }
+      return;
+   }
    zeromem(buf, sizeof(buf));
    if (len > (unsigned long)sizeof(buf))
       burn_stack(len - sizeof(buf));
 }
 
+/**
+   Set the stack burning policy
+   @param deferred   nonzero to defer burns until burn_stack_flush()
+   @return the previous policy
+*/
+int burn_stack_policy(int deferred)
+{
+   int old = burn_deferred;
+   burn_deferred = deferred ? 1 : 0;
+   if (!burn_deferred) {
+      /* back to immediate: settle anything a batch left behind so no
+       * recorded burn outlives the deferred window */
+      burn_stack_flush();
+   }
+   return old;
+}
+
+/**
+   Perform the largest deferred burn, if any
+
+   Called once per buffer by the bulk processing paths; a no-op when
+   nothing was deferred, so it costs nothing under the default policy.
+*/
+void burn_stack_flush(void)
+{
+   unsigned long len;
+   int           old;
+
+   if (burn_pending == 0) {
+      return;
+   }
+   len           = burn_pending;
+   burn_pending  = 0;
+   /* drop to immediate just for the internal burn, then restore the
+    * policy that was in force: the application may have switched back
+    * to immediate while this flush was still pending */
+   old           = burn_deferred;
+   burn_deferred = 0;
+   burn_stack(len);
+   burn_deferred = old;
+}
+
 
 
 /* $Source$ */
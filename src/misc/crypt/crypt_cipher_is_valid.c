@@ -22,6 +22,13 @@
 */
 int cipher_is_valid(int idx)
 {
+   /* sealed registries are immutable, the check is a plain load */
+   if (ltc_registry_sealed) {
+      if (idx < 0 || idx >= TAB_SIZE || cipher_descriptor[idx].name == NULL) {
+         return CRYPT_INVALID_CIPHER;
+      }
+      return CRYPT_OK;
+   }
    LTC_MUTEX_LOCK(&ltc_cipher_mutex);
    if (idx < 0 || idx >= TAB_SIZE || cipher_descriptor[idx].name == NULL) {
       LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
@@ -0,0 +1,78 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file crypt_cpu_features.c
+  Runtime CPU capability detection, Tom St Denis
+
+  One probe for every accelerated backend.  The first call performs the
+  CPUID dance (x86) or the HWCAP lookup (AArch64) and caches the result,
+  so backends can consult it on every operation for free.  The flag
+  names are architecture neutral -- LTC_CPU_AES means "this CPU has an
+  AES instruction", whether that is AES-NI or the ARMv8 extension --
+  because the backends themselves are compiled per architecture and the
+  ambiguity cannot arise.
+
+  The dispatch convention accelerated backends follow:
+
+    - the backend lives in its own file behind an LTC_<ALG>_<ISA> build
+      flag and exports <alg>_<isa>_enabled(), implemented as
+      (ltc_cpu_features() & <bits>) != 0;
+    - the portable entry point (descriptor setup or compress function)
+      tests <alg>_<isa>_enabled() and branches to the accelerated code,
+      so a binary built with the backend still runs -- through the
+      portable path -- on CPUs without the instructions;
+    - nothing is patched or registered: the test is a cached load and a
+      branch, cheap enough to make per call.
+
+  aes.c/aes_ni.c and sha256.c/sha256_ni.c are the reference examples.
+*/
+
+#if defined(__aarch64__)
+#include <sys/auxv.h>
+/* the kernel's bit assignments; spelled out for old libc headers */
+#define LTC_HWCAP_AES   (1UL << 3)
+#define LTC_HWCAP_PMULL (1UL << 4)
+#define LTC_HWCAP_SHA2  (1UL << 6)
+#endif
+
+unsigned long ltc_cpu_features(void)
+{
+   static int detected = 0;
+   static unsigned long feats = 0;
+
+   if (!detected) {
+      unsigned long f = 0;
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+      if (__builtin_cpu_supports("aes"))    f |= LTC_CPU_AES;
+      if (__builtin_cpu_supports("pclmul")) f |= LTC_CPU_CLMUL;
+      if (__builtin_cpu_supports("sha"))    f |= LTC_CPU_SHA;
+      if (__builtin_cpu_supports("ssse3"))  f |= LTC_CPU_SSSE3;
+      if (__builtin_cpu_supports("sse4.1")) f |= LTC_CPU_SSE41;
+      if (__builtin_cpu_supports("avx2"))   f |= LTC_CPU_AVX2;
+#elif defined(__aarch64__)
+      {
+         unsigned long hw = getauxval(AT_HWCAP);
+         if (hw & LTC_HWCAP_AES)   f |= LTC_CPU_AES;
+         if (hw & LTC_HWCAP_PMULL) f |= LTC_CPU_CLMUL;
+         if (hw & LTC_HWCAP_SHA2)  f |= LTC_CPU_SHA;
+      }
+#endif
+      feats    = f;
+      detected = 1;
+   }
+   return feats;
+}
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
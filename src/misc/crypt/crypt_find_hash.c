@@ -15,6 +15,57 @@
   Find a hash, Tom St Denis
 */
 
+/* open addressed name -> descriptor index map; rebuilt lazily after a
+ * (un)registration so name resolution costs one probe instead of a
+ * strcmp scan over the whole descriptor table */
+#define LTC_HASH_NAME_MAP (2 * TAB_SIZE)
+
+static struct {
+   ulong32 key;
+   int     idx;     /* -1 == empty slot */
+} name_map[LTC_HASH_NAME_MAP];
+static int name_map_valid = 0;
+
+/* FNV-1a over the name */
+static ulong32 name_key(const char *name)
+{
+   ulong32 h = 0x811c9dc5UL;
+
+   while (*name != '\0') {
+      h = (h ^ (ulong32)(unsigned char)*name++) * 0x01000193UL;
+   }
+   return h;
+}
+
+/* must be called with ltc_hash_mutex held */
+static void name_map_rebuild(void)
+{
+   unsigned long i;
+   int           x;
+
+   for (x = 0; x < LTC_HASH_NAME_MAP; x++) {
+      name_map[x].idx = -1;
+   }
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (hash_descriptor[x].name != NULL) {
+         ulong32 key = name_key(hash_descriptor[x].name);
+         i = key % LTC_HASH_NAME_MAP;
+         while (name_map[i].idx != -1) {
+            i = (i + 1) % LTC_HASH_NAME_MAP;
+         }
+         name_map[i].key = key;
+         name_map[i].idx = x;
+      }
+   }
+   name_map_valid = 1;
+}
+
+/* called by register_hash/unregister_hash while they hold ltc_hash_mutex */
+void hash_name_index_invalidate(void)
+{
+   name_map_valid = 0;
+}
+
 /**
    Find a registered hash by name
    @param name   The name of the hash to look for
@@ -22,17 +73,38 @@
 */
 int find_hash(const char *name)
 {
-   int x;
+   ulong32       key;
+   unsigned long i;
+   int           x, ret, locked;
+
    LTC_ARGCHK(name != NULL);
-   LTC_MUTEX_LOCK(&ltc_hash_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-       if (hash_descriptor[x].name != NULL && XSTRCMP(hash_descriptor[x].name, name) == 0) {
-          LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
-          return x;
-       }
+
+   /* sealed registries are immutable, the probe needs no lock */
+   locked = 0;
+   if (!ltc_registry_sealed || !name_map_valid) {
+      LTC_MUTEX_LOCK(&ltc_hash_mutex);
+      locked = 1;
+      if (!name_map_valid) {
+         name_map_rebuild();
+      }
+   }
+   ret = -1;
+   key = name_key(name);
+   i   = key % LTC_HASH_NAME_MAP;
+   while (name_map[i].idx != -1) {
+      x = name_map[i].idx;
+      if (name_map[i].key == key &&
+          hash_descriptor[x].name != NULL &&
+          XSTRCMP(hash_descriptor[x].name, name) == 0) {
+         ret = x;
+         break;
+      }
+      i = (i + 1) % LTC_HASH_NAME_MAP;
+   }
+   if (locked) {
+      LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
    }
-   LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
-   return -1;
+   return ret;
 }
 
 /* $Source$ */
@@ -15,16 +15,80 @@
   Find a hash, Tom St Denis
 */
 
+/* open addressed OID -> descriptor index map; rebuilt lazily after a
+ * (un)registration so certificate processing resolves OIDs with one
+ * probe instead of scanning the whole descriptor table */
+#define LTC_HASH_OID_MAP (2 * TAB_SIZE)
+
+static struct {
+   ulong32 key;
+   int     idx;     /* -1 == empty slot */
+} oid_map[LTC_HASH_OID_MAP];
+static int oid_map_valid = 0;
+
+/* FNV-1a over the OID words and the word count */
+static ulong32 oid_key(const unsigned long *ID, unsigned long IDlen)
+{
+   ulong32       h = 0x811c9dc5UL;
+   unsigned long i;
+
+   for (i = 0; i < IDlen; i++) {
+      h = (h ^ (ulong32)ID[i]) * 0x01000193UL;
+   }
+   return (h ^ (ulong32)IDlen) * 0x01000193UL;
+}
+
+/* must be called with ltc_hash_mutex held */
+static void oid_map_rebuild(void)
+{
+   unsigned long i;
+   int           x;
+
+   for (x = 0; x < LTC_HASH_OID_MAP; x++) {
+      oid_map[x].idx = -1;
+   }
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (hash_descriptor[x].name != NULL && hash_descriptor[x].OIDlen > 0) {
+         ulong32 key = oid_key(hash_descriptor[x].OID, hash_descriptor[x].OIDlen);
+         i = key % LTC_HASH_OID_MAP;
+         while (oid_map[i].idx != -1) {
+            i = (i + 1) % LTC_HASH_OID_MAP;
+         }
+         oid_map[i].key = key;
+         oid_map[i].idx = x;
+      }
+   }
+   oid_map_valid = 1;
+}
+
+/* called by register_hash/unregister_hash while they hold ltc_hash_mutex */
+void hash_oid_index_invalidate(void)
+{
+   oid_map_valid = 0;
+}
+
 int find_hash_oid(const unsigned long *ID, unsigned long IDlen)
 {
-   int x;
+   ulong32       key;
+   unsigned long i;
+   int           x;
+
    LTC_ARGCHK(ID != NULL);
    LTC_MUTEX_LOCK(&ltc_hash_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-       if (hash_descriptor[x].name != NULL && hash_descriptor[x].OIDlen == IDlen && !XMEMCMP(hash_descriptor[x].OID, ID, sizeof(unsigned long) * IDlen)) {
-          LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
-          return x;
-       }
+   if (!oid_map_valid) {
+      oid_map_rebuild();
+   }
+   key = oid_key(ID, IDlen);
+   i   = key % LTC_HASH_OID_MAP;
+   while (oid_map[i].idx != -1) {
+      x = oid_map[i].idx;
+      if (oid_map[i].key == key &&
+          hash_descriptor[x].OIDlen == IDlen &&
+          !XMEMCMP(hash_descriptor[x].OID, ID, sizeof(unsigned long) * IDlen)) {
+         LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
+         return x;
+      }
+      i = (i + 1) % LTC_HASH_OID_MAP;
    }
    LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
    return -1;
@@ -38,6 +38,83 @@ void init_GMP(void) {
 #endif
 */
 
+#if defined(LTM_DESC) && defined(TFM_DESC)
+
+#include <time.h>
+
+/* exptmods timed per candidate; a handful is enough to separate the
+ * backends and keeps init cheap even at 4096 bits */
+#define LTC_MP_TUNE_ROUNDS 4
+
+/* time LTC_MP_TUNE_ROUNDS exponentiations at the given size under the
+ * current ltc_mp; (clock_t)-1 when the backend cannot do them (e.g.
+ * the size is beyond TFM's FP_MAX_SIZE) */
+static clock_t s_time_exptmod(int bits)
+{
+   void    *a, *b, *c, *d;
+   clock_t  t;
+   int      i, err;
+
+   if (mp_init_multi(&a, &b, &c, &d, NULL) != CRYPT_OK) {
+      return (clock_t)-1;
+   }
+
+   /* fixed operands: c = 2^bits - 1 (odd), a and b full size */
+   err = CRYPT_OK;
+   if (mp_2expt(c, bits)          != CRYPT_OK ||
+       mp_sub_d(c, 1, c)          != CRYPT_OK ||
+       mp_2expt(a, bits - 1)      != CRYPT_OK ||
+       mp_add_d(a, 0x1234, a)     != CRYPT_OK ||
+       mp_2expt(b, bits - 1)      != CRYPT_OK ||
+       mp_add_d(b, 0x4321, b)     != CRYPT_OK) {
+      err = CRYPT_ERROR;
+   }
+
+   t = XCLOCK();
+   for (i = 0; err == CRYPT_OK && i < LTC_MP_TUNE_ROUNDS; i++) {
+      err = mp_exptmod(a, b, c, d);
+   }
+   t = (err == CRYPT_OK) ? XCLOCK() - t : (clock_t)-1;
+
+   mp_clear_multi(a, b, c, d, NULL);
+   return t;
+}
+
+/**
+   Pick the fastest compiled math backend for one operand size
+
+   TFM tends to win below its FP_MAX_SIZE compile limit and LTM above,
+   so a binary linking both should not hardcode either.  This times a
+   few exponentiations at the size the deployment actually uses and
+   registers the winner in ltc_mp.  Per-operation routing between the
+   backends is not possible -- every bignum carries its creator's
+   representation, so the choice is made once here instead.
+
+   @param bits  The modulus size to tune for (e.g. 2048)
+   @return CRYPT_OK on success
+*/
+int init_AUTO(int bits)
+{
+   clock_t t_ltm, t_tfm;
+
+   if (bits < 16) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   ltc_mp = ltm_desc;
+   t_ltm  = s_time_exptmod(bits);
+   ltc_mp = tfm_desc;
+   t_tfm  = s_time_exptmod(bits);
+
+   if (t_tfm == (clock_t)-1 || (t_ltm != (clock_t)-1 && t_ltm < t_tfm)) {
+      ltc_mp = ltm_desc;
+   }
+   /* otherwise tfm_desc stays registered */
+   return CRYPT_OK;
+}
+
+#endif
+
 
 /* $Source$ */
 /* $Revision$ */
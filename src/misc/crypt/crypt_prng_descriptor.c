@@ -15,7 +15,7 @@
   Stores the PRNG descriptors, Tom St Denis
 */
 struct ltc_prng_descriptor prng_descriptor[TAB_SIZE] = {
-{ NULL, 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL }
+{ NULL, 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL }
 };
 
 LTC_MUTEX_GLOBAL(ltc_prng_mutex)
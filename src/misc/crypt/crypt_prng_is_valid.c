@@ -22,6 +22,13 @@
 */
 int prng_is_valid(int idx)
 {
+   /* sealed registries are immutable, the check is a plain load */
+   if (ltc_registry_sealed) {
+      if (idx < 0 || idx >= TAB_SIZE || prng_descriptor[idx].name == NULL) {
+         return CRYPT_INVALID_PRNG;
+      }
+      return CRYPT_OK;
+   }
    LTC_MUTEX_LOCK(&ltc_prng_mutex);
    if (idx < 0 || idx >= TAB_SIZE || prng_descriptor[idx].name == NULL) {
       LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
@@ -0,0 +1,234 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file crypt_register_all.c
+  Seed the descriptor tables with every built-in algorithm, Tom St Denis
+*/
+
+/* short-lived tools that want "everything" spent their startup in a
+ * dozen register_*() calls, each rescanning its table for duplicates
+ * under the lock.  This seeds each table in one pass with one lock
+ * round-trip; pair it with crypt_registry_seal() and library init is
+ * two calls. */
+
+static const struct ltc_cipher_descriptor * const all_ciphers[] = {
+#ifdef LTC_RIJNDAEL
+   &aes_desc,
+   &rijndael_desc,
+#endif
+#ifdef LTC_BLOWFISH
+   &blowfish_desc,
+#endif
+#ifdef LTC_RC5
+   &rc5_desc,
+#endif
+#ifdef LTC_RC6
+   &rc6_desc,
+#endif
+#ifdef LTC_RC2
+   &rc2_desc,
+#endif
+#ifdef LTC_SAFERP
+   &saferp_desc,
+#endif
+#ifdef LTC_SAFER
+   &safer_k64_desc,
+   &safer_k128_desc,
+   &safer_sk64_desc,
+   &safer_sk128_desc,
+#endif
+#ifdef LTC_XTEA
+   &xtea_desc,
+#endif
+#ifdef LTC_TWOFISH
+   &twofish_desc,
+#endif
+#ifdef LTC_DES
+   &des_desc,
+   &des3_desc,
+#endif
+#ifdef LTC_CAST5
+   &cast5_desc,
+#endif
+#ifdef LTC_NOEKEON
+   &noekeon_desc,
+#endif
+#ifdef LTC_SKIPJACK
+   &skipjack_desc,
+#endif
+#ifdef LTC_KHAZAD
+   &khazad_desc,
+#endif
+#ifdef LTC_ANUBIS
+   &anubis_desc,
+#endif
+#ifdef LTC_KSEED
+   &kseed_desc,
+#endif
+#ifdef LTC_KASUMI
+   &kasumi_desc,
+#endif
+#ifdef LTC_MULTI2
+   &multi2_desc,
+#endif
+#ifdef LTC_CAMELLIA
+   &camellia_desc,
+#endif
+   NULL
+};
+
+static const struct ltc_hash_descriptor * const all_hashes[] = {
+#ifdef LTC_SHA3
+   &sha3_512_desc,
+   &sha3_384_desc,
+   &sha3_256_desc,
+   &sha3_224_desc,
+#endif
+#ifdef LTC_SHA512
+   &sha512_desc,
+#endif
+#ifdef LTC_SHA384
+   &sha384_desc,
+#endif
+#ifdef LTC_SHA512_256
+   &sha512_256_desc,
+#endif
+#ifdef LTC_SHA512_224
+   &sha512_224_desc,
+#endif
+#ifdef LTC_SHA256
+   &sha256_desc,
+#endif
+#ifdef LTC_SHA224
+   &sha224_desc,
+#endif
+#ifdef LTC_SHA1
+   &sha1_desc,
+#endif
+#ifdef LTC_BLAKE2S
+   &blake2s_256_desc,
+   &blake2s_224_desc,
+   &blake2s_160_desc,
+   &blake2s_128_desc,
+#endif
+#ifdef LTC_BLAKE2B
+   &blake2b_512_desc,
+   &blake2b_384_desc,
+   &blake2b_256_desc,
+   &blake2b_160_desc,
+#endif
+#ifdef LTC_BLAKE2BP
+   &blake2bp_desc,
+#endif
+#ifdef LTC_TIGER
+   &tiger_desc,
+#endif
+#ifdef LTC_MD5
+   &md5_desc,
+#endif
+#ifdef LTC_MD4
+   &md4_desc,
+#endif
+#ifdef LTC_MD2
+   &md2_desc,
+#endif
+#ifdef LTC_RIPEMD128
+   &rmd128_desc,
+#endif
+#ifdef LTC_RIPEMD160
+   &rmd160_desc,
+#endif
+#ifdef LTC_RIPEMD256
+   &rmd256_desc,
+#endif
+#ifdef LTC_RIPEMD320
+   &rmd320_desc,
+#endif
+#ifdef LTC_WHIRLPOOL
+   &whirlpool_desc,
+#endif
+   NULL
+};
+
+static const struct ltc_prng_descriptor * const all_prngs[] = {
+#ifdef LTC_YARROW
+   &yarrow_desc,
+#endif
+#ifdef LTC_FORTUNA
+   &fortuna_desc,
+#endif
+#ifdef LTC_RC4
+   &rc4_desc,
+#endif
+#ifdef LTC_CHACHA20_PRNG
+   &chacha20_prng_desc,
+#endif
+#ifdef LTC_CTR_DRBG
+   &ctr_drbg_desc,
+#endif
+#ifdef LTC_SOBER128
+   &sober128_desc,
+#endif
+#ifdef LTC_SPRNG
+   &sprng_desc,
+#endif
+   NULL
+};
+
+/**
+  Register every built-in cipher, hash and PRNG descriptor
+
+  Intended for freshly initialized (empty) tables; existing entries in
+  the first slots are overwritten.  Unlike per-algorithm register_*()
+  calls there is no duplicate scan, each table is filled in one pass
+  under one lock acquisition.  CHC (which needs a bound cipher) is not
+  registered.  Call crypt_registry_seal() afterwards if no further
+  registration is wanted.
+  @return CRYPT_OK if successful
+*/
+int crypt_register_all_descriptors(void)
+{
+   int x;
+
+   if (ltc_registry_sealed) {
+      return CRYPT_ERROR;
+   }
+
+   LTC_MUTEX_LOCK(&ltc_cipher_mutex);
+   for (x = 0; x < TAB_SIZE && all_ciphers[x] != NULL; x++) {
+      XMEMCPY(&cipher_descriptor[x], all_ciphers[x], sizeof(struct ltc_cipher_descriptor));
+   }
+   cipher_name_index_invalidate();
+   LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
+
+   LTC_MUTEX_LOCK(&ltc_hash_mutex);
+   for (x = 0; x < TAB_SIZE && all_hashes[x] != NULL; x++) {
+      XMEMCPY(&hash_descriptor[x], all_hashes[x], sizeof(struct ltc_hash_descriptor));
+   }
+   hash_oid_index_invalidate();
+   hash_name_index_invalidate();
+   LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
+
+   LTC_MUTEX_LOCK(&ltc_prng_mutex);
+   for (x = 0; x < TAB_SIZE && all_prngs[x] != NULL; x++) {
+      XMEMCPY(&prng_descriptor[x], all_prngs[x], sizeof(struct ltc_prng_descriptor));
+   }
+   prng_name_index_invalidate();
+   LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
+
+   return CRYPT_OK;
+}
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -26,6 +26,11 @@ int register_cipher(const struct ltc_cipher_descriptor *cipher)
 
    LTC_ARGCHK(cipher != NULL);
 
+   /* the registry is immutable once sealed */
+   if (ltc_registry_sealed) {
+      return -1;
+   }
+
    /* is it already registered? */
    LTC_MUTEX_LOCK(&ltc_cipher_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
@@ -39,6 +44,7 @@ int register_cipher(const struct ltc_cipher_descriptor *cipher)
    for (x = 0; x < TAB_SIZE; x++) {
        if (cipher_descriptor[x].name == NULL) {
           XMEMCPY(&cipher_descriptor[x], cipher, sizeof(struct ltc_cipher_descriptor));
+          cipher_name_index_invalidate();
           LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
           return x;
        }
@@ -26,6 +26,11 @@ int register_hash(const struct ltc_hash_descriptor *hash)
 
    LTC_ARGCHK(hash != NULL);
 
+   /* the registry is immutable once sealed */
+   if (ltc_registry_sealed) {
+      return -1;
+   }
+
    /* is it already registered? */
    LTC_MUTEX_LOCK(&ltc_hash_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
@@ -39,6 +44,8 @@ int register_hash(const struct ltc_hash_descriptor *hash)
    for (x = 0; x < TAB_SIZE; x++) {
        if (hash_descriptor[x].name == NULL) {
           XMEMCPY(&hash_descriptor[x], hash, sizeof(struct ltc_hash_descriptor));
+          hash_oid_index_invalidate();
+          hash_name_index_invalidate();
           LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
           return x;
        }
@@ -26,6 +26,11 @@ int register_prng(const struct ltc_prng_descriptor *prng)
 
    LTC_ARGCHK(prng != NULL);
 
+   /* the registry is immutable once sealed */
+   if (ltc_registry_sealed) {
+      return -1;
+   }
+
    /* is it already registered? */
    LTC_MUTEX_LOCK(&ltc_prng_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
@@ -39,6 +44,7 @@ int register_prng(const struct ltc_prng_descriptor *prng)
    for (x = 0; x < TAB_SIZE; x++) {
        if (prng_descriptor[x].name == NULL) {
           XMEMCPY(&prng_descriptor[x], prng, sizeof(struct ltc_prng_descriptor));
+          prng_name_index_invalidate();
           LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
           return x;
        }
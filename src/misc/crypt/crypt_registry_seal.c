@@ -0,0 +1,50 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file crypt_registry_seal.c
+  Seal the descriptor registries for lock-free reads, Tom St Denis
+*/
+
+/* most applications register their ciphers/hashes/PRNGs once at
+ * startup and never touch the tables again, yet every find_*() and
+ * *_is_valid() call still paid for the registry mutex.  Sealing makes
+ * the tables immutable: the hot read paths become plain loads and any
+ * further (un)registration is refused. */
+
+int ltc_registry_sealed = 0;
+
+/**
+  Seal the cipher/hash/PRNG descriptor registries
+
+  Call once after all register_*() calls are done.  The name indexes
+  are built under their locks here so no post-seal lookup has to, then
+  the sealed flag makes find_cipher/find_hash/find_prng and the
+  *_is_valid() helpers bypass the registry mutexes.  There is no
+  unseal; register_*()/unregister_*() fail once sealed.
+  @return CRYPT_OK if successful
+*/
+int crypt_registry_seal(void)
+{
+   /* force the lazily-built name indexes into existence while the
+    * locks still guard them */
+   (void)find_cipher("");
+   (void)find_hash("");
+   (void)find_prng("");
+
+   ltc_registry_sealed = 1;
+   return CRYPT_OK;
+}
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
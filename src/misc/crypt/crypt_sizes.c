@@ -172,6 +172,7 @@ static const crypt_size _crypt_sizes[] = {
 #endif
 #ifdef LTC_HMAC
     _SZ_STRINGIFY_T(hmac_state),
+    _SZ_STRINGIFY_T(hmac_precomputed),
 #endif
 #ifdef LTC_OMAC
     _SZ_STRINGIFY_T(omac_state),
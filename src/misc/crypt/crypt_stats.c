@@ -0,0 +1,73 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file crypt_stats.c
+  Hot path usage counters, Tom St Denis
+
+  Compiled in with LTC_STATS: the bulk entry points count their calls,
+  the bytes they processed and how often they had to take a slow path
+  (no accelerator, carried partial block, length off the block size),
+  keyed by operation and descriptor index.  The counters are plain
+  increments without any locking -- under heavy concurrency an update
+  may occasionally be lost, which is the accepted price for keeping
+  the hot paths free of synchronization; the snapshot is statistics,
+  not accounting.
+*/
+
+#ifdef LTC_STATS
+
+static ltc_stat stats_tab[LTC_STAT_OPS][TAB_SIZE];
+
+/* called from the hot paths through LTC_STATS_BUMP() */
+void crypt_stats_bump(int op, int idx, unsigned long nbytes, int slow)
+{
+   if (op < 0 || op >= LTC_STAT_OPS || idx < 0 || idx >= TAB_SIZE) {
+      return;
+   }
+   stats_tab[op][idx].calls += 1;
+   stats_tab[op][idx].bytes += nbytes;
+   if (slow) {
+      stats_tab[op][idx].slow += 1;
+   }
+}
+
+/**
+  Snapshot one counter
+  @param op    One of the LTC_STAT_* operations
+  @param idx   The cipher (or, for LTC_STAT_HASH, hash) descriptor index
+  @param out   [out] Receives the counter values
+  @return CRYPT_OK if successful
+*/
+int crypt_stats_get(int op, int idx, ltc_stat *out)
+{
+   LTC_ARGCHK(out != NULL);
+   if (op < 0 || op >= LTC_STAT_OPS || idx < 0 || idx >= TAB_SIZE) {
+      return CRYPT_INVALID_ARG;
+   }
+   *out = stats_tab[op][idx];
+   return CRYPT_OK;
+}
+
+/**
+  Zero every counter
+*/
+void crypt_stats_reset(void)
+{
+   zeromem(stats_tab, sizeof(stats_tab));
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
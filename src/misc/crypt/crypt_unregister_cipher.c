@@ -26,12 +26,18 @@ int unregister_cipher(const struct ltc_cipher_descriptor *cipher)
 
    LTC_ARGCHK(cipher != NULL);
 
+   /* the registry is immutable once sealed */
+   if (ltc_registry_sealed) {
+      return CRYPT_ERROR;
+   }
+
    /* is it already registered? */
    LTC_MUTEX_LOCK(&ltc_cipher_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
        if (XMEMCMP(&cipher_descriptor[x], cipher, sizeof(struct ltc_cipher_descriptor)) == 0) {
           cipher_descriptor[x].name = NULL;
           cipher_descriptor[x].ID   = 255;
+          cipher_name_index_invalidate();
           LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
           return CRYPT_OK;
        }
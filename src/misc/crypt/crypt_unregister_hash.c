@@ -26,11 +26,18 @@ int unregister_hash(const struct ltc_hash_descriptor *hash)
 
    LTC_ARGCHK(hash != NULL);
 
+   /* the registry is immutable once sealed */
+   if (ltc_registry_sealed) {
+      return CRYPT_ERROR;
+   }
+
    /* is it already registered? */
    LTC_MUTEX_LOCK(&ltc_hash_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
        if (XMEMCMP(&hash_descriptor[x], hash, sizeof(struct ltc_hash_descriptor)) == 0) {
           hash_descriptor[x].name = NULL;
+          hash_oid_index_invalidate();
+          hash_name_index_invalidate();
           LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
           return CRYPT_OK;
        }
@@ -26,11 +26,17 @@ int unregister_prng(const struct ltc_prng_descriptor *prng)
 
    LTC_ARGCHK(prng != NULL);
 
+   /* the registry is immutable once sealed */
+   if (ltc_registry_sealed) {
+      return CRYPT_ERROR;
+   }
+
    /* is it already registered? */
    LTC_MUTEX_LOCK(&ltc_prng_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
        if (XMEMCMP(&prng_descriptor[x], prng, sizeof(struct ltc_prng_descriptor)) == 0) {
           prng_descriptor[x].name = NULL;
+          prng_name_index_invalidate();
           LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
           return CRYPT_OK;
        }
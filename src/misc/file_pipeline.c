@@ -0,0 +1,278 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file file_pipeline.c
+  Streaming read/transform/write pipeline, Tom St Denis
+*/
+
+#ifndef LTC_NO_FILE
+
+#ifdef LTC_FILE_POSIX
+#include <sys/types.h>
+#include <aio.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+/* one pipeline chunk; each ring slot leaves a page of slack (at least
+ * MAXBLOCKSIZE) so a transform may grow its chunk (e.g. padding) in
+ * place, and the page-sized stride keeps every slot page aligned for
+ * descriptors opened with O_DIRECT */
+#define LTC_PIPE_BUFSIZE   (256*1024)
+#define LTC_PIPE_SLOT      (LTC_PIPE_BUFSIZE + 4096)
+
+#ifdef LTC_FILE_POSIX
+/* wait out one aio request and fetch its result */
+static int _pipe_reap(struct aiocb *cb, long *res)
+{
+   const struct aiocb *w[1];
+   ssize_t r;
+
+   w[0] = cb;
+   while (aio_error(cb) == EINPROGRESS) {
+      (void)aio_suspend(w, 1, NULL);
+   }
+   if (aio_error(cb) != 0 || (r = aio_return(cb)) < 0) {
+      return CRYPT_ERROR;
+   }
+   *res = (long)r;
+   return CRYPT_OK;
+}
+#endif
+
+/* plain lookahead loop: read the next chunk before transforming the
+ * current one, so the transform learns it is final before it runs */
+static int _pipe_buffered(FILE *in, FILE *out,
+                          int (*transform)(void *state, unsigned char *buf, unsigned long *len, int final),
+                          void *state)
+{
+   unsigned char *a, *b, *t;
+   unsigned long  la, lb;
+   int            err, final;
+
+   if ((a = XMALLOC(2 * LTC_PIPE_SLOT)) == NULL) {
+      return CRYPT_MEM;
+   }
+   b   = a + LTC_PIPE_SLOT;
+   err = CRYPT_OK;
+
+   la = (unsigned long)fread(a, 1, LTC_PIPE_BUFSIZE, in);
+   if (ferror(in)) {
+      err = CRYPT_ERROR;
+      goto LBL_DONE;
+   }
+   for (;;) {
+      lb = (unsigned long)fread(b, 1, LTC_PIPE_BUFSIZE, in);
+      if (ferror(in)) {
+         err = CRYPT_ERROR;
+         break;
+      }
+      final = (lb == 0);
+      if ((err = transform(state, a, &la, final)) != CRYPT_OK) {
+         break;
+      }
+      if (la > 0 && fwrite(a, 1, la, out) != la) {
+         err = CRYPT_ERROR;
+         break;
+      }
+      if (final) {
+         break;
+      }
+      t = a; a = b; b = t;
+      la = lb;
+   }
+
+LBL_DONE:
+   zeromem(a < b ? a : b, 2 * LTC_PIPE_SLOT);
+   XFREE(a < b ? a : b);
+   return err;
+}
+
+/**
+  Pump a file through a transform into another file with the stages
+  overlapped.  Chunks move through a three-slot ring: while the
+  transform works on one chunk, the read for the next and the write of
+  the previous are both in flight via POSIX aio.  The transform is
+  called as transform(state, buf, &len, final) with the chunk in buf;
+  it may rewrite the chunk in place and grow it by up to MAXBLOCKSIZE
+  octets or shrink it (padding modes need both), and it sees final
+  nonzero exactly once, on the last chunk - with len 0 if the input was
+  empty.  Hosts without the POSIX driver run the same lookahead loop
+  with plain stdio.  The call is synchronous; the library never spawns
+  threads.
+  @param in         The source file handle (read to EOF from the current position)
+  @param out        The destination file handle
+  @param transform  The transform callback
+  @param state      Opaque state handed to the callback
+  @return CRYPT_OK if successful
+*/
+int file_pipeline_filehandle(FILE *in, FILE *out,
+                             int (*transform)(void *state, unsigned char *buf, unsigned long *len, int final),
+                             void *state)
+{
+#ifdef LTC_FILE_POSIX
+   unsigned char *bufs;
+   struct aiocb   rcb, wcb;
+   off_t          roff, ooff;
+   unsigned long  prevlen, plen, wexp, k;
+   long           got, wres;
+   int            ifd, ofd, err, final, chunk, nxt, wbuf;
+   int            rinflight, winflight;
+
+   LTC_ARGCHK(in        != NULL);
+   LTC_ARGCHK(out       != NULL);
+   LTC_ARGCHK(transform != NULL);
+
+   /* aio bypasses stdio, so pick up the logical positions and make
+    * sure nothing is sitting in the output buffer */
+   if (fflush(out) != 0) {
+      return CRYPT_ERROR;
+   }
+   ifd  = fileno(in);
+   ofd  = fileno(out);
+   roff = ftello(in);
+   ooff = ftello(out);
+   if (ifd < 0 || ofd < 0 || roff < 0 || ooff < 0) {
+      return _pipe_buffered(in, out, transform, state);
+   }
+
+   if ((bufs = XMALLOC_ALIGNED(3 * LTC_PIPE_SLOT, 4096)) == NULL) {
+      return CRYPT_MEM;
+   }
+
+   XMEMSET(&rcb, 0, sizeof(rcb));
+   XMEMSET(&wcb, 0, sizeof(wcb));
+   rcb.aio_fildes = ifd;
+   wcb.aio_fildes = ofd;
+
+   rcb.aio_buf    = bufs;
+   rcb.aio_nbytes = LTC_PIPE_BUFSIZE;
+   rcb.aio_offset = roff;
+   if (aio_read(&rcb) != 0) {
+      /* no aio here; the buffered loop starts from an untouched file */
+      XFREE_ALIGNED(bufs);
+      return _pipe_buffered(in, out, transform, state);
+   }
+
+   err       = CRYPT_OK;
+   rinflight = 1;
+   winflight = 0;
+   wbuf      = -1;
+   wexp      = 0;
+   prevlen   = 0;
+
+   for (k = 0;; k++) {
+      if ((err = _pipe_reap(&rcb, &got)) != CRYPT_OK) {
+         rinflight = 0;
+         goto LBL_DRAIN;
+      }
+      rinflight = 0;
+      roff     += got;
+
+      if (got > 0) {
+         /* launch the next read before the transform runs; its slot
+          * may still be on its way out, so settle that write first */
+         nxt = (int)((k + 1) % 3);
+         if (winflight && wbuf == nxt) {
+            if ((err = _pipe_reap(&wcb, &wres)) != CRYPT_OK || (unsigned long)wres != wexp) {
+               winflight = 0;
+               err = err != CRYPT_OK ? err : CRYPT_ERROR;
+               goto LBL_DRAIN;
+            }
+            winflight = 0;
+         }
+         rcb.aio_buf    = bufs + (unsigned long)nxt * LTC_PIPE_SLOT;
+         rcb.aio_nbytes = LTC_PIPE_BUFSIZE;
+         rcb.aio_offset = roff;
+         if (aio_read(&rcb) != 0) {
+            err = CRYPT_ERROR;
+            goto LBL_DRAIN;
+         }
+         rinflight = 1;
+      }
+
+      final = (got == 0);
+      if (k > 0 || final) {
+         /* the previous chunk is complete and we know whether it is
+          * the last one; transform and ship it */
+         chunk = (k > 0) ? (int)((k - 1) % 3) : 0;
+         plen  = (k > 0) ? prevlen : 0;
+         if ((err = transform(state, bufs + (unsigned long)chunk * LTC_PIPE_SLOT, &plen, final)) != CRYPT_OK) {
+            goto LBL_DRAIN;
+         }
+         if (winflight) {
+            if ((err = _pipe_reap(&wcb, &wres)) != CRYPT_OK || (unsigned long)wres != wexp) {
+               winflight = 0;
+               err = err != CRYPT_OK ? err : CRYPT_ERROR;
+               goto LBL_DRAIN;
+            }
+            winflight = 0;
+         }
+         if (plen > 0) {
+            wcb.aio_buf    = bufs + (unsigned long)chunk * LTC_PIPE_SLOT;
+            wcb.aio_nbytes = plen;
+            wcb.aio_offset = ooff;
+            if (aio_write(&wcb) != 0) {
+               err = CRYPT_ERROR;
+               goto LBL_DRAIN;
+            }
+            winflight = 1;
+            wbuf      = chunk;
+            wexp      = plen;
+            ooff     += (off_t)plen;
+         }
+      }
+      if (final) {
+         break;
+      }
+      prevlen = (unsigned long)got;
+   }
+
+LBL_DRAIN:
+   if (rinflight) {
+      (void)aio_cancel(ifd, &rcb);
+      (void)_pipe_reap(&rcb, &got);
+   }
+   if (winflight) {
+      if (err == CRYPT_OK) {
+         if (_pipe_reap(&wcb, &wres) != CRYPT_OK || (unsigned long)wres != wexp) {
+            err = CRYPT_ERROR;
+         }
+      } else {
+         (void)aio_cancel(ofd, &wcb);
+         (void)_pipe_reap(&wcb, &wres);
+      }
+   }
+
+   /* resync the stdio handles with where the pipeline left off */
+   if (err == CRYPT_OK) {
+      (void)fseeko(in, roff, SEEK_SET);
+      (void)fseeko(out, ooff, SEEK_SET);
+   }
+
+   zeromem(bufs, 3 * LTC_PIPE_SLOT);
+   XFREE_ALIGNED(bufs);
+   return err;
+#else
+   LTC_ARGCHK(in        != NULL);
+   LTC_ARGCHK(out       != NULL);
+   LTC_ARGCHK(transform != NULL);
+   return _pipe_buffered(in, out, transform, state);
+#endif
+}
+
+#endif /* #ifndef LTC_NO_FILE */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
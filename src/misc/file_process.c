@@ -0,0 +1,314 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file file_process.c
+  Chunked file driver shared by the *_file helpers, Tom St Denis
+*/
+
+#ifndef LTC_NO_FILE
+
+#ifdef LTC_FILE_POSIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <aio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+/* one transfer for the buffered paths; much larger than stdio's default
+ * so the compute loop is not broken up every few KB */
+#define LTC_FILE_XFER_BUFSIZE   (256*1024)
+
+/* how much of a mapped file we hand to the callback at once; the next
+ * chunk is advised to the kernel first so the fetch overlaps compute */
+#define LTC_FILE_MMAP_CHUNK     (4UL*1024*1024)
+
+/* how much of the file is mapped at a time; windows are unmapped as
+ * soon as they are consumed so huge files neither exhaust address
+ * space on 32-bit hosts nor pin the whole page cache working set.
+ * A multiple of any page size so window offsets stay aligned. */
+#define LTC_FILE_MMAP_WINDOW    (64UL*1024*1024)
+
+/**
+  Feed an open file handle through a process callback in large chunks.
+  @param in       The open file handle (read to EOF from the current position)
+  @param process  The callback, called as process(state, buf, len)
+  @param state    Opaque state handed to the callback
+  @return CRYPT_OK if successful
+*/
+int file_process_filehandle(FILE *in,
+                            int (*process)(void *state, const unsigned char *buf, unsigned long len),
+                            void *state)
+{
+   unsigned char *buf;
+   size_t x;
+   int err;
+
+   LTC_ARGCHK(in      != NULL);
+   LTC_ARGCHK(process != NULL);
+
+   if ((buf = XMALLOC(LTC_FILE_XFER_BUFSIZE)) == NULL) {
+      return CRYPT_MEM;
+   }
+
+   do {
+      x = fread(buf, 1, LTC_FILE_XFER_BUFSIZE, in);
+      if ((err = process(state, buf, (unsigned long)x)) != CRYPT_OK) {
+         goto LBL_CLEANBUF;
+      }
+   } while (x == LTC_FILE_XFER_BUFSIZE);
+   err = ferror(in) ? CRYPT_ERROR : CRYPT_OK;
+
+LBL_CLEANBUF:
+   zeromem(buf, LTC_FILE_XFER_BUFSIZE);
+   XFREE(buf);
+   return err;
+}
+
+/**
+  Feed a file through a process callback.  On POSIX hosts regular files
+  are mapped and walked one chunk at a time with the following chunk
+  advised to the kernel first, so the disk fetch runs while the current
+  chunk is being processed; everything else falls back to a large
+  buffered read loop.
+  @param fname    The name of the file
+  @param process  The callback, called as process(state, buf, len)
+  @param state    Opaque state handed to the callback
+  @return CRYPT_OK if successful, CRYPT_FILE_NOTFOUND if it cannot be opened
+*/
+int file_process(const char *fname,
+                 int (*process)(void *state, const unsigned char *buf, unsigned long len),
+                 void *state)
+{
+   FILE *in;
+   int err;
+
+   LTC_ARGCHK(fname   != NULL);
+   LTC_ARGCHK(process != NULL);
+
+#ifdef LTC_FILE_POSIX
+   {
+      struct stat sb;
+      int fd;
+
+      fd = open(fname, O_RDONLY);
+      if (fd < 0) {
+         return CRYPT_FILE_NOTFOUND;
+      }
+
+      if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0) {
+         unsigned char *map;
+         off_t          off = 0;
+         size_t         wlen;
+         int            mapped = 1;
+
+         err = CRYPT_OK;
+         while (off < sb.st_size) {
+            unsigned long left, n;
+            unsigned char *p;
+
+            wlen = (size_t)(sb.st_size - off < (off_t)LTC_FILE_MMAP_WINDOW
+                               ? sb.st_size - off : (off_t)LTC_FILE_MMAP_WINDOW);
+            map = mmap(NULL, wlen, PROT_READ, MAP_SHARED, fd, off);
+            if (map == MAP_FAILED) {
+               /* leave the descriptor at off and let the buffered loop
+                * below finish the remainder */
+               mapped = 0;
+               break;
+            }
+#ifdef MADV_SEQUENTIAL
+            (void)madvise(map, wlen, MADV_SEQUENTIAL);
+#endif
+            p    = map;
+            left = (unsigned long)wlen;
+            while (left > 0) {
+               n = left < LTC_FILE_MMAP_CHUNK ? left : LTC_FILE_MMAP_CHUNK;
+#ifdef MADV_WILLNEED
+               if (left > n) {
+                  unsigned long ahead = left - n;
+                  if (ahead > LTC_FILE_MMAP_CHUNK) {
+                     ahead = LTC_FILE_MMAP_CHUNK;
+                  }
+                  (void)madvise(p + n, (size_t)ahead, MADV_WILLNEED);
+               }
+#endif
+               if ((err = process(state, p, n)) != CRYPT_OK) {
+                  break;
+               }
+               p    += n;
+               left -= n;
+            }
+#ifdef MADV_DONTNEED
+            /* the window was consumed; let the kernel reclaim it */
+            (void)madvise(map, wlen, MADV_DONTNEED);
+#endif
+            (void)munmap(map, wlen);
+            if (err != CRYPT_OK) {
+               break;
+            }
+            off += (off_t)wlen;
+         }
+         if (mapped) {
+            (void)close(fd);
+            return err;
+         }
+         if (lseek(fd, off, SEEK_SET) != off) {
+            (void)close(fd);
+            return CRYPT_ERROR;
+         }
+      }
+
+      /* pipes, devices, or a failed map: big-buffer read loop with
+       * sequential readahead hints */
+#ifdef POSIX_FADV_SEQUENTIAL
+      (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+      in = fdopen(fd, "rb");
+      if (in == NULL) {
+         (void)close(fd);
+         return CRYPT_FILE_NOTFOUND;
+      }
+   }
+#else
+   in = fopen(fname, "rb");
+   if (in == NULL) {
+      return CRYPT_FILE_NOTFOUND;
+   }
+#endif
+
+   err = file_process_filehandle(in, process, state);
+   if (fclose(in) != 0 && err == CRYPT_OK) {
+      err = CRYPT_ERROR;
+   }
+   return err;
+}
+
+/**
+  Feed a file through a process callback with overlapped I/O.  Two
+  transfer buffers alternate: while the callback works on one, a POSIX
+  aio read for the next is already in flight, so disk wait and compute
+  overlap instead of strictly alternating.  Hosts without the POSIX
+  driver fall back to file_process().  The call itself is synchronous -
+  the library never spawns threads; the asynchrony is purely between
+  the kernel's reads and our compute loop.
+  @param fname    The name of the file
+  @param process  The callback, called as process(state, buf, len)
+  @param state    Opaque state handed to the callback
+  @return CRYPT_OK if successful, CRYPT_FILE_NOTFOUND if it cannot be opened
+*/
+int file_process_overlapped(const char *fname,
+                            int (*process)(void *state, const unsigned char *buf, unsigned long len),
+                            void *state)
+{
+#ifdef LTC_FILE_POSIX
+   unsigned char *bufs;
+   struct aiocb   cb[2];
+   const struct aiocb *wait[1];
+   off_t          off;
+   ssize_t        got;
+   int            fd, cur, nxt, err, i;
+   int            live[2];
+
+   LTC_ARGCHK(fname   != NULL);
+   LTC_ARGCHK(process != NULL);
+
+   fd = open(fname, O_RDONLY);
+   if (fd < 0) {
+      return CRYPT_FILE_NOTFOUND;
+   }
+   if ((bufs = XMALLOC(2 * LTC_FILE_XFER_BUFSIZE)) == NULL) {
+      (void)close(fd);
+      return CRYPT_MEM;
+   }
+
+   XMEMSET(cb, 0, sizeof(cb));
+   for (i = 0; i < 2; i++) {
+      cb[i].aio_fildes = fd;
+      cb[i].aio_buf    = bufs + (unsigned long)i * LTC_FILE_XFER_BUFSIZE;
+      cb[i].aio_nbytes = LTC_FILE_XFER_BUFSIZE;
+   }
+
+   live[0] = live[1] = 0;
+   cb[0].aio_offset = 0;
+   if (aio_read(&cb[0]) != 0) {
+      /* no aio on this setup; hand the whole job to the plain driver */
+      XFREE(bufs);
+      (void)close(fd);
+      return file_process(fname, process, state);
+   }
+
+   live[0] = 1;
+   err = CRYPT_OK;
+   cur = 0;
+   off = 0;
+   for (;;) {
+      /* reap the read for the current buffer */
+      wait[0] = &cb[cur];
+      while (aio_error(&cb[cur]) == EINPROGRESS) {
+         (void)aio_suspend(wait, 1, NULL);
+      }
+      live[cur] = 0;
+      if (aio_error(&cb[cur]) != 0 || (got = aio_return(&cb[cur])) < 0) {
+         err = CRYPT_ERROR;
+         break;
+      }
+      if (got == 0) {
+         break;
+      }
+      off += got;
+
+      /* launch the next read before touching this chunk */
+      nxt = cur ^ 1;
+      cb[nxt].aio_offset = off;
+      cb[nxt].aio_nbytes = LTC_FILE_XFER_BUFSIZE;
+      if (aio_read(&cb[nxt]) != 0) {
+         err = CRYPT_ERROR;
+         break;
+      }
+      live[nxt] = 1;
+
+      if ((err = process(state, (unsigned char *)cb[cur].aio_buf, (unsigned long)got)) != CRYPT_OK) {
+         break;
+      }
+      cur = nxt;
+   }
+
+   /* drain anything still in flight before the buffers go away */
+   (void)aio_cancel(fd, NULL);
+   for (i = 0; i < 2; i++) {
+      if (!live[i]) {
+         continue;
+      }
+      wait[0] = &cb[i];
+      while (aio_error(&cb[i]) == EINPROGRESS) {
+         (void)aio_suspend(wait, 1, NULL);
+      }
+      (void)aio_return(&cb[i]);
+   }
+
+   zeromem(bufs, 2 * LTC_FILE_XFER_BUFSIZE);
+   XFREE(bufs);
+   (void)close(fd);
+   return err;
+#else
+   return file_process(fname, process, state);
+#endif
+}
+
+#endif /* #ifndef LTC_NO_FILE */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,168 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include <tomcrypt.h>
+
+/**
+  @file hkdf_prk.c
+  HKDF with a reusable extracted-key context, by Tom St Denis
+
+  hkdf() re-extracts and re-keys HMAC on every call, which is wasted
+  work when many outputs hang off one master secret (session-key
+  fan-out).  Here the extract step ends in an hkdf_prk context holding
+  the PRK-keyed HMAC midstates (hmac_precompute()), so each subsequent
+  expand keys HMAC by struct copy -- no re-extraction, no key
+  hashing, no heap traffic.
+*/
+
+#ifdef LTC_HKDF
+
+/**
+  Extract a PRK and precompute its HMAC midstates for reuse
+  @param hash_idx  The index of the hash to use
+  @param salt      The optional salt (may be NULL)
+  @param saltlen   The length of the salt (octets)
+  @param in        The input keying material
+  @param inlen     The length of the input keying material (octets)
+  @param prk       [out] The PRK context to fill
+  @return CRYPT_OK on success
+*/
+int hkdf_extract_prk(int hash_idx,
+                     const unsigned char *salt, unsigned long saltlen,
+                     const unsigned char *in,   unsigned long inlen,
+                     hkdf_prk *prk)
+{
+   unsigned char K[MAXBLOCKSIZE];
+   unsigned long Klen;
+   int err;
+
+   LTC_ARGCHK(prk != NULL);
+
+   if ((err = hash_is_valid(hash_idx)) != CRYPT_OK) {
+      return err;
+   }
+   Klen = sizeof(K);
+   if ((err = hkdf_extract(hash_idx, salt, saltlen, in, inlen, K, &Klen)) != CRYPT_OK) {
+      return err;
+   }
+   err = hmac_precompute(&prk->hmac, hash_idx, K, Klen);
+   prk->hash_idx = hash_idx;
+   prk->hashsize = hash_descriptor[hash_idx].hashsize;
+   zeromem(K, sizeof(K));
+   return err;
+}
+
+/**
+  Expand one labeled output from a PRK context.
+
+  The context is read-only here, so one context may serve any number
+  of threads.
+
+  @param prk      The PRK context (hkdf_extract_prk())
+  @param info     The optional context/label (may be NULL)
+  @param infolen  The length of the label (octets)
+  @param out      [out] The derived output
+  @param outlen   The length to derive (octets, at most 255 * hashsize)
+  @return CRYPT_OK on success
+*/
+int hkdf_expand_prk(const hkdf_prk *prk,
+                    const unsigned char *info, unsigned long infolen,
+                          unsigned char *out,  unsigned long outlen)
+{
+   hmac_state    hmac;
+   unsigned char T[MAXBLOCKSIZE], N;
+   unsigned long Tlen, Noutlen, outoff;
+   int err;
+
+   LTC_ARGCHK(prk != NULL);
+   LTC_ARGCHK(out != NULL);
+
+   /* RFC5869 parameter restrictions */
+   if (outlen > prk->hashsize * 255) {
+      return CRYPT_INVALID_ARG;
+   }
+   if (info == NULL && infolen != 0) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   N      = 0;
+   Tlen   = 0;      /* T(1) doesn't include a previous hash value */
+   outoff = 0;
+   while (1) {      /* an exit condition breaks mid-loop */
+      N++;
+      if ((err = hmac_init_from_precomputed(&hmac, &prk->hmac))   != CRYPT_OK ||
+          (err = hmac_process(&hmac, T, Tlen))                    != CRYPT_OK ||
+          (infolen > 0 &&
+          (err = hmac_process(&hmac, info, infolen))              != CRYPT_OK) ||
+          (err = hmac_process(&hmac, &N, 1))                      != CRYPT_OK) {
+         goto error;
+      }
+      Tlen = sizeof(T);
+      if ((err = hmac_done(&hmac, T, &Tlen)) != CRYPT_OK) {
+         goto error;
+      }
+      Noutlen = MIN(Tlen, outlen - outoff);
+      XMEMCPY(out + outoff, T, Noutlen);
+      outoff += Noutlen;
+
+      if (outoff >= outlen) { /* loop exit condition */
+         break;
+      }
+   }
+   err = CRYPT_OK;
+error:
+   zeromem(T, sizeof(T));
+   zeromem(&hmac, sizeof(hmac));
+   return err;
+}
+
+/**
+  Expand several labeled outputs from one PRK context in one pass
+  @param prk      The PRK context (hkdf_extract_prk())
+  @param labels   The labels to derive; each entry names its info,
+                  output buffer and length
+  @param nlabels  The number of labels
+  @return CRYPT_OK on success
+*/
+int hkdf_expand_multi(const hkdf_prk *prk,
+                      const hkdf_label *labels, unsigned int nlabels)
+{
+   unsigned int x;
+   int err;
+
+   LTC_ARGCHK(prk    != NULL);
+   LTC_ARGCHK(labels != NULL);
+
+   for (x = 0; x < nlabels; x++) {
+      if ((err = hkdf_expand_prk(prk, labels[x].info, labels[x].infolen,
+                                 labels[x].out, labels[x].outlen)) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Terminate a PRK context, wiping the key midstates
+  @param prk   The PRK context
+  @return CRYPT_OK on success
+*/
+int hkdf_prk_done(hkdf_prk *prk)
+{
+   LTC_ARGCHK(prk != NULL);
+   zeromem(prk, sizeof(*prk));
+   return CRYPT_OK;
+}
+
+#endif /* LTC_HKDF */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
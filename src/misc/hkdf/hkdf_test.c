@@ -271,6 +271,39 @@ int hkdf_test(void)
             return err;
         }
 
+        /* the split extract-once/expand-many path must agree with the
+           monolithic call on every vector */
+        {
+            hkdf_prk      prk;
+            hkdf_label    lbl;
+            unsigned char OKM2[82];
+
+            if ((err = hkdf_extract_prk(hash, cases[i].salt, cases[i].salt_l,
+                                        cases[i].IKM, cases[i].IKM_l, &prk)) != CRYPT_OK) {
+                return err;
+            }
+            if ((err = hkdf_expand_prk(&prk, cases[i].info, cases[i].info_l,
+                                       OKM2, cases[i].OKM_l)) != CRYPT_OK) {
+                return err;
+            }
+            if (XMEMCMP(OKM2, OKM, (size_t)cases[i].OKM_l) != 0) {
+                return CRYPT_FAIL_TESTVECTOR;
+            }
+            /* and so must the batched form */
+            lbl.info    = cases[i].info;
+            lbl.infolen = cases[i].info_l;
+            lbl.out     = OKM2;
+            lbl.outlen  = cases[i].OKM_l;
+            zeromem(OKM2, sizeof(OKM2));
+            if ((err = hkdf_expand_multi(&prk, &lbl, 1)) != CRYPT_OK) {
+                return err;
+            }
+            if (XMEMCMP(OKM2, OKM, (size_t)cases[i].OKM_l) != 0) {
+                return CRYPT_FAIL_TESTVECTOR;
+            }
+            hkdf_prk_done(&prk);
+        }
+
         if(XMEMCMP(OKM, cases[i].OKM, (size_t)cases[i].OKM_l) != 0)  {
             failed++;
 #if 0
@@ -0,0 +1,138 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ivseq.c
+  Counter based deterministic IV sequencer
+*/
+
+/* Emits unique 12 byte IVs as random-prefix || big endian counter.
+ * The PRNG is consulted once at start for the prefix; every IV after
+ * that is a counter increment, so per-record IV generation costs no
+ * PRNG transaction.  The 12 byte length keeps GCM in its short-IV
+ * counter mode (see gcm_add_iv.c).  The counter is per context: use
+ * one sequencer per key and never reuse a sequencer across keys.
+ */
+
+#ifdef LTC_IVSEQ
+
+/**
+  Initialize an IV sequencer
+  @param wprng   Index of the PRNG to read the prefix from
+  @param prng    The active PRNG state
+  @param seq     [out] The sequencer to initialize
+  @return CRYPT_OK if successful
+*/
+int ivseq_start(int wprng, prng_state *prng, ivseq_state *seq)
+{
+   int err;
+
+   LTC_ARGCHK(seq != NULL);
+
+   if ((err = prng_is_valid(wprng)) != CRYPT_OK) {
+      return err;
+   }
+
+   if (prng_descriptor[wprng].read(seq->prefix, sizeof(seq->prefix), prng) != sizeof(seq->prefix)) {
+      return CRYPT_ERROR_READPRNG;
+   }
+   seq->ctr = 0;
+
+   return CRYPT_OK;
+}
+
+/**
+  Produce the next IV in the sequence
+  @param seq     The sequencer
+  @param IV      [out] Destination for the IV (LTC_IVSEQ_IVLEN bytes)
+  @param IVlen   [in/out] Max size and resulting size of the IV
+  @return CRYPT_OK if successful, CRYPT_OVERFLOW once the counter space is exhausted
+*/
+int ivseq_next(ivseq_state *seq, unsigned char *IV, unsigned long *IVlen)
+{
+   LTC_ARGCHK(seq   != NULL);
+   LTC_ARGCHK(IV    != NULL);
+   LTC_ARGCHK(IVlen != NULL);
+
+   if (*IVlen < LTC_IVSEQ_IVLEN) {
+      *IVlen = LTC_IVSEQ_IVLEN;
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+
+   /* refuse to wrap; the last counter value is sacrificed so the
+    * exhausted state cannot be confused with a fresh one */
+   if (seq->ctr == CONST64(0xFFFFFFFFFFFFFFFF)) {
+      return CRYPT_OVERFLOW;
+   }
+
+   XMEMCPY(IV, seq->prefix, sizeof(seq->prefix));
+   STORE64H(seq->ctr, IV + sizeof(seq->prefix));
+   ++seq->ctr;
+
+   *IVlen = LTC_IVSEQ_IVLEN;
+   return CRYPT_OK;
+}
+
+/**
+  Terminate an IV sequencer
+  @param seq   The sequencer to terminate
+  @return CRYPT_OK if successful
+*/
+int ivseq_done(ivseq_state *seq)
+{
+   LTC_ARGCHK(seq != NULL);
+   zeromem(seq, sizeof(*seq));
+   return CRYPT_OK;
+}
+
+/**
+  Self-test the IV sequencer
+  @return CRYPT_OK if successful, CRYPT_NOP if self-testing has been disabled
+*/
+int ivseq_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   ivseq_state   seq;
+   unsigned char iv[LTC_IVSEQ_IVLEN];
+   unsigned long ivlen;
+   unsigned char t1[] = { 0xde, 0xad, 0xbe, 0xef, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+   unsigned char t2[] = { 0xde, 0xad, 0xbe, 0xef, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+   seq.prefix[0] = 0xde; seq.prefix[1] = 0xad;
+   seq.prefix[2] = 0xbe; seq.prefix[3] = 0xef;
+   seq.ctr = 0;
+
+   ivlen = sizeof(iv);
+   if (ivseq_next(&seq, iv, &ivlen) != CRYPT_OK || ivlen != LTC_IVSEQ_IVLEN) return CRYPT_FAIL_TESTVECTOR;
+   if (compare_testvector(iv, ivlen, t1, sizeof(t1), "IVSEQ", 1)) return CRYPT_FAIL_TESTVECTOR;
+
+   ivlen = sizeof(iv);
+   if (ivseq_next(&seq, iv, &ivlen) != CRYPT_OK) return CRYPT_FAIL_TESTVECTOR;
+   if (compare_testvector(iv, ivlen, t2, sizeof(t2), "IVSEQ", 2)) return CRYPT_FAIL_TESTVECTOR;
+
+   /* counter space exhausted -> refuse to wrap */
+   seq.ctr = CONST64(0xFFFFFFFFFFFFFFFF);
+   ivlen = sizeof(iv);
+   if (ivseq_next(&seq, iv, &ivlen) != CRYPT_OVERFLOW) return CRYPT_FAIL_TESTVECTOR;
+
+   return ivseq_done(&seq);
+#endif
+}
+
+#endif /* LTC_IVSEQ */
+
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
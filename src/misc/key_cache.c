@@ -0,0 +1,160 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file key_cache.c
+  Process-wide cache of expanded symmetric keys.  Connection churn
+  tends to hand cbc_start/ctr_start/gcm_init/xts_start the same session
+  key many times within microseconds; each call used to re-run the
+  cipher's key schedule.  The mode *_start functions now route their
+  setup through cipher_setup_cached(), which keeps a small LRU of
+  scheduled keys indexed by (cipher, key bytes, key length, rounds) and
+  copies a hit into the caller's symmetric_key instead of re-expanding.
+
+  Entries are allocated on first use, key lookups compare in constant
+  time, eviction and cipher_key_cache_purge() wipe before freeing, and
+  the cache is mutex protected when LTC_PTHREAD is in play.  Callers
+  that key off long-lived secrets should purge once the secrets are
+  retired, since cached copies otherwise live until evicted.
+*/
+
+#ifdef LTC_KEY_CACHE
+
+struct s_kc_entry {
+   int           cipher;
+   int           keylen;
+   int           num_rounds;
+   unsigned char key[LTC_KEY_CACHE_MAXKEY];
+   symmetric_key skey;
+   ulong64       stamp;       /* LRU clock at last touch */
+};
+
+LTC_MUTEX_GLOBAL(ltc_key_cache_mutex)
+
+static struct s_kc_entry *s_kc[LTC_KEY_CACHE_SIZE];
+static ulong64            s_kc_clock;
+static ulong64            s_kc_hits, s_kc_misses;
+
+/**
+   Schedule a key, consulting the global cache first
+   @param cipher      The index of the cipher
+   @param key         The secret key
+   @param keylen      The length of the key (octets)
+   @param num_rounds  Number of rounds (0 for default)
+   @param skey        [out] The scheduled key
+   @return CRYPT_OK if successful
+*/
+int cipher_setup_cached(int cipher, const unsigned char *key, int keylen,
+                        int num_rounds, symmetric_key *skey)
+{
+   struct s_kc_entry *e;
+   int x, victim, err;
+
+   LTC_ARGCHK(key  != NULL);
+   LTC_ARGCHK(skey != NULL);
+   if ((err = cipher_is_valid(cipher)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* oversized keys (LRW-style concatenations) bypass the cache */
+   if (keylen <= 0 || keylen > LTC_KEY_CACHE_MAXKEY) {
+      return cipher_descriptor[cipher].setup(key, keylen, num_rounds, skey);
+   }
+
+   LTC_MUTEX_LOCK(&ltc_key_cache_mutex);
+   for (x = 0; x < LTC_KEY_CACHE_SIZE; x++) {
+      e = s_kc[x];
+      if (e != NULL && e->cipher == cipher && e->keylen == keylen &&
+          e->num_rounds == num_rounds &&
+          mem_neq(e->key, key, (unsigned long)keylen) == 0) {
+         XMEMCPY(skey, &e->skey, sizeof(*skey));
+         e->stamp = ++s_kc_clock;
+         s_kc_hits++;
+         LTC_MUTEX_UNLOCK(&ltc_key_cache_mutex);
+         return CRYPT_OK;
+      }
+   }
+   s_kc_misses++;
+   LTC_MUTEX_UNLOCK(&ltc_key_cache_mutex);
+
+   /* expand outside the lock so concurrent misses don't serialize */
+   if ((err = cipher_descriptor[cipher].setup(key, keylen, num_rounds, skey)) != CRYPT_OK) {
+      return err;
+   }
+
+   LTC_MUTEX_LOCK(&ltc_key_cache_mutex);
+   victim = 0;
+   for (x = 0; x < LTC_KEY_CACHE_SIZE; x++) {
+      if (s_kc[x] == NULL) { victim = x; break; }
+      if (s_kc[x]->stamp < s_kc[victim]->stamp) { victim = x; }
+   }
+   e = s_kc[victim];
+   if (e == NULL) {
+      e = XMALLOC_ALIGNED(sizeof(*e), 64);
+      if (e == NULL) {
+         /* the schedule is already in *skey; just skip caching it */
+         LTC_MUTEX_UNLOCK(&ltc_key_cache_mutex);
+         return CRYPT_OK;
+      }
+      s_kc[victim] = e;
+   }
+   e->cipher     = cipher;
+   e->keylen     = keylen;
+   e->num_rounds = num_rounds;
+   zeromem(e->key, sizeof(e->key));
+   XMEMCPY(e->key, key, (unsigned long)keylen);
+   XMEMCPY(&e->skey, skey, sizeof(*skey));
+   e->stamp = ++s_kc_clock;
+   LTC_MUTEX_UNLOCK(&ltc_key_cache_mutex);
+   return CRYPT_OK;
+}
+
+/**
+   Wipe and release every cached key schedule
+   @return CRYPT_OK if successful
+*/
+int cipher_key_cache_purge(void)
+{
+   int x;
+   LTC_MUTEX_LOCK(&ltc_key_cache_mutex);
+   for (x = 0; x < LTC_KEY_CACHE_SIZE; x++) {
+      if (s_kc[x] != NULL) {
+         zeromem(s_kc[x], sizeof(*s_kc[x]));
+         XFREE_ALIGNED(s_kc[x]);
+         s_kc[x] = NULL;
+      }
+   }
+   s_kc_clock  = 0;
+   s_kc_hits   = 0;
+   s_kc_misses = 0;
+   LTC_MUTEX_UNLOCK(&ltc_key_cache_mutex);
+   return CRYPT_OK;
+}
+
+/**
+   Read the cache hit/miss counters (either pointer may be NULL)
+   @param hits    [out] Number of lookups served from the cache
+   @param misses  [out] Number of lookups that ran the key schedule
+*/
+void cipher_key_cache_stats(ulong64 *hits, ulong64 *misses)
+{
+   LTC_MUTEX_LOCK(&ltc_key_cache_mutex);
+   if (hits   != NULL) *hits   = s_kc_hits;
+   if (misses != NULL) *misses = s_kc_misses;
+   LTC_MUTEX_UNLOCK(&ltc_key_cache_mutex);
+}
+
+#endif /* LTC_KEY_CACHE */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,211 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file mem_accounting.c
+  Allocator accounting shim for the XMALLOC hooks, Tom St Denis
+
+  Build with LTC_MEM_ACCOUNTING and point XMALLOC/XREALLOC/XCALLOC/
+  XFREE (tomcrypt_custom.h) at the ltc_acct_* functions below and every
+  library allocation is counted: live and peak bytes plus call counts,
+  globally and bucketed by tag.  Allocating entry points mark their
+  bucket with LTC_MEM_TAG("der") etc. before their first allocation;
+  the tag sticks until the next mark, so untagged helpers called from a
+  tagged function are charged to their caller -- the right answer for
+  sizing -- and anything outside a tagged path lands in the "other"
+  bucket.  Each block carries a small header recording its size and
+  bucket, so frees always debit the bucket that was charged, whatever
+  tag is current.
+
+  Math-provider allocations only appear here if the provider's own
+  allocator hooks are pointed at these functions too; tag "mp" is
+  reserved for that use.
+
+  This is a sizing and churn-hunting tool: the header costs
+  2*sizeof(size_t) per block and every operation takes the accounting
+  mutex, so leave it out of production builds.
+*/
+
+#ifdef LTC_MEM_ACCOUNTING
+
+#include <stdlib.h>
+
+/* header prepended to every block; kept a multiple of the strictest
+   alignment so user pointers stay aligned */
+typedef union {
+   struct { size_t size; size_t tag; } h;
+   ulong64 pad[2];
+} acct_hdr;
+
+#define LTC_MACCT_TAGS 16
+
+LTC_MUTEX_GLOBAL(ltc_macct_mutex)
+
+static const char   *macct_name[LTC_MACCT_TAGS] = { "other" };
+static ltc_mem_acct  macct_tab[LTC_MACCT_TAGS];
+static ltc_mem_acct  macct_all;
+static size_t        macct_cur = 0;   /* bucket charged by the next alloc */
+
+/* find (or create) the bucket for a tag; 0 when the table is full */
+static size_t macct_lookup(const char *tag)
+{
+   size_t i;
+   for (i = 0; i < LTC_MACCT_TAGS && macct_name[i] != NULL; i++) {
+      if (XSTRCMP(macct_name[i], tag) == 0) {
+         return i;
+      }
+   }
+   if (i < LTC_MACCT_TAGS) {
+      macct_name[i] = tag;
+      return i;
+   }
+   return 0;
+}
+
+/**
+  Mark the bucket subsequent allocations are charged to
+  @param tag   Bucket name (a string literal); NULL reverts to "other"
+*/
+void ltc_mem_acct_tag(const char *tag)
+{
+   LTC_MUTEX_LOCK(&ltc_macct_mutex);
+   macct_cur = (tag == NULL) ? 0 : macct_lookup(tag);
+   LTC_MUTEX_UNLOCK(&ltc_macct_mutex);
+}
+
+static void macct_charge(ltc_mem_acct *a, size_t n)
+{
+   a->allocs++;
+   a->live_bytes += n;
+   if (a->live_bytes > a->peak_bytes) {
+      a->peak_bytes = a->live_bytes;
+   }
+}
+
+void *ltc_acct_malloc(size_t n)
+{
+   acct_hdr *h = malloc(sizeof(*h) + n);
+   if (h == NULL) {
+      return NULL;
+   }
+   LTC_MUTEX_LOCK(&ltc_macct_mutex);
+   h->h.size = n;
+   h->h.tag  = macct_cur;
+   macct_charge(&macct_tab[macct_cur], n);
+   macct_charge(&macct_all, n);
+   LTC_MUTEX_UNLOCK(&ltc_macct_mutex);
+   return h + 1;
+}
+
+void *ltc_acct_calloc(size_t n, size_t s)
+{
+   void *p;
+   if (s != 0 && n > ((size_t)-1 - sizeof(acct_hdr)) / s) {
+      return NULL;
+   }
+   p = ltc_acct_malloc(n * s);
+   if (p != NULL) {
+      XMEMSET(p, 0, n * s);
+   }
+   return p;
+}
+
+void *ltc_acct_realloc(void *p, size_t n)
+{
+   acct_hdr *h;
+   size_t old, tag;
+   if (p == NULL) {
+      return ltc_acct_malloc(n);
+   }
+   h = (acct_hdr *)p - 1;
+   old = h->h.size;
+   tag = h->h.tag;
+   h = realloc(h, sizeof(*h) + n);
+   if (h == NULL) {
+      return NULL;
+   }
+   LTC_MUTEX_LOCK(&ltc_macct_mutex);
+   h->h.size = n;
+   macct_tab[tag].reallocs++;
+   macct_tab[tag].live_bytes += n - old;
+   if (macct_tab[tag].live_bytes > macct_tab[tag].peak_bytes) {
+      macct_tab[tag].peak_bytes = macct_tab[tag].live_bytes;
+   }
+   macct_all.reallocs++;
+   macct_all.live_bytes += n - old;
+   if (macct_all.live_bytes > macct_all.peak_bytes) {
+      macct_all.peak_bytes = macct_all.live_bytes;
+   }
+   LTC_MUTEX_UNLOCK(&ltc_macct_mutex);
+   return h + 1;
+}
+
+void ltc_acct_free(void *p)
+{
+   acct_hdr *h;
+   if (p == NULL) {
+      return;
+   }
+   h = (acct_hdr *)p - 1;
+   LTC_MUTEX_LOCK(&ltc_macct_mutex);
+   macct_tab[h->h.tag].frees++;
+   macct_tab[h->h.tag].live_bytes -= h->h.size;
+   macct_all.frees++;
+   macct_all.live_bytes -= h->h.size;
+   LTC_MUTEX_UNLOCK(&ltc_macct_mutex);
+   free(h);
+}
+
+/**
+  Snapshot one bucket (or the global totals)
+  @param tag   Bucket name, or NULL for the totals across all buckets
+  @param out   [out] Where to store the counters
+  @return CRYPT_OK if successful, CRYPT_INVALID_ARG on an unknown tag
+*/
+int ltc_mem_acct_get(const char *tag, ltc_mem_acct *out)
+{
+   size_t i;
+   LTC_ARGCHK(out != NULL);
+   LTC_MUTEX_LOCK(&ltc_macct_mutex);
+   if (tag == NULL) {
+      *out = macct_all;
+      LTC_MUTEX_UNLOCK(&ltc_macct_mutex);
+      return CRYPT_OK;
+   }
+   for (i = 0; i < LTC_MACCT_TAGS && macct_name[i] != NULL; i++) {
+      if (XSTRCMP(macct_name[i], tag) == 0) {
+         *out = macct_tab[i];
+         LTC_MUTEX_UNLOCK(&ltc_macct_mutex);
+         return CRYPT_OK;
+      }
+   }
+   LTC_MUTEX_UNLOCK(&ltc_macct_mutex);
+   return CRYPT_INVALID_ARG;
+}
+
+/**
+  Zero every counter; live blocks keep their headers so later frees
+  may drive live_bytes of a bucket below zero -- reset when idle
+*/
+void ltc_mem_acct_reset(void)
+{
+   LTC_MUTEX_LOCK(&ltc_macct_mutex);
+   XMEMSET(macct_tab, 0, sizeof(macct_tab));
+   XMEMSET(&macct_all, 0, sizeof(macct_all));
+   LTC_MUTEX_UNLOCK(&ltc_macct_mutex);
+}
+
+#endif /* LTC_MEM_ACCOUNTING */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
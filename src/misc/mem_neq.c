@@ -23,6 +23,10 @@
    if the memory is equal or not - you can not determine by how much the
    first different byte differs.
 
+   The comparison stays constant time: the word-wide path accumulates
+   XOR differences exactly like the byte loop, just more of them per
+   step, and never branches on the data.
+
    @param a     The first memory region
    @param b     The second memory region
    @param len   The length of the area to compare (octets)
@@ -41,6 +45,33 @@ int mem_neq(const void *a, const void *b, size_t len)
    pa = a;
    pb = b;
 
+#ifdef LTC_FAST
+   /* word-wide when both pointers share alignment; short lengths (MAC
+    * tags are 16 bytes) still benefit from the one or two word loads */
+   if (len >= sizeof(LTC_FAST_TYPE) &&
+       ((((unsigned long)pa) ^ ((unsigned long)pb)) & (sizeof(LTC_FAST_TYPE) - 1)) == 0) {
+      LTC_FAST_TYPE wret = 0;
+      unsigned int  i;
+      while ((((unsigned long)pa) & (sizeof(LTC_FAST_TYPE) - 1)) != 0 && len > 0) {
+         ret |= *pa ^ *pb;
+         ++pa;
+         ++pb;
+         --len;
+      }
+      while (len >= sizeof(LTC_FAST_TYPE)) {
+         wret |= *(const LTC_FAST_TYPE *)(const void *)pa ^
+                 *(const LTC_FAST_TYPE *)(const void *)pb;
+         pa  += sizeof(LTC_FAST_TYPE);
+         pb  += sizeof(LTC_FAST_TYPE);
+         len -= sizeof(LTC_FAST_TYPE);
+      }
+      /* fold the word accumulator into the byte accumulator */
+      for (i = 0; i < sizeof(LTC_FAST_TYPE); i++) {
+         ret |= (unsigned char)(wret >> (8 * i));
+      }
+   }
+#endif
+
    while (len-- > 0) {
       ret |= *pa ^ *pb;
       ++pa;
@@ -0,0 +1,218 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include <tomcrypt.h>
+
+/**
+  @file mhkdf.c
+  Memory-hard key derivation (scrypt-style ROMix over the hash
+  descriptors), by Tom St Denis
+
+  Layout follows scrypt: an HMAC extract step seeds p independent
+  lanes, each lane runs a sequential memory-hard mix over cost blocks
+  of hashsize octets, and the lane outputs are folded back through
+  HMAC/HKDF into the requested output.  Each lane needs
+  cost * hashsize octets of scratch, and because the second ROMix pass
+  reads the scratch at data-dependent indices an attacker must either
+  keep all of it or recompute -- the usual memory/time trade-off.
+
+  Lanes share nothing, so with LTC_MHKDF_CONCURRENT (requires
+  LTC_PTHREAD) each extra lane runs on its own thread and the wall
+  clock stays put while the memory bill scales with p.  Without it the
+  lanes run back to back with identical results.
+*/
+
+#ifdef LTC_MHKDF
+
+#ifdef LTC_MHKDF_CONCURRENT
+#include <pthread.h>
+#endif
+
+/* one lane's worth of work; self-contained so a worker thread can run
+ * it via pthread_create */
+struct mhkdf_lane {
+   int            hash_idx;
+   unsigned long  cost, hs;
+   unsigned char  X[MAXBLOCKSIZE];  /* in: lane seed, out: lane result */
+   int            err;
+};
+
+static void *s_mhkdf_lane(void *arg)
+{
+   struct mhkdf_lane *l = arg;
+   unsigned char *V;
+   unsigned long  j, k, outlen;
+   int            err;
+   ulong32        idx;
+
+   V = XMALLOC(l->cost * l->hs);
+   if (V == NULL) {
+      l->err = CRYPT_MEM;
+      return NULL;
+   }
+
+   /* fill pass: V[0] = seed, V[j] = H(V[j-1]) */
+   XMEMCPY(V, l->X, l->hs);
+   for (j = 1; j < l->cost; j++) {
+      outlen = l->hs;
+      if ((err = hash_memory(l->hash_idx, V + (j-1)*l->hs, l->hs,
+                             V + j*l->hs, &outlen)) != CRYPT_OK) {
+         goto error;
+      }
+   }
+
+   /* mix pass: data-dependent reads force the memory to stay hot */
+   XMEMCPY(l->X, V + (l->cost - 1)*l->hs, l->hs);
+   for (j = 0; j < l->cost; j++) {
+      LOAD32L(idx, l->X);
+      idx %= (ulong32)l->cost;
+      for (k = 0; k < l->hs; k++) {
+         l->X[k] ^= V[idx * l->hs + k];
+      }
+      outlen = l->hs;
+      if ((err = hash_memory(l->hash_idx, l->X, l->hs, l->X, &outlen)) != CRYPT_OK) {
+         goto error;
+      }
+   }
+   err = CRYPT_OK;
+error:
+   zeromem(V, l->cost * l->hs);
+   XFREE(V);
+   l->err = err;
+   return NULL;
+}
+
+/**
+  Memory-hard password-based key derivation
+
+  @param hash_idx       The index of the hash to build on
+  @param password       The password
+  @param password_len   The length of the password (octets)
+  @param salt           The salt
+  @param salt_len       The length of the salt (octets)
+  @param cost           Scratch blocks per lane; memory per lane is
+                        cost * hashsize octets (at least 2)
+  @param lanes          Parallel lanes (1..255); raising lanes raises
+                        the total memory bill, not the wall clock,
+                        when LTC_MHKDF_CONCURRENT is compiled in
+  @param out            [out] The derived key
+  @param outlen         The length of the derived key (octets)
+  @return CRYPT_OK on success
+*/
+int mhkdf(int hash_idx,
+          const unsigned char *password, unsigned long password_len,
+          const unsigned char *salt,     unsigned long salt_len,
+                unsigned long  cost,     unsigned int  lanes,
+                unsigned char *out,      unsigned long outlen)
+{
+   struct mhkdf_lane *l;
+   unsigned char      prk[MAXBLOCKSIZE], lbl[8];
+   unsigned char     *Y;
+   unsigned long      hs, x, prklen;
+   unsigned int       i;
+   int                err;
+
+   LTC_ARGCHK(password != NULL);
+   LTC_ARGCHK(salt     != NULL);
+   LTC_ARGCHK(out      != NULL);
+
+   if ((err = hash_is_valid(hash_idx)) != CRYPT_OK) {
+      return err;
+   }
+   hs = hash_descriptor[hash_idx].hashsize;
+   if (cost < 2 || cost > (0x7FFFFFFFUL / hs) ||
+       lanes < 1 || lanes > 255 ||
+       outlen < 1 || outlen > hs * 255) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   l = XMALLOC(sizeof(*l) * lanes);
+   Y = XMALLOC(hs * lanes);
+   if (l == NULL || Y == NULL) {
+      if (l != NULL) XFREE(l);
+      if (Y != NULL) XFREE(Y);
+      return CRYPT_MEM;
+   }
+
+   /* extract: PRK = HMAC(password, salt), then seed each lane with
+    * HMAC(PRK, "lane" || LE32(i)) so lanes are independent */
+   prklen = sizeof(prk);
+   if ((err = hmac_memory(hash_idx, password, password_len,
+                          salt, salt_len, prk, &prklen)) != CRYPT_OK) {
+      goto error;
+   }
+   XMEMCPY(lbl, "lane", 4);
+   for (i = 0; i < lanes; i++) {
+      unsigned long xl = sizeof(l[i].X);
+      STORE32L((ulong32)i, lbl + 4);
+      if ((err = hmac_memory(hash_idx, prk, prklen, lbl, 8,
+                             l[i].X, &xl)) != CRYPT_OK) {
+         goto error;
+      }
+      l[i].hash_idx = hash_idx;
+      l[i].cost     = cost;
+      l[i].hs       = hs;
+      l[i].err      = CRYPT_OK;
+   }
+
+#ifdef LTC_MHKDF_CONCURRENT
+   {
+      pthread_t tid[255];
+      int       spawned[255];
+      for (i = 1; i < lanes; i++) {
+         spawned[i] = (pthread_create(&tid[i], NULL, s_mhkdf_lane, &l[i]) == 0);
+      }
+      s_mhkdf_lane(&l[0]);
+      for (i = 1; i < lanes; i++) {
+         if (spawned[i]) {
+            pthread_join(tid[i], NULL);
+         } else {
+            /* thread did not start; run the lane here */
+            s_mhkdf_lane(&l[i]);
+         }
+      }
+   }
+#else
+   for (i = 0; i < lanes; i++) {
+      s_mhkdf_lane(&l[i]);
+   }
+#endif
+   for (i = 0; i < lanes; i++) {
+      if (l[i].err != CRYPT_OK) {
+         err = l[i].err;
+         goto error;
+      }
+      XMEMCPY(Y + (unsigned long)i * hs, l[i].X, hs);
+   }
+
+   /* fold the lane results back through the PRK and expand */
+   x = sizeof(prk);
+   if ((err = hmac_memory(hash_idx, prk, prklen, Y, hs * lanes,
+                          prk, &x)) != CRYPT_OK) {
+      goto error;
+   }
+   err = hkdf_expand(hash_idx, NULL, 0, prk, x, out, outlen);
+
+error:
+   zeromem(prk, sizeof(prk));
+   zeromem(Y, hs * lanes);
+   for (x = 0; x < lanes; x++) {
+      zeromem(l[x].X, sizeof(l[x].X));
+   }
+   XFREE(Y);
+   XFREE(l);
+   return err;
+}
+
+#endif /* LTC_MHKDF */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,88 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include <tomcrypt.h>
+
+/**
+  @file mhkdf_test.c
+  Memory-hard KDF self test, by Tom St Denis
+*/
+
+#ifdef LTC_MHKDF
+
+/**
+  Test the memory-hard KDF
+  @return CRYPT_OK on success
+*/
+int mhkdf_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   /* mhkdf is our own construction, so the vector below is a
+    * regression anchor generated from the implementation at
+    * introduction time rather than an external KAT; what it pins down
+    * is that lane seeding, the two ROMix passes and the final fold
+    * never silently change shape */
+   static const unsigned char expect[32] = {
+      0x0f,0xb0,0x96,0xb0,0xb6,0x88,0xea,0x37,
+      0x74,0x64,0x0e,0xc6,0xf9,0x70,0x8e,0x8c,
+      0x16,0x1d,0x35,0x9e,0x4a,0x34,0x30,0xb0,
+      0xea,0xf2,0xcc,0x8d,0x87,0x1d,0xfd,0xfe };
+   const unsigned char pw[]   = "password";
+   const unsigned char salt[] = "NaCl";
+   unsigned char out[32], out2[32];
+   int hash, err;
+
+   hash = find_hash("sha256");
+   if (hash == -1) {
+      return CRYPT_NOP;
+   }
+
+   if ((err = mhkdf(hash, pw, 8, salt, 4, 16, 4, out, sizeof(out))) != CRYPT_OK) {
+      return err;
+   }
+   if (compare_testvector(out, sizeof(out), expect, sizeof(expect),
+                          "MHKDF", 0) != 0) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+
+   /* deterministic */
+   if ((err = mhkdf(hash, pw, 8, salt, 4, 16, 4, out2, sizeof(out2))) != CRYPT_OK) {
+      return err;
+   }
+   if (compare_testvector(out2, sizeof(out2), out, sizeof(out),
+                          "MHKDF-DET", 0) != 0) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+
+   /* the lane count is part of the derivation */
+   if ((err = mhkdf(hash, pw, 8, salt, 4, 16, 2, out2, sizeof(out2))) != CRYPT_OK) {
+      return err;
+   }
+   if (XMEMCMP(out2, out, sizeof(out)) == 0) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+
+   /* degenerate parameters must be refused */
+   if (mhkdf(hash, pw, 8, salt, 4, 1, 4, out, sizeof(out)) != CRYPT_INVALID_ARG ||
+       mhkdf(hash, pw, 8, salt, 4, 16, 0, out, sizeof(out)) != CRYPT_INVALID_ARG) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+
+   return CRYPT_OK;
+#endif
+}
+
+#endif /* LTC_MHKDF */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
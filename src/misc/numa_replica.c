@@ -0,0 +1,146 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file numa_replica.c
+  Per-NUMA-node replication of read-only crypto contexts, Tom St Denis
+
+  On multi-socket machines a single shared gcm_precomp (or any other
+  precomputed, read-only context) bounces its cache lines across the
+  interconnect whenever both sockets work the same key.  An
+  ltc_replica_set wraps such a context: ltc_replica_get() hands back a
+  copy that lives on the calling thread's node, cloning it lazily on
+  first use there.  Because the clone is allocated and written by a
+  thread already running on that node, first-touch placement makes the
+  copy node-local without any libnuma dependency; off Linux (or when
+  the node cannot be determined) everything degrades to the master
+  copy.
+
+  Only flat, read-only state is replicable this way -- GCM H/PC
+  tables, scheduled keys, HMAC midstates.  Mutable state (Fortuna
+  pools, live mode states) must not go through this API; give each
+  node its own instance instead.
+
+  Typical use with GCM:
+     ltc_replica_init(&set, &pre, sizeof(pre));
+     ...per request, on any thread...
+     ltc_replica_get(&set, &p);
+     gcm_init_ex(&gcm, (gcm_precomp *)p);
+*/
+
+#ifdef LTC_NUMA_REPLICA
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+/**
+   NUMA node of the calling thread
+   @return The node number, 0 when it cannot be determined
+*/
+int ltc_numa_node(void)
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+   unsigned cpu, node;
+   if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0 &&
+       node < LTC_NUMA_MAX_NODES) {
+      return (int)node;
+   }
+#endif
+   return 0;
+}
+
+/**
+   Wrap a read-only context for per-node replication
+   @param set     The replica set to initialize
+   @param master  The context to replicate (must stay valid and unchanged)
+   @param size    Its length in octets
+   @return CRYPT_OK on success
+*/
+int ltc_replica_init(ltc_replica_set *set, const void *master, unsigned long size)
+{
+   LTC_ARGCHK(set    != NULL);
+   LTC_ARGCHK(master != NULL);
+   if (size == 0) {
+      return CRYPT_INVALID_ARG;
+   }
+   zeromem(set, sizeof(*set));
+   set->master = master;
+   set->size   = size;
+   LTC_MUTEX_INIT(&set->lock)
+   return CRYPT_OK;
+}
+
+/**
+   Fetch the calling thread's node-local copy of the context
+   @param set   The replica set
+   @param ctx   [out] Points at the node-local (or master) copy
+   @return CRYPT_OK on success
+*/
+int ltc_replica_get(ltc_replica_set *set, const void **ctx)
+{
+   int node;
+
+   LTC_ARGCHK(set != NULL);
+   LTC_ARGCHK(ctx != NULL);
+
+   node = ltc_numa_node();
+   if (node == 0) {
+      /* the master was (presumably) built on node 0; no copy needed */
+      *ctx = set->master;
+      return CRYPT_OK;
+   }
+
+   LTC_MUTEX_LOCK(&set->lock);
+   if (set->replica[node] == NULL) {
+      /* allocated and written here, so first touch lands on this node */
+      void *copy = XMALLOC_ALIGNED(set->size, 64);
+      if (copy == NULL) {
+         LTC_MUTEX_UNLOCK(&set->lock);
+         *ctx = set->master;  /* degraded, not broken */
+         return CRYPT_OK;
+      }
+      XMEMCPY(copy, set->master, set->size);
+      set->replica[node] = copy;
+   }
+   *ctx = set->replica[node];
+   LTC_MUTEX_UNLOCK(&set->lock);
+   return CRYPT_OK;
+}
+
+/**
+   Release every replica (the master is the caller's to free)
+   @param set   The replica set
+   @return CRYPT_OK on success
+*/
+int ltc_replica_done(ltc_replica_set *set)
+{
+   int i;
+   LTC_ARGCHK(set != NULL);
+   for (i = 0; i < LTC_NUMA_MAX_NODES; i++) {
+      if (set->replica[i] != NULL) {
+         zeromem(set->replica[i], set->size);
+         XFREE_ALIGNED(set->replica[i]);
+         set->replica[i] = NULL;
+      }
+   }
+   set->master = NULL;
+   set->size   = 0;
+   return CRYPT_OK;
+}
+
+#endif /* LTC_NUMA_REPLICA */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
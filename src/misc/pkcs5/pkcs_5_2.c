@@ -36,8 +36,9 @@ int pkcs_5_alg2(const unsigned char *password, unsigned long password_len,
    int err, itts;
    ulong32  blkno;
    unsigned long stored, left, x, y;
-   unsigned char *buf[2];
-   hmac_state    *hmac;
+   unsigned char buf[2][MAXBLOCKSIZE];
+   hmac_state       hmac;
+   hmac_precomputed pre;
 
    LTC_ARGCHK(password != NULL);
    LTC_ARGCHK(salt     != NULL);
@@ -49,50 +50,54 @@ int pkcs_5_alg2(const unsigned char *password, unsigned long password_len,
       return err;
    }
 
-   buf[0] = XMALLOC(MAXBLOCKSIZE * 2);
-   hmac   = XMALLOC(sizeof(hmac_state));
-   if (hmac == NULL || buf[0] == NULL) {
-      if (hmac != NULL) {
-         XFREE(hmac);
-      }
-      if (buf[0] != NULL) {
-         XFREE(buf[0]);
-      }
-      return CRYPT_MEM;
+   /* everything lives on the stack: key derivation runs in the
+    * malloc-averse setup paths, so the helper performs no heap
+    * allocation at all */
+
+   /* hash the password's padded key blocks once; every PRF call below
+    * is then keyed by struct copy and each iteration costs only the
+    * inner and outer finalization */
+   if ((err = hmac_precompute(&pre, hash_idx, password, password_len)) != CRYPT_OK) {
+      goto LBL_ERR;
    }
-   /* buf[1] points to the second block of MAXBLOCKSIZE bytes */
-   buf[1] = buf[0] + MAXBLOCKSIZE;
 
    left   = *outlen;
    blkno  = 1;
    stored = 0;
    while (left != 0) {
        /* process block number blkno */
-       zeromem(buf[0], MAXBLOCKSIZE*2);
+       zeromem(buf, sizeof(buf));
 
        /* store current block number and increment for next pass */
        STORE32H(blkno, buf[1]);
        ++blkno;
 
        /* get PRF(P, S||int(blkno)) */
-       if ((err = hmac_init(hmac, hash_idx, password, password_len)) != CRYPT_OK) {
+       if ((err = hmac_init_from_precomputed(&hmac, &pre)) != CRYPT_OK) {
           goto LBL_ERR;
        }
-       if ((err = hmac_process(hmac, salt, salt_len)) != CRYPT_OK) {
+       if ((err = hmac_process(&hmac, salt, salt_len)) != CRYPT_OK) {
           goto LBL_ERR;
        }
-       if ((err = hmac_process(hmac, buf[1], 4)) != CRYPT_OK) {
+       if ((err = hmac_process(&hmac, buf[1], 4)) != CRYPT_OK) {
           goto LBL_ERR;
        }
        x = MAXBLOCKSIZE;
-       if ((err = hmac_done(hmac, buf[0], &x)) != CRYPT_OK) {
+       if ((err = hmac_done(&hmac, buf[0], &x)) != CRYPT_OK) {
           goto LBL_ERR;
        }
 
        /* now compute repeated and XOR it in buf[1] */
        XMEMCPY(buf[1], buf[0], x);
        for (itts = 1; itts < iteration_count; ++itts) {
-           if ((err = hmac_memory(hash_idx, password, password_len, buf[0], x, buf[0], &x)) != CRYPT_OK) {
+           if ((err = hmac_init_from_precomputed(&hmac, &pre)) != CRYPT_OK) {
+              goto LBL_ERR;
+           }
+           if ((err = hmac_process(&hmac, buf[0], x)) != CRYPT_OK) {
+              goto LBL_ERR;
+           }
+           x = MAXBLOCKSIZE;
+           if ((err = hmac_done(&hmac, buf[0], &x)) != CRYPT_OK) {
               goto LBL_ERR;
            }
            for (y = 0; y < x; y++) {
@@ -111,13 +116,11 @@ int pkcs_5_alg2(const unsigned char *password, unsigned long password_len,
    err = CRYPT_OK;
 LBL_ERR:
 #ifdef LTC_CLEAN_STACK
-   zeromem(buf[0], MAXBLOCKSIZE*2);
-   zeromem(hmac, sizeof(hmac_state));
+   zeromem(buf, sizeof(buf));
+   zeromem(&hmac, sizeof(hmac));
+   zeromem(&pre, sizeof(pre));
 #endif
 
-   XFREE(hmac);
-   XFREE(buf[0]);
-
    return err;
 }
 
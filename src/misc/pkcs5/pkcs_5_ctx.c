@@ -0,0 +1,293 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include <tomcrypt.h>
+
+/**
+   @file pkcs_5_ctx.c
+   PKCS #5, reusable derivation contexts, Tom St Denis
+
+   The one-shot pkcs_5_alg1/pkcs_5_alg2 entry points copy the password
+   into fresh buffers (and, for v2, re-hash its padded HMAC key blocks)
+   on every call.  A credential-migration batch deriving millions of
+   keys wants that paid once: pkcs_5_init() takes a single copy of
+   password and salt and, for v2, folds the password into an HMAC
+   midstate; pkcs_5_derive() then writes into caller storage with no
+   heap allocation at all.  pkcs_5_derive_salt() re-derives under a
+   different salt for jobs that fix the password and vary the salt per
+   record.  The context path also processes the caller's full salt
+   length for algorithm 1, unlike pkcs_5_alg1 which is pinned to the 8
+   octets of the original spec.
+*/
+#ifdef LTC_PKCS_5
+
+/**
+   Set up a reusable PKCS #5 derivation context
+   @param kdf              The context to initialize
+   @param alg              LTC_PKCS_5_V1, LTC_PKCS_5_V1_OPENSSL or LTC_PKCS_5_V2
+   @param password         The password (one copy is taken)
+   @param password_len     The length of the password (octets)
+   @param salt             The default salt (one copy is taken)
+   @param salt_len         The length of the salt (octets)
+   @param iteration_count  The iteration count
+   @param hash_idx         The index of the hash desired
+   @return CRYPT_OK if successful
+*/
+int pkcs_5_init(pkcs_5_state *kdf, int alg,
+                const unsigned char *password, unsigned long password_len,
+                const unsigned char *salt,     unsigned long salt_len,
+                int iteration_count, int hash_idx)
+{
+   int err;
+
+   LTC_ARGCHK(kdf      != NULL);
+   LTC_ARGCHK(password != NULL);
+   LTC_ARGCHK(salt     != NULL);
+
+   if (alg != LTC_PKCS_5_V1 && alg != LTC_PKCS_5_V1_OPENSSL &&
+       alg != LTC_PKCS_5_V2) {
+      return CRYPT_INVALID_ARG;
+   }
+   if (iteration_count < 1) {
+      return CRYPT_INVALID_ARG;
+   }
+   if ((err = hash_is_valid(hash_idx)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* one block holds password||salt; the +1 keeps the request nonzero
+      for empty inputs */
+   kdf->password = XMALLOC(password_len + salt_len + 1);
+   if (kdf->password == NULL) {
+      return CRYPT_MEM;
+   }
+   XMEMCPY(kdf->password, password, password_len);
+   kdf->salt = kdf->password + password_len;
+   XMEMCPY(kdf->salt, salt, salt_len);
+
+   kdf->alg             = alg;
+   kdf->hash_idx        = hash_idx;
+   kdf->iteration_count = iteration_count;
+   kdf->password_len    = password_len;
+   kdf->salt_len        = salt_len;
+
+   if (alg == LTC_PKCS_5_V2) {
+      /* hash the password's padded HMAC key blocks once up front */
+      if ((err = hmac_precompute(&kdf->pre, hash_idx, password, password_len)) != CRYPT_OK) {
+         zeromem(kdf->password, password_len + salt_len + 1);
+         XFREE(kdf->password);
+         kdf->password = NULL;
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+/* algorithm 1 off the context: the _pkcs_5_alg1_common loop with the
+   scratch on the stack and the salt taken at its real length */
+static int s_pkcs_5_v1_derive(pkcs_5_state *kdf,
+                              const unsigned char *salt, unsigned long salt_len,
+                              unsigned char *out, unsigned long *outlen)
+{
+   hash_state    md;
+   unsigned char buf[MAXBLOCKSIZE];
+   unsigned long block, iter, outidx, nb, hashsize;
+   int           err, compat;
+
+   compat   = (kdf->alg == LTC_PKCS_5_V1_OPENSSL);
+   hashsize = hash_descriptor[kdf->hash_idx].hashsize;
+
+   block = 0;
+   while (block * hashsize < *outlen) {
+      /* hash initial (maybe previous hash) + password + salt */
+      if ((err = hash_descriptor[kdf->hash_idx].init(&md)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if (compat && block) {
+         if ((err = hash_descriptor[kdf->hash_idx].process(&md, buf, hashsize)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+      }
+      if ((err = hash_descriptor[kdf->hash_idx].process(&md, kdf->password, kdf->password_len)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = hash_descriptor[kdf->hash_idx].process(&md, salt, salt_len)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = hash_descriptor[kdf->hash_idx].done(&md, buf)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+
+      iter = kdf->iteration_count;
+      while (--iter) {
+         if ((err = hash_descriptor[kdf->hash_idx].init(&md)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+         if ((err = hash_descriptor[kdf->hash_idx].process(&md, buf, hashsize)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+         if ((err = hash_descriptor[kdf->hash_idx].done(&md, buf)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+      }
+
+      outidx = block * hashsize;
+      nb     = hashsize;
+      if (outidx + nb > *outlen) {
+         nb = *outlen - outidx;
+      }
+      if (nb > 0) {
+         XMEMCPY(out + outidx, buf, nb);
+      }
+
+      block++;
+      if (!compat) {
+         break;
+      }
+   }
+   if (!compat) {
+      *outlen = hashsize;
+   }
+   err = CRYPT_OK;
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(buf, sizeof(buf));
+   zeromem(&md, sizeof(md));
+#endif
+   return err;
+}
+
+/* algorithm 2 off the context: the pkcs_5_alg2 loop keyed from the
+   stored HMAC midstate */
+static int s_pkcs_5_v2_derive(pkcs_5_state *kdf,
+                              const unsigned char *salt, unsigned long salt_len,
+                              unsigned char *out, unsigned long *outlen)
+{
+   hmac_state    hmac;
+   unsigned char buf[2][MAXBLOCKSIZE];
+   unsigned long stored, left, x, y;
+   ulong32       blkno;
+   int           err, itts;
+
+   left   = *outlen;
+   blkno  = 1;
+   stored = 0;
+   while (left != 0) {
+      zeromem(buf, sizeof(buf));
+      STORE32H(blkno, buf[1]);
+      ++blkno;
+
+      /* get PRF(P, S||int(blkno)) */
+      if ((err = hmac_init_from_precomputed(&hmac, &kdf->pre)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = hmac_process(&hmac, salt, salt_len)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = hmac_process(&hmac, buf[1], 4)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      x = MAXBLOCKSIZE;
+      if ((err = hmac_done(&hmac, buf[0], &x)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+
+      XMEMCPY(buf[1], buf[0], x);
+      for (itts = 1; itts < kdf->iteration_count; ++itts) {
+         if ((err = hmac_init_from_precomputed(&hmac, &kdf->pre)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+         if ((err = hmac_process(&hmac, buf[0], x)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+         x = MAXBLOCKSIZE;
+         if ((err = hmac_done(&hmac, buf[0], &x)) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+         for (y = 0; y < x; y++) {
+            buf[1][y] ^= buf[0][y];
+         }
+      }
+
+      for (y = 0; y < x && left != 0; ++y) {
+         out[stored++] = buf[1][y];
+         --left;
+      }
+   }
+   *outlen = stored;
+   err = CRYPT_OK;
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(buf, sizeof(buf));
+   zeromem(&hmac, sizeof(hmac));
+#endif
+   return err;
+}
+
+/**
+   Derive a key under a caller-supplied salt (the stored one is ignored)
+   @param kdf        The context from pkcs_5_init()
+   @param salt       The salt for this derivation
+   @param salt_len   The length of the salt (octets)
+   @param out        [out] The destination for the derived key
+   @param outlen     [in/out] The max size and resulting size of the output
+   @return CRYPT_OK if successful
+*/
+int pkcs_5_derive_salt(pkcs_5_state *kdf,
+                       const unsigned char *salt, unsigned long salt_len,
+                       unsigned char *out, unsigned long *outlen)
+{
+   LTC_ARGCHK(kdf    != NULL);
+   LTC_ARGCHK(salt   != NULL);
+   LTC_ARGCHK(out    != NULL);
+   LTC_ARGCHK(outlen != NULL);
+   LTC_ARGCHK(kdf->password != NULL);
+
+   if (kdf->alg == LTC_PKCS_5_V2) {
+      return s_pkcs_5_v2_derive(kdf, salt, salt_len, out, outlen);
+   }
+   return s_pkcs_5_v1_derive(kdf, salt, salt_len, out, outlen);
+}
+
+/**
+   Derive a key under the salt stored at init time
+   @param kdf        The context from pkcs_5_init()
+   @param out        [out] The destination for the derived key
+   @param outlen     [in/out] The max size and resulting size of the output
+   @return CRYPT_OK if successful
+*/
+int pkcs_5_derive(pkcs_5_state *kdf, unsigned char *out, unsigned long *outlen)
+{
+   LTC_ARGCHK(kdf != NULL);
+   LTC_ARGCHK(kdf->password != NULL);
+   return pkcs_5_derive_salt(kdf, kdf->salt, kdf->salt_len, out, outlen);
+}
+
+/**
+   Wipe and release a derivation context
+   @param kdf   The context to terminate
+   @return CRYPT_OK if successful
+*/
+int pkcs_5_done(pkcs_5_state *kdf)
+{
+   LTC_ARGCHK(kdf != NULL);
+   if (kdf->password != NULL) {
+      zeromem(kdf->password, kdf->password_len + kdf->salt_len + 1);
+      XFREE(kdf->password);
+   }
+   zeromem(kdf, sizeof(*kdf));
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -251,6 +251,76 @@ int pkcs_5_test (void)
         }
     }
 
+    /* the reusable context must reproduce the one-shot outputs, and
+       keep doing so across repeated derives */
+    {
+        pkcs_5_state  kdf;
+        unsigned char DK2[40];
+        int           pass;
+
+        ++tested;
+        pass  = 1;
+        dkLen = cases_5_2[1].dkLen;
+        if (pkcs_5_init(&kdf, LTC_PKCS_5_V2,
+                        (unsigned char*)cases_5_2[1].P, cases_5_2[1].P_len,
+                        (unsigned char*)cases_5_2[1].S, cases_5_2[1].S_len,
+                        cases_5_2[1].c, hash) != CRYPT_OK) {
+            pass = 0;
+        }
+        for (i = 0; pass && i < 3; i++) {
+            dkLen = cases_5_2[1].dkLen;
+            if (pkcs_5_derive(&kdf, DK2, &dkLen) != CRYPT_OK ||
+                dkLen != cases_5_2[1].dkLen ||
+                XMEMCMP(DK2, cases_5_2[1].DK, (size_t)cases_5_2[1].dkLen) != 0) {
+                pass = 0;
+            }
+        }
+        /* a per-call salt must match the one-shot function too */
+        if (pass) {
+            dkLen = cases_5_2[0].dkLen;
+            if (pkcs_5_derive_salt(&kdf,
+                                   (unsigned char*)cases_5_2[0].S, cases_5_2[0].S_len,
+                                   DK2, &dkLen) != CRYPT_OK) {
+                pass = 0;
+            } else {
+                unsigned long dkLen1 = cases_5_2[0].dkLen;
+                if (pkcs_5_alg2((unsigned char*)cases_5_2[1].P, cases_5_2[1].P_len,
+                                (unsigned char*)cases_5_2[0].S, cases_5_2[0].S_len,
+                                cases_5_2[1].c, hash, DK, &dkLen1) != CRYPT_OK ||
+                    dkLen != dkLen1 || XMEMCMP(DK, DK2, (size_t)dkLen) != 0) {
+                    pass = 0;
+                }
+            }
+        }
+        pkcs_5_done(&kdf);
+        if (!pass) {
+            printf("\nPKCS#5 context test (v2): Failed\n");
+            ++failed;
+        }
+
+        ++tested;
+        pass  = 1;
+        if (pkcs_5_init(&kdf, LTC_PKCS_5_V1,
+                        (unsigned char*)cases_5_1[0].P, cases_5_1[0].P_len,
+                        (unsigned char*)cases_5_1[0].S, 8,
+                        cases_5_1[0].c, hash) != CRYPT_OK) {
+            pass = 0;
+        }
+        if (pass) {
+            dkLen = cases_5_1[0].dkLen;
+            if (pkcs_5_derive(&kdf, DK2, &dkLen) != CRYPT_OK ||
+                dkLen != cases_5_1[0].dkLen ||
+                XMEMCMP(DK2, cases_5_1[0].DK, (size_t)cases_5_1[0].dkLen) != 0) {
+                pass = 0;
+            }
+        }
+        pkcs_5_done(&kdf);
+        if (!pass) {
+            printf("\nPKCS#5 context test (v1): Failed\n");
+            ++failed;
+        }
+    }
+
     return (failed != 0) ? CRYPT_FAIL_TESTVECTOR : CRYPT_OK;
  #endif
 }
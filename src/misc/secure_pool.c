@@ -0,0 +1,258 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file secure_pool.c
+  Locked memory pool for key material, Tom St Denis
+
+  An opt-in slab arena backed by a single mlock()ed mapping.  The pool
+  serves small allocations (key schedules, PRNG and MAC states) from
+  power-of-two size classes; anything larger than the biggest class --
+  i.e. bulk data buffers -- falls through to the libc heap, so only a
+  few pages of locked memory cover all key-bearing structs.  Wire it in
+  by defining the XMALLOC/XREALLOC/XCALLOC/XFREE hooks in
+  tomcrypt_custom.h to the secure_pool functions; until
+  secure_pool_init() is called they behave exactly like libc.
+*/
+
+#ifdef LTC_SECURE_POOL
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* size classes run from 2^LTC_SPOOL_MINCLASS to 2^LTC_SPOOL_MAXCLASS
+ * octets; 4096 comfortably covers the largest key schedule */
+#define LTC_SPOOL_MINCLASS  5
+#define LTC_SPOOL_MAXCLASS 12
+#define LTC_SPOOL_NCLASS   (LTC_SPOOL_MAXCLASS - LTC_SPOOL_MINCLASS + 1)
+
+/* every chunk is preceded by a header recording its class; 16 octets
+ * keeps the payload alignment the same malloc() guarantees */
+#define LTC_SPOOL_HDR      16
+
+LTC_MUTEX_GLOBAL(ltc_spool_mutex)
+
+static unsigned char *spool_base = NULL;  /* the locked arena        */
+static size_t         spool_size = 0;     /* its length              */
+static size_t         spool_brk  = 0;     /* high-water bump pointer */
+static void          *spool_list[LTC_SPOOL_NCLASS]; /* per-class free lists */
+
+/* is p a payload pointer inside the arena? */
+#define LTC_SPOOL_OWNS(p) \
+   (spool_base != NULL && (unsigned char *)(p) >= spool_base + LTC_SPOOL_HDR && \
+    (unsigned char *)(p) < spool_base + spool_brk)
+
+/**
+   Create the locked pool
+   @param poolsize   Arena length in octets (rounded up to a page)
+   @return CRYPT_OK if successful
+*/
+int secure_pool_init(size_t poolsize)
+{
+   long pg;
+   unsigned char *base;
+   int x;
+
+   if (poolsize == 0 || spool_base != NULL) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   pg = sysconf(_SC_PAGESIZE);
+   if (pg <= 0) {
+      pg = 4096;
+   }
+   poolsize = (poolsize + (size_t)pg - 1) & ~((size_t)pg - 1);
+
+   base = mmap(NULL, poolsize, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (base == MAP_FAILED) {
+      return CRYPT_MEM;
+   }
+   if (mlock(base, poolsize) != 0) {
+      munmap(base, poolsize);
+      return CRYPT_MEM;
+   }
+#ifdef MADV_DONTDUMP
+   /* keep key material out of core dumps too */
+   madvise(base, poolsize, MADV_DONTDUMP);
+#endif
+
+   LTC_MUTEX_LOCK(&ltc_spool_mutex);
+   spool_base = base;
+   spool_size = poolsize;
+   spool_brk  = 0;
+   for (x = 0; x < LTC_SPOOL_NCLASS; x++) {
+      spool_list[x] = NULL;
+   }
+   LTC_MUTEX_UNLOCK(&ltc_spool_mutex);
+
+   return CRYPT_OK;
+}
+
+/**
+   Wipe and release the locked pool.  Outstanding pool pointers become
+   invalid; allocations revert to libc.
+*/
+void secure_pool_done(void)
+{
+   unsigned char *base;
+   size_t sz;
+   int x;
+
+   LTC_MUTEX_LOCK(&ltc_spool_mutex);
+   base       = spool_base;
+   sz         = spool_size;
+   spool_base = NULL;
+   spool_size = 0;
+   spool_brk  = 0;
+   for (x = 0; x < LTC_SPOOL_NCLASS; x++) {
+      spool_list[x] = NULL;
+   }
+   LTC_MUTEX_UNLOCK(&ltc_spool_mutex);
+
+   if (base != NULL) {
+      zeromem(base, sz);
+      munlock(base, sz);
+      munmap(base, sz);
+   }
+}
+
+/**
+   Allocate from the locked pool (malloc() semantics).  Requests larger
+   than the biggest size class, or made before secure_pool_init(), or
+   made once the arena is full, come from the libc heap instead.
+   @param n   Number of octets
+   @return pointer or NULL on error
+*/
+void *secure_pool_alloc(size_t n)
+{
+   unsigned char *hdr;
+   void *p;
+   int c;
+
+   if (n == 0) {
+      n = 1;
+   }
+   if (n > ((size_t)1 << LTC_SPOOL_MAXCLASS)) {
+      /* deliberately the raw libc call: XMALLOC may be this function */
+      return malloc(n);
+   }
+   for (c = LTC_SPOOL_MINCLASS; ((size_t)1 << c) < n; c++);
+
+   p = NULL;
+   LTC_MUTEX_LOCK(&ltc_spool_mutex);
+   if (spool_base != NULL) {
+      if (spool_list[c - LTC_SPOOL_MINCLASS] != NULL) {
+         /* reuse a wiped chunk of this class; its first octets held the
+          * free list link, so clear those too */
+         p = spool_list[c - LTC_SPOOL_MINCLASS];
+         XMEMCPY(&spool_list[c - LTC_SPOOL_MINCLASS], p, sizeof(void *));
+         XMEMSET(p, 0, sizeof(void *));
+      } else if (spool_size - spool_brk >= LTC_SPOOL_HDR + ((size_t)1 << c)) {
+         /* carve a fresh chunk off the arena */
+         hdr        = spool_base + spool_brk;
+         spool_brk += LTC_SPOOL_HDR + ((size_t)1 << c);
+         hdr[0]     = (unsigned char)c;
+         p          = hdr + LTC_SPOOL_HDR;
+      }
+   }
+   LTC_MUTEX_UNLOCK(&ltc_spool_mutex);
+
+   if (p == NULL) {
+      p = malloc(n);
+   }
+   return p;
+}
+
+/**
+   Release a pointer obtained from secure_pool_alloc().  Pool chunks are
+   wiped before they go back on their free list; heap pointers are
+   passed to free().
+   @param p   The pointer (may be NULL)
+*/
+void secure_pool_free(void *p)
+{
+   int c;
+
+   if (p == NULL) {
+      return;
+   }
+   if (!LTC_SPOOL_OWNS(p)) {
+      free(p);
+      return;
+   }
+
+   c = ((unsigned char *)p)[-LTC_SPOOL_HDR];
+   zeromem(p, (size_t)1 << c);
+
+   LTC_MUTEX_LOCK(&ltc_spool_mutex);
+   XMEMCPY(p, &spool_list[c - LTC_SPOOL_MINCLASS], sizeof(void *));
+   spool_list[c - LTC_SPOOL_MINCLASS] = p;
+   LTC_MUTEX_UNLOCK(&ltc_spool_mutex);
+}
+
+/**
+   Resize a pointer (realloc() semantics)
+   @param p   The pointer (may be NULL)
+   @param n   The new length in octets
+   @return pointer or NULL on error (p is then left intact)
+*/
+void *secure_pool_realloc(void *p, size_t n)
+{
+   void *q;
+   size_t old;
+   int c;
+
+   if (p == NULL) {
+      return secure_pool_alloc(n);
+   }
+   if (!LTC_SPOOL_OWNS(p)) {
+      return realloc(p, n);
+   }
+
+   c   = ((unsigned char *)p)[-LTC_SPOOL_HDR];
+   old = (size_t)1 << c;
+   if (n <= old && n > 0) {
+      return p;
+   }
+   if ((q = secure_pool_alloc(n)) == NULL) {
+      return NULL;
+   }
+   XMEMCPY(q, p, old < n ? old : n);
+   secure_pool_free(p);
+   return q;
+}
+
+/**
+   Allocate zeroed storage (calloc() semantics)
+   @param n   Number of elements
+   @param s   Element size in octets
+   @return pointer or NULL on error
+*/
+void *secure_pool_calloc(size_t n, size_t s)
+{
+   void *p;
+
+   if (s != 0 && n > ((size_t)-1) / s) {
+      return NULL;
+   }
+   if ((p = secure_pool_alloc(n * s)) != NULL) {
+      XMEMSET(p, 0, n * s);
+   }
+   return p;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,168 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file xor_block.c
+  Bulk XOR with a runtime-selected word width, Tom St Denis
+
+  LTC_FAST fixes the XOR word at compile time and requires aligned
+  pointers, which is the right trade for the per-block mode loops but
+  not for the long keystream XORs: there the best width depends on the
+  CPU, not the build.  ltc_xorbuf() picks among 32-, 64- and 128-bit
+  kernels by timing each once on first use; the kernels stage words
+  through XMEMCPY, so any alignment is fine and the compiler lowers
+  them to plain (vector) loads on targets that allow it.
+
+  Builds that want the choice constant-folded (static dispatch, no
+  probe) can pin it with -DLTC_XORBUF_WIDTH=32|64|128.
+
+  The probe runs under a mutex like the other lazy one-time setup in
+  the library (descriptor tables, the Ed25519 base table), so
+  concurrent first calls are well defined and thread checkers stay
+  quiet.
+*/
+
+typedef void (*ltc_xor_fn)(unsigned char *, const unsigned char *,
+                           const unsigned char *, unsigned long);
+
+static void _xor_w32(unsigned char *dst, const unsigned char *a,
+                     const unsigned char *b, unsigned long len)
+{
+   ulong32 x, y;
+   while (len >= 4) {
+      XMEMCPY(&x, a, 4);
+      XMEMCPY(&y, b, 4);
+      x ^= y;
+      XMEMCPY(dst, &x, 4);
+      dst += 4; a += 4; b += 4; len -= 4;
+   }
+   while (len-- > 0) {
+      *dst++ = *a++ ^ *b++;
+   }
+}
+
+static void _xor_w64(unsigned char *dst, const unsigned char *a,
+                     const unsigned char *b, unsigned long len)
+{
+   ulong64 x, y;
+   while (len >= 8) {
+      XMEMCPY(&x, a, 8);
+      XMEMCPY(&y, b, 8);
+      x ^= y;
+      XMEMCPY(dst, &x, 8);
+      dst += 8; a += 8; b += 8; len -= 8;
+   }
+   _xor_w32(dst, a, b, len);
+}
+
+static void _xor_w128(unsigned char *dst, const unsigned char *a,
+                      const unsigned char *b, unsigned long len)
+{
+   ulong64 x[2], y[2];
+   while (len >= 16) {
+      XMEMCPY(x, a, 16);
+      XMEMCPY(y, b, 16);
+      x[0] ^= y[0];
+      x[1] ^= y[1];
+      XMEMCPY(dst, x, 16);
+      dst += 16; a += 16; b += 16; len -= 16;
+   }
+   _xor_w64(dst, a, b, len);
+}
+
+#if defined(LTC_XORBUF_WIDTH)
+
+/* pinned width: direct call, nothing to probe */
+void ltc_xorbuf(unsigned char *dst, const unsigned char *a,
+                const unsigned char *b, unsigned long len)
+{
+#if   LTC_XORBUF_WIDTH == 128
+   _xor_w128(dst, a, b, len);
+#elif LTC_XORBUF_WIDTH == 64
+   _xor_w64(dst, a, b, len);
+#else
+   _xor_w32(dst, a, b, len);
+#endif
+}
+
+#else
+
+#define LTC_XORPROBE_LEN  4096
+#define LTC_XORPROBE_REPS 2048
+
+static ltc_xor_fn ltc_xor_dispatch = NULL;
+
+LTC_MUTEX_GLOBAL(ltc_xor_probe_mutex)
+
+/* clock() ticks one kernel takes for REPS passes over a scratch buffer */
+static clock_t _xor_time(ltc_xor_fn fn, unsigned char *buf)
+{
+   clock_t t0, t1;
+   int i;
+   t0 = XCLOCK();
+   for (i = 0; i < LTC_XORPROBE_REPS; i++) {
+      fn(buf, buf, buf + LTC_XORPROBE_LEN, LTC_XORPROBE_LEN);
+   }
+   t1 = XCLOCK();
+   return t1 - t0;
+}
+
+static void _xor_probe(void)
+{
+   static unsigned char buf[2 * LTC_XORPROBE_LEN];
+   clock_t t32, t64, t128;
+   ltc_xor_fn best;
+
+   t32  = _xor_time(_xor_w32,  buf);
+   t64  = _xor_time(_xor_w64,  buf);
+   t128 = _xor_time(_xor_w128, buf);
+
+   if (t32 == 0 && t64 == 0 && t128 == 0) {
+      /* clock too coarse to tell; go by the native word */
+      best = sizeof(void *) >= 8 ? _xor_w128 : _xor_w32;
+   } else {
+      best = _xor_w32;
+      if (t64  < t32)                 best = _xor_w64;
+      if (t128 < t64 && t128 < t32)   best = _xor_w128;
+   }
+   ltc_xor_dispatch = best;
+}
+
+/**
+  dst = a ^ b over len octets, any alignment, through the kernel the
+  first call measured to be fastest on this CPU
+  @param dst  Destination (may equal a or b)
+  @param a    First operand
+  @param b    Second operand
+  @param len  Number of octets
+*/
+void ltc_xorbuf(unsigned char *dst, const unsigned char *a,
+                const unsigned char *b, unsigned long len)
+{
+   ltc_xor_fn fn;
+
+   /* probe once and publish the pointer under the mutex; reading it
+    * back under the same lock keeps the dispatch race-free */
+   LTC_MUTEX_LOCK(&ltc_xor_probe_mutex);
+   if (ltc_xor_dispatch == NULL) {
+      _xor_probe();
+   }
+   fn = ltc_xor_dispatch;
+   LTC_MUTEX_UNLOCK(&ltc_xor_probe_mutex);
+   fn(dst, a, b, len);
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -24,6 +24,26 @@ void zeromem(volatile void *out, size_t outlen)
 {
    volatile char *mem = out;
    LTC_ARGCHKVD(out != NULL);
+
+#ifdef LTC_FAST
+   /* word-wide volatile stores for the bulk; short lengths (IVs, MAC
+    * tags) fall straight through to the byte loop.  The stores stay
+    * volatile qualified so the compiler may not elide them. */
+   if (outlen >= 2 * sizeof(LTC_FAST_TYPE)) {
+      volatile LTC_FAST_TYPE *wp;
+      while (((unsigned long)mem & (sizeof(LTC_FAST_TYPE) - 1)) != 0) {
+         *mem++ = '\0';
+         --outlen;
+      }
+      wp = (volatile LTC_FAST_TYPE *)(volatile void *)mem;
+      while (outlen >= sizeof(LTC_FAST_TYPE)) {
+         *wp++ = 0;
+         outlen -= sizeof(LTC_FAST_TYPE);
+      }
+      mem = (volatile char *)wp;
+   }
+#endif
+
    while (outlen-- > 0) {
       *mem++ = '\0';
    }
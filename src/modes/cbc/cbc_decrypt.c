@@ -18,9 +18,12 @@
 
 #ifdef LTC_CBC_MODE
 
+/* blocks decrypted per accel_ecb_decrypt call in the bulk path */
+#define LTC_CBC_BULK_BLOCKS 8
+
 /**
   CBC decrypt
-  @param ct     Ciphertext
+  @param ct     Ciphertext (may equal pt, the mode is in-place safe)
   @param pt     [out] Plaintext
   @param len    The number of bytes to process (must be multiple of block length)
   @param cbc    CBC state
@@ -40,30 +43,80 @@ int cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long len, s
    LTC_ARGCHK(ct  != NULL);
    LTC_ARGCHK(cbc != NULL);
 
-   if ((err = cipher_is_valid(cbc->cipher)) != CRYPT_OK) {
-       return err;
-   }
+   if (cbc->sealed != LTC_STATE_SEALED) {
+      if ((err = cipher_is_valid(cbc->cipher)) != CRYPT_OK) {
+          return err;
+      }
 
-   /* is blocklen valid? */
-   if (cbc->blocklen < 1 || cbc->blocklen > (int)sizeof(cbc->IV) || cbc->blocklen > (int)sizeof(tmp)) {
-      return CRYPT_INVALID_ARG;
+      /* is blocklen valid? */
+      if (cbc->blocklen < 1 || cbc->blocklen > (int)sizeof(cbc->IV) || cbc->blocklen > (int)sizeof(tmp)) {
+         return CRYPT_INVALID_ARG;
+      }
+#ifdef LTC_FAST
+      if (cbc->blocklen % sizeof(LTC_FAST_TYPE)) {
+         return CRYPT_INVALID_ARG;
+      }
+#endif
    }
 
    if (len % cbc->blocklen) {
       return CRYPT_INVALID_ARG;
    }
-#ifdef LTC_FAST
-   if (cbc->blocklen % sizeof(LTC_FAST_TYPE)) {
-      return CRYPT_INVALID_ARG;
-   }
-#endif
+
+   LTC_STATS_BUMP(LTC_STAT_CBC_DECRYPT, cbc->cipher, len,
+                  cipher_descriptor[cbc->cipher].accel_cbc_decrypt == NULL &&
+                  cipher_descriptor[cbc->cipher].accel_ecb_decrypt == NULL);
 
    if (cipher_descriptor[cbc->cipher].accel_cbc_decrypt != NULL) {
       return cipher_descriptor[cbc->cipher].accel_cbc_decrypt(ct, pt, len / cbc->blocklen, cbc->IV, &cbc->key);
    } else {
+      /* CBC decryption has no chaining dependency, so when the cipher offers a
+       * multi-block ECB accelerator decrypt whole stripes per call and apply
+       * the XOR chain afterwards.  Blocks are resolved back to front so the
+       * ciphertext a block chains from is still intact when pt aliases ct. */
+      if (cipher_descriptor[cbc->cipher].accel_ecb_decrypt != NULL && len >= 2 * (unsigned long)cbc->blocklen) {
+         unsigned char buf[LTC_CBC_BULK_BLOCKS * MAXBLOCKSIZE], iv2[MAXBLOCKSIZE];
+         unsigned long n;
+         int           i;
+         while (len >= 2 * (unsigned long)cbc->blocklen) {
+            n = len / cbc->blocklen;
+            if (n > LTC_CBC_BULK_BLOCKS) {
+               n = LTC_CBC_BULK_BLOCKS;
+            }
+            /* the last ciphertext block becomes the next IV */
+            XMEMCPY(iv2, ct + (n-1)*cbc->blocklen, cbc->blocklen);
+            if ((err = cipher_descriptor[cbc->cipher].accel_ecb_decrypt(ct, buf, n, &cbc->key)) != CRYPT_OK) {
+               return err;
+            }
+            for (i = (int)n-1; i > 0; i--) {
+#ifdef LTC_FAST
+               for (x = 0; x < cbc->blocklen; x += sizeof(LTC_FAST_TYPE)) {
+                  *(LTC_FAST_TYPE_PTR_CAST(pt + i*cbc->blocklen + x)) =
+                     *(LTC_FAST_TYPE_PTR_CAST(buf + i*cbc->blocklen + x)) ^
+                     *(LTC_FAST_TYPE_PTR_CAST(ct + (i-1)*cbc->blocklen + x));
+               }
+#else
+               for (x = 0; x < cbc->blocklen; x++) {
+                  pt[i*cbc->blocklen + x] = buf[i*cbc->blocklen + x] ^ ct[(i-1)*cbc->blocklen + x];
+               }
+#endif
+            }
+            for (x = 0; x < cbc->blocklen; x++) {
+               pt[x] = buf[x] ^ cbc->IV[x];
+            }
+            XMEMCPY(cbc->IV, iv2, cbc->blocklen);
+            n   *= cbc->blocklen;
+            ct  += n;
+            pt  += n;
+            len -= n;
+         }
+#ifdef LTC_CLEAN_STACK
+         zeromem(buf, sizeof(buf));
+#endif
+      }
       while (len) {
          /* decrypt */
-         if ((err = cipher_descriptor[cbc->cipher].ecb_decrypt(ct, tmp, &cbc->key)) != CRYPT_OK) {
+         if ((err = LTC_CIPHER_ECB_DECRYPT(cbc->cipher, ct, tmp, &cbc->key)) != CRYPT_OK) {
             return err;
          }
 
@@ -87,6 +140,9 @@ int cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long len, s
          len -= cbc->blocklen;
       }
    }
+#ifdef LTC_CLEAN_STACK
+   burn_stack_flush();
+#endif
    return CRYPT_OK;
 }
 
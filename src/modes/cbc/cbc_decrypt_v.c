@@ -0,0 +1,120 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file cbc_decrypt_v.c
+  CBC implementation, decrypt a scattered buffer, Tom St Denis
+*/
+
+#ifdef LTC_CBC_MODE
+
+/* copy n octets out of the chain starting at fragment *f offset *o,
+ * advancing the cursor */
+static void _gather(const ltc_iovec *iov, int *f, unsigned long *o,
+                    unsigned char *dst, unsigned long n)
+{
+   unsigned long a;
+   while (n > 0) {
+      a = iov[*f].len - *o;
+      if (a == 0) { (*f)++; *o = 0; continue; }
+      if (a > n)  { a = n; }
+      XMEMCPY(dst, iov[*f].data + *o, a);
+      dst += a; *o += a; n -= a;
+   }
+}
+
+/* the reverse: copy n octets back into the chain */
+static void _scatter(const ltc_iovec *iov, int *f, unsigned long *o,
+                     const unsigned char *src, unsigned long n)
+{
+   unsigned long a;
+   while (n > 0) {
+      a = iov[*f].len - *o;
+      if (a == 0) { (*f)++; *o = 0; continue; }
+      if (a > n)  { a = n; }
+      XMEMCPY(iov[*f].data + *o, src, a);
+      src += a; *o += a; n -= a;
+   }
+}
+
+/**
+  CBC decrypt a fragment chain (see cbc_encrypt_v() for the layout
+  rules; fragments may split blocks anywhere, the chain total must be a
+  multiple of the block length)
+  @param iov     The array of fragments, decrypted in place
+  @param iovcnt  The number of fragments
+  @param cbc     CBC state
+  @return CRYPT_OK if successful
+*/
+int cbc_decrypt_v(const ltc_iovec *iov, int iovcnt, symmetric_CBC *cbc)
+{
+   unsigned char blk[MAXBLOCKSIZE];
+   unsigned long total, avail, n, o, so;
+   int x, f, sf, err;
+
+   LTC_ARGCHK(cbc != NULL);
+   LTC_ARGCHK(iov != NULL || iovcnt == 0);
+
+   if (cbc->blocklen < 1 || cbc->blocklen > (int)sizeof(blk)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   total = 0;
+   for (x = 0; x < iovcnt; x++) {
+      LTC_ARGCHK(iov[x].data != NULL || iov[x].len == 0);
+      total += iov[x].len;
+   }
+   if (total % cbc->blocklen) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   err = CRYPT_OK;
+   f   = 0;
+   o   = 0;
+   while (total > 0) {
+      avail = iov[f].len - o;
+      if (avail == 0) {
+         f++; o = 0;
+         continue;
+      }
+      if (avail >= (unsigned long)cbc->blocklen) {
+         /* whole blocks are contiguous here; no copying at all */
+         n = avail - (avail % cbc->blocklen);
+         if ((err = cbc_decrypt(iov[f].data + o, iov[f].data + o, n, cbc)) != CRYPT_OK) {
+            goto LBL_DONE;
+         }
+         o     += n;
+         total -= n;
+         continue;
+      }
+      /* this block straddles one or more fragment boundaries */
+      sf = f; so = o;
+      _gather(iov, &f, &o, blk, (unsigned long)cbc->blocklen);
+      if ((err = cbc_decrypt(blk, blk, (unsigned long)cbc->blocklen, cbc)) != CRYPT_OK) {
+         goto LBL_DONE;
+      }
+      _scatter(iov, &sf, &so, blk, (unsigned long)cbc->blocklen);
+      total -= cbc->blocklen;
+   }
+
+LBL_DONE:
+#ifdef LTC_CLEAN_STACK
+   zeromem(blk, sizeof(blk));
+#endif
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -20,7 +20,7 @@
 
 /**
   CBC encrypt
-  @param pt     Plaintext
+  @param pt     Plaintext (may equal ct for in-place operation)
   @param ct     [out] Ciphertext
   @param len    The number of bytes to process (must be multiple of block length)
   @param cbc    CBC state
@@ -34,23 +34,28 @@ int cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, s
    LTC_ARGCHK(ct != NULL);
    LTC_ARGCHK(cbc != NULL);
 
-   if ((err = cipher_is_valid(cbc->cipher)) != CRYPT_OK) {
-       return err;
-   }
+   if (cbc->sealed != LTC_STATE_SEALED) {
+      if ((err = cipher_is_valid(cbc->cipher)) != CRYPT_OK) {
+          return err;
+      }
 
-   /* is blocklen valid? */
-   if (cbc->blocklen < 1 || cbc->blocklen > (int)sizeof(cbc->IV)) {
-      return CRYPT_INVALID_ARG;
+      /* is blocklen valid? */
+      if (cbc->blocklen < 1 || cbc->blocklen > (int)sizeof(cbc->IV)) {
+         return CRYPT_INVALID_ARG;
+      }
+#ifdef LTC_FAST
+      if (cbc->blocklen % sizeof(LTC_FAST_TYPE)) {
+         return CRYPT_INVALID_ARG;
+      }
+#endif
    }
 
    if (len % cbc->blocklen) {
       return CRYPT_INVALID_ARG;
    }
-#ifdef LTC_FAST
-   if (cbc->blocklen % sizeof(LTC_FAST_TYPE)) {
-      return CRYPT_INVALID_ARG;
-   }
-#endif
+
+   LTC_STATS_BUMP(LTC_STAT_CBC_ENCRYPT, cbc->cipher, len,
+                  cipher_descriptor[cbc->cipher].accel_cbc_encrypt == NULL);
 
    if (cipher_descriptor[cbc->cipher].accel_cbc_encrypt != NULL) {
       return cipher_descriptor[cbc->cipher].accel_cbc_encrypt(pt, ct, len / cbc->blocklen, cbc->IV, &cbc->key);
@@ -68,7 +73,7 @@ int cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, s
     #endif
 
          /* encrypt */
-         if ((err = cipher_descriptor[cbc->cipher].ecb_encrypt(cbc->IV, ct, &cbc->key)) != CRYPT_OK) {
+         if ((err = LTC_CIPHER_ECB_ENCRYPT(cbc->cipher, cbc->IV, ct, &cbc->key)) != CRYPT_OK) {
             return err;
          }
 
@@ -88,6 +93,9 @@ int cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, s
          len -= cbc->blocklen;
       }
    }
+#ifdef LTC_CLEAN_STACK
+   burn_stack_flush();
+#endif
    return CRYPT_OK;
 }
 
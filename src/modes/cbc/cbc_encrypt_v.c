@@ -0,0 +1,125 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file cbc_encrypt_v.c
+  CBC implementation, encrypt a scattered buffer, Tom St Denis
+*/
+
+#ifdef LTC_CBC_MODE
+
+/* copy n octets out of the chain starting at fragment *f offset *o,
+ * advancing the cursor */
+static void _gather(const ltc_iovec *iov, int *f, unsigned long *o,
+                    unsigned char *dst, unsigned long n)
+{
+   unsigned long a;
+   while (n > 0) {
+      a = iov[*f].len - *o;
+      if (a == 0) { (*f)++; *o = 0; continue; }
+      if (a > n)  { a = n; }
+      XMEMCPY(dst, iov[*f].data + *o, a);
+      dst += a; *o += a; n -= a;
+   }
+}
+
+/* the reverse: copy n octets back into the chain */
+static void _scatter(const ltc_iovec *iov, int *f, unsigned long *o,
+                     const unsigned char *src, unsigned long n)
+{
+   unsigned long a;
+   while (n > 0) {
+      a = iov[*f].len - *o;
+      if (a == 0) { (*f)++; *o = 0; continue; }
+      if (a > n)  { a = n; }
+      XMEMCPY(iov[*f].data + *o, src, a);
+      src += a; *o += a; n -= a;
+   }
+}
+
+/**
+  CBC encrypt a fragment chain.  Each fragment is encrypted in place and
+  fragments may split cipher blocks anywhere: runs of whole blocks inside
+  a fragment go through cbc_encrypt() (and its bulk paths) directly,
+  while a block straddling a boundary is gathered into a stack block,
+  encrypted, and scattered back - so nothing larger than one cipher
+  block is ever copied.  The total length of the chain must be a
+  multiple of the block length, as with cbc_encrypt() on a contiguous
+  buffer.
+  @param iov     The array of fragments, encrypted in place
+  @param iovcnt  The number of fragments
+  @param cbc     CBC state
+  @return CRYPT_OK if successful
+*/
+int cbc_encrypt_v(const ltc_iovec *iov, int iovcnt, symmetric_CBC *cbc)
+{
+   unsigned char blk[MAXBLOCKSIZE];
+   unsigned long total, avail, n, o, so;
+   int x, f, sf, err;
+
+   LTC_ARGCHK(cbc != NULL);
+   LTC_ARGCHK(iov != NULL || iovcnt == 0);
+
+   if (cbc->blocklen < 1 || cbc->blocklen > (int)sizeof(blk)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   total = 0;
+   for (x = 0; x < iovcnt; x++) {
+      LTC_ARGCHK(iov[x].data != NULL || iov[x].len == 0);
+      total += iov[x].len;
+   }
+   if (total % cbc->blocklen) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   err = CRYPT_OK;
+   f   = 0;
+   o   = 0;
+   while (total > 0) {
+      avail = iov[f].len - o;
+      if (avail == 0) {
+         f++; o = 0;
+         continue;
+      }
+      if (avail >= (unsigned long)cbc->blocklen) {
+         /* whole blocks are contiguous here; no copying at all */
+         n = avail - (avail % cbc->blocklen);
+         if ((err = cbc_encrypt(iov[f].data + o, iov[f].data + o, n, cbc)) != CRYPT_OK) {
+            goto LBL_DONE;
+         }
+         o     += n;
+         total -= n;
+         continue;
+      }
+      /* this block straddles one or more fragment boundaries */
+      sf = f; so = o;
+      _gather(iov, &f, &o, blk, (unsigned long)cbc->blocklen);
+      if ((err = cbc_encrypt(blk, blk, (unsigned long)cbc->blocklen, cbc)) != CRYPT_OK) {
+         goto LBL_DONE;
+      }
+      _scatter(iov, &sf, &so, blk, (unsigned long)cbc->blocklen);
+      total -= cbc->blocklen;
+   }
+
+LBL_DONE:
+#ifdef LTC_CLEAN_STACK
+   zeromem(blk, sizeof(blk));
+#endif
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -42,7 +42,7 @@ int cbc_start(int cipher, const unsigned char *IV, const unsigned char *key,
    }
 
    /* setup cipher */
-   if ((err = cipher_descriptor[cipher].setup(key, keylen, num_rounds, &cbc->key)) != CRYPT_OK) {
+   if ((err = cipher_setup_cached(cipher, key, keylen, num_rounds, &cbc->key)) != CRYPT_OK) {
       return err;
    }
 
@@ -52,6 +52,7 @@ int cbc_start(int cipher, const unsigned char *IV, const unsigned char *key,
    for (x = 0; x < cbc->blocklen; x++) {
        cbc->IV[x] = IV[x];
    }
+   cbc->sealed = LTC_STATE_SEALED;
    return CRYPT_OK;
 }
 
@@ -19,7 +19,7 @@
 
 /**
    CFB decrypt
-   @param ct      Ciphertext
+   @param ct      Ciphertext (decrypting over the same buffer is allowed)
    @param pt      [out] Plaintext
    @param len     Length of ciphertext (octets)
    @param cfb     CFB state
@@ -43,9 +43,40 @@ int cfb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long len, s
       return CRYPT_INVALID_ARG;
    }
 
+   /* trickle bytes until the keystream block boundary */
+   while (len > 0 && cfb->padlen != cfb->blocklen) {
+       cfb->pad[cfb->padlen] = *ct;
+       *pt = *ct ^ cfb->IV[cfb->padlen];
+       ++pt;
+       ++ct;
+       ++(cfb->padlen);
+       --len;
+   }
+
+   /* whole-block segments: save the ciphertext block as the next feedback
+    * value before writing pt so in-place (pt == ct) stays safe */
+#ifdef LTC_FAST
+   if ((cfb->blocklen % sizeof(LTC_FAST_TYPE)) == 0) {
+      int x;
+      while (len >= (unsigned long)cfb->blocklen) {
+         if ((err = LTC_CIPHER_ECB_ENCRYPT(cfb->cipher, cfb->pad, cfb->IV, &cfb->key)) != CRYPT_OK) {
+            return err;
+         }
+         XMEMCPY(cfb->pad, ct, cfb->blocklen);
+         for (x = 0; x < cfb->blocklen; x += sizeof(LTC_FAST_TYPE)) {
+            *(LTC_FAST_TYPE_PTR_CAST(pt + x)) = *(LTC_FAST_TYPE_PTR_CAST(ct + x)) ^
+                                                *(LTC_FAST_TYPE_PTR_CAST(cfb->IV + x));
+         }
+         pt  += cfb->blocklen;
+         ct  += cfb->blocklen;
+         len -= cfb->blocklen;
+      }
+   }
+#endif
+
    while (len-- > 0) {
        if (cfb->padlen == cfb->blocklen) {
-          if ((err = cipher_descriptor[cfb->cipher].ecb_encrypt(cfb->pad, cfb->IV, &cfb->key)) != CRYPT_OK) {
+          if ((err = LTC_CIPHER_ECB_ENCRYPT(cfb->cipher, cfb->pad, cfb->IV, &cfb->key)) != CRYPT_OK) {
              return err;
           }
           cfb->padlen = 0;
@@ -19,7 +19,7 @@
 
 /**
   CFB encrypt
-  @param pt     Plaintext
+  @param pt     Plaintext (pt == ct is allowed)
   @param ct     [out] Ciphertext
   @param len    Length of plaintext (octets)
   @param cfb    CFB state
@@ -43,9 +43,39 @@ int cfb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, s
       return CRYPT_INVALID_ARG;
    }
 
+   /* trickle bytes until the keystream block boundary */
+   while (len > 0 && cfb->padlen != cfb->blocklen) {
+       cfb->pad[cfb->padlen] = (*ct = *pt ^ cfb->IV[cfb->padlen]);
+       ++pt;
+       ++ct;
+       ++(cfb->padlen);
+       --len;
+   }
+
+   /* whole-block segments: one cipher call and a wide XOR per block, the
+    * ciphertext block becoming the next feedback value */
+#ifdef LTC_FAST
+   if ((cfb->blocklen % sizeof(LTC_FAST_TYPE)) == 0) {
+      int x;
+      while (len >= (unsigned long)cfb->blocklen) {
+         if ((err = LTC_CIPHER_ECB_ENCRYPT(cfb->cipher, cfb->pad, cfb->IV, &cfb->key)) != CRYPT_OK) {
+            return err;
+         }
+         for (x = 0; x < cfb->blocklen; x += sizeof(LTC_FAST_TYPE)) {
+            *(LTC_FAST_TYPE_PTR_CAST(ct + x)) = *(LTC_FAST_TYPE_PTR_CAST(pt + x)) ^
+                                                *(LTC_FAST_TYPE_PTR_CAST(cfb->IV + x));
+         }
+         XMEMCPY(cfb->pad, ct, cfb->blocklen);
+         pt  += cfb->blocklen;
+         ct  += cfb->blocklen;
+         len -= cfb->blocklen;
+      }
+   }
+#endif
+
    while (len-- > 0) {
        if (cfb->padlen == cfb->blocklen) {
-          if ((err = cipher_descriptor[cfb->cipher].ecb_encrypt(cfb->pad, cfb->IV, &cfb->key)) != CRYPT_OK) {
+          if ((err = LTC_CIPHER_ECB_ENCRYPT(cfb->cipher, cfb->pad, cfb->IV, &cfb->key)) != CRYPT_OK) {
              return err;
           }
           cfb->padlen = 0;
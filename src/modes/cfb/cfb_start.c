@@ -49,7 +49,7 @@ int cfb_start(int cipher, const unsigned char *IV, const unsigned char *key,
        cfb->IV[x] = IV[x];
 
    /* init the cipher */
-   if ((err = cipher_descriptor[cipher].setup(key, keylen, num_rounds, &cfb->key)) != CRYPT_OK) {
+   if ((err = cipher_setup_cached(cipher, key, keylen, num_rounds, &cfb->key)) != CRYPT_OK) {
       return err;
    }
 
@@ -19,7 +19,7 @@
 
 /**
    CTR decrypt
-   @param ct      Ciphertext
+   @param ct      Ciphertext (pt == ct is allowed)
    @param pt      [out] Plaintext
    @param len     Length of ciphertext (octets)
    @param ctr     CTR state
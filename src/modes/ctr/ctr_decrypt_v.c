@@ -0,0 +1,36 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ctr_decrypt_v.c
+  CTR implementation, decrypt a scattered buffer, Tom St Denis
+*/
+
+#ifdef LTC_CTR_MODE
+
+/**
+  CTR decrypt a fragment chain (see ctr_encrypt_v())
+  @param iov     The array of fragments, decrypted in place
+  @param iovcnt  The number of fragments
+  @param ctr     CTR state
+  @return CRYPT_OK if successful
+*/
+int ctr_decrypt_v(const ltc_iovec *iov, int iovcnt, symmetric_CTR *ctr)
+{
+   return ctr_encrypt_v(iov, iovcnt, ctr);
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
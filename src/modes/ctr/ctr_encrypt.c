@@ -18,9 +18,35 @@
 
 #ifdef LTC_CTR_MODE
 
+/* number of counter blocks materialized per trip through the bulk path */
+#define LTC_CTR_BULK_BLOCKS 16
+
+/* advance the counter by one block */
+static void _ctr_increment(symmetric_CTR *ctr)
+{
+   int x;
+   if (ctr->mode == CTR_COUNTER_LITTLE_ENDIAN) {
+      /* little-endian */
+      for (x = 0; x < ctr->ctrlen; x++) {
+         ctr->ctr[x] = (ctr->ctr[x] + (unsigned char)1) & (unsigned char)255;
+         if (ctr->ctr[x] != (unsigned char)0) {
+            break;
+         }
+      }
+   } else {
+      /* big-endian */
+      for (x = ctr->blocklen-1; x >= ctr->ctrlen; x--) {
+         ctr->ctr[x] = (ctr->ctr[x] + (unsigned char)1) & (unsigned char)255;
+         if (ctr->ctr[x] != (unsigned char)0) {
+            break;
+         }
+      }
+   }
+}
+
 /**
   CTR encrypt
-  @param pt     Plaintext
+  @param pt     Plaintext (may equal ct for in-place operation)
   @param ct     [out] Ciphertext
   @param len    Length of plaintext (octets)
   @param ctr    CTR state
@@ -28,27 +54,53 @@
 */
 int ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, symmetric_CTR *ctr)
 {
-   int x, err;
+#ifdef LTC_FAST
+   int x;
+#endif
+   int err;
 
    LTC_ARGCHK(pt != NULL);
    LTC_ARGCHK(ct != NULL);
    LTC_ARGCHK(ctr != NULL);
 
-   if ((err = cipher_is_valid(ctr->cipher)) != CRYPT_OK) {
-       return err;
-   }
+   if (ctr->sealed != LTC_STATE_SEALED) {
+      if ((err = cipher_is_valid(ctr->cipher)) != CRYPT_OK) {
+          return err;
+      }
 
-   /* is blocklen/padlen valid? */
-   if (ctr->blocklen < 1 || ctr->blocklen > (int)sizeof(ctr->ctr) ||
-       ctr->padlen   < 0 || ctr->padlen   > (int)sizeof(ctr->pad)) {
-      return CRYPT_INVALID_ARG;
-   }
+      /* is blocklen/padlen valid? */
+      if (ctr->blocklen < 1 || ctr->blocklen > (int)sizeof(ctr->ctr) ||
+          ctr->padlen   < 0 || ctr->padlen   > (int)sizeof(ctr->pad)) {
+         return CRYPT_INVALID_ARG;
+      }
 
 #ifdef LTC_FAST
-   if (ctr->blocklen % sizeof(LTC_FAST_TYPE)) {
-      return CRYPT_INVALID_ARG;
-   }
+      if (ctr->blocklen % sizeof(LTC_FAST_TYPE)) {
+         return CRYPT_INVALID_ARG;
+      }
 #endif
+   }
+
+   /* a partially consumed pad or an off-size tail forces byte work
+    * (padlen == 0 is a full precomputed pad, not a partial one) */
+   LTC_STATS_BUMP(LTC_STAT_CTR_ENCRYPT, ctr->cipher, len,
+                  (ctr->padlen != ctr->blocklen && ctr->padlen != 0) ||
+                  (len % (unsigned long)ctr->blocklen) != 0);
+
+   /* serve prefetched keystream first: pure XOR, no cipher call */
+   if (ctr->lookahead_on && ctr->lookahead_len > 0 && len > 0) {
+      unsigned long n;
+      n = (len < (unsigned long)ctr->lookahead_len) ? len : (unsigned long)ctr->lookahead_len;
+      ltc_xorbuf(ct, pt, ctr->lookahead + ctr->lookahead_off, n);
+      ctr->lookahead_off += n;
+      ctr->lookahead_len -= n;
+      if (ctr->lookahead_len == 0) {
+         ctr->lookahead_off = 0;
+      }
+      pt  += n;
+      ct  += n;
+      len -= n;
+   }
 
    /* handle acceleration only if pad is empty, accelerator is present and length is >= a block size */
    if ((ctr->padlen == ctr->blocklen) && cipher_descriptor[ctr->cipher].accel_ctr_encrypt != NULL && (len >= (unsigned long)ctr->blocklen)) {
@@ -58,30 +110,45 @@ int ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, s
       len %= ctr->blocklen;
    }
 
+   /* bulk path: materialize a run of counter blocks and push them through the
+    * ECB accelerator in one call, then XOR the keystream over the plaintext */
+   if ((ctr->padlen == ctr->blocklen) && cipher_descriptor[ctr->cipher].accel_ecb_encrypt != NULL &&
+       (len >= 2 * (unsigned long)ctr->blocklen)) {
+      unsigned char stream[LTC_CTR_BULK_BLOCKS * MAXBLOCKSIZE];
+      unsigned long n, i;
+      while (len >= 2 * (unsigned long)ctr->blocklen) {
+         n = len / ctr->blocklen;
+         if (n > LTC_CTR_BULK_BLOCKS) {
+            n = LTC_CTR_BULK_BLOCKS;
+         }
+         for (i = 0; i < n; i++) {
+            _ctr_increment(ctr);
+            XMEMCPY(stream + i*ctr->blocklen, ctr->ctr, ctr->blocklen);
+         }
+         if ((err = cipher_descriptor[ctr->cipher].accel_ecb_encrypt(stream, stream, n, &ctr->key)) != CRYPT_OK) {
+            return err;
+         }
+         n *= ctr->blocklen;
+         /* runs long enough to amortize the probed-width kernel, which
+          * also lifts LTC_FAST's alignment restriction here */
+         ltc_xorbuf(ct, pt, stream, n);
+         pt  += n;
+         ct  += n;
+         len -= n;
+      }
+#ifdef LTC_CLEAN_STACK
+      zeromem(stream, sizeof(stream));
+#endif
+   }
+
    while (len) {
       /* is the pad empty? */
       if (ctr->padlen == ctr->blocklen) {
          /* increment counter */
-         if (ctr->mode == CTR_COUNTER_LITTLE_ENDIAN) {
-            /* little-endian */
-            for (x = 0; x < ctr->ctrlen; x++) {
-               ctr->ctr[x] = (ctr->ctr[x] + (unsigned char)1) & (unsigned char)255;
-               if (ctr->ctr[x] != (unsigned char)0) {
-                  break;
-               }
-            }
-         } else {
-            /* big-endian */
-            for (x = ctr->blocklen-1; x >= ctr->ctrlen; x--) {
-               ctr->ctr[x] = (ctr->ctr[x] + (unsigned char)1) & (unsigned char)255;
-               if (ctr->ctr[x] != (unsigned char)0) {
-                  break;
-               }
-            }
-         }
+         _ctr_increment(ctr);
 
          /* encrypt it */
-         if ((err = cipher_descriptor[ctr->cipher].ecb_encrypt(ctr->ctr, ctr->pad, &ctr->key)) != CRYPT_OK) {
+         if ((err = LTC_CIPHER_ECB_ENCRYPT(ctr->cipher, ctr->ctr, ctr->pad, &ctr->key)) != CRYPT_OK) {
             return err;
          }
          ctr->padlen = 0;
@@ -102,6 +169,28 @@ int ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, s
       *ct++ = *pt++ ^ ctr->pad[ctr->padlen++];
       --len;
    }
+
+   /* top the lookahead window back up off the caller's critical path */
+   if (ctr->lookahead_on && ctr->padlen == ctr->blocklen) {
+      int i;
+      if (ctr->lookahead_off > 0 && ctr->lookahead_len > 0) {
+         for (i = 0; i < ctr->lookahead_len; i++) {
+            ctr->lookahead[i] = ctr->lookahead[ctr->lookahead_off + i];
+         }
+      }
+      ctr->lookahead_off = 0;
+      while (ctr->lookahead_len + ctr->blocklen <= LTC_CTR_LOOKAHEAD_BLOCKS * ctr->blocklen) {
+         _ctr_increment(ctr);
+         if ((err = LTC_CIPHER_ECB_ENCRYPT(ctr->cipher, ctr->ctr, ctr->lookahead + ctr->lookahead_len, &ctr->key)) != CRYPT_OK) {
+            return err;
+         }
+         ctr->lookahead_len += ctr->blocklen;
+      }
+   }
+
+#ifdef LTC_CLEAN_STACK
+   burn_stack_flush();
+#endif
    return CRYPT_OK;
 }
 
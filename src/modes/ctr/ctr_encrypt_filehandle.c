@@ -0,0 +1,51 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ctr_encrypt_filehandle.c
+  CTR implementation, encrypt between open file handles, Tom St Denis
+*/
+
+#if defined(LTC_CTR_MODE) && !defined(LTC_NO_FILE)
+
+static int s_ctr_file_xform(void *state, unsigned char *buf,
+                            unsigned long *len, int final)
+{
+   LTC_UNUSED_PARAM(final);
+   return ctr_encrypt(buf, buf, *len, state);
+}
+
+/**
+  CTR encrypt (or decrypt; the keystream is symmetric) from one open
+  file handle to another.  Chunks run through the overlapped driver of
+  file_pipeline_filehandle(), so the read of the next chunk and the
+  write of the previous one are in flight while the current chunk goes
+  through the bulk CTR path - instead of the strictly alternating
+  fread/ctr_encrypt/fwrite loops everyone hand-rolls.
+  @param in    The input handle (read to EOF from the current position)
+  @param out   The output handle
+  @param ctr   The CTR state (the counter advances across the whole file)
+  @return CRYPT_OK if successful
+*/
+int ctr_encrypt_filehandle(FILE *in, FILE *out, symmetric_CTR *ctr)
+{
+   LTC_ARGCHK(in  != NULL);
+   LTC_ARGCHK(out != NULL);
+   LTC_ARGCHK(ctr != NULL);
+   return file_pipeline_filehandle(in, out, s_ctr_file_xform, ctr);
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,53 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ctr_encrypt_v.c
+  CTR implementation, encrypt a scattered buffer, Tom St Denis
+*/
+
+#ifdef LTC_CTR_MODE
+
+/**
+  CTR encrypt a fragment chain.  Each fragment is encrypted in place;
+  the pad offset in the CTR state carries partial keystream blocks
+  across fragment boundaries (and across calls), so the chain behaves
+  exactly like one contiguous buffer and fragments may have any length.
+  @param iov     The array of fragments, encrypted in place
+  @param iovcnt  The number of fragments
+  @param ctr     CTR state
+  @return CRYPT_OK if successful
+*/
+int ctr_encrypt_v(const ltc_iovec *iov, int iovcnt, symmetric_CTR *ctr)
+{
+   int x, err;
+
+   LTC_ARGCHK(ctr != NULL);
+   LTC_ARGCHK(iov != NULL || iovcnt == 0);
+
+   for (x = 0; x < iovcnt; x++) {
+      if (iov[x].len == 0) {
+         continue;
+      }
+      if ((err = ctr_encrypt(iov[x].data, iov[x].data, iov[x].len, ctr)) != CRYPT_OK) {
+         return err;
+      }
+   }
+
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
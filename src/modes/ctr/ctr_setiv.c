@@ -43,8 +43,10 @@ int ctr_setiv(const unsigned char *IV, unsigned long len, symmetric_CTR *ctr)
    /* set IV */
    XMEMCPY(ctr->ctr, IV, len);
 
-   /* force next block */
-   ctr->padlen = 0;
+   /* force next block, dropping any prefetched keystream */
+   ctr->padlen        = 0;
+   ctr->lookahead_off = 0;
+   ctr->lookahead_len = 0;
    return cipher_descriptor[ctr->cipher].ecb_encrypt(IV, ctr->pad, &ctr->key);
 }
 
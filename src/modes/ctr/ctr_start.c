@@ -57,15 +57,18 @@ int ctr_start(               int   cipher,
    }
 
    /* setup cipher */
-   if ((err = cipher_descriptor[cipher].setup(key, keylen, num_rounds, &ctr->key)) != CRYPT_OK) {
+   if ((err = cipher_setup_cached(cipher, key, keylen, num_rounds, &ctr->key)) != CRYPT_OK) {
       return err;
    }
 
    /* copy ctr */
-   ctr->blocklen = cipher_descriptor[cipher].block_length;
-   ctr->cipher   = cipher;
-   ctr->padlen   = 0;
-   ctr->mode     = ctr_mode & 0x1000;
+   ctr->blocklen      = cipher_descriptor[cipher].block_length;
+   ctr->cipher        = cipher;
+   ctr->padlen        = 0;
+   ctr->mode          = ctr_mode & 0x1000;
+   ctr->lookahead_on  = (ctr_mode & LTC_CTR_PREFETCH) ? 1 : 0;
+   ctr->lookahead_off = 0;
+   ctr->lookahead_len = 0;
    for (x = 0; x < ctr->blocklen; x++) {
        ctr->ctr[x] = IV[x];
    }
@@ -91,7 +94,42 @@ int ctr_start(               int   cipher,
       }
    }
 
-   return cipher_descriptor[ctr->cipher].ecb_encrypt(ctr->ctr, ctr->pad, &ctr->key);
+   if ((err = cipher_descriptor[ctr->cipher].ecb_encrypt(ctr->ctr, ctr->pad, &ctr->key)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* prime the lookahead window so the first messages hit no cipher call */
+   if (ctr->lookahead_on) {
+      XMEMCPY(ctr->lookahead, ctr->pad, ctr->blocklen);
+      ctr->lookahead_len = ctr->blocklen;
+      ctr->padlen        = ctr->blocklen;
+      while (ctr->lookahead_len + ctr->blocklen <= LTC_CTR_LOOKAHEAD_BLOCKS * ctr->blocklen) {
+         if (ctr->mode == CTR_COUNTER_LITTLE_ENDIAN) {
+            /* little-endian */
+            for (x = 0; x < ctr->ctrlen; x++) {
+                ctr->ctr[x] = (ctr->ctr[x] + (unsigned char)1) & (unsigned char)255;
+                if (ctr->ctr[x] != (unsigned char)0) {
+                   break;
+                }
+            }
+         } else {
+            /* big-endian */
+            for (x = ctr->blocklen-1; x >= ctr->ctrlen; x--) {
+                ctr->ctr[x] = (ctr->ctr[x] + (unsigned char)1) & (unsigned char)255;
+                if (ctr->ctr[x] != (unsigned char)0) {
+                   break;
+                }
+            }
+         }
+         if ((err = cipher_descriptor[ctr->cipher].ecb_encrypt(ctr->ctr, ctr->lookahead + ctr->lookahead_len, &ctr->key)) != CRYPT_OK) {
+            return err;
+         }
+         ctr->lookahead_len += ctr->blocklen;
+      }
+   }
+
+   ctr->sealed = LTC_STATE_SEALED;
+   return CRYPT_OK;
 }
 
 #endif
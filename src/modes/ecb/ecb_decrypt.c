@@ -31,19 +31,24 @@ int ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long len, s
    LTC_ARGCHK(pt != NULL);
    LTC_ARGCHK(ct != NULL);
    LTC_ARGCHK(ecb != NULL);
-   if ((err = cipher_is_valid(ecb->cipher)) != CRYPT_OK) {
-       return err;
+   if (ecb->sealed != LTC_STATE_SEALED) {
+      if ((err = cipher_is_valid(ecb->cipher)) != CRYPT_OK) {
+          return err;
+      }
    }
    if (len % cipher_descriptor[ecb->cipher].block_length) {
       return CRYPT_INVALID_ARG;
    }
 
+   LTC_STATS_BUMP(LTC_STAT_ECB_DECRYPT, ecb->cipher, len,
+                  cipher_descriptor[ecb->cipher].accel_ecb_decrypt == NULL);
+
    /* check for accel */
    if (cipher_descriptor[ecb->cipher].accel_ecb_decrypt != NULL) {
       return cipher_descriptor[ecb->cipher].accel_ecb_decrypt(ct, pt, len / cipher_descriptor[ecb->cipher].block_length, &ecb->key);
    } else {
       while (len) {
-         if ((err = cipher_descriptor[ecb->cipher].ecb_decrypt(ct, pt, &ecb->key)) != CRYPT_OK) {
+         if ((err = LTC_CIPHER_ECB_DECRYPT(ecb->cipher, ct, pt, &ecb->key)) != CRYPT_OK) {
             return err;
          }
          pt  += cipher_descriptor[ecb->cipher].block_length;
@@ -51,6 +56,9 @@ int ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long len, s
          len -= cipher_descriptor[ecb->cipher].block_length;
       }
    }
+#ifdef LTC_CLEAN_STACK
+   burn_stack_flush();
+#endif
    return CRYPT_OK;
 }
 
@@ -38,7 +38,11 @@ int ecb_start(int cipher, const unsigned char *key, int keylen, int num_rounds,
    }
    ecb->cipher = cipher;
    ecb->blocklen = cipher_descriptor[cipher].block_length;
-   return cipher_descriptor[cipher].setup(key, keylen, num_rounds, &ecb->key);
+   if ((err = cipher_setup_cached(cipher, key, keylen, num_rounds, &ecb->key)) != CRYPT_OK) {
+      return err;
+   }
+   ecb->sealed = LTC_STATE_SEALED;
+   return CRYPT_OK;
 }
 
 #endif
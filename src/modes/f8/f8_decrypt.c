@@ -19,7 +19,7 @@
 
 /**
    F8 decrypt
-   @param ct      Ciphertext
+   @param ct      Ciphertext (pt == ct is allowed)
    @param pt      [out] Plaintext
    @param len     Length of ciphertext (octets)
    @param f8      F8 state
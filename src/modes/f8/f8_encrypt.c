@@ -19,7 +19,7 @@
 
 /**
   F8 encrypt
-  @param pt     Plaintext
+  @param pt     Plaintext (may equal ct for in-place operation)
   @param ct     [out] Ciphertext
   @param len    Length of plaintext (octets)
   @param f8     F8 state
@@ -0,0 +1,66 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file f8_encrypt_packets.c
+  F8 implementation, encrypt an array of packets, Tom St Denis
+*/
+
+#ifdef LTC_F8_MODE
+
+/**
+  F8 encrypt a batch of independent packets with one scheduled key
+
+  Each packet is its own F8 stream: the state is re-IV'd (f8_setiv
+  semantics, block counter reset) before the packet is processed, so
+  the key schedule from f8_start is paid once for the whole batch
+  instead of once per packet.  Since F8 is an involution the same call
+  decrypts.
+
+  @param pt      [in] Array of 'packets' plaintext pointers
+  @param ct      [out] Array of 'packets' ciphertext pointers (may alias pt)
+  @param lens    [in] Array of 'packets' packet lengths (octets)
+  @param IVs     [in] Array of 'packets' per-packet IVs, each one block long
+  @param packets Number of packets in the batch
+  @param f8      F8 state (started with f8_start)
+  @return CRYPT_OK if successful
+*/
+int f8_encrypt_packets(const unsigned char * const *pt, unsigned char * const *ct,
+                       const unsigned long *lens, const unsigned char * const *IVs,
+                       unsigned long packets, symmetric_F8 *f8)
+{
+   unsigned long i;
+   int err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(lens != NULL);
+   LTC_ARGCHK(IVs  != NULL);
+   LTC_ARGCHK(f8   != NULL);
+
+   for (i = 0; i < packets; i++) {
+      if ((err = f8_setiv(IVs[i], f8->blocklen, f8)) != CRYPT_OK) {
+         return err;
+      }
+      f8->blockcnt = 0;
+      if ((err = f8_encrypt(pt[i], ct[i], lens[i], f8)) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
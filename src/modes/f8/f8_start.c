@@ -72,7 +72,7 @@ int f8_start(                int  cipher, const unsigned char *IV,
    }
 
    /* now encrypt with tkey[0..keylen-1] the IV and use that as the IV */
-   if ((err = cipher_descriptor[cipher].setup(tkey, keylen, num_rounds, &f8->key)) != CRYPT_OK) {
+   if ((err = cipher_setup_cached(cipher, tkey, keylen, num_rounds, &f8->key)) != CRYPT_OK) {
       return err;
    }
 
@@ -88,7 +88,7 @@ int f8_start(                int  cipher, const unsigned char *IV,
    cipher_descriptor[f8->cipher].done(&f8->key);
 
    /* init the cipher */
-   return cipher_descriptor[cipher].setup(key, keylen, num_rounds, &f8->key);
+   return cipher_setup_cached(cipher, key, keylen, num_rounds, &f8->key);
 }
 
 #endif
@@ -55,6 +55,11 @@ int lrw_process(const unsigned char *pt, unsigned char *ct, unsigned long len, i
       }
 
       /* update pad */
+#ifdef LTC_GF_CLMUL
+      if (lrw->clmul) {
+         gcm_gf_mult_clmul(lrw->tweak, lrw->IV, lrw->pad);
+      } else {
+#endif
 #ifdef LTC_LRW_TABLES
       /* for each byte changed we undo it's affect on the pad then add the new product */
       for (; x < 16; x++) {
@@ -71,6 +76,9 @@ int lrw_process(const unsigned char *pt, unsigned char *ct, unsigned long len, i
 #else
       gcm_gf_mult(lrw->tweak, lrw->IV, lrw->pad);
 #endif
+#ifdef LTC_GF_CLMUL
+      }
+#endif
 
       /* xor prod */
 #ifdef LTC_FAST
@@ -85,11 +93,11 @@ int lrw_process(const unsigned char *pt, unsigned char *ct, unsigned long len, i
 
       /* send through cipher */
       if (mode == LRW_ENCRYPT) {
-         if ((err = cipher_descriptor[lrw->cipher].ecb_encrypt(ct, ct, &lrw->key)) != CRYPT_OK) {
+         if ((err = LTC_CIPHER_ECB_ENCRYPT(lrw->cipher, ct, ct, &lrw->key)) != CRYPT_OK) {
             return err;
          }
       } else {
-         if ((err = cipher_descriptor[lrw->cipher].ecb_decrypt(ct, ct, &lrw->key)) != CRYPT_OK) {
+         if ((err = LTC_CIPHER_ECB_DECRYPT(lrw->cipher, ct, ct, &lrw->key)) != CRYPT_OK) {
             return err;
          }
       }
@@ -51,6 +51,13 @@ int lrw_setiv(const unsigned char *IV, unsigned long len, symmetric_LRW *lrw)
        return CRYPT_OK;
    }
 
+#ifdef LTC_GF_CLMUL
+   if (lrw->clmul) {
+      gcm_gf_mult_clmul(lrw->tweak, IV, lrw->pad);
+      return CRYPT_OK;
+   }
+#endif
+
 #ifdef LTC_LRW_TABLES
    XMEMCPY(T, &lrw->PC[0][IV[0]][0], 16);
    for (x = 1; x < 16; x++) {
@@ -61,7 +61,7 @@ int lrw_start(               int   cipher,
    }
 
    /* schedule key */
-   if ((err = cipher_descriptor[cipher].setup(key, keylen, num_rounds, &lrw->key)) != CRYPT_OK) {
+   if ((err = cipher_setup_cached(cipher, key, keylen, num_rounds, &lrw->key)) != CRYPT_OK) {
       return err;
    }
    lrw->cipher = cipher;
@@ -69,7 +69,16 @@ int lrw_start(               int   cipher,
    /* copy the IV and tweak */
    XMEMCPY(lrw->tweak, tweak, 16);
 
+#ifdef LTC_GF_CLMUL
+   /* with a carry-less multiplier the per-block product is cheap enough
+    * that the 64KB table build below is a net loss; decide at runtime */
+   lrw->clmul = gcm_gf_mult_clmul_enabled();
+#endif
+
 #ifdef LTC_LRW_TABLES
+#ifdef LTC_GF_CLMUL
+   if (!lrw->clmul) {
+#endif
    /* setup tables */
    /* generate the first table as it has no shifting (from which we make the other tables) */
    zeromem(B, 16);
@@ -90,6 +99,9 @@ int lrw_start(               int   cipher,
          lrw->PC[x][y][1] ^= gcm_shift_table[(t<<1)+1];
       }
    }
+#ifdef LTC_GF_CLMUL
+   }
+#endif
 #endif
 
    /* generate first pad */
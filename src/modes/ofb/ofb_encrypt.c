@@ -19,7 +19,7 @@
 
 /**
   OFB encrypt
-  @param pt     Plaintext
+  @param pt     Plaintext (may equal ct for in-place operation)
   @param ct     [out] Ciphertext
   @param len    Length of plaintext (octets)
   @param ofb    OFB state
@@ -41,9 +41,34 @@ int ofb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, s
       return CRYPT_INVALID_ARG;
    }
 
+   /* trickle bytes until the keystream block boundary */
+   while (len > 0 && ofb->padlen != ofb->blocklen) {
+       *ct++ = *pt++ ^ ofb->IV[(ofb->padlen)++];
+       --len;
+   }
+
+   /* whole-block segments: one cipher call and a wide XOR per block */
+#ifdef LTC_FAST
+   if ((ofb->blocklen % sizeof(LTC_FAST_TYPE)) == 0) {
+      int x;
+      while (len >= (unsigned long)ofb->blocklen) {
+         if ((err = LTC_CIPHER_ECB_ENCRYPT(ofb->cipher, ofb->IV, ofb->IV, &ofb->key)) != CRYPT_OK) {
+            return err;
+         }
+         for (x = 0; x < ofb->blocklen; x += sizeof(LTC_FAST_TYPE)) {
+            *(LTC_FAST_TYPE_PTR_CAST(ct + x)) = *(LTC_FAST_TYPE_PTR_CAST(pt + x)) ^
+                                                *(LTC_FAST_TYPE_PTR_CAST(ofb->IV + x));
+         }
+         pt  += ofb->blocklen;
+         ct  += ofb->blocklen;
+         len -= ofb->blocklen;
+      }
+   }
+#endif
+
    while (len-- > 0) {
        if (ofb->padlen == ofb->blocklen) {
-          if ((err = cipher_descriptor[ofb->cipher].ecb_encrypt(ofb->IV, ofb->IV, &ofb->key)) != CRYPT_OK) {
+          if ((err = LTC_CIPHER_ECB_ENCRYPT(ofb->cipher, ofb->IV, ofb->IV, &ofb->key)) != CRYPT_OK) {
              return err;
           }
           ofb->padlen = 0;
@@ -50,7 +50,7 @@ int ofb_start(int cipher, const unsigned char *IV, const unsigned char *key,
 
    /* init the cipher */
    ofb->padlen = ofb->blocklen;
-   return cipher_descriptor[cipher].setup(key, keylen, num_rounds, &ofb->key);
+   return cipher_setup_cached(cipher, key, keylen, num_rounds, &ofb->key);
 }
 
 #endif
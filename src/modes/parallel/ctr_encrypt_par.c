@@ -0,0 +1,142 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ctr_encrypt_par.c
+  Parallel-modes layer, split CTR encryption, Tom St Denis
+*/
+
+#ifdef LTC_CTR_MODE
+
+/* advance the counter by 'delta' blocks in one pass */
+static void _ctr_add(symmetric_CTR *ctr, ulong64 delta)
+{
+   ulong64 carry;
+   int     x;
+
+   carry = delta;
+   if (ctr->mode == CTR_COUNTER_LITTLE_ENDIAN) {
+      for (x = 0; x < ctr->ctrlen && carry != 0; x++) {
+         carry += (ulong64)ctr->ctr[x];
+         ctr->ctr[x] = (unsigned char)(carry & 255);
+         carry >>= 8;
+      }
+   } else {
+      for (x = ctr->blocklen-1; x >= ctr->ctrlen && carry != 0; x--) {
+         carry += (ulong64)ctr->ctr[x];
+         ctr->ctr[x] = (unsigned char)(carry & 255);
+         carry >>= 8;
+      }
+   }
+}
+
+static int _ctr_par_job(ltc_parallel_job *job)
+{
+   job->err = ctr_encrypt(job->in, job->out, job->len, (symmetric_CTR *)job->state);
+   return job->err;
+}
+
+/**
+  CTR encrypt a large buffer as independent slices
+
+  Every slice gets a private copy of the CTR state with the counter
+  advanced to its offset, so the slices may run in any order.  The CTR
+  state must sit on a block boundary (padlen 0 or blocklen, i.e. right
+  after ctr_start/ctr_setiv or after a block-aligned amount of data)
+  and must not use LTC_CTR_PREFETCH.  On success the caller's state is
+  advanced past the buffer as if ctr_encrypt had processed it.
+
+  @param pt     Plaintext (may equal ct for in-place operation)
+  @param ct     [out] Ciphertext
+  @param len    Length of plaintext (octets)
+  @param spec   The parallel spec (may be NULL for serial execution)
+  @param ctr    CTR state
+  @return CRYPT_OK if successful
+*/
+int ctr_encrypt_par(const unsigned char *pt, unsigned char *ct, unsigned long len,
+                    const ltc_parallel_spec *spec, symmetric_CTR *ctr)
+{
+   ltc_parallel_job *jobs;
+   symmetric_CTR    *states;
+   unsigned long     chunk, njobs, off, n, i;
+   int               err;
+
+   LTC_ARGCHK(pt  != NULL);
+   LTC_ARGCHK(ct  != NULL);
+   LTC_ARGCHK(ctr != NULL);
+
+   if ((err = cipher_is_valid(ctr->cipher)) != CRYPT_OK) {
+      return err;
+   }
+
+   if (ctr->blocklen < 1 || ctr->blocklen > (int)sizeof(ctr->ctr)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* mid-block pads and the lookahead window cannot be split up */
+   if (ctr->lookahead_on || (ctr->padlen != 0 && ctr->padlen != ctr->blocklen)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* round the slice size up to a whole number of blocks */
+   chunk = (spec != NULL && spec->chunk_size != 0) ? spec->chunk_size : 65536;
+   chunk += (ctr->blocklen - 1);
+   chunk -= chunk % ctr->blocklen;
+
+   if (len <= chunk) {
+      return ctr_encrypt(pt, ct, len, ctr);
+   }
+
+   njobs = (len + chunk - 1) / chunk;
+   if ((jobs = XMALLOC(njobs * sizeof(*jobs))) == NULL) {
+      return CRYPT_MEM;
+   }
+   if ((states = XMALLOC(njobs * sizeof(*states))) == NULL) {
+      XFREE(jobs);
+      return CRYPT_MEM;
+   }
+
+   for (i = 0, off = 0; i < njobs; i++, off += n) {
+      n = (len - off < chunk) ? (len - off) : chunk;
+      XMEMCPY(&states[i], ctr, sizeof(*ctr));
+      if (i > 0) {
+         /* with padlen == 0 the pad already holds the first keystream
+          * block, so the counter trails the stream by one increment */
+         _ctr_add(&states[i], (ulong64)(off / ctr->blocklen) - (ctr->padlen == 0 ? 1 : 0));
+         states[i].padlen = states[i].blocklen;
+      }
+      jobs[i].fn    = _ctr_par_job;
+      jobs[i].in    = pt + off;
+      jobs[i].out   = ct + off;
+      jobs[i].len   = n;
+      jobs[i].state = &states[i];
+      jobs[i].err   = CRYPT_OK;
+   }
+
+   if ((err = ltc_parallel_run(jobs, njobs, spec)) == CRYPT_OK) {
+      /* continue the caller's stream after the last slice */
+      XMEMCPY(ctr, &states[njobs-1], sizeof(*ctr));
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(states, njobs * sizeof(*states));
+#endif
+   XFREE(states);
+   XFREE(jobs);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,90 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ecb_encrypt_par.c
+  Parallel-modes layer, split ECB encryption, Tom St Denis
+*/
+
+#ifdef LTC_ECB_MODE
+
+static int _ecb_par_job(ltc_parallel_job *job)
+{
+   job->err = ecb_encrypt(job->in, job->out, job->len, (symmetric_ECB *)job->state);
+   return job->err;
+}
+
+/**
+  ECB encrypt a large buffer as independent slices
+
+  ECB has no cross-block state, so the ECB context is shared read-only
+  by every slice and any partitioning is valid.
+
+  @param pt     Plaintext (may equal ct for in-place operation)
+  @param ct     [out] Ciphertext
+  @param len    Length of plaintext (octets), must be a multiple of the block size
+  @param spec   The parallel spec (may be NULL for serial execution)
+  @param ecb    ECB state
+  @return CRYPT_OK if successful
+*/
+int ecb_encrypt_par(const unsigned char *pt, unsigned char *ct, unsigned long len,
+                    const ltc_parallel_spec *spec, symmetric_ECB *ecb)
+{
+   ltc_parallel_job *jobs;
+   unsigned long     chunk, njobs, off, n, i;
+   int               err;
+
+   LTC_ARGCHK(pt  != NULL);
+   LTC_ARGCHK(ct  != NULL);
+   LTC_ARGCHK(ecb != NULL);
+
+   if ((err = cipher_is_valid(ecb->cipher)) != CRYPT_OK) {
+      return err;
+   }
+   if (len % cipher_descriptor[ecb->cipher].block_length) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* round the slice size up to a whole number of blocks */
+   chunk = (spec != NULL && spec->chunk_size != 0) ? spec->chunk_size : 65536;
+   chunk += (cipher_descriptor[ecb->cipher].block_length - 1);
+   chunk -= chunk % cipher_descriptor[ecb->cipher].block_length;
+
+   if (len <= chunk) {
+      return ecb_encrypt(pt, ct, len, ecb);
+   }
+
+   njobs = (len + chunk - 1) / chunk;
+   if ((jobs = XMALLOC(njobs * sizeof(*jobs))) == NULL) {
+      return CRYPT_MEM;
+   }
+
+   for (i = 0, off = 0; i < njobs; i++, off += n) {
+      n = (len - off < chunk) ? (len - off) : chunk;
+      jobs[i].fn    = _ecb_par_job;
+      jobs[i].in    = pt + off;
+      jobs[i].out   = ct + off;
+      jobs[i].len   = n;
+      jobs[i].state = ecb;
+      jobs[i].err   = CRYPT_OK;
+   }
+
+   err = ltc_parallel_run(jobs, njobs, spec);
+   XFREE(jobs);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,64 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file parallel_run.c
+  Parallel-modes layer, job dispatch, Tom St Denis
+*/
+
+#if defined(LTC_ECB_MODE) || defined(LTC_CTR_MODE) || defined(LTC_XTS_MODE)
+
+/**
+  Run a set of parallel-mode jobs through the caller's pool (or serially)
+
+  The library never spawns threads itself; when spec->map is set it is
+  expected to call job->fn(job) for every job, on whatever threads it
+  likes, and only return once all of them finished.
+
+  @param jobs   The jobs to run
+  @param count  Number of jobs
+  @param spec   The parallel spec (may be NULL for serial execution)
+  @return CRYPT_OK if every job succeeded, else the first job's error
+*/
+int ltc_parallel_run(ltc_parallel_job *jobs, unsigned long count, const ltc_parallel_spec *spec)
+{
+   unsigned long i;
+   int err;
+
+   LTC_ARGCHK(jobs != NULL);
+
+   if (spec != NULL && spec->map != NULL) {
+      if ((err = spec->map(jobs, count, spec->pool)) != CRYPT_OK) {
+         return err;
+      }
+   } else {
+      for (i = 0; i < count; i++) {
+         if ((err = jobs[i].fn(&jobs[i])) != CRYPT_OK) {
+            return err;
+         }
+      }
+   }
+
+   /* pick up failures from jobs run inside a pool */
+   for (i = 0; i < count; i++) {
+      if (jobs[i].err != CRYPT_OK) {
+         return jobs[i].err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
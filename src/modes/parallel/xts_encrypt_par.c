@@ -0,0 +1,128 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file xts_encrypt_par.c
+  Parallel-modes layer, split XTS encryption, Tom St Denis
+*/
+
+#ifdef LTC_XTS_MODE
+
+static int _xts_par_job(ltc_parallel_job *job)
+{
+   job->err = xts_encrypt(job->in, job->len, job->out, job->tweak, (symmetric_xts *)job->state);
+   return job->err;
+}
+
+/**
+  XTS encrypt a large buffer as independent slices
+
+  Each slice gets the tweak for its own offset, derived by walking the
+  encrypted tweak forward block by block, so the slices may run in any
+  order.  A partial trailing block (ciphertext stealing) stays attached
+  to the last slice.  On return the tweak buffer holds the tweak past
+  the buffer, matching xts_encrypt.
+
+  @param pt     [in]  Plaintext (may equal ct for in-place operation)
+  @param ptlen  Length of plaintext (and ciphertext)
+  @param ct     [out] Ciphertext
+  @param tweak  [in] The 128--bit encryption tweak (e.g. sector number)
+  @param spec   The parallel spec (may be NULL for serial execution)
+  @param xts    The XTS structure
+  @return CRYPT_OK upon success
+*/
+int xts_encrypt_par(const unsigned char *pt, unsigned long ptlen, unsigned char *ct,
+                    unsigned char *tweak, const ltc_parallel_spec *spec, symmetric_xts *xts)
+{
+   ltc_parallel_job *jobs;
+   symmetric_xts    *states;
+   unsigned char     T[16];
+   unsigned long     chunk, njobs, off, n, i, j;
+   int               err;
+
+   LTC_ARGCHK(pt    != NULL);
+   LTC_ARGCHK(ct    != NULL);
+   LTC_ARGCHK(tweak != NULL);
+   LTC_ARGCHK(xts   != NULL);
+
+   if ((err = cipher_is_valid(xts->cipher)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* round the slice size up to a whole number of blocks */
+   chunk = (spec != NULL && spec->chunk_size != 0) ? spec->chunk_size : 65536;
+   chunk += 15;
+   chunk &= ~(unsigned long)15;
+
+   /* the stolen tail rides with the last full slice, so slice count comes
+    * from the whole blocks only */
+   njobs = ptlen / chunk;
+   if (njobs < 2) {
+      return xts_encrypt(pt, ptlen, ct, tweak, xts);
+   }
+
+   if ((jobs = XMALLOC(njobs * sizeof(*jobs))) == NULL) {
+      return CRYPT_MEM;
+   }
+   /* private contexts: xts_encrypt scribbles on the tweak_tab scratch */
+   if ((states = XMALLOC(njobs * sizeof(*states))) == NULL) {
+      XFREE(jobs);
+      return CRYPT_MEM;
+   }
+
+   /* encrypt the tweak once, then walk it to each slice boundary */
+   if ((err = cipher_descriptor[xts->cipher].ecb_encrypt(tweak, T, &xts->key2)) != CRYPT_OK) {
+      goto done;
+   }
+
+   for (i = 0, off = 0; i < njobs; i++, off += n) {
+      n = (i + 1 == njobs) ? (ptlen - off) : chunk;
+      XMEMCPY(&states[i], xts, sizeof(*xts));
+      if (i == 0) {
+         XMEMCPY(jobs[i].tweak, tweak, 16);
+      } else {
+         for (j = 0; j < chunk >> 4; j++) {
+            xts_mult_x(T);
+         }
+         /* xts_encrypt takes the tweak unencrypted */
+         if ((err = cipher_descriptor[xts->cipher].ecb_decrypt(T, jobs[i].tweak, &xts->key2)) != CRYPT_OK) {
+            goto done;
+         }
+      }
+      jobs[i].fn    = _xts_par_job;
+      jobs[i].in    = pt + off;
+      jobs[i].out   = ct + off;
+      jobs[i].len   = n;
+      jobs[i].state = &states[i];
+      jobs[i].err   = CRYPT_OK;
+   }
+
+   if ((err = ltc_parallel_run(jobs, njobs, spec)) == CRYPT_OK) {
+      /* xts_encrypt left the advanced tweak in the last slice's copy */
+      XMEMCPY(tweak, jobs[njobs-1].tweak, 16);
+   }
+
+done:
+#ifdef LTC_CLEAN_STACK
+   zeromem(states, njobs * sizeof(*states));
+   zeromem(T, sizeof(T));
+#endif
+   XFREE(states);
+   XFREE(jobs);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
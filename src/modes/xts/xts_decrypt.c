@@ -50,8 +50,51 @@ static int tweak_uncrypt(const unsigned char *C, unsigned char *P, unsigned char
    return err;
 }
 
+/* process 'blocks' blocks at once: materialize the tweak stream into
+ * xts->tweak_tab, XOR it in, run the multi-block ECB accelerator over the
+ * whole stripe and XOR the tweaks back out */
+static int tweak_uncrypt_bulk(const unsigned char *C, unsigned char *P, unsigned char *T,
+                              unsigned long blocks, symmetric_xts *xts)
+{
+   unsigned long i, x;
+   int err;
+
+   for (i = 0; i < blocks; i++) {
+      XMEMCPY(xts->tweak_tab + (i << 4), T, 16);
+      xts_mult_x(T);
+   }
+
+   x = blocks << 4;
+#ifdef LTC_FAST
+   for (i = 0; i < x; i += sizeof(LTC_FAST_TYPE)) {
+      *(LTC_FAST_TYPE_PTR_CAST(&P[i])) = *(LTC_FAST_TYPE_PTR_CAST(&C[i])) ^
+                                         *(LTC_FAST_TYPE_PTR_CAST(&xts->tweak_tab[i]));
+   }
+#else
+   for (i = 0; i < x; i++) {
+      P[i] = C[i] ^ xts->tweak_tab[i];
+   }
+#endif
+
+   if ((err = cipher_descriptor[xts->cipher].accel_ecb_decrypt(P, P, blocks, &xts->key1)) != CRYPT_OK) {
+      return err;
+   }
+
+#ifdef LTC_FAST
+   for (i = 0; i < x; i += sizeof(LTC_FAST_TYPE)) {
+      *(LTC_FAST_TYPE_PTR_CAST(&P[i])) ^= *(LTC_FAST_TYPE_PTR_CAST(&xts->tweak_tab[i]));
+   }
+#else
+   for (i = 0; i < x; i++) {
+      P[i] = P[i] ^ xts->tweak_tab[i];
+   }
+#endif
+
+   return CRYPT_OK;
+}
+
 /** XTS Decryption
- @param ct     [in] Ciphertext
+ @param ct     [in] Ciphertext (pt == ct is allowed)
  @param ptlen  Length of plaintext (and ciphertext)
  @param pt     [out]  Plaintext
  @param tweak  [in] The 128--bit encryption tweak (e.g. sector number)
@@ -109,7 +152,23 @@ int xts_decrypt(const unsigned char *ct, unsigned long ptlen, unsigned char *pt,
          return err;
       }
 
-      for (i = 0; i < lim; i++) {
+      i = 0;
+      if (cipher_descriptor[xts->cipher].accel_ecb_decrypt != NULL) {
+         unsigned long n;
+         while (lim - i >= 2) {
+            n = lim - i;
+            if (n > LTC_XTS_BULK_BLOCKS) {
+               n = LTC_XTS_BULK_BLOCKS;
+            }
+            if ((err = tweak_uncrypt_bulk(ct, pt, T, n, xts)) != CRYPT_OK) {
+               return err;
+            }
+            ct += n << 4;
+            pt += n << 4;
+            i  += n;
+         }
+      }
+      for (; i < lim; i++) {
          if ((err = tweak_uncrypt(ct, pt, T, xts)) != CRYPT_OK) {
             return err;
          }
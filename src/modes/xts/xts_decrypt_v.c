@@ -0,0 +1,211 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file xts_decrypt_v.c
+  XTS implementation, decrypt a scattered data unit, Tom St Denis
+*/
+
+#ifdef LTC_XTS_MODE
+
+static int tweak_uncrypt(const unsigned char *C, unsigned char *P, unsigned char *T, symmetric_xts *xts)
+{
+   unsigned long x;
+   int err;
+
+   /* tweak encrypt block i */
+#ifdef LTC_FAST
+   for (x = 0; x < 16; x += sizeof(LTC_FAST_TYPE)) {
+      *(LTC_FAST_TYPE_PTR_CAST(&P[x])) = *(LTC_FAST_TYPE_PTR_CAST(&C[x])) ^ *(LTC_FAST_TYPE_PTR_CAST(&T[x]));
+   }
+#else
+   for (x = 0; x < 16; x++) {
+      P[x] = C[x] ^ T[x];
+   }
+#endif
+
+   err = cipher_descriptor[xts->cipher].ecb_decrypt(P, P, &xts->key1);
+
+#ifdef LTC_FAST
+   for (x = 0; x < 16; x += sizeof(LTC_FAST_TYPE)) {
+      *(LTC_FAST_TYPE_PTR_CAST(&P[x])) ^= *(LTC_FAST_TYPE_PTR_CAST(&T[x]));
+   }
+#else
+   for (x = 0; x < 16; x++) {
+      P[x] = P[x] ^ T[x];
+   }
+#endif
+
+   /* LFSR the tweak */
+   xts_mult_x(T);
+
+   return err;
+}
+
+/* copy n octets out of the chain starting at fragment *f offset *o,
+ * advancing the cursor */
+static void _gather(const ltc_iovec *iov, int *f, unsigned long *o,
+                    unsigned char *dst, unsigned long n)
+{
+   unsigned long a;
+   while (n > 0) {
+      a = iov[*f].len - *o;
+      if (a == 0) { (*f)++; *o = 0; continue; }
+      if (a > n)  { a = n; }
+      XMEMCPY(dst, iov[*f].data + *o, a);
+      dst += a; *o += a; n -= a;
+   }
+}
+
+/* the reverse: copy n octets back into the chain */
+static void _scatter(const ltc_iovec *iov, int *f, unsigned long *o,
+                     const unsigned char *src, unsigned long n)
+{
+   unsigned long a;
+   while (n > 0) {
+      a = iov[*f].len - *o;
+      if (a == 0) { (*f)++; *o = 0; continue; }
+      if (a > n)  { a = n; }
+      XMEMCPY(iov[*f].data + *o, src, a);
+      src += a; *o += a; n -= a;
+   }
+}
+
+/** XTS Decryption of a scattered data unit (see xts_encrypt_v() for
+ the layout rules; the result matches xts_decrypt() on the coalesced
+ buffer, including the ciphertext-stealing tail)
+ @param iov    The array of fragments, decrypted in place
+ @param iovcnt The number of fragments
+ @param tweak  [in] The 128--bit encryption tweak (e.g. sector number)
+ @param xts    The XTS structure
+ Returns CRYPT_OK upon success
+*/
+int xts_decrypt_v(const ltc_iovec *iov, int iovcnt, unsigned char *tweak,
+                  symmetric_xts *xts)
+{
+   unsigned char PP[16], CC[16], T[16], g[16], tail[32];
+   unsigned long total, avail, i, m, mo, lim, n, o, so;
+   int x, f, sf, err;
+
+   /* check inputs */
+   LTC_ARGCHK(tweak != NULL);
+   LTC_ARGCHK(xts   != NULL);
+   LTC_ARGCHK(iov   != NULL || iovcnt == 0);
+
+   /* check if valid */
+   if ((err = cipher_is_valid(xts->cipher)) != CRYPT_OK) {
+      return err;
+   }
+
+   total = 0;
+   for (x = 0; x < iovcnt; x++) {
+      LTC_ARGCHK(iov[x].data != NULL || iov[x].len == 0);
+      total += iov[x].len;
+   }
+
+   /* get number of blocks */
+   m  = total >> 4;
+   mo = total & 15;
+
+   /* must have at least one full block */
+   if (m == 0) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   if (mo == 0) {
+      lim = m;
+   } else {
+      lim = m - 1;
+   }
+
+   /* encrypt the tweak */
+   if ((err = cipher_descriptor[xts->cipher].ecb_encrypt(tweak, T, &xts->key2)) != CRYPT_OK) {
+      return err;
+   }
+
+   f = 0;
+   o = 0;
+   i = 0;
+   while (i < lim) {
+      avail = iov[f].len - o;
+      if (avail == 0) {
+         f++; o = 0;
+         continue;
+      }
+      if (avail >= 16) {
+         /* whole blocks are contiguous here; crypt them in place */
+         n = avail >> 4;
+         if (n > lim - i) {
+            n = lim - i;
+         }
+         i += n;
+         while (n-- > 0) {
+            if ((err = tweak_uncrypt(iov[f].data + o, iov[f].data + o, T, xts)) != CRYPT_OK) {
+               return err;
+            }
+            o += 16;
+         }
+         continue;
+      }
+      /* this block straddles one or more fragment boundaries */
+      sf = f; so = o;
+      _gather(iov, &f, &o, g, 16);
+      if ((err = tweak_uncrypt(g, g, T, xts)) != CRYPT_OK) {
+         return err;
+      }
+      _scatter(iov, &sf, &so, g, 16);
+      i++;
+   }
+
+   /* if the total does not divide 16 then */
+   if (mo > 0) {
+      /* the stolen tail may straddle too; stage it through a buffer */
+      sf = f; so = o;
+      _gather(iov, &f, &o, tail, 16 + mo);
+
+      XMEMCPY(CC, T, 16);
+      xts_mult_x(CC);
+
+      /* PP = tweak decrypt block m-1 */
+      if ((err = tweak_uncrypt(tail, PP, CC, xts)) != CRYPT_OK) {
+         return err;
+      }
+
+      /* Pm = first 'mo' bytes of PP */
+      for (i = 0; i < mo; i++) {
+         CC[i]        = tail[16 + i];
+         tail[16 + i] = PP[i];
+      }
+      for (; i < 16; i++) {
+         CC[i] = PP[i];
+      }
+
+      /* Pm-1 = Tweak uncrypt CC */
+      if ((err = tweak_uncrypt(CC, tail, T, xts)) != CRYPT_OK) {
+         return err;
+      }
+      _scatter(iov, &sf, &so, tail, 16 + mo);
+   }
+
+   /* Decrypt the tweak back */
+   if ((err = cipher_descriptor[xts->cipher].ecb_decrypt(T, tweak, &xts->key2)) != CRYPT_OK) {
+      return err;
+   }
+
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -52,8 +52,51 @@ static int tweak_crypt(const unsigned char *P, unsigned char *C, unsigned char *
    return CRYPT_OK;
 }
 
+/* process 'blocks' blocks at once: materialize the tweak stream into
+ * xts->tweak_tab, XOR it in, run the multi-block ECB accelerator over the
+ * whole stripe and XOR the tweaks back out */
+static int tweak_crypt_bulk(const unsigned char *P, unsigned char *C, unsigned char *T,
+                            unsigned long blocks, symmetric_xts *xts)
+{
+   unsigned long i, x;
+   int err;
+
+   for (i = 0; i < blocks; i++) {
+      XMEMCPY(xts->tweak_tab + (i << 4), T, 16);
+      xts_mult_x(T);
+   }
+
+   x = blocks << 4;
+#ifdef LTC_FAST
+   for (i = 0; i < x; i += sizeof(LTC_FAST_TYPE)) {
+      *(LTC_FAST_TYPE_PTR_CAST(&C[i])) = *(LTC_FAST_TYPE_PTR_CAST(&P[i])) ^
+                                         *(LTC_FAST_TYPE_PTR_CAST(&xts->tweak_tab[i]));
+   }
+#else
+   for (i = 0; i < x; i++) {
+      C[i] = P[i] ^ xts->tweak_tab[i];
+   }
+#endif
+
+   if ((err = cipher_descriptor[xts->cipher].accel_ecb_encrypt(C, C, blocks, &xts->key1)) != CRYPT_OK) {
+      return err;
+   }
+
+#ifdef LTC_FAST
+   for (i = 0; i < x; i += sizeof(LTC_FAST_TYPE)) {
+      *(LTC_FAST_TYPE_PTR_CAST(&C[i])) ^= *(LTC_FAST_TYPE_PTR_CAST(&xts->tweak_tab[i]));
+   }
+#else
+   for (i = 0; i < x; i++) {
+      C[i] = C[i] ^ xts->tweak_tab[i];
+   }
+#endif
+
+   return CRYPT_OK;
+}
+
 /** XTS Encryption
- @param pt     [in]  Plaintext
+ @param pt     [in]  Plaintext (may equal ct for in-place operation)
  @param ptlen  Length of plaintext (and ciphertext)
  @param ct     [out] Ciphertext
  @param tweak  [in] The 128--bit encryption tweak (e.g. sector number)
@@ -112,7 +155,23 @@ int xts_encrypt(const unsigned char *pt, unsigned long ptlen, unsigned char *ct,
          return err;
       }
 
-      for (i = 0; i < lim; i++) {
+      i = 0;
+      if (cipher_descriptor[xts->cipher].accel_ecb_encrypt != NULL) {
+         unsigned long n;
+         while (lim - i >= 2) {
+            n = lim - i;
+            if (n > LTC_XTS_BULK_BLOCKS) {
+               n = LTC_XTS_BULK_BLOCKS;
+            }
+            if ((err = tweak_crypt_bulk(pt, ct, T, n, xts)) != CRYPT_OK) {
+               return err;
+            }
+            ct += n << 4;
+            pt += n << 4;
+            i  += n;
+         }
+      }
+      for (; i < lim; i++) {
          if ((err = tweak_crypt(pt, ct, T, xts)) != CRYPT_OK) {
             return err;
          }
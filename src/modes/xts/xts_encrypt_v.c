@@ -0,0 +1,213 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file xts_encrypt_v.c
+  XTS implementation, encrypt a scattered data unit, Tom St Denis
+*/
+
+#ifdef LTC_XTS_MODE
+
+static int tweak_crypt(const unsigned char *P, unsigned char *C, unsigned char *T, symmetric_xts *xts)
+{
+   unsigned long x;
+   int err;
+
+   /* tweak encrypt block i */
+#ifdef LTC_FAST
+   for (x = 0; x < 16; x += sizeof(LTC_FAST_TYPE)) {
+      *(LTC_FAST_TYPE_PTR_CAST(&C[x])) = *(LTC_FAST_TYPE_PTR_CAST(&P[x])) ^ *(LTC_FAST_TYPE_PTR_CAST(&T[x]));
+   }
+#else
+   for (x = 0; x < 16; x++) {
+      C[x] = P[x] ^ T[x];
+   }
+#endif
+
+   if ((err = cipher_descriptor[xts->cipher].ecb_encrypt(C, C, &xts->key1)) != CRYPT_OK) {
+      return err;
+   }
+
+#ifdef LTC_FAST
+   for (x = 0; x < 16; x += sizeof(LTC_FAST_TYPE)) {
+      *(LTC_FAST_TYPE_PTR_CAST(&C[x])) ^= *(LTC_FAST_TYPE_PTR_CAST(&T[x]));
+   }
+#else
+   for (x = 0; x < 16; x++) {
+      C[x] = C[x] ^ T[x];
+   }
+#endif
+
+   /* LFSR the tweak */
+   xts_mult_x(T);
+
+   return CRYPT_OK;
+}
+
+/* copy n octets out of the chain starting at fragment *f offset *o,
+ * advancing the cursor */
+static void _gather(const ltc_iovec *iov, int *f, unsigned long *o,
+                    unsigned char *dst, unsigned long n)
+{
+   unsigned long a;
+   while (n > 0) {
+      a = iov[*f].len - *o;
+      if (a == 0) { (*f)++; *o = 0; continue; }
+      if (a > n)  { a = n; }
+      XMEMCPY(dst, iov[*f].data + *o, a);
+      dst += a; *o += a; n -= a;
+   }
+}
+
+/* the reverse: copy n octets back into the chain */
+static void _scatter(const ltc_iovec *iov, int *f, unsigned long *o,
+                     const unsigned char *src, unsigned long n)
+{
+   unsigned long a;
+   while (n > 0) {
+      a = iov[*f].len - *o;
+      if (a == 0) { (*f)++; *o = 0; continue; }
+      if (a > n)  { a = n; }
+      XMEMCPY(iov[*f].data + *o, src, a);
+      src += a; *o += a; n -= a;
+   }
+}
+
+/** XTS Encryption of a scattered data unit.  The fragment chain is one
+ XTS data unit: the result is bit for bit what xts_encrypt() produces
+ on the coalesced buffer, including the ciphertext-stealing tail.
+ Fragments are encrypted in place and may split blocks anywhere;
+ blocks that straddle a boundary are gathered and scattered through a
+ stack block, so nothing larger than the 32-octet tail is ever copied.
+ @param iov    The array of fragments, encrypted in place
+ @param iovcnt The number of fragments
+ @param tweak  [in] The 128--bit encryption tweak (e.g. sector number)
+ @param xts    The XTS structure
+ Returns CRYPT_OK upon success
+*/
+int xts_encrypt_v(const ltc_iovec *iov, int iovcnt, unsigned char *tweak,
+                  symmetric_xts *xts)
+{
+   unsigned char PP[16], CC[16], T[16], g[16], tail[32];
+   unsigned long total, avail, i, m, mo, lim, n, o, so;
+   int x, f, sf, err;
+
+   /* check inputs */
+   LTC_ARGCHK(tweak != NULL);
+   LTC_ARGCHK(xts   != NULL);
+   LTC_ARGCHK(iov   != NULL || iovcnt == 0);
+
+   /* check if valid */
+   if ((err = cipher_is_valid(xts->cipher)) != CRYPT_OK) {
+      return err;
+   }
+
+   total = 0;
+   for (x = 0; x < iovcnt; x++) {
+      LTC_ARGCHK(iov[x].data != NULL || iov[x].len == 0);
+      total += iov[x].len;
+   }
+
+   /* get number of blocks */
+   m  = total >> 4;
+   mo = total & 15;
+
+   /* must have at least one full block */
+   if (m == 0) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   if (mo == 0) {
+      lim = m;
+   } else {
+      lim = m - 1;
+   }
+
+   /* encrypt the tweak */
+   if ((err = cipher_descriptor[xts->cipher].ecb_encrypt(tweak, T, &xts->key2)) != CRYPT_OK) {
+      return err;
+   }
+
+   f = 0;
+   o = 0;
+   i = 0;
+   while (i < lim) {
+      avail = iov[f].len - o;
+      if (avail == 0) {
+         f++; o = 0;
+         continue;
+      }
+      if (avail >= 16) {
+         /* whole blocks are contiguous here; crypt them in place */
+         n = avail >> 4;
+         if (n > lim - i) {
+            n = lim - i;
+         }
+         i += n;
+         while (n-- > 0) {
+            if ((err = tweak_crypt(iov[f].data + o, iov[f].data + o, T, xts)) != CRYPT_OK) {
+               return err;
+            }
+            o += 16;
+         }
+         continue;
+      }
+      /* this block straddles one or more fragment boundaries */
+      sf = f; so = o;
+      _gather(iov, &f, &o, g, 16);
+      if ((err = tweak_crypt(g, g, T, xts)) != CRYPT_OK) {
+         return err;
+      }
+      _scatter(iov, &sf, &so, g, 16);
+      i++;
+   }
+
+   /* if the total does not divide 16 then */
+   if (mo > 0) {
+      /* the stolen tail may straddle too; stage it through a buffer */
+      sf = f; so = o;
+      _gather(iov, &f, &o, tail, 16 + mo);
+
+      /* CC = tweak encrypt block m-1 */
+      if ((err = tweak_crypt(tail, CC, T, xts)) != CRYPT_OK) {
+         return err;
+      }
+
+      /* Cm = first 'mo' bytes of CC */
+      for (i = 0; i < mo; i++) {
+         PP[i]        = tail[16 + i];
+         tail[16 + i] = CC[i];
+      }
+      for (; i < 16; i++) {
+         PP[i] = CC[i];
+      }
+
+      /* Cm-1 = Tweak encrypt PP */
+      if ((err = tweak_crypt(PP, tail, T, xts)) != CRYPT_OK) {
+         return err;
+      }
+      _scatter(iov, &sf, &so, tail, 16 + mo);
+   }
+
+   /* Decrypt the tweak back */
+   if ((err = cipher_descriptor[xts->cipher].ecb_decrypt(T, tweak, &xts->key2)) != CRYPT_OK) {
+      return err;
+   }
+
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,115 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file xts_filehandle.c
+  XTS implementation, sector-granular file handle helpers, Tom St Denis
+
+  File-image companions to xts_encrypt_sectors(): the stream is treated
+  as consecutive data units of sector_size octets starting at
+  first_sector, pumped through the overlapped I/O driver of
+  file_pipeline_filehandle().  The input must be a whole number of
+  sectors; a trailing fragment fails with CRYPT_INVALID_ARG.
+*/
+
+#if defined(LTC_XTS_MODE) && !defined(LTC_NO_FILE)
+
+struct s_xts_file_state {
+   symmetric_xts *xts;
+   ulong64        sector_num;      /* next data unit number */
+   unsigned long  sector_size;
+   int            decrypt;
+};
+
+static int s_xts_file_xform(void *state, unsigned char *buf,
+                            unsigned long *len, int final)
+{
+   struct s_xts_file_state *f = state;
+   unsigned char tweak[16];
+   unsigned long i;
+   int           err;
+
+   LTC_UNUSED_PARAM(final);
+   if ((*len % f->sector_size) != 0) {
+      return CRYPT_INVALID_ARG;
+   }
+   for (i = 0; i < *len; i += f->sector_size, f->sector_num++) {
+      STORE64L(f->sector_num, tweak);
+      zeromem(tweak + 8, 8);
+      if (f->decrypt) {
+         err = xts_decrypt(buf + i, f->sector_size, buf + i, tweak, f->xts);
+      } else {
+         err = xts_encrypt(buf + i, f->sector_size, buf + i, tweak, f->xts);
+      }
+      if (err != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+static int s_xts_filehandle(FILE *in, FILE *out, unsigned long sector_size,
+                            ulong64 first_sector, symmetric_xts *xts, int decrypt)
+{
+   struct s_xts_file_state f;
+
+   LTC_ARGCHK(in  != NULL);
+   LTC_ARGCHK(out != NULL);
+   LTC_ARGCHK(xts != NULL);
+   /* one cipher block minimum, and sectors must pack the pipeline's
+    * 256KB chunks exactly -- any power of two up to 256KB qualifies */
+   if (sector_size < 16 || ((256*1024) % sector_size) != 0) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   f.xts         = xts;
+   f.sector_num  = first_sector;
+   f.sector_size = sector_size;
+   f.decrypt     = decrypt;
+   return file_pipeline_filehandle(in, out, s_xts_file_xform, &f);
+}
+
+/**
+  XTS encrypt a file image of whole sectors between open file handles
+  @param in            The input handle (read to EOF from the current position)
+  @param out           The output handle
+  @param sector_size   Size of one data unit (octets)
+  @param first_sector  Data unit number of the first sector
+  @param xts           The XTS state
+  @return CRYPT_OK if successful
+*/
+int xts_encrypt_filehandle(FILE *in, FILE *out, unsigned long sector_size,
+                           ulong64 first_sector, symmetric_xts *xts)
+{
+   return s_xts_filehandle(in, out, sector_size, first_sector, xts, 0);
+}
+
+/**
+  XTS decrypt a file image of whole sectors between open file handles
+  @param in            The input handle (read to EOF from the current position)
+  @param out           The output handle
+  @param sector_size   Size of one data unit (octets)
+  @param first_sector  Data unit number of the first sector
+  @param xts           The XTS state
+  @return CRYPT_OK if successful
+*/
+int xts_decrypt_filehandle(FILE *in, FILE *out, unsigned long sector_size,
+                           ulong64 first_sector, symmetric_xts *xts)
+{
+   return s_xts_filehandle(in, out, sector_size, first_sector, xts, 1);
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
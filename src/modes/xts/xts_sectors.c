@@ -0,0 +1,93 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file xts_sectors.c
+  XTS batch interface for independent data units (disk sectors).  Each
+  sector is a self-contained XTS data unit whose tweak is derived from
+  its sector number (IEEE 1619: little-endian 128-bit), so the entries
+  of a batch do not depend on each other; callers that want to spread a
+  batch across cores can simply shard the arrays and hand each worker
+  its own slice with the same (read-only) symmetric_xts state.
+*/
+
+#ifdef LTC_XTS_MODE
+
+/** XTS sector-batch encryption
+ @param pt           [in] Array of 'sectors' plaintext sector pointers
+ @param ct           [out] Array of 'sectors' ciphertext sector pointers (may alias pt)
+ @param sectors      Number of sectors in the batch
+ @param sector_size  Size of each sector in octets (at least 16)
+ @param sector_nums  [in] Array of 'sectors' data-unit (sector) numbers
+ @param xts          The XTS structure
+ Returns CRYPT_OK upon success
+*/
+int xts_encrypt_sectors(const unsigned char * const *pt, unsigned char * const *ct,
+                        unsigned long sectors, unsigned long sector_size,
+                        const ulong64 *sector_nums, symmetric_xts *xts)
+{
+   unsigned char tweak[16];
+   unsigned long i;
+   int err;
+
+   LTC_ARGCHK(pt          != NULL);
+   LTC_ARGCHK(ct          != NULL);
+   LTC_ARGCHK(sector_nums != NULL);
+   LTC_ARGCHK(xts         != NULL);
+
+   for (i = 0; i < sectors; i++) {
+      STORE64L(sector_nums[i], tweak);
+      zeromem(tweak + 8, 8);
+      if ((err = xts_encrypt(pt[i], sector_size, ct[i], tweak, xts)) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+/** XTS sector-batch decryption
+ @param ct           [in] Array of 'sectors' ciphertext sector pointers
+ @param pt           [out] Array of 'sectors' plaintext sector pointers (may alias ct)
+ @param sectors      Number of sectors in the batch
+ @param sector_size  Size of each sector in octets (at least 16)
+ @param sector_nums  [in] Array of 'sectors' data-unit (sector) numbers
+ @param xts          The XTS structure
+ Returns CRYPT_OK upon success
+*/
+int xts_decrypt_sectors(const unsigned char * const *ct, unsigned char * const *pt,
+                        unsigned long sectors, unsigned long sector_size,
+                        const ulong64 *sector_nums, symmetric_xts *xts)
+{
+   unsigned char tweak[16];
+   unsigned long i;
+   int err;
+
+   LTC_ARGCHK(pt          != NULL);
+   LTC_ARGCHK(ct          != NULL);
+   LTC_ARGCHK(sector_nums != NULL);
+   LTC_ARGCHK(xts         != NULL);
+
+   for (i = 0; i < sectors; i++) {
+      STORE64L(sector_nums[i], tweak);
+      zeromem(tweak + 8, 8);
+      if ((err = xts_decrypt(ct[i], sector_size, pt[i], tweak, xts)) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
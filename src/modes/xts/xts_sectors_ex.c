@@ -0,0 +1,184 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file xts_sectors_ex.c
+  XTS sector batches with pluggable per-sector tweak policies.  The
+  plain xts_*_sectors calls hard-code the IEEE 1619 little-endian
+  sector-number tweak; disk targets that inherited other layouts
+  (big-endian sector numbers, dm-crypt ESSIV) supply a policy callback
+  here instead of open-coding the sector loop.  Policies are stateless
+  or carry their own read-only context, so sharded batches keep working
+  across worker threads.
+*/
+
+#ifdef LTC_XTS_MODE
+
+/* the default policy: IEEE 1619 little-endian sector number */
+static int s_tweak_plain64(ulong64 sector_num, unsigned char *tweak, void *ctx)
+{
+   LTC_UNUSED_PARAM(ctx);
+   STORE64L(sector_num, tweak);
+   zeromem(tweak + 8, 8);
+   return CRYPT_OK;
+}
+
+/** Initialize an ESSIV tweak policy (dm-crypt style): the tweak is the
+    sector number encrypted under a digest of the disk key, so sector
+    numbers never appear as raw tweaks on disk
+ @param essiv   The policy context to fill
+ @param cipher  Index of the cipher (128-bit block; normally the XTS cipher)
+ @param hash    Index of the hash used to derive the tweak key
+ @param key     The disk key (normally the full XTS key material)
+ @param keylen  The length of the key (octets)
+ Returns CRYPT_OK upon success
+*/
+int xts_essiv_init(ltc_xts_essiv *essiv, int cipher, int hash,
+                   const unsigned char *key, unsigned long keylen)
+{
+   unsigned char salt[MAXBLOCKSIZE];
+   unsigned long saltlen;
+   int keysize, err;
+
+   LTC_ARGCHK(essiv != NULL);
+   LTC_ARGCHK(key   != NULL);
+
+   if ((err = cipher_is_valid(cipher)) != CRYPT_OK) return err;
+   if ((err = hash_is_valid(hash))     != CRYPT_OK) return err;
+   if (cipher_descriptor[cipher].block_length != 16) {
+      return CRYPT_INVALID_CIPHER;
+   }
+
+   saltlen = sizeof(salt);
+   if ((err = hash_memory(hash, key, keylen, salt, &saltlen)) != CRYPT_OK) {
+      return err;
+   }
+   /* clamp the digest to a key size the cipher accepts */
+   keysize = (int)saltlen;
+   if ((err = cipher_descriptor[cipher].keysize(&keysize)) != CRYPT_OK) {
+      goto error;
+   }
+   err = cipher_descriptor[cipher].setup(salt, keysize, 0, &essiv->K);
+   essiv->cipher = cipher;
+error:
+   zeromem(salt, sizeof(salt));
+   return err;
+}
+
+/** The ESSIV tweak policy; pass with its ltc_xts_essiv as tweak_ctx */
+int xts_essiv_tweak(ulong64 sector_num, unsigned char *tweak, void *ctx)
+{
+   ltc_xts_essiv *essiv = ctx;
+   unsigned char blk[16];
+
+   LTC_ARGCHK(ctx != NULL);
+   STORE64L(sector_num, blk);
+   zeromem(blk + 8, 8);
+   return cipher_descriptor[essiv->cipher].ecb_encrypt(blk, tweak, &essiv->K);
+}
+
+/** Terminate an ESSIV policy, wiping the tweak key */
+int xts_essiv_done(ltc_xts_essiv *essiv)
+{
+   LTC_ARGCHK(essiv != NULL);
+   if (cipher_descriptor[essiv->cipher].done != NULL) {
+      cipher_descriptor[essiv->cipher].done(&essiv->K);
+   }
+   zeromem(essiv, sizeof(*essiv));
+   return CRYPT_OK;
+}
+
+/** XTS sector-batch encryption with a tweak policy
+ @param pt           [in] Array of 'sectors' plaintext sector pointers
+ @param ct           [out] Array of 'sectors' ciphertext sector pointers (may alias pt)
+ @param sectors      Number of sectors in the batch
+ @param sector_size  Size of each sector in octets (at least 16)
+ @param sector_nums  [in] Array of 'sectors' data-unit (sector) numbers
+ @param tweak_fn     Per-sector tweak policy (NULL for IEEE 1619 plain64)
+ @param tweak_ctx    Opaque context handed to tweak_fn
+ @param xts          The XTS structure
+ Returns CRYPT_OK upon success
+*/
+int xts_encrypt_sectors_ex(const unsigned char * const *pt, unsigned char * const *ct,
+                           unsigned long sectors, unsigned long sector_size,
+                           const ulong64 *sector_nums,
+                           ltc_xts_tweak_fn tweak_fn, void *tweak_ctx,
+                           symmetric_xts *xts)
+{
+   unsigned char tweak[16];
+   unsigned long i;
+   int err;
+
+   LTC_ARGCHK(pt          != NULL);
+   LTC_ARGCHK(ct          != NULL);
+   LTC_ARGCHK(sector_nums != NULL);
+   LTC_ARGCHK(xts         != NULL);
+
+   if (tweak_fn == NULL) {
+      tweak_fn = s_tweak_plain64;
+   }
+   for (i = 0; i < sectors; i++) {
+      if ((err = tweak_fn(sector_nums[i], tweak, tweak_ctx)) != CRYPT_OK) {
+         return err;
+      }
+      if ((err = xts_encrypt(pt[i], sector_size, ct[i], tweak, xts)) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+/** XTS sector-batch decryption with a tweak policy
+ @param ct           [in] Array of 'sectors' ciphertext sector pointers
+ @param pt           [out] Array of 'sectors' plaintext sector pointers (may alias ct)
+ @param sectors      Number of sectors in the batch
+ @param sector_size  Size of each sector in octets (at least 16)
+ @param sector_nums  [in] Array of 'sectors' data-unit (sector) numbers
+ @param tweak_fn     Per-sector tweak policy (NULL for IEEE 1619 plain64)
+ @param tweak_ctx    Opaque context handed to tweak_fn
+ @param xts          The XTS structure
+ Returns CRYPT_OK upon success
+*/
+int xts_decrypt_sectors_ex(const unsigned char * const *ct, unsigned char * const *pt,
+                           unsigned long sectors, unsigned long sector_size,
+                           const ulong64 *sector_nums,
+                           ltc_xts_tweak_fn tweak_fn, void *tweak_ctx,
+                           symmetric_xts *xts)
+{
+   unsigned char tweak[16];
+   unsigned long i;
+   int err;
+
+   LTC_ARGCHK(pt          != NULL);
+   LTC_ARGCHK(ct          != NULL);
+   LTC_ARGCHK(sector_nums != NULL);
+   LTC_ARGCHK(xts         != NULL);
+
+   if (tweak_fn == NULL) {
+      tweak_fn = s_tweak_plain64;
+   }
+   for (i = 0; i < sectors; i++) {
+      if ((err = tweak_fn(sector_nums[i], tweak, tweak_ctx)) != CRYPT_OK) {
+         return err;
+      }
+      if ((err = xts_decrypt(ct[i], sector_size, pt[i], tweak, xts)) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -49,16 +49,7 @@ int der_decode_integer(const unsigned char *in, unsigned long inlen, void *num)
 
    if ((z & 0x80) == 0x00) {
       /* short form */
-
-      /* will it overflow? */
-      if (x + z > inlen) {
-         return CRYPT_INVALID_PACKET;
-      }
-
-      /* no so read it */
-      if ((err = mp_read_unsigned_bin(num, (unsigned char *)in + x, z)) != CRYPT_OK) {
-         return err;
-      }
+      y = z;
    } else {
       /* long form */
       z &= 0x7F;
@@ -73,16 +64,25 @@ int der_decode_integer(const unsigned char *in, unsigned long inlen, void *num)
       while (z--) {
          y = ((unsigned long)(in[x++])) | (y << 8);
       }
+   }
 
-      /* now will reading y bytes overrun? */
-      if ((x + y) > inlen) {
-         return CRYPT_INVALID_PACKET;
-      }
+   /* will reading y bytes overrun? */
+   if ((x + y) > inlen) {
+      return CRYPT_INVALID_PACKET;
+   }
 
-      /* no so read it */
-      if ((err = mp_read_unsigned_bin(num, (unsigned char *)in + x, y)) != CRYPT_OK) {
-         return err;
+   /* non-negative fast path: strip the sign/padding octets up front and
+    * hand only the magnitude to the math backend in one bulk read */
+   if (y > 0 && (in[x] & 0x80) == 0x00) {
+      while (y > 1 && in[x] == 0x00) {
+         ++x;
+         --y;
       }
+      return mp_read_unsigned_bin(num, (unsigned char *)in + x, y);
+   }
+
+   if ((err = mp_read_unsigned_bin(num, (unsigned char *)in + x, y)) != CRYPT_OK) {
+      return err;
    }
 
    /* see if it's negative */
@@ -29,33 +29,67 @@
 int der_encode_integer(void *num, unsigned char *out, unsigned long *outlen)
 {
    unsigned long tmplen, y;
-   int           err, leading_zero;
+   int           err, leading_zero, bits;
 
    LTC_ARGCHK(num    != NULL);
    LTC_ARGCHK(out    != NULL);
    LTC_ARGCHK(outlen != NULL);
 
-   /* find out how big this will be */
-   if ((err = der_length_integer(num, &tmplen)) != CRYPT_OK) {
-      return err;
-   }
-
-   if (*outlen < tmplen) {
-      *outlen = tmplen;
-      return CRYPT_BUFFER_OVERFLOW;
-   }
+   if (mp_iszero(num) == LTC_MP_YES) {
+      /* zero encodes as the single octet 0x00; backends disagree on
+       * mp_count_bits(0) (LTM says 0, GMP says 1), so handle it
+       * explicitly rather than through the bit count below */
+      leading_zero = 1;
+      y            = 1;
+      tmplen       = 2 + y;
+
+      if (*outlen < tmplen) {
+         *outlen = tmplen;
+         return CRYPT_BUFFER_OVERFLOW;
+      }
+   } else if (mp_cmp_d(num, 0) != LTC_MP_LT) {
+      /* positive fast path: a single bit count sizes the whole
+       * encoding */
+      bits = mp_count_bits(num);
 
-   if (mp_cmp_d(num, 0) != LTC_MP_LT) {
       /* we only need a leading zero if the msb of the first byte is one */
-      if ((mp_count_bits(num) & 7) == 0 || mp_iszero(num) == LTC_MP_YES) {
+      if ((bits & 7) == 0) {
          leading_zero = 1;
       } else {
          leading_zero = 0;
       }
 
       /* get length of num in bytes (plus 1 since we force the msbyte to zero) */
-      y = mp_unsigned_bin_size(num) + leading_zero;
+      y = (unsigned long)((bits + 7) >> 3) + leading_zero;
+
+      /* header plus payload */
+      if (y < 128) {
+         tmplen = 2 + y;
+      } else if (y < 256) {
+         tmplen = 3 + y;
+      } else if (y < 65536UL) {
+         tmplen = 4 + y;
+      } else if (y < 16777216UL) {
+         tmplen = 5 + y;
+      } else {
+         return CRYPT_INVALID_ARG;
+      }
+
+      if (*outlen < tmplen) {
+         *outlen = tmplen;
+         return CRYPT_BUFFER_OVERFLOW;
+      }
    } else {
+      /* find out how big this will be */
+      if ((err = der_length_integer(num, &tmplen)) != CRYPT_OK) {
+         return err;
+      }
+
+      if (*outlen < tmplen) {
+         *outlen = tmplen;
+         return CRYPT_BUFFER_OVERFLOW;
+      }
+
       leading_zero = 0;
       y            = mp_count_bits(num);
       y            = y + (8 - (y & 7));
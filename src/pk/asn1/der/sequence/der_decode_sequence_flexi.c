@@ -53,16 +53,44 @@ static unsigned long fetch_length(const unsigned char *in, unsigned long inlen,
    return z+*data_offset;
 }
 
-static int new_element(ltc_asn1_list **l)
+/* carve zeroed memory from the arena, or fall back to the heap when no
+ * arena was supplied; arena exhaustion is reported as NULL just like a
+ * failed XCALLOC */
+static void *arena_calloc(ltc_asn1_arena *arena, unsigned long nmemb, unsigned long size)
+{
+   unsigned long len, ofs;
+   void          *p;
+
+   if (arena == NULL) {
+      return XCALLOC(nmemb, size);
+   }
+
+   len = nmemb * size;
+   if (nmemb != 0 && len / nmemb != size) {
+      return NULL;
+   }
+
+   /* keep carves pointer aligned */
+   ofs = (arena->used + (sizeof(void *) - 1)) & ~((unsigned long)sizeof(void *) - 1);
+   if (ofs > arena->size || arena->size - ofs < len) {
+      return NULL;
+   }
+   p = arena->base + ofs;
+   arena->used = ofs + len;
+   XMEMSET(p, 0, len);
+   return p;
+}
+
+static int new_element(ltc_asn1_list **l, ltc_asn1_arena *arena)
 {
    /* alloc new link */
    if (*l == NULL) {
-      *l = XCALLOC(1, sizeof(ltc_asn1_list));
+      *l = arena_calloc(arena, 1, sizeof(ltc_asn1_list));
       if (*l == NULL) {
          return CRYPT_MEM;
       }
    } else {
-      (*l)->next = XCALLOC(1, sizeof(ltc_asn1_list));
+      (*l)->next = arena_calloc(arena, 1, sizeof(ltc_asn1_list));
       if ((*l)->next == NULL) {
          return CRYPT_MEM;
       }
@@ -72,14 +100,7 @@ static int new_element(ltc_asn1_list **l)
    return CRYPT_OK;
 }
 
-/**
-   ASN.1 DER Flexi(ble) decoder will decode arbitrary DER packets and create a linked list of the decoded elements.
-   @param in      The input buffer
-   @param inlen   [in/out] The length of the input buffer and on output the amount of decoded data
-   @param out     [out] A pointer to the linked list
-   @return CRYPT_OK on success.
-*/
-int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc_asn1_list **out)
+static int flexi_decode(const unsigned char *in, unsigned long *inlen, ltc_asn1_list **out, ltc_asn1_arena *arena, int flags)
 {
    ltc_asn1_list *l;
    unsigned long err, type, len, totlen, data_offset;
@@ -89,12 +110,14 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
    LTC_ARGCHK(inlen != NULL);
    LTC_ARGCHK(out   != NULL);
 
+   LTC_MEM_TAG("der");
+
    l = NULL;
    totlen = 0;
 
    if (*inlen == 0) {
       /* alloc new link */
-      if ((err = new_element(&l)) != CRYPT_OK) {
+      if ((err = new_element(&l, arena)) != CRYPT_OK) {
          goto error;
       }
    }
@@ -112,7 +135,7 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
       }
 
       /* alloc new link */
-      if ((err = new_element(&l)) != CRYPT_OK) {
+      if ((err = new_element(&l, arena)) != CRYPT_OK) {
          goto error;
       }
 
@@ -134,7 +157,7 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
          case 0x01: /* BOOLEAN */
             l->type = LTC_ASN1_BOOLEAN;
             l->size = 1;
-            l->data = XCALLOC(1, sizeof(int));
+            l->data = arena_calloc(arena, 1, sizeof(int));
 
             if ((err = der_decode_boolean(in, *inlen, l->data)) != CRYPT_OK) {
                goto error;
@@ -167,9 +190,18 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
          case 0x03: /* BIT */
             /* init field */
             l->type = LTC_ASN1_BIT_STRING;
+
+            if (flags & LTC_DER_FLEXI_BORROW) {
+               /* borrowed: raw content octets, the first one holding the
+                * unused-bit count, NOT one decoded bit per char */
+               l->data = (void *)(in + data_offset);
+               l->size = len - data_offset;
+               break;
+            }
+
             l->size = len * 8; /* *8 because we store decoded bits one per char and they are encoded 8 per char.  */
 
-            if ((l->data = XCALLOC(1, l->size)) == NULL) {
+            if ((l->data = arena_calloc(arena, 1, l->size)) == NULL) {
                err = CRYPT_MEM;
                goto error;
             }
@@ -187,9 +219,16 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
 
             /* init field */
             l->type = LTC_ASN1_OCTET_STRING;
+
+            if (flags & LTC_DER_FLEXI_BORROW) {
+               l->data = (void *)(in + data_offset);
+               l->size = len - data_offset;
+               break;
+            }
+
             l->size = len;
 
-            if ((l->data = XCALLOC(1, l->size)) == NULL) {
+            if ((l->data = arena_calloc(arena, 1, l->size)) == NULL) {
                err = CRYPT_MEM;
                goto error;
             }
@@ -225,7 +264,7 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
             l->type = LTC_ASN1_OBJECT_IDENTIFIER;
             l->size = len;
 
-            if ((l->data = XCALLOC(len, sizeof(unsigned long))) == NULL) {
+            if ((l->data = arena_calloc(arena, len, sizeof(unsigned long))) == NULL) {
                err = CRYPT_MEM;
                goto error;
             }
@@ -238,12 +277,15 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
                goto error;
             }
 
-            /* resize it to save a bunch of mem */
-            if ((realloc_tmp = XREALLOC(l->data, l->size * sizeof(unsigned long))) == NULL) {
-               /* out of heap but this is not an error */
-               break;
+            /* resize it to save a bunch of mem; arena carves cannot shrink
+             * and the arena is transient anyway */
+            if (arena == NULL) {
+               if ((realloc_tmp = XREALLOC(l->data, l->size * sizeof(unsigned long))) == NULL) {
+                  /* out of heap but this is not an error */
+                  break;
+               }
+               l->data = realloc_tmp;
             }
-            l->data = realloc_tmp;
             break;
 
          case 0x0C: /* UTF8 */
@@ -252,7 +294,7 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
             l->type = LTC_ASN1_UTF8_STRING;
             l->size = len;
 
-            if ((l->data = XCALLOC(sizeof(wchar_t), l->size)) == NULL) {
+            if ((l->data = arena_calloc(arena, sizeof(wchar_t), l->size)) == NULL) {
                err = CRYPT_MEM;
                goto error;
             }
@@ -270,9 +312,16 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
 
             /* init field */
             l->type = LTC_ASN1_PRINTABLE_STRING;
+
+            if (flags & LTC_DER_FLEXI_BORROW) {
+               l->data = (void *)(in + data_offset);
+               l->size = len - data_offset;
+               break;
+            }
+
             l->size = len;
 
-            if ((l->data = XCALLOC(1, l->size)) == NULL) {
+            if ((l->data = arena_calloc(arena, 1, l->size)) == NULL) {
                err = CRYPT_MEM;
                goto error;
             }
@@ -290,9 +339,16 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
 
             /* init field */
             l->type = LTC_ASN1_TELETEX_STRING;
+
+            if (flags & LTC_DER_FLEXI_BORROW) {
+               l->data = (void *)(in + data_offset);
+               l->size = len - data_offset;
+               break;
+            }
+
             l->size = len;
 
-            if ((l->data = XCALLOC(1, l->size)) == NULL) {
+            if ((l->data = arena_calloc(arena, 1, l->size)) == NULL) {
                err = CRYPT_MEM;
                goto error;
             }
@@ -310,9 +366,16 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
 
             /* init field */
             l->type = LTC_ASN1_IA5_STRING;
+
+            if (flags & LTC_DER_FLEXI_BORROW) {
+               l->data = (void *)(in + data_offset);
+               l->size = len - data_offset;
+               break;
+            }
+
             l->size = len;
 
-            if ((l->data = XCALLOC(1, l->size)) == NULL) {
+            if ((l->data = arena_calloc(arena, 1, l->size)) == NULL) {
                err = CRYPT_MEM;
                goto error;
             }
@@ -332,7 +395,7 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
             l->type = LTC_ASN1_UTCTIME;
             l->size = 1;
 
-            if ((l->data = XCALLOC(1, sizeof(ltc_utctime))) == NULL) {
+            if ((l->data = arena_calloc(arena, 1, sizeof(ltc_utctime))) == NULL) {
                err = CRYPT_MEM;
                goto error;
             }
@@ -351,7 +414,7 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
             l->type = LTC_ASN1_GENERALIZEDTIME;
             l->size = len;
 
-            if ((l->data = XCALLOC(1, sizeof(ltc_generalizedtime))) == NULL) {
+            if ((l->data = arena_calloc(arena, 1, sizeof(ltc_generalizedtime))) == NULL) {
                err = CRYPT_MEM;
                goto error;
             }
@@ -381,14 +444,25 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
                 l->type = LTC_ASN1_SET;
              }
 
-             if ((l->data = XMALLOC(len)) == NULL) {
-                err = CRYPT_MEM;
-                goto error;
+             if (flags & LTC_DER_FLEXI_BORROW) {
+                l->data = (void *)in;
+                l->size = len;
+             } else {
+                if (arena == NULL) {
+                   if ((l->data = XMALLOC(len)) == NULL) {
+                      err = CRYPT_MEM;
+                      goto error;
+                   }
+                } else {
+                   if ((l->data = arena_calloc(arena, 1, len)) == NULL) {
+                      err = CRYPT_MEM;
+                      goto error;
+                   }
+                }
+                XMEMCPY(l->data, in, len);
+                l->size = len;
              }
 
-             XMEMCPY(l->data, in, len);
-             l->size = len;
-
 
              /* jump to the start of the data */
              in     += data_offset;
@@ -396,7 +470,7 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
              len = len - data_offset;
 
              /* Sequence elements go as child */
-             if ((err = der_decode_sequence_flexi(in, &len, &(l->child))) != CRYPT_OK) {
+             if ((err = flexi_decode(in, &len, &(l->child), arena, flags)) != CRYPT_OK) {
                 goto error;
              }
 
@@ -414,7 +488,13 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
          case 0x80: /* Context-specific */
              l->type = LTC_ASN1_CONTEXT_SPECIFIC;
 
-             if ((l->data = XCALLOC(1, len - data_offset)) == NULL) {
+             if (flags & LTC_DER_FLEXI_BORROW) {
+                l->data = (void *)(in + data_offset);
+                l->size = len - data_offset;
+                break;
+             }
+
+             if ((l->data = arena_calloc(arena, 1, len - data_offset)) == NULL) {
                 err = CRYPT_MEM;
                 goto error;
              }
@@ -429,7 +509,9 @@ int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc
            /* remove link */
            if (l->prev) {
               l       = l->prev;
-              XFREE(l->next);
+              if (arena == NULL) {
+                 XFREE(l->next);
+              }
               l->next = NULL;
            }
            goto outside;
@@ -462,11 +544,70 @@ outside:
 
 error:
    /* free list */
-   der_sequence_free(l);
+   if (arena == NULL) {
+      der_sequence_free_ex(l, flags);
+   } else {
+      der_sequence_arena_free(l);
+   }
 
    return err;
 }
 
+/**
+   ASN.1 DER Flexi(ble) decoder will decode arbitrary DER packets and create a linked list of the decoded elements.
+   @param in      The input buffer
+   @param inlen   [in/out] The length of the input buffer and on output the amount of decoded data
+   @param out     [out] A pointer to the linked list
+   @return CRYPT_OK on success.
+*/
+int der_decode_sequence_flexi(const unsigned char *in, unsigned long *inlen, ltc_asn1_list **out)
+{
+   return flexi_decode(in, inlen, out, NULL, 0);
+}
+
+/**
+   Flexi decoder carving nodes and payloads from a caller supplied arena.
+   Only INTEGER elements still touch the heap (they hold mp ints); free
+   the result with der_sequence_arena_free() then recycle the arena in
+   one shot.  Returns CRYPT_MEM when the arena is too small; retry with
+   a larger one (a few times the DER length is usually ample).
+   @param in      The input buffer
+   @param inlen   [in/out] The length of the input buffer and on output the amount of decoded data
+   @param out     [out] A pointer to the linked list
+   @param arena   The arena to carve from; used must be initialized (normally to zero)
+   @return CRYPT_OK on success.
+*/
+int der_decode_sequence_flexi_arena(const unsigned char *in, unsigned long *inlen, ltc_asn1_list **out, ltc_asn1_arena *arena)
+{
+   LTC_ARGCHK(arena       != NULL);
+   LTC_ARGCHK(arena->base != NULL);
+   return flexi_decode(in, inlen, out, arena, 0);
+}
+
+/**
+   Flexi decoder with options.  With LTC_DER_FLEXI_BORROW the string-ish
+   payloads (OCTET, BIT, IA5, PRINTABLE, TELETEX, CONTEXT SPECIFIC and
+   the raw SEQUENCE/SET/CONSTRUCTED copies) are NOT copied: 'data'
+   points into the caller's input, which must stay alive and unmodified
+   for the lifetime of the list.  A borrowed BIT STRING holds the raw
+   content octets (leading unused-bit count first), not one decoded bit
+   per char.  Free the result with der_sequence_free_ex() passing the
+   same flags, or with der_sequence_arena_free() when an arena is used.
+   @param in      The input buffer
+   @param inlen   [in/out] The length of the input buffer and on output the amount of decoded data
+   @param out     [out] A pointer to the linked list
+   @param arena   Optional arena to carve nodes from (may be NULL for heap nodes)
+   @param flags   LTC_DER_FLEXI_BORROW or 0
+   @return CRYPT_OK on success.
+*/
+int der_decode_sequence_flexi_ex(const unsigned char *in, unsigned long *inlen, ltc_asn1_list **out, ltc_asn1_arena *arena, int flags)
+{
+   if (arena != NULL) {
+      LTC_ARGCHK(arena->base != NULL);
+   }
+   return flexi_decode(in, inlen, out, arena, flags);
+}
+
 #endif
 
 
@@ -0,0 +1,338 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file der_encode_sequence_single.c
+  ASN.1 DER, encode a SEQUENCE measuring each element only once, Tom St Denis
+*/
+
+#ifdef LTC_DER
+
+/* der_encode_sequence_ex() measures the list, then each nested
+ * der_encode_sequence_ex() call measures its sub-list again, so deeply
+ * nested structures are traversed once per nesting level.  Here the
+ * content length of every (sub)sequence is computed bottom-up in a
+ * single walk and memoized in a pre-order side table; the encode walk
+ * then emits headers straight from the table. */
+
+/* lengths of this many nested sequences fit without a heap allocation */
+#define LTC_SEQ_TAB_STACK 32
+
+/* count the SEQUENCE nodes (the implicit root included by the caller) */
+static int seq_count(ltc_asn1_list *list, unsigned long inlen, unsigned long *count)
+{
+   unsigned long i;
+   int           err;
+
+   for (i = 0; i < inlen; i++) {
+      if (list[i].type == LTC_ASN1_EOL) {
+         break;
+      }
+      if (list[i].type == LTC_ASN1_SEQUENCE) {
+         ++(*count);
+         if ((err = seq_count(list[i].data, list[i].size, count)) != CRYPT_OK) {
+            return err;
+         }
+      }
+   }
+   return CRYPT_OK;
+}
+
+/* header octets needed for a content length */
+static int seq_hdrlen(unsigned long z, unsigned long *hdr)
+{
+   if (z < 128) {
+      *hdr = 2;
+   } else if (z < 256) {
+      *hdr = 3;
+   } else if (z < 65536UL) {
+      *hdr = 4;
+   } else if (z < 16777216UL) {
+      *hdr = 5;
+   } else {
+      return CRYPT_INVALID_ARG;
+   }
+   return CRYPT_OK;
+}
+
+/* measure the list, storing each (sub)sequence content length in tab in
+ * pre-order; *outlen receives the content length of this level */
+static int seq_lengths(ltc_asn1_list *list, unsigned long inlen,
+                       unsigned long *tab, unsigned long *tabidx, unsigned long *outlen)
+{
+   unsigned long i, x, y, slot, hdr;
+   int           err;
+
+   y = 0;
+   for (i = 0; i < inlen; i++) {
+      ltc_asn1_type type = list[i].type;
+      unsigned long size = list[i].size;
+      void          *data = list[i].data;
+
+      if (type == LTC_ASN1_EOL) {
+         break;
+      }
+
+      switch (type) {
+         case LTC_ASN1_BOOLEAN:
+            if ((err = der_length_boolean(&x)) != CRYPT_OK)                         { return err; }
+            y += x;
+            break;
+         case LTC_ASN1_INTEGER:
+            if ((err = der_length_integer(data, &x)) != CRYPT_OK)                   { return err; }
+            y += x;
+            break;
+         case LTC_ASN1_SHORT_INTEGER:
+            if ((err = der_length_short_integer(*((unsigned long*)data), &x)) != CRYPT_OK) { return err; }
+            y += x;
+            break;
+         case LTC_ASN1_BIT_STRING:
+         case LTC_ASN1_RAW_BIT_STRING:
+            if ((err = der_length_bit_string(size, &x)) != CRYPT_OK)                { return err; }
+            y += x;
+            break;
+         case LTC_ASN1_OCTET_STRING:
+            if ((err = der_length_octet_string(size, &x)) != CRYPT_OK)              { return err; }
+            y += x;
+            break;
+         case LTC_ASN1_NULL:
+            y += 2;
+            break;
+         case LTC_ASN1_OBJECT_IDENTIFIER:
+            if ((err = der_length_object_identifier(data, size, &x)) != CRYPT_OK)   { return err; }
+            y += x;
+            break;
+         case LTC_ASN1_IA5_STRING:
+            if ((err = der_length_ia5_string(data, size, &x)) != CRYPT_OK)          { return err; }
+            y += x;
+            break;
+         case LTC_ASN1_PRINTABLE_STRING:
+            if ((err = der_length_printable_string(data, size, &x)) != CRYPT_OK)    { return err; }
+            y += x;
+            break;
+         case LTC_ASN1_UTF8_STRING:
+            if ((err = der_length_utf8_string(data, size, &x)) != CRYPT_OK)         { return err; }
+            y += x;
+            break;
+         case LTC_ASN1_UTCTIME:
+            if ((err = der_length_utctime(data, &x)) != CRYPT_OK)                   { return err; }
+            y += x;
+            break;
+         case LTC_ASN1_GENERALIZEDTIME:
+            if ((err = der_length_generalizedtime(data, &x)) != CRYPT_OK)           { return err; }
+            y += x;
+            break;
+
+         case LTC_ASN1_SEQUENCE:
+            /* reserve the pre-order slot, then fill it bottom-up */
+            slot = (*tabidx)++;
+            if ((err = seq_lengths(data, size, tab, tabidx, &x)) != CRYPT_OK)       { return err; }
+            tab[slot] = x;
+            if ((err = seq_hdrlen(x, &hdr)) != CRYPT_OK)                            { return err; }
+            y += hdr + x;
+            break;
+
+         case LTC_ASN1_SET:
+         case LTC_ASN1_SETOF:
+            /* sets get sorted by their own encoder, delegate as-is */
+            if ((err = der_length_sequence(data, size, &x)) != CRYPT_OK)            { return err; }
+            y += x;
+            break;
+
+         case LTC_ASN1_CHOICE:
+         case LTC_ASN1_CONSTRUCTED:
+         case LTC_ASN1_CONTEXT_SPECIFIC:
+         case LTC_ASN1_EOL:
+         case LTC_ASN1_TELETEX_STRING:
+            return CRYPT_INVALID_ARG;
+      }
+   }
+
+   *outlen = y;
+   return CRYPT_OK;
+}
+
+/* emit one level: header from the memoized content length, then the
+ * elements; nested sequences recurse without re-measuring */
+static int seq_encode(ltc_asn1_list *list, unsigned long inlen,
+                      unsigned char *out, unsigned long *outlen,
+                      const unsigned long *tab, unsigned long *tabidx)
+{
+   unsigned long i, x, z, left;
+   int           err;
+
+   z = tab[(*tabidx)++];
+
+   x = 0;
+   out[x++] = 0x30;
+   if (z < 128) {
+      out[x++] = (unsigned char)z;
+   } else if (z < 256) {
+      out[x++] = 0x81;
+      out[x++] = (unsigned char)z;
+   } else if (z < 65536UL) {
+      out[x++] = 0x82;
+      out[x++] = (unsigned char)((z>>8UL)&255);
+      out[x++] = (unsigned char)(z&255);
+   } else if (z < 16777216UL) {
+      out[x++] = 0x83;
+      out[x++] = (unsigned char)((z>>16UL)&255);
+      out[x++] = (unsigned char)((z>>8UL)&255);
+      out[x++] = (unsigned char)(z&255);
+   } else {
+      return CRYPT_INVALID_ARG;
+   }
+
+   left = *outlen - x;
+   for (i = 0; i < inlen; i++) {
+      ltc_asn1_type type = list[i].type;
+      unsigned long size = list[i].size;
+      void          *data = list[i].data;
+
+      if (type == LTC_ASN1_EOL) {
+         break;
+      }
+
+      z = left;
+      switch (type) {
+         case LTC_ASN1_BOOLEAN:
+            err = der_encode_boolean(*((int *)data), out + x, &z);
+            break;
+         case LTC_ASN1_INTEGER:
+            err = der_encode_integer(data, out + x, &z);
+            break;
+         case LTC_ASN1_SHORT_INTEGER:
+            err = der_encode_short_integer(*((unsigned long*)data), out + x, &z);
+            break;
+         case LTC_ASN1_BIT_STRING:
+            err = der_encode_bit_string(data, size, out + x, &z);
+            break;
+         case LTC_ASN1_RAW_BIT_STRING:
+            err = der_encode_raw_bit_string(data, size, out + x, &z);
+            break;
+         case LTC_ASN1_OCTET_STRING:
+            err = der_encode_octet_string(data, size, out + x, &z);
+            break;
+         case LTC_ASN1_NULL:
+            out[x] = 0x05;
+            out[x+1] = 0x00;
+            z = 2;
+            err = CRYPT_OK;
+            break;
+         case LTC_ASN1_OBJECT_IDENTIFIER:
+            err = der_encode_object_identifier(data, size, out + x, &z);
+            break;
+         case LTC_ASN1_IA5_STRING:
+            err = der_encode_ia5_string(data, size, out + x, &z);
+            break;
+         case LTC_ASN1_PRINTABLE_STRING:
+            err = der_encode_printable_string(data, size, out + x, &z);
+            break;
+         case LTC_ASN1_UTF8_STRING:
+            err = der_encode_utf8_string(data, size, out + x, &z);
+            break;
+         case LTC_ASN1_UTCTIME:
+            err = der_encode_utctime(data, out + x, &z);
+            break;
+         case LTC_ASN1_GENERALIZEDTIME:
+            err = der_encode_generalizedtime(data, out + x, &z);
+            break;
+         case LTC_ASN1_SEQUENCE:
+            err = seq_encode(data, size, out + x, &z, tab, tabidx);
+            break;
+         case LTC_ASN1_SET:
+            err = der_encode_set(data, size, out + x, &z);
+            break;
+         case LTC_ASN1_SETOF:
+            err = der_encode_setof(data, size, out + x, &z);
+            break;
+         default:
+            err = CRYPT_INVALID_ARG;
+            break;
+      }
+      if (err != CRYPT_OK) {
+         return err;
+      }
+      x    += z;
+      left -= z;
+   }
+
+   *outlen = x;
+   return CRYPT_OK;
+}
+
+/**
+   Encode a SEQUENCE, measuring every nested element exactly once
+   @param list      The list of items to encode
+   @param inlen     The number of items in the list
+   @param out       [out] The destination
+   @param outlen    [in/out] The size of the output
+   @return CRYPT_OK on success
+*/
+int der_encode_sequence_single(ltc_asn1_list *list, unsigned long inlen,
+                               unsigned char *out,  unsigned long *outlen)
+{
+   unsigned long stack_tab[LTC_SEQ_TAB_STACK];
+   unsigned long *tab, nseq, tabidx, z, hdr;
+   int           err;
+
+   LTC_ARGCHK(list    != NULL);
+   LTC_ARGCHK(out     != NULL);
+   LTC_ARGCHK(outlen  != NULL);
+
+   /* one table slot per (sub)sequence plus the implicit root */
+   nseq = 1;
+   if ((err = seq_count(list, inlen, &nseq)) != CRYPT_OK) {
+      return err;
+   }
+   if (nseq <= LTC_SEQ_TAB_STACK) {
+      tab = stack_tab;
+   } else {
+      LTC_MEM_TAG("der");
+      tab = XMALLOC(nseq * sizeof(unsigned long));
+      if (tab == NULL) {
+         return CRYPT_MEM;
+      }
+   }
+
+   /* measure everything once, root content length goes in slot 0 */
+   tabidx = 1;
+   if ((err = seq_lengths(list, inlen, tab, &tabidx, &z)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   tab[0] = z;
+
+   if ((err = seq_hdrlen(z, &hdr)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if (*outlen < hdr + z) {
+      *outlen = hdr + z;
+      err = CRYPT_BUFFER_OVERFLOW;
+      goto LBL_ERR;
+   }
+
+   tabidx = 0;
+   err = seq_encode(list, inlen, out, outlen, tab, &tabidx);
+
+LBL_ERR:
+   if (tab != stack_tab) {
+      XFREE(tab);
+   }
+   return err;
+}
+
+#endif
+
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,61 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file der_sequence_arena_free.c
+  ASN.1 DER, release a structure decoded by der_decode_sequence_flexi_arena(), Tom St Denis
+*/
+
+#ifdef LTC_DER
+
+/**
+  Release a list decoded by der_decode_sequence_flexi_arena()
+
+  Nodes and payloads live in the caller's arena and are reclaimed by
+  recycling the arena; only INTEGER elements hold heap allocated mp
+  ints, so all this walk does is clear those.
+  @param in     The list to release
+*/
+void der_sequence_arena_free(ltc_asn1_list *in)
+{
+   if (!in) return;
+
+   /* walk to the start of the chain */
+   while (in->prev != NULL || in->parent != NULL) {
+      if (in->parent != NULL) {
+          in = in->parent;
+      } else {
+          in = in->prev;
+      }
+   }
+
+   /* clear the mp ints, the arena owns everything else */
+   while (in != NULL) {
+      if (in->child) {
+         in->child->parent = NULL;
+         der_sequence_arena_free(in->child);
+      }
+
+      if (in->type == LTC_ASN1_INTEGER && in->data != NULL) {
+         mp_clear(in->data);
+         in->data = NULL;
+      }
+
+      in = in->next;
+   }
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
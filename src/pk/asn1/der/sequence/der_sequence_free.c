@@ -18,10 +18,11 @@
 #ifdef LTC_DER
 
 /**
-  Free memory allocated by der_decode_sequence_flexi()
+  Free memory allocated by der_decode_sequence_flexi_ex()
   @param in     The list to free
+  @param flags  The flags the list was decoded with
 */
-void der_sequence_free(ltc_asn1_list *in)
+void der_sequence_free_ex(ltc_asn1_list *in, int flags)
 {
    ltc_asn1_list *l;
 
@@ -42,12 +43,24 @@ void der_sequence_free(ltc_asn1_list *in)
       if (in->child) {
          /* disconnect */
          in->child->parent = NULL;
-         der_sequence_free(in->child);
+         der_sequence_free_ex(in->child, flags);
       }
 
       switch (in->type) {
          case LTC_ASN1_SETOF: break;
          case LTC_ASN1_INTEGER : if (in->data != NULL) { mp_clear(in->data); } break;
+         /* with LTC_DER_FLEXI_BORROW these point into the caller's input */
+         case LTC_ASN1_BIT_STRING:
+         case LTC_ASN1_OCTET_STRING:
+         case LTC_ASN1_PRINTABLE_STRING:
+         case LTC_ASN1_TELETEX_STRING:
+         case LTC_ASN1_IA5_STRING:
+         case LTC_ASN1_CONTEXT_SPECIFIC:
+         case LTC_ASN1_CONSTRUCTED:
+         case LTC_ASN1_SEQUENCE:
+         case LTC_ASN1_SET:
+            if ((flags & LTC_DER_FLEXI_BORROW) == 0 && in->data != NULL) { XFREE(in->data); }
+            break;
          default               : if (in->data != NULL) { XFREE(in->data);    }
       }
 
@@ -58,6 +71,15 @@ void der_sequence_free(ltc_asn1_list *in)
    }
 }
 
+/**
+  Free memory allocated by der_decode_sequence_flexi()
+  @param in     The list to free
+*/
+void der_sequence_free(ltc_asn1_list *in)
+{
+   der_sequence_free_ex(in, 0);
+}
+
 #endif
 
 /* $Source$ */
@@ -0,0 +1,40 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file der_stream_done.c
+  ASN.1 DER, finish a streaming decode, Tom St Denis
+*/
+
+#ifdef LTC_DER
+
+/**
+  Finish a streaming DER decode
+  @param ds   The decoder state
+  @return CRYPT_OK if the stream ended on an element boundary with all
+          constructed elements closed, CRYPT_INVALID_PACKET otherwise
+*/
+int der_stream_done(der_stream_state *ds)
+{
+   LTC_ARGCHK(ds != NULL);
+
+   if (ds->state != 0 || ds->depth != 0 || ds->hdrlen != 0) {
+      return CRYPT_INVALID_PACKET;
+   }
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
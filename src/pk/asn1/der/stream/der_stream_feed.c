@@ -0,0 +1,211 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file der_stream_feed.c
+  ASN.1 DER, feed a chunk to the streaming decoder, Tom St Denis
+*/
+
+#ifdef LTC_DER
+
+/* decoder states */
+enum {
+   DER_STREAM_TAG = 0,   /* expecting an identifier octet   */
+   DER_STREAM_LEN,       /* expecting the first length octet */
+   DER_STREAM_LENN,      /* collecting long-form length octets */
+   DER_STREAM_DATA       /* streaming primitive content */
+};
+
+/* every consumed octet belongs to all open constructed elements */
+static int stream_account(der_stream_state *ds, unsigned long n)
+{
+   int x;
+   for (x = 0; x < ds->depth; x++) {
+      if (ds->remain[x] < n) {
+         return CRYPT_INVALID_PACKET;
+      }
+      ds->remain[x] -= n;
+   }
+   return CRYPT_OK;
+}
+
+/* pop every constructed element whose content is fully consumed */
+static int stream_close(der_stream_state *ds)
+{
+   int err;
+   while (ds->depth > 0 && ds->remain[ds->depth-1] == 0) {
+      --ds->depth;
+      if ((err = ds->event(LTC_DER_STREAM_END, (unsigned long)ds->depth,
+                           ds->tagstack[ds->depth], NULL, 0, ds->user)) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+/* a full header has been buffered; emit BEGIN and descend or start
+ * streaming the primitive content */
+static int stream_begin(der_stream_state *ds)
+{
+   int err;
+
+   /* the element must fit in its enclosing element */
+   if (ds->depth > 0 && ds->len > ds->remain[ds->depth-1]) {
+      return CRYPT_INVALID_PACKET;
+   }
+
+   if ((err = ds->event(LTC_DER_STREAM_BEGIN, (unsigned long)ds->depth,
+                        ds->tag, NULL, ds->len, ds->user)) != CRYPT_OK) {
+      return err;
+   }
+   ds->hdrlen = 0;
+
+   if (ds->tag & 0x20) {
+      /* constructed: push a level */
+      if (ds->depth >= LTC_DER_STREAM_DEPTH) {
+         return CRYPT_INVALID_PACKET;
+      }
+      ds->tagstack[ds->depth] = ds->tag;
+      ds->remain[ds->depth]   = ds->len;
+      ++ds->depth;
+      ds->state = DER_STREAM_TAG;
+      return stream_close(ds);
+   }
+
+   /* primitive */
+   ds->need  = ds->len;
+   ds->state = DER_STREAM_DATA;
+   if (ds->need == 0) {
+      if ((err = ds->event(LTC_DER_STREAM_END, (unsigned long)ds->depth,
+                           ds->tag, NULL, 0, ds->user)) != CRYPT_OK) {
+         return err;
+      }
+      ds->state = DER_STREAM_TAG;
+      return stream_close(ds);
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Feed a chunk of the encoding to the streaming decoder
+
+  Chunks may split anywhere, including inside headers; primitive
+  payloads are delivered as DATA slices pointing into the caller's
+  chunk, so nothing is buffered beyond the 6 header octets.
+  @param ds      The decoder state
+  @param in      The chunk
+  @param inlen   Length of the chunk in octets
+  @return CRYPT_OK if successful
+*/
+int der_stream_feed(der_stream_state *ds, const unsigned char *in, unsigned long inlen)
+{
+   unsigned long n;
+   int           err;
+
+   LTC_ARGCHK(ds != NULL);
+   if (inlen > 0) {
+      LTC_ARGCHK(in != NULL);
+   }
+
+   while (inlen > 0) {
+      switch (ds->state) {
+         case DER_STREAM_TAG:
+            ds->tag = *in;
+            /* multi-octet identifiers are not used by DER as produced
+             * by this library */
+            if ((ds->tag & 0x1F) == 0x1F) {
+               return CRYPT_INVALID_PACKET;
+            }
+            ds->hdr[0] = *in;
+            ds->hdrlen = 1;
+            if ((err = stream_account(ds, 1)) != CRYPT_OK) {
+               return err;
+            }
+            ++in; --inlen;
+            ds->state = DER_STREAM_LEN;
+            break;
+
+         case DER_STREAM_LEN:
+            n = *in;
+            ds->hdr[ds->hdrlen++] = *in;
+            if ((err = stream_account(ds, 1)) != CRYPT_OK) {
+               return err;
+            }
+            ++in; --inlen;
+            if (n < 128) {
+               ds->len = n;
+               if ((err = stream_begin(ds)) != CRYPT_OK) {
+                  return err;
+               }
+            } else {
+               n &= 0x7F;
+               /* 0x80 is the indefinite form which DER forbids */
+               if (n == 0 || n > 4) {
+                  return CRYPT_INVALID_PACKET;
+               }
+               ds->lenlen = n;
+               ds->len    = 0;
+               ds->state  = DER_STREAM_LENN;
+            }
+            break;
+
+         case DER_STREAM_LENN:
+            ds->len = (ds->len << 8) | ((unsigned long)*in);
+            ds->hdr[ds->hdrlen++] = *in;
+            if ((err = stream_account(ds, 1)) != CRYPT_OK) {
+               return err;
+            }
+            ++in; --inlen;
+            if (--ds->lenlen == 0) {
+               if ((err = stream_begin(ds)) != CRYPT_OK) {
+                  return err;
+               }
+            }
+            break;
+
+         case DER_STREAM_DATA:
+            n = MIN(ds->need, inlen);
+            if ((err = ds->event(LTC_DER_STREAM_DATA, (unsigned long)ds->depth,
+                                 ds->tag, in, n, ds->user)) != CRYPT_OK) {
+               return err;
+            }
+            if ((err = stream_account(ds, n)) != CRYPT_OK) {
+               return err;
+            }
+            in      += n;
+            inlen   -= n;
+            ds->need -= n;
+            if (ds->need == 0) {
+               if ((err = ds->event(LTC_DER_STREAM_END, (unsigned long)ds->depth,
+                                    ds->tag, NULL, 0, ds->user)) != CRYPT_OK) {
+                  return err;
+               }
+               ds->state = DER_STREAM_TAG;
+               if ((err = stream_close(ds)) != CRYPT_OK) {
+                  return err;
+               }
+            }
+            break;
+
+         default:
+            return CRYPT_INVALID_ARG;
+      }
+   }
+
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,49 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file der_stream_init.c
+  ASN.1 DER, initialize a streaming decoder, Tom St Denis
+*/
+
+#ifdef LTC_DER
+
+/**
+  Initialize a streaming DER decoder
+
+  The decoder is fed arbitrary chunks with der_stream_feed() and
+  reports the structure as TLV events through the callback, so
+  multi-megabyte objects parse in constant memory.
+  @param ds      The decoder state to initialize
+  @param event   The event callback
+  @param user    Opaque pointer handed to every callback invocation
+  @return CRYPT_OK if successful
+*/
+int der_stream_init(der_stream_state *ds,
+                    int (*event)(int ev, unsigned long depth, unsigned long tag,
+                                 const unsigned char *data, unsigned long len, void *user),
+                    void *user)
+{
+   LTC_ARGCHK(ds    != NULL);
+   LTC_ARGCHK(event != NULL);
+
+   XMEMSET(ds, 0, sizeof(*ds));
+   ds->event = event;
+   ds->user  = user;
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -20,6 +20,181 @@
 
 #include "dh_static.h"
 
+/* Fixed-base tables for the registered groups: fb_tab[x][i] holds
+ * g^(16^i) mod p for group sets[x].  A table is built the first time
+ * dh_make_key uses its group and is shared read-only afterwards, so
+ * ephemeral keygen pays one multiplication per 4-bit window of the
+ * exponent (Brickell et al.) instead of a full square-and-multiply.
+ */
+#define DH_FB_MAXSETS 16
+
+LTC_MUTEX_GLOBAL(ltc_dh_fb_mutex)
+
+static void **fb_tab[DH_FB_MAXSETS];
+static int    fb_len[DH_FB_MAXSETS];
+
+/* Cached Montgomery contexts for the group primes: the reduction
+ * digit from mp_montgomery_setup() plus the normalization residue.
+ * The groups never change, so the reduction setup that mp_exptmod
+ * re-derives on every call is paid once per group here instead. */
+static void *mont_mp[DH_FB_MAXSETS];
+static void *mont_R[DH_FB_MAXSETS];
+
+/* extract the 4-bit window starting at bit 4*n of a */
+static unsigned int _dh_fb_digit(void *a, int n)
+{
+   int           pos, d, b, have;
+   unsigned long v;
+
+   pos  = n << 2;
+   d    = pos / MP_DIGIT_BIT;
+   b    = pos % MP_DIGIT_BIT;
+   v    = (unsigned long)mp_get_digit(a, d) >> b;
+   have = MP_DIGIT_BIT - b;
+   if (have < 4) {
+      v |= (unsigned long)mp_get_digit(a, d + 1) << have;
+   }
+   return (unsigned int)(v & 15);
+}
+
+/* build the table for group idx; caller holds the lock */
+static int _dh_fb_build(int idx, void *g, void *p)
+{
+   void **tab;
+   int    i, len, err;
+
+   len = sets[idx].size * 2;      /* 4-bit windows in a size-octet exponent */
+   tab = XCALLOC(len, sizeof(*tab));
+   if (tab == NULL) {
+      return CRYPT_MEM;
+   }
+   for (i = 0; i < len; i++) {
+      if ((err = mp_init(&tab[i])) != CRYPT_OK) {
+         goto error;
+      }
+   }
+
+   /* tab[i+1] = tab[i]^16 mod p */
+   if ((err = mp_copy(g, tab[0])) != CRYPT_OK) {
+      goto error;
+   }
+   for (i = 1; i < len; i++) {
+      if ((err = mp_sqrmod(tab[i-1], p, tab[i])) != CRYPT_OK) { goto error; }
+      if ((err = mp_sqrmod(tab[i],   p, tab[i])) != CRYPT_OK) { goto error; }
+      if ((err = mp_sqrmod(tab[i],   p, tab[i])) != CRYPT_OK) { goto error; }
+      if ((err = mp_sqrmod(tab[i],   p, tab[i])) != CRYPT_OK) { goto error; }
+   }
+
+   fb_tab[idx] = tab;
+   fb_len[idx] = len;
+   return CRYPT_OK;
+error:
+   for (i = 0; i < len; i++) {
+      if (tab[i] != NULL) {
+         mp_clear(tab[i]);
+      }
+   }
+   XFREE(tab);
+   return err;
+}
+
+/* y = g^x mod p off the shared table; exponent digits >= fb_len[idx]
+ * cannot occur since x has at most sets[idx].size octets */
+static int _dh_fb_exptmod(int idx, void *x, void *p, void *y)
+{
+   void **tab, *A, *B;
+   int    w, i, len, err;
+
+   tab = fb_tab[idx];
+   len = fb_len[idx];
+
+   if ((err = mp_init_multi(&A, &B, NULL)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = mp_set(A, 1)) != CRYPT_OK) { goto error; }
+   if ((err = mp_set(B, 1)) != CRYPT_OK) { goto error; }
+
+   /* A = prod over w of (prod of tab[i] with digit(x,i) >= w); B carries
+    * the inner product down from w=15 so each table entry is used once */
+   for (w = 15; w >= 1; w--) {
+      for (i = 0; i < len; i++) {
+         if (_dh_fb_digit(x, i) == (unsigned int)w) {
+            if ((err = mp_mulmod(B, tab[i], p, B)) != CRYPT_OK) { goto error; }
+         }
+      }
+      if ((err = mp_mulmod(A, B, p, A)) != CRYPT_OK) { goto error; }
+   }
+   err = mp_copy(A, y);
+error:
+   mp_clear_multi(B, A, NULL);
+   return err;
+}
+
+/* y = g^x mod p through the group's cached Montgomery context,
+ * building the context the first time the group is used; anything
+ * that prevents caching falls back to plain mp_exptmod */
+static int _dh_mont_exptmod(int idx, void *g, void *x, void *p, void *y)
+{
+   int err;
+
+   if (ltc_mp.montgomery_setup  == NULL ||
+       ltc_mp.montgomery_reduce == NULL ||
+       idx < 0 || idx >= DH_FB_MAXSETS) {
+      return mp_exptmod(g, x, p, y);
+   }
+
+   LTC_MUTEX_LOCK(&ltc_dh_fb_mutex);
+   if (mont_mp[idx] == NULL) {
+      if ((err = mp_montgomery_setup(p, &mont_mp[idx])) != CRYPT_OK) {
+         mont_mp[idx] = NULL;
+         LTC_MUTEX_UNLOCK(&ltc_dh_fb_mutex);
+         return mp_exptmod(g, x, p, y);
+      }
+      if ((err = mp_init(&mont_R[idx])) != CRYPT_OK ||
+          (err = mp_montgomery_normalization(mont_R[idx], p)) != CRYPT_OK) {
+         if (mont_R[idx] != NULL) {
+            mp_clear(mont_R[idx]);
+            mont_R[idx] = NULL;
+         }
+         mp_montgomery_free(mont_mp[idx]);
+         mont_mp[idx] = NULL;
+         LTC_MUTEX_UNLOCK(&ltc_dh_fb_mutex);
+         return mp_exptmod(g, x, p, y);
+      }
+   }
+   LTC_MUTEX_UNLOCK(&ltc_dh_fb_mutex);
+
+   return ltc_mp_exptmod_mont(g, x, p, mont_mp[idx], mont_R[idx], y);
+}
+
+/**
+  Free the shared fixed-base tables and Montgomery contexts
+*/
+void dh_fixed_base_free(void)
+{
+   int x, i;
+   LTC_MUTEX_LOCK(&ltc_dh_fb_mutex);
+   for (x = 0; x < DH_FB_MAXSETS; x++) {
+      if (fb_tab[x] != NULL) {
+         for (i = 0; i < fb_len[x]; i++) {
+            mp_clear(fb_tab[x][i]);
+         }
+         XFREE(fb_tab[x]);
+         fb_tab[x] = NULL;
+         fb_len[x] = 0;
+      }
+      if (mont_mp[x] != NULL) {
+         mp_montgomery_free(mont_mp[x]);
+         mont_mp[x] = NULL;
+      }
+      if (mont_R[x] != NULL) {
+         mp_clear(mont_R[x]);
+         mont_R[x] = NULL;
+      }
+   }
+   LTC_MUTEX_UNLOCK(&ltc_dh_fb_mutex);
+}
+
 /**
    Test the DH sub-system (can take a while)
    @return CRYPT_OK if successful
@@ -163,7 +338,21 @@ int dh_make_key(prng_state *prng, int wprng, int keysize, dh_key *key)
 
    /* load the x value */
    if ((err = mp_read_unsigned_bin(key->x, buf, keysize)) != CRYPT_OK)     { goto error; }
-   if ((err = mp_exptmod(g, key->x, p, key->y)) != CRYPT_OK)            { goto error; }
+
+   /* build the group's fixed-base table on first use; a build failure
+    * just leaves the plain exptmod path */
+   if (key->idx < DH_FB_MAXSETS) {
+      LTC_MUTEX_LOCK(&ltc_dh_fb_mutex);
+      if (fb_tab[key->idx] == NULL) {
+         (void)_dh_fb_build(key->idx, g, p);
+      }
+      LTC_MUTEX_UNLOCK(&ltc_dh_fb_mutex);
+   }
+   if (key->idx < DH_FB_MAXSETS && fb_tab[key->idx] != NULL) {
+      if ((err = _dh_fb_exptmod(key->idx, key->x, p, key->y)) != CRYPT_OK) { goto error; }
+   } else {
+      if ((err = _dh_mont_exptmod(key->idx, g, key->x, p, key->y)) != CRYPT_OK) { goto error; }
+   }
    key->type = PK_PRIVATE;
 
    /* free up ram */
@@ -360,7 +549,7 @@ int dh_shared_secret(dh_key *private_key, dh_key *public_key,
    }
 
    if ((err = mp_read_radix(p, (char *)sets[private_key->idx].prime, 64)) != CRYPT_OK)     { goto error; }
-   if ((err = mp_exptmod(public_key->y, private_key->x, p, tmp)) != CRYPT_OK)           { goto error; }
+   if ((err = _dh_mont_exptmod(private_key->idx, public_key->y, private_key->x, p, tmp)) != CRYPT_OK) { goto error; }
 
    /* enough space for output? */
    x = (unsigned long)mp_unsigned_bin_size(tmp);
@@ -24,6 +24,18 @@
 void dsa_free(dsa_key *key)
 {
    LTC_ARGCHKVD(key != NULL);
+   while (key->nonce_count > 0) {
+      key->nonce_count--;
+      mp_clear_multi(key->nonce_r[key->nonce_count], key->nonce_kinv[key->nonce_count], NULL);
+   }
+   if (key->mont_p != NULL) {
+      mp_montgomery_free(key->mont_p);
+      key->mont_p = NULL;
+   }
+   if (key->mont_pR != NULL) {
+      mp_clear(key->mont_pR);
+      key->mont_pR = NULL;
+   }
    mp_clear_multi(key->g, key->q, key->p, key->x, key->y, NULL);
 }
 
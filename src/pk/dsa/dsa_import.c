@@ -39,6 +39,9 @@ int dsa_import(const unsigned char *in, unsigned long inlen, dsa_key *key)
    if (mp_init_multi(&key->p, &key->g, &key->q, &key->x, &key->y, NULL) != CRYPT_OK) {
       return CRYPT_MEM;
    }
+   key->nonce_count = 0;
+   key->mont_p      = NULL;
+   key->mont_pR     = NULL;
 
    /* try to match the old libtomcrypt format */
    if ((err = der_decode_sequence_multi(in, inlen,
@@ -125,6 +128,11 @@ LBL_OK:
       goto LBL_ERR;
    }
 
+  /* the group is fixed from here on; cache its reduction constants */
+  if ((err = dsa_mont_setup(key)) != CRYPT_OK) {
+     goto LBL_ERR;
+  }
+
   return CRYPT_OK;
 LBL_ERR:
    mp_clear_multi(key->p, key->g, key->q, key->x, key->y, NULL);
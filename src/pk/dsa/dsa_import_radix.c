@@ -37,6 +37,9 @@ int dsa_import_radix(int radix, char *p, char *q, char *g, char *x, char *y, dsa
    /* init key */
    err = mp_init_multi(&key->p, &key->g, &key->q, &key->x, &key->y, NULL);
    if (err != CRYPT_OK) return err;
+   key->nonce_count = 0;
+   key->mont_p      = NULL;
+   key->mont_pR     = NULL;
 
    if ((err = mp_read_radix(key->p , p , radix)) != CRYPT_OK) { goto LBL_ERR; }
    if ((err = mp_read_radix(key->q , q , radix)) != CRYPT_OK) { goto LBL_ERR; }
@@ -57,6 +60,11 @@ int dsa_import_radix(int radix, char *p, char *q, char *g, char *x, char *y, dsa
       err = CRYPT_INVALID_PACKET;
       goto LBL_ERR;
    }
+
+   /* the group is fixed from here on; cache its reduction constants */
+   if ((err = dsa_mont_setup(key)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
    return CRYPT_OK;
 
 LBL_ERR:
@@ -214,6 +214,9 @@ int dsa_make_key_ex(prng_state *prng, int wprng, int group_size, int modulus_siz
   if ((err = mp_init_multi(&key->g, &key->q, &key->p, &key->x, &key->y, NULL)) != CRYPT_OK) {
     return err;
   }
+  key->nonce_count = 0;
+  key->mont_p      = NULL;
+  key->mont_pR     = NULL;
 
   if (p_hex == NULL || q_hex == NULL || g_hex == NULL) {
     /* generate params */
@@ -240,6 +243,9 @@ int dsa_make_key_ex(prng_state *prng, int wprng, int group_size, int modulus_siz
   key->type = PK_PRIVATE;
   key->qord = group_size;
 
+  /* the group is fixed from here on; cache its reduction constants */
+  if ((err = dsa_mont_setup(key)) != CRYPT_OK)                                          { goto cleanup; }
+
   return CRYPT_OK;
 
 cleanup:
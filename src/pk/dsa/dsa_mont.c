@@ -0,0 +1,72 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+   @file dsa_mont.c
+   DSA implementation, cached reduction constants, Tom St Denis
+
+   A DSA group is static for years while sign/verify run millions of
+   times against it, yet every mp_exptmod re-derives its reduction
+   setup from p.  dsa_mont_setup() computes the Montgomery context for
+   p once and parks it in the key; the exponentiations in
+   dsa_sign_hash_raw, dsa_verify_hash_raw and dsa_presign then go
+   through ltc_mp_exptmod_mont() with the cached values.  The group
+   order q is only ever a mulmod/invmod modulus here -- no
+   exponentiation uses it -- and the math descriptor exposes no
+   Barrett hooks, so nothing is cached for q.
+*/
+
+#ifdef LTC_MDSA
+
+/**
+  Precompute the Montgomery context for the key's modulus p
+  @param key   The DSA key (p must be set)
+  @return CRYPT_OK if successful (also when the provider has no
+          Montgomery hooks; the cache then simply stays empty)
+*/
+int dsa_mont_setup(dsa_key *key)
+{
+   int err;
+
+   LTC_ARGCHK(key != NULL);
+   LTC_ARGCHK(ltc_mp.name != NULL);
+
+   if (ltc_mp.montgomery_setup  == NULL ||
+       ltc_mp.montgomery_reduce == NULL || key->mont_p != NULL) {
+      return CRYPT_OK;
+   }
+
+   if ((err = mp_montgomery_setup(key->p, &key->mont_p)) != CRYPT_OK) {
+      key->mont_p = NULL;
+      return err;
+   }
+   if ((err = mp_init(&key->mont_pR)) != CRYPT_OK) {
+      mp_montgomery_free(key->mont_p);
+      key->mont_p  = NULL;
+      key->mont_pR = NULL;
+      return err;
+   }
+   if ((err = mp_montgomery_normalization(key->mont_pR, key->p)) != CRYPT_OK) {
+      mp_clear(key->mont_pR);
+      mp_montgomery_free(key->mont_p);
+      key->mont_p  = NULL;
+      key->mont_pR = NULL;
+      return err;
+   }
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
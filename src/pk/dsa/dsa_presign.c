@@ -0,0 +1,114 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+   @file dsa_presign.c
+   DSA implementation, precompute signing nonces, Tom St Denis
+*/
+
+#ifdef LTC_MDSA
+
+/**
+  Precompute {1/k mod q, r} signing nonces for a key
+
+  r = g^k mod p mod q and 1/k are message independent, so a quiet
+  moment can pay the per-signature exponentiation up front;
+  dsa_sign_hash_raw() then finishes a signature with two modular
+  multiplies.  Access to the key must be serialized by the caller,
+  as with every other operation on a dsa_key.
+
+  @param prng     An active PRNG state
+  @param wprng    The index of the PRNG desired
+  @param count    How many nonces to add (capped at the free pool slots)
+  @param key      A private DSA key
+  @return CRYPT_OK if successful
+*/
+int dsa_presign(prng_state *prng, int wprng, int count, dsa_key *key)
+{
+   void *kv[LTC_MDSA_NONCE_POOL], *rv[LTC_MDSA_NONCE_POOL], *tmp;
+   int   err, qbits, i, n;
+
+   LTC_ARGCHK(key != NULL);
+
+   if ((err = prng_is_valid(wprng)) != CRYPT_OK) {
+      return err;
+   }
+   if (key->type != PK_PRIVATE) {
+      return CRYPT_PK_NOT_PRIVATE;
+   }
+   if (count < 0) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   n = LTC_MDSA_NONCE_POOL - key->nonce_count;
+   if (count < n) {
+      n = count;
+   }
+   if (n <= 0) {
+      return CRYPT_OK;
+   }
+
+   if ((err = mp_init(&tmp)) != CRYPT_OK) {
+      return err;
+   }
+
+   qbits = mp_count_bits(key->q);
+
+   /* generate all nonces and their r values first; the inversions
+    * then collapse into one mp_invmod by Montgomery's trick */
+   for (i = 0; i < n; i++) {
+      if ((err = mp_init_multi(&kv[i], &rv[i], NULL)) != CRYPT_OK) {
+         n = i;
+         goto error;
+      }
+retry:
+      do {
+         /* gen random k from range 1 <= k <= q-1 with gcd(k, q) == 1 */
+         if ((err = rand_bn_bits(kv[i], qbits, prng, wprng)) != CRYPT_OK)          { n = i + 1; goto error; }
+         if (mp_cmp_d(kv[i], 0) != LTC_MP_GT || mp_cmp(kv[i], key->q) != LTC_MP_LT) { goto retry; }
+         if ((err = mp_gcd(kv[i], key->q, tmp)) != CRYPT_OK)                       { n = i + 1; goto error; }
+      } while (mp_cmp_d(tmp, 1) != LTC_MP_EQ);
+
+      /* r = g^k mod p mod q */
+      if (key->mont_p != NULL) {
+         if ((err = ltc_mp_exptmod_mont(key->g, kv[i], key->p, key->mont_p, key->mont_pR, rv[i])) != CRYPT_OK) { n = i + 1; goto error; }
+      } else {
+         if ((err = mp_exptmod(key->g, kv[i], key->p, rv[i])) != CRYPT_OK)         { n = i + 1; goto error; }
+      }
+      if ((err = mp_mod(rv[i], key->q, rv[i])) != CRYPT_OK)                        { n = i + 1; goto error; }
+      if (mp_iszero(rv[i]) == LTC_MP_YES)                                          { goto retry; }
+   }
+
+   /* kv[i] = 1/k_i mod q, all at once */
+   if ((err = ltc_mp_invmod_multi(kv, n, key->q)) != CRYPT_OK)                     { goto error; }
+
+   for (i = 0; i < n; i++) {
+      key->nonce_kinv[key->nonce_count] = kv[i];
+      key->nonce_r[key->nonce_count]    = rv[i];
+      key->nonce_count++;
+   }
+   mp_clear(tmp);
+   return CRYPT_OK;
+
+error:
+   for (i = 0; i < n; i++) {
+      mp_clear_multi(kv[i], rv[i], NULL);
+   }
+   mp_clear(tmp);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
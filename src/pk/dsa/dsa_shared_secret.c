@@ -44,7 +44,13 @@ int dsa_shared_secret(void          *private_key, void *base,
       return err;
    }
 
-   if ((err = mp_exptmod(base, private_key, public_key->p, res)) != CRYPT_OK) {
+   if (public_key->mont_p != NULL) {
+      err = ltc_mp_exptmod_mont(base, private_key, public_key->p,
+                                public_key->mont_p, public_key->mont_pR, res);
+   } else {
+      err = mp_exptmod(base, private_key, public_key->p, res);
+   }
+   if (err != CRYPT_OK) {
       mp_clear(res);
       return err;
    }
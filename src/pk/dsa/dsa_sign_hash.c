@@ -62,6 +62,32 @@ int dsa_sign_hash_raw(const unsigned char *in,  unsigned long inlen,
    if ((err = mp_init_multi(&k, &kinv, &tmp, NULL)) != CRYPT_OK)                       { goto ERRBUF; }
 
    qbits = mp_count_bits(key->q);
+
+   /* a pooled {1/k, r} pair from dsa_presign() leaves only the two
+    * modular multiplies for s */
+   if (key->nonce_count > 0) {
+      void *pkinv, *pr;
+
+      key->nonce_count--;
+      pkinv = key->nonce_kinv[key->nonce_count];
+      pr    = key->nonce_r[key->nonce_count];
+      key->nonce_kinv[key->nonce_count] = NULL;
+      key->nonce_r[key->nonce_count]    = NULL;
+
+      if ((err = mp_copy(pr, r)) != CRYPT_OK)                                        { goto poolout; }
+
+      /* s = (in + xr)/k mod q */
+      if ((err = mp_read_unsigned_bin(tmp, (unsigned char *)in,
+                      MIN(inlen, (unsigned long)(key->qord)))) != CRYPT_OK)          { goto poolout; }
+      if ((err = mp_mul(key->x, r, s)) != CRYPT_OK)                                  { goto poolout; }
+      if ((err = mp_add(s, tmp, s)) != CRYPT_OK)                                     { goto poolout; }
+      err = mp_mulmod(s, pkinv, key->q, s);
+poolout:
+      mp_clear_multi(pr, pkinv, NULL);
+      if (err != CRYPT_OK)                                                           { goto error; }
+      if (mp_iszero(s) != LTC_MP_YES)                                                { goto error; }
+      /* s == 0 happens with negligible probability; sign with a fresh k */
+   }
 retry:
 
    do {
@@ -79,7 +105,11 @@ retry:
    if ((err = mp_invmod(k, key->q, kinv)) != CRYPT_OK)                                 { goto error; }
 
    /* now find r = g^k mod p mod q */
-   if ((err = mp_exptmod(key->g, k, key->p, r)) != CRYPT_OK)                           { goto error; }
+   if (key->mont_p != NULL) {
+      if ((err = ltc_mp_exptmod_mont(key->g, k, key->p, key->mont_p, key->mont_pR, r)) != CRYPT_OK) { goto error; }
+   } else {
+      if ((err = mp_exptmod(key->g, k, key->p, r)) != CRYPT_OK)                        { goto error; }
+   }
    if ((err = mp_mod(r, key->q, r)) != CRYPT_OK)                                       { goto error; }
 
    if (mp_iszero(r) == LTC_MP_YES)                                                     { goto retry; }
@@ -121,7 +151,8 @@ int dsa_sign_hash(const unsigned char *in,  unsigned long inlen,
                         unsigned char *out, unsigned long *outlen,
                         prng_state *prng, int wprng, dsa_key *key)
 {
-   void         *r, *s;
+   void          *r, *s;
+   ltc_asn1_list rs[2];
    int           err;
 
    LTC_ARGCHK(in      != NULL);
@@ -137,10 +168,10 @@ int dsa_sign_hash(const unsigned char *in,  unsigned long inlen,
       goto error;
    }
 
-   err = der_encode_sequence_multi(out, outlen,
-                             LTC_ASN1_INTEGER, 1UL, r,
-                             LTC_ASN1_INTEGER, 1UL, s,
-                             LTC_ASN1_EOL,     0UL, NULL);
+   /* stack list, no varargs walk or heap allocation per signature */
+   LTC_SET_ASN1(rs, 0, LTC_ASN1_INTEGER, r, 1UL);
+   LTC_SET_ASN1(rs, 1, LTC_ASN1_INTEGER, s, 1UL);
+   err = der_encode_sequence(rs, 2, out, outlen);
 
 error:
    mp_clear_multi(r, s, NULL);
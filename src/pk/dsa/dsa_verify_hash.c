@@ -68,9 +68,19 @@ int dsa_verify_hash_raw(         void   *r,          void   *s,
    if ((err = mp_mulmod(r, w, key->q, u2)) != CRYPT_OK)                                   { goto error; }
 
    /* v = g^u1 * y^u2 mod p mod q */
-   if ((err = mp_exptmod(key->g, u1, key->p, u1)) != CRYPT_OK)                            { goto error; }
-   if ((err = mp_exptmod(key->y, u2, key->p, u2)) != CRYPT_OK)                            { goto error; }
-   if ((err = mp_mulmod(u1, u2, key->p, v)) != CRYPT_OK)                                  { goto error; }
+   if (ltc_mp.multi_exptmod != NULL) {
+      /* one interleaved squaring chain instead of two */
+      if ((err = ltc_mp.multi_exptmod(key->g, u1, key->y, u2, key->p, v)) != CRYPT_OK)    { goto error; }
+   } else if (key->mont_p != NULL) {
+      /* two chains, but each off the key's cached Montgomery context */
+      if ((err = ltc_mp_exptmod_mont(key->g, u1, key->p, key->mont_p, key->mont_pR, u1)) != CRYPT_OK) { goto error; }
+      if ((err = ltc_mp_exptmod_mont(key->y, u2, key->p, key->mont_p, key->mont_pR, u2)) != CRYPT_OK) { goto error; }
+      if ((err = mp_mulmod(u1, u2, key->p, v)) != CRYPT_OK)                               { goto error; }
+   } else {
+      if ((err = mp_exptmod(key->g, u1, key->p, u1)) != CRYPT_OK)                         { goto error; }
+      if ((err = mp_exptmod(key->y, u2, key->p, u2)) != CRYPT_OK)                         { goto error; }
+      if ((err = mp_mulmod(u1, u2, key->p, v)) != CRYPT_OK)                               { goto error; }
+   }
    if ((err = mp_mod(v, key->q, v)) != CRYPT_OK)                                          { goto error; }
 
    /* if r = v then we're set */
@@ -98,6 +108,7 @@ int dsa_verify_hash(const unsigned char *sig, unsigned long siglen,
                     const unsigned char *hash, unsigned long hashlen,
                     int *stat, dsa_key *key)
 {
+   ltc_asn1_list rs[2];
    int    err;
    void   *r, *s;
 
@@ -105,11 +116,10 @@ int dsa_verify_hash(const unsigned char *sig, unsigned long siglen,
       return CRYPT_MEM;
    }
 
-   /* decode the sequence */
-   if ((err = der_decode_sequence_multi(sig, siglen,
-                                  LTC_ASN1_INTEGER, 1UL, r,
-                                  LTC_ASN1_INTEGER, 1UL, s,
-                                  LTC_ASN1_EOL,     0UL, NULL)) != CRYPT_OK) {
+   /* decode the sequence from a stack list */
+   LTC_SET_ASN1(rs, 0, LTC_ASN1_INTEGER, r, 1UL);
+   LTC_SET_ASN1(rs, 1, LTC_ASN1_INTEGER, s, 1UL);
+   if ((err = der_decode_sequence(sig, siglen, rs, 2)) != CRYPT_OK) {
       goto LBL_ERR;
    }
 
@@ -0,0 +1,299 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+   @file dsa_verify_hash_batch.c
+   DSA implementation, batch verification under one group, Tom St Denis
+
+   dsa_verify_hash_raw() pays two full exponentiations (or one
+   interleaved multi_exptmod chain) per signature and re-derives
+   nothing across calls.  A log-replication verifier that checks
+   thousands of signatures under a single group wants the squaring
+   chains hoisted out entirely: dsa_verify_ctx_init() precomputes
+   4-bit fixed-base tables T[i][d] = b^(d * 16^i) mod p for both the
+   group generator g and the key's y, after which each exponentiation
+   in the batch is one table multiplication per exponent digit --
+   no squarings at all.  The tables cost a few exponentiations'
+   worth of work to build and amortize across the batch.
+*/
+
+#ifdef LTC_MDSA
+
+/* 4-bit digits; a 160..256-bit q gives 40..64 digits per exponent */
+#define DSA_FB_WIN  4
+#define DSA_FB_VALS 15   /* non-zero digit values per position */
+
+/* the idx'th 4-bit digit of a, spanning limb boundaries */
+static int s_dsa_fb_digit(void *a, int idx)
+{
+   int bit, d, i;
+
+   d = 0;
+   for (i = DSA_FB_WIN - 1; i >= 0; i--) {
+      bit = DSA_FB_WIN * idx + i;
+      d <<= 1;
+      d |= (int)((mp_get_digit(a, bit / (int)ltc_mp.bits_per_digit) >>
+                  (bit % (int)ltc_mp.bits_per_digit)) & 1);
+   }
+   return d;
+}
+
+/* build tab[i*DSA_FB_VALS + d-1] = base^(d * 16^i) mod p for digits cnt */
+static int s_dsa_fb_build(void ***tab_out, void *base, void *p, int cnt)
+{
+   void **tab, *pw;
+   int    i, d, err;
+
+   tab = XCALLOC((size_t)cnt * DSA_FB_VALS, sizeof(*tab));
+   if (tab == NULL) {
+      return CRYPT_MEM;
+   }
+   if ((err = mp_init(&pw)) != CRYPT_OK) {
+      XFREE(tab);
+      return err;
+   }
+
+   /* pw walks base^(16^i) */
+   if ((err = mp_copy(base, pw)) != CRYPT_OK) { goto error; }
+   for (i = 0; i < cnt; i++) {
+      /* tab[i][1] = pw, tab[i][d] = tab[i][d-1] * pw */
+      for (d = 1; d <= DSA_FB_VALS; d++) {
+         if ((err = mp_init(&tab[i * DSA_FB_VALS + d - 1])) != CRYPT_OK) { goto error; }
+         if (d == 1) {
+            if ((err = mp_copy(pw, tab[i * DSA_FB_VALS])) != CRYPT_OK)  { goto error; }
+         } else {
+            if ((err = mp_mulmod(tab[i * DSA_FB_VALS + d - 2], pw, p,
+                                 tab[i * DSA_FB_VALS + d - 1])) != CRYPT_OK) { goto error; }
+         }
+      }
+      if (i + 1 < cnt) {
+         for (d = 0; d < DSA_FB_WIN; d++) {
+            if ((err = mp_sqrmod(pw, p, pw)) != CRYPT_OK)               { goto error; }
+         }
+      }
+   }
+   mp_clear(pw);
+   *tab_out = tab;
+   return CRYPT_OK;
+error:
+   for (i = 0; i < cnt * DSA_FB_VALS; i++) {
+      if (tab[i] != NULL) { mp_clear(tab[i]); }
+   }
+   XFREE(tab);
+   mp_clear(pw);
+   return err;
+}
+
+/* out = base^e mod p off the table: one multiplication per set digit */
+static int s_dsa_fb_expt(void **tab, void *e, void *p, int cnt, void *out)
+{
+   int i, d, loaded, err;
+
+   loaded = 0;
+   for (i = 0; i < cnt; i++) {
+      d = s_dsa_fb_digit(e, i);
+      if (d == 0) {
+         continue;
+      }
+      if (!loaded) {
+         if ((err = mp_copy(tab[i * DSA_FB_VALS + d - 1], out)) != CRYPT_OK) {
+            return err;
+         }
+         loaded = 1;
+      } else {
+         if ((err = mp_mulmod(out, tab[i * DSA_FB_VALS + d - 1], p, out)) != CRYPT_OK) {
+            return err;
+         }
+      }
+   }
+   if (!loaded) {
+      /* e == 0 */
+      if ((err = mp_set_int(out, 1)) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Precompute fixed-base tables for batch verification under one key
+  @param ctx   The batch-verify context to fill
+  @param key   The public DSA key (must outlive the context)
+  @return CRYPT_OK if successful
+*/
+int dsa_verify_ctx_init(dsa_verify_ctx *ctx, dsa_key *key)
+{
+   int err;
+
+   LTC_ARGCHK(ctx != NULL);
+   LTC_ARGCHK(key != NULL);
+   LTC_ARGCHK(ltc_mp.name != NULL);
+
+   ctx->key    = key;
+   ctx->digits = (mp_count_bits(key->q) + DSA_FB_WIN - 1) / DSA_FB_WIN;
+   ctx->gtab   = NULL;
+   ctx->ytab   = NULL;
+
+   if ((err = s_dsa_fb_build(&ctx->gtab, key->g, key->p, ctx->digits)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = s_dsa_fb_build(&ctx->ytab, key->y, key->p, ctx->digits)) != CRYPT_OK) {
+      dsa_verify_ctx_done(ctx);
+      return err;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Verify one DSA signature off the precomputed tables
+  @param ctx      The batch-verify context
+  @param r        DSA "r" parameter
+  @param s        DSA "s" parameter
+  @param hash     The hash that was signed
+  @param hashlen  The length of the hash that was signed
+  @param stat     [out] 1==valid, 0==invalid
+  @return CRYPT_OK if successful (even if the signature is invalid)
+*/
+int dsa_verify_ctx_raw(dsa_verify_ctx *ctx, void *r, void *s,
+                       const unsigned char *hash, unsigned long hashlen,
+                       int *stat)
+{
+   void    *w, *v, *u1, *u2, *t;
+   dsa_key *key;
+   int      err;
+
+   LTC_ARGCHK(ctx  != NULL);
+   LTC_ARGCHK(r    != NULL);
+   LTC_ARGCHK(s    != NULL);
+   LTC_ARGCHK(stat != NULL);
+   key = ctx->key;
+
+   *stat = 0;
+
+   if ((err = mp_init_multi(&w, &v, &u1, &u2, &t, NULL)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* neither r or s can be null or >q */
+   if (mp_iszero(r) == LTC_MP_YES || mp_iszero(s) == LTC_MP_YES ||
+       mp_cmp(r, key->q) != LTC_MP_LT || mp_cmp(s, key->q) != LTC_MP_LT) {
+      err = CRYPT_INVALID_PACKET;
+      goto error;
+   }
+
+   /* FIPS 186-4 4.7: use leftmost min(bitlen(q), bitlen(hash)) bits of 'hash' */
+   hashlen = MIN(hashlen, (unsigned long)(key->qord));
+
+   /* w = 1/s mod q, u1 = m*w mod q, u2 = r*w mod q */
+   if ((err = mp_invmod(s, key->q, w)) != CRYPT_OK)                                  { goto error; }
+   if ((err = mp_read_unsigned_bin(u1, (unsigned char *)hash, hashlen)) != CRYPT_OK) { goto error; }
+   if ((err = mp_mulmod(u1, w, key->q, u1)) != CRYPT_OK)                             { goto error; }
+   if ((err = mp_mulmod(r, w, key->q, u2)) != CRYPT_OK)                              { goto error; }
+
+   /* v = g^u1 * y^u2 mod p mod q off the tables */
+   if ((err = s_dsa_fb_expt(ctx->gtab, u1, key->p, ctx->digits, v)) != CRYPT_OK)     { goto error; }
+   if ((err = s_dsa_fb_expt(ctx->ytab, u2, key->p, ctx->digits, t)) != CRYPT_OK)     { goto error; }
+   if ((err = mp_mulmod(v, t, key->p, v)) != CRYPT_OK)                               { goto error; }
+   if ((err = mp_mod(v, key->q, v)) != CRYPT_OK)                                     { goto error; }
+
+   if (mp_cmp(r, v) == LTC_MP_EQ) {
+      *stat = 1;
+   }
+   err = CRYPT_OK;
+error:
+   mp_clear_multi(w, v, u1, u2, t, NULL);
+   return err;
+}
+
+/**
+  Verify a batch of DER-encoded DSA signatures under one key
+  @param ctx       The batch-verify context
+  @param sigs      Array of num signatures
+  @param siglens   Array of num signature lengths (octets)
+  @param hashes    Array of num hashes that were signed
+  @param hashlens  Array of num hash lengths (octets)
+  @param stats     [out] Array of num results, 1==valid, 0==invalid
+  @param num       How many signatures
+  @return CRYPT_OK if successful (even if signatures are invalid)
+*/
+int dsa_verify_hash_batch(dsa_verify_ctx *ctx,
+                          const unsigned char **sigs,  const unsigned long *siglens,
+                          const unsigned char **hashes, const unsigned long *hashlens,
+                          int *stats, unsigned long num)
+{
+   ltc_asn1_list rs[2];
+   void         *r, *s;
+   unsigned long i;
+   int           err;
+
+   LTC_ARGCHK(ctx      != NULL);
+   LTC_ARGCHK(sigs     != NULL);
+   LTC_ARGCHK(siglens  != NULL);
+   LTC_ARGCHK(hashes   != NULL);
+   LTC_ARGCHK(hashlens != NULL);
+   LTC_ARGCHK(stats    != NULL);
+
+   if ((err = mp_init_multi(&r, &s, NULL)) != CRYPT_OK) {
+      return err;
+   }
+   for (i = 0; i < num; i++) {
+      stats[i] = 0;
+      LTC_SET_ASN1(rs, 0, LTC_ASN1_INTEGER, r, 1UL);
+      LTC_SET_ASN1(rs, 1, LTC_ASN1_INTEGER, s, 1UL);
+      if (der_decode_sequence(sigs[i], siglens[i], rs, 2) != CRYPT_OK) {
+         continue;   /* malformed entry: flagged invalid, batch goes on */
+      }
+      if ((err = dsa_verify_ctx_raw(ctx, r, s, hashes[i], hashlens[i],
+                                    &stats[i])) != CRYPT_OK &&
+          err != CRYPT_INVALID_PACKET) {
+         goto done;
+      }
+   }
+   err = CRYPT_OK;
+done:
+   mp_clear_multi(r, s, NULL);
+   return err;
+}
+
+/**
+  Release the precomputed tables
+  @param ctx   The batch-verify context
+  @return CRYPT_OK if successful
+*/
+int dsa_verify_ctx_done(dsa_verify_ctx *ctx)
+{
+   int i;
+
+   LTC_ARGCHK(ctx != NULL);
+   if (ctx->gtab != NULL) {
+      for (i = 0; i < ctx->digits * DSA_FB_VALS; i++) {
+         if (ctx->gtab[i] != NULL) { mp_clear(ctx->gtab[i]); }
+      }
+      XFREE(ctx->gtab);
+      ctx->gtab = NULL;
+   }
+   if (ctx->ytab != NULL) {
+      for (i = 0; i < ctx->digits * DSA_FB_VALS; i++) {
+         if (ctx->ytab[i] != NULL) { mp_clear(ctx->ytab[i]); }
+      }
+      XFREE(ctx->ytab);
+      ctx->ytab = NULL;
+   }
+   ctx->key = NULL;
+   return CRYPT_OK;
+}
+
+#endif /* LTC_MDSA */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
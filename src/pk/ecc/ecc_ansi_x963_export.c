@@ -31,7 +31,6 @@
 */
 int ecc_ansi_x963_export(ecc_key *key, unsigned char *out, unsigned long *outlen)
 {
-   unsigned char buf[ECC_BUF_SIZE];
    unsigned long numlen, xlen, ylen;
 
    LTC_ARGCHK(key    != NULL);
@@ -44,7 +43,7 @@ int ecc_ansi_x963_export(ecc_key *key, unsigned char *out, unsigned long *outlen
    xlen = mp_unsigned_bin_size(key->pubkey.x);
    ylen = mp_unsigned_bin_size(key->pubkey.y);
 
-   if (xlen > numlen || ylen > numlen || sizeof(buf) < numlen) {
+   if (xlen > numlen || ylen > numlen) {
       return CRYPT_BUFFER_OVERFLOW;
    }
 
@@ -58,15 +57,10 @@ int ecc_ansi_x963_export(ecc_key *key, unsigned char *out, unsigned long *outlen
    /* store byte 0x04 */
    out[0] = 0x04;
 
-   /* pad and store x */
-   zeromem(buf, sizeof(buf));
-   mp_to_unsigned_bin(key->pubkey.x, buf + (numlen - xlen));
-   XMEMCPY(out+1, buf, numlen);
-
-   /* pad and store y */
-   zeromem(buf, sizeof(buf));
-   mp_to_unsigned_bin(key->pubkey.y, buf + (numlen - ylen));
-   XMEMCPY(out+1+numlen, buf, numlen);
+   /* zero pad and store x and y straight into the caller's buffer */
+   zeromem(out+1, 2*numlen);
+   mp_to_unsigned_bin(key->pubkey.x, out+1+(numlen - xlen));
+   mp_to_unsigned_bin(key->pubkey.y, out+1+numlen+(numlen - ylen));
 
    *outlen = 1 + 2*numlen;
    return CRYPT_OK;
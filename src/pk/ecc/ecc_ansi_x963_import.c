@@ -49,6 +49,8 @@ int ecc_ansi_x963_import_ex(const unsigned char *in, unsigned long inlen, ecc_ke
    if (mp_init_multi(&key->pubkey.x, &key->pubkey.y, &key->pubkey.z, &key->k, NULL) != CRYPT_OK) {
       return CRYPT_MEM;
    }
+   key->pub_der     = NULL;
+   key->pub_der_len = 0;
 
    /* check for 4, 6 or 7 */
    if (in[0] != 4 && in[0] != 6 && in[0] != 7) {
@@ -88,7 +90,8 @@ int ecc_ansi_x963_import_ex(const unsigned char *in, unsigned long inlen, ecc_ke
       key->idx = -1;
       key->dp  = dp;
    }
-   key->type = PK_PUBLIC;
+   key->type   = PK_PUBLIC;
+   key->sealed = 0;
 
    /* we're done */
    return CRYPT_OK;
@@ -97,6 +100,68 @@ error:
    return err;
 }
 
+/** Import an ANSI X9.63 format public key into an initialized key (fast path)
+  The key must already hold bignums, e.g. from a previous import or
+  ecc_make_key(); they are overwritten in place so a loop importing
+  ephemeral points performs no heap allocation.  The coordinates are
+  read straight from the caller's buffer; as with ecc_ansi_x963_import()
+  no curve equation check is made here, validation stays deferred to use.
+  @param in      The input data to read
+  @param inlen   The length of the input data
+  @param key     [out] initialized key to overwrite with the import
+  @param dp      Custom domain parameters, NULL to keep the key's current curve
+*/
+int ecc_ansi_x963_import_raw(const unsigned char *in, unsigned long inlen, ecc_key *key, ltc_ecc_set_type *dp)
+{
+   int err;
+
+   LTC_ARGCHK(in             != NULL);
+   LTC_ARGCHK(key            != NULL);
+   LTC_ARGCHK(key->pubkey.x  != NULL);
+   LTC_ARGCHK(key->pubkey.y  != NULL);
+   LTC_ARGCHK(key->pubkey.z  != NULL);
+
+   /* must be odd */
+   if ((inlen & 1) == 0) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* check for 4, 6 or 7 */
+   if (in[0] != 4 && in[0] != 6 && in[0] != 7) {
+      return CRYPT_INVALID_PACKET;
+   }
+
+   if (dp != NULL) {
+      key->idx = -1;
+      key->dp  = dp;
+   }
+   if (key->dp == NULL || ((inlen-1)>>1) != (unsigned long) key->dp->size) {
+      return CRYPT_INVALID_PACKET;
+   }
+
+   /* the public point changes, drop any cached export */
+   if (key->pub_der != NULL) {
+      XFREE(key->pub_der);
+      key->pub_der     = NULL;
+      key->pub_der_len = 0;
+   }
+
+   /* read data */
+   if ((err = mp_read_unsigned_bin(key->pubkey.x, (unsigned char *)in+1, (inlen-1)>>1)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = mp_read_unsigned_bin(key->pubkey.y, (unsigned char *)in+1+((inlen-1)>>1), (inlen-1)>>1)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = mp_set(key->pubkey.z, 1)) != CRYPT_OK) {
+      return err;
+   }
+   key->type   = PK_PUBLIC;
+   key->sealed = 0;
+
+   return CRYPT_OK;
+}
+
 #endif
 
 /* $Source$ */
@@ -53,6 +53,17 @@ int ecc_export(unsigned char *out, unsigned long *outlen, int type, ecc_key *key
    /* we store the NIST byte size */
    key_size = key->dp->size;
 
+   /* public exports are served from the cached encoding */
+   if (type == PK_PUBLIC && key->pub_der != NULL) {
+      if (*outlen < key->pub_der_len) {
+         *outlen = key->pub_der_len;
+         return CRYPT_BUFFER_OVERFLOW;
+      }
+      XMEMCPY(out, key->pub_der, key->pub_der_len);
+      *outlen = key->pub_der_len;
+      return CRYPT_OK;
+   }
+
    if (type == PK_PRIVATE) {
        flags[0] = 1;
        err = der_encode_sequence_multi(out, outlen,
@@ -70,6 +81,16 @@ int ecc_export(unsigned char *out, unsigned long *outlen, int type, ecc_key *key
                                  LTC_ASN1_INTEGER,         1UL, key->pubkey.x,
                                  LTC_ASN1_INTEGER,         1UL, key->pubkey.y,
                                  LTC_ASN1_EOL,             0UL, NULL);
+
+       /* stash the encoding for the next export; running out of heap
+        * just means the next call encodes again */
+       if (err == CRYPT_OK) {
+          key->pub_der = XMALLOC(*outlen);
+          if (key->pub_der != NULL) {
+             XMEMCPY(key->pub_der, out, *outlen);
+             key->pub_der_len = *outlen;
+          }
+       }
    }
 
    return err;
@@ -30,6 +30,10 @@
 void ecc_free(ecc_key *key)
 {
    LTC_ARGCHKVD(key != NULL);
+   if (key->pub_der != NULL) {
+      XFREE(key->pub_der);
+      key->pub_der = NULL;
+   }
    mp_clear_multi(key->pubkey.x, key->pubkey.y, key->pubkey.z, key->k, NULL);
 }
 
@@ -105,6 +105,8 @@ int ecc_import_ex(const unsigned char *in, unsigned long inlen, ecc_key *key, co
    if (mp_init_multi(&key->pubkey.x, &key->pubkey.y, &key->pubkey.z, &key->k, NULL) != CRYPT_OK) {
       return CRYPT_MEM;
    }
+   key->pub_der     = NULL;
+   key->pub_der_len = 0;
 
    /* find out what type of key it is */
    if ((err = der_decode_sequence_multi(in, inlen,
@@ -116,7 +118,8 @@ int ecc_import_ex(const unsigned char *in, unsigned long inlen, ecc_key *key, co
 
    if (flags[0] == 1) {
       /* private key */
-      key->type = PK_PRIVATE;
+      key->type   = PK_PRIVATE;
+      key->sealed = 0;
       if ((err = der_decode_sequence_multi(in, inlen,
                                      LTC_ASN1_BIT_STRING,      1UL, flags,
                                      LTC_ASN1_SHORT_INTEGER,   1UL, &key_size,
@@ -128,7 +131,8 @@ int ecc_import_ex(const unsigned char *in, unsigned long inlen, ecc_key *key, co
       }
    } else {
       /* public key */
-      key->type = PK_PUBLIC;
+      key->type   = PK_PUBLIC;
+      key->sealed = 0;
       if ((err = der_decode_sequence_multi(in, inlen,
                                      LTC_ASN1_BIT_STRING,      1UL, flags,
                                      LTC_ASN1_SHORT_INTEGER,   1UL, &key_size,
@@ -0,0 +1,76 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/* Implements ECC over Z/pZ for curve y^2 = x^3 - 3x + b
+ *
+ * All curves taken from NIST recommendation paper of July 1999
+ * Available at http://csrc.nist.gov/cryptval/dss.htm
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ecc_key_prealloc.c
+  ECC Crypto, Tom St Denis
+
+  Container setup for zero-allocation key ingestion.  An ephemeral
+  handshake peer key lives microseconds, but ecc_import and the plain
+  X9.63 import pay mp_init_multi heap setup for every one of them.
+  ecc_key_prealloc() does that setup exactly once on a caller-owned
+  ecc_key; after that, each peer point goes in through
+  ecc_ansi_x963_import_raw() with no DER walk and no allocation, and
+  the same container (with an ecc_shared_ctx) is reused across
+  handshakes.  Release it with the usual ecc_free().
+*/
+
+#ifdef LTC_MECC
+
+/**
+  Initialize a caller-owned ecc_key for reuse with ecc_ansi_x963_import_raw()
+  @param key   The key container to set up
+  @param dp    The curve the peer points will be on, or NULL to pass one
+               (or rely on the key's curve) at import time
+  @return CRYPT_OK if successful
+*/
+int ecc_key_prealloc(ecc_key *key, const ltc_ecc_set_type *dp)
+{
+   int x, err;
+
+   LTC_ARGCHK(key         != NULL);
+   LTC_ARGCHK(ltc_mp.name != NULL);
+
+   if ((err = mp_init_multi(&key->pubkey.x, &key->pubkey.y, &key->pubkey.z,
+                            &key->k, NULL)) != CRYPT_OK) {
+      return err;
+   }
+   key->pub_der     = NULL;
+   key->pub_der_len = 0;
+   key->type        = PK_PUBLIC;
+   key->sealed      = 0;
+   key->dp          = dp;
+   key->idx         = -1;
+   if (dp != NULL) {
+      /* recover the set index when dp is one of the built-in curves so
+       * the fixed-base and shared-secret paths keep their fast cases */
+      for (x = 0; ltc_ecc_sets[x].size != 0; x++) {
+         if (dp == &ltc_ecc_sets[x]) {
+            key->idx = x;
+            break;
+         }
+      }
+   }
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,103 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/* Implements ECC over Z/pZ for curve y^2 = x^3 - 3x + b
+ *
+ * All curves taken from NIST recommendation paper of July 1999
+ * Available at http://csrc.nist.gov/cryptval/dss.htm
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ecc_key_seal.c
+  ECC Crypto, Tom St Denis
+
+  Amortized validation for session keys.  A peer key reused for
+  thousands of operations pays per-call parameter checks in
+  ecc_verify_hash and ecc_shared_secret, while the cheap import paths
+  (ecc_ansi_x963_import_raw in particular) defer curve-membership
+  validation entirely.  ecc_key_seal() runs the full check once --
+  curve parameters valid, coordinates in range, point on the curve --
+  and marks the key; the hot entry points then skip their per-call
+  re-validation for sealed keys.  Any import into the key clears the
+  mark again.  The built-in curves have cofactor 1, so for them
+  on-curve membership already implies the prime-order subgroup.
+*/
+
+#ifdef LTC_MECC
+
+/**
+  Fully validate a key once and mark it for fast-path reuse
+  @param key   The key to validate and seal
+  @return CRYPT_OK if the key validated (key is now sealed);
+          CRYPT_INVALID_PACKET if the point is not on the curve
+*/
+int ecc_key_seal(ecc_key *key)
+{
+   void *prime, *b, *t1, *t2;
+   int   err;
+
+   LTC_ARGCHK(key         != NULL);
+   LTC_ARGCHK(ltc_mp.name != NULL);
+
+   /* parameters: either a built-in set or caller-supplied domain */
+   if (key->dp == NULL ||
+       (key->idx != -1 && ltc_ecc_is_valid_idx(key->idx) != 1)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   if ((err = mp_init_multi(&prime, &b, &t1, &t2, NULL)) != CRYPT_OK) {
+      return err;
+   }
+
+   if ((err = mp_read_radix(prime, (char *)key->dp->prime, 16)) != CRYPT_OK)  { goto error; }
+   if ((err = mp_read_radix(b, (char *)key->dp->B, 16)) != CRYPT_OK)          { goto error; }
+
+   /* coordinates in [0, p) */
+   if (mp_cmp_d(key->pubkey.x, 0) == LTC_MP_LT || mp_cmp(key->pubkey.x, prime) != LTC_MP_LT ||
+       mp_cmp_d(key->pubkey.y, 0) == LTC_MP_LT || mp_cmp(key->pubkey.y, prime) != LTC_MP_LT) {
+      err = CRYPT_INVALID_PACKET;
+      goto error;
+   }
+
+   /* y^2 - x^3 + 3x == b (mod p), i.e. the point satisfies the curve */
+   if ((err = mp_sqr(key->pubkey.y, t1)) != CRYPT_OK)                         { goto error; }
+   if ((err = mp_sqr(key->pubkey.x, t2)) != CRYPT_OK)                         { goto error; }
+   if ((err = mp_mod(t2, prime, t2)) != CRYPT_OK)                             { goto error; }
+   if ((err = mp_mul(key->pubkey.x, t2, t2)) != CRYPT_OK)                     { goto error; }
+   if ((err = mp_sub(t1, t2, t1)) != CRYPT_OK)                                { goto error; }
+   if ((err = mp_add(t1, key->pubkey.x, t1)) != CRYPT_OK)                     { goto error; }
+   if ((err = mp_add(t1, key->pubkey.x, t1)) != CRYPT_OK)                     { goto error; }
+   if ((err = mp_add(t1, key->pubkey.x, t1)) != CRYPT_OK)                     { goto error; }
+   if ((err = mp_mod(t1, prime, t1)) != CRYPT_OK)                             { goto error; }
+   while (mp_cmp_d(t1, 0) == LTC_MP_LT) {
+      if ((err = mp_add(t1, prime, t1)) != CRYPT_OK)                          { goto error; }
+   }
+   while (mp_cmp(t1, prime) != LTC_MP_LT) {
+      if ((err = mp_sub(t1, prime, t1)) != CRYPT_OK)                          { goto error; }
+   }
+   if (mp_cmp(t1, b) != LTC_MP_EQ) {
+      err = CRYPT_INVALID_PACKET;
+      goto error;
+   }
+
+   key->sealed = 1;
+   err = CRYPT_OK;
+error:
+   mp_clear_multi(prime, b, t1, t2, NULL);
+   return err;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -53,7 +53,7 @@ int ecc_make_key_ex(prng_state *prng, int wprng, ecc_key *key, const ltc_ecc_set
    ecc_point     *base;
    void          *prime, *order;
    unsigned char *buf;
-   int            keysize;
+   int            keysize, fbidx;
 
    LTC_ARGCHK(key         != NULL);
    LTC_ARGCHK(ltc_mp.name != NULL);
@@ -85,6 +85,8 @@ int ecc_make_key_ex(prng_state *prng, int wprng, ecc_key *key, const ltc_ecc_set
    if ((err = mp_init_multi(&key->pubkey.x, &key->pubkey.y, &key->pubkey.z, &key->k, &prime, &order, NULL)) != CRYPT_OK) {
       goto ERR_BUF;
    }
+   key->pub_der     = NULL;
+   key->pub_der_len = 0;
    base = ltc_ecc_new_point();
    if (base == NULL) {
       err = CRYPT_MEM;
@@ -103,9 +105,24 @@ int ecc_make_key_ex(prng_state *prng, int wprng, ecc_key *key, const ltc_ecc_set
    if (mp_cmp(key->k, order) != LTC_MP_LT) {
        if((err = mp_mod(key->k, order, key->k)) != CRYPT_OK)                                    { goto errkey; }
    }
-   /* make the public key */
-   if ((err = ltc_mp.ecc_ptmul(key->k, base, &key->pubkey, prime, 1)) != CRYPT_OK)              { goto errkey; }
-   key->type = PK_PRIVATE;
+   /* make the public key; built-in curves multiply the generator off
+    * its fixed base table.  P-256 keeps its dedicated constant-time
+    * backend and a timing resistant build skips the table walk, whose
+    * addition pattern follows the scalar */
+   fbidx = -1;
+#ifndef LTC_ECC_TIMING_RESISTANT
+   fbidx = ltc_ecc_fb_set_idx(dp);
+#ifdef LTC_ECC_P256
+   if (ltc_ecc_p256_accel_ok(key->k, base, prime, 1)) {
+      fbidx = -1;
+   }
+#endif
+#endif
+   if (fbidx < 0 || ltc_ecc_fb_mulmod(fbidx, key->k, &key->pubkey, prime) != CRYPT_OK) {
+      if ((err = ltc_mp.ecc_ptmul(key->k, base, &key->pubkey, prime, 1)) != CRYPT_OK)           { goto errkey; }
+   }
+   key->type   = PK_PRIVATE;
+   key->sealed = 0;
 
    /* free up ram */
    err = CRYPT_OK;
@@ -49,11 +49,14 @@ int ecc_shared_secret(ecc_key *private_key, ecc_key *public_key,
       return CRYPT_PK_NOT_PRIVATE;
    }
 
-   if (ltc_ecc_is_valid_idx(private_key->idx) == 0 || ltc_ecc_is_valid_idx(public_key->idx) == 0) {
+   /* sealed keys were validated up front by ecc_key_seal() */
+   if ((private_key->sealed != 1 && ltc_ecc_is_valid_idx(private_key->idx) == 0) ||
+       (public_key->sealed  != 1 && ltc_ecc_is_valid_idx(public_key->idx)  == 0)) {
       return CRYPT_INVALID_ARG;
    }
 
-   if (XSTRCMP(private_key->dp->name, public_key->dp->name) != 0) {
+   if (private_key->dp != public_key->dp &&
+       XSTRCMP(private_key->dp->name, public_key->dp->name) != 0) {
       return CRYPT_PK_TYPE_MISMATCH;
    }
 
@@ -63,7 +66,7 @@ int ecc_shared_secret(ecc_key *private_key, ecc_key *public_key,
       return CRYPT_MEM;
    }
 
-   if ((err = mp_init(&prime)) != CRYPT_OK) {
+   if ((err = ltc_mp_pool_get(&prime)) != CRYPT_OK) {
       ltc_ecc_del_point(result);
       return err;
    }
@@ -83,7 +86,7 @@ int ecc_shared_secret(ecc_key *private_key, ecc_key *public_key,
    err     = CRYPT_OK;
    *outlen = x;
 done:
-   mp_clear(prime);
+   ltc_mp_pool_put(prime);
    ltc_ecc_del_point(result);
    return err;
 }
@@ -0,0 +1,174 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/* Implements ECC over Z/pZ for curve y^2 = x^3 - 3x + b
+ *
+ * All curves taken from NIST recommendation paper of July 1999
+ * Available at http://csrc.nist.gov/cryptval/dss.htm
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ecc_shared_secret_ctx.c
+  ECC Crypto, Tom St Denis
+
+  Reusable scratch state for repeated EC-DH.  ecc_shared_secret()
+  allocates a point and the curve prime on every call; a handshake
+  tier doing this per connection pays the allocator each time.  The
+  context below carries both across calls, re-reading the prime only
+  when the curve changes.
+*/
+
+#ifdef LTC_MECC
+
+/**
+  Initialize a reusable EC-DH context
+  @param ctx    The context to initialize
+  @return CRYPT_OK if successful
+*/
+int ecc_shared_secret_ctx_init(ecc_shared_ctx *ctx)
+{
+   int err;
+
+   LTC_ARGCHK(ctx != NULL);
+
+   ctx->result = ltc_ecc_new_point();
+   if (ctx->result == NULL) {
+      return CRYPT_MEM;
+   }
+   if ((err = mp_init(&ctx->prime)) != CRYPT_OK) {
+      ltc_ecc_del_point(ctx->result);
+      ctx->result = NULL;
+      return err;
+   }
+   ctx->idx = -1;
+   return CRYPT_OK;
+}
+
+/**
+  Create an ECC shared secret using a reusable context
+  @param ctx              An initialized EC-DH context
+  @param private_key      The private ECC key
+  @param public_key       The public key
+  @param out              [out] Destination of the shared secret (Conforms to EC-DH from ANSI X9.63)
+  @param outlen           [in/out] The max size and resulting size of the shared secret
+  @return CRYPT_OK if successful
+*/
+int ecc_shared_secret_ctx(ecc_shared_ctx *ctx,
+                          ecc_key *private_key, ecc_key *public_key,
+                          unsigned char *out, unsigned long *outlen)
+{
+   unsigned long  x;
+   int            err;
+
+   LTC_ARGCHK(ctx         != NULL);
+   LTC_ARGCHK(private_key != NULL);
+   LTC_ARGCHK(public_key  != NULL);
+   LTC_ARGCHK(out         != NULL);
+   LTC_ARGCHK(outlen      != NULL);
+
+   /* type valid? */
+   if (private_key->type != PK_PRIVATE) {
+      return CRYPT_PK_NOT_PRIVATE;
+   }
+
+   /* sealed keys were validated up front by ecc_key_seal() */
+   if ((private_key->sealed != 1 && ltc_ecc_is_valid_idx(private_key->idx) == 0) ||
+       (public_key->sealed  != 1 && ltc_ecc_is_valid_idx(public_key->idx)  == 0)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   if (private_key->dp != public_key->dp &&
+       XSTRCMP(private_key->dp->name, public_key->dp->name) != 0) {
+      return CRYPT_PK_TYPE_MISMATCH;
+   }
+
+   /* the prime survives across calls; re-read it only on a curve switch */
+   if (ctx->idx != private_key->idx) {
+      if ((err = mp_read_radix(ctx->prime, (char *)private_key->dp->prime, 16)) != CRYPT_OK) {
+         ctx->idx = -1;
+         return err;
+      }
+      ctx->idx = private_key->idx;
+   }
+
+   if ((err = ltc_mp.ecc_ptmul(private_key->k, &public_key->pubkey, ctx->result, ctx->prime, 1)) != CRYPT_OK) {
+      return err;
+   }
+
+   x = (unsigned long)mp_unsigned_bin_size(ctx->prime);
+   if (*outlen < x) {
+      *outlen = x;
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+   zeromem(out, x);
+   if ((err = mp_to_unsigned_bin(ctx->result->x, out + (x - mp_unsigned_bin_size(ctx->result->x)))) != CRYPT_OK) {
+      return err;
+   }
+
+   *outlen = x;
+   return CRYPT_OK;
+}
+
+/**
+  Create ECC shared secrets against several peer keys in one go
+  @param ctx              An initialized EC-DH context
+  @param private_key      The private ECC key
+  @param public_keys      Array of num public keys
+  @param outs             Array of num destination buffers
+  @param outlens          [in/out] Array of num max/resulting sizes
+  @param num              How many peers
+  @return CRYPT_OK if all secrets were derived
+*/
+int ecc_shared_secret_batch(ecc_shared_ctx *ctx,
+                            ecc_key *private_key, ecc_key **public_keys,
+                            unsigned char **outs, unsigned long *outlens,
+                            int num)
+{
+   int i, err;
+
+   LTC_ARGCHK(ctx         != NULL);
+   LTC_ARGCHK(private_key != NULL);
+   LTC_ARGCHK(public_keys != NULL);
+   LTC_ARGCHK(outs        != NULL);
+   LTC_ARGCHK(outlens     != NULL);
+
+   for (i = 0; i < num; i++) {
+      if ((err = ecc_shared_secret_ctx(ctx, private_key, public_keys[i],
+                                       outs[i], &outlens[i])) != CRYPT_OK) {
+         return err;
+      }
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Free a reusable EC-DH context
+  @param ctx    The context to free
+*/
+void ecc_shared_secret_ctx_free(ecc_shared_ctx *ctx)
+{
+   LTC_ARGCHKVD(ctx != NULL);
+   if (ctx->result != NULL) {
+      ltc_ecc_del_point(ctx->result);
+      ctx->result = NULL;
+   }
+   if (ctx->prime != NULL) {
+      mp_clear(ctx->prime);
+      ctx->prime = NULL;
+   }
+   ctx->idx = -1;
+}
+
+#endif
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
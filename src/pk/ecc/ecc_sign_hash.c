@@ -120,6 +120,7 @@ int ecc_sign_hash(const unsigned char *in,  unsigned long inlen,
                         prng_state *prng, int wprng, ecc_key *key)
 {
    void          *r, *s;
+   ltc_asn1_list rs[2];
    int           err;
 
    LTC_ARGCHK(in     != NULL);
@@ -135,11 +136,10 @@ int ecc_sign_hash(const unsigned char *in,  unsigned long inlen,
       goto error;
    }
 
-   /* store as SEQUENCE { r, s -- integer } */
-   err = der_encode_sequence_multi(out, outlen,
-                             LTC_ASN1_INTEGER, 1UL, r,
-                             LTC_ASN1_INTEGER, 1UL, s,
-                             LTC_ASN1_EOL, 0UL, NULL);
+   /* store as SEQUENCE { r, s -- integer } from a stack list */
+   LTC_SET_ASN1(rs, 0, LTC_ASN1_INTEGER, r, 1UL);
+   LTC_SET_ASN1(rs, 1, LTC_ASN1_INTEGER, s, 1UL);
+   err = der_encode_sequence(rs, 2, out, outlen);
 
 error:
    mp_clear_multi(r, s, NULL);
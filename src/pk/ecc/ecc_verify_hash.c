@@ -62,8 +62,8 @@ int ecc_verify_hash_raw(      void   *r, void   *s,
    *stat = 0;
    mp    = NULL;
 
-   /* is the IDX valid ?  */
-   if (ltc_ecc_is_valid_idx(key->idx) != 1) {
+   /* is the IDX valid ?  (sealed keys were validated up front) */
+   if (key->sealed != 1 && ltc_ecc_is_valid_idx(key->idx) != 1) {
       return CRYPT_PK_INVALID_TYPE;
    }
 
@@ -167,6 +167,7 @@ int ecc_verify_hash(const unsigned char *sig,  unsigned long siglen,
                     int *stat, ecc_key *key)
 {
    void          *r, *s;
+   ltc_asn1_list rs[2];
    int           err;
 
    LTC_ARGCHK(sig  != NULL);
@@ -179,11 +180,10 @@ int ecc_verify_hash(const unsigned char *sig,  unsigned long siglen,
       return CRYPT_MEM;
    }
 
-   /* parse header */
-   if ((err = der_decode_sequence_multi(sig, siglen,
-                                  LTC_ASN1_INTEGER, 1UL, r,
-                                  LTC_ASN1_INTEGER, 1UL, s,
-                                  LTC_ASN1_EOL, 0UL, NULL)) != CRYPT_OK) {
+   /* parse header from a stack list */
+   LTC_SET_ASN1(rs, 0, LTC_ASN1_INTEGER, r, 1UL);
+   LTC_SET_ASN1(rs, 1, LTC_ASN1_INTEGER, s, 1UL);
+   if ((err = der_decode_sequence(sig, siglen, rs, 2)) != CRYPT_OK) {
       goto error;
    }
 
@@ -0,0 +1,249 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/* Implements ECC over Z/pZ for curve y^2 = x^3 - 3x + b
+ *
+ * All curves taken from NIST recommendation paper of July 1999
+ * Available at http://csrc.nist.gov/cryptval/dss.htm
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ecc_verify_hash_batch.c
+  ECC Crypto, Tom St Denis
+
+  Verify a burst of independent ECDSA signatures.  Each signature
+  still needs its own u1*G + u2*Q Shamir evaluation -- with only
+  (r, s) on the wire the R points cannot be recombined into one
+  multi-exponentiation -- but everything around it is shared across
+  the batch: one set of bignums and points instead of ten per call,
+  and the curve order, modulus and base point are read from their hex
+  strings once per curve instead of once per signature.
+*/
+
+#ifdef LTC_MECC
+
+/**
+   Verify a batch of ECC signatures
+   @param sigs        Array of num signatures
+   @param siglens     Array of num signature lengths (octets)
+   @param hashes      Array of num hashes (message digests) that were signed
+   @param hashlens    Array of num hash lengths (octets)
+   @param stats       [out] Array of num results, 1==valid, 0==invalid
+   @param num         How many signatures
+   @param keys        Array of num corresponding public ECC keys
+   @return CRYPT_OK if successful (even if some signatures are not valid)
+*/
+int ecc_verify_hash_batch(const unsigned char **sigs,  const unsigned long *siglens,
+                          const unsigned char **hashes, const unsigned long *hashlens,
+                          int *stats, int num, ecc_key **keys)
+{
+   ecc_point     *mG, *mQ, *G;
+   void          *r, *s, *v, *w, *u1, *u2, *e, *p, *m, *ri, *wi;
+   ltc_asn1_list sig_list[2];
+   void          *mp;
+   void         **rs, **ws;
+   const ltc_ecc_set_type *dp;
+   ecc_key       *key;
+   int            i, err, batched;
+
+   LTC_ARGCHK(sigs     != NULL);
+   LTC_ARGCHK(siglens  != NULL);
+   LTC_ARGCHK(hashes   != NULL);
+   LTC_ARGCHK(hashlens != NULL);
+   LTC_ARGCHK(stats    != NULL);
+   LTC_ARGCHK(keys     != NULL);
+
+   mp = NULL;
+   dp = NULL;
+   rs = NULL;
+   ws = NULL;
+
+   /* one shot of allocations for the whole burst */
+   if ((err = mp_init_multi(&r, &s, &v, &w, &u1, &u2, &p, &e, &m, NULL)) != CRYPT_OK) {
+      return CRYPT_MEM;
+   }
+   mG = ltc_ecc_new_point();
+   mQ = ltc_ecc_new_point();
+   G  = ltc_ecc_new_point();
+   if (mG == NULL || mQ == NULL || G == NULL) {
+      err = CRYPT_MEM;
+      goto error;
+   }
+
+   /* when the whole burst is on one curve the s inversions collapse
+    * into a single mp_invmod by Montgomery's trick */
+   batched = (num > 1);
+   for (i = 1; i < num; i++) {
+      if (keys[i] == NULL || keys[0] == NULL || keys[i]->dp != keys[0]->dp) {
+         batched = 0;
+         break;
+      }
+   }
+   if (batched) {
+      rs = XCALLOC(num, sizeof(*rs));
+      ws = XCALLOC(num, sizeof(*ws));
+      if (rs == NULL || ws == NULL) {
+         err = CRYPT_MEM;
+         goto error;
+      }
+      if ((err = mp_read_radix(p, (char *)keys[0]->dp->order, 16)) != CRYPT_OK)                           { goto error; }
+      for (i = 0; i < num; i++) {
+         if (sigs[i] == NULL) {
+            err = CRYPT_INVALID_ARG;
+            goto error;
+         }
+         if ((err = mp_init_multi(&rs[i], &ws[i], NULL)) != CRYPT_OK) {
+            rs[i] = ws[i] = NULL;
+            goto error;
+         }
+         LTC_SET_ASN1(sig_list, 0, LTC_ASN1_INTEGER, rs[i], 1UL);
+         LTC_SET_ASN1(sig_list, 1, LTC_ASN1_INTEGER, ws[i], 1UL);
+         if ((err = der_decode_sequence(sigs[i], siglens[i], sig_list, 2)) != CRYPT_OK) {
+            goto error;
+         }
+         if (mp_iszero(rs[i]) || mp_iszero(ws[i]) ||
+             mp_cmp(rs[i], p) != LTC_MP_LT || mp_cmp(ws[i], p) != LTC_MP_LT) {
+            err = CRYPT_INVALID_PACKET;
+            goto error;
+         }
+      }
+      /* ws[i] becomes 1/s_i mod n */
+      if ((err = ltc_mp_invmod_multi(ws, num, p)) != CRYPT_OK)                                            { goto error; }
+   }
+
+   for (i = 0; i < num; i++) {
+      stats[i] = 0;
+      key = keys[i];
+      if (key == NULL || sigs[i] == NULL || hashes[i] == NULL) {
+         err = CRYPT_INVALID_ARG;
+         goto error;
+      }
+      if (ltc_ecc_is_valid_idx(key->idx) != 1) {
+         err = CRYPT_PK_INVALID_TYPE;
+         goto error;
+      }
+
+      /* curve constants survive until the curve changes */
+      if (dp != key->dp) {
+         if ((err = mp_read_radix(p, (char *)key->dp->order, 16)) != CRYPT_OK)                           { goto error; }
+         if ((err = mp_read_radix(m, (char *)key->dp->prime, 16)) != CRYPT_OK)                           { goto error; }
+         if ((err = mp_read_radix(G->x, (char *)key->dp->Gx, 16)) != CRYPT_OK)                           { goto error; }
+         if ((err = mp_read_radix(G->y, (char *)key->dp->Gy, 16)) != CRYPT_OK)                           { goto error; }
+         if ((err = mp_set(G->z, 1)) != CRYPT_OK)                                                        { goto error; }
+         dp = key->dp;
+      }
+
+      if (batched) {
+         /* decoded, range checked and inverted up front */
+         ri = rs[i];
+         wi = ws[i];
+      } else {
+         /* parse header */
+         LTC_SET_ASN1(sig_list, 0, LTC_ASN1_INTEGER, r, 1UL);
+         LTC_SET_ASN1(sig_list, 1, LTC_ASN1_INTEGER, s, 1UL);
+         if ((err = der_decode_sequence(sigs[i], siglens[i], sig_list, 2)) != CRYPT_OK) {
+            goto error;
+         }
+
+         /* check for zero */
+         if (mp_iszero(r) || mp_iszero(s) || mp_cmp(r, p) != LTC_MP_LT || mp_cmp(s, p) != LTC_MP_LT) {
+            err = CRYPT_INVALID_PACKET;
+            goto error;
+         }
+
+         /*  w  = s^-1 mod n */
+         if ((err = mp_invmod(s, p, w)) != CRYPT_OK)                                                     { goto error; }
+         ri = r;
+         wi = w;
+      }
+
+      /* read hash */
+      if ((err = mp_read_unsigned_bin(e, (unsigned char *)hashes[i], (int)hashlens[i])) != CRYPT_OK)     { goto error; }
+
+      /* u1 = ew */
+      if ((err = mp_mulmod(e, wi, p, u1)) != CRYPT_OK)                                                   { goto error; }
+
+      /* u2 = rw */
+      if ((err = mp_mulmod(ri, wi, p, u2)) != CRYPT_OK)                                                  { goto error; }
+
+      /* find mG and mQ */
+      if ((err = mp_copy(G->x, mG->x)) != CRYPT_OK)                                                      { goto error; }
+      if ((err = mp_copy(G->y, mG->y)) != CRYPT_OK)                                                      { goto error; }
+      if ((err = mp_copy(G->z, mG->z)) != CRYPT_OK)                                                      { goto error; }
+
+      if ((err = mp_copy(key->pubkey.x, mQ->x)) != CRYPT_OK)                                             { goto error; }
+      if ((err = mp_copy(key->pubkey.y, mQ->y)) != CRYPT_OK)                                             { goto error; }
+      if ((err = mp_copy(key->pubkey.z, mQ->z)) != CRYPT_OK)                                             { goto error; }
+
+      /* compute u1*mG + u2*mQ = mG */
+      if (ltc_mp.ecc_mul2add == NULL) {
+         if ((err = ltc_mp.ecc_ptmul(u1, mG, mG, m, 0)) != CRYPT_OK)                                     { goto error; }
+         if ((err = ltc_mp.ecc_ptmul(u2, mQ, mQ, m, 0)) != CRYPT_OK)                                     { goto error; }
+
+         /* find the montgomery mp */
+         if (mp == NULL) {
+            if ((err = mp_montgomery_setup(m, &mp)) != CRYPT_OK)                                         { goto error; }
+         }
+
+         /* add them */
+         if ((err = ltc_mp.ecc_ptadd(mQ, mG, mG, m, mp)) != CRYPT_OK)                                    { goto error; }
+
+         /* reduce */
+         if ((err = ltc_mp.ecc_map(mG, m, mp)) != CRYPT_OK)                                              { goto error; }
+      } else {
+         /* use Shamir's trick to compute u1*mG + u2*mQ using half of the doubles */
+         if ((err = ltc_mp.ecc_mul2add(mG, u1, mQ, u2, mG, m)) != CRYPT_OK)                              { goto error; }
+      }
+
+      /* v = X_x1 mod n */
+      if ((err = mp_mod(mG->x, p, v)) != CRYPT_OK)                                                       { goto error; }
+
+      /* does v == r */
+      if (mp_cmp(v, ri) == LTC_MP_EQ) {
+         stats[i] = 1;
+      }
+
+      /* the montgomery setup is per modulus */
+      if (mp != NULL && i + 1 < num && keys[i+1] != NULL && keys[i+1]->dp != dp) {
+         mp_montgomery_free(mp);
+         mp = NULL;
+      }
+   }
+
+   /* clear up and return */
+   err = CRYPT_OK;
+error:
+   ltc_ecc_del_point(G);
+   ltc_ecc_del_point(mG);
+   ltc_ecc_del_point(mQ);
+   mp_clear_multi(r, s, v, w, u1, u2, p, e, m, NULL);
+   if (rs != NULL) {
+      for (i = 0; i < num; i++) {
+         if (rs[i] != NULL) {
+            mp_clear_multi(rs[i], ws[i], NULL);
+         }
+      }
+      XFREE(rs);
+   }
+   if (ws != NULL) {
+      XFREE(ws);
+   }
+   if (mp != NULL) {
+      mp_montgomery_free(mp);
+   }
+   return err;
+}
+
+#endif
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,246 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/* Implements ECC over Z/pZ for curve y^2 = x^3 - 3x + b
+ *
+ * All curves taken from NIST recommendation paper of July 1999
+ * Available at http://csrc.nist.gov/cryptval/dss.htm
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ltc_ecc_fixed_base.c
+  ECC Crypto, Tom St Denis
+
+  Fixed base point multiplication for the built-in curves.  The
+  generator of a curve never changes, so a per-curve table of
+  T[i] = 16^i * G is built once and every later kG becomes one pass
+  of table additions (Brickell-Gordon-McCurley-Wilson with 4-bit
+  digits) instead of a fresh double-and-add ladder.  Key generation
+  and therefore signing lean on this; arbitrary-point multiplication
+  is unaffected.
+*/
+
+#ifdef LTC_MECC
+
+/* one table per entry of ltc_ecc_sets[]; the list is terminated by a
+ * zero size so the live count is found at runtime */
+#define ECC_FB_MAXSETS 32
+
+static ecc_point **fb_tab[ECC_FB_MAXSETS];
+static int         fb_len[ECC_FB_MAXSETS];
+
+LTC_MUTEX_GLOBAL(ltc_ecc_fb_mutex)
+
+/* which built-in set is this, -1 if user supplied */
+int ltc_ecc_fb_set_idx(const ltc_ecc_set_type *dp)
+{
+   int i;
+   for (i = 0; ltc_ecc_sets[i].size != 0 && i < ECC_FB_MAXSETS; i++) {
+      if (dp == &ltc_ecc_sets[i]) {
+         return i;
+      }
+   }
+   return -1;
+}
+
+/* the idx'th 4-bit digit of a, spanning limb boundaries */
+static int s_ecc_fb_digit(void *a, int idx)
+{
+   int bit, d, i;
+
+   d = 0;
+   for (i = 3; i >= 0; i--) {
+      bit = 4 * idx + i;
+      d <<= 1;
+      d |= (int)((mp_get_digit(a, bit / (int)ltc_mp.bits_per_digit) >>
+                  (bit % (int)ltc_mp.bits_per_digit)) & 1);
+   }
+   return d;
+}
+
+/* build the table for set idx; must hold the mutex.  The points are
+ * kept in the montgomery domain so the per-signature pass needs no
+ * mapping of the table */
+static int s_ecc_fb_build(int idx, void *modulus, void *mp, void *mu)
+{
+   ecc_point **tab;
+   void       *order;
+   int         i, j, len, err;
+
+   if ((err = mp_init(&order)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = mp_read_radix(order, (char *)ltc_ecc_sets[idx].order, 16)) != CRYPT_OK) {
+      mp_clear(order);
+      return err;
+   }
+   len = (mp_count_bits(order) + 3) / 4;
+   mp_clear(order);
+
+   tab = XMALLOC_ALIGNED(len * sizeof(*tab), 64);
+   if (tab == NULL) {
+      return CRYPT_MEM;
+   }
+   zeromem(tab, len * sizeof(*tab));
+   for (i = 0; i < len; i++) {
+      tab[i] = ltc_ecc_new_point();
+      if (tab[i] == NULL) {
+         err = CRYPT_MEM;
+         goto failed;
+      }
+   }
+
+   /* T[0] = G in the montgomery domain */
+   if ((err = mp_read_radix(tab[0]->x, (char *)ltc_ecc_sets[idx].Gx, 16)) != CRYPT_OK)    { goto failed; }
+   if ((err = mp_read_radix(tab[0]->y, (char *)ltc_ecc_sets[idx].Gy, 16)) != CRYPT_OK)    { goto failed; }
+   if ((err = mp_mulmod(tab[0]->x, mu, modulus, tab[0]->x)) != CRYPT_OK)                  { goto failed; }
+   if ((err = mp_mulmod(tab[0]->y, mu, modulus, tab[0]->y)) != CRYPT_OK)                  { goto failed; }
+   if ((err = mp_copy(mu, tab[0]->z)) != CRYPT_OK)                                        { goto failed; }
+
+   /* T[i+1] = 16 * T[i] */
+   for (i = 1; i < len; i++) {
+      if ((err = ltc_mp.ecc_ptdbl(tab[i-1], tab[i], modulus, mp)) != CRYPT_OK)            { goto failed; }
+      for (j = 0; j < 3; j++) {
+         if ((err = ltc_mp.ecc_ptdbl(tab[i], tab[i], modulus, mp)) != CRYPT_OK)           { goto failed; }
+      }
+   }
+
+   fb_tab[idx] = tab;
+   fb_len[idx] = len;
+   return CRYPT_OK;
+failed:
+   for (i = 0; i < len; i++) {
+      if (tab[i] != NULL) {
+         ltc_ecc_del_point(tab[i]);
+      }
+   }
+   XFREE_ALIGNED(tab);
+   return err;
+}
+
+/**
+   Multiply the generator of a built-in curve off its fixed table
+   @param idx      Index into ltc_ecc_sets[] (see ltc_ecc_fb_set_idx)
+   @param k        The multiplicand
+   @param R        [out] Destination of kG, mapped to affine
+   @param modulus  The modulus for the curve
+   @return CRYPT_OK on success
+*/
+int ltc_ecc_fb_mulmod(int idx, void *k, ecc_point *R, void *modulus)
+{
+   ecc_point  *B;
+   ecc_point **tab;
+   void       *mp, *mu;
+   int         i, w, len, a_set, b_set, err, cached;
+
+   LTC_ARGCHK(k       != NULL);
+   LTC_ARGCHK(R       != NULL);
+   LTC_ARGCHK(modulus != NULL);
+
+   if (idx < 0 || idx >= ECC_FB_MAXSETS) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* the montgomery constants, cached per curve */
+   if ((err = ltc_ecc_mont_get(modulus, &mp, &mu, &cached)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* lazily build the table; it is immutable afterwards so the pass
+    * below runs outside the mutex */
+   LTC_MUTEX_LOCK(&ltc_ecc_fb_mutex);
+   if (fb_tab[idx] == NULL) {
+      err = s_ecc_fb_build(idx, modulus, mp, mu);
+   } else {
+      err = CRYPT_OK;
+   }
+   LTC_MUTEX_UNLOCK(&ltc_ecc_fb_mutex);
+   if (err != CRYPT_OK)                                                                   { goto done2; }
+   tab = fb_tab[idx];
+   len = fb_len[idx];
+
+   B = ltc_ecc_new_point();
+   if (B == NULL) {
+      err = CRYPT_MEM;
+      goto done2;
+   }
+
+   /* BGMW pass: for w = 15..1 fold every T[i] whose digit equals w
+    * into B, then fold B into the accumulator R; R ends up as
+    * sum(d_i * 16^i * G) = kG with roughly len + 15 additions */
+   a_set = b_set = 0;
+   for (w = 15; w >= 1; w--) {
+      for (i = 0; i < len; i++) {
+         if (s_ecc_fb_digit(k, i) != w) {
+            continue;
+         }
+         if (!b_set) {
+            if ((err = mp_copy(tab[i]->x, B->x)) != CRYPT_OK)                             { goto done; }
+            if ((err = mp_copy(tab[i]->y, B->y)) != CRYPT_OK)                             { goto done; }
+            if ((err = mp_copy(tab[i]->z, B->z)) != CRYPT_OK)                             { goto done; }
+            b_set = 1;
+         } else {
+            if ((err = ltc_mp.ecc_ptadd(B, tab[i], B, modulus, mp)) != CRYPT_OK)          { goto done; }
+         }
+      }
+      if (!b_set) {
+         continue;
+      }
+      if (!a_set) {
+         if ((err = mp_copy(B->x, R->x)) != CRYPT_OK)                                     { goto done; }
+         if ((err = mp_copy(B->y, R->y)) != CRYPT_OK)                                     { goto done; }
+         if ((err = mp_copy(B->z, R->z)) != CRYPT_OK)                                     { goto done; }
+         a_set = 1;
+      } else {
+         if ((err = ltc_mp.ecc_ptadd(R, B, R, modulus, mp)) != CRYPT_OK)                  { goto done; }
+      }
+   }
+   if (!a_set) {
+      /* k == 0; nothing sensible to map */
+      err = CRYPT_INVALID_ARG;
+      goto done;
+   }
+
+   err = ltc_ecc_map(R, modulus, mp);
+done:
+   ltc_ecc_del_point(B);
+done2:
+   if (!cached) {
+      mp_clear(mu);
+      mp_montgomery_free(mp);
+   }
+   return err;
+}
+
+/** Free the fixed base tables (not thread safe against concurrent use) */
+void ltc_ecc_fixed_base_free(void)
+{
+   int i, j;
+
+   LTC_MUTEX_LOCK(&ltc_ecc_fb_mutex);
+   for (i = 0; i < ECC_FB_MAXSETS; i++) {
+      if (fb_tab[i] != NULL) {
+         for (j = 0; j < fb_len[i]; j++) {
+            ltc_ecc_del_point(fb_tab[i][j]);
+         }
+         XFREE_ALIGNED(fb_tab[i]);
+         fb_tab[i] = NULL;
+         fb_len[i] = 0;
+      }
+   }
+   LTC_MUTEX_UNLOCK(&ltc_ecc_fb_mutex);
+}
+
+#endif
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
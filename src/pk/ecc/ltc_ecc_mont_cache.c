@@ -0,0 +1,158 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/* Implements ECC over Z/pZ for curve y^2 = x^3 - 3x + b
+ *
+ * All curves taken from NIST recommendation paper of July 1999
+ * Available at http://csrc.nist.gov/cryptval/dss.htm
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ltc_ecc_mont_cache.c
+  ECC Crypto, Tom St Denis
+
+  The Montgomery setup and normalization constant depend only on the
+  curve prime, yet every point multiply used to derive them afresh.
+  This keeps them in a small per-process table keyed by the modulus
+  value, so repeated operations on the same curve pay the setup once.
+  The cached objects are read-only after creation and may be shared
+  between threads; callers must not free them when *cached is set.
+*/
+
+#ifdef LTC_MECC
+
+/* a handful of slots covers every curve a process realistically uses;
+ * when they are all taken the caller simply owns a fresh setup */
+#define ECC_MONT_CACHE 8
+
+static struct {
+   void *modulus, *mp, *mu;
+} s_mont_cache[ECC_MONT_CACHE];
+
+LTC_RWLOCK_GLOBAL(ltc_ecc_mont_lock)
+
+/* fresh caller-owned constants, used when the cache is full */
+static int s_mont_make(void *modulus, void **mp, void **mu)
+{
+   int err;
+
+   if ((err = mp_montgomery_setup(modulus, mp)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = mp_init(mu)) != CRYPT_OK) {
+      mp_montgomery_free(*mp);
+      return err;
+   }
+   if ((err = mp_montgomery_normalization(*mu, modulus)) != CRYPT_OK) {
+      mp_clear(*mu);
+      mp_montgomery_free(*mp);
+      return err;
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Fetch the Montgomery constants for a modulus, caching per process
+   @param modulus  The curve prime
+   @param mp       [out] The Montgomery setup of modulus
+   @param mu       [out] The normalization constant R mod modulus
+   @param cached   [out] 1 if mp/mu are cache owned (do not free them),
+                         0 if the caller owns them
+   @return CRYPT_OK on success
+*/
+int ltc_ecc_mont_get(void *modulus, void **mp, void **mu, int *cached)
+{
+   int i, err;
+
+   LTC_ARGCHK(modulus != NULL);
+   LTC_ARGCHK(mp      != NULL);
+   LTC_ARGCHK(mu      != NULL);
+   LTC_ARGCHK(cached  != NULL);
+
+   /* shared probe first; the common case after warmup */
+   LTC_RWLOCK_RDLOCK(&ltc_ecc_mont_lock);
+   for (i = 0; i < ECC_MONT_CACHE; i++) {
+      if (s_mont_cache[i].modulus != NULL &&
+          mp_cmp(modulus, s_mont_cache[i].modulus) == LTC_MP_EQ) {
+         *mp     = s_mont_cache[i].mp;
+         *mu     = s_mont_cache[i].mu;
+         *cached = 1;
+         LTC_RWLOCK_UNLOCK(&ltc_ecc_mont_lock);
+         return CRYPT_OK;
+      }
+   }
+   LTC_RWLOCK_UNLOCK(&ltc_ecc_mont_lock);
+
+   LTC_RWLOCK_WRLOCK(&ltc_ecc_mont_lock);
+   /* someone may have filled the slot while we waited */
+   for (i = 0; i < ECC_MONT_CACHE; i++) {
+      if (s_mont_cache[i].modulus != NULL &&
+          mp_cmp(modulus, s_mont_cache[i].modulus) == LTC_MP_EQ) {
+         *mp     = s_mont_cache[i].mp;
+         *mu     = s_mont_cache[i].mu;
+         *cached = 1;
+         LTC_RWLOCK_UNLOCK(&ltc_ecc_mont_lock);
+         return CRYPT_OK;
+      }
+   }
+   for (i = 0; i < ECC_MONT_CACHE; i++) {
+      if (s_mont_cache[i].modulus == NULL) {
+         break;
+      }
+   }
+   if (i == ECC_MONT_CACHE) {
+      /* full; hand out a private copy */
+      LTC_RWLOCK_UNLOCK(&ltc_ecc_mont_lock);
+      *cached = 0;
+      return s_mont_make(modulus, mp, mu);
+   }
+
+   if ((err = s_mont_make(modulus, &s_mont_cache[i].mp, &s_mont_cache[i].mu)) != CRYPT_OK) {
+      LTC_RWLOCK_UNLOCK(&ltc_ecc_mont_lock);
+      return err;
+   }
+   if ((err = mp_init_copy(&s_mont_cache[i].modulus, modulus)) != CRYPT_OK) {
+      mp_clear(s_mont_cache[i].mu);
+      mp_montgomery_free(s_mont_cache[i].mp);
+      s_mont_cache[i].mp = s_mont_cache[i].mu = NULL;
+      LTC_RWLOCK_UNLOCK(&ltc_ecc_mont_lock);
+      return err;
+   }
+   *mp     = s_mont_cache[i].mp;
+   *mu     = s_mont_cache[i].mu;
+   *cached = 1;
+   LTC_RWLOCK_UNLOCK(&ltc_ecc_mont_lock);
+   return CRYPT_OK;
+}
+
+/**
+   Free the cached Montgomery constants (process shutdown)
+*/
+void ltc_ecc_mont_cache_free(void)
+{
+   int i;
+
+   LTC_RWLOCK_WRLOCK(&ltc_ecc_mont_lock);
+   for (i = 0; i < ECC_MONT_CACHE; i++) {
+      if (s_mont_cache[i].modulus != NULL) {
+         mp_clear_multi(s_mont_cache[i].modulus, s_mont_cache[i].mu, NULL);
+         mp_montgomery_free(s_mont_cache[i].mp);
+         s_mont_cache[i].modulus = s_mont_cache[i].mp = s_mont_cache[i].mu = NULL;
+      }
+   }
+   LTC_RWLOCK_UNLOCK(&ltc_ecc_mont_lock);
+}
+
+#endif
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
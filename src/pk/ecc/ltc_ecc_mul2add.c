@@ -42,7 +42,7 @@ int ltc_ecc_mul2add(ecc_point *A, void *kA,
   ecc_point     *precomp[16];
   unsigned       bitbufA, bitbufB, lenA, lenB, len, x, y, nA, nB, nibble;
   unsigned char *tA, *tB;
-  int            err, first;
+  int            err, first, cached;
   void          *mp, *mu;
 
   /* argchks */
@@ -93,16 +93,10 @@ int ltc_ecc_mul2add(ecc_point *A, void *kA,
      }
   }
 
-  /* init montgomery reduction */
-  if ((err = mp_montgomery_setup(modulus, &mp)) != CRYPT_OK) {
+  /* the montgomery constants, cached per curve */
+  if ((err = ltc_ecc_mont_get(modulus, &mp, &mu, &cached)) != CRYPT_OK) {
       goto ERR_P;
   }
-  if ((err = mp_init(&mu)) != CRYPT_OK) {
-      goto ERR_MP;
-  }
-  if ((err = mp_montgomery_normalization(mu, modulus)) != CRYPT_OK) {
-      goto ERR_MU;
-  }
 
   /* copy ones ... */
   if ((err = mp_mulmod(A->x, mu, modulus, precomp[1]->x)) != CRYPT_OK)                                         { goto ERR_MU; }
@@ -182,9 +176,10 @@ int ltc_ecc_mul2add(ecc_point *A, void *kA,
 
   /* clean up */
 ERR_MU:
-   mp_clear(mu);
-ERR_MP:
-   mp_montgomery_free(mp);
+   if (!cached) {
+      mp_clear(mu);
+      mp_montgomery_free(mp);
+   }
 ERR_P:
    for (x = 0; x < 16; x++) {
        ltc_ecc_del_point(precomp[x]);
@@ -24,7 +24,9 @@
 #ifdef LTC_MECC
 #ifndef LTC_ECC_TIMING_RESISTANT
 
-/* size of sliding window, don't change this! */
+/* window width for the signed wNAF digits; digits are odd values in
+ * -(2^WINSIZE - 1) .. 2^WINSIZE - 1 so only the four odd multiples
+ * G, 3G, 5G, 7G get precomputed, negatives are a cheap y flip */
 #define WINSIZE 4
 
 /**
@@ -38,47 +40,95 @@
 */
 int ltc_ecc_mulmod(void *k, ecc_point *G, ecc_point *R, void *modulus, int map)
 {
-   ecc_point *tG, *M[8];
-   int        i, j, err;
-   void       *mu, *mp;
-   ltc_mp_digit buf;
-   int        first, bitbuf, bitcpy, bitcnt, mode, digidx;
+   ecc_point   *tG, *D, *M[4], *N[4];
+   int          i, j, err, nbits, naflen, d, first, cached;
+   void        *mu, *mp;
+   unsigned char *bits;
+   signed char   *naf;
 
    LTC_ARGCHK(k       != NULL);
    LTC_ARGCHK(G       != NULL);
    LTC_ARGCHK(R       != NULL);
    LTC_ARGCHK(modulus != NULL);
 
-   /* init montgomery reduction */
-   if ((err = mp_montgomery_setup(modulus, &mp)) != CRYPT_OK) {
-      return err;
+#ifdef LTC_ECC_P256
+   /* the P-256 prime gets the dedicated fixed-limb backend */
+   if (ltc_ecc_p256_accel_ok(k, G, modulus, map)) {
+      return ltc_ecc_p256_mulmod(k, G, R);
    }
-   if ((err = mp_init(&mu)) != CRYPT_OK) {
-      mp_montgomery_free(mp);
+#endif
+
+   /* the montgomery constants, cached per curve */
+   if ((err = ltc_ecc_mont_get(modulus, &mp, &mu, &cached)) != CRYPT_OK) {
       return err;
    }
-   if ((err = mp_montgomery_normalization(mu, modulus)) != CRYPT_OK) {
-      mp_montgomery_free(mp);
-      mp_clear(mu);
-      return err;
+
+   /* recode the scalar to wNAF; the carry can run a few bits past the
+    * top so leave headroom */
+   nbits  = mp_count_bits(k);
+   bits   = XCALLOC(1, (nbits + 8) * 2);
+   if (bits == NULL) {
+      if (!cached) {
+         mp_clear(mu);
+         mp_montgomery_free(mp);
+      }
+      return CRYPT_MEM;
    }
+   naf = (signed char *)(bits + nbits + 8);
 
-  /* alloc ram for window temps */
-  for (i = 0; i < 8; i++) {
+   for (i = 0; i < nbits; i++) {
+      bits[i] = (unsigned char)((mp_get_digit(k, i / (int)ltc_mp.bits_per_digit) >>
+                                 (i % (int)ltc_mp.bits_per_digit)) & 1);
+   }
+   naflen = 0;
+   for (i = 0; i < nbits + 8; ) {
+      if (bits[i] == 0) {
+         naf[i++] = 0;
+         continue;
+      }
+      /* gather WINSIZE bits and make the digit odd and centered */
+      d = bits[i] + 2*bits[i+1] + 4*bits[i+2] + 8*bits[i+3];
+      if (d >= (1 << (WINSIZE-1))) {
+         d -= (1 << WINSIZE);
+         /* propagate the borrow as a carry above the window */
+         j = i + WINSIZE;
+         while (bits[j] == 1) {
+            bits[j++] = 0;
+         }
+         bits[j] = 1;
+      }
+      naf[i] = (signed char)d;
+      naflen = i + 1;
+      for (j = 1; j < WINSIZE && i + j < nbits + 8; j++) {
+         naf[i+j] = 0;
+      }
+      i += WINSIZE;
+   }
+
+  /* alloc ram for the odd multiples and their negatives */
+  for (i = 0; i < 4; i++) {
       M[i] = ltc_ecc_new_point();
-      if (M[i] == NULL) {
+      N[i] = ltc_ecc_new_point();
+      if (M[i] == NULL || N[i] == NULL) {
+         if (M[i] != NULL) ltc_ecc_del_point(M[i]);
+         if (N[i] != NULL) ltc_ecc_del_point(N[i]);
          for (j = 0; j < i; j++) {
              ltc_ecc_del_point(M[j]);
+             ltc_ecc_del_point(N[j]);
          }
-         mp_montgomery_free(mp);
-         mp_clear(mu);
+         if (!cached) {
+            mp_clear(mu);
+            mp_montgomery_free(mp);
+         }
+         XFREE(bits);
          return CRYPT_MEM;
       }
   }
 
    /* make a copy of G incase R==G */
    tG = ltc_ecc_new_point();
-   if (tG == NULL)                                                                   { err = CRYPT_MEM; goto done; }
+   D  = ltc_ecc_new_point();
+   if (tG == NULL || D == NULL)                                                      { err = CRYPT_MEM; goto done; }
 
    /* tG = G  and convert to montgomery */
    if (mp_cmp_d(mu, 1) == LTC_MP_EQ) {
@@ -90,107 +140,45 @@ int ltc_ecc_mulmod(void *k, ecc_point *G, ecc_point *R, void *modulus, int map)
       if ((err = mp_mulmod(G->y, mu, modulus, tG->y)) != CRYPT_OK)                   { goto done; }
       if ((err = mp_mulmod(G->z, mu, modulus, tG->z)) != CRYPT_OK)                   { goto done; }
    }
-   mp_clear(mu);
-   mu = NULL;
-
-   /* calc the M tab, which holds kG for k==8..15 */
-   /* M[0] == 8G */
-   if ((err = ltc_mp.ecc_ptdbl(tG, M[0], modulus, mp)) != CRYPT_OK)                 { goto done; }
-   if ((err = ltc_mp.ecc_ptdbl(M[0], M[0], modulus, mp)) != CRYPT_OK)               { goto done; }
-   if ((err = ltc_mp.ecc_ptdbl(M[0], M[0], modulus, mp)) != CRYPT_OK)               { goto done; }
-
-   /* now find (8+k)G for k=1..7 */
-   for (j = 9; j < 16; j++) {
-       if ((err = ltc_mp.ecc_ptadd(M[j-9], tG, M[j-8], modulus, mp)) != CRYPT_OK)   { goto done; }
-   }
 
-   /* setup sliding window */
-   mode   = 0;
-   bitcnt = 1;
-   buf    = 0;
-   digidx = mp_get_digit_count(k) - 1;
-   bitcpy = bitbuf = 0;
-   first  = 1;
-
-   /* perform ops */
-   for (;;) {
-     /* grab next digit as required */
-     if (--bitcnt == 0) {
-       if (digidx == -1) {
-          break;
-       }
-       buf    = mp_get_digit(k, digidx);
-       bitcnt = (int) ltc_mp.bits_per_digit;
-       --digidx;
-     }
-
-     /* grab the next msb from the ltiplicand */
-     i = (buf >> (ltc_mp.bits_per_digit - 1)) & 1;
-     buf <<= 1;
-
-     /* skip leading zero bits */
-     if (mode == 0 && i == 0) {
-        continue;
-     }
-
-     /* if the bit is zero and mode == 1 then we double */
-     if (mode == 1 && i == 0) {
-        if ((err = ltc_mp.ecc_ptdbl(R, R, modulus, mp)) != CRYPT_OK)                 { goto done; }
-        continue;
-     }
-
-     /* else we add it to the window */
-     bitbuf |= (i << (WINSIZE - ++bitcpy));
-     mode = 2;
-
-     if (bitcpy == WINSIZE) {
-       /* if this is the first window we do a simple copy */
-       if (first == 1) {
-          /* R = kG [k = first window] */
-          if ((err = mp_copy(M[bitbuf-8]->x, R->x)) != CRYPT_OK)                     { goto done; }
-          if ((err = mp_copy(M[bitbuf-8]->y, R->y)) != CRYPT_OK)                     { goto done; }
-          if ((err = mp_copy(M[bitbuf-8]->z, R->z)) != CRYPT_OK)                     { goto done; }
-          first = 0;
-       } else {
-         /* normal window */
-         /* ok window is filled so double as required and add  */
-         /* double first */
-         for (j = 0; j < WINSIZE; j++) {
-           if ((err = ltc_mp.ecc_ptdbl(R, R, modulus, mp)) != CRYPT_OK)              { goto done; }
-         }
+   /* M[i] = (2i+1)G off a single doubling: one dbl and three adds
+    * replace the old fixed-window build of three dbls and seven adds */
+   if ((err = ltc_mp.ecc_ptdbl(tG, D, modulus, mp)) != CRYPT_OK)                     { goto done; }
+   if ((err = mp_copy(tG->x, M[0]->x)) != CRYPT_OK)                                  { goto done; }
+   if ((err = mp_copy(tG->y, M[0]->y)) != CRYPT_OK)                                  { goto done; }
+   if ((err = mp_copy(tG->z, M[0]->z)) != CRYPT_OK)                                  { goto done; }
+   for (i = 1; i < 4; i++) {
+      if ((err = ltc_mp.ecc_ptadd(M[i-1], D, M[i], modulus, mp)) != CRYPT_OK)        { goto done; }
+   }
 
-         /* then add, bitbuf will be 8..15 [8..2^WINSIZE] guaranteed */
-         if ((err = ltc_mp.ecc_ptadd(R, M[bitbuf-8], R, modulus, mp)) != CRYPT_OK)   { goto done; }
-       }
-       /* empty window and reset */
-       bitcpy = bitbuf = 0;
-       mode = 1;
-    }
-  }
+   /* N[i] = -M[i]; negation is y -> modulus - y, valid in the
+    * montgomery domain too */
+   for (i = 0; i < 4; i++) {
+      if ((err = mp_copy(M[i]->x, N[i]->x)) != CRYPT_OK)                             { goto done; }
+      if ((err = mp_sub(modulus, M[i]->y, N[i]->y)) != CRYPT_OK)                     { goto done; }
+      if ((err = mp_copy(M[i]->z, N[i]->z)) != CRYPT_OK)                             { goto done; }
+   }
 
-   /* if bits remain then double/add */
-   if (mode == 2 && bitcpy > 0) {
-     /* double then add */
-     for (j = 0; j < bitcpy; j++) {
-       /* only double if we have had at least one add first */
-       if (first == 0) {
-          if ((err = ltc_mp.ecc_ptdbl(R, R, modulus, mp)) != CRYPT_OK)              { goto done; }
-       }
-
-       bitbuf <<= 1;
-       if ((bitbuf & (1 << WINSIZE)) != 0) {
-         if (first == 1){
-            /* first add, so copy */
-            if ((err = mp_copy(tG->x, R->x)) != CRYPT_OK)                           { goto done; }
-            if ((err = mp_copy(tG->y, R->y)) != CRYPT_OK)                           { goto done; }
-            if ((err = mp_copy(tG->z, R->z)) != CRYPT_OK)                           { goto done; }
-            first = 0;
-         } else {
-            /* then add */
-            if ((err = ltc_mp.ecc_ptadd(R, tG, R, modulus, mp)) != CRYPT_OK)        { goto done; }
-         }
-       }
-     }
+   /* scan the wNAF from the top; R picks up the first digit by copy */
+   first = 1;
+   for (i = naflen - 1; i >= 0; i--) {
+      if (first == 0) {
+         if ((err = ltc_mp.ecc_ptdbl(R, R, modulus, mp)) != CRYPT_OK)                { goto done; }
+      }
+      d = naf[i];
+      if (d == 0) {
+         continue;
+      }
+      if (first == 1) {
+         ecc_point *P = (d > 0) ? M[(d-1) >> 1] : N[(-d-1) >> 1];
+         if ((err = mp_copy(P->x, R->x)) != CRYPT_OK)                                { goto done; }
+         if ((err = mp_copy(P->y, R->y)) != CRYPT_OK)                                { goto done; }
+         if ((err = mp_copy(P->z, R->z)) != CRYPT_OK)                                { goto done; }
+         first = 0;
+      } else {
+         ecc_point *P = (d > 0) ? M[(d-1) >> 1] : N[(-d-1) >> 1];
+         if ((err = ltc_mp.ecc_ptadd(R, P, R, modulus, mp)) != CRYPT_OK)             { goto done; }
+      }
    }
 
    /* map R back from projective space */
@@ -200,14 +188,17 @@ int ltc_ecc_mulmod(void *k, ecc_point *G, ecc_point *R, void *modulus, int map)
       err = CRYPT_OK;
    }
 done:
-   if (mu != NULL) {
+   if (!cached) {
       mp_clear(mu);
+      mp_montgomery_free(mp);
    }
-   mp_montgomery_free(mp);
+   ltc_ecc_del_point(D);
    ltc_ecc_del_point(tG);
-   for (i = 0; i < 8; i++) {
+   for (i = 0; i < 4; i++) {
        ltc_ecc_del_point(M[i]);
+       ltc_ecc_del_point(N[i]);
    }
+   XFREE(bits);
    return err;
 }
 
@@ -25,6 +25,27 @@
 
 #ifdef LTC_ECC_TIMING_RESISTANT
 
+/* the fixed window width; 16 precomputed multiples cost 14 point ops
+ * up front and drop the per-bit work from one add plus one double to
+ * a quarter add plus one double */
+#define WINSIZE 4
+
+/* the idx'th WINSIZE-bit digit of k, spanning digit boundaries */
+static ltc_mp_digit s_mul_digit(void *k, int idx)
+{
+   ltc_mp_digit d;
+   int bit, i;
+
+   d = 0;
+   for (i = WINSIZE - 1; i >= 0; i--) {
+      bit = WINSIZE * idx + i;
+      d <<= 1;
+      d |= (mp_get_digit(k, bit / (int)MP_DIGIT_BIT) >>
+            (bit % (int)MP_DIGIT_BIT)) & 1;
+   }
+   return d;
+}
+
 /**
    Perform a point multiplication  (timing resistant)
    @param k    The scalar to multiply by
@@ -36,108 +57,106 @@
 */
 int ltc_ecc_mulmod(void *k, ecc_point *G, ecc_point *R, void *modulus, int map)
 {
-   ecc_point *tG, *M[3];
-   int        i, j, err;
+   ecc_point *tG, *acc, *dst, *M[16];
+   int        i, j, w, err, wcount, started, cached;
    void       *mu, *mp;
-   ltc_mp_digit buf;
-   int        bitcnt, mode, digidx;
+   ltc_mp_digit d;
 
    LTC_ARGCHK(k       != NULL);
    LTC_ARGCHK(G       != NULL);
    LTC_ARGCHK(R       != NULL);
    LTC_ARGCHK(modulus != NULL);
 
-   /* init montgomery reduction */
-   if ((err = mp_montgomery_setup(modulus, &mp)) != CRYPT_OK) {
-      return err;
+#ifdef LTC_ECC_P256
+   /* the P-256 prime gets the dedicated fixed-limb backend, which is
+    * also timing resistant */
+   if (ltc_ecc_p256_accel_ok(k, G, modulus, map)) {
+      return ltc_ecc_p256_mulmod(k, G, R);
    }
-   if ((err = mp_init(&mu)) != CRYPT_OK) {
-      mp_montgomery_free(mp);
-      return err;
-   }
-   if ((err = mp_montgomery_normalization(mu, modulus)) != CRYPT_OK) {
-      mp_clear(mu);
-      mp_montgomery_free(mp);
+#endif
+
+   /* the montgomery constants, cached per curve */
+   if ((err = ltc_ecc_mont_get(modulus, &mp, &mu, &cached)) != CRYPT_OK) {
       return err;
    }
 
-   /* alloc ram for window temps */
-   for (i = 0; i < 3; i++) {
+   /* alloc ram for the window table; M[0] doubles as the scratch for
+    * the dummy operations */
+   for (i = 0; i < 16; i++) {
       M[i] = ltc_ecc_new_point();
       if (M[i] == NULL) {
          for (j = 0; j < i; j++) {
              ltc_ecc_del_point(M[j]);
          }
-         mp_clear(mu);
-         mp_montgomery_free(mp);
+         if (!cached) {
+            mp_clear(mu);
+            mp_montgomery_free(mp);
+         }
          return CRYPT_MEM;
       }
    }
+   acc = NULL;
 
    /* make a copy of G incase R==G */
-   tG = ltc_ecc_new_point();
-   if (tG == NULL)                                                                   { err = CRYPT_MEM; goto done; }
+   tG  = ltc_ecc_new_point();
+   acc = ltc_ecc_new_point();
+   if (tG == NULL || acc == NULL)                                                    { err = CRYPT_MEM; goto done; }
 
    /* tG = G  and convert to montgomery */
    if ((err = mp_mulmod(G->x, mu, modulus, tG->x)) != CRYPT_OK)                      { goto done; }
    if ((err = mp_mulmod(G->y, mu, modulus, tG->y)) != CRYPT_OK)                      { goto done; }
    if ((err = mp_mulmod(G->z, mu, modulus, tG->z)) != CRYPT_OK)                      { goto done; }
-   mp_clear(mu);
-   mu = NULL;
 
-   /* calc the M tab */
-   /* M[0] == G */
+   /* M[i] = iG for 1..15; M[0] starts as a copy of G so the dummy
+    * stream below always works on a valid point */
    if ((err = mp_copy(tG->x, M[0]->x)) != CRYPT_OK)                                  { goto done; }
    if ((err = mp_copy(tG->y, M[0]->y)) != CRYPT_OK)                                  { goto done; }
    if ((err = mp_copy(tG->z, M[0]->z)) != CRYPT_OK)                                  { goto done; }
-   /* M[1] == 2G */
-   if ((err = ltc_mp.ecc_ptdbl(tG, M[1], modulus, mp)) != CRYPT_OK)                  { goto done; }
-
-   /* setup sliding window */
-   mode   = 0;
-   bitcnt = 1;
-   buf    = 0;
-   digidx = mp_get_digit_count(k) - 1;
-
-   /* perform ops */
-   for (;;) {
-     /* grab next digit as required */
-      if (--bitcnt == 0) {
-         if (digidx == -1) {
-            break;
-         }
-         buf    = mp_get_digit(k, digidx);
-         bitcnt = (int) MP_DIGIT_BIT;
-         --digidx;
+   if ((err = mp_copy(tG->x, M[1]->x)) != CRYPT_OK)                                  { goto done; }
+   if ((err = mp_copy(tG->y, M[1]->y)) != CRYPT_OK)                                  { goto done; }
+   if ((err = mp_copy(tG->z, M[1]->z)) != CRYPT_OK)                                  { goto done; }
+   for (i = 2; i < 16; i++) {
+      if ((i & 1) == 0) {
+         if ((err = ltc_mp.ecc_ptdbl(M[i >> 1], M[i], modulus, mp)) != CRYPT_OK)     { goto done; }
+      } else {
+         if ((err = ltc_mp.ecc_ptadd(M[i - 1], M[1], M[i], modulus, mp)) != CRYPT_OK){ goto done; }
       }
+   }
 
-      /* grab the next msb from the ltiplicand */
-      i = (buf >> (MP_DIGIT_BIT - 1)) & 1;
-      buf <<= 1;
-
-      if (mode == 0 && i == 0) {
-         /* dummy operations */
-         if ((err = ltc_mp.ecc_ptadd(M[0], M[1], M[2], modulus, mp)) != CRYPT_OK)    { goto done; }
-         if ((err = ltc_mp.ecc_ptdbl(M[1], M[2], modulus, mp)) != CRYPT_OK)          { goto done; }
-         continue;
+   /* walk the scalar in fixed WINSIZE-bit windows from the top; the
+    * window count depends only on the digit count of k, as before.
+    * Every window runs WINSIZE doublings and exactly one addition;
+    * before the first nonzero digit both run against the M[0]
+    * scratch, after it a zero digit only redirects the addition
+    * there, so the operation stream does not depend on the digits.
+    * The table entry is picked by index; masked cache-line safe
+    * loads are not possible through the opaque bignum pointers here
+    * and live in the fixed-limb P-256 backend instead */
+   wcount  = (mp_get_digit_count(k) * (int)MP_DIGIT_BIT + WINSIZE - 1) / WINSIZE;
+   started = 0;
+   for (w = wcount - 1; w >= 0; w--) {
+      dst = started ? acc : M[0];
+      for (i = 0; i < WINSIZE; i++) {
+         if ((err = ltc_mp.ecc_ptdbl(dst, dst, modulus, mp)) != CRYPT_OK)            { goto done; }
       }
-
-      if (mode == 0 && i == 1) {
-         mode = 1;
-         /* dummy operations */
-         if ((err = ltc_mp.ecc_ptadd(M[0], M[1], M[2], modulus, mp)) != CRYPT_OK)    { goto done; }
-         if ((err = ltc_mp.ecc_ptdbl(M[1], M[2], modulus, mp)) != CRYPT_OK)          { goto done; }
-         continue;
+      d   = s_mul_digit(k, w);
+      dst = (started && d != 0) ? acc : M[0];
+      if ((err = ltc_mp.ecc_ptadd(dst, M[d + (d == 0)], dst, modulus, mp)) != CRYPT_OK) { goto done; }
+      if (!started && d != 0) {
+         /* first real digit: the accumulator becomes dG */
+         if ((err = mp_copy(M[d]->x, acc->x)) != CRYPT_OK)                           { goto done; }
+         if ((err = mp_copy(M[d]->y, acc->y)) != CRYPT_OK)                           { goto done; }
+         if ((err = mp_copy(M[d]->z, acc->z)) != CRYPT_OK)                           { goto done; }
+         started = 1;
       }
-
-      if ((err = ltc_mp.ecc_ptadd(M[0], M[1], M[i^1], modulus, mp)) != CRYPT_OK)     { goto done; }
-      if ((err = ltc_mp.ecc_ptdbl(M[i], M[i], modulus, mp)) != CRYPT_OK)             { goto done; }
    }
 
-   /* copy result out */
-   if ((err = mp_copy(M[0]->x, R->x)) != CRYPT_OK)                                   { goto done; }
-   if ((err = mp_copy(M[0]->y, R->y)) != CRYPT_OK)                                   { goto done; }
-   if ((err = mp_copy(M[0]->z, R->z)) != CRYPT_OK)                                   { goto done; }
+   /* copy result out; a zero scalar leaves the accumulator untouched
+    * and hands back the scratch, as the old ladder did */
+   dst = started ? acc : M[0];
+   if ((err = mp_copy(dst->x, R->x)) != CRYPT_OK)                                    { goto done; }
+   if ((err = mp_copy(dst->y, R->y)) != CRYPT_OK)                                    { goto done; }
+   if ((err = mp_copy(dst->z, R->z)) != CRYPT_OK)                                    { goto done; }
 
    /* map R back from projective space */
    if (map) {
@@ -146,17 +165,20 @@ int ltc_ecc_mulmod(void *k, ecc_point *G, ecc_point *R, void *modulus, int map)
       err = CRYPT_OK;
    }
 done:
-   if (mu != NULL) {
+   if (!cached) {
       mp_clear(mu);
+      mp_montgomery_free(mp);
    }
-   mp_montgomery_free(mp);
+   ltc_ecc_del_point(acc);
    ltc_ecc_del_point(tG);
-   for (i = 0; i < 3; i++) {
+   for (i = 0; i < 16; i++) {
        ltc_ecc_del_point(M[i]);
    }
    return err;
 }
 
+#undef WINSIZE
+
 #endif
 #endif
 /* $Source$ */
@@ -0,0 +1,468 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ltc_ecc_p256_mulmod.c
+  Constant-time point multiplication for the NIST P-256 prime,
+  Tom St Denis
+
+  The field is fixed at p = 2^256 - 2^224 + 2^192 + 2^96 - 1 held in
+  four 64-bit limbs, products run through 128-bit accumulators and a
+  word-wise Montgomery reduction (for this prime -1/p mod 2^64 is 1,
+  so the reduction needs no multiplier per round).  All temporaries
+  live on the stack and the scalar walk is fixed-window with masked
+  table selection, so the sequence of field operations does not
+  depend on the scalar.
+*/
+
+#ifdef LTC_ECC_P256
+
+typedef unsigned __int128 ulong128;
+
+/* the field prime, little-endian limbs */
+typedef ulong64 fe256[4];
+static const fe256 p256_p = {
+   CONST64(0xFFFFFFFFFFFFFFFF), CONST64(0x00000000FFFFFFFF),
+   CONST64(0x0000000000000000), CONST64(0xFFFFFFFF00000001)
+};
+
+/* all-ones when x == y, zero otherwise */
+static ulong64 s_ct_eq(ulong64 x, ulong64 y)
+{
+   ulong64 d = x ^ y;
+   return (ulong64)0 - (ulong64)(1 ^ ((d | ((ulong64)0 - d)) >> 63));
+}
+
+/* r = a when mask is all-ones, unchanged when zero */
+static void fe256_cmov(fe256 r, const fe256 a, ulong64 mask)
+{
+   int i;
+   for (i = 0; i < 4; i++) {
+      r[i] ^= mask & (r[i] ^ a[i]);
+   }
+}
+
+/* r = (a + b) mod p */
+static void fe256_add(fe256 r, const fe256 a, const fe256 b)
+{
+   fe256    s, d;
+   ulong128 t;
+   ulong64  c, bo, mask;
+   int      i;
+
+   t = 0;
+   for (i = 0; i < 4; i++) {
+      t += (ulong128)a[i] + b[i];
+      s[i] = (ulong64)t;
+      t >>= 64;
+   }
+   c = (ulong64)t;
+
+   t = 0;
+   for (i = 0; i < 4; i++) {
+      t = (ulong128)s[i] - p256_p[i] - t;
+      d[i] = (ulong64)t;
+      t = (t >> 64) & 1;
+   }
+   bo = (ulong64)t;
+
+   /* keep the difference when the sum overflowed or reached p */
+   mask = (ulong64)0 - (c | (bo ^ 1));
+   for (i = 0; i < 4; i++) {
+      r[i] = s[i] ^ (mask & (s[i] ^ d[i]));
+   }
+}
+
+/* r = (a - b) mod p */
+static void fe256_sub(fe256 r, const fe256 a, const fe256 b)
+{
+   fe256    d;
+   ulong128 t;
+   ulong64  bo, mask;
+   int      i;
+
+   t = 0;
+   for (i = 0; i < 4; i++) {
+      t = (ulong128)a[i] - b[i] - t;
+      d[i] = (ulong64)t;
+      t = (t >> 64) & 1;
+   }
+   bo = (ulong64)t;
+
+   /* add p back when we went below zero */
+   mask = (ulong64)0 - bo;
+   t = 0;
+   for (i = 0; i < 4; i++) {
+      t += (ulong128)d[i] + (mask & p256_p[i]);
+      r[i] = (ulong64)t;
+      t >>= 64;
+   }
+}
+
+/* r = a * b / 2^256 mod p (Montgomery product) */
+static void fe256_mul(fe256 r, const fe256 a, const fe256 b)
+{
+   ulong64  t[9], m, c, bo, mask;
+   fe256    d;
+   ulong128 uv;
+   int      i, j;
+
+   XMEMSET(t, 0, sizeof(t));
+   for (i = 0; i < 4; i++) {
+      c = 0;
+      for (j = 0; j < 4; j++) {
+         uv = (ulong128)a[i] * b[j] + t[i+j] + c;
+         t[i+j] = (ulong64)uv;
+         c      = (ulong64)(uv >> 64);
+      }
+      t[i+4] = c;
+   }
+
+   /* four rounds of word-wise reduction; the per-round multiplier is
+    * t[i] itself since -1/p mod 2^64 == 1 */
+   for (i = 0; i < 4; i++) {
+      m = t[i];
+      c = 0;
+      for (j = 0; j < 4; j++) {
+         uv = (ulong128)m * p256_p[j] + t[i+j] + c;
+         t[i+j] = (ulong64)uv;
+         c      = (ulong64)(uv >> 64);
+      }
+      for (j = i + 4; j <= 8; j++) {
+         uv = (ulong128)t[j] + c;
+         t[j] = (ulong64)uv;
+         c    = (ulong64)(uv >> 64);
+      }
+   }
+
+   /* result is t[4..8] < 2p; one masked subtraction brings it below p */
+   uv = 0;
+   for (i = 0; i < 4; i++) {
+      uv = (ulong128)t[i+4] - p256_p[i] - uv;
+      d[i] = (ulong64)uv;
+      uv = (uv >> 64) & 1;
+   }
+   bo = (ulong64)uv;
+   mask = (ulong64)0 - (t[8] | (bo ^ 1));
+   for (i = 0; i < 4; i++) {
+      r[i] = t[i+4] ^ (mask & (t[i+4] ^ d[i]));
+   }
+}
+
+/* r = 1/a mod p via a^(p-2); the exponent is public so plain
+ * square-and-multiply is fine */
+static void fe256_invert(fe256 r, const fe256 a, const fe256 one)
+{
+   fe256 e, s;
+   int   i;
+
+   XMEMCPY(e, p256_p, sizeof(e));
+   e[0] -= 2;
+
+   XMEMCPY(s, one, sizeof(s));
+   for (i = 255; i >= 0; i--) {
+      fe256_mul(s, s, s);
+      if ((e[i >> 6] >> (i & 63)) & 1) {
+         fe256_mul(s, s, a);
+      }
+   }
+   XMEMCPY(r, s, sizeof(s));
+}
+
+/* big-endian 32 octets <-> limbs */
+static void fe256_frombytes(fe256 r, const unsigned char *in)
+{
+   int i, j;
+   for (i = 0; i < 4; i++) {
+      r[i] = 0;
+      for (j = 0; j < 8; j++) {
+         r[i] = (r[i] << 8) | in[(3 - i) * 8 + j];
+      }
+   }
+}
+
+static void fe256_tobytes(unsigned char *out, const fe256 a)
+{
+   int i, j;
+   for (i = 0; i < 4; i++) {
+      for (j = 0; j < 8; j++) {
+         out[(3 - i) * 8 + j] = (unsigned char)(a[i] >> (8 * (7 - j)));
+      }
+   }
+}
+
+/* a point in Jacobian coordinates, Montgomery domain */
+typedef struct {
+   fe256 X, Y, Z;
+} p256_point;
+
+static void s_p256_cmov_point(p256_point *r, const p256_point *a, ulong64 mask)
+{
+   fe256_cmov(r->X, a->X, mask);
+   fe256_cmov(r->Y, a->Y, mask);
+   fe256_cmov(r->Z, a->Z, mask);
+}
+
+/* R = 2P (dbl-2001-b, a = -3); safe for P at infinity (Z stays 0) */
+static void s_p256_dbl(p256_point *R, const p256_point *P)
+{
+   fe256 delta, gamma, beta, alpha, t1, t2;
+
+   fe256_mul(delta, P->Z, P->Z);
+   fe256_mul(gamma, P->Y, P->Y);
+   fe256_mul(beta, P->X, gamma);
+   fe256_sub(t1, P->X, delta);
+   fe256_add(t2, P->X, delta);
+   fe256_mul(t1, t1, t2);
+   fe256_add(alpha, t1, t1);
+   fe256_add(alpha, alpha, t1);
+
+   fe256_add(t1, P->Y, P->Z);
+   fe256_mul(t1, t1, t1);
+   fe256_sub(t1, t1, gamma);
+   fe256_sub(R->Z, t1, delta);
+
+   fe256_mul(t1, alpha, alpha);
+   fe256_add(t2, beta, beta);
+   fe256_add(t2, t2, t2);
+   fe256_add(t2, t2, t2);
+   fe256_sub(R->X, t1, t2);
+
+   fe256_add(t1, beta, beta);
+   fe256_add(t1, t1, t1);
+   fe256_sub(t1, t1, R->X);
+   fe256_mul(t1, alpha, t1);
+   fe256_mul(t2, gamma, gamma);
+   fe256_add(t2, t2, t2);
+   fe256_add(t2, t2, t2);
+   fe256_add(t2, t2, t2);
+   fe256_sub(R->Y, t1, t2);
+}
+
+/* R = P + Q (add-2007-bl); neither input may be at infinity and
+ * P != +-Q, both arranged by the callers */
+static void s_p256_add(p256_point *R, const p256_point *P, const p256_point *Q)
+{
+   fe256 z1z1, z2z2, u1, u2, s1, s2, h, i, j, rr, v, t;
+
+   fe256_mul(z1z1, P->Z, P->Z);
+   fe256_mul(z2z2, Q->Z, Q->Z);
+   fe256_mul(u1, P->X, z2z2);
+   fe256_mul(u2, Q->X, z1z1);
+   fe256_mul(s1, P->Y, Q->Z);
+   fe256_mul(s1, s1, z2z2);
+   fe256_mul(s2, Q->Y, P->Z);
+   fe256_mul(s2, s2, z1z1);
+
+   fe256_sub(h, u2, u1);
+   fe256_add(i, h, h);
+   fe256_mul(i, i, i);
+   fe256_mul(j, h, i);
+   fe256_sub(rr, s2, s1);
+   fe256_add(rr, rr, rr);
+   fe256_mul(v, u1, i);
+
+   fe256_mul(t, rr, rr);
+   fe256_sub(t, t, j);
+   fe256_sub(t, t, v);
+   fe256_sub(R->X, t, v);
+
+   fe256_sub(t, v, R->X);
+   fe256_mul(t, rr, t);
+   fe256_mul(s1, s1, j);
+   fe256_add(s1, s1, s1);
+   fe256_sub(R->Y, t, s1);
+
+   fe256_add(t, P->Z, Q->Z);
+   fe256_mul(t, t, t);
+   fe256_sub(t, t, z1z1);
+   fe256_sub(t, t, z2z2);
+   fe256_mul(R->Z, t, h);
+}
+
+/**
+   Decide whether the dedicated P-256 path applies
+   @param k        The scalar to multiply by
+   @param G        The base point
+   @param modulus  The modulus of the field the ECC curve is in
+   @param map      Boolean whether to map back to affine
+   @return 1 if ltc_ecc_p256_mulmod() can serve this call, 0 otherwise
+*/
+int ltc_ecc_p256_accel_ok(void *k, ecc_point *G, void *modulus, int map)
+{
+   unsigned char buf[32], pb[32];
+   int           bits;
+
+   if (k == NULL || G == NULL || modulus == NULL || map != 1) {
+      return 0;
+   }
+   /* the scalar walk below wants an affine base and up to 256 bits */
+   if (mp_cmp_d(G->z, 1) != LTC_MP_EQ) {
+      return 0;
+   }
+   bits = mp_count_bits(k);
+   if (bits < 1 || bits > 256) {
+      return 0;
+   }
+   if (mp_unsigned_bin_size(modulus) != 32) {
+      return 0;
+   }
+   if (mp_to_unsigned_bin(modulus, buf) != CRYPT_OK) {
+      return 0;
+   }
+   fe256_tobytes(pb, p256_p);
+   return mem_neq(buf, pb, 32) == 0;
+}
+
+/* the scalar walk on raw 32-octet big-endian strings; returns
+ * CRYPT_INVALID_ARG when the result is the point at infinity */
+static int s_p256_scalarmult(unsigned char *rx, unsigned char *ry,
+                             const unsigned char *kb,
+                             const unsigned char *gx, const unsigned char *gy)
+{
+   p256_point tab[16], acc, sel, sum;
+   fe256      r2, one, zinv, z2, x, y;
+   ulong64    rinf, m_zero, m_first, d;
+   int        i, w;
+
+   /* derive 2^512 mod p by doubling; saves carrying a magic constant
+    * and costs nothing next to the ladder */
+   XMEMSET(r2, 0, sizeof(r2));
+   r2[0] = 1;
+   for (i = 0; i < 512; i++) {
+      fe256_add(r2, r2, r2);
+   }
+
+   /* tab[1] = G in the Montgomery domain */
+   fe256_frombytes(x, gx);
+   fe256_frombytes(y, gy);
+   fe256_mul(tab[1].X, x, r2);
+   fe256_mul(tab[1].Y, y, r2);
+   XMEMSET(one, 0, sizeof(one));
+   one[0] = 1;
+   fe256_mul(tab[1].Z, one, r2);   /* 1 in the Montgomery domain */
+
+   /* tab[i] = iG; even entries by doubling, odd by adding G */
+   for (i = 2; i < 16; i++) {
+      if ((i & 1) == 0) {
+         s_p256_dbl(&tab[i], &tab[i >> 1]);
+      } else {
+         s_p256_add(&tab[i], &tab[i - 1], &tab[1]);
+      }
+   }
+
+   /* fixed 4-bit windows, high to low; the accumulator starts at
+    * infinity which the add formula cannot represent, so carry a mask
+    * and substitute the table point on the first real digit.  For
+    * scalars below the group order the accumulator never meets +-sel
+    * in the additions (that would need a sub-scalar collision), which
+    * is the usual argument for incomplete Jacobian formulas here */
+   XMEMSET(&acc, 0, sizeof(acc));
+   rinf = (ulong64)0 - 1;
+   for (w = 0; w < 64; w++) {
+      if (w != 0) {
+         s_p256_dbl(&acc, &acc);
+         s_p256_dbl(&acc, &acc);
+         s_p256_dbl(&acc, &acc);
+         s_p256_dbl(&acc, &acc);
+      }
+      d = (kb[w >> 1] >> ((w & 1) ? 0 : 4)) & 15;
+
+      /* masked table scan; a zero digit leaves the dummy tab[1] */
+      XMEMCPY(&sel, &tab[1], sizeof(sel));
+      for (i = 2; i < 16; i++) {
+         s_p256_cmov_point(&sel, &tab[i], s_ct_eq(d, (ulong64)i));
+      }
+
+      s_p256_add(&sum, &acc, &sel);
+      m_zero  = s_ct_eq(d, 0);
+      m_first = rinf & ~m_zero;
+      s_p256_cmov_point(&acc, &sum, ~rinf & ~m_zero);
+      s_p256_cmov_point(&acc, &sel, m_first);
+      rinf &= m_zero;
+   }
+   if (rinf != 0) {
+      /* k was zero or a multiple of the group order; the generic
+       * path cannot map that either */
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* back to affine and out of the Montgomery domain; fe256_mul by
+    * the plain 1 divides by 2^256 */
+   fe256_invert(zinv, acc.Z, tab[1].Z);
+   fe256_mul(z2, zinv, zinv);
+   fe256_mul(x, acc.X, z2);
+   fe256_mul(x, x, one);
+   fe256_mul(z2, z2, zinv);
+   fe256_mul(y, acc.Y, z2);
+   fe256_mul(y, y, one);
+   fe256_tobytes(rx, x);
+   fe256_tobytes(ry, y);
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(&acc, sizeof(acc));
+   zeromem(&sel, sizeof(sel));
+   zeromem(&sum, sizeof(sum));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+   Perform a point multiplication over the P-256 prime (timing resistant)
+   @param k    The scalar to multiply by
+   @param G    The base point (affine, z == 1)
+   @param R    [out] Destination for kG, mapped to affine
+   @return CRYPT_OK on success
+*/
+int ltc_ecc_p256_mulmod(void *k, ecc_point *G, ecc_point *R)
+{
+   unsigned char kb[32], gx[32], gy[32];
+   unsigned long size;
+   int           err;
+
+   LTC_ARGCHK(k != NULL);
+   LTC_ARGCHK(G != NULL);
+   LTC_ARGCHK(R != NULL);
+
+   /* left pad the operands to 32 octets */
+   size = mp_unsigned_bin_size(G->x);
+   if (size > 32) return CRYPT_INVALID_ARG;
+   zeromem(gx, sizeof(gx));
+   if ((err = mp_to_unsigned_bin(G->x, gx + 32 - size)) != CRYPT_OK) return err;
+   size = mp_unsigned_bin_size(G->y);
+   if (size > 32) return CRYPT_INVALID_ARG;
+   zeromem(gy, sizeof(gy));
+   if ((err = mp_to_unsigned_bin(G->y, gy + 32 - size)) != CRYPT_OK) return err;
+   size = mp_unsigned_bin_size(k);
+   if (size > 32) return CRYPT_INVALID_ARG;
+   zeromem(kb, sizeof(kb));
+   if ((err = mp_to_unsigned_bin(k, kb + 32 - size)) != CRYPT_OK) return err;
+
+   if ((err = s_p256_scalarmult(gx, gy, kb, gx, gy)) != CRYPT_OK) {
+      return err;
+   }
+
+   if ((err = mp_read_unsigned_bin(R->x, gx, 32)) != CRYPT_OK)    { return err; }
+   if ((err = mp_read_unsigned_bin(R->y, gy, 32)) != CRYPT_OK)    { return err; }
+   if ((err = mp_set(R->z, 1)) != CRYPT_OK)                       { return err; }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(kb, sizeof(kb));
+#endif
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
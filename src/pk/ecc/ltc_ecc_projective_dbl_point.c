@@ -41,7 +41,7 @@ int ltc_ecc_projective_dbl_point(ecc_point *P, ecc_point *R, void *modulus, void
    LTC_ARGCHK(modulus != NULL);
    LTC_ARGCHK(mp      != NULL);
 
-   if ((err = mp_init_multi(&t1, &t2, NULL)) != CRYPT_OK) {
+   if ((err = ltc_mp_pool_get_multi(&t1, &t2, NULL)) != CRYPT_OK) {
       return err;
    }
 
@@ -137,7 +137,7 @@ int ltc_ecc_projective_dbl_point(ecc_point *P, ecc_point *R, void *modulus, void
 
    err = CRYPT_OK;
 done:
-   mp_clear_multi(t1, t2, NULL);
+   ltc_mp_pool_put_multi(t1, t2, NULL);
    return err;
 }
 #endif
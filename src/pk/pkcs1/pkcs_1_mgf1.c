@@ -33,8 +33,8 @@ int pkcs_1_mgf1(int                  hash_idx,
    unsigned long hLen, x;
    ulong32       counter;
    int           err;
-   hash_state    *md;
-   unsigned char *buf;
+   hash_state    md, mdseed;
+   unsigned char buf[MAXBLOCKSIZE], cnt[4];
 
    LTC_ARGCHK(seed != NULL);
    LTC_ARGCHK(mask != NULL);
@@ -47,17 +47,14 @@ int pkcs_1_mgf1(int                  hash_idx,
    /* get hash output size */
    hLen = hash_descriptor[hash_idx].hashsize;
 
-   /* allocate memory */
-   md  = XMALLOC(sizeof(hash_state));
-   buf = XMALLOC(hLen);
-   if (md == NULL || buf == NULL) {
-      if (md != NULL) {
-         XFREE(md);
-      }
-      if (buf != NULL) {
-         XFREE(buf);
-      }
-      return CRYPT_MEM;
+   /* every mask block hashes seed || counter; absorb the common seed
+    * prefix once and restart each block from that midstate instead of
+    * re-running init/process over the seed */
+   if ((err = hash_descriptor[hash_idx].init(&mdseed)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = hash_descriptor[hash_idx].process(&mdseed, seed, seedlen)) != CRYPT_OK) {
+      goto LBL_ERR;
    }
 
    /* start counter */
@@ -65,20 +62,15 @@ int pkcs_1_mgf1(int                  hash_idx,
 
    while (masklen > 0) {
        /* handle counter */
-       STORE32H(counter, buf);
+       STORE32H(counter, cnt);
        ++counter;
 
-       /* get hash of seed || counter */
-       if ((err = hash_descriptor[hash_idx].init(md)) != CRYPT_OK) {
-          goto LBL_ERR;
-       }
-       if ((err = hash_descriptor[hash_idx].process(md, seed, seedlen)) != CRYPT_OK) {
+       /* get hash of seed || counter off the seed midstate */
+       XMEMCPY(&md, &mdseed, sizeof(md));
+       if ((err = hash_descriptor[hash_idx].process(&md, cnt, 4)) != CRYPT_OK) {
           goto LBL_ERR;
        }
-       if ((err = hash_descriptor[hash_idx].process(md, buf, 4)) != CRYPT_OK) {
-          goto LBL_ERR;
-       }
-       if ((err = hash_descriptor[hash_idx].done(md, buf)) != CRYPT_OK) {
+       if ((err = hash_descriptor[hash_idx].done(&md, buf)) != CRYPT_OK) {
           goto LBL_ERR;
        }
 
@@ -91,13 +83,11 @@ int pkcs_1_mgf1(int                  hash_idx,
    err = CRYPT_OK;
 LBL_ERR:
 #ifdef LTC_CLEAN_STACK
-   zeromem(buf, hLen);
-   zeromem(md,  sizeof(hash_state));
+   zeromem(buf,     sizeof(buf));
+   zeromem(&md,     sizeof(md));
+   zeromem(&mdseed, sizeof(mdseed));
 #endif
 
-   XFREE(buf);
-   XFREE(md);
-
    return err;
 }
 
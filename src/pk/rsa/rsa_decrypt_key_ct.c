@@ -0,0 +1,147 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file rsa_decrypt_key_ct.c
+  RSA PKCS #1 v1.5 decryption with constant-time depad, Tom St Denis
+
+  rsa_decrypt_key_ex() runs the exponentiation and pkcs_1_v1_5_decode()
+  as separate passes through a heap temp, and the depad loop exits as
+  soon as it spots the separator - both the allocation and the
+  data-dependent exit are costly at key-unwrap rates, and the latter is
+  exactly the oracle Bleichenbacher-style attacks feed on.  The fused
+  path here exponentiates into caller-provided scratch and unpads with
+  masked loads over the whole block: every octet of the scratch buffer
+  is touched the same number of times whether the padding is good or
+  not, and the only data-dependent values left are *outlen and *stat,
+  which the caller inspects anyway.
+*/
+
+#ifdef LTC_MRSA
+
+/* all-ones when x == 0, else all-zeros; operands stay below 2^31 so
+ * the sign trick in the comparisons below is safe */
+static ulong32 s_eq_zero_m(ulong32 x)
+{
+   return ~((ulong32)0 - ((x | ((ulong32)0 - x)) >> 31));
+}
+
+/* all-ones when a == b, else all-zeros */
+static ulong32 s_eq_m(ulong32 a, ulong32 b)
+{
+   return s_eq_zero_m(a ^ b);
+}
+
+/* all-ones when a < b, else all-zeros */
+static ulong32 s_lt_m(ulong32 a, ulong32 b)
+{
+   return (ulong32)0 - ((a - b) >> 31);
+}
+
+/**
+   PKCS #1 v1.5 decrypt with branchless depad and no heap traffic
+   @param in          The ciphertext
+   @param inlen       The length of the ciphertext (octets)
+   @param out         [out] The plaintext; must not alias scratch
+   @param outlen      [in/out] The max size and resulting size of the plaintext;
+                      must admit modulus_size - 11 octets going in
+   @param scratch     Caller-provided working storage, wiped before return
+   @param scratchlen  Size of scratch (octets); at least the modulus size
+   @param stat        [out] Result of the decryption, 1==valid, 0==invalid
+   @param key         The corresponding private RSA key
+   @return CRYPT_OK if succcessful (even if invalid)
+*/
+int rsa_decrypt_key_ct(const unsigned char *in,      unsigned long  inlen,
+                             unsigned char *out,     unsigned long *outlen,
+                             unsigned char *scratch, unsigned long  scratchlen,
+                             int           *stat,    rsa_key       *key)
+{
+  unsigned long modulus_bytelen, maxmsg, msglen, i, j, src;
+  ulong32       valid, found, idx, z, sel, keep;
+  unsigned char acc;
+  int           err;
+
+  LTC_ARGCHK(in      != NULL);
+  LTC_ARGCHK(out     != NULL);
+  LTC_ARGCHK(outlen  != NULL);
+  LTC_ARGCHK(scratch != NULL);
+  LTC_ARGCHK(stat    != NULL);
+  LTC_ARGCHK(key     != NULL);
+
+  /* default to invalid */
+  *stat = 0;
+
+  /* the public sizes are checked up front; none of them is secret */
+  modulus_bytelen = mp_unsigned_bin_size( (key->N));
+  if (modulus_bytelen < 11 || modulus_bytelen != inlen) {
+     return CRYPT_INVALID_PACKET;
+  }
+  if (scratchlen < modulus_bytelen) {
+     return CRYPT_BUFFER_OVERFLOW;
+  }
+  maxmsg = modulus_bytelen - 11;
+  if (*outlen < maxmsg) {
+     *outlen = maxmsg;
+     return CRYPT_BUFFER_OVERFLOW;
+  }
+
+  /* rsa decode the packet straight into the scratch block; the result
+   * is left-padded to exactly modulus_bytelen octets */
+  i = scratchlen;
+  if ((err = ltc_mp.rsa_me(in, inlen, scratch, &i, PK_PRIVATE, key)) != CRYPT_OK) {
+     return err;
+  }
+
+  /* scan for the separator without leaving the loop: remember the
+   * first zero octet and keep walking regardless */
+  valid = s_eq_m(scratch[0], 0x00) & s_eq_m(scratch[1], 0x02);
+  found = 0;
+  idx   = 0;
+  for (i = 2; i < modulus_bytelen; i++) {
+     z      = s_eq_zero_m(scratch[i]);
+     sel    = z & ~found;
+     idx    = (idx & ~sel) | ((ulong32)i & sel);
+     found |= z;
+  }
+  /* a separator must exist and leave at least 8 octets of PS */
+  valid &= found;
+  valid &= ~s_lt_m(idx, 10);
+
+  /* message length; forced to zero when the padding is bad so the
+   * masked copy below emits only zeros */
+  msglen = (modulus_bytelen - idx - 1) & valid;
+
+  /* masked gather: every output octet is built by sweeping the whole
+   * padded block, so neither the separator position nor the validity
+   * steers a load or a store */
+  for (j = 0; j < maxmsg; j++) {
+     acc = 0;
+     src = idx + 1 + j;
+     for (i = 2; i < modulus_bytelen; i++) {
+        acc |= scratch[i] & (unsigned char)s_eq_m((ulong32)i, (ulong32)src);
+     }
+     keep   = s_lt_m((ulong32)j, (ulong32)msglen);
+     out[j] = acc & (unsigned char)keep;
+  }
+
+  *outlen = msglen;
+  *stat   = (int)(valid & 1);
+
+  zeromem(scratch, modulus_bytelen);
+  return CRYPT_OK;
+}
+
+#endif /* LTC_MRSA */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
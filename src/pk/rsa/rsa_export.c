@@ -58,6 +58,26 @@ int rsa_export(unsigned char *out, unsigned long *outlen, int type, rsa_key *key
       /* public key */
       unsigned long tmplen, *ptmplen;
       unsigned char* tmp = NULL;
+      unsigned char **cache;
+      unsigned long  *cachelen;
+
+      /* served from the cached encoding? */
+      if (type & PK_STD) {
+         cache    = &key->pub_der_std;
+         cachelen = &key->pub_der_std_len;
+      } else {
+         cache    = &key->pub_der;
+         cachelen = &key->pub_der_len;
+      }
+      if (*cache != NULL) {
+         if (*outlen < *cachelen) {
+            *outlen = *cachelen;
+            return CRYPT_BUFFER_OVERFLOW;
+         }
+         XMEMCPY(out, *cache, *cachelen);
+         *outlen = *cachelen;
+         return CRYPT_OK;
+      }
 
       if (type & PK_STD) {
           tmplen = (mp_count_bits(key->N)/8)*2+8;
@@ -87,6 +107,16 @@ int rsa_export(unsigned char *out, unsigned long *outlen, int type, rsa_key *key
 finish:
       if (tmp != out)
         XFREE(tmp);
+
+      /* stash the encoding for the next export; running out of heap
+       * just means the next call encodes again */
+      if (err == CRYPT_OK) {
+         *cache = XMALLOC(*outlen);
+         if (*cache != NULL) {
+            XMEMCPY(*cache, out, *outlen);
+            *cachelen = *outlen;
+         }
+      }
       return err;
 
    }
@@ -19,6 +19,37 @@
 
 #ifdef LTC_MRSA
 
+#ifdef LTC_RSA_BLINDING
+/* guards the blinding pair cached inside a (possibly shared) rsa_key;
+ * without LTC_PTHREAD this compiles away like every other LTC_MUTEX_*
+ * user and the caller owns thread safety */
+LTC_MUTEX_GLOBAL(ltc_rsa_blind_mutex)
+#endif
+
+#if defined(LTC_PTHREAD) && defined(LTC_RSA_CRT_CONCURRENT)
+
+/* one half of a CRT private operation; the struct carries the operands
+ * so a worker thread can run it via pthread_create */
+struct rsa_crt_half {
+   void *g, *x, *p, *mont, *R, *res;
+   int   err;
+};
+
+static void *_rsa_crt_half(void *arg)
+{
+   struct rsa_crt_half *h = arg;
+   if (ltc_mp.exptmod_ct != NULL) {
+      h->err = ltc_mp.exptmod_ct(h->g, h->x, h->p, h->res);
+   } else if (h->mont != NULL) {
+      h->err = ltc_mp_exptmod_mont(h->g, h->x, h->p, h->mont, h->R, h->res);
+   } else {
+      h->err = mp_exptmod(h->g, h->x, h->p, h->res);
+   }
+   return NULL;
+}
+
+#endif /* LTC_PTHREAD && LTC_RSA_CRT_CONCURRENT */
+
 /**
    Compute an RSA modular exponentiation
    @param in         The input data to send into RSA
@@ -55,8 +86,8 @@ int rsa_exptmod(const unsigned char *in,   unsigned long inlen,
       return CRYPT_PK_INVALID_TYPE;
    }
 
-   /* init and copy into tmp */
-   if ((err = mp_init_multi(&tmp, &tmpa, &tmpb,
+   /* grab temps from the pool and copy into tmp */
+   if ((err = ltc_mp_pool_get_multi(&tmp, &tmpa, &tmpb,
 #ifdef LTC_RSA_BLINDING
                                                &rnd, &rndi,
 #endif /* LTC_RSA_BLINDING */
@@ -75,25 +106,53 @@ int rsa_exptmod(const unsigned char *in,   unsigned long inlen,
    /* are we using the private exponent and is the key optimized? */
    if (which == PK_PRIVATE) {
       #ifdef LTC_RSA_BLINDING
-      /* do blinding */
-      err = mp_rand(rnd, mp_get_digit_count(key->N));
-      if (err != CRYPT_OK) {
-             goto error;
-      }
+      /* do blinding; the cached pair is shared by every user of the
+       * key, so hold the mutex from the NULL test to the last touch
+       * of key->Vf/Vi */
+      LTC_MUTEX_LOCK(&ltc_rsa_blind_mutex);
+      if (key->Vf != NULL && key->Vi != NULL) {
+         /* refresh the cached pair by squaring; (Vf, Vi) stays a valid
+          * (r^e, 1/r) pair for r squared */
+         if ((err = mp_mulmod(key->Vf, key->Vf, key->N, key->Vf)) != CRYPT_OK) { goto blind_done; }
+         if ((err = mp_mulmod(key->Vi, key->Vi, key->N, key->Vi)) != CRYPT_OK) { goto blind_done; }
+         if ((err = mp_copy(key->Vf, rnd))  != CRYPT_OK)                       { goto blind_done; }
+         if ((err = mp_copy(key->Vi, rndi)) != CRYPT_OK)                       { goto blind_done; }
+      } else {
+         err = mp_rand(rnd, mp_get_digit_count(key->N));
+         if (err != CRYPT_OK) {
+                goto blind_done;
+         }
 
-      /* rndi = 1/rnd mod N */
-      err = mp_invmod(rnd, key->N, rndi);
-      if (err != CRYPT_OK) {
-             goto error;
-      }
+         /* rndi = 1/rnd mod N */
+         err = mp_invmod(rnd, key->N, rndi);
+         if (err != CRYPT_OK) {
+                goto blind_done;
+         }
+
+         /* rnd = rnd^e */
+         err = mp_exptmod( rnd, key->e, key->N, rnd);
+         if (err != CRYPT_OK) {
+                goto blind_done;
+         }
 
-      /* rnd = rnd^e */
-      err = mp_exptmod( rnd, key->e, key->N, rnd);
+         /* seed the cached pair; on failure stay with per-call blinding */
+         if (mp_init_multi(&key->Vf, &key->Vi, NULL) == CRYPT_OK) {
+            if (mp_copy(rnd,  key->Vf) != CRYPT_OK ||
+                mp_copy(rndi, key->Vi) != CRYPT_OK) {
+               mp_clear_multi(key->Vf, key->Vi, NULL);
+               key->Vf = key->Vi = NULL;
+            }
+         } else {
+            key->Vf = key->Vi = NULL;
+         }
+      }
+blind_done:
+      LTC_MUTEX_UNLOCK(&ltc_rsa_blind_mutex);
       if (err != CRYPT_OK) {
              goto error;
       }
 
-      /* tmp = tmp*rnd mod N */
+      /* tmp = tmp*rnd mod N; rnd is this call's private copy */
       err = mp_mulmod( tmp, rnd, key->N, tmp);
       if (err != CRYPT_OK) {
              goto error;
@@ -109,13 +168,59 @@ int rsa_exptmod(const unsigned char *in,   unsigned long inlen,
           * In case CRT optimization parameters are not provided,
           * the private key is directly used to exptmod it
           */
-         if ((err = mp_exptmod(tmp, key->d, key->N, tmp)) != CRYPT_OK)                              { goto error; }
+         if (ltc_mp.exptmod_ct != NULL) {
+            if ((err = ltc_mp.exptmod_ct(tmp, key->d, key->N, tmp)) != CRYPT_OK)                    { goto error; }
+         } else if (key->mont_N != NULL) {
+            if ((err = ltc_mp_exptmod_mont(tmp, key->d, key->N, key->mont_N, key->R_N, tmp)) != CRYPT_OK)   { goto error; }
+         } else {
+            if ((err = mp_exptmod(tmp, key->d, key->N, tmp)) != CRYPT_OK)                           { goto error; }
+         }
       } else {
-         /* tmpa = tmp^dP mod p */
-         if ((err = mp_exptmod(tmp, key->dP, key->p, tmpa)) != CRYPT_OK)                            { goto error; }
+#if defined(LTC_PTHREAD) && defined(LTC_RSA_CRT_CONCURRENT)
+         /* run the q half on a worker thread while this thread does the
+          * p half; the two exponentiations only read shared state, but
+          * the math provider must be thread-safe */
+         struct rsa_crt_half hp, hq;
+         pthread_t           tid;
+         int                 spawned;
+
+         hp.g = tmp; hp.x = key->dP; hp.p = key->p;
+         hp.mont = key->mont_p; hp.R = key->R_p; hp.res = tmpa;
+         hq.g = tmp; hq.x = key->dQ; hq.p = key->q;
+         hq.mont = key->mont_q; hq.R = key->R_q; hq.res = tmpb;
+
+         spawned = (pthread_create(&tid, NULL, _rsa_crt_half, &hq) == 0);
+         if (!spawned) {
+            /* no worker available, run both halves here */
+            _rsa_crt_half(&hq);
+         }
+         _rsa_crt_half(&hp);
+         if (spawned) {
+            pthread_join(tid, NULL);
+         }
+         if (hp.err != CRYPT_OK) { err = hp.err; goto error; }
+         if (hq.err != CRYPT_OK) { err = hq.err; goto error; }
+#else
+         /* tmpa = tmp^dP mod p, timing resistant when the descriptor
+          * has the hook, else through the cached Montgomery context
+          * when rsa_mont_setup filled one in */
+         if (ltc_mp.exptmod_ct != NULL) {
+            if ((err = ltc_mp.exptmod_ct(tmp, key->dP, key->p, tmpa)) != CRYPT_OK)                  { goto error; }
+         } else if (key->mont_p != NULL) {
+            if ((err = ltc_mp_exptmod_mont(tmp, key->dP, key->p, key->mont_p, key->R_p, tmpa)) != CRYPT_OK) { goto error; }
+         } else {
+            if ((err = mp_exptmod(tmp, key->dP, key->p, tmpa)) != CRYPT_OK)                         { goto error; }
+         }
 
          /* tmpb = tmp^dQ mod q */
-         if ((err = mp_exptmod(tmp, key->dQ, key->q, tmpb)) != CRYPT_OK)                            { goto error; }
+         if (ltc_mp.exptmod_ct != NULL) {
+            if ((err = ltc_mp.exptmod_ct(tmp, key->dQ, key->q, tmpb)) != CRYPT_OK)                  { goto error; }
+         } else if (key->mont_q != NULL) {
+            if ((err = ltc_mp_exptmod_mont(tmp, key->dQ, key->q, key->mont_q, key->R_q, tmpb)) != CRYPT_OK) { goto error; }
+         } else {
+            if ((err = mp_exptmod(tmp, key->dQ, key->q, tmpb)) != CRYPT_OK)                         { goto error; }
+         }
+#endif /* LTC_PTHREAD && LTC_RSA_CRT_CONCURRENT */
 
          /* tmp = (tmpa - tmpb) * qInv (mod p) */
          if ((err = mp_sub(tmpa, tmpb, tmp)) != CRYPT_OK)                                           { goto error; }
@@ -168,7 +273,7 @@ int rsa_exptmod(const unsigned char *in,   unsigned long inlen,
    /* clean up and return */
    err = CRYPT_OK;
 error:
-   mp_clear_multi(
+   ltc_mp_pool_put_multi(
 #ifdef LTC_RSA_BLINDING
                   rndi, rnd,
 #endif /* LTC_RSA_BLINDING */
@@ -24,6 +24,11 @@
 void rsa_free(rsa_key *key)
 {
    LTC_ARGCHKVD(key != NULL);
+   rsa_mont_free(key);
+   if (key->pub_der     != NULL) { XFREE(key->pub_der);     key->pub_der     = NULL; }
+   if (key->pub_der_std != NULL) { XFREE(key->pub_der_std); key->pub_der_std = NULL; }
+   if (key->Vf != NULL) { mp_clear(key->Vf); key->Vf = NULL; }
+   if (key->Vi != NULL) { mp_clear(key->Vi); key->Vi = NULL; }
    mp_clear_multi(key->q, key->p, key->qP, key->dP, key->dQ, key->N, key->d, key->e, NULL);
 }
 
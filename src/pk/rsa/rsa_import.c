@@ -40,6 +40,11 @@ int rsa_import(const unsigned char *in, unsigned long inlen, rsa_key *key)
                             &key->dP, &key->qP, &key->p, &key->q, NULL)) != CRYPT_OK) {
       return err;
    }
+   key->mont_p = key->mont_q = key->mont_N = NULL;
+   key->pub_der = key->pub_der_std = NULL;
+   key->pub_der_len = key->pub_der_std_len = 0;
+   key->R_p    = key->R_q    = key->R_N    = NULL;
+   key->Vf     = key->Vi     = NULL;
 
    /* see if the OpenSSL DER format RSA public key will work */
    tmpbuf_len = MAX_RSA_SIZE * 8;
@@ -63,8 +68,7 @@ int rsa_import(const unsigned char *in, unsigned long inlen, rsa_key *key)
          goto LBL_ERR;
       }
       key->type = PK_PUBLIC;
-      err = CRYPT_OK;
-      goto LBL_FREE;
+      goto LBL_MONT;
    }
 
    /* not SSL public key, try to match against PKCS #1 standards */
@@ -109,7 +113,12 @@ int rsa_import(const unsigned char *in, unsigned long inlen, rsa_key *key)
       }
       key->type = PK_PUBLIC;
    }
-   err = CRYPT_OK;
+
+LBL_MONT:
+   /* cache the Montgomery contexts for the moduli we now hold */
+   if ((err = rsa_mont_setup(key)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
    goto LBL_FREE;
 
 LBL_ERR:
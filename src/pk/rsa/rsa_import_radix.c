@@ -38,6 +38,11 @@ int rsa_import_radix(int radix, char *N, char *e, char *d, char *p, char *q, cha
 
    err = mp_init_multi(&key->e, &key->d, &key->N, &key->dQ, &key->dP, &key->qP, &key->p, &key->q, NULL);
    if (err != CRYPT_OK) return err;
+   key->mont_p = key->mont_q = key->mont_N = NULL;
+   key->pub_der = key->pub_der_std = NULL;
+   key->pub_der_len = key->pub_der_std_len = 0;
+   key->R_p    = key->R_q    = key->R_N    = NULL;
+   key->Vf     = key->Vi     = NULL;
 
    if ((err = mp_read_radix(key->N , N , radix)) != CRYPT_OK)    { goto LBL_ERR; }
    if ((err = mp_read_radix(key->e , e , radix)) != CRYPT_OK)    { goto LBL_ERR; }
@@ -54,6 +59,7 @@ int rsa_import_radix(int radix, char *N, char *e, char *d, char *p, char *q, cha
    else {
       key->type = PK_PUBLIC;
    }
+   if ((err = rsa_mont_setup(key)) != CRYPT_OK)                  { goto LBL_ERR; }
    return CRYPT_OK;
 
 LBL_ERR:
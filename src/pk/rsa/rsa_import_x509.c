@@ -17,6 +17,88 @@
 
 #ifdef LTC_MRSA
 
+/* rsaEncryption 1.2.840.113549.1.1.1 as encoded OID content */
+static const unsigned char rsa_oid_der[] = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x01 };
+
+/* parse one TLV header; *hdrlen is the header size, *len the content size */
+static int der_peek_header(const unsigned char *in, unsigned long inlen,
+                           unsigned long *tag, unsigned long *hdrlen, unsigned long *len)
+{
+   unsigned long x, y, z;
+
+   if (inlen < 2) {
+      return CRYPT_INVALID_PACKET;
+   }
+   *tag = in[0];
+   x = in[1];
+   y = 2;
+   if (x < 128) {
+      z = x;
+   } else {
+      x &= 0x7F;
+      if (x == 0 || x > 4 || 2 + x > inlen) {
+         return CRYPT_INVALID_PACKET;
+      }
+      z = 0;
+      while (x--) {
+         z = (z << 8) | ((unsigned long)in[y]);
+         ++y;
+      }
+   }
+   if (z > inlen - y) {
+      return CRYPT_INVALID_PACKET;
+   }
+   *hdrlen = y;
+   *len    = z;
+   return CRYPT_OK;
+}
+
+/* skip-scan the certificate for the SubjectPublicKeyInfo of an RSA key:
+ * walk the headers of the tbsCertificate elements, skipping every
+ * subtree by its encoded length, until a SEQUENCE starting with
+ * SEQUENCE { OID rsaEncryption ... } is found; nothing else is decoded
+ * or allocated */
+static int find_rsa_spki(const unsigned char *in, unsigned long inlen,
+                         const unsigned char **spki, unsigned long *spkilen)
+{
+   unsigned long tag, hl, len;
+   const unsigned char *p, *end;
+   int err;
+
+   /* Certificate ::= SEQUENCE { tbsCertificate, ... } */
+   if ((err = der_peek_header(in, inlen, &tag, &hl, &len)) != CRYPT_OK)   { return err; }
+   if (tag != 0x30)                                                       { return CRYPT_INVALID_PACKET; }
+   p     = in + hl;
+   inlen = len;
+
+   /* tbsCertificate ::= SEQUENCE { ... } */
+   if ((err = der_peek_header(p, inlen, &tag, &hl, &len)) != CRYPT_OK)    { return err; }
+   if (tag != 0x30)                                                       { return CRYPT_INVALID_PACKET; }
+   end = p + hl + len;
+   p  += hl;
+
+   while (p < end) {
+      if ((err = der_peek_header(p, (unsigned long)(end - p), &tag, &hl, &len)) != CRYPT_OK) {
+         return err;
+      }
+      if (tag == 0x30) {
+         /* candidate: first child SEQUENCE { OID rsaEncryption ... } */
+         unsigned long t2, h2, l2, t3, h3, l3;
+         const unsigned char *q = p + hl;
+         if (der_peek_header(q, len, &t2, &h2, &l2) == CRYPT_OK && t2 == 0x30 &&
+             der_peek_header(q + h2, l2, &t3, &h3, &l3) == CRYPT_OK && t3 == 0x06 &&
+             l3 == sizeof(rsa_oid_der) && XMEMCMP(q + h2 + h3, rsa_oid_der, l3) == 0) {
+            *spki    = p;
+            *spkilen = hl + len;
+            return CRYPT_OK;
+         }
+      }
+      /* skip this element wholesale */
+      p += hl + len;
+   }
+   return CRYPT_ERROR;
+}
+
 /**
   Import an RSA key from a X.509 certificate
   @param in      The packet to import from
@@ -28,8 +110,9 @@ int rsa_import_x509(const unsigned char *in, unsigned long inlen, rsa_key *key)
 {
    int           err;
    unsigned char *tmpbuf=NULL;
-   unsigned long tmpbuf_len, tmp_inlen;
-   ltc_asn1_list *decoded_list = NULL, *l;
+   unsigned long tmpbuf_len, spkilen;
+   const unsigned char *spki;
+   ltc_asn1_list ne[2];
 
    LTC_ARGCHK(in          != NULL);
    LTC_ARGCHK(key         != NULL);
@@ -40,6 +123,11 @@ int rsa_import_x509(const unsigned char *in, unsigned long inlen, rsa_key *key)
                             &key->dP, &key->qP, &key->p, &key->q, NULL)) != CRYPT_OK) {
       return err;
    }
+   key->mont_p = key->mont_q = key->mont_N = NULL;
+   key->pub_der = key->pub_der_std = NULL;
+   key->pub_der_len = key->pub_der_std_len = 0;
+   key->R_p    = key->R_q    = key->R_N    = NULL;
+   key->Vf     = key->Vi     = NULL;
 
    tmpbuf_len = MAX_RSA_SIZE * 8;
    tmpbuf = XCALLOC(1, tmpbuf_len);
@@ -48,65 +136,33 @@ int rsa_import_x509(const unsigned char *in, unsigned long inlen, rsa_key *key)
        goto LBL_ERR;
    }
 
-   tmp_inlen = inlen;
-   if ((err = der_decode_sequence_flexi(in, &tmp_inlen, &decoded_list)) == CRYPT_OK) {
-      l = decoded_list;
-      /* Move 2 levels up in the tree
-         SEQUENCE
-             SEQUENCE
-                 ...
-       */
-      if (l->type == LTC_ASN1_SEQUENCE && l->child) {
-         l = l->child;
-         if (l->type == LTC_ASN1_SEQUENCE && l->child) {
-            l = l->child;
-
-            err = CRYPT_ERROR;
-
-            /* Move forward in the tree until we find this combination
-                 ...
-                 SEQUENCE
-                     SEQUENCE
-                         OBJECT IDENTIFIER 1.2.840.113549.1.1.1
-                         NULL
-                     BIT STRING
-             */
-            do {
-               /* The additional check for l->data is there to make sure
-                * we won't try to decode a list that has been 'shrunk'
-                */
-               if (l->type == LTC_ASN1_SEQUENCE && l->data && l->child &&
-                     l->child->type == LTC_ASN1_SEQUENCE && l->child->child &&
-                     l->child->child->type == LTC_ASN1_OBJECT_IDENTIFIER && l->child->next &&
-                     l->child->next->type == LTC_ASN1_BIT_STRING) {
-                  err = der_decode_subject_public_key_info(l->data, l->size,
-                       PKA_RSA, tmpbuf, &tmpbuf_len,
-                       LTC_ASN1_NULL, NULL, 0);
-                  if (err == CRYPT_OK) {
-                     /* now it should be SEQUENCE { INTEGER, INTEGER } */
-                     if ((err = der_decode_sequence_multi(tmpbuf, tmpbuf_len,
-                                                          LTC_ASN1_INTEGER, 1UL, key->N,
-                                                          LTC_ASN1_INTEGER, 1UL, key->e,
-                                                          LTC_ASN1_EOL,     0UL, NULL)) != CRYPT_OK) {
-                        goto LBL_ERR;
-                     }
-                     key->type = PK_PUBLIC;
-                     err = CRYPT_OK;
-                     goto LBL_FREE;
-                  }
-               }
-               l = l->next;
-            } while(l);
-         }
-      }
+   /* header walk straight to the SubjectPublicKeyInfo, no tree */
+   if ((err = find_rsa_spki(in, inlen, &spki, &spkilen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   if ((err = der_decode_subject_public_key_info(spki, spkilen,
+        PKA_RSA, tmpbuf, &tmpbuf_len,
+        LTC_ASN1_NULL, NULL, 0)) != CRYPT_OK) {
+      goto LBL_ERR;
    }
 
+   /* now it should be SEQUENCE { INTEGER, INTEGER } */
+   LTC_SET_ASN1(ne, 0, LTC_ASN1_INTEGER, key->N, 1UL);
+   LTC_SET_ASN1(ne, 1, LTC_ASN1_INTEGER, key->e, 1UL);
+   if ((err = der_decode_sequence(tmpbuf, tmpbuf_len, ne, 2)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   key->type = PK_PUBLIC;
+   if ((err = rsa_mont_setup(key)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   goto LBL_FREE;
 
 LBL_ERR:
    rsa_free(key);
 
 LBL_FREE:
-   if (decoded_list) der_free_sequence_flexi(decoded_list);
    if (tmpbuf != NULL) XFREE(tmpbuf);
 
    return err;
@@ -95,6 +95,14 @@ int rsa_make_key(prng_state *prng, int wprng, int size, long e, rsa_key *key)
    /* set key type (in this case it's CRT optimized) */
    key->type = PK_PRIVATE;
 
+   /* cache the Montgomery contexts for p, q and N */
+   key->mont_p = key->mont_q = key->mont_N = NULL;
+   key->pub_der = key->pub_der_std = NULL;
+   key->pub_der_len = key->pub_der_std_len = 0;
+   key->R_p    = key->R_q    = key->R_N    = NULL;
+   key->Vf     = key->Vi     = NULL;
+   if ((err = rsa_mont_setup(key)) != CRYPT_OK)                        { goto errkey; }
+
    /* return ok and free temps */
    err       = CRYPT_OK;
    goto cleanup;
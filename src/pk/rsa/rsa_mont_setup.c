@@ -0,0 +1,108 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file rsa_mont_setup.c
+  Cache Montgomery contexts inside an RSA key, Tom St Denis
+*/
+
+#ifdef LTC_MRSA
+
+static int _mont_one(void *modulus, void **mont, void **R)
+{
+   int err;
+
+   if ((err = mp_montgomery_setup(modulus, mont)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = mp_init(R)) != CRYPT_OK) {
+      mp_montgomery_free(*mont);
+      *mont = NULL;
+      return err;
+   }
+   if ((err = mp_montgomery_normalization(*R, modulus)) != CRYPT_OK) {
+      mp_montgomery_free(*mont);
+      mp_clear(*R);
+      *mont = NULL;
+      *R    = NULL;
+      return err;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Cache the Montgomery reduction digits and normalization residues for
+  p, q and N inside an RSA key, so rsa_exptmod can skip the fixed
+  reduction setup on every private-key operation.  Called by
+  rsa_make_key and rsa_import; safe to call again after the key
+  changes.  If the active math provider has no Montgomery hooks the
+  key is left uncached and CRYPT_OK is returned.
+  @param key    The RSA key to populate
+  @return CRYPT_OK if successful
+*/
+int rsa_mont_setup(rsa_key *key)
+{
+   int err;
+
+   LTC_ARGCHK(key != NULL);
+
+   rsa_mont_free(key);
+
+   if (ltc_mp.montgomery_setup         == NULL ||
+       ltc_mp.montgomery_normalization == NULL ||
+       ltc_mp.montgomery_reduce        == NULL) {
+      return CRYPT_OK;
+   }
+
+   if ((err = _mont_one(key->N, &key->mont_N, &key->R_N)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* the CRT moduli, when the key carries them */
+   if (key->type == PK_PRIVATE &&
+       key->p != NULL && mp_get_digit_count(key->p) != 0 &&
+       key->q != NULL && mp_get_digit_count(key->q) != 0) {
+      if ((err = _mont_one(key->p, &key->mont_p, &key->R_p)) != CRYPT_OK) {
+         rsa_mont_free(key);
+         return err;
+      }
+      if ((err = _mont_one(key->q, &key->mont_q, &key->R_q)) != CRYPT_OK) {
+         rsa_mont_free(key);
+         return err;
+      }
+   }
+
+   return CRYPT_OK;
+}
+
+/**
+  Release the cached Montgomery contexts of an RSA key, leaving the
+  key material itself alone.
+  @param key    The RSA key to strip
+*/
+void rsa_mont_free(rsa_key *key)
+{
+   LTC_ARGCHKVD(key != NULL);
+
+   if (key->mont_p != NULL) { mp_montgomery_free(key->mont_p); key->mont_p = NULL; }
+   if (key->mont_q != NULL) { mp_montgomery_free(key->mont_q); key->mont_q = NULL; }
+   if (key->mont_N != NULL) { mp_montgomery_free(key->mont_N); key->mont_N = NULL; }
+   if (key->R_p    != NULL) { mp_clear(key->R_p);              key->R_p    = NULL; }
+   if (key->R_q    != NULL) { mp_clear(key->R_q);              key->R_q    = NULL; }
+   if (key->R_N    != NULL) { mp_clear(key->R_N);              key->R_N    = NULL; }
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,79 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file rsa_verify_hash_batch.c
+  RSA signature verification over an array of items, Tom St Denis
+*/
+
+#ifdef LTC_MRSA
+
+/**
+  Verify an array of RSA signatures, returning a per-item verdict
+  vector.  Keys keep their Montgomery contexts cached (rsa_mont_setup),
+  so verifying many signatures under the same imported key repeats no
+  reduction setup.  A malformed signature marks its slot invalid and
+  the batch continues; only argument-level problems fail the call, so
+  the verdict vector is always fully populated on CRYPT_OK.
+  @param sigs     The array of signatures
+  @param siglens  The lengths of the signatures (octets)
+  @param hashes   The array of message hashes
+  @param hashlens The lengths of the hashes (octets)
+  @param padding  Type of padding (LTC_PKCS_1_PSS or LTC_PKCS_1_V1_5)
+  @param hash_idx The index of the desired hash
+  @param saltlen  The length of the salt used during signature
+  @param stat     [out] Per-item results, 1==valid, 0==invalid
+  @param keys     The public RSA keys, one per item (may repeat)
+  @param msgs     The number of items
+  @return CRYPT_OK on success (even if some signatures are invalid)
+*/
+int rsa_verify_hash_batch(const unsigned char * const *sigs,   const unsigned long *siglens,
+                          const unsigned char * const *hashes, const unsigned long *hashlens,
+                                int            padding,
+                                int            hash_idx, unsigned long saltlen,
+                                int           *stat,     rsa_key * const *keys, int msgs)
+{
+   int err, x;
+
+   LTC_ARGCHK(stat     != NULL);
+   LTC_ARGCHK(sigs     != NULL || msgs == 0);
+   LTC_ARGCHK(siglens  != NULL || msgs == 0);
+   LTC_ARGCHK(hashes   != NULL || msgs == 0);
+   LTC_ARGCHK(hashlens != NULL || msgs == 0);
+   LTC_ARGCHK(keys     != NULL || msgs == 0);
+
+   /* valid padding? */
+   if ((padding != LTC_PKCS_1_V1_5) &&
+       (padding != LTC_PKCS_1_PSS)) {
+      return CRYPT_PK_INVALID_PADDING;
+   }
+
+   for (x = 0; x < msgs; x++) {
+      stat[x] = 0;
+      err = rsa_verify_hash_ex(sigs[x], siglens[x], hashes[x], hashlens[x],
+                               padding, hash_idx, saltlen, &stat[x], keys[x]);
+      if (err == CRYPT_PK_INVALID_PADDING || err == CRYPT_INVALID_ARG) {
+         /* the whole batch is misconfigured, not just this item */
+         return err;
+      }
+      /* anything else (truncated packet, wrong size, ...) is a verdict
+       * on this item only; stat[x] stays 0 */
+   }
+
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -0,0 +1,822 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ed25519.c
+  Ed25519 signatures (RFC 8032), Tom St Denis
+
+  Extended twisted Edwards coordinates over the shared fe51 field
+  arithmetic, 4-bit window scalar multiplication with a cached
+  base-point table, and a batch verifier that checks a random linear
+  combination of many signatures under one shared doubling chain.
+*/
+
+#ifdef LTC_ED25519
+
+#include "fe51.h"
+
+/* group element in extended coordinates (X:Y:Z:T), x=X/Z y=Y/Z xy=T/Z */
+typedef struct {
+   fe51 X, Y, Z, T;
+} ge25519;
+
+/* the group order L = 2^252 + 27742317777372353535851937790883648493 */
+static const ulong64 s_sc_L[4] = {
+   CONST64(0x5812631A5CF5D3ED), CONST64(0x14DEF9DEA2F79CD6),
+   CONST64(0x0000000000000000), CONST64(0x1000000000000000)
+};
+static const unsigned char s_sc_L_bytes[32] = {
+   0xED, 0xD3, 0xF5, 0x5C, 0x1A, 0x63, 0x12, 0x58,
+   0xD6, 0x9C, 0xF7, 0xA2, 0xDE, 0xF9, 0xDE, 0x14,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+
+/* curve constants and the cached base-point window table, computed on
+ * first use and shared read-only; s_tabB[i] = (i+1)*B */
+LTC_MUTEX_GLOBAL(ltc_ed25519_mutex)
+static int     s_init_done = 0;
+static fe51    s_d, s_d2, s_sqrtm1;
+static ge25519 s_tabB[15];
+
+/* ---- scalar arithmetic mod L ---- */
+
+/* out = in mod L; in is inlen octets little endian.  Bit-serial
+ * shift-and-subtract: scalar work is tiny next to the point math */
+static void s_sc_reduce(unsigned char *out, const unsigned char *in, int inlen)
+{
+   ulong64 r0 = 0, r1 = 0, r2 = 0, r3 = 0, t0, t1, t2, t3, b;
+   int     i;
+
+   for (i = inlen * 8 - 1; i >= 0; i--) {
+      /* r = 2r + bit; r < L keeps this under 2^253 */
+      r3 = (r3 << 1) | (r2 >> 63);
+      r2 = (r2 << 1) | (r1 >> 63);
+      r1 = (r1 << 1) | (r0 >> 63);
+      r0 = (r0 << 1) | ((in[i >> 3] >> (i & 7)) & 1);
+
+      /* subtract L once when r >= L */
+      t0 = r0 - s_sc_L[0];                   b = (r0 < s_sc_L[0]);
+      t1 = r1 - s_sc_L[1] - b;               b = (r1 < s_sc_L[1] + b);
+      t2 = r2 - b;                           b = (r2 < b);
+      t3 = r3 - s_sc_L[3] - b;               b = (r3 < s_sc_L[3] + b);
+      if (!b) {
+         r0 = t0; r1 = t1; r2 = t2; r3 = t3;
+      }
+   }
+   STORE64L(r0, out);
+   STORE64L(r1, out +  8);
+   STORE64L(r2, out + 16);
+   STORE64L(r3, out + 24);
+}
+
+/* out = (a*b + c) mod L; all 32-octet little endian, a and b reduced */
+static void s_sc_muladd(unsigned char *out, const unsigned char *a, const unsigned char *b, const unsigned char *c)
+{
+   ulong64       al[4], bl[4], p[8], carry, cl;
+   ulong128      t;
+   unsigned char buf[64];
+   int           i, j;
+
+   for (i = 0; i < 4; i++) {
+      LOAD64L(al[i], a + 8*i);
+      LOAD64L(bl[i], b + 8*i);
+      p[i] = p[i+4] = 0;
+   }
+   for (i = 0; i < 4; i++) {
+      carry = 0;
+      for (j = 0; j < 4; j++) {
+         t = (ulong128)al[i] * bl[j] + p[i+j] + carry;
+         p[i+j] = (ulong64)t;
+         carry  = (ulong64)(t >> 64);
+      }
+      p[i+4] = carry;
+   }
+   carry = 0;
+   for (i = 0; i < 4; i++) {
+      LOAD64L(cl, c + 8*i);
+      t = (ulong128)p[i] + cl + carry;
+      p[i]  = (ulong64)t;
+      carry = (ulong64)(t >> 64);
+   }
+   for (i = 4; i < 8 && carry != 0; i++) {
+      t = (ulong128)p[i] + carry;
+      p[i]  = (ulong64)t;
+      carry = (ulong64)(t >> 64);
+   }
+   for (i = 0; i < 8; i++) {
+      STORE64L(p[i], buf + 8*i);
+   }
+   s_sc_reduce(out, buf, 64);
+}
+
+/* 1 when s (32 octets little endian) is < L; rejects the malleable
+ * form of a signature's S half */
+static int s_sc_is_canonical(const unsigned char *s)
+{
+   int i;
+   for (i = 31; i >= 0; i--) {
+      if (s[i] < s_sc_L_bytes[i]) return 1;
+      if (s[i] > s_sc_L_bytes[i]) return 0;
+   }
+   return 0;
+}
+
+/* ---- point arithmetic ---- */
+
+static void s_ge_identity(ge25519 *r)
+{
+   int i;
+   for (i = 0; i < 5; i++) {
+      r->X[i] = r->Y[i] = r->Z[i] = r->T[i] = 0;
+   }
+   r->Y[0] = r->Z[0] = 1;
+}
+
+/* r = p + q; unified extended addition (valid for p == q), r may alias
+ * either input */
+static void s_ge_add(ge25519 *r, const ge25519 *p, const ge25519 *q)
+{
+   fe51 A, B, C, D, E, F, G, H, t;
+
+   fe51_sub(t, p->Y, p->X);
+   fe51_sub(A, q->Y, q->X);
+   fe51_mul(A, t, A);
+   fe51_add(t, p->Y, p->X);
+   fe51_add(B, q->Y, q->X);
+   fe51_mul(B, t, B);
+   fe51_mul(C, p->T, q->T);
+   fe51_mul(C, C, s_d2);
+   fe51_mul(D, p->Z, q->Z);
+   fe51_add(D, D, D);
+   fe51_sub(E, B, A);
+   fe51_sub(F, D, C);
+   fe51_add(G, D, C);
+   fe51_add(H, B, A);
+   fe51_mul(r->X, E, F);
+   fe51_mul(r->Y, G, H);
+   fe51_mul(r->T, E, H);
+   fe51_mul(r->Z, F, G);
+}
+
+/* r = -p; coordinates are reduced enough that the subtraction
+ * headroom holds */
+static void s_ge_neg(ge25519 *r, const ge25519 *p)
+{
+   fe51 zero;
+   int  i;
+   for (i = 0; i < 5; i++) {
+      zero[i] = 0;
+   }
+   fe51_sub(r->X, zero, p->X);
+   XMEMCPY(r->Y, p->Y, sizeof(fe51));
+   XMEMCPY(r->Z, p->Z, sizeof(fe51));
+   fe51_sub(r->T, zero, p->T);
+}
+
+/* serialize: y with the parity of x in the top bit */
+static void s_ge_tobytes(unsigned char *out, const ge25519 *p)
+{
+   fe51          zi, x, y;
+   unsigned char xb[32];
+
+   fe51_invert(zi, p->Z);
+   fe51_mul(x, p->X, zi);
+   fe51_mul(y, p->Y, zi);
+   fe51_tobytes(out, y);
+   fe51_tobytes(xb, x);
+   out[31] |= (unsigned char)((xb[0] & 1) << 7);
+}
+
+/* decompress; CRYPT_INVALID_PACKET when in is not a curve point */
+static int s_ge_frombytes(ge25519 *p, const unsigned char *in)
+{
+   fe51          one, zero, u, v, v3, t, x, nu;
+   unsigned char chk1[32], chk2[32], xb[32], yb[32];
+   int           i, sign;
+
+   XMEMCPY(yb, in, 32);
+   sign = yb[31] >> 7;
+   yb[31] &= 127;
+
+   /* reject a non-canonical y */
+   fe51_frombytes(p->Y, yb);
+   fe51_tobytes(chk1, p->Y);
+   if (XMEMCMP(chk1, yb, 32) != 0) {
+      return CRYPT_INVALID_PACKET;
+   }
+
+   for (i = 0; i < 5; i++) {
+      one[i] = zero[i] = 0;
+   }
+   one[0] = 1;
+
+   /* x^2 = u/v with u = y^2-1, v = d*y^2+1 */
+   fe51_sqr(t, p->Y);
+   fe51_sub(u, t, one);
+   fe51_mul(v, t, s_d);
+   fe51_add(v, v, one);
+
+   /* candidate x = u*v^3 * (u*v^7)^((p-5)/8) */
+   fe51_sqr(v3, v);
+   fe51_mul(v3, v3, v);
+   fe51_sqr(t, v3);
+   fe51_mul(t, t, v);
+   fe51_mul(t, t, u);
+   fe51_pow22523(t, t);
+   fe51_mul(x, u, v3);
+   fe51_mul(x, x, t);
+
+   /* v*x^2 must be u (done) or -u (multiply x by sqrt(-1)) */
+   fe51_sqr(t, x);
+   fe51_mul(t, t, v);
+   fe51_tobytes(chk1, t);
+   fe51_tobytes(chk2, u);
+   if (XMEMCMP(chk1, chk2, 32) != 0) {
+      fe51_frombytes(u, chk2);      /* canonical u, safe to negate */
+      fe51_sub(nu, zero, u);
+      fe51_tobytes(chk2, nu);
+      if (XMEMCMP(chk1, chk2, 32) != 0) {
+         return CRYPT_INVALID_PACKET;
+      }
+      fe51_mul(x, x, s_sqrtm1);
+   }
+
+   fe51_tobytes(xb, x);
+   if ((xb[0] & 1) != sign) {
+      fe51_frombytes(x, xb);
+      fe51_sub(x, zero, x);
+   }
+   /* x == 0 admits no sign bit */
+   if (sign != 0) {
+      int z = 0;
+      for (i = 0; i < 32; i++) {
+         z |= xb[i];
+      }
+      if (z == 0) {
+         return CRYPT_INVALID_PACKET;
+      }
+   }
+
+   XMEMCPY(p->X, x, sizeof(fe51));
+   p->Z[0] = 1;
+   for (i = 1; i < 5; i++) {
+      p->Z[i] = 0;
+   }
+   fe51_mul(p->T, p->X, p->Y);
+   return CRYPT_OK;
+}
+
+/* tab[i] = (i+1) * p */
+static void s_ge_build_table(ge25519 *tab, const ge25519 *p)
+{
+   int i;
+   XMEMCPY(&tab[0], p, sizeof(*p));
+   for (i = 1; i < 15; i++) {
+      s_ge_add(&tab[i], &tab[i-1], p);
+   }
+}
+
+/* r = sum of [scalar_i]P_i over one shared doubling chain; num scalars
+ * (32 octets little endian, < 2^253) with their 15-entry tables.
+ * Variable time: only used on public data */
+static void s_ge_straus(ge25519 *r, const unsigned char * const *scs, const ge25519 * const *tabs, int num)
+{
+   int w, i, j, nib;
+
+   s_ge_identity(r);
+   for (w = 63; w >= 0; w--) {
+      for (j = 0; j < 4; j++) {
+         s_ge_add(r, r, r);
+      }
+      for (i = 0; i < num; i++) {
+         nib = (scs[i][w >> 1] >> ((w & 1) << 2)) & 15;
+         if (nib != 0) {
+            s_ge_add(r, r, &tabs[i][nib - 1]);
+         }
+      }
+   }
+}
+
+/* constant-time select: r = tab[nib-1] when nib != 0, identity
+ * otherwise.  Every table entry is read and folded in through masks so
+ * neither the memory access pattern nor the branch structure depends
+ * on the nibble */
+static void s_ge_select(ge25519 *r, const ge25519 *tab, unsigned int nib)
+{
+   ulong64      mask, x;
+   unsigned int i;
+   int          j;
+
+   s_ge_identity(r);
+   for (i = 1; i < 16; i++) {
+      x    = (ulong64)(i ^ nib);
+      mask = (ulong64)0 - ((x - 1) >> 63);   /* all-ones iff i == nib */
+      for (j = 0; j < 5; j++) {
+         r->X[j] ^= mask & (r->X[j] ^ tab[i-1].X[j]);
+         r->Y[j] ^= mask & (r->Y[j] ^ tab[i-1].Y[j]);
+         r->Z[j] ^= mask & (r->Z[j] ^ tab[i-1].Z[j]);
+         r->T[j] ^= mask & (r->T[j] ^ tab[i-1].T[j]);
+      }
+   }
+}
+
+/* r = [sc]B for a secret scalar: the same fixed 4-bit window walk as
+ * s_ge_straus, but every nibble costs one masked table select and one
+ * unified addition (the identity is a valid addend), so there are no
+ * secret-dependent branches or table indices.  Key expansion and
+ * signing come through here; s_ge_straus stays on the verify side
+ * where every scalar is public */
+static void s_ge_scalarmult_base_ct(ge25519 *r, const unsigned char *sc)
+{
+   ge25519 t;
+   int     w, j;
+
+   s_ge_identity(r);
+   for (w = 63; w >= 0; w--) {
+      for (j = 0; j < 4; j++) {
+         s_ge_add(r, r, r);
+      }
+      s_ge_select(&t, s_tabB, (unsigned int)((sc[w >> 1] >> ((w & 1) << 2)) & 15));
+      s_ge_add(r, r, &t);
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(&t, sizeof(t));
+#endif
+}
+
+/* compute the curve constants and the base-point table once */
+static void s_ed25519_init(void)
+{
+   fe51 t, five;
+   unsigned char yb[32];
+   ge25519 B;
+   int  i;
+
+   LTC_MUTEX_LOCK(&ltc_ed25519_mutex);
+   if (!s_init_done) {
+      /* sqrt(-1) = 2^((p-1)/4) = (2^(2^252-3))^2 * 2 */
+      for (i = 0; i < 5; i++) {
+         t[i] = 0;
+      }
+      t[0] = 2;
+      fe51_pow22523(s_sqrtm1, t);
+      fe51_sqr(s_sqrtm1, s_sqrtm1);
+      fe51_add(s_sqrtm1, s_sqrtm1, s_sqrtm1);   /* *2 */
+
+      /* d = -121665/121666, d2 = 2d */
+      for (i = 0; i < 5; i++) {
+         t[i] = 0;
+      }
+      t[0] = 121666;
+      fe51_invert(t, t);
+      fe51_mul121665(s_d, t);
+      for (i = 0; i < 5; i++) {
+         t[i] = 0;
+      }
+      fe51_sub(s_d, t, s_d);
+      fe51_add(s_d2, s_d, s_d);
+
+      /* base point: y = 4/5, even x */
+      for (i = 0; i < 5; i++) {
+         t[i] = five[i] = 0;
+      }
+      t[0] = 4; five[0] = 5;
+      fe51_invert(five, five);
+      fe51_mul(t, t, five);
+      fe51_tobytes(yb, t);
+      (void)s_ge_frombytes(&B, yb);
+
+      s_ge_build_table(s_tabB, &B);
+      s_init_done = 1;
+   }
+   LTC_MUTEX_UNLOCK(&ltc_ed25519_mutex);
+}
+
+/* sha512(a [, b [, c]]) with NULL meaning absent */
+static void s_ed25519_hash(unsigned char *out,
+                           const unsigned char *a, unsigned long alen,
+                           const unsigned char *b, unsigned long blen,
+                           const unsigned char *c, unsigned long clen)
+{
+   hash_state md;
+   sha512_init(&md);
+   if (a != NULL) sha512_process(&md, a, alen);
+   if (b != NULL) sha512_process(&md, b, blen);
+   if (c != NULL) sha512_process(&md, c, clen);
+   sha512_done(&md, out);
+}
+
+/* derive the clamped secret scalar and prefix from the seed, and the
+ * public point when pub is not NULL */
+static void s_ed25519_expand(unsigned char *scalar, unsigned char *prefix, unsigned char *pub, const ed25519_key *key)
+{
+   unsigned char h[64];
+
+   s_ed25519_hash(h, key->seed, 32, NULL, 0, NULL, 0);
+   h[0]  &= 248;
+   h[31] &= 127;
+   h[31] |= 64;
+   XMEMCPY(scalar, h, 32);
+   if (prefix != NULL) {
+      XMEMCPY(prefix, h + 32, 32);
+   }
+   if (pub != NULL) {
+      ge25519 A;
+      s_ge_scalarmult_base_ct(&A, scalar);
+      s_ge_tobytes(pub, &A);
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(h, sizeof(h));
+#endif
+}
+
+/* ---- public API ---- */
+
+/**
+  Make an Ed25519 key [private key pair]
+  @param prng     An active PRNG state
+  @param wprng    The index for the PRNG you desire to use
+  @param key      [out] Where the newly created Ed25519 key will be stored
+  @return CRYPT_OK if successful
+*/
+int ed25519_make_key(prng_state *prng, int wprng, ed25519_key *key)
+{
+   unsigned char scalar[32];
+   int err;
+
+   LTC_ARGCHK(key != NULL);
+
+   if ((err = prng_is_valid(wprng)) != CRYPT_OK) {
+      return err;
+   }
+   if (prng_descriptor[wprng].read(key->seed, 32, prng) != 32) {
+      return CRYPT_ERROR_READPRNG;
+   }
+
+   s_ed25519_init();
+   s_ed25519_expand(scalar, NULL, key->pub, key);
+   key->type = PK_PRIVATE;
+#ifdef LTC_CLEAN_STACK
+   zeromem(scalar, sizeof(scalar));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Sign a message with Ed25519
+  @param msg      The message to sign
+  @param msglen   The length of the message (octets)
+  @param sig      [out] The destination for the 64-octet signature
+  @param siglen   [in/out] The max size and resulting size of the signature
+  @param key      A private Ed25519 key
+  @return CRYPT_OK if successful
+*/
+int ed25519_sign(const unsigned char *msg, unsigned long msglen,
+                       unsigned char *sig, unsigned long *siglen,
+                 const ed25519_key *key)
+{
+   unsigned char scalar[32], prefix[32], r[32], k[32], h[64];
+   ge25519       R;
+
+   LTC_ARGCHK(msg    != NULL || msglen == 0);
+   LTC_ARGCHK(sig    != NULL);
+   LTC_ARGCHK(siglen != NULL);
+   LTC_ARGCHK(key    != NULL);
+
+   if (key->type != PK_PRIVATE) {
+      return CRYPT_PK_NOT_PRIVATE;
+   }
+   if (*siglen < 64) {
+      *siglen = 64;
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+
+   s_ed25519_init();
+   s_ed25519_expand(scalar, prefix, NULL, key);
+
+   /* r = H(prefix || M) mod L, R = [r]B */
+   s_ed25519_hash(h, prefix, 32, msg, msglen, NULL, 0);
+   s_sc_reduce(r, h, 64);
+   s_ge_scalarmult_base_ct(&R, r);
+   s_ge_tobytes(sig, &R);
+
+   /* S = r + H(R || A || M) * a mod L */
+   s_ed25519_hash(h, sig, 32, key->pub, 32, msg, msglen);
+   s_sc_reduce(k, h, 64);
+   s_sc_muladd(sig + 32, k, scalar, r);
+
+   *siglen = 64;
+#ifdef LTC_CLEAN_STACK
+   zeromem(scalar, sizeof(scalar));
+   zeromem(prefix, sizeof(prefix));
+   zeromem(r,      sizeof(r));
+   zeromem(h,      sizeof(h));
+#endif
+   return CRYPT_OK;
+}
+
+/* shared per-signature checks; fills h = H(R||A||M) mod L and the
+ * decompressed negated public point */
+static int s_ed25519_verify_prep(const unsigned char *msg, unsigned long msglen,
+                                 const unsigned char *sig, unsigned long siglen,
+                                 unsigned char *h, ge25519 *negA, const ed25519_key *key)
+{
+   unsigned char hbig[64];
+   ge25519       A;
+   int           err;
+
+   if (siglen != 64 || !s_sc_is_canonical(sig + 32)) {
+      return CRYPT_INVALID_PACKET;
+   }
+   if ((err = s_ge_frombytes(&A, key->pub)) != CRYPT_OK) {
+      return err;
+   }
+   s_ge_neg(negA, &A);
+   s_ed25519_hash(hbig, sig, 32, key->pub, 32, msg, msglen);
+   s_sc_reduce(h, hbig, 64);
+   return CRYPT_OK;
+}
+
+/**
+  Verify an Ed25519 signature
+  @param msg      The message that was signed
+  @param msglen   The length of the message (octets)
+  @param sig      The 64-octet signature
+  @param siglen   The length of the signature (octets)
+  @param stat     [out] 1 if the signature is valid, 0 otherwise
+  @param key      The public Ed25519 key
+  @return CRYPT_OK if the verdict in stat is meaningful
+*/
+int ed25519_verify(const unsigned char *msg, unsigned long msglen,
+                   const unsigned char *sig, unsigned long siglen,
+                   int *stat, const ed25519_key *key)
+{
+   unsigned char h[32], chk[32];
+   ge25519       negA, tabA[15], P;
+   const unsigned char *scs[2];
+   const ge25519       *tabs[2];
+
+   LTC_ARGCHK(msg  != NULL || msglen == 0);
+   LTC_ARGCHK(sig  != NULL);
+   LTC_ARGCHK(stat != NULL);
+   LTC_ARGCHK(key  != NULL);
+
+   *stat = 0;
+   s_ed25519_init();
+
+   if (s_ed25519_verify_prep(msg, msglen, sig, siglen, h, &negA, key) != CRYPT_OK) {
+      return CRYPT_OK;
+   }
+
+   /* [S]B - [h]A must equal R */
+   s_ge_build_table(tabA, &negA);
+   scs[0]  = sig + 32; tabs[0] = s_tabB;
+   scs[1]  = h;        tabs[1] = tabA;
+   s_ge_straus(&P, scs, tabs, 2);
+   s_ge_tobytes(chk, &P);
+   if (XMEMCMP(chk, sig, 32) == 0) {
+      *stat = 1;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Verify many Ed25519 signatures at once
+
+  Checks one random linear combination [8]*sum z_i*([S_i]B - R_i - [h_i]A_i)
+  over a single shared doubling chain, so the per-signature cost drops
+  to the window additions.
+
+  The combined check uses the cofactored equation (the sum is cleared
+  of the 8-torsion before the identity compare): this is necessary
+  because colluding signers could otherwise pick torsion components
+  that cancel under the random weights.  A consequence is that the
+  batch can accept signatures whose R or A carry a small-torsion
+  component even though the strict ed25519_verify would reject them;
+  both verdicts are permitted by RFC 8032.  Only when the combined
+  check fails does every item get re-verified individually, and then
+  stat matches ed25519_verify exactly.
+
+  @param msgs     The array of messages
+  @param msglens  The lengths of the messages (octets)
+  @param sigs     The array of 64-octet signatures
+  @param siglens  The lengths of the signatures (octets)
+  @param stat     [out] Per-item results, 1==valid, 0==invalid
+  @param keys     The public Ed25519 keys, one per item
+  @param num      The number of items
+  @param prng     An active PRNG state (for the combination weights)
+  @param wprng    The index of the PRNG desired
+  @return CRYPT_OK if the verdicts in stat are meaningful
+*/
+int ed25519_verify_batch(const unsigned char * const *msgs, const unsigned long *msglens,
+                         const unsigned char * const *sigs, const unsigned long *siglens,
+                         int *stat, const ed25519_key * const *keys, int num,
+                         prng_state *prng, int wprng)
+{
+   unsigned char        *z, *w, *u, zero[32];
+   unsigned char         chk[32];
+   ge25519              *tabs, negA, R, negR, P;
+   const unsigned char **scs;
+   const ge25519       **tabp;
+   int                   err, i, n, ok;
+
+   LTC_ARGCHK(stat    != NULL);
+   LTC_ARGCHK(msgs    != NULL || num == 0);
+   LTC_ARGCHK(msglens != NULL || num == 0);
+   LTC_ARGCHK(sigs    != NULL || num == 0);
+   LTC_ARGCHK(siglens != NULL || num == 0);
+   LTC_ARGCHK(keys    != NULL || num == 0);
+
+   if ((err = prng_is_valid(wprng)) != CRYPT_OK) {
+      return err;
+   }
+   if (num <= 0) {
+      return CRYPT_OK;
+   }
+
+   s_ed25519_init();
+
+   /* scalars: u for B, then z_i and w_i = z_i*h_i per item; tables:
+    * negated R_i and A_i per item */
+   z    = XCALLOC(2*num + 1, 32);
+   tabs = XMALLOC(sizeof(ge25519) * 15 * 2 * num);
+   scs  = XMALLOC(sizeof(*scs)  * (2*num + 1));
+   tabp = XMALLOC(sizeof(*tabp) * (2*num + 1));
+   if (z == NULL || tabs == NULL || scs == NULL || tabp == NULL) {
+      if (z    != NULL) XFREE(z);
+      if (tabs != NULL) XFREE(tabs);
+      if (scs  != NULL) XFREE(scs);
+      if (tabp != NULL) XFREE(tabp);
+      return CRYPT_MEM;
+   }
+   u = z + 2*num*32;
+   zeromem(zero, 32);
+
+   n = 0;
+   for (i = 0; i < num; i++) {
+      unsigned char h[32];
+
+      stat[i] = 0;
+      if (s_ed25519_verify_prep(msgs[i], msglens[i], sigs[i], siglens[i], h, &negA, keys[i]) != CRYPT_OK) {
+         continue;                      /* stays invalid, not batched */
+      }
+      if (s_ge_frombytes(&R, sigs[i]) != CRYPT_OK) {
+         continue;
+      }
+      s_ge_neg(&negR, &R);
+
+      /* random odd 128-bit weight */
+      w = z + (2*n)*32;
+      if (prng_descriptor[wprng].read(w, 16, prng) != 16) {
+         err = CRYPT_ERROR_READPRNG;
+         goto done;
+      }
+      w[0] |= 1;
+
+      /* u += z_i * S_i, w_i = z_i * h_i */
+      s_sc_muladd(u, w, sigs[i] + 32, u);
+      s_sc_muladd(w + 32, w, h, zero);
+
+      s_ge_build_table(&tabs[(2*n)   * 15], &negR);
+      s_ge_build_table(&tabs[(2*n+1) * 15], &negA);
+      scs[2*n+1]  = w;
+      tabp[2*n+1] = &tabs[(2*n) * 15];
+      scs[2*n+2]  = w + 32;
+      tabp[2*n+2] = &tabs[(2*n+1) * 15];
+      stat[i] = 1;                      /* provisional */
+      n++;
+   }
+
+   err = CRYPT_OK;
+   if (n > 0) {
+      scs[0]  = u;
+      tabp[0] = s_tabB;
+      s_ge_straus(&P, scs, tabp, 2*n + 1);
+      /* multiply by the cofactor: annihilates any 8-torsion component
+       * so colluding items cannot cancel through the random weights */
+      s_ge_add(&P, &P, &P);
+      s_ge_add(&P, &P, &P);
+      s_ge_add(&P, &P, &P);
+      s_ge_tobytes(chk, &P);
+      zeromem(zero, 32);
+      zero[0] = 1;                      /* encoded identity */
+      ok = (XMEMCMP(chk, zero, 32) == 0);
+      if (!ok) {
+         /* at least one forgery: fall back to exact per-item verdicts */
+         for (i = 0; i < num; i++) {
+            if (stat[i] == 1) {
+               if ((err = ed25519_verify(msgs[i], msglens[i], sigs[i], siglens[i], &stat[i], keys[i])) != CRYPT_OK) {
+                  goto done;
+               }
+            }
+         }
+      }
+   }
+
+done:
+   XFREE(tabp);
+   XFREE(scs);
+   XFREE(tabs);
+   XFREE(z);
+   return err;
+}
+
+/**
+  Export an Ed25519 key as a raw 32-octet string
+  @param out    [out] The destination for the key
+  @param outlen [in/out] The max size and resulting size of the export
+  @param type   Which part of the key (PK_PRIVATE seed or PK_PUBLIC point)
+  @param key    The key you wish to export
+  @return CRYPT_OK if successful
+*/
+int ed25519_export(unsigned char *out, unsigned long *outlen, int type, const ed25519_key *key)
+{
+   LTC_ARGCHK(out    != NULL);
+   LTC_ARGCHK(outlen != NULL);
+   LTC_ARGCHK(key    != NULL);
+
+   if (*outlen < 32) {
+      *outlen = 32;
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+   if (type == PK_PRIVATE) {
+      if (key->type != PK_PRIVATE) {
+         return CRYPT_PK_NOT_PRIVATE;
+      }
+      XMEMCPY(out, key->seed, 32);
+   } else if (type == PK_PUBLIC) {
+      XMEMCPY(out, key->pub, 32);
+   } else {
+      return CRYPT_PK_INVALID_TYPE;
+   }
+   *outlen = 32;
+   return CRYPT_OK;
+}
+
+/**
+  Import a raw 32-octet Ed25519 key
+  @param in     The 32-octet seed (PK_PRIVATE) or compressed point (PK_PUBLIC)
+  @param inlen  The length of the input (must be 32)
+  @param type   Which kind of key (PK_PRIVATE or PK_PUBLIC)
+  @param key    [out] Where to import the key to
+  @return CRYPT_OK if successful
+*/
+int ed25519_import(const unsigned char *in, unsigned long inlen, int type, ed25519_key *key)
+{
+   LTC_ARGCHK(in  != NULL);
+   LTC_ARGCHK(key != NULL);
+
+   if (inlen != 32) {
+      return CRYPT_INVALID_PACKET;
+   }
+
+   s_ed25519_init();
+
+   if (type == PK_PRIVATE) {
+      unsigned char scalar[32];
+      XMEMCPY(key->seed, in, 32);
+      s_ed25519_expand(scalar, NULL, key->pub, key);
+      key->type = PK_PRIVATE;
+#ifdef LTC_CLEAN_STACK
+      zeromem(scalar, sizeof(scalar));
+#endif
+   } else if (type == PK_PUBLIC) {
+      ge25519 A;
+      int     err;
+      if ((err = s_ge_frombytes(&A, in)) != CRYPT_OK) {
+         return err;
+      }
+      XMEMCPY(key->pub, in, 32);
+      zeromem(key->seed, 32);
+      key->type = PK_PUBLIC;
+   } else {
+      return CRYPT_PK_INVALID_TYPE;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Zero an Ed25519 key
+  @param key   The key to wipe
+*/
+void ed25519_free(ed25519_key *key)
+{
+   LTC_ARGCHKVD(key != NULL);
+   zeromem(key, sizeof(*key));
+}
+
+#endif /* LTC_ED25519 */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
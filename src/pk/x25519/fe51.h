@@ -0,0 +1,237 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+
+/**
+  @file fe51.h
+  GF(2^255-19) arithmetic shared by the curve25519 family, Tom St Denis
+
+  Five 51-bit limbs with 128-bit products; private to src/pk/x25519.
+*/
+
+#ifndef __FE51_H__
+#define __FE51_H__
+
+#ifdef LTC_CURVE25519
+
+typedef unsigned __int128 ulong128;
+
+/* field element: five 51-bit limbs, little endian */
+typedef ulong64 fe51[5];
+
+#define FE_MASK  CONST64(0x7FFFFFFFFFFFF)
+
+static LTC_INLINE void fe51_frombytes(fe51 f, const unsigned char *in)
+{
+   ulong64 t;
+   LOAD64L(t, in);      f[0] = t                          & FE_MASK;
+   LOAD64L(t, in +  6); f[1] = (t >> 3)                   & FE_MASK;
+   LOAD64L(t, in + 12); f[2] = (t >> 6)                   & FE_MASK;
+   LOAD64L(t, in + 19); f[3] = (t >> 1)                   & FE_MASK;
+   LOAD64L(t, in + 24); f[4] = (t >> 12)                  & FE_MASK;
+}
+
+/* carry and freeze to the canonical representative, then serialize */
+static LTC_INLINE void fe51_tobytes(unsigned char *out, const fe51 f)
+{
+   ulong64 t0 = f[0], t1 = f[1], t2 = f[2], t3 = f[3], t4 = f[4], t;
+   int     i;
+
+#define FE_CARRY()                                             \
+   t1 += t0 >> 51; t0 &= FE_MASK;                              \
+   t2 += t1 >> 51; t1 &= FE_MASK;                              \
+   t3 += t2 >> 51; t2 &= FE_MASK;                              \
+   t4 += t3 >> 51; t3 &= FE_MASK;                              \
+   t0 += 19 * (t4 >> 51); t4 &= FE_MASK
+
+   for (i = 0; i < 2; i++) {
+      FE_CARRY();
+   }
+
+   /* now 0 <= t < 2^255; adding 19 pushes t >= p over 2^255 */
+   t0 += 19;
+   FE_CARRY();
+
+   /* offset by 2^255 and drop bit 255, i.e. subtract the 19 again and
+    * reduce mod p exactly once */
+   t0 += FE_MASK + 1 - 19;
+   t1 += FE_MASK;
+   t2 += FE_MASK;
+   t3 += FE_MASK;
+   t4 += FE_MASK;
+   t1 += t0 >> 51; t0 &= FE_MASK;
+   t2 += t1 >> 51; t1 &= FE_MASK;
+   t3 += t2 >> 51; t2 &= FE_MASK;
+   t4 += t3 >> 51; t3 &= FE_MASK;
+   t4 &= FE_MASK;
+
+   t = t0 | (t1 << 51);           STORE64L(t, out);
+   t = (t1 >> 13) | (t2 << 38);   STORE64L(t, out +  8);
+   t = (t2 >> 26) | (t3 << 25);   STORE64L(t, out + 16);
+   t = (t3 >> 39) | (t4 << 12);   STORE64L(t, out + 24);
+#undef FE_CARRY
+}
+
+static LTC_INLINE void fe51_add(fe51 out, const fe51 a, const fe51 b)
+{
+   out[0] = a[0] + b[0];
+   out[1] = a[1] + b[1];
+   out[2] = a[2] + b[2];
+   out[3] = a[3] + b[3];
+   out[4] = a[4] + b[4];
+}
+
+/* out = a - b; 8*p is added limbwise so nothing underflows */
+static LTC_INLINE void fe51_sub(fe51 out, const fe51 a, const fe51 b)
+{
+   out[0] = a[0] + (CONST64(0x3FFFFFFFFFFF68)) - b[0];
+   out[1] = a[1] + (CONST64(0x3FFFFFFFFFFFF8)) - b[1];
+   out[2] = a[2] + (CONST64(0x3FFFFFFFFFFFF8)) - b[2];
+   out[3] = a[3] + (CONST64(0x3FFFFFFFFFFFF8)) - b[3];
+   out[4] = a[4] + (CONST64(0x3FFFFFFFFFFFF8)) - b[4];
+}
+
+static LTC_INLINE void fe51_mul(fe51 out, const fe51 a, const fe51 b)
+{
+   ulong128 t0, t1, t2, t3, t4;
+   ulong64  a0 = a[0], a1 = a[1], a2 = a[2], a3 = a[3], a4 = a[4];
+   ulong64  b0 = b[0], b1 = b[1], b2 = b[2], b3 = b[3], b4 = b[4];
+   ulong64  s1 = 19 * b1, s2 = 19 * b2, s3 = 19 * b3, s4 = 19 * b4;
+   ulong64  c;
+
+   t0 = (ulong128)a0 * b0 + (ulong128)a1 * s4 + (ulong128)a2 * s3 + (ulong128)a3 * s2 + (ulong128)a4 * s1;
+   t1 = (ulong128)a0 * b1 + (ulong128)a1 * b0 + (ulong128)a2 * s4 + (ulong128)a3 * s3 + (ulong128)a4 * s2;
+   t2 = (ulong128)a0 * b2 + (ulong128)a1 * b1 + (ulong128)a2 * b0 + (ulong128)a3 * s4 + (ulong128)a4 * s3;
+   t3 = (ulong128)a0 * b3 + (ulong128)a1 * b2 + (ulong128)a2 * b1 + (ulong128)a3 * b0 + (ulong128)a4 * s4;
+   t4 = (ulong128)a0 * b4 + (ulong128)a1 * b3 + (ulong128)a2 * b2 + (ulong128)a3 * b1 + (ulong128)a4 * b0;
+
+   out[0] = (ulong64)t0 & FE_MASK; c = (ulong64)(t0 >> 51);
+   t1 += c;
+   out[1] = (ulong64)t1 & FE_MASK; c = (ulong64)(t1 >> 51);
+   t2 += c;
+   out[2] = (ulong64)t2 & FE_MASK; c = (ulong64)(t2 >> 51);
+   t3 += c;
+   out[3] = (ulong64)t3 & FE_MASK; c = (ulong64)(t3 >> 51);
+   t4 += c;
+   out[4] = (ulong64)t4 & FE_MASK; c = (ulong64)(t4 >> 51);
+   out[0] += c * 19;               c = out[0] >> 51; out[0] &= FE_MASK;
+   out[1] += c;                    c = out[1] >> 51; out[1] &= FE_MASK;
+   out[2] += c;
+}
+
+static LTC_INLINE void fe51_sqr(fe51 out, const fe51 a)
+{
+   fe51_mul(out, a, a);
+}
+
+/* out = a * 121665, the ladder constant (A-2)/4 */
+static LTC_INLINE void fe51_mul121665(fe51 out, const fe51 a)
+{
+   ulong128 t0, t1, t2, t3, t4;
+   ulong64  c;
+
+   t0 = (ulong128)a[0] * 121665;
+   t1 = (ulong128)a[1] * 121665;
+   t2 = (ulong128)a[2] * 121665;
+   t3 = (ulong128)a[3] * 121665;
+   t4 = (ulong128)a[4] * 121665;
+
+   out[0] = (ulong64)t0 & FE_MASK; c = (ulong64)(t0 >> 51);
+   t1 += c;
+   out[1] = (ulong64)t1 & FE_MASK; c = (ulong64)(t1 >> 51);
+   t2 += c;
+   out[2] = (ulong64)t2 & FE_MASK; c = (ulong64)(t2 >> 51);
+   t3 += c;
+   out[3] = (ulong64)t3 & FE_MASK; c = (ulong64)(t3 >> 51);
+   t4 += c;
+   out[4] = (ulong64)t4 & FE_MASK; c = (ulong64)(t4 >> 51);
+   out[0] += c * 19;
+}
+
+/* constant-time conditional swap on bit */
+static LTC_INLINE void fe51_cswap(ulong64 bit, fe51 a, fe51 b)
+{
+   ulong64 mask = (ulong64)0 - bit, t;
+   int     i;
+   for (i = 0; i < 5; i++) {
+      t    = (a[i] ^ b[i]) & mask;
+      a[i] ^= t;
+      b[i] ^= t;
+   }
+}
+
+/* out = a^(p-2) = 1/a; fixed ref10 addition chain */
+static LTC_INLINE void fe51_invert(fe51 out, const fe51 a)
+{
+   fe51 t0, t1, t2, t3;
+   int  i;
+
+   fe51_sqr(t0, a);                                        /* a^2 */
+   fe51_sqr(t1, t0); fe51_sqr(t1, t1);                     /* a^8 */
+   fe51_mul(t1, a, t1);                                    /* a^9 */
+   fe51_mul(t0, t0, t1);                                   /* a^11 */
+   fe51_sqr(t2, t0);                                       /* a^22 */
+   fe51_mul(t1, t1, t2);                                   /* a^(2^5-1) */
+   fe51_sqr(t2, t1); for (i = 1; i <  5; i++) fe51_sqr(t2, t2);
+   fe51_mul(t1, t2, t1);                                   /* a^(2^10-1) */
+   fe51_sqr(t2, t1); for (i = 1; i < 10; i++) fe51_sqr(t2, t2);
+   fe51_mul(t2, t2, t1);                                   /* a^(2^20-1) */
+   fe51_sqr(t3, t2); for (i = 1; i < 20; i++) fe51_sqr(t3, t3);
+   fe51_mul(t2, t3, t2);                                   /* a^(2^40-1) */
+   fe51_sqr(t2, t2); for (i = 1; i < 10; i++) fe51_sqr(t2, t2);
+   fe51_mul(t1, t2, t1);                                   /* a^(2^50-1) */
+   fe51_sqr(t2, t1); for (i = 1; i < 50; i++) fe51_sqr(t2, t2);
+   fe51_mul(t2, t2, t1);                                   /* a^(2^100-1) */
+   fe51_sqr(t3, t2); for (i = 1; i < 100; i++) fe51_sqr(t3, t3);
+   fe51_mul(t2, t3, t2);                                   /* a^(2^200-1) */
+   fe51_sqr(t2, t2); for (i = 1; i < 50; i++) fe51_sqr(t2, t2);
+   fe51_mul(t1, t2, t1);                                   /* a^(2^250-1) */
+   fe51_sqr(t1, t1); for (i = 1; i <  5; i++) fe51_sqr(t1, t1);
+   fe51_mul(out, t1, t0);                                  /* a^(2^255-21) */
+}
+
+/* out = a^(2^252-3), the shared stretch of the inversion chain; used
+ * as the square root exponent (p-5)/8 when decompressing points */
+static LTC_INLINE void fe51_pow22523(fe51 out, const fe51 a)
+{
+   fe51 t0, t1, t2;
+   int  i;
+
+   fe51_sqr(t0, a);                                        /* a^2 */
+   fe51_sqr(t1, t0); fe51_sqr(t1, t1);                     /* a^8 */
+   fe51_mul(t1, a, t1);                                    /* a^9 */
+   fe51_mul(t0, t0, t1);                                   /* a^11 */
+   fe51_sqr(t0, t0);                                       /* a^22 */
+   fe51_mul(t0, t1, t0);                                   /* a^(2^5-1) */
+   fe51_sqr(t1, t0); for (i = 1; i <  5; i++) fe51_sqr(t1, t1);
+   fe51_mul(t0, t1, t0);                                   /* a^(2^10-1) */
+   fe51_sqr(t1, t0); for (i = 1; i < 10; i++) fe51_sqr(t1, t1);
+   fe51_mul(t1, t1, t0);                                   /* a^(2^20-1) */
+   fe51_sqr(t2, t1); for (i = 1; i < 20; i++) fe51_sqr(t2, t2);
+   fe51_mul(t1, t2, t1);                                   /* a^(2^40-1) */
+   fe51_sqr(t1, t1); for (i = 1; i < 10; i++) fe51_sqr(t1, t1);
+   fe51_mul(t0, t1, t0);                                   /* a^(2^50-1) */
+   fe51_sqr(t1, t0); for (i = 1; i < 50; i++) fe51_sqr(t1, t1);
+   fe51_mul(t1, t1, t0);                                   /* a^(2^100-1) */
+   fe51_sqr(t2, t1); for (i = 1; i < 100; i++) fe51_sqr(t2, t2);
+   fe51_mul(t1, t2, t1);                                   /* a^(2^200-1) */
+   fe51_sqr(t1, t1); for (i = 1; i < 50; i++) fe51_sqr(t1, t1);
+   fe51_mul(t0, t1, t0);                                   /* a^(2^250-1) */
+   fe51_sqr(t0, t0); fe51_sqr(t0, t0);                     /* a^(2^252-4) */
+   fe51_mul(out, t0, a);                                   /* a^(2^252-3) */
+}
+
+#endif /* LTC_CURVE25519 */
+
+#endif /* __FE51_H__ */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
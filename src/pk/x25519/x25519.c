@@ -0,0 +1,244 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file x25519.c
+  X25519 key exchange (RFC 7748), Tom St Denis
+
+  Self-contained GF(2^255-19) arithmetic on five 51-bit limbs with
+  128-bit products, and a constant-time Montgomery ladder.  No
+  ltc_mp round-trips; the whole exchange works on 32-octet strings.
+*/
+
+#ifdef LTC_CURVE25519
+
+#include "fe51.h"
+
+/* the RFC 7748 X25519 function; k is the raw 32-octet scalar and u
+ * the raw 32-octet u-coordinate */
+static void _x25519_scalarmult(unsigned char *out, const unsigned char *k, const unsigned char *u)
+{
+   unsigned char e[32], uc[32];
+   fe51          x1, x2, z2, x3, z3, A, AA, B, BB, E, C, D, DA, CB, T;
+   ulong64       swap, bit;
+   int           t;
+
+   /* clamp the scalar, mask the uninterpreted top bit of u */
+   XMEMCPY(e, k, 32);
+   e[0]  &= 248;
+   e[31] &= 127;
+   e[31] |= 64;
+   XMEMCPY(uc, u, 32);
+   uc[31] &= 127;
+
+   fe51_frombytes(x1, uc);
+   x2[0] = 1; x2[1] = x2[2] = x2[3] = x2[4] = 0;
+   z2[0] = z2[1] = z2[2] = z2[3] = z2[4] = 0;
+   XMEMCPY(x3, x1, sizeof(x3));
+   z3[0] = 1; z3[1] = z3[2] = z3[3] = z3[4] = 0;
+
+   swap = 0;
+   for (t = 254; t >= 0; t--) {
+      bit  = (e[t >> 3] >> (t & 7)) & 1;
+      swap ^= bit;
+      fe51_cswap(swap, x2, x3);
+      fe51_cswap(swap, z2, z3);
+      swap = bit;
+
+      fe51_add(A, x2, z2);
+      fe51_sqr(AA, A);
+      fe51_sub(B, x2, z2);
+      fe51_sqr(BB, B);
+      fe51_sub(E, AA, BB);
+      fe51_add(C, x3, z3);
+      fe51_sub(D, x3, z3);
+      fe51_mul(DA, D, A);
+      fe51_mul(CB, C, B);
+      fe51_add(T, DA, CB);
+      fe51_sqr(x3, T);
+      fe51_sub(T, DA, CB);
+      fe51_sqr(T, T);
+      fe51_mul(z3, x1, T);
+      fe51_mul(x2, AA, BB);
+      fe51_mul121665(T, E);
+      fe51_add(T, AA, T);
+      fe51_mul(z2, E, T);
+   }
+   fe51_cswap(swap, x2, x3);
+   fe51_cswap(swap, z2, z3);
+
+   fe51_invert(z2, z2);
+   fe51_mul(x2, x2, z2);
+   fe51_tobytes(out, x2);
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(e, sizeof(e));
+   zeromem(x2, sizeof(x2));
+   zeromem(z2, sizeof(z2));
+#endif
+}
+
+/**
+  Make an X25519 key [private key pair]
+  @param prng     An active PRNG state
+  @param wprng    The index for the PRNG you desire to use
+  @param key      [out] Where the newly created X25519 key will be stored
+  @return CRYPT_OK if successful
+*/
+int x25519_make_key(prng_state *prng, int wprng, x25519_key *key)
+{
+   static const unsigned char base[32] = { 9 };
+   int err;
+
+   LTC_ARGCHK(key != NULL);
+
+   if ((err = prng_is_valid(wprng)) != CRYPT_OK) {
+      return err;
+   }
+
+   if (prng_descriptor[wprng].read(key->priv, 32, prng) != 32) {
+      return CRYPT_ERROR_READPRNG;
+   }
+   key->priv[0]  &= 248;
+   key->priv[31] &= 127;
+   key->priv[31] |= 64;
+
+   _x25519_scalarmult(key->pub, key->priv, base);
+   key->type = PK_PRIVATE;
+   return CRYPT_OK;
+}
+
+/**
+   Create an X25519 shared secret
+   @param private_key     The private X25519 key in the pair
+   @param public_key      The public X25519 key in the pair
+   @param out             [out] The destination of the shared data
+   @param outlen          [in/out] The max size and resulting size (32) of the shared data
+   @return CRYPT_OK if successful
+*/
+int x25519_shared_secret(const x25519_key *private_key, const x25519_key *public_key,
+                         unsigned char *out, unsigned long *outlen)
+{
+   unsigned char z;
+   int x;
+
+   LTC_ARGCHK(private_key != NULL);
+   LTC_ARGCHK(public_key  != NULL);
+   LTC_ARGCHK(out         != NULL);
+   LTC_ARGCHK(outlen      != NULL);
+
+   if (private_key->type != PK_PRIVATE) {
+      return CRYPT_PK_NOT_PRIVATE;
+   }
+   if (*outlen < 32) {
+      *outlen = 32;
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+
+   _x25519_scalarmult(out, private_key->priv, public_key->pub);
+
+   /* RFC 7748: an all-zero result means a low order public key */
+   z = 0;
+   for (x = 0; x < 32; x++) {
+      z |= out[x];
+   }
+   if (z == 0) {
+      zeromem(out, 32);
+      return CRYPT_INVALID_ARG;
+   }
+
+   *outlen = 32;
+   return CRYPT_OK;
+}
+
+/**
+  Export an X25519 key as a raw 32-octet string
+  @param out    [out] The destination for the key
+  @param outlen [in/out] The max size and resulting size of the export
+  @param type   Which part of the key (PK_PRIVATE or PK_PUBLIC)
+  @param key    The key you wish to export
+  @return CRYPT_OK if successful
+*/
+int x25519_export(unsigned char *out, unsigned long *outlen, int type, const x25519_key *key)
+{
+   LTC_ARGCHK(out    != NULL);
+   LTC_ARGCHK(outlen != NULL);
+   LTC_ARGCHK(key    != NULL);
+
+   if (*outlen < 32) {
+      *outlen = 32;
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+   if (type == PK_PRIVATE) {
+      if (key->type != PK_PRIVATE) {
+         return CRYPT_PK_NOT_PRIVATE;
+      }
+      XMEMCPY(out, key->priv, 32);
+   } else if (type == PK_PUBLIC) {
+      XMEMCPY(out, key->pub, 32);
+   } else {
+      return CRYPT_PK_INVALID_TYPE;
+   }
+   *outlen = 32;
+   return CRYPT_OK;
+}
+
+/**
+  Import a raw 32-octet X25519 key
+  @param in     The 32-octet scalar (PK_PRIVATE) or u-coordinate (PK_PUBLIC)
+  @param inlen  The length of the input (must be 32)
+  @param type   Which kind of key (PK_PRIVATE or PK_PUBLIC)
+  @param key    [out] Where to import the key to
+  @return CRYPT_OK if successful
+*/
+int x25519_import(const unsigned char *in, unsigned long inlen, int type, x25519_key *key)
+{
+   static const unsigned char base[32] = { 9 };
+
+   LTC_ARGCHK(in  != NULL);
+   LTC_ARGCHK(key != NULL);
+
+   if (inlen != 32) {
+      return CRYPT_INVALID_PACKET;
+   }
+   if (type == PK_PRIVATE) {
+      XMEMCPY(key->priv, in, 32);
+      key->priv[0]  &= 248;
+      key->priv[31] &= 127;
+      key->priv[31] |= 64;
+      _x25519_scalarmult(key->pub, key->priv, base);
+      key->type = PK_PRIVATE;
+   } else if (type == PK_PUBLIC) {
+      XMEMCPY(key->pub, in, 32);
+      zeromem(key->priv, 32);
+      key->type = PK_PUBLIC;
+   } else {
+      return CRYPT_PK_INVALID_TYPE;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Zero an X25519 key
+  @param key   The key to wipe
+*/
+void x25519_free(x25519_key *key)
+{
+   LTC_ARGCHKVD(key != NULL);
+   zeromem(key, sizeof(*key));
+}
+
+#endif /* LTC_CURVE25519 */
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -26,7 +26,9 @@ const struct ltc_prng_descriptor chacha20_prng_desc =
    &chacha20_prng_done,
    &chacha20_prng_export,
    &chacha20_prng_import,
-   &chacha20_prng_test
+   &chacha20_prng_test,
+   &chacha20_prng_fill,
+   &chacha20_prng_seed
 };
 
 /**
@@ -100,6 +102,26 @@ int chacha20_prng_ready(prng_state *prng)
    return CRYPT_OK;
 }
 
+/**
+  Instantiate directly from a seed
+  @param in     The seed material
+  @param inlen  Length of the seed material (octets)
+  @param prng   [out] The PRNG state to instantiate
+  @return CRYPT_OK if successful
+*/
+int chacha20_prng_seed(const unsigned char *in, unsigned long inlen, prng_state *prng)
+{
+   int err;
+
+   LTC_ARGCHK(in   != NULL);
+   LTC_ARGCHK(prng != NULL);
+   LTC_ARGCHK(inlen > 0);
+
+   if ((err = chacha20_prng_start(prng)) != CRYPT_OK)           return err;
+   if ((err = chacha20_prng_add_entropy(in, inlen, prng)) != CRYPT_OK) return err;
+   return chacha20_prng_ready(prng);
+}
+
 /**
   Read from the PRNG
   @param out      Destination
@@ -114,6 +136,25 @@ unsigned long chacha20_prng_read(unsigned char *out, unsigned long outlen, prng_
    return outlen;
 }
 
+/**
+  Fill a large buffer in one shot
+  @param out      Destination
+  @param outlen   Length of output
+  @param prng     The active PRNG to read from
+  @return CRYPT_OK if the whole buffer was filled
+
+  Large requests stream straight into the caller's buffer through
+  chacha_crypt, which batches blocks (vectorized where available), so
+  a single call here replaces a caller-side chunking loop.
+*/
+int chacha20_prng_fill(unsigned char *out, unsigned long outlen, prng_state *prng)
+{
+   if (outlen == 0) {
+      return CRYPT_OK;
+   }
+   return (chacha20_prng_read(out, outlen, prng) == outlen) ? CRYPT_OK : CRYPT_ERROR_READPRNG;
+}
+
 /**
   Terminate the PRNG
   @param prng   The PRNG to terminate
@@ -185,7 +226,7 @@ int chacha20_prng_test(void)
                           0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e,
                           0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
                           0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32 };
-   unsigned char dmp[300];
+   unsigned char dmp[sizeof(chacha_state) + 16];
    unsigned long dmplen = sizeof(dmp);
    unsigned char out[500];
    unsigned char t1[] = { 0x59, 0xb2, 0x26, 0x95, 0x2b, 0x01, 0x8f, 0x05, 0xbe, 0xd8 };
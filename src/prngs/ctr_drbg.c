@@ -0,0 +1,405 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file ctr_drbg.c
+  NIST SP 800-90A CTR_DRBG on AES-256 (no derivation function)
+*/
+
+/* Generation is plain AES-CTR through rijndael_ecb_encrypt, so the
+   AES-NI hooks carry the bulk path; the other registered PRNGs are
+   all built on primitives without hardware support.  The reseed
+   discipline of SP 800-90A is kept: the internal state is ratcheted
+   after every request and reads fail once the reseed interval is
+   exhausted without fresh entropy. */
+
+#ifdef LTC_CTR_DRBG
+
+/* requires AES */
+#if !defined(LTC_RIJNDAEL)
+   #error LTC_CTR_DRBG requires LTC_RIJNDAEL (AES)
+#endif
+
+/* seedlen for AES-256: 32 byte key + 16 byte counter */
+#define LTC_CTR_DRBG_SEEDLEN 48
+
+/* generate requests allowed between reseeds (SP 800-90A: 2^48) */
+#define LTC_CTR_DRBG_RESEED_INTERVAL (CONST64(1) << 48)
+
+/* bytes per generate request (SP 800-90A: 2^19 bits); larger reads
+ * are split internally with a ratchet between the parts */
+#define LTC_CTR_DRBG_MAX_REQUEST 65536UL
+
+const struct ltc_prng_descriptor ctr_drbg_desc =
+{
+   "ctr_drbg",
+   LTC_CTR_DRBG_SEEDLEN,
+   &ctr_drbg_start,
+   &ctr_drbg_add_entropy,
+   &ctr_drbg_ready,
+   &ctr_drbg_read,
+   &ctr_drbg_done,
+   &ctr_drbg_export,
+   &ctr_drbg_import,
+   &ctr_drbg_test,
+   &ctr_drbg_fill,
+   &ctr_drbg_seed
+};
+
+/* increment the counter block */
+static void s_ctr_drbg_inc(unsigned char *V)
+{
+   int x;
+   for (x = 15; x >= 0; x--) {
+      V[x] = (V[x] + 1) & 255;
+      if (V[x] != 0) break;
+   }
+}
+
+/* the Update function of SP 800-90A: ratchet K and V, folding in the
+   provided seed material (may be NULL for all-zero input) */
+static int s_ctr_drbg_update(prng_state *prng, const unsigned char *provided)
+{
+   unsigned char tmp[LTC_CTR_DRBG_SEEDLEN];
+   int           err, x;
+
+   for (x = 0; x < LTC_CTR_DRBG_SEEDLEN; x += 16) {
+      s_ctr_drbg_inc(prng->ctr_drbg.V);
+      rijndael_ecb_encrypt(prng->ctr_drbg.V, tmp + x, &prng->ctr_drbg.skey);
+   }
+   if (provided != NULL) {
+      for (x = 0; x < LTC_CTR_DRBG_SEEDLEN; x++) {
+         tmp[x] ^= provided[x];
+      }
+   }
+   XMEMCPY(prng->ctr_drbg.K, tmp,      32);
+   XMEMCPY(prng->ctr_drbg.V, tmp + 32, 16);
+   err = rijndael_setup(prng->ctr_drbg.K, 32, 0, &prng->ctr_drbg.skey);
+#ifdef LTC_CLEAN_STACK
+   zeromem(tmp, sizeof(tmp));
+#endif
+   return err;
+}
+
+/**
+  Start the PRNG
+  @param prng     [out] The PRNG state to initialize
+  @return CRYPT_OK if successful
+*/
+int ctr_drbg_start(prng_state *prng)
+{
+   LTC_ARGCHK(prng != NULL);
+   prng->ctr_drbg.ready = 0;
+   prng->ctr_drbg.idx   = 0;
+   prng->ctr_drbg.reseed_cnt = 0;
+   XMEMSET(prng->ctr_drbg.ent, 0, sizeof(prng->ctr_drbg.ent));
+   LTC_MUTEX_INIT(&prng->ctr_drbg.prng_lock)
+   return CRYPT_OK;
+}
+
+/**
+  Add entropy to the PRNG state
+  @param in       The data to add (at most 48 octets per call)
+  @param inlen    Length of the data to add
+  @param prng     PRNG state to update
+  @return CRYPT_OK if successful
+*/
+int ctr_drbg_add_entropy(const unsigned char *in, unsigned long inlen, prng_state *prng)
+{
+   unsigned char buf[LTC_CTR_DRBG_SEEDLEN];
+   unsigned long i;
+   int           err;
+
+   LTC_ARGCHK(prng != NULL);
+   LTC_ARGCHK(in   != NULL);
+   LTC_ARGCHK(inlen > 0);
+
+   if (inlen > LTC_CTR_DRBG_SEEDLEN) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   LTC_MUTEX_LOCK(&prng->ctr_drbg.prng_lock);
+   if (prng->ctr_drbg.ready) {
+      /* reseed: fold the material into the state and restart the
+       * reseed counter */
+      XMEMSET(buf, 0, sizeof(buf));
+      XMEMCPY(buf, in, inlen);
+      if ((err = s_ctr_drbg_update(prng, buf)) != CRYPT_OK) {
+         LTC_MUTEX_UNLOCK(&prng->ctr_drbg.prng_lock);
+         return err;
+      }
+      prng->ctr_drbg.reseed_cnt = 1;
+#ifdef LTC_CLEAN_STACK
+      zeromem(buf, sizeof(buf));
+#endif
+   } else {
+      /* not instantiated yet; collect seed material */
+      for (i = 0; i < inlen; i++) {
+         prng->ctr_drbg.ent[prng->ctr_drbg.idx++ % LTC_CTR_DRBG_SEEDLEN] ^= in[i];
+      }
+   }
+   LTC_MUTEX_UNLOCK(&prng->ctr_drbg.prng_lock);
+   return CRYPT_OK;
+}
+
+/**
+  Make the PRNG ready to read from
+  @param prng   The PRNG to make active
+  @return CRYPT_OK if successful
+*/
+int ctr_drbg_ready(prng_state *prng)
+{
+   int err;
+
+   LTC_ARGCHK(prng != NULL);
+
+   LTC_MUTEX_LOCK(&prng->ctr_drbg.prng_lock);
+   /* instantiate: K = 0^256, V = 0^128, then fold in the seed */
+   XMEMSET(prng->ctr_drbg.K, 0, 32);
+   XMEMSET(prng->ctr_drbg.V, 0, 16);
+   if ((err = rijndael_setup(prng->ctr_drbg.K, 32, 0, &prng->ctr_drbg.skey)) != CRYPT_OK) {
+      LTC_MUTEX_UNLOCK(&prng->ctr_drbg.prng_lock);
+      return err;
+   }
+   if ((err = s_ctr_drbg_update(prng, prng->ctr_drbg.ent)) != CRYPT_OK) {
+      LTC_MUTEX_UNLOCK(&prng->ctr_drbg.prng_lock);
+      return err;
+   }
+   XMEMSET(prng->ctr_drbg.ent, 0, sizeof(prng->ctr_drbg.ent));
+   prng->ctr_drbg.idx        = 0;
+   prng->ctr_drbg.reseed_cnt = 1;
+   prng->ctr_drbg.ready      = 1;
+   LTC_MUTEX_UNLOCK(&prng->ctr_drbg.prng_lock);
+   return CRYPT_OK;
+}
+
+/**
+  Instantiate directly from a seed
+  @param in     The seed material
+  @param inlen  Length of the seed material (octets)
+  @param prng   [out] The PRNG state to instantiate
+  @return CRYPT_OK if successful
+*/
+int ctr_drbg_seed(const unsigned char *in, unsigned long inlen, prng_state *prng)
+{
+   unsigned long n;
+   int           err;
+
+   LTC_ARGCHK(in   != NULL);
+   LTC_ARGCHK(prng != NULL);
+   LTC_ARGCHK(inlen > 0);
+
+   if ((err = ctr_drbg_start(prng)) != CRYPT_OK) {
+      return err;
+   }
+   /* longer seeds fold into the collection buffer in seedlen chunks */
+   while (inlen > 0) {
+      n = MIN(inlen, LTC_CTR_DRBG_SEEDLEN);
+      if ((err = ctr_drbg_add_entropy(in, n, prng)) != CRYPT_OK) {
+         return err;
+      }
+      in    += n;
+      inlen -= n;
+   }
+   return ctr_drbg_ready(prng);
+}
+
+/**
+  Read from the PRNG
+  @param out      Destination
+  @param outlen   Length of output
+  @param prng     The active PRNG to read from
+  @return Number of octets read
+*/
+unsigned long ctr_drbg_read(unsigned char *out, unsigned long outlen, prng_state *prng)
+{
+   unsigned char tmp[16];
+   unsigned long tlen, chunk;
+
+   LTC_ARGCHK(out  != NULL);
+   LTC_ARGCHK(prng != NULL);
+
+   LTC_MUTEX_LOCK(&prng->ctr_drbg.prng_lock);
+   if (!prng->ctr_drbg.ready) {
+      LTC_MUTEX_UNLOCK(&prng->ctr_drbg.prng_lock);
+      return 0;
+   }
+
+   tlen = outlen;
+   while (outlen > 0) {
+      if (prng->ctr_drbg.reseed_cnt > LTC_CTR_DRBG_RESEED_INTERVAL) {
+         /* reseed interval exhausted; refuse to generate */
+         LTC_MUTEX_UNLOCK(&prng->ctr_drbg.prng_lock);
+         return 0;
+      }
+      chunk = MIN(outlen, LTC_CTR_DRBG_MAX_REQUEST);
+      outlen -= chunk;
+
+      /* whole blocks straight into the caller's buffer */
+      while (chunk >= 16) {
+         s_ctr_drbg_inc(prng->ctr_drbg.V);
+         rijndael_ecb_encrypt(prng->ctr_drbg.V, out, &prng->ctr_drbg.skey);
+         out   += 16;
+         chunk -= 16;
+      }
+      if (chunk > 0) {
+         s_ctr_drbg_inc(prng->ctr_drbg.V);
+         rijndael_ecb_encrypt(prng->ctr_drbg.V, tmp, &prng->ctr_drbg.skey);
+         XMEMCPY(out, tmp, chunk);
+         out += chunk;
+      }
+
+      /* ratchet the state after every request */
+      if (s_ctr_drbg_update(prng, NULL) != CRYPT_OK) {
+         LTC_MUTEX_UNLOCK(&prng->ctr_drbg.prng_lock);
+         return 0;
+      }
+      ++prng->ctr_drbg.reseed_cnt;
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(tmp, sizeof(tmp));
+#endif
+   LTC_MUTEX_UNLOCK(&prng->ctr_drbg.prng_lock);
+   return tlen;
+}
+
+/**
+  Fill a large buffer in one shot
+  @param out      Destination
+  @param outlen   Length of output
+  @param prng     The active PRNG to read from
+  @return CRYPT_OK if the whole buffer was filled
+*/
+int ctr_drbg_fill(unsigned char *out, unsigned long outlen, prng_state *prng)
+{
+   if (outlen == 0) {
+      return CRYPT_OK;
+   }
+   return (ctr_drbg_read(out, outlen, prng) == outlen) ? CRYPT_OK : CRYPT_ERROR_READPRNG;
+}
+
+/**
+  Terminate the PRNG
+  @param prng   The PRNG to terminate
+  @return CRYPT_OK if successful
+*/
+int ctr_drbg_done(prng_state *prng)
+{
+   LTC_ARGCHK(prng != NULL);
+   LTC_MUTEX_LOCK(&prng->ctr_drbg.prng_lock);
+   prng->ctr_drbg.ready = 0;
+   zeromem(prng->ctr_drbg.K,   sizeof(prng->ctr_drbg.K));
+   zeromem(prng->ctr_drbg.V,   sizeof(prng->ctr_drbg.V));
+   zeromem(prng->ctr_drbg.ent, sizeof(prng->ctr_drbg.ent));
+   LTC_MUTEX_UNLOCK(&prng->ctr_drbg.prng_lock);
+   return CRYPT_OK;
+}
+
+/**
+  Export the PRNG state
+  @param out       [out] Destination
+  @param outlen    [in/out] Max size and resulting size of the state
+  @param prng      The PRNG to export
+  @return CRYPT_OK if successful
+
+  48 bytes of output are exported rather than the raw state, so the
+  blob cannot reproduce anything this instance generated; importing
+  re-instantiates from those bytes.
+*/
+int ctr_drbg_export(unsigned char *out, unsigned long *outlen, prng_state *prng)
+{
+   LTC_ARGCHK(out    != NULL);
+   LTC_ARGCHK(outlen != NULL);
+   LTC_ARGCHK(prng   != NULL);
+
+   if (*outlen < LTC_CTR_DRBG_SEEDLEN) {
+      *outlen = LTC_CTR_DRBG_SEEDLEN;
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+   if (!prng->ctr_drbg.ready) {
+      return CRYPT_ERROR;
+   }
+   if (ctr_drbg_read(out, LTC_CTR_DRBG_SEEDLEN, prng) != LTC_CTR_DRBG_SEEDLEN) {
+      return CRYPT_ERROR_READPRNG;
+   }
+   *outlen = LTC_CTR_DRBG_SEEDLEN;
+   return CRYPT_OK;
+}
+
+/**
+  Import a PRNG state
+  @param in       The PRNG state
+  @param inlen    Size of the state
+  @param prng     The PRNG to import
+  @return CRYPT_OK if successful
+*/
+int ctr_drbg_import(const unsigned char *in, unsigned long inlen, prng_state *prng)
+{
+   int err;
+
+   LTC_ARGCHK(in   != NULL);
+   LTC_ARGCHK(prng != NULL);
+
+   if (inlen != LTC_CTR_DRBG_SEEDLEN) {
+      return CRYPT_INVALID_ARG;
+   }
+   if ((err = ctr_drbg_start(prng)) != CRYPT_OK) {
+      return err;
+   }
+   return ctr_drbg_add_entropy(in, inlen, prng);
+}
+
+/**
+  PRNG self-test
+  @return CRYPT_OK if successful, CRYPT_NOP if self-testing has been disabled
+*/
+int ctr_drbg_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   /* NIST CAVP CTR_DRBG.rsp, [AES-256 no df][PredictionResistance =
+    * False], COUNT = 0: instantiate, generate twice, compare the
+    * second output */
+   unsigned char ent[48] = {
+      0xdf, 0x5d, 0x73, 0xfa, 0xa4, 0x68, 0x64, 0x9e, 0xdd, 0xa3, 0x3b, 0x5c,
+      0xca, 0x79, 0xb0, 0xb0, 0x56, 0x00, 0x41, 0x9c, 0xcb, 0x7a, 0x87, 0x9d,
+      0xdf, 0xec, 0x9d, 0xb3, 0x2e, 0xe4, 0x94, 0xe5, 0x53, 0x1b, 0x51, 0xde,
+      0x16, 0xa3, 0x0f, 0x76, 0x92, 0x62, 0x47, 0x4c, 0x73, 0xbe, 0xc0, 0x10 };
+   unsigned char t1[64] = {
+      0xd1, 0xc0, 0x7c, 0xd9, 0x5a, 0xf8, 0xa7, 0xf1, 0x10, 0x12, 0xc8, 0x4c,
+      0xe4, 0x8b, 0xb8, 0xcb, 0x87, 0x18, 0x9e, 0x99, 0xd4, 0x0f, 0xcc, 0xb1,
+      0x77, 0x1c, 0x61, 0x9b, 0xdf, 0x82, 0xab, 0x22, 0x80, 0xb1, 0xdc, 0x2f,
+      0x25, 0x81, 0xf3, 0x91, 0x64, 0xf7, 0xac, 0x0c, 0x51, 0x04, 0x94, 0xb3,
+      0xa4, 0x3c, 0x41, 0xb7, 0xdb, 0x17, 0x51, 0x4c, 0x87, 0xb1, 0x07, 0xae,
+      0x79, 0x3e, 0x01, 0xc5 };
+   unsigned char out[64];
+   prng_state st;
+   int err;
+
+   if ((err = rijndael_test()) != CRYPT_OK)                       return err;
+   if ((err = ctr_drbg_start(&st)) != CRYPT_OK)                   return err;
+   if ((err = ctr_drbg_add_entropy(ent, sizeof(ent), &st)) != CRYPT_OK) return err;
+   if ((err = ctr_drbg_ready(&st)) != CRYPT_OK)                   return err;
+   if (ctr_drbg_read(out, 64, &st) != 64)                         return CRYPT_ERROR_READPRNG;
+   if (ctr_drbg_read(out, 64, &st) != 64)                         return CRYPT_ERROR_READPRNG;
+   if (compare_testvector(out, 64, t1, sizeof(t1), "CTR-DRBG", 1)) return CRYPT_FAIL_TESTVECTOR;
+   ctr_drbg_done(&st);
+
+   return CRYPT_OK;
+#endif
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
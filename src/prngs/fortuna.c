@@ -37,6 +37,16 @@ we reseed automatically when len(pool0) >= 64 or every LTC_FORTUNA_WD calls to t
    #error LTC_FORTUNA_POOLS must be in [4..32]
 #endif
 
+/* after fork() parent and child share the generator state; we stamp the
+ * state with the process id at keying time and rekey on first use in a
+ * new process, so the streams diverge without a full re-instantiation */
+#if !defined(_WIN32) && !defined(_WIN32_WCE)
+   #include <unistd.h>
+   #define FORTUNA_PID() ((unsigned long)getpid())
+#else
+   #define FORTUNA_PID() 0UL
+#endif
+
 const struct ltc_prng_descriptor fortuna_desc = {
     "fortuna", 1024,
     &fortuna_start,
@@ -46,7 +56,9 @@ const struct ltc_prng_descriptor fortuna_desc = {
     &fortuna_done,
     &fortuna_export,
     &fortuna_import,
-    &fortuna_test
+    &fortuna_test,
+    &fortuna_fill,
+    &fortuna_seed
 };
 
 /* update the IV */
@@ -62,6 +74,72 @@ static void fortuna_update_iv(prng_state *prng)
    }
 }
 
+/* rekey a state inherited through fork(); hashing the child's pid into
+ * K diverges the child's stream from the parent's at the cost of one
+ * hash and one key schedule, paid once per process.  Must be called
+ * with the state lock held */
+static int fortuna_fork_rekey(prng_state *prng)
+{
+   unsigned char pid[sizeof(unsigned long)];
+   unsigned long p;
+   hash_state    md;
+   int           err, x;
+
+   p = FORTUNA_PID();
+   for (x = 0; x < (int)sizeof(pid); x++) {
+      pid[x] = (unsigned char)(p & 255);
+      p >>= 8;
+   }
+
+   /* new K == LTC_SHA256(K || pid) */
+   sha256_init(&md);
+   if ((err = sha256_process(&md, prng->fortuna.K, 32)) != CRYPT_OK) {
+      sha256_done(&md, prng->fortuna.K);
+      return err;
+   }
+   if ((err = sha256_process(&md, pid, sizeof(pid))) != CRYPT_OK) {
+      sha256_done(&md, prng->fortuna.K);
+      return err;
+   }
+   if ((err = sha256_done(&md, prng->fortuna.K)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = rijndael_setup(prng->fortuna.K, 32, 0, &prng->fortuna.skey)) != CRYPT_OK) {
+      return err;
+   }
+   fortuna_update_iv(prng);
+   prng->fortuna.pid = FORTUNA_PID();
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(&md, sizeof(md));
+#endif
+   return CRYPT_OK;
+}
+
+/* fold the batched entropy events into the current pool with one hash
+ * call; must be called with the state lock held */
+static int fortuna_flush_events(prng_state *prng)
+{
+   int err;
+
+   if (prng->fortuna.evlen == 0) {
+      return CRYPT_OK;
+   }
+   if ((err = sha256_process(&prng->fortuna.pool[prng->fortuna.pool_idx],
+                             prng->fortuna.evbuf, prng->fortuna.evlen)) != CRYPT_OK) {
+      return err;
+   }
+   if (prng->fortuna.pool_idx == 0) {
+      prng->fortuna.pool0_len += prng->fortuna.evlen;
+   }
+   if (++(prng->fortuna.pool_idx) == LTC_FORTUNA_POOLS) {
+      prng->fortuna.pool_idx = 0;
+   }
+   zeromem(prng->fortuna.evbuf, prng->fortuna.evlen);
+   prng->fortuna.evlen = 0;
+   return CRYPT_OK;
+}
+
 /* reseed the PRNG */
 static int fortuna_reseed(prng_state *prng)
 {
@@ -69,6 +147,42 @@ static int fortuna_reseed(prng_state *prng)
    hash_state    md;
    int           err, x;
 
+   /* pending events must reach their pool before it is terminated */
+   if ((err = fortuna_flush_events(prng)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* a fortuna_maintenance call already folded the pools into the
+    * staging digest off the reader path; fold that into K with one
+    * short hash instead of terminating the pools here */
+   if (prng->fortuna.stage_ready) {
+      sha256_init(&md);
+      if ((err = sha256_process(&md, prng->fortuna.K, 32)) != CRYPT_OK) {
+         sha256_done(&md, tmp);
+         return err;
+      }
+      if ((err = sha256_process(&md, prng->fortuna.stage, 32)) != CRYPT_OK) {
+         sha256_done(&md, tmp);
+         return err;
+      }
+      if ((err = sha256_done(&md, prng->fortuna.K)) != CRYPT_OK) {
+         return err;
+      }
+      if ((err = rijndael_setup(prng->fortuna.K, 32, 0, &prng->fortuna.skey)) != CRYPT_OK) {
+         return err;
+      }
+      fortuna_update_iv(prng);
+      zeromem(prng->fortuna.stage, sizeof(prng->fortuna.stage));
+      prng->fortuna.stage_ready = 0;
+      /* reset_cnt was advanced when the stage was prepared */
+      prng->fortuna.pool0_len = 0;
+      prng->fortuna.wd        = 0;
+#ifdef LTC_CLEAN_STACK
+      zeromem(&md, sizeof(md));
+#endif
+      return CRYPT_OK;
+   }
+
    ++prng->fortuna.reset_cnt;
 
    /* new K == LTC_SHA256(K || s) where s == LTC_SHA256(P0) || LTC_SHA256(P1) ... */
@@ -144,7 +258,11 @@ int fortuna_start(prng_state *prng)
        }
    }
    prng->fortuna.pool_idx = prng->fortuna.pool0_len = prng->fortuna.wd = 0;
+   prng->fortuna.evlen    = 0;
    prng->fortuna.reset_cnt = 0;
+   prng->fortuna.pid       = FORTUNA_PID();
+   prng->fortuna.stage_ready = 0;
+   zeromem(prng->fortuna.stage, sizeof(prng->fortuna.stage));
 
    /* reset bufs */
    zeromem(prng->fortuna.K, 32);
@@ -184,22 +302,20 @@ int fortuna_add_entropy(const unsigned char *in, unsigned long inlen, prng_state
       return CRYPT_INVALID_ARG;
    }
 
-   /* add s || length(in) || in to pool[pool_idx] */
+   /* append s || length(in) || in to the event batch; the hot path is
+    * a short copy and the hashing happens once per full batch */
    tmp[0] = 0;
    tmp[1] = (unsigned char)inlen;
-   if ((err = sha256_process(&prng->fortuna.pool[prng->fortuna.pool_idx], tmp, 2)) != CRYPT_OK) {
-      LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
-      return err;
-   }
-   if ((err = sha256_process(&prng->fortuna.pool[prng->fortuna.pool_idx], in, inlen)) != CRYPT_OK) {
-      LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
-      return err;
-   }
-   if (prng->fortuna.pool_idx == 0) {
-      prng->fortuna.pool0_len += inlen;
-   }
-   if (++(prng->fortuna.pool_idx) == LTC_FORTUNA_POOLS) {
-      prng->fortuna.pool_idx = 0;
+   XMEMCPY(prng->fortuna.evbuf + prng->fortuna.evlen, tmp, 2);
+   XMEMCPY(prng->fortuna.evbuf + prng->fortuna.evlen + 2, in, inlen);
+   prng->fortuna.evlen += 2 + inlen;
+
+   /* fold once there is no room left for a maximum size event */
+   if (prng->fortuna.evlen + 34 > sizeof(prng->fortuna.evbuf)) {
+      if ((err = fortuna_flush_events(prng)) != CRYPT_OK) {
+         LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
+         return err;
+      }
    }
 
    LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
@@ -216,6 +332,143 @@ int fortuna_ready(prng_state *prng)
    return fortuna_reseed(prng);
 }
 
+/**
+  Instantiate directly from a seed
+  @param in     The seed material
+  @param inlen  Length of the seed material (octets)
+  @param prng   [out] The PRNG state to instantiate
+  @return CRYPT_OK if successful
+
+  Keys the generator with K = SHA-256(seed) in one step instead of
+  routing the seed through the pools and terminating all of them in
+  ready(); for one-off PRNGs seeded from the system RNG.  Entropy
+  added later still goes through the pools as usual.
+*/
+int fortuna_seed(const unsigned char *in, unsigned long inlen, prng_state *prng)
+{
+   hash_state md;
+   int        err;
+
+   LTC_ARGCHK(in   != NULL);
+   LTC_ARGCHK(prng != NULL);
+   LTC_ARGCHK(inlen > 0);
+
+   if ((err = fortuna_start(prng)) != CRYPT_OK) {
+      return err;
+   }
+
+   sha256_init(&md);
+   if ((err = sha256_process(&md, in, inlen)) != CRYPT_OK) {
+      sha256_done(&md, prng->fortuna.K);
+      return err;
+   }
+   if ((err = sha256_done(&md, prng->fortuna.K)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = rijndael_setup(prng->fortuna.K, 32, 0, &prng->fortuna.skey)) != CRYPT_OK) {
+      return err;
+   }
+   fortuna_update_iv(prng);
+   prng->fortuna.reset_cnt = 1;
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(&md, sizeof(md));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Prepare the next reseed off the reader path
+  @param prng   The PRNG state to maintain
+  @return CRYPT_OK if successful
+
+  The library never spawns threads; call this from an application
+  maintenance thread (or idle loop).  It captures the due pools under
+  the lock with a plain copy, hashes them OUTSIDE the lock, and parks
+  the digest in the staging buffer.  The next reseed then folds that
+  digest into K with one short hash instead of terminating the pools,
+  so fortuna_read latency stays flat through reseed boundaries.  A
+  no-op while a staged fold is still pending.
+*/
+int fortuna_maintenance(prng_state *prng)
+{
+   hash_state    *pools, md;
+   unsigned char tmp[MAXBLOCKSIZE];
+   ulong64       reset_cnt;
+   int           err, x, cnt;
+
+   LTC_ARGCHK(prng != NULL);
+
+   pools = XMALLOC(LTC_FORTUNA_POOLS * sizeof(hash_state));
+   if (pools == NULL) {
+      return CRYPT_MEM;
+   }
+
+   LTC_MUTEX_LOCK(&prng->fortuna.prng_lock);
+   if (prng->fortuna.stage_ready) {
+      LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
+      XFREE(pools);
+      return CRYPT_OK;
+   }
+   if ((err = fortuna_flush_events(prng)) != CRYPT_OK) {
+      LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
+      XFREE(pools);
+      return err;
+   }
+
+   /* advance the reseed count now; the swap in fortuna_reseed must not
+    * count this fold a second time */
+   reset_cnt = ++prng->fortuna.reset_cnt;
+
+   /* capture the due pools with a copy and reset them; entropy added
+    * from here on lands in the fresh pools */
+   cnt = 0;
+   for (x = 0; x < LTC_FORTUNA_POOLS; x++) {
+      if (x == 0 || ((reset_cnt >> (x-1)) & 1) == 0) {
+         XMEMCPY(&pools[cnt++], &prng->fortuna.pool[x], sizeof(hash_state));
+         if ((err = sha256_init(&prng->fortuna.pool[x])) != CRYPT_OK) {
+            LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
+            goto LBL_ERR;
+         }
+      } else {
+         break;
+      }
+   }
+   prng->fortuna.pool0_len = 0;
+   LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
+
+   /* the expensive part: terminate the captured pools outside the lock */
+   sha256_init(&md);
+   for (x = 0; x < cnt; x++) {
+      if ((err = sha256_done(&pools[x], tmp)) != CRYPT_OK) {
+         sha256_done(&md, tmp);
+         goto LBL_ERR;
+      }
+      if ((err = sha256_process(&md, tmp, 32)) != CRYPT_OK) {
+         sha256_done(&md, tmp);
+         goto LBL_ERR;
+      }
+   }
+
+   LTC_MUTEX_LOCK(&prng->fortuna.prng_lock);
+   if ((err = sha256_done(&md, prng->fortuna.stage)) != CRYPT_OK) {
+      LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
+      goto LBL_ERR;
+   }
+   prng->fortuna.stage_ready = 1;
+   LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
+   err = CRYPT_OK;
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(pools, LTC_FORTUNA_POOLS * sizeof(hash_state));
+   zeromem(&md, sizeof(md));
+   zeromem(tmp, sizeof(tmp));
+#endif
+   XFREE(pools);
+   return err;
+}
+
 /**
   Read from the PRNG
   @param out      Destination
@@ -233,6 +486,14 @@ unsigned long fortuna_read(unsigned char *out, unsigned long outlen, prng_state
 
    LTC_MUTEX_LOCK(&prng->fortuna.prng_lock);
 
+   /* state inherited through fork()?  rekey before any output */
+   if (prng->fortuna.pid != FORTUNA_PID()) {
+      if (fortuna_fork_rekey(prng) != CRYPT_OK) {
+         LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
+         return 0;
+      }
+   }
+
    /* do we have to reseed? */
    if (++prng->fortuna.wd == LTC_FORTUNA_WD || prng->fortuna.pool0_len >= 64) {
       if (fortuna_reseed(prng) != CRYPT_OK) {
@@ -279,6 +540,26 @@ unsigned long fortuna_read(unsigned char *out, unsigned long outlen, prng_state
    return tlen;
 }
 
+/**
+  Fill a large buffer in one shot
+  @param out      Destination
+  @param outlen   Length of output
+  @param prng     The active PRNG to read from
+  @return CRYPT_OK if the whole buffer was filled
+
+  fortuna_read already takes the lock once and generates whole blocks
+  straight into the caller's buffer for any length, with one reseed
+  check and one key erasure per call; filling through here instead of
+  a chunking loop amortizes those over the entire buffer.
+*/
+int fortuna_fill(unsigned char *out, unsigned long outlen, prng_state *prng)
+{
+   if (outlen == 0) {
+      return CRYPT_OK;
+   }
+   return (fortuna_read(out, outlen, prng) == outlen) ? CRYPT_OK : CRYPT_ERROR_READPRNG;
+}
+
 /**
   Terminate the PRNG
   @param prng   The PRNG to terminate
@@ -334,6 +615,13 @@ int fortuna_export(unsigned char *out, unsigned long *outlen, prng_state *prng)
       return CRYPT_BUFFER_OVERFLOW;
    }
 
+   /* batched events must land in their pool before the pools are
+    * copied out */
+   if ((err = fortuna_flush_events(prng)) != CRYPT_OK) {
+      LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
+      return err;
+   }
+
    md = XMALLOC(sizeof(hash_state));
    if (md == NULL) {
       LTC_MUTEX_UNLOCK(&prng->fortuna.prng_lock);
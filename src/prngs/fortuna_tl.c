@@ -0,0 +1,199 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include "tomcrypt.h"
+
+/**
+  @file fortuna_tl.c
+  Per-thread Fortuna output generators, Tom St Denis
+*/
+
+/* Every fortuna_read serializes callers on the state mutex, so many
+   threads drawing from one prng_state contend on a single lock.  This
+   frontend gives each thread its own AES-CTR output generator that is
+   keyed from the shared Fortuna state; steady-state reads touch only
+   thread-local data and the shared lock is taken solely when a
+   generator (re)keys.  Forward secrecy is kept per thread with the
+   same key-erasure step fortuna_read performs. */
+
+#if defined(LTC_FORTUNA) && defined(LTC_PTHREAD)
+
+/* bytes a thread may draw from one key before pulling fresh material
+ * from the shared state */
+#ifndef LTC_FORTUNA_TL_BYTES
+   #define LTC_FORTUNA_TL_BYTES (1024UL * 1024UL)
+#endif
+
+struct fortuna_tl_gen {
+   symmetric_key skey;
+   unsigned char K[32], IV[16];
+   unsigned long left;
+};
+
+static prng_state    *s_tl_master = NULL;
+static pthread_key_t  s_tl_key;
+static pthread_once_t s_tl_once = PTHREAD_ONCE_INIT;
+
+/* thread exit: scrub and release this thread's generator */
+static void s_tl_destructor(void *p)
+{
+   zeromem(p, sizeof(struct fortuna_tl_gen));
+   XFREE(p);
+}
+
+static void s_tl_make_key(void)
+{
+   (void)pthread_key_create(&s_tl_key, s_tl_destructor);
+}
+
+/* same carry-chain increment fortuna.c applies to its IV */
+static void s_tl_update_iv(struct fortuna_tl_gen *g)
+{
+   int x;
+   for (x = 0; x < 16; x++) {
+      g->IV[x] = (g->IV[x] + 1) & 255;
+      if (g->IV[x] != 0) break;
+   }
+}
+
+/* pull a fresh key and IV from the shared state; this is the only
+ * place the shared lock is touched */
+static int s_tl_rekey(struct fortuna_tl_gen *g)
+{
+   unsigned char seed[48];
+   int           err;
+
+   if (fortuna_read(seed, sizeof(seed), s_tl_master) != sizeof(seed)) {
+      return CRYPT_ERROR_READPRNG;
+   }
+   XMEMCPY(g->K,  seed,      32);
+   XMEMCPY(g->IV, seed + 32, 16);
+   err = rijndael_setup(g->K, 32, 0, &g->skey);
+   zeromem(seed, sizeof(seed));
+   if (err != CRYPT_OK) {
+      return err;
+   }
+   g->left = LTC_FORTUNA_TL_BYTES;
+   return CRYPT_OK;
+}
+
+/**
+  Attach the per-thread frontend to a running Fortuna state
+  @param prng   A started and ready Fortuna prng_state shared by all threads
+  @return CRYPT_OK if successful
+*/
+int fortuna_tl_start(prng_state *prng)
+{
+   LTC_ARGCHK(prng != NULL);
+
+   if (pthread_once(&s_tl_once, s_tl_make_key) != 0) {
+      return CRYPT_ERROR;
+   }
+   s_tl_master = prng;
+   return CRYPT_OK;
+}
+
+/**
+  Read from the calling thread's generator, keying it on first use
+  @param out      Destination
+  @param outlen   Length of output
+  @return Number of octets read
+*/
+unsigned long fortuna_tl_read(unsigned char *out, unsigned long outlen)
+{
+   struct fortuna_tl_gen *g;
+   unsigned char          tmp[16];
+   unsigned long          tlen;
+
+   LTC_ARGCHK(out != NULL);
+
+   if (s_tl_master == NULL) {
+      return 0;
+   }
+
+   g = pthread_getspecific(s_tl_key);
+   if (g == NULL) {
+      g = XCALLOC(1, sizeof(*g));
+      if (g == NULL) {
+         return 0;
+      }
+      if (pthread_setspecific(s_tl_key, g) != 0) {
+         XFREE(g);
+         return 0;
+      }
+   }
+
+   /* rekey from the shared state on first use or when the budget for
+    * the current key runs out */
+   if (g->left < outlen || g->left == 0) {
+      if (s_tl_rekey(g) != CRYPT_OK) {
+         return 0;
+      }
+   }
+
+   tlen = outlen;
+
+   /* whole blocks straight into the caller's buffer */
+   while (outlen >= 16) {
+      rijndael_ecb_encrypt(g->IV, out, &g->skey);
+      out    += 16;
+      outlen -= 16;
+      s_tl_update_iv(g);
+   }
+
+   /* left over bytes? */
+   if (outlen > 0) {
+      rijndael_ecb_encrypt(g->IV, tmp, &g->skey);
+      XMEMCPY(out, tmp, outlen);
+      s_tl_update_iv(g);
+   }
+
+   /* key erasure, as in fortuna_read, so a captured generator cannot
+    * reproduce earlier output */
+   rijndael_ecb_encrypt(g->IV, g->K,      &g->skey);
+   s_tl_update_iv(g);
+   rijndael_ecb_encrypt(g->IV, g->K + 16, &g->skey);
+   s_tl_update_iv(g);
+   if (rijndael_setup(g->K, 32, 0, &g->skey) != CRYPT_OK) {
+      return 0;
+   }
+
+   g->left = (g->left > tlen) ? g->left - tlen : 0;
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(tmp, sizeof(tmp));
+#endif
+   return tlen;
+}
+
+/**
+  Scrub and release the calling thread's generator
+  @return CRYPT_OK if successful
+*/
+int fortuna_tl_done(void)
+{
+   struct fortuna_tl_gen *g;
+
+   if (s_tl_master == NULL) {
+      return CRYPT_OK;
+   }
+   g = pthread_getspecific(s_tl_key);
+   if (g != NULL) {
+      (void)pthread_setspecific(s_tl_key, NULL);
+      s_tl_destructor(g);
+   }
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -27,7 +27,9 @@ const struct ltc_prng_descriptor rc4_desc =
     &rc4_done,
     &rc4_export,
     &rc4_import,
-    &rc4_test
+    &rc4_test,
+    NULL,
+    NULL
 };
 
 /**
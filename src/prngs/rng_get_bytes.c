@@ -52,6 +52,86 @@ static unsigned long rng_nix(unsigned char *buf, unsigned long len,
 #endif /* LTC_NO_FILE */
 }
 
+#if !defined(LTC_NO_FILE) && !defined(_WIN32) && !defined(_WIN32_WCE)
+
+/* process-wide pool refilled in one large read so small requests
+   (PRNG seeds, salts) do not pay a device open/read each.  The pool
+   is tied to the pid that filled it; a forked child finds the pid
+   stale and refills, so parent and child never share pool bytes. */
+
+#include <unistd.h>
+#if defined(__GLIBC__) && defined(__GLIBC_PREREQ)
+#if __GLIBC_PREREQ(2, 25)
+#define LTC_RNG_GETRANDOM
+#include <sys/random.h>
+#endif
+#endif
+
+#define LTC_RNG_POOL_SIZE 4096
+
+static unsigned char s_rng_pool[LTC_RNG_POOL_SIZE];
+static unsigned long s_rng_pool_left = 0;
+static long          s_rng_pool_pid  = -1;
+LTC_MUTEX_GLOBAL(ltc_rng_pool_lock)
+
+/* fill buf with len bytes; getrandom where glibc offers it, the
+   device otherwise */
+static unsigned long s_rng_pool_fill(unsigned char *buf, unsigned long len,
+                                     void (*callback)(void))
+{
+#ifdef LTC_RNG_GETRANDOM
+   unsigned long done = 0;
+   while (done < len) {
+      ssize_t r = getrandom(buf + done, len - done, 0);
+      if (r <= 0) {
+         break;
+      }
+      done += (unsigned long)r;
+   }
+   if (done == len) {
+      return len;
+   }
+#endif
+   return rng_nix(buf, len, callback);
+}
+
+/* serve a small request from the pool; returns 0 when the caller
+   should fall back to an unbuffered read */
+static unsigned long rng_pool(unsigned char *buf, unsigned long len,
+                              void (*callback)(void))
+{
+   unsigned long served = 0;
+
+   if (len == 0 || len > LTC_RNG_POOL_SIZE / 4) {
+      return 0;
+   }
+
+   LTC_MUTEX_LOCK(&ltc_rng_pool_lock);
+   if (s_rng_pool_pid != (long)getpid()) {
+      /* fresh process (or first use); drop inherited bytes */
+      s_rng_pool_left = 0;
+      s_rng_pool_pid  = (long)getpid();
+   }
+   if (s_rng_pool_left < len) {
+      if (s_rng_pool_fill(s_rng_pool, LTC_RNG_POOL_SIZE, callback) == LTC_RNG_POOL_SIZE) {
+         s_rng_pool_left = LTC_RNG_POOL_SIZE;
+      } else {
+         s_rng_pool_left = 0;
+      }
+   }
+   if (s_rng_pool_left >= len) {
+      XMEMCPY(buf, s_rng_pool + (LTC_RNG_POOL_SIZE - s_rng_pool_left), len);
+      /* scrub what was handed out */
+      zeromem(s_rng_pool + (LTC_RNG_POOL_SIZE - s_rng_pool_left), len);
+      s_rng_pool_left -= len;
+      served = len;
+   }
+   LTC_MUTEX_UNLOCK(&ltc_rng_pool_lock);
+   return served;
+}
+
+#endif /* !LTC_NO_FILE && !_WIN32 && !_WIN32_WCE */
+
 #endif /* LTC_DEVRANDOM */
 
 #if !defined(_WIN32_WCE)
@@ -147,6 +227,10 @@ unsigned long rng_get_bytes(unsigned char *out, unsigned long outlen,
 #if defined(_WIN32) || defined(_WIN32_WCE)
    x = rng_win32(out, outlen, callback); if (x != 0) { return x; }
 #elif defined(LTC_DEVRANDOM)
+#if !defined(LTC_NO_FILE)
+   /* small requests come out of the buffered pool */
+   x = rng_pool(out, outlen, callback);  if (x != 0) { return x; }
+#endif
    x = rng_nix(out, outlen, callback);   if (x != 0) { return x; }
 #endif
 #ifdef ANSI_RNG
@@ -41,15 +41,27 @@ int rng_make_prng(int bits, int wprng, prng_state *prng,
       return CRYPT_INVALID_PRNGSIZE;
    }
 
-   if ((err = prng_descriptor[wprng].start(prng)) != CRYPT_OK) {
-      return err;
-   }
-
    bits = ((bits/8)+((bits&7)!=0?1:0)) * 2;
    if (rng_get_bytes(buf, (unsigned long)bits, callback) != (unsigned long)bits) {
       return CRYPT_ERROR_READPRNG;
    }
 
+   /* PRNGs with a direct instantiate hook skip the add_entropy/ready
+    * accumulation machinery (for Fortuna: the pool terminations) */
+   if (prng_descriptor[wprng].seed != NULL) {
+      if ((err = prng_descriptor[wprng].seed(buf, (unsigned long)bits, prng)) != CRYPT_OK) {
+         return err;
+      }
+   #ifdef LTC_CLEAN_STACK
+      zeromem(buf, sizeof(buf));
+   #endif
+      return CRYPT_OK;
+   }
+
+   if ((err = prng_descriptor[wprng].start(prng)) != CRYPT_OK) {
+      return err;
+   }
+
    if ((err = prng_descriptor[wprng].add_entropy(buf, (unsigned long)bits, prng)) != CRYPT_OK) {
       return err;
    }
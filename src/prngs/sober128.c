@@ -31,7 +31,9 @@ const struct ltc_prng_descriptor sober128_desc =
     &sober128_done,
     &sober128_export,
     &sober128_import,
-    &sober128_test
+    &sober128_test,
+    NULL,
+    NULL
 };
 
 /* don't change these... */
@@ -32,7 +32,9 @@ const struct ltc_prng_descriptor sprng_desc =
     &sprng_done,
     &sprng_export,
     &sprng_import,
-    &sprng_test
+    &sprng_test,
+    &sprng_fill,
+    &sprng_seed
 };
 
 /**
@@ -86,6 +88,39 @@ unsigned long sprng_read(unsigned char *out, unsigned long outlen, prng_state *p
    return rng_get_bytes(out, outlen, NULL);
 }
 
+/**
+  Instantiate directly from a seed (a no-op; the system RNG needs none)
+  @param in     The seed material
+  @param inlen  Length of the seed material (octets)
+  @param prng   [out] The PRNG state to instantiate
+  @return CRYPT_OK if successful
+*/
+int sprng_seed(const unsigned char *in, unsigned long inlen, prng_state *prng)
+{
+   LTC_UNUSED_PARAM(in);
+   LTC_UNUSED_PARAM(inlen);
+   LTC_UNUSED_PARAM(prng);
+   return CRYPT_OK;
+}
+
+/**
+  Fill a large buffer in one shot
+  @param out      Destination
+  @param outlen   Length of output
+  @param prng     The active PRNG to read from
+  @return CRYPT_OK if the whole buffer was filled
+
+  rng_get_bytes serves large requests with a single system read, so
+  one call here replaces a caller-side chunking loop.
+*/
+int sprng_fill(unsigned char *out, unsigned long outlen, prng_state *prng)
+{
+   if (outlen == 0) {
+      return CRYPT_OK;
+   }
+   return (sprng_read(out, outlen, prng) == outlen) ? CRYPT_OK : CRYPT_ERROR_READPRNG;
+}
+
 /**
   Terminate the PRNG
   @param prng   The PRNG to terminate
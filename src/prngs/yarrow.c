@@ -27,7 +27,9 @@ const struct ltc_prng_descriptor yarrow_desc =
     &yarrow_done,
     &yarrow_export,
     &yarrow_import,
-    &yarrow_test
+    &yarrow_test,
+    NULL,
+    NULL
 };
 
 /**
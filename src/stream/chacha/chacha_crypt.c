@@ -22,6 +22,249 @@
   x[a] += x[b]; x[d] = ROL(x[d] ^ x[a],  8); \
   x[c] += x[d]; x[b] = ROL(x[b] ^ x[c],  7);
 
+#ifdef LTC_CHACHA_SSSE3
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+#define LTC_CHACHA_CALL __attribute__((target("ssse3,sse2")))
+
+static int _chacha_ssse3_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_SSSE3) != 0;
+}
+
+/* rotates by 16 and 8 are byte moves, the others pairs of shifts */
+#define SSE_ROT16(v, m16) _mm_shuffle_epi8(v, m16)
+#define SSE_ROT12(v)      _mm_or_si128(_mm_slli_epi32(v, 12), _mm_srli_epi32(v, 20))
+#define SSE_ROT8(v, m8)   _mm_shuffle_epi8(v, m8)
+#define SSE_ROT7(v)       _mm_or_si128(_mm_slli_epi32(v,  7), _mm_srli_epi32(v, 25))
+
+#define SSE_QROUND(a,b,c,d) \
+  a = _mm_add_epi32(a, b); d = SSE_ROT16(_mm_xor_si128(d, a), m16); \
+  c = _mm_add_epi32(c, d); b = SSE_ROT12(_mm_xor_si128(b, c));      \
+  a = _mm_add_epi32(a, b); d = SSE_ROT8(_mm_xor_si128(d, a), m8);   \
+  c = _mm_add_epi32(c, d); b = SSE_ROT7(_mm_xor_si128(b, c));
+
+/* transpose rows r0..r3 (word w of blocks 0..3) into blocks 0..3 and XOR
+ * them against in[] at 64-byte stride; g is the word-group index (0..3) */
+#define SSE_PUTBLOCKS(r0,r1,r2,r3,g)                                          \
+  t0 = _mm_unpacklo_epi32(r0, r1); t1 = _mm_unpacklo_epi32(r2, r3);           \
+  t2 = _mm_unpackhi_epi32(r0, r1); t3 = _mm_unpackhi_epi32(r2, r3);           \
+  _mm_storeu_si128((__m128i*)(out +       (g)*16),                            \
+     _mm_xor_si128(_mm_unpacklo_epi64(t0, t1),                                \
+                   _mm_loadu_si128((const __m128i*)(in +       (g)*16))));    \
+  _mm_storeu_si128((__m128i*)(out +  64 + (g)*16),                            \
+     _mm_xor_si128(_mm_unpackhi_epi64(t0, t1),                                \
+                   _mm_loadu_si128((const __m128i*)(in +  64 + (g)*16))));    \
+  _mm_storeu_si128((__m128i*)(out + 128 + (g)*16),                            \
+     _mm_xor_si128(_mm_unpacklo_epi64(t2, t3),                                \
+                   _mm_loadu_si128((const __m128i*)(in + 128 + (g)*16))));    \
+  _mm_storeu_si128((__m128i*)(out + 192 + (g)*16),                            \
+     _mm_xor_si128(_mm_unpackhi_epi64(t2, t3),                                \
+                   _mm_loadu_si128((const __m128i*)(in + 192 + (g)*16))));
+
+/* encrypt four 64-byte blocks at counters input[12]+0..3; the caller must
+ * ensure the 32-bit counter does not wrap inside the batch */
+LTC_CHACHA_CALL
+static void _chacha_block4_xor(unsigned char *out, const unsigned char *in, const ulong32 *input, int rounds)
+{
+   const __m128i m16  = _mm_setr_epi8( 2, 3, 0, 1,  6, 7, 4, 5, 10,11, 8, 9, 14,15,12,13);
+   const __m128i m8   = _mm_setr_epi8( 3, 0, 1, 2,  7, 4, 5, 6, 11, 8, 9,10, 15,12,13,14);
+   const __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+   __m128i x[16], t0, t1, t2, t3;
+   int i;
+
+   /* lane b of x[i] is state word i of block b */
+   for (i = 0; i < 16; i++) {
+      x[i] = _mm_set1_epi32((int)input[i]);
+   }
+   x[12] = _mm_add_epi32(x[12], lane);
+
+   for (i = rounds; i > 0; i -= 2) {
+      SSE_QROUND(x[0], x[4], x[ 8], x[12])
+      SSE_QROUND(x[1], x[5], x[ 9], x[13])
+      SSE_QROUND(x[2], x[6], x[10], x[14])
+      SSE_QROUND(x[3], x[7], x[11], x[15])
+      SSE_QROUND(x[0], x[5], x[10], x[15])
+      SSE_QROUND(x[1], x[6], x[11], x[12])
+      SSE_QROUND(x[2], x[7], x[ 8], x[13])
+      SSE_QROUND(x[3], x[4], x[ 9], x[14])
+   }
+
+   for (i = 0; i < 16; i++) {
+      x[i] = _mm_add_epi32(x[i], _mm_set1_epi32((int)input[i]));
+   }
+   x[12] = _mm_add_epi32(x[12], lane);
+
+   SSE_PUTBLOCKS(x[ 0], x[ 1], x[ 2], x[ 3], 0)
+   SSE_PUTBLOCKS(x[ 4], x[ 5], x[ 6], x[ 7], 1)
+   SSE_PUTBLOCKS(x[ 8], x[ 9], x[10], x[11], 2)
+   SSE_PUTBLOCKS(x[12], x[13], x[14], x[15], 3)
+}
+
+#endif /* LTC_CHACHA_SSSE3 */
+
+#ifdef LTC_CHACHA_AVX2
+
+/* immintrin.h drags in AVX-512 headers that are not C90 clean */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+#define LTC_CHACHA_AVX2_CALL __attribute__((target("avx2")))
+
+static int _chacha_avx2_enabled(void)
+{
+   return (ltc_cpu_features() & LTC_CPU_AVX2) != 0;
+}
+
+#define AVX_ROT16(v, m16) _mm256_shuffle_epi8(v, m16)
+#define AVX_ROT12(v)      _mm256_or_si256(_mm256_slli_epi32(v, 12), _mm256_srli_epi32(v, 20))
+#define AVX_ROT8(v, m8)   _mm256_shuffle_epi8(v, m8)
+#define AVX_ROT7(v)       _mm256_or_si256(_mm256_slli_epi32(v,  7), _mm256_srli_epi32(v, 25))
+
+#define AVX_QROUND(a,b,c,d) \
+  a = _mm256_add_epi32(a, b); d = AVX_ROT16(_mm256_xor_si256(d, a), m16); \
+  c = _mm256_add_epi32(c, d); b = AVX_ROT12(_mm256_xor_si256(b, c));      \
+  a = _mm256_add_epi32(a, b); d = AVX_ROT8(_mm256_xor_si256(d, a), m8);   \
+  c = _mm256_add_epi32(c, d); b = AVX_ROT7(_mm256_xor_si256(b, c));
+
+/* transpose rows r0..r3 (word w of blocks 0..7, word group g) and XOR
+ * the 128-bit pieces against in[]; the low half of each transposed
+ * register belongs to block b, the high half to block b+4 */
+#define AVX_PUTBLOCKS(r0,r1,r2,r3,g)                                             \
+  t0 = _mm256_unpacklo_epi32(r0, r1); t1 = _mm256_unpacklo_epi32(r2, r3);        \
+  t2 = _mm256_unpackhi_epi32(r0, r1); t3 = _mm256_unpackhi_epi32(r2, r3);        \
+  q0 = _mm256_unpacklo_epi64(t0, t1); q1 = _mm256_unpackhi_epi64(t0, t1);        \
+  q2 = _mm256_unpacklo_epi64(t2, t3); q3 = _mm256_unpackhi_epi64(t2, t3);        \
+  AVX_PUTPIECE(q0, 0, g) AVX_PUTPIECE(q1, 1, g)                                  \
+  AVX_PUTPIECE(q2, 2, g) AVX_PUTPIECE(q3, 3, g)
+
+#define AVX_PUTPIECE(q, b, g)                                                    \
+  _mm_storeu_si128((__m128i*)(out + (b)*64       + (g)*16),                      \
+     _mm_xor_si128(_mm256_castsi256_si128(q),                                    \
+        _mm_loadu_si128((const __m128i*)(in + (b)*64       + (g)*16))));         \
+  _mm_storeu_si128((__m128i*)(out + ((b)+4)*64   + (g)*16),                      \
+     _mm_xor_si128(_mm256_extracti128_si256(q, 1),                               \
+        _mm_loadu_si128((const __m128i*)(in + ((b)+4)*64   + (g)*16))));
+
+/* encrypt eight 64-byte blocks at counters input[12]+0..7; the caller
+ * must ensure the 32-bit counter does not wrap inside the batch */
+LTC_CHACHA_AVX2_CALL
+static void _chacha_block8_xor(unsigned char *out, const unsigned char *in, const ulong32 *input, int rounds)
+{
+   const __m256i m16  = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8( 2, 3, 0, 1,  6, 7, 4, 5, 10,11, 8, 9, 14,15,12,13));
+   const __m256i m8   = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8( 3, 0, 1, 2,  7, 4, 5, 6, 11, 8, 9,10, 15,12,13,14));
+   const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+   __m256i x[16], t0, t1, t2, t3, q0, q1, q2, q3;
+   int i;
+
+   /* lane b of x[i] is state word i of block b */
+   for (i = 0; i < 16; i++) {
+      x[i] = _mm256_set1_epi32((int)input[i]);
+   }
+   x[12] = _mm256_add_epi32(x[12], lane);
+
+   for (i = rounds; i > 0; i -= 2) {
+      AVX_QROUND(x[0], x[4], x[ 8], x[12])
+      AVX_QROUND(x[1], x[5], x[ 9], x[13])
+      AVX_QROUND(x[2], x[6], x[10], x[14])
+      AVX_QROUND(x[3], x[7], x[11], x[15])
+      AVX_QROUND(x[0], x[5], x[10], x[15])
+      AVX_QROUND(x[1], x[6], x[11], x[12])
+      AVX_QROUND(x[2], x[7], x[ 8], x[13])
+      AVX_QROUND(x[3], x[4], x[ 9], x[14])
+   }
+
+   for (i = 0; i < 16; i++) {
+      x[i] = _mm256_add_epi32(x[i], _mm256_set1_epi32((int)input[i]));
+   }
+   x[12] = _mm256_add_epi32(x[12], lane);
+
+   AVX_PUTBLOCKS(x[ 0], x[ 1], x[ 2], x[ 3], 0)
+   AVX_PUTBLOCKS(x[ 4], x[ 5], x[ 6], x[ 7], 1)
+   AVX_PUTBLOCKS(x[ 8], x[ 9], x[10], x[11], 2)
+   AVX_PUTBLOCKS(x[12], x[13], x[14], x[15], 3)
+   _mm256_zeroupper();
+}
+
+#endif /* LTC_CHACHA_AVX2 */
+
+#ifdef LTC_CHACHA_NEON
+
+#include <arm_neon.h>
+
+#define NEON_ROT16(v) vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(v)))
+#define NEON_ROT12(v) vsriq_n_u32(vshlq_n_u32(v, 12), v, 20)
+#define NEON_ROT8(v)  vsriq_n_u32(vshlq_n_u32(v,  8), v, 24)
+#define NEON_ROT7(v)  vsriq_n_u32(vshlq_n_u32(v,  7), v, 25)
+
+#define NEON_QROUND(a,b,c,d) \
+  a = vaddq_u32(a, b); d = NEON_ROT16(veorq_u32(d, a)); \
+  c = vaddq_u32(c, d); b = NEON_ROT12(veorq_u32(b, c)); \
+  a = vaddq_u32(a, b); d = NEON_ROT8(veorq_u32(d, a));  \
+  c = vaddq_u32(c, d); b = NEON_ROT7(veorq_u32(b, c));
+
+/* transpose rows r0..r3 (word w of blocks 0..3) into blocks and XOR
+ * against in[] at 64-byte stride; g is the word-group index (0..3) */
+#define NEON_PUTBLOCKS(r0,r1,r2,r3,g)                                          \
+  t0 = vzip1q_u32(r0, r1); t1 = vzip1q_u32(r2, r3);                            \
+  t2 = vzip2q_u32(r0, r1); t3 = vzip2q_u32(r2, r3);                            \
+  vst1q_u8(out +       (g)*16, veorq_u8(vreinterpretq_u8_u64(                  \
+     vzip1q_u64(vreinterpretq_u64_u32(t0), vreinterpretq_u64_u32(t1))),        \
+     vld1q_u8(in +       (g)*16)));                                            \
+  vst1q_u8(out +  64 + (g)*16, veorq_u8(vreinterpretq_u8_u64(                  \
+     vzip2q_u64(vreinterpretq_u64_u32(t0), vreinterpretq_u64_u32(t1))),        \
+     vld1q_u8(in +  64 + (g)*16)));                                            \
+  vst1q_u8(out + 128 + (g)*16, veorq_u8(vreinterpretq_u8_u64(                  \
+     vzip1q_u64(vreinterpretq_u64_u32(t2), vreinterpretq_u64_u32(t3))),        \
+     vld1q_u8(in + 128 + (g)*16)));                                            \
+  vst1q_u8(out + 192 + (g)*16, veorq_u8(vreinterpretq_u8_u64(                  \
+     vzip2q_u64(vreinterpretq_u64_u32(t2), vreinterpretq_u64_u32(t3))),        \
+     vld1q_u8(in + 192 + (g)*16)));
+
+/* encrypt four 64-byte blocks at counters input[12]+0..3; the caller
+ * must ensure the 32-bit counter does not wrap inside the batch */
+static void _chacha_block4_xor(unsigned char *out, const unsigned char *in, const ulong32 *input, int rounds)
+{
+   const uint32x4_t lane = { 0, 1, 2, 3 };
+   uint32x4_t x[16], t0, t1, t2, t3;
+   int i;
+
+   /* lane b of x[i] is state word i of block b */
+   for (i = 0; i < 16; i++) {
+      x[i] = vdupq_n_u32(input[i]);
+   }
+   x[12] = vaddq_u32(x[12], lane);
+
+   for (i = rounds; i > 0; i -= 2) {
+      NEON_QROUND(x[0], x[4], x[ 8], x[12])
+      NEON_QROUND(x[1], x[5], x[ 9], x[13])
+      NEON_QROUND(x[2], x[6], x[10], x[14])
+      NEON_QROUND(x[3], x[7], x[11], x[15])
+      NEON_QROUND(x[0], x[5], x[10], x[15])
+      NEON_QROUND(x[1], x[6], x[11], x[12])
+      NEON_QROUND(x[2], x[7], x[ 8], x[13])
+      NEON_QROUND(x[3], x[4], x[ 9], x[14])
+   }
+
+   for (i = 0; i < 16; i++) {
+      x[i] = vaddq_u32(x[i], vdupq_n_u32(input[i]));
+   }
+   x[12] = vaddq_u32(x[12], lane);
+
+   NEON_PUTBLOCKS(x[ 0], x[ 1], x[ 2], x[ 3], 0)
+   NEON_PUTBLOCKS(x[ 4], x[ 5], x[ 6], x[ 7], 1)
+   NEON_PUTBLOCKS(x[ 8], x[ 9], x[10], x[11], 2)
+   NEON_PUTBLOCKS(x[12], x[13], x[14], x[15], 3)
+}
+
+#endif /* LTC_CHACHA_NEON */
+
 static void _chacha_block(unsigned char *output, const ulong32 *input, int rounds)
 {
    ulong32 x[16];
@@ -63,20 +306,52 @@ int chacha_crypt(chacha_state *st, const unsigned char *in, unsigned long inlen,
 
    if (st->ksleft > 0) {
       j = MIN(st->ksleft, inlen);
-      for (i = 0; i < j; ++i, st->ksleft--) out[i] = in[i] ^ st->kstream[64 - st->ksleft];
+      for (i = 0; i < j; ++i, st->ksleft--) out[i] = in[i] ^ st->kstream[sizeof(st->kstream) - st->ksleft];
       inlen -= j;
       if (inlen == 0) return CRYPT_OK;
       out += j;
       in  += j;
    }
+#ifdef LTC_CHACHA_AVX2
+   if (_chacha_avx2_enabled()) {
+      while (inlen >= 512 && st->input[12] < 0xFFFFFFF9UL) {
+         _chacha_block8_xor(out, in, st->input, st->rounds);
+         for (j = 0; j < 8; ++j) {
+            if (!++st->input[12] && !++st->input[13] && !++st->input[14]) { ++st->input[15]; }
+         }
+         inlen -= 512;
+         out += 512;
+         in  += 512;
+      }
+      if (inlen == 0) return CRYPT_OK;
+   }
+#endif
+#if defined(LTC_CHACHA_SSSE3) || defined(LTC_CHACHA_NEON)
+#ifdef LTC_CHACHA_SSSE3
+   if (_chacha_ssse3_enabled())
+#endif
+   {
+      while (inlen >= 256 && st->input[12] < 0xFFFFFFFDUL) {
+         _chacha_block4_xor(out, in, st->input, st->rounds);
+         for (j = 0; j < 4; ++j) {
+            if (!++st->input[12] && !++st->input[13] && !++st->input[14]) { ++st->input[15]; }
+         }
+         inlen -= 256;
+         out += 256;
+         in  += 256;
+      }
+      if (inlen == 0) return CRYPT_OK;
+   }
+#endif
    for (;;) {
      _chacha_block(buf, st->input, st->rounds);
      /* increment the counter */
      if (!++st->input[12] && !++st->input[13] && !++st->input[14]) { ++st->input[15]; }
      if (inlen <= 64) {
        for (i = 0; i < inlen; ++i) out[i] = in[i] ^ buf[i];
+       /* leftover keystream lives at the tail of the buffer */
        st->ksleft = 64 - inlen;
-       for (i = inlen; i < 64; ++i) st->kstream[i] = buf[i];
+       for (i = inlen; i < 64; ++i) st->kstream[(sizeof(st->kstream) - 64) + i] = buf[i];
        return CRYPT_OK;
      }
      for (i = 0; i < 64; ++i) out[i] = in[i] ^ buf[i];
@@ -25,8 +25,24 @@
  */
 int chacha_keystream(chacha_state *st, unsigned char *out, unsigned long outlen)
 {
+   int err;
+
    if (outlen == 0) return CRYPT_OK; /* nothing to do */
+   LTC_ARGCHK(st  != NULL);
    LTC_ARGCHK(out != NULL);
+
+   /* a small draw from an empty buffer refills all four blocks in one
+    * batched fill (vectorized when chacha_crypt has a SIMD path) and
+    * is then served from the buffer; the read-ahead is part of the
+    * state, so export/import and rekeying see the same stream */
+   if (st->ksleft == 0 && outlen < sizeof(st->kstream)) {
+      XMEMSET(st->kstream, 0, sizeof(st->kstream));
+      if ((err = chacha_crypt(st, st->kstream, sizeof(st->kstream), st->kstream)) != CRYPT_OK) {
+         return err;
+      }
+      st->ksleft = sizeof(st->kstream);
+   }
+
    XMEMSET(out, 0, outlen);
    return chacha_crypt(st, out, outlen, out);
 }
@@ -54,6 +54,10 @@ int chacha_setup(chacha_state *st, const unsigned char *key, unsigned long keyle
    LOAD32L(st->input[2],  constants + 8);
    LOAD32L(st->input[3],  constants + 12);
    st->rounds  = rounds; /* e.g. 20 for chacha20 */
+   /* stash the key words for chacha_xivctr64() and drop any cached
+    * HChaCha subkey derived under the previous key */
+   XMEMCPY(st->xkey, &st->input[4], sizeof(st->xkey));
+   st->xvalid = 0;
    return CRYPT_OK;
 }
 
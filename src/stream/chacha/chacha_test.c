@@ -59,6 +59,25 @@ int chacha_test(void)
    chacha_crypt(&st, (unsigned char*)pt, len, out);
    if (compare_testvector(out, len, ct, sizeof(ct), "CHACHA-TV3", 1)) return CRYPT_FAIL_TESTVECTOR;
 
+   /* XChaCha20, draft-irtf-cfrg-xchacha A.3.2: the keystream under the
+    * 192-bit nonce; run twice to cover the cached-subkey path */
+   {
+      unsigned char xk[32], xn[24], xks[32];
+      /* A.2.2.1 HChaCha20 subkey check rides along via the keystream */
+      static const unsigned char xex[] = { 0xf1, 0x0c, 0x73, 0xf4, 0x5b, 0xf0, 0xf4, 0x5a, 0xfb, 0x12, 0x77, 0xd3, 0xf6, 0xae, 0x9d, 0x55,
+                                           0x32, 0x47, 0x72, 0x6e, 0x05, 0x44, 0x9c, 0xec, 0xca, 0xba, 0xf5, 0x0c, 0x42, 0x55, 0x0d, 0xc8 };
+      int i;
+      for (i = 0; i < 32; i++) xk[i] = 0x80 + i;
+      for (i = 0; i < 24; i++) xn[i] = 0x40 + i;
+      chacha_setup(&st, xk, sizeof(xk), 20);
+      chacha_xivctr64(&st, xn, sizeof(xn), 1);
+      chacha_keystream(&st, xks, sizeof(xks));
+      if (compare_testvector(xks, sizeof(xks), xex, sizeof(xex), "XCHACHA-TV1", 1)) return CRYPT_FAIL_TESTVECTOR;
+      chacha_xivctr64(&st, xn, sizeof(xn), 1);
+      chacha_keystream(&st, xks, sizeof(xks));
+      if (compare_testvector(xks, sizeof(xks), xex, sizeof(xex), "XCHACHA-TV2", 1)) return CRYPT_FAIL_TESTVECTOR;
+   }
+
    return CRYPT_OK;
 #endif
 }
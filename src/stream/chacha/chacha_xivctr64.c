@@ -0,0 +1,104 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/* The implementation is based on:
+ * chacha-ref.c version 20080118
+ * Public domain from D. J. Bernstein
+ * XChaCha20 per draft-irtf-cfrg-xchacha
+ */
+
+#include "tomcrypt.h"
+
+#ifdef LTC_CHACHA
+
+#define QUARTERROUND(a,b,c,d) \
+  x[a] += x[b]; x[d] = ROL(x[d] ^ x[a], 16); \
+  x[c] += x[d]; x[b] = ROL(x[b] ^ x[c], 12); \
+  x[a] += x[b]; x[d] = ROL(x[d] ^ x[a],  8); \
+  x[c] += x[d]; x[b] = ROL(x[b] ^ x[c],  7);
+
+/* HChaCha: the ChaCha rounds over constants|key|prefix without the
+ * feedforward add; words 0..3 and 12..15 become the subkey */
+static void _hchacha(ulong32 *sub, const ulong32 *key, const unsigned char *prefix, int rounds)
+{
+   ulong32 x[16];
+   int i;
+
+   x[0] = 0x61707865UL; x[1] = 0x3320646EUL;   /* sigma; 256-bit only */
+   x[2] = 0x79622D32UL; x[3] = 0x6B206574UL;
+   for (i = 0; i < 8; i++) {
+      x[4 + i] = key[i];
+   }
+   LOAD32L(x[12], prefix +  0);
+   LOAD32L(x[13], prefix +  4);
+   LOAD32L(x[14], prefix +  8);
+   LOAD32L(x[15], prefix + 12);
+
+   for (i = rounds; i > 0; i -= 2) {
+      QUARTERROUND(0, 4, 8,12)
+      QUARTERROUND(1, 5, 9,13)
+      QUARTERROUND(2, 6,10,14)
+      QUARTERROUND(3, 7,11,15)
+      QUARTERROUND(0, 5,10,15)
+      QUARTERROUND(1, 6,11,12)
+      QUARTERROUND(2, 7, 8,13)
+      QUARTERROUND(3, 4, 9,14)
+   }
+
+   sub[0] = x[ 0]; sub[1] = x[ 1]; sub[2] = x[ 2]; sub[3] = x[ 3];
+   sub[4] = x[12]; sub[5] = x[13]; sub[6] = x[14]; sub[7] = x[15];
+}
+
+/**
+  Set an extended 192-bit IV + counter on the ChaCha state (XChaCha).
+  The first 16 IV octets select an HChaCha subkey, the last 8 act as
+  the chacha_ivctr64() IV; the subkey is cached in the state, so
+  consecutive calls with the same prefix (streams of records under one
+  randomly drawn prefix) skip the derivation.
+  @param st      The ChaCha state, keyed with a 256-bit key
+  @param iv      The IV data to add
+  @param ivlen   The length of the IV (must be 24)
+  @param counter 64bit (unsigned) initial counter value
+  @return CRYPT_OK on success
+ */
+int chacha_xivctr64(chacha_state *st, const unsigned char *iv, unsigned long ivlen, ulong64 counter)
+{
+   int i;
+
+   LTC_ARGCHK(st != NULL);
+   LTC_ARGCHK(iv != NULL);
+   /* 128bit subkey prefix + 64bit IV + 64bit counter */
+   LTC_ARGCHK(ivlen == 24);
+   /* HChaCha is defined for 256-bit keys only; sigma marks one */
+   if (st->input[1] != 0x3320646EUL) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   if (!st->xvalid || XMEMCMP(st->xprefix, iv, 16) != 0) {
+      _hchacha(st->xsub, st->xkey, iv, st->rounds);
+      XMEMCPY(st->xprefix, iv, 16);
+      st->xvalid = 1;
+   }
+   for (i = 0; i < 8; i++) {
+      st->input[4 + i] = st->xsub[i];
+   }
+
+   st->input[12] = (ulong32)(counter & 0xFFFFFFFF);
+   st->input[13] = (ulong32)(counter >> 32);
+   LOAD32L(st->input[14], iv + 16);
+   LOAD32L(st->input[15], iv + 20);
+   st->ksleft = 0;
+   return CRYPT_OK;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
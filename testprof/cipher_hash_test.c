@@ -26,6 +26,9 @@ int cipher_hash_test(void)
 
    /* SHAKE128 + SHAKE256 tests are a bit special */
    DOX(sha3_shake_test(), "sha3_shake");
+#ifdef LTC_SHAKE_TREE
+   DOX(shake_tree_test(), "shake_tree");
+#endif
 
    /* test prngs (test, import/export */
    for (x = 0; prng_descriptor[x].name != NULL; x++) {
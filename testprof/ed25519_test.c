@@ -0,0 +1,137 @@
+#include <tomcrypt_test.h>
+
+#ifdef LTC_ED25519
+
+/* RFC 8032 section 7.1 test vectors: seed, public key, message, signature */
+static const struct {
+   unsigned char seed[32], pub[32], sig[64];
+   unsigned char msg[2];
+   unsigned long msglen;
+} rfc_vectors[] = {
+   /* TEST 1, empty message */
+   { { 0x9d, 0x61, 0xb1, 0x9d, 0xef, 0xfd, 0x5a, 0x60, 0xba, 0x84, 0x4a, 0xf4, 0x92, 0xec, 0x2c, 0xc4,
+       0x44, 0x49, 0xc5, 0x69, 0x7b, 0x32, 0x69, 0x19, 0x70, 0x3b, 0xac, 0x03, 0x1c, 0xae, 0x7f, 0x60 },
+     { 0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7, 0xd5, 0x4b, 0xfe, 0xd3, 0xc9, 0x64, 0x07, 0x3a,
+       0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6, 0x23, 0x25, 0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a },
+     { 0xe5, 0x56, 0x43, 0x00, 0xc3, 0x60, 0xac, 0x72, 0x90, 0x86, 0xe2, 0xcc, 0x80, 0x6e, 0x82, 0x8a,
+       0x84, 0x87, 0x7f, 0x1e, 0xb8, 0xe5, 0xd9, 0x74, 0xd8, 0x73, 0xe0, 0x65, 0x22, 0x49, 0x01, 0x55,
+       0x5f, 0xb8, 0x82, 0x15, 0x90, 0xa3, 0x3b, 0xac, 0xc6, 0x1e, 0x39, 0x70, 0x1c, 0xf9, 0xb4, 0x6b,
+       0xd2, 0x5b, 0xf5, 0xf0, 0x59, 0x5b, 0xbe, 0x24, 0x65, 0x51, 0x41, 0x43, 0x8e, 0x7a, 0x10, 0x0b },
+     { 0x00, 0x00 }, 0 },
+   /* TEST 2, one octet */
+   { { 0x4c, 0xcd, 0x08, 0x9b, 0x28, 0xff, 0x96, 0xda, 0x9d, 0xb6, 0xc3, 0x46, 0xec, 0x11, 0x4e, 0x0f,
+       0x5b, 0x8a, 0x31, 0x9f, 0x35, 0xab, 0xa6, 0x24, 0xda, 0x8c, 0xf6, 0xed, 0x4f, 0xb8, 0xa6, 0xfb },
+     { 0x3d, 0x40, 0x17, 0xc3, 0xe8, 0x43, 0x89, 0x5a, 0x92, 0xb7, 0x0a, 0xa7, 0x4d, 0x1b, 0x7e, 0xbc,
+       0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c, 0xc0, 0xcd, 0x55, 0xf1, 0x2a, 0xf4, 0x66, 0x0c },
+     { 0x92, 0xa0, 0x09, 0xa9, 0xf0, 0xd4, 0xca, 0xb8, 0x72, 0x0e, 0x82, 0x0b, 0x5f, 0x64, 0x25, 0x40,
+       0xa2, 0xb2, 0x7b, 0x54, 0x16, 0x50, 0x3f, 0x8f, 0xb3, 0x76, 0x22, 0x23, 0xeb, 0xdb, 0x69, 0xda,
+       0x08, 0x5a, 0xc1, 0xe4, 0x3e, 0x15, 0x99, 0x6e, 0x45, 0x8f, 0x36, 0x13, 0xd0, 0xf1, 0x1d, 0x8c,
+       0x38, 0x7b, 0x2e, 0xae, 0xb4, 0x30, 0x2a, 0xee, 0xb0, 0x0d, 0x29, 0x16, 0x12, 0xbb, 0x0c, 0x00 },
+     { 0x72, 0x00 }, 1 },
+   /* TEST 3, two octets */
+   { { 0xc5, 0xaa, 0x8d, 0xf4, 0x3f, 0x9f, 0x83, 0x7b, 0xed, 0xb7, 0x44, 0x2f, 0x31, 0xdc, 0xb7, 0xb1,
+       0x66, 0xd3, 0x85, 0x35, 0x07, 0x6f, 0x09, 0x4b, 0x85, 0xce, 0x3a, 0x2e, 0x0b, 0x44, 0x58, 0xf7 },
+     { 0xfc, 0x51, 0xcd, 0x8e, 0x62, 0x18, 0xa1, 0xa3, 0x8d, 0xa4, 0x7e, 0xd0, 0x02, 0x30, 0xf0, 0x58,
+       0x08, 0x16, 0xed, 0x13, 0xba, 0x33, 0x03, 0xac, 0x5d, 0xeb, 0x91, 0x15, 0x48, 0x90, 0x80, 0x25 },
+     { 0x62, 0x91, 0xd6, 0x57, 0xde, 0xec, 0x24, 0x02, 0x48, 0x27, 0xe6, 0x9c, 0x3a, 0xbe, 0x01, 0xa3,
+       0x0c, 0xe5, 0x48, 0xa2, 0x84, 0x74, 0x3a, 0x44, 0x5e, 0x36, 0x80, 0xd7, 0xdb, 0x5a, 0xc3, 0xac,
+       0x18, 0xff, 0x9b, 0x53, 0x8d, 0x16, 0xf2, 0x90, 0xae, 0x67, 0xf7, 0x60, 0x98, 0x4d, 0xc6, 0x59,
+       0x4a, 0x7c, 0x15, 0xe9, 0x71, 0x6e, 0xd2, 0x8d, 0xc0, 0x27, 0xbe, 0xce, 0xea, 0x1e, 0xc4, 0x0a },
+     { 0xaf, 0x82 }, 2 },
+};
+
+#define ED25519_BATCH 4
+
+int ed25519_test(void)
+{
+   unsigned char sig[64], msgs[ED25519_BATCH][32];
+   unsigned long siglen, x;
+   ed25519_key   key, keys[ED25519_BATCH];
+   int           stat, stats[ED25519_BATCH], i;
+
+   const unsigned char *bmsgs[ED25519_BATCH], *bsigs[ED25519_BATCH];
+   const ed25519_key   *bkeys[ED25519_BATCH];
+   unsigned long        bmsglens[ED25519_BATCH], bsiglens[ED25519_BATCH];
+   unsigned char        batch_sigs[ED25519_BATCH][64];
+
+   /* RFC 8032 vectors: deterministic signatures and derived public keys */
+   for (x = 0; x < sizeof(rfc_vectors)/sizeof(rfc_vectors[0]); x++) {
+      DO(ed25519_import(rfc_vectors[x].seed, 32, PK_PRIVATE, &key));
+      if (memcmp(key.pub, rfc_vectors[x].pub, 32) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+      siglen = sizeof(sig);
+      DO(ed25519_sign(rfc_vectors[x].msg, rfc_vectors[x].msglen, sig, &siglen, &key));
+      if (siglen != 64 || memcmp(sig, rfc_vectors[x].sig, 64) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+      DO(ed25519_verify(rfc_vectors[x].msg, rfc_vectors[x].msglen, sig, 64, &stat, &key));
+      if (stat != 1) return CRYPT_FAIL_TESTVECTOR;
+
+      /* a flipped signature bit must be rejected */
+      sig[17] ^= 0x40;
+      DO(ed25519_verify(rfc_vectors[x].msg, rfc_vectors[x].msglen, sig, 64, &stat, &key));
+      if (stat != 0) return CRYPT_FAIL_TESTVECTOR;
+
+      /* ...and so must a flipped message bit */
+      if (rfc_vectors[x].msglen > 0) {
+         unsigned char m[2];
+         XMEMCPY(m, rfc_vectors[x].msg, rfc_vectors[x].msglen);
+         m[0] ^= 0x01;
+         DO(ed25519_verify(m, rfc_vectors[x].msglen, rfc_vectors[x].sig, 64, &stat, &key));
+         if (stat != 0) return CRYPT_FAIL_TESTVECTOR;
+      }
+      ed25519_free(&key);
+   }
+
+   /* fresh keys: sign/verify round trip and batch verification */
+   for (i = 0; i < ED25519_BATCH; i++) {
+      DO(ed25519_make_key(&yarrow_prng, find_prng("yarrow"), &keys[i]));
+      yarrow_read(msgs[i], 32, &yarrow_prng);
+
+      siglen = 64;
+      DO(ed25519_sign(msgs[i], 32, batch_sigs[i], &siglen, &keys[i]));
+      DO(ed25519_verify(msgs[i], 32, batch_sigs[i], 64, &stat, &keys[i]));
+      if (stat != 1) return CRYPT_FAIL_TESTVECTOR;
+
+      bmsgs[i]    = msgs[i];
+      bmsglens[i] = 32;
+      bsigs[i]    = batch_sigs[i];
+      bsiglens[i] = 64;
+      bkeys[i]    = &keys[i];
+   }
+
+   /* all-valid batch */
+   DO(ed25519_verify_batch(bmsgs, bmsglens, bsigs, bsiglens, stats, bkeys, ED25519_BATCH,
+                           &yarrow_prng, find_prng("yarrow")));
+   for (i = 0; i < ED25519_BATCH; i++) {
+      if (stats[i] != 1) return CRYPT_FAIL_TESTVECTOR;
+   }
+
+   /* corrupt one item: the fallback must pinpoint exactly that item */
+   batch_sigs[1][40] ^= 0x04;
+   DO(ed25519_verify_batch(bmsgs, bmsglens, bsigs, bsiglens, stats, bkeys, ED25519_BATCH,
+                           &yarrow_prng, find_prng("yarrow")));
+   for (i = 0; i < ED25519_BATCH; i++) {
+      if (stats[i] != (i != 1)) return CRYPT_FAIL_TESTVECTOR;
+   }
+   batch_sigs[1][40] ^= 0x04;
+
+   for (i = 0; i < ED25519_BATCH; i++) {
+      ed25519_free(&keys[i]);
+   }
+
+   return 0;
+}
+
+#else
+
+int ed25519_test(void)
+{
+   fprintf(stderr, "NOP");
+   return 0;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -32,6 +32,10 @@ int mac_test(void)
 #endif
 #ifdef LTC_GCM_MODE
    DO(gcm_test());
+   DO(gmac_test());
+#endif
+#ifdef LTC_GCM_SIV_MODE
+   DO(gcmsiv_test());
 #endif
 #ifdef LTC_PELICAN
    DO(pelican_test());
@@ -39,8 +43,23 @@ int mac_test(void)
 #ifdef LTC_POLY1305
    DO(poly1305_test());
 #endif
+#ifdef LTC_SIPHASH
+   DO(siphash_test());
+#endif
+#ifdef LTC_NHMAC
+   DO(nhmac_test());
+#endif
+#ifdef LTC_BLAKE2BMAC
+   DO(blake2bmac_test());
+#endif
+#ifdef LTC_BLAKE2SMAC
+   DO(blake2smac_test());
+#endif
 #ifdef LTC_CHACHA20POLY1305_MODE
    DO(chacha20poly1305_test());
+#endif
+#ifdef LTC_SEAL
+   DO(ltc_seal_test());
 #endif
    return 0;
 }
@@ -13,7 +13,8 @@ int modes_test(void)
 #ifdef LTC_OFB_MODE
    symmetric_OFB ofb;
 #endif
-#if defined(LTC_CBC_MODE) || defined(LTC_CFB_MODE) || defined(LTC_OFB_MODE)
+#if defined(LTC_CBC_MODE) || defined(LTC_CFB_MODE) || defined(LTC_OFB_MODE) || \
+    (defined(LTC_CTR_MODE) && defined(LTC_RIJNDAEL)) || defined(LTC_XTS_MODE)
    unsigned char pt[64], ct[64], tmp[64], key[16], iv[16], iv2[16];
    int cipher_idx;
    unsigned long l;
@@ -59,6 +60,21 @@ int modes_test(void)
       fprintf(stderr, "CBC failed");
       return 1;
    }
+
+   /* in-place (pt == ct) must match the out-of-place result */
+   memcpy(tmp, pt, 64);
+   DO(ret = cbc_setiv(iv2, l, &cbc));
+   DO(ret = cbc_encrypt(tmp, tmp, 64, &cbc));
+   if (memcmp(tmp, ct, 64) != 0) {
+      fprintf(stderr, "CBC in-place encrypt failed");
+      return 1;
+   }
+   DO(ret = cbc_setiv(iv2, l, &cbc));
+   DO(ret = cbc_decrypt(tmp, tmp, 64, &cbc));
+   if (memcmp(tmp, pt, 64) != 0) {
+      fprintf(stderr, "CBC in-place decrypt failed");
+      return 1;
+   }
 #endif
 
 #ifdef LTC_CFB_MODE
@@ -82,6 +98,21 @@ int modes_test(void)
       fprintf(stderr, "CFB failed");
       return 1;
    }
+
+   /* in-place (pt == ct) must match the out-of-place result */
+   memcpy(tmp, pt, 64);
+   DO(ret = cfb_setiv(iv, l, &cfb));
+   DO(ret = cfb_encrypt(tmp, tmp, 64, &cfb));
+   if (memcmp(tmp, ct, 64) != 0) {
+      fprintf(stderr, "CFB in-place encrypt failed");
+      return 1;
+   }
+   DO(ret = cfb_setiv(iv, l, &cfb));
+   DO(ret = cfb_decrypt(tmp, tmp, 64, &cfb));
+   if (memcmp(tmp, pt, 64) != 0) {
+      fprintf(stderr, "CFB in-place decrypt failed");
+      return 1;
+   }
 #endif
 
 #ifdef LTC_OFB_MODE
@@ -104,14 +135,68 @@ int modes_test(void)
       fprintf(stderr, "OFB failed");
       return 1;
    }
+
+   /* in-place (pt == ct) must match the out-of-place result */
+   memcpy(tmp, pt, 64);
+   DO(ret = ofb_setiv(iv2, l, &ofb));
+   DO(ret = ofb_encrypt(tmp, tmp, 64, &ofb));
+   if (memcmp(tmp, ct, 64) != 0) {
+      fprintf(stderr, "OFB in-place encrypt failed");
+      return 1;
+   }
+   DO(ret = ofb_setiv(iv2, l, &ofb));
+   DO(ret = ofb_decrypt(tmp, tmp, 64, &ofb));
+   if (memcmp(tmp, pt, 64) != 0) {
+      fprintf(stderr, "OFB in-place decrypt failed");
+      return 1;
+   }
 #endif
 
 #if defined(LTC_CTR_MODE) && defined(LTC_RIJNDAEL)
    DO(ret = ctr_test());
+
+   /* in-place (pt == ct) must match the out-of-place result */
+   {
+      symmetric_CTR ctr;
+      DO(ret = ctr_start(cipher_idx, iv, key, 16, 0, CTR_COUNTER_BIG_ENDIAN, &ctr));
+      DO(ret = ctr_encrypt(pt, ct, 64, &ctr));
+      memcpy(tmp, pt, 64);
+      DO(ret = ctr_setiv(iv, 16, &ctr));
+      DO(ret = ctr_encrypt(tmp, tmp, 64, &ctr));
+      if (memcmp(tmp, ct, 64) != 0) {
+         fprintf(stderr, "CTR in-place encrypt failed");
+         return 1;
+      }
+      DO(ret = ctr_done(&ctr));
+   }
 #endif
 
 #ifdef LTC_XTS_MODE
    DO(ret = xts_test());
+
+   /* in-place (pt == ct) must match the out-of-place result */
+   {
+      symmetric_xts xts;
+      unsigned char tweak[16];
+      yarrow_read(tweak, 16, &yarrow_prng);
+      DO(ret = xts_start(cipher_idx, key, key, 16, 0, &xts));
+      memcpy(iv2, tweak, 16);
+      DO(ret = xts_encrypt(pt, 64, ct, iv2, &xts));
+      memcpy(tmp, pt, 64);
+      memcpy(iv2, tweak, 16);
+      DO(ret = xts_encrypt(tmp, 64, tmp, iv2, &xts));
+      if (memcmp(tmp, ct, 64) != 0) {
+         fprintf(stderr, "XTS in-place encrypt failed");
+         return 1;
+      }
+      memcpy(iv2, tweak, 16);
+      DO(ret = xts_decrypt(tmp, 64, tmp, iv2, &xts));
+      if (memcmp(tmp, pt, 64) != 0) {
+         fprintf(stderr, "XTS in-place decrypt failed");
+         return 1;
+      }
+      xts_done(&xts);
+   }
 #endif
 
    if (ret == CRYPT_NOP)
@@ -147,7 +147,9 @@ const struct ltc_prng_descriptor no_prng_desc =
     &no_prng_done,
     &no_prng_export,
     &no_prng_import,
-    &no_prng_test
+    &no_prng_test,
+    NULL,
+    NULL
 };
 
 #endif
@@ -0,0 +1,311 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ *
+ * Tom St Denis, tomstdenis@gmail.com, http://libtom.org
+ */
+#include <tomcrypt_test.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* performance regression gate: measures the throughput of the key
+ * primitives and fails when any of them drops more than a tolerance
+ * below a stored per-machine baseline, so slowdowns no longer ship
+ * silently.
+ *
+ * The baseline lives in the file named by $LTC_PERF_BASELINE (default
+ * "perf_baseline.txt"); keep one per machine, it is meaningless across
+ * hosts.  Record or refresh it with
+ *
+ *     LTC_PERF_RECORD=1 ./test perf_test
+ *
+ * and gate against it with plain "./test perf_test" (or the full test
+ * run; without a baseline file the test is a no-op so fresh checkouts
+ * are not penalized).  $LTC_PERF_TOLERANCE overrides the allowed
+ * regression in percent (default 10). */
+
+#define PERF_BUFLEN   65536UL
+#define PERF_TRIALS   7
+#define PERF_TRIAL_NS 2000000.0
+#define PERF_MAXITEMS 16
+
+struct perf_item {
+   char   name[32];
+   double mbs;
+};
+
+static ulong64 perf_ns(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (ulong64)ts.tv_sec * CONST64(1000000000) + (ulong64)ts.tv_nsec;
+}
+
+static int perf_dbl_cmp(const void *a, const void *b)
+{
+   double x = *(const double *)a, y = *(const double *)b;
+   return (x > y) - (x < y);
+}
+
+typedef void (*perf_fn)(void *ctx, unsigned char *buf, unsigned long reps);
+
+/* best-of-trials MB/s over PERF_BUFLEN octets per rep; the fastest
+ * trial is the right statistic for a gate since scheduler interference
+ * only ever slows a run down */
+static double perf_measure(perf_fn fn, void *ctx, unsigned char *buf)
+{
+   double trial[PERF_TRIALS], ns_per_rep;
+   ulong64 t0, t1;
+   unsigned long reps, r;
+   int i;
+
+   t0 = perf_ns();
+   fn(ctx, buf, 1);
+   t1 = perf_ns();
+   ns_per_rep = (double)(t1 - t0);
+   if (ns_per_rep < 1.0) ns_per_rep = 1.0;
+   reps = (unsigned long)(PERF_TRIAL_NS / ns_per_rep);
+   if (reps < 1) reps = 1;
+
+   fn(ctx, buf, reps);  /* warmup */
+   for (i = 0; i < PERF_TRIALS; i++) {
+      t0 = perf_ns();
+      for (r = reps; r > 0; r--) {
+         fn(ctx, buf, 1);
+      }
+      t1 = perf_ns();
+      trial[i] = (double)(t1 - t0) / (double)reps;
+   }
+   XQSORT(trial, PERF_TRIALS, sizeof(double), perf_dbl_cmp);
+   return (double)PERF_BUFLEN * (1.0e9 / trial[0]) / 1048576.0;
+}
+
+/* ---- the measured primitives --------------------------------------- */
+
+static void perf_run_ecb(void *vc, unsigned char *buf, unsigned long reps)
+{
+   while (reps-- > 0) { ecb_encrypt(buf, buf, PERF_BUFLEN, vc); }
+}
+
+static void perf_run_cbc(void *vc, unsigned char *buf, unsigned long reps)
+{
+   while (reps-- > 0) { cbc_encrypt(buf, buf, PERF_BUFLEN, vc); }
+}
+
+static void perf_run_ctr(void *vc, unsigned char *buf, unsigned long reps)
+{
+   while (reps-- > 0) { ctr_encrypt(buf, buf, PERF_BUFLEN, vc); }
+}
+
+#ifdef LTC_GCM_MODE
+static void perf_run_gcm(void *vc, unsigned char *buf, unsigned long reps)
+{
+   int cipher = *(int *)vc;
+   unsigned char key[16], iv[12], tag[16];
+   unsigned long taglen;
+   XMEMSET(key, 0x55, sizeof(key));
+   XMEMSET(iv,  0xAA, sizeof(iv));
+   while (reps-- > 0) {
+      taglen = sizeof(tag);
+      gcm_memory(cipher, key, sizeof(key), iv, sizeof(iv), NULL, 0,
+                 buf, PERF_BUFLEN, buf, tag, &taglen, GCM_ENCRYPT);
+   }
+}
+#endif
+
+static void perf_run_hash(void *vc, unsigned char *buf, unsigned long reps)
+{
+   int hash = *(int *)vc;
+   unsigned char md[MAXBLOCKSIZE];
+   unsigned long mdlen;
+   while (reps-- > 0) {
+      mdlen = sizeof(md);
+      hash_memory(hash, buf, PERF_BUFLEN, md, &mdlen);
+   }
+}
+
+#ifdef LTC_HMAC
+static void perf_run_hmac(void *vc, unsigned char *buf, unsigned long reps)
+{
+   int hash = *(int *)vc;
+   unsigned char key[32], md[MAXBLOCKSIZE];
+   unsigned long mdlen;
+   XMEMSET(key, 0x55, sizeof(key));
+   while (reps-- > 0) {
+      mdlen = sizeof(md);
+      hmac_memory(hash, key, sizeof(key), buf, PERF_BUFLEN, md, &mdlen);
+   }
+}
+#endif
+
+static int perf_collect(struct perf_item *items, unsigned char *buf)
+{
+   unsigned char key[32], iv[MAXBLOCKSIZE];
+   int n, idx;
+
+   n = 0;
+   XMEMSET(key, 0x55, sizeof(key));
+   XMEMSET(iv,  0xAA, sizeof(iv));
+
+   if ((idx = find_cipher("aes")) != -1) {
+      symmetric_ECB ecb;
+      symmetric_CBC cbc;
+      symmetric_CTR ctr;
+      if (ecb_start(idx, key, 16, 0, &ecb) == CRYPT_OK) {
+         strcpy(items[n].name, "aes128-ecb");
+         items[n++].mbs = perf_measure(perf_run_ecb, &ecb, buf);
+         ecb_done(&ecb);
+      }
+      if (cbc_start(idx, iv, key, 16, 0, &cbc) == CRYPT_OK) {
+         strcpy(items[n].name, "aes128-cbc");
+         items[n++].mbs = perf_measure(perf_run_cbc, &cbc, buf);
+         cbc_done(&cbc);
+      }
+      if (ctr_start(idx, iv, key, 16, 0, CTR_COUNTER_LITTLE_ENDIAN, &ctr) == CRYPT_OK) {
+         strcpy(items[n].name, "aes128-ctr");
+         items[n++].mbs = perf_measure(perf_run_ctr, &ctr, buf);
+         ctr_done(&ctr);
+      }
+#ifdef LTC_GCM_MODE
+      strcpy(items[n].name, "aes128-gcm");
+      items[n++].mbs = perf_measure(perf_run_gcm, &idx, buf);
+#endif
+   }
+
+   if ((idx = find_hash("sha1")) != -1) {
+      strcpy(items[n].name, "sha1");
+      items[n++].mbs = perf_measure(perf_run_hash, &idx, buf);
+   }
+   if ((idx = find_hash("sha256")) != -1) {
+      strcpy(items[n].name, "sha256");
+      items[n++].mbs = perf_measure(perf_run_hash, &idx, buf);
+#ifdef LTC_HMAC
+      strcpy(items[n].name, "hmac-sha256");
+      items[n++].mbs = perf_measure(perf_run_hmac, &idx, buf);
+#endif
+   }
+   if ((idx = find_hash("sha512")) != -1) {
+      strcpy(items[n].name, "sha512");
+      items[n++].mbs = perf_measure(perf_run_hash, &idx, buf);
+   }
+
+   return n;
+}
+
+/* ---- baseline file ------------------------------------------------- */
+
+static const char *perf_baseline_name(void)
+{
+   const char *p = getenv("LTC_PERF_BASELINE");
+   return (p != NULL && p[0] != '\0') ? p : "perf_baseline.txt";
+}
+
+static int perf_baseline_load(struct perf_item *items, int maxn)
+{
+   FILE *f;
+   int n;
+
+   if ((f = fopen(perf_baseline_name(), "r")) == NULL) {
+      return -1;
+   }
+   n = 0;
+   while (n < maxn &&
+          fscanf(f, "%31s %lf", items[n].name, &items[n].mbs) == 2) {
+      n++;
+   }
+   fclose(f);
+   return n;
+}
+
+static int perf_baseline_store(const struct perf_item *items, int n)
+{
+   FILE *f;
+   int i;
+
+   if ((f = fopen(perf_baseline_name(), "w")) == NULL) {
+      return CRYPT_FILE_NOTFOUND;
+   }
+   for (i = 0; i < n; i++) {
+      fprintf(f, "%s %.2f\n", items[i].name, items[i].mbs);
+   }
+   fclose(f);
+   return CRYPT_OK;
+}
+
+int perf_test(void)
+{
+   struct perf_item now[PERF_MAXITEMS], base[PERF_MAXITEMS];
+   unsigned char *buf;
+   const char *env;
+   double tol, delta;
+   int n, nb, i, j, fails;
+
+   tol = 10.0;
+   if ((env = getenv("LTC_PERF_TOLERANCE")) != NULL) {
+      tol = atof(env);
+      if (tol <= 0.0) tol = 10.0;
+   }
+
+   if ((buf = XMALLOC(PERF_BUFLEN)) == NULL) {
+      return CRYPT_MEM;
+   }
+   for (i = 0; (unsigned long)i < PERF_BUFLEN; i++) {
+      buf[i] = (unsigned char)i;
+   }
+
+   n = perf_collect(now, buf);
+   XFREE(buf);
+   if (n == 0) {
+      return CRYPT_NOP;
+   }
+
+   if (getenv("LTC_PERF_RECORD") != NULL) {
+      fprintf(stderr, "perf_test: recording baseline to %s\n",
+              perf_baseline_name());
+      for (i = 0; i < n; i++) {
+         fprintf(stderr, "  %-12s %10.2f MB/s\n", now[i].name, now[i].mbs);
+      }
+      return perf_baseline_store(now, n);
+   }
+
+   nb = perf_baseline_load(base, PERF_MAXITEMS);
+   if (nb < 0) {
+      fprintf(stderr, "perf_test: no baseline (%s); record one with "
+              "LTC_PERF_RECORD=1 to arm the gate\n", perf_baseline_name());
+      return CRYPT_NOP;
+   }
+
+   fails = 0;
+   for (i = 0; i < n; i++) {
+      for (j = 0; j < nb; j++) {
+         if (strcmp(now[i].name, base[j].name) == 0) break;
+      }
+      if (j == nb) {
+         fprintf(stderr, "  %-12s %10.2f MB/s (no baseline)\n",
+                 now[i].name, now[i].mbs);
+         continue;
+      }
+      delta = 100.0 * (now[i].mbs - base[j].mbs) / base[j].mbs;
+      fprintf(stderr, "  %-12s %10.2f MB/s, baseline %10.2f (%+.1f%%)%s\n",
+              now[i].name, now[i].mbs, base[j].mbs, delta,
+              delta < -tol ? "  REGRESSION" : "");
+      if (delta < -tol) {
+         fails++;
+      }
+   }
+   if (fails > 0) {
+      fprintf(stderr, "perf_test: %d primitive(s) regressed more than "
+              "%.0f%%\n", fails, tol);
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+   return CRYPT_OK;
+}
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */
@@ -17,6 +17,9 @@ int pkcs_1_emsa_test(void)
   for (i = 0; i < sizeof(testcases_emsa)/sizeof(testcases_emsa[0]); ++i) {
     testcase_t* t = &testcases_emsa[i];
     rsa_key k, *key = &k;
+    /* the cached-context members (mont_*, Vf/Vi, pub_der*) are consumed
+     * if non-NULL, so a hand-built key must start from zeros */
+    XMEMSET(&k, 0, sizeof(k));
     DOX(mp_init_multi(&key->e, &key->d, &key->N, &key->dQ,
                        &key->dP, &key->qP, &key->p, &key->q, NULL), t->name);
 
@@ -43,7 +46,8 @@ int pkcs_1_emsa_test(void)
         DOX(stat == 1?CRYPT_OK:CRYPT_FAIL_TESTVECTOR, s->name);
     } /* for */
 
-    mp_clear_multi(key->d,  key->e, key->N, key->dQ, key->dP, key->qP, key->p, key->q, NULL);
+    /* rsa_free also releases any caches seeded during the operations */
+    rsa_free(key);
   } /* for */
 
   return 0;
@@ -19,6 +19,9 @@ int pkcs_1_pss_test(void)
   for (i = 0; i < sizeof(testcases_pss)/sizeof(testcases_pss[0]); ++i) {
     testcase_t* t = &testcases_pss[i];
     rsa_key k, *key = &k;
+    /* the cached-context members (mont_*, Vf/Vi, pub_der*) are consumed
+     * if non-NULL, so a hand-built key must start from zeros */
+    XMEMSET(&k, 0, sizeof(k));
     DOX(mp_init_multi(&key->e, &key->d, &key->N, &key->dQ,
                        &key->dP, &key->qP, &key->p, &key->q, NULL), t->name);
 
@@ -46,7 +49,8 @@ int pkcs_1_pss_test(void)
         DOX(stat == 1?CRYPT_OK:CRYPT_FAIL_TESTVECTOR, s->name);
     } /* for */
 
-    mp_clear_multi(key->d,  key->e, key->N, key->dQ, key->dP, key->qP, key->p, key->q, NULL);
+    /* rsa_free also releases any caches seeded during the operations */
+    rsa_free(key);
   } /* for */
 
   unregister_prng(&no_prng_desc);
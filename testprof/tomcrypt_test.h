@@ -59,6 +59,8 @@ int store_test(void);
 int rotate_test(void);
 int rsa_test(void);
 int dh_test(void);
+int x25519_test(void);
+int ed25519_test(void);
 int katja_test(void);
 int ecc_tests(void);
 int dsa_test(void);
@@ -66,6 +68,9 @@ int der_tests(void);
 int misc_test(void);
 int base64_test(void);
 int file_test(void);
+/* throughput gate against a per-machine baseline; no-op until a
+   baseline is recorded with LTC_PERF_RECORD=1 (see perf_test.c) */
+int perf_test(void);
 
 /* timing */
 #define KTIMES  25
@@ -0,0 +1,123 @@
+#include <tomcrypt_test.h>
+
+#ifdef LTC_CURVE25519
+
+/* RFC 7748 section 5.2: X25519(scalar, u) one-shot vectors */
+static const unsigned char rfc_scalar1[32] = {
+   0xa5, 0x46, 0xe3, 0x6b, 0xf0, 0x52, 0x7c, 0x9d, 0x3b, 0x16, 0x15, 0x4b, 0x82, 0x46, 0x5e, 0xdd,
+   0x62, 0x14, 0x4c, 0x0a, 0xc1, 0xfc, 0x5a, 0x18, 0x50, 0x6a, 0x22, 0x44, 0xba, 0x44, 0x9a, 0xc4 };
+static const unsigned char rfc_u1[32] = {
+   0xe6, 0xdb, 0x68, 0x67, 0x58, 0x30, 0x30, 0xdb, 0x35, 0x94, 0xc1, 0xa4, 0x24, 0xb1, 0x5f, 0x7c,
+   0x72, 0x66, 0x24, 0xec, 0x26, 0xb3, 0x35, 0x3b, 0x10, 0xa9, 0x03, 0xa6, 0xd0, 0xab, 0x1c, 0x4c };
+static const unsigned char rfc_out1[32] = {
+   0xc3, 0xda, 0x55, 0x37, 0x9d, 0xe9, 0xc6, 0x90, 0x8e, 0x94, 0xea, 0x4d, 0xf2, 0x8d, 0x08, 0x4f,
+   0x32, 0xec, 0xcf, 0x03, 0x49, 0x1c, 0x71, 0xf7, 0x54, 0xb4, 0x07, 0x55, 0x77, 0xa2, 0x85, 0x52 };
+
+static const unsigned char rfc_scalar2[32] = {
+   0x4b, 0x66, 0xe9, 0xd4, 0xd1, 0xb4, 0x67, 0x3c, 0x5a, 0xd2, 0x26, 0x91, 0x95, 0x7d, 0x6a, 0xf5,
+   0xc1, 0x1b, 0x64, 0x21, 0xe0, 0xea, 0x01, 0xd4, 0x2c, 0xa4, 0x16, 0x9e, 0x79, 0x18, 0xba, 0x0d };
+static const unsigned char rfc_u2[32] = {
+   0xe5, 0x21, 0x0f, 0x12, 0x78, 0x68, 0x11, 0xd3, 0xf4, 0xb7, 0x95, 0x9d, 0x05, 0x38, 0xae, 0x2c,
+   0x31, 0xdb, 0xe7, 0x10, 0x6f, 0xc0, 0x3c, 0x3e, 0xfc, 0x4c, 0xd5, 0x49, 0xc7, 0x15, 0xa4, 0x93 };
+static const unsigned char rfc_out2[32] = {
+   0x95, 0xcb, 0xde, 0x94, 0x76, 0xe8, 0x90, 0x7d, 0x7a, 0xad, 0xe4, 0x5c, 0xb4, 0xb8, 0x73, 0xf8,
+   0x8b, 0x59, 0x5a, 0x68, 0x79, 0x9f, 0xa1, 0x52, 0xe6, 0xf8, 0xf7, 0x64, 0x7a, 0xac, 0x79, 0x57 };
+
+/* RFC 7748 section 6.1: Diffie-Hellman */
+static const unsigned char alice_priv[32] = {
+   0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d, 0x3c, 0x16, 0xc1, 0x72, 0x51, 0xb2, 0x66, 0x45,
+   0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a, 0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a };
+static const unsigned char alice_pub[32] = {
+   0x85, 0x20, 0xf0, 0x09, 0x89, 0x30, 0xa7, 0x54, 0x74, 0x8b, 0x7d, 0xdc, 0xb4, 0x3e, 0xf7, 0x5a,
+   0x0d, 0xbf, 0x3a, 0x0d, 0x26, 0x38, 0x1a, 0xf4, 0xeb, 0xa4, 0xa9, 0x8e, 0xaa, 0x9b, 0x4e, 0x6a };
+static const unsigned char bob_priv[32] = {
+   0x5d, 0xab, 0x08, 0x7e, 0x62, 0x4a, 0x8a, 0x4b, 0x79, 0xe1, 0x7f, 0x8b, 0x83, 0x80, 0x0e, 0xe6,
+   0x6f, 0x3b, 0xb1, 0x29, 0x26, 0x18, 0xb6, 0xfd, 0x1c, 0x2f, 0x8b, 0x27, 0xff, 0x88, 0xe0, 0xeb };
+static const unsigned char bob_pub[32] = {
+   0xde, 0x9e, 0xdb, 0x7d, 0x7b, 0x7d, 0xc1, 0xb4, 0xd3, 0x5b, 0x61, 0xc2, 0xec, 0xe4, 0x35, 0x37,
+   0x3f, 0x83, 0x43, 0xc8, 0x5b, 0x78, 0x67, 0x4d, 0xad, 0xfc, 0x7e, 0x14, 0x6f, 0x88, 0x2b, 0x4f };
+static const unsigned char rfc_shared[32] = {
+   0x4a, 0x5d, 0x9d, 0x5b, 0xa4, 0xce, 0x2d, 0xe1, 0x72, 0x8e, 0x3b, 0xf4, 0x80, 0x35, 0x0f, 0x25,
+   0xe0, 0x7e, 0x21, 0xc9, 0x47, 0xd1, 0x9e, 0x33, 0x76, 0xf0, 0x9b, 0x3c, 0x1e, 0x16, 0x17, 0x42 };
+
+/* RFC 7748 section 5.2: result after 1,000 iterations of the chain
+   k, u = X25519(k, u), k starting from the base point */
+static const unsigned char chain_1000[32] = {
+   0x68, 0x4c, 0xf5, 0x9b, 0xa8, 0x33, 0x09, 0x55, 0x28, 0x00, 0xef, 0x56, 0x6f, 0x2f, 0x4d, 0x3c,
+   0x1c, 0x38, 0x87, 0xc4, 0x93, 0x60, 0xe3, 0x87, 0x5f, 0x2e, 0xb9, 0x4d, 0x99, 0x53, 0x2c, 0x51 };
+
+/* X25519(k, u) through the public API: the clamp is part of the RFC
+   function, so importing k as a private key applies it for us */
+static int _do_x25519(const unsigned char *k, const unsigned char *u, unsigned char *out)
+{
+   x25519_key    priv, pub;
+   unsigned long outlen = 32;
+   int           err;
+
+   if ((err = x25519_import(k, 32, PK_PRIVATE, &priv)) != CRYPT_OK)    { return err; }
+   if ((err = x25519_import(u, 32, PK_PUBLIC, &pub)) != CRYPT_OK)      { return err; }
+   err = x25519_shared_secret(&priv, &pub, out, &outlen);
+   x25519_free(&priv);
+   x25519_free(&pub);
+   return err;
+}
+
+int x25519_test(void)
+{
+   unsigned char out[32], k[32], u[32], t[32];
+   unsigned long outlen;
+   x25519_key    alice, bob, bob_public, alice_public;
+   int           i;
+
+   /* one-shot function vectors */
+   DO(_do_x25519(rfc_scalar1, rfc_u1, out));
+   if (memcmp(out, rfc_out1, 32) != 0) return CRYPT_FAIL_TESTVECTOR;
+   DO(_do_x25519(rfc_scalar2, rfc_u2, out));
+   if (memcmp(out, rfc_out2, 32) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   /* Diffie-Hellman: derived public halves and both shared secrets */
+   DO(x25519_import(alice_priv, 32, PK_PRIVATE, &alice));
+   if (memcmp(alice.pub, alice_pub, 32) != 0) return CRYPT_FAIL_TESTVECTOR;
+   DO(x25519_import(bob_priv, 32, PK_PRIVATE, &bob));
+   if (memcmp(bob.pub, bob_pub, 32) != 0) return CRYPT_FAIL_TESTVECTOR;
+   DO(x25519_import(bob_pub, 32, PK_PUBLIC, &bob_public));
+   DO(x25519_import(alice_pub, 32, PK_PUBLIC, &alice_public));
+
+   outlen = sizeof(out);
+   DO(x25519_shared_secret(&alice, &bob_public, out, &outlen));
+   if (outlen != 32 || memcmp(out, rfc_shared, 32) != 0) return CRYPT_FAIL_TESTVECTOR;
+   outlen = sizeof(out);
+   DO(x25519_shared_secret(&bob, &alice_public, out, &outlen));
+   if (outlen != 32 || memcmp(out, rfc_shared, 32) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   x25519_free(&alice);
+   x25519_free(&bob);
+   x25519_free(&alice_public);
+   x25519_free(&bob_public);
+
+   /* the 1,000-iteration ladder chain */
+   zeromem(k, 32); k[0] = 9;
+   XMEMCPY(u, k, 32);
+   for (i = 0; i < 1000; i++) {
+      DO(_do_x25519(k, u, t));
+      XMEMCPY(u, k, 32);
+      XMEMCPY(k, t, 32);
+   }
+   if (memcmp(k, chain_1000, 32) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+   return 0;
+}
+
+#else
+
+int x25519_test(void)
+{
+   fprintf(stderr, "NOP");
+   return 0;
+}
+
+#endif
+
+/* $Source$ */
+/* $Revision$ */
+/* $Date$ */